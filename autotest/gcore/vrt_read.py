@@ -1313,6 +1313,180 @@ def vrt_read_30():
 
     return 'success'
 
+###############################################################################
+# Test reading sources concurrently with the NUM_THREADS open option
+
+def vrt_read_31():
+
+    src_ds = gdal.Open('data/rgbsmall.tif')
+    tiles = []
+    for j in range(5):
+        for i in range(5):
+            tile = '/vsimem/vrt_read_31_%d_%d.tif' % (i, j)
+            gdal.Translate(tile, src_ds, srcWin = [i * 10, j * 10, 10, 10])
+            tiles.append(tile)
+    gdal.BuildVRT('/vsimem/vrt_read_31.vrt', tiles)
+    # Overlapping sources must still be composited in order
+    gdal.BuildVRT('/vsimem/vrt_read_31_overlap.vrt',
+                  tiles + ['data/rgbsmall.tif'] + tiles)
+
+    for filename in [ '/vsimem/vrt_read_31.vrt',
+                      '/vsimem/vrt_read_31_overlap.vrt' ]:
+        ref_ds = gdal.OpenEx(filename, open_options = ['NUM_THREADS=1'])
+        ds = gdal.OpenEx(filename, open_options = ['NUM_THREADS=4'])
+        for i in range(3):
+            if ds.GetRasterBand(i+1).Checksum() != src_ds.GetRasterBand(i+1).Checksum():
+                gdaltest.post_reason('fail')
+                print(filename, i)
+                return 'fail'
+        for (xsize, ysize) in [ (50, 50), (17, 23), (100, 80) ]:
+            for resample_alg in [ gdal.GRIORA_NearestNeighbour, gdal.GRIORA_Bilinear ]:
+                expected = ref_ds.ReadRaster(0, 0, 50, 50, xsize, ysize,
+                                             resample_alg = resample_alg)
+                got = ds.ReadRaster(0, 0, 50, 50, xsize, ysize,
+                                    resample_alg = resample_alg)
+                if got != expected:
+                    gdaltest.post_reason('fail')
+                    print(filename, xsize, ysize, resample_alg)
+                    return 'fail'
+                expected = ref_ds.GetRasterBand(2).ReadRaster(3, 7, 41, 39, xsize, ysize,
+                                             resample_alg = resample_alg)
+                got = ds.GetRasterBand(2).ReadRaster(3, 7, 41, 39, xsize, ysize,
+                                    resample_alg = resample_alg)
+                if got != expected:
+                    gdaltest.post_reason('fail')
+                    print(filename, xsize, ysize, resample_alg)
+                    return 'fail'
+        ds = None
+        ref_ds = None
+        gdal.Unlink(filename)
+
+    for tile in tiles:
+        gdal.Unlink(tile)
+
+    return 'success'
+
+###############################################################################
+# Test reading a VRT with enough sources to use the spatial index of sources
+
+def vrt_read_32():
+
+    src_ds = gdal.Open('data/byte.tif')
+    tiles = []
+    for j in range(10):
+        for i in range(10):
+            tile = '/vsimem/vrt_read_32_%d_%d.tif' % (i, j)
+            gdal.Translate(tile, src_ds, srcWin = [i * 2, j * 2, 2, 2])
+            tiles.append(tile)
+    gdal.BuildVRT('/vsimem/vrt_read_32.vrt', tiles)
+    # Overlapping sources must still be composited in order
+    gdal.BuildVRT('/vsimem/vrt_read_32_overlap.vrt',
+                  tiles + ['data/byte.tif'] + tiles)
+
+    for filename in [ '/vsimem/vrt_read_32.vrt',
+                      '/vsimem/vrt_read_32_overlap.vrt' ]:
+        ds = gdal.Open(filename)
+        if ds.GetRasterBand(1).Checksum() != src_ds.GetRasterBand(1).Checksum():
+            gdaltest.post_reason('fail')
+            print(filename)
+            return 'fail'
+        for (xoff, yoff, xsize, ysize) in [ (0, 0, 1, 1), (3, 5, 1, 1),
+                                            (1, 1, 3, 3), (2, 2, 2, 2),
+                                            (5, 7, 11, 9), (19, 19, 1, 1) ]:
+            expected = src_ds.ReadRaster(xoff, yoff, xsize, ysize)
+            got = ds.ReadRaster(xoff, yoff, xsize, ysize)
+            if got != expected:
+                gdaltest.post_reason('fail')
+                print(filename, xoff, yoff, xsize, ysize)
+                return 'fail'
+        got = ds.GetRasterBand(1).GetMetadataItem('Pixel_5_7', 'LocationInfo')
+        if got.find('/vsimem/vrt_read_32_2_3.tif') < 0:
+            gdaltest.post_reason('fail')
+            print(got)
+            return 'fail'
+        ds = None
+        gdal.Unlink(filename)
+
+    for tile in tiles:
+        gdal.Unlink(tile)
+
+    return 'success'
+
+###############################################################################
+# Test the binary sources cache of VRT_SOURCES_CACHE=YES
+
+def vrt_read_33():
+
+    def write_vrt(filename, nsources):
+        f = open(filename, 'wt')
+        f.write('<VRTDataset rasterXSize="50" rasterYSize="20">\n')
+        f.write('  <VRTRasterBand dataType="Byte" band="1">\n')
+        for k in range(nsources):
+            i = k % 50
+            j = k // 50
+            typ = 'SimpleSource' if (k % 2) == 0 else 'ComplexSource'
+            f.write('    <%s>\n' % typ)
+            f.write('      <SourceFilename relativeToVRT="1">../data/byte.tif</SourceFilename>\n')
+            f.write('      <SourceBand>1</SourceBand>\n')
+            f.write('      <SourceProperties RasterXSize="20" RasterYSize="20" DataType="Byte" BlockXSize="20" BlockYSize="20" />\n')
+            f.write('      <SrcRect xOff="%d" yOff="%d" xSize="1" ySize="1" />\n' % (i % 20, j))
+            f.write('      <DstRect xOff="%d" yOff="%d" xSize="1" ySize="1" />\n' % (i, j))
+            if typ == 'ComplexSource':
+                f.write('      <NODATA>107</NODATA>\n')
+            f.write('    </%s>\n' % typ)
+        f.write('  </VRTRasterBand>\n')
+        f.write('</VRTDataset>\n')
+        f.close()
+
+    filename = 'tmp/vrt_read_33.vrt'
+    cache_filename = filename + '.srccache'
+    gdal.Unlink(cache_filename)
+    write_vrt(filename, 1000)
+
+    ds = gdal.Open(filename)
+    expected_cs = ds.GetRasterBand(1).Checksum()
+    ds = None
+    if gdal.VSIStatL(cache_filename) is not None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    # First opening writes the cache, second one uses it
+    for i in range(2):
+        with gdaltest.config_option('VRT_SOURCES_CACHE', 'YES'):
+            ds = gdal.Open(filename)
+        if gdal.VSIStatL(cache_filename) is None:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        cs = ds.GetRasterBand(1).Checksum()
+        if cs != expected_cs:
+            gdaltest.post_reason('fail')
+            print(i, cs, expected_cs)
+            return 'fail'
+        if len(ds.GetFileList()) != 2:
+            gdaltest.post_reason('fail')
+            print(ds.GetFileList())
+            return 'fail'
+        ds = None
+
+    # A modified VRT must not be opened from a stale cache
+    write_vrt(filename, 999)
+    ds = gdal.Open(filename)
+    expected_cs = ds.GetRasterBand(1).Checksum()
+    ds = None
+    with gdaltest.config_option('VRT_SOURCES_CACHE', 'YES'):
+        ds = gdal.Open(filename)
+    cs = ds.GetRasterBand(1).Checksum()
+    ds = None
+    if cs != expected_cs:
+        gdaltest.post_reason('fail')
+        print(cs, expected_cs)
+        return 'fail'
+
+    gdal.Unlink(filename)
+    gdal.Unlink(cache_filename)
+
+    return 'success'
+
 for item in init_list:
     ut = gdaltest.GDALTest( 'VRT', item[0], item[1], item[2] )
     if ut is None:
@@ -1350,6 +1524,9 @@ gdaltest_list.append( vrt_read_27 )
 gdaltest_list.append( vrt_read_28 )
 gdaltest_list.append( vrt_read_29 )
 gdaltest_list.append( vrt_read_30 )
+gdaltest_list.append( vrt_read_31 )
+gdaltest_list.append( vrt_read_32 )
+gdaltest_list.append( vrt_read_33 )
 
 if __name__ == '__main__':
 
@@ -3783,6 +3783,63 @@ def gpkg_48():
 
     return 'success'
 
+###############################################################################
+# Test that multi-tile RasterIO() requests, which fetch the tiles with a
+# single query and decode them in worker threads, return the same data as
+# block per block reads.
+
+def gpkg_49():
+
+    if gdaltest.gpkg_dr is None:
+        return 'skip'
+    if gdaltest.png_dr is None:
+        return 'skip'
+
+    tmpfile = '/vsimem/gpkg_49.gpkg'
+    src_ds = gdal.Open('data/small_world.tif')
+    gdaltest.gpkg_dr.CreateCopy(tmpfile, src_ds,
+                                options = ['TILE_FORMAT=PNG', 'BLOCKSIZE=64'])
+    src_ds = None
+
+    # Reference built from single tile requests
+    ds = gdal.Open(tmpfile)
+    xsize = ds.RasterXSize
+    ysize = ds.RasterYSize
+    ref_data = b''
+    for i in range(ds.RasterCount):
+        band_data = bytearray(xsize * ysize)
+        for y in range(0, ysize, 64):
+            for x in range(0, xsize, 64):
+                w = min(64, xsize - x)
+                h = min(64, ysize - y)
+                block = ds.GetRasterBand(i+1).ReadRaster(x, y, w, h)
+                for j in range(h):
+                    band_data[(y+j)*xsize+x:(y+j)*xsize+x+w] = \
+                        block[j*w:(j+1)*w]
+        ref_data += bytes(band_data)
+    ds = None
+
+    for num_threads in ['1', '4']:
+        with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+            ds = gdal.Open(tmpfile)
+            data = ds.ReadRaster(0, 0, xsize, ysize)
+            ds = None
+            ds = gdal.Open(tmpfile)
+            data_band = ds.GetRasterBand(2).ReadRaster(0, 0, xsize, ysize)
+            ds = None
+        if data != ref_data:
+            gdaltest.post_reason('fail')
+            print(num_threads)
+            return 'fail'
+        if data_band != ref_data[xsize*ysize:2*xsize*ysize]:
+            gdaltest.post_reason('fail')
+            print(num_threads)
+            return 'fail'
+
+    gdal.Unlink(tmpfile)
+
+    return 'success'
+
 ###############################################################################
 #
 
@@ -3853,6 +3910,7 @@ gdaltest_list = [
     gpkg_46,
     gpkg_47,
     gpkg_48,
+    gpkg_49,
     gpkg_cleanup,
 ]
 #gdaltest_list = [ gpkg_init, gpkg_47, gpkg_cleanup ]
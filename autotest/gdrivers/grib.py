@@ -204,6 +204,77 @@ def grib_read_vsizip():
 
     return 'success'
 
+###############################################################################
+# Test the message index cache (GRIB_INDEX_CACHE) and the concurrent reading
+# of messages in multi-band RasterIO (GDAL_NUM_THREADS)
+
+def grib_read_index_cache():
+
+    if gdaltest.grib_drv is None:
+        return 'skip'
+
+    src_filename = '/vsizip/data/grib/gfs.t00z.mastergrb2f03.zip/gfs.t00z.mastergrb2f03'
+    f = gdal.VSIFOpenL(src_filename, 'rb')
+    data = gdal.VSIFReadL(1, 1000000, f)
+    gdal.VSIFCloseL(f)
+    filename = '/vsimem/grib_read_index_cache.grb2'
+    gdal.FileFromMemBuffer(filename, data)
+
+    ds = gdal.Open(filename)
+    ref_md = [ds.GetRasterBand(i + 1).GetMetadata()
+              for i in range(ds.RasterCount)]
+    ref_desc = [ds.GetRasterBand(i + 1).GetDescription()
+                for i in range(ds.RasterCount)]
+    ref_gt = ds.GetGeoTransform()
+    ref_data = ds.ReadRaster()
+    ds = None
+
+    for i in range(2):
+        with gdaltest.config_option('GRIB_INDEX_CACHE', 'YES'):
+            ds = gdal.Open(filename)
+        if gdal.VSIStatL(filename + '.gribidx.xml') is None:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        if len(ds.GetFileList()) != 2:
+            gdaltest.post_reason('fail')
+            print(ds.GetFileList())
+            return 'fail'
+        if ds.GetGeoTransform() != ref_gt:
+            gdaltest.post_reason('fail')
+            print(i, ds.GetGeoTransform())
+            return 'fail'
+        for j in range(ds.RasterCount):
+            band = ds.GetRasterBand(j + 1)
+            if band.GetMetadata() != ref_md[j] or \
+               band.GetDescription() != ref_desc[j]:
+                gdaltest.post_reason('fail')
+                print(i, j, band.GetMetadata(), band.GetDescription())
+                return 'fail'
+        with gdaltest.config_option('GDAL_NUM_THREADS', '2'):
+            got_data = ds.ReadRaster()
+        if got_data != ref_data:
+            gdaltest.post_reason('fail')
+            print(i)
+            return 'fail'
+        ds = None
+
+    # Changing a configuration option that affects the metadata must
+    # invalidate the index
+    with gdaltest.config_options({'GRIB_INDEX_CACHE': 'YES',
+                                  'GRIB_NORMALIZE_UNITS': 'NO'}):
+        ds = gdal.Open(filename)
+    unit = ds.GetRasterBand(1).GetMetadataItem('GRIB_UNIT')
+    ds = None
+    if unit != '[K]':
+        gdaltest.post_reason('fail')
+        print(unit)
+        return 'fail'
+
+    gdal.Unlink(filename)
+    gdal.Unlink(filename + '.gribidx.xml')
+
+    return 'success'
+
 ###############################################################################
 # Write PDS numbers to all bands
 
@@ -1530,6 +1601,7 @@ gdaltest_list = [
     grib_read_units,
     grib_read_geotransform_one_n_or_n_one,
     grib_read_vsizip,
+    grib_read_index_cache,
     grib_grib2_test_grib_pds_all_bands,
     grib_grib2_read_template_4_15,
     grib_grib2_read_png,
@@ -682,6 +682,44 @@ def mrf_versioned():
 
     return 'success'
 
+def mrf_num_threads():
+
+    src_ds = gdal.Translate('/vsimem/src.tif', 'data/rgbsmall.tif',
+                            width = 500, height = 500)
+    expected_cs = [src_ds.GetRasterBand(i+1).Checksum() for i in range(3)]
+
+    for co in [ ['COMPRESS=PNG', 'INTERLEAVE=PIXEL'],
+                ['COMPRESS=DEFLATE', 'INTERLEAVE=BAND'],
+                ['COMPRESS=TIF', 'INTERLEAVE=BAND'] ]:
+        gdal.Translate('/vsimem/out.mrf', src_ds, format = 'MRF',
+                       creationOptions = co + ['BLOCKSIZE=128', 'NUM_THREADS=4'])
+
+        ds = gdal.OpenEx('/vsimem/out.mrf', open_options = ['NUM_THREADS=4'])
+        cs = [ds.GetRasterBand(i+1).Checksum() for i in range(3)]
+        if cs != expected_cs:
+            gdaltest.post_reason('fail')
+            print(co)
+            print(cs)
+            return 'fail'
+        data = ds.ReadRaster(100, 100, 300, 300)
+        ds = None
+
+        ds = gdal.Open('/vsimem/out.mrf')
+        if ds.ReadRaster(100, 100, 300, 300) != data:
+            gdaltest.post_reason('fail')
+            print(co)
+            return 'fail'
+        ds = None
+
+        for f in gdal.ReadDir('/vsimem/'):
+            if f.startswith('out.'):
+                gdal.Unlink('/vsimem/' + f)
+
+    src_ds = None
+    gdal.Unlink('/vsimem/src.tif')
+
+    return 'success'
+
 def mrf_cleanup():
 
     files = [
@@ -763,6 +801,7 @@ gdaltest_list += [ mrf_lerc_with_huffman ]
 gdaltest_list += [ mrf_cached_source ]
 gdaltest_list += [ mrf_versioned ]
 gdaltest_list += [ mrf_zen_test ]
+gdaltest_list += [ mrf_num_threads ]
 gdaltest_list += [ mrf_cleanup ]
 
 if __name__ == '__main__':
@@ -3141,6 +3141,50 @@ def netcdf_82():
 
     return 'success'
 
+###############################################################################
+# Test reading several bands of a 3D variable at once (single hyperslab request)
+
+def netcdf_83():
+
+    if gdaltest.netcdf_drv is None:
+        return 'skip'
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', 20, 10, 6, gdal.GDT_Int16)
+    src_ds.SetGeoTransform([2, 1, 0, 49, 0, -1])
+    src_ds.SetMetadataItem('NETCDF_DIM_EXTRA', '{time}')
+    src_ds.SetMetadataItem('NETCDF_DIM_time_DEF', '{6,6}')
+    src_ds.SetMetadataItem('NETCDF_DIM_time_VALUES', '{0,1,2,3,4,5}')
+    for i in range(6):
+        src_ds.GetRasterBand(i + 1).SetMetadataItem('NETCDF_VARNAME', 'var')
+        src_ds.GetRasterBand(i + 1).Fill(100 * i)
+        src_ds.GetRasterBand(i + 1).WriteRaster(i, 2 * i, 3, 2,
+            struct.pack('h' * 6, 1, 2, 3, 4, 5, 6 + i))
+    gdaltest.netcdf_drv.CreateCopy('tmp/netcdf_83.nc', src_ds)
+    src_ds = None
+
+    ds = gdal.Open('tmp/netcdf_83.nc')
+    for (xoff, yoff, xsize, ysize, band_list, buf_type) in [
+            (0, 0, 20, 10, [1, 2, 3, 4, 5, 6], gdal.GDT_Int16),
+            (1, 2, 5, 7, [2, 4, 6], gdal.GDT_Int16),
+            (3, 0, 4, 10, [1, 3, 5], gdal.GDT_Float64),
+            (0, 0, 20, 10, [2, 1], gdal.GDT_Int16)]:
+        got = ds.ReadRaster(xoff, yoff, xsize, ysize, buf_type=buf_type,
+                            band_list=band_list)
+        expected = b''
+        for i in band_list:
+            expected += ds.GetRasterBand(i).ReadRaster(xoff, yoff,
+                                                       xsize, ysize,
+                                                       buf_type=buf_type)
+        if got != expected:
+            gdaltest.post_reason('fail')
+            print(xoff, yoff, xsize, ysize, band_list)
+            return 'fail'
+    ds = None
+
+    gdaltest.netcdf_drv.Delete('tmp/netcdf_83.nc')
+
+    return 'success'
+
 ###############################################################################
 
 ###############################################################################
@@ -3233,7 +3277,8 @@ gdaltest_list = [
     netcdf_79,
     netcdf_80,
     netcdf_81,
-    netcdf_82
+    netcdf_82,
+    netcdf_83
 ]
 
 ###############################################################################
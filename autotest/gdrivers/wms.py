@@ -34,12 +34,14 @@ import os
 import sys
 from osgeo import gdal
 import shutil
+import threading
 from time import sleep
 import hashlib
 
 sys.path.append( '../pymod' )
 
 import gdaltest
+import webserver
 
 ###############################################################################
 # Verify we have the driver.
@@ -980,6 +982,181 @@ def wms_19():
 
     return 'success'
 ###############################################################################
+# Test ReadAhead against a local tile server: reading one block also fetches
+# its neighbours, so that reading them afterwards issues no request.
+
+def wms_20():
+
+    if gdaltest.wms_drv is None:
+        return 'skip'
+
+    (webserver_process, webserver_port) = webserver.launch(handler = webserver.DispatcherHttpHandler)
+    if webserver_port == 0:
+        return 'skip'
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', 256, 256)
+    src_ds.GetRasterBand(1).Fill(127)
+    gdal.GetDriverByName('PNG').CreateCopy('/vsimem/wms_20.png', src_ds)
+    src_ds = None
+    f = gdal.VSIFOpenL('/vsimem/wms_20.png', 'rb')
+    tile = gdal.VSIFReadL(1, 10000, f)
+    gdal.VSIFCloseL(f)
+    gdal.Unlink('/vsimem/wms_20.png')
+
+    xml = """<GDAL_WMS>
+    <Service name="TMS"><ServerUrl>http://localhost:%d/${z}/${x}/${y}.png</ServerUrl></Service>
+    <DataWindow><UpperLeftX>-20037508.34</UpperLeftX><UpperLeftY>20037508.34</UpperLeftY>
+    <LowerRightX>20037508.34</LowerRightX><LowerRightY>-20037508.34</LowerRightY>
+    <TileLevel>1</TileLevel><TileCountX>1</TileCountX><TileCountY>1</TileCountY><YOrigin>top</YOrigin></DataWindow>
+    <Projection>EPSG:3857</Projection><BlockSizeX>256</BlockSizeX><BlockSizeY>256</BlockSizeY>
+    <BandsCount>1</BandsCount><OverviewCount>0</OverviewCount>
+    <MaxConnections>1</MaxConnections><ReadAhead>1</ReadAhead>
+</GDAL_WMS>""" % webserver_port
+
+    ret = 'success'
+    ds = gdal.Open(xml)
+    if ds is None:
+        gdaltest.post_reason('fail')
+        webserver.server_stop(webserver_process, webserver_port)
+        return 'fail'
+
+    handler = webserver.SequentialHandler()
+    for (x, y) in [(0, 0), (1, 0), (0, 1), (1, 1)]:
+        handler.add('GET', '/1/%d/%d.png' % (x, y), 200,
+                    {'Content-Type': 'image/png'}, tile)
+    with webserver.install_http_handler(handler):
+        data = ds.GetRasterBand(1).ReadBlock(0, 0)
+    if data is None or len(data) != 256 * 256:
+        gdaltest.post_reason('fail')
+        ret = 'fail'
+
+    # All blocks are now in the block cache: any request would fail
+    handler = webserver.SequentialHandler()
+    gdal.ErrorReset()
+    with webserver.install_http_handler(handler):
+        with gdaltest.error_handler():
+            minmax = ds.GetRasterBand(1).ComputeRasterMinMax()
+    if gdal.GetLastErrorMsg() != '' or minmax != (127, 127):
+        gdaltest.post_reason('fail')
+        print(minmax)
+        ret = 'fail'
+
+    ds = None
+    webserver.server_stop(webserver_process, webserver_port)
+
+    return ret
+
+###############################################################################
+# Test that several threads reading the same blocks at the same time only
+# issue one request per tile, unless their requests use different credentials.
+
+class WMSCountingHandler:
+    def __init__(self, tile):
+        self.tile = tile
+        self.counts = {}
+        self.lock = threading.Lock()
+
+    def do_GET(self, request):
+        with self.lock:
+            self.counts[request.path] = self.counts.get(request.path, 0) + 1
+        # Keep the request in flight long enough for the other threads to
+        # ask for the same tile
+        sleep(0.5)
+        request.send_response(200)
+        request.send_header('Content-Type', 'image/png')
+        request.send_header('Content-Length', len(self.tile))
+        request.end_headers()
+        request.wfile.write(self.tile)
+
+def wms_21_worker(xml, results, idx):
+    ds = gdal.Open(xml)
+    if ds is not None:
+        results[idx] = ds.GetRasterBand(1).ReadRaster(0, 0, 512, 256)
+    ds = None
+
+def wms_21_read_concurrently(xmls):
+    results = [None for xml in xmls]
+    threads = []
+    for i in range(len(xmls)):
+        t = threading.Thread(target = wms_21_worker,
+                             args = (xmls[i], results, i))
+        t.start()
+        threads.append(t)
+    for t in threads:
+        t.join()
+    return results
+
+def wms_21():
+
+    if gdaltest.wms_drv is None:
+        return 'skip'
+
+    (webserver_process, webserver_port) = webserver.launch(handler = webserver.DispatcherHttpHandler)
+    if webserver_port == 0:
+        return 'skip'
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', 256, 256)
+    src_ds.GetRasterBand(1).Fill(127)
+    gdal.GetDriverByName('PNG').CreateCopy('/vsimem/wms_21.png', src_ds)
+    src_ds = None
+    f = gdal.VSIFOpenL('/vsimem/wms_21.png', 'rb')
+    tile = gdal.VSIFReadL(1, 10000, f)
+    gdal.VSIFCloseL(f)
+    gdal.Unlink('/vsimem/wms_21.png')
+
+    xml_template = """<GDAL_WMS>
+    <Service name="TMS"><ServerUrl>http://localhost:%d/${z}/${x}/${y}.png</ServerUrl></Service>
+    <DataWindow><UpperLeftX>-20037508.34</UpperLeftX><UpperLeftY>20037508.34</UpperLeftY>
+    <LowerRightX>20037508.34</LowerRightX><LowerRightY>-20037508.34</LowerRightY>
+    <TileLevel>1</TileLevel><TileCountX>1</TileCountX><TileCountY>1</TileCountY><YOrigin>top</YOrigin></DataWindow>
+    <Projection>EPSG:3857</Projection><BlockSizeX>256</BlockSizeX><BlockSizeY>256</BlockSizeY>
+    <BandsCount>1</BandsCount><OverviewCount>0</OverviewCount>%s
+</GDAL_WMS>"""
+    xml = xml_template % (webserver_port, '')
+    xml_auth = xml_template % (webserver_port, '<UserPwd>user:passwd</UserPwd>')
+
+    ret = 'success'
+
+    # 4 threads, each with its own dataset, read the same 2 blocks
+    handler = WMSCountingHandler(tile)
+    with webserver.install_http_handler(handler):
+        results = wms_21_read_concurrently([xml, xml, xml, xml])
+    for res in results:
+        if res is None or res != results[0]:
+            gdaltest.post_reason('fail')
+            ret = 'fail'
+    if handler.counts != { '/1/0/0.png': 1, '/1/1/0.png': 1 }:
+        gdaltest.post_reason('fail')
+        print(handler.counts)
+        ret = 'fail'
+
+    # Requests with different credentials must not share their response
+    handler = WMSCountingHandler(tile)
+    with webserver.install_http_handler(handler):
+        results = wms_21_read_concurrently([xml, xml_auth])
+    if results[0] is None or results[1] is None:
+        gdaltest.post_reason('fail')
+        ret = 'fail'
+    if handler.counts != { '/1/0/0.png': 2, '/1/1/0.png': 2 }:
+        gdaltest.post_reason('fail')
+        print(handler.counts)
+        ret = 'fail'
+
+    # And coalescing can be disabled
+    handler = WMSCountingHandler(tile)
+    with gdaltest.config_option('GDAL_WMS_COALESCE_REQUESTS', 'NO'):
+        with webserver.install_http_handler(handler):
+            results = wms_21_read_concurrently([xml, xml])
+    if handler.counts != { '/1/0/0.png': 2, '/1/1/0.png': 2 }:
+        gdaltest.post_reason('fail')
+        print(handler.counts)
+        ret = 'fail'
+
+    webserver.server_stop(webserver_process, webserver_port)
+
+    return ret
+
+###############################################################################
 def wms_cleanup():
 
     gdaltest.wms_ds = None
@@ -1008,6 +1185,8 @@ gdaltest_list = [
     #wms_17,
     wms_18,
     wms_19,
+    wms_20,
+    wms_21,
     wms_cleanup ]
 
 
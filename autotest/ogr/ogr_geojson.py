@@ -3891,6 +3891,54 @@ def ogr_geojson_68():
     return 'success'
 
 
+###############################################################################
+# Test that geometries read from a file, whose coordinates are not turned into
+# json-c objects, are the same as the ones read from a string
+
+def ogr_geojson_69():
+
+    content = """{"type": "FeatureCollection", "features": [
+{ "type": "Feature", "properties": {"id": 1}, "geometry": { "type": "Point", "coordinates": [1,2,3,4] } },
+{ "type": "Feature", "properties": {"id": 2}, "geometry": { "coordinates": [[1,2],[3,4,5]], "type": "LineString" } },
+{ "type": "Feature", "properties": {"id": 3}, "geometry": { "type": "Polygon", "coordinates": [[[0,0],[0,1],[1,1],[0,0]],[[0,0],[1]],[[0,0],[0.5,0.5],[0,0.5],[0,0]]] } },
+{ "type": "Feature", "properties": {"id": 4}, "geometry": { "type": "MultiPoint", "coordinates": [[1,2],[3,4,5]] } },
+{ "type": "Feature", "properties": {"id": 5}, "geometry": { "type": "MultiLineString", "coordinates": [[[1,2],[3,4]],[[1]],[[5,6],[7,8]]] } },
+{ "type": "Feature", "properties": {"id": 6}, "geometry": { "type": "MultiPolygon", "coordinates": [[[[0,0],[0,1],[1,1],[0,0]]],[],[[[5,5],[5,6],[6,6],[5,5]]]] } },
+{ "type": "Feature", "properties": {"id": 7}, "geometry": { "type": "LineString", "coordinates": [[1,2],[3,null]] } },
+{ "type": "Feature", "properties": {"id": 8}, "geometry": { "type": "MultiPolygon", "coordinates": [[[[0,0],[0,1],[1,1],[0,0]]],[[[0,0],{"a":1}]]] } },
+{ "type": "Feature", "properties": {"id": 9}, "geometry": { "type": "GeometryCollection", "geometries": [{ "type": "Point", "coordinates": [1,2] }] } },
+{ "type": "Feature", "properties": {"id": 10}, "geometry": null }
+]}"""
+
+    gdal.FileFromMemBuffer('/vsimem/ogr_geojson_69.json', content)
+    ds_file = ogr.Open('/vsimem/ogr_geojson_69.json')
+    ds_string = ogr.Open(content)
+    lyr_file = ds_file.GetLayer(0)
+    lyr_string = ds_string.GetLayer(0)
+    if lyr_file.GetFeatureCount() != 10:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    for i in range(10):
+        with gdaltest.error_handler():
+            f_file = lyr_file.GetNextFeature()
+            f_string = lyr_string.GetNextFeature()
+        g_file = f_file.GetGeometryRef()
+        g_string = f_string.GetGeometryRef()
+        if g_file is None and g_string is None:
+            continue
+        if g_file is None or g_string is None or \
+           g_file.ExportToIsoWkt() != g_string.ExportToIsoWkt():
+            gdaltest.post_reason('fail')
+            f_file.DumpReadable()
+            f_string.DumpReadable()
+            return 'fail'
+    ds_file = None
+    ds_string = None
+    gdal.Unlink('/vsimem/ogr_geojson_69.json')
+
+    return 'success'
+
+
 gdaltest_list = [
     ogr_geojson_1,
     ogr_geojson_2,
@@ -3960,6 +4008,7 @@ gdaltest_list = [
     ogr_geojson_66,
     ogr_geojson_67,
     ogr_geojson_68,
+    ogr_geojson_69,
     ogr_geojson_cleanup ]
 
 if __name__ == '__main__':
@@ -46,6 +46,7 @@ from osgeo import gdal
 from osgeo import ogr
 from osgeo import osr
 import gdaltest
+import ogrtest
 sys.path.append( '../osr' )
 import osr_proj4
 
@@ -4571,6 +4572,156 @@ CREATE TABLE "poly"("fid" INTEGER PRIMARY KEY, "geom" POLYGON);
 
     return 'success'
 
+###############################################################################
+# Test spatial filtering on the geometry blobs, without R-Tree
+
+def ogr_gpkg_58():
+
+    if gdaltest.gpkg_dr is None:
+        return 'skip'
+
+    ds = gdaltest.gpkg_dr.CreateDataSource('/vsimem/ogr_gpkg_58.gpkg')
+    lyr = ds.CreateLayer('test', geom_type = ogr.wkbUnknown,
+                         options = ['SPATIAL_INDEX=NO'])
+    for wkt in [ 'POINT (1 1)',
+                 'LINESTRING (0 0,10 10)',
+                 'POLYGON ((0 0,0 10,10 10,10 0,0 0),(2 2,2 8,8 8,8 2,2 2))',
+                 'POINT EMPTY',
+                 'MULTIPOLYGON (((20 20,20 30,30 30,30 20,20 20)))',
+                 'CIRCULARSTRING (0 0,5 5,10 0)',
+                 'LINESTRING Z (0 10 1,10 0 2)',
+                 None,
+                 'GEOMETRYCOLLECTION (POINT (50 50),LINESTRING (40 40,41 41))' ]:
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if wkt is not None:
+            f.SetGeometryDirectly(ogr.CreateGeometryFromWkt(wkt))
+        lyr.CreateFeature(f)
+    ds = None
+
+    ds = ogr.Open('/vsimem/ogr_gpkg_58.gpkg')
+    lyr = ds.GetLayer(0)
+    # Expected FIDs with GEOS, and with envelope-only intersection tests
+    for (rect, expected_geos, expected_no_geos) in [
+            ((-100, -100, 100, 100), [1, 2, 3, 5, 6, 7, 9], [1, 2, 3, 5, 6, 7, 9]),
+            ((0.5, 0.5, 1.5, 1.5), [1, 2, 3], [1, 2, 3, 6, 7]),
+            ((21, 21, 22, 22), [5], [5]),
+            ((4.9, 5.9, 5.1, 6.1), [], [2, 3, 7]),
+            ((40.2, 40.7, 40.3, 40.8), [], [9]),
+            ((60, 60, 70, 70), [], []) ]:
+        if ogrtest.have_geos():
+            expected_fids = expected_geos
+        else:
+            expected_fids = expected_no_geos
+        lyr.SetSpatialFilterRect(rect[0], rect[1], rect[2], rect[3])
+        fids = [ f.GetFID() for f in lyr ]
+        if fids != expected_fids:
+            gdaltest.post_reason('fail')
+            print(rect, fids)
+            return 'fail'
+        if lyr.GetFeatureCount() != len(expected_fids):
+            gdaltest.post_reason('fail')
+            print(rect, lyr.GetFeatureCount())
+            return 'fail'
+    lyr.SetSpatialFilter(None)
+
+    sql_lyr = ds.ExecuteSQL('SELECT ST_MinX(geom), ST_MaxY(geom), ST_IsEmpty(geom) FROM test WHERE fid IN (1, 4, 7)')
+    expected = [ [1, 1, 0], [None, None, 1], [0, 10, 0] ]
+    got = [ [ f.GetField(0), f.GetField(1), f.GetField(2) ] for f in sql_lyr ]
+    ds.ReleaseResultSet(sql_lyr)
+    if got != expected:
+        gdaltest.post_reason('fail')
+        print(got)
+        return 'fail'
+
+    ds = None
+    gdaltest.gpkg_dr.DeleteDataSource('/vsimem/ogr_gpkg_58.gpkg')
+
+    return 'success'
+
+###############################################################################
+# Test bulk loading of the deferred spatial index
+
+def ogr_gpkg_59():
+
+    if gdaltest.gpkg_dr is None:
+        return 'skip'
+
+    rtree_content = None
+    for (bulk_load, set_feature) in [ ('YES', False), ('YES', True),
+                                      ('NO', False) ]:
+        filename = '/vsimem/ogr_gpkg_59.gpkg'
+        ds = gdaltest.gpkg_dr.CreateDataSource(filename)
+        lyr = ds.CreateLayer('test', geom_type = ogr.wkbUnknown)
+        for i in range(1000):
+            f = ogr.Feature(lyr.GetLayerDefn())
+            if i % 10 == 3:
+                f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('POINT EMPTY'))
+            elif i % 10 != 7:
+                x = (i * 37) % 100
+                y = (i * 91) % 100
+                f.SetGeometryDirectly(ogr.CreateGeometryFromWkt(
+                    'LINESTRING (%d %d,%d %d)' % (x, y, x + i % 3, y + 0.5)))
+            lyr.CreateFeature(f)
+            if set_feature and i == 500:
+                # Invalidates the envelopes collected during insertion, so
+                # that the table is read back when building the index
+                f = ogr.Feature(lyr.GetLayerDefn())
+                f.SetFID(1)
+                f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('POINT (0 0)'))
+                lyr.SetFeature(f)
+                f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('LINESTRING (0 0,0 0.5)'))
+                lyr.SetFeature(f)
+        gdal.SetConfigOption('OGR_GPKG_RTREE_BULK_LOAD', bulk_load)
+        ds = None
+        gdal.SetConfigOption('OGR_GPKG_RTREE_BULK_LOAD', None)
+
+        ds = ogr.Open(filename, update = 1)
+        sql_lyr = ds.ExecuteSQL('SELECT * FROM rtree_test_geom ORDER BY id')
+        content = [ [ f.GetField(i) for i in range(5) ] for f in sql_lyr ]
+        ds.ReleaseResultSet(sql_lyr)
+        if len(content) != 800:
+            gdaltest.post_reason('fail')
+            print(bulk_load, set_feature, len(content))
+            return 'fail'
+        if rtree_content is None:
+            rtree_content = content
+        elif content != rtree_content:
+            gdaltest.post_reason('fail')
+            print(bulk_load, set_feature)
+            return 'fail'
+
+        lyr = ds.GetLayer(0)
+        lyr.SetSpatialFilterRect(10, 20, 30, 40)
+        fids = [ f.GetFID() for f in lyr ]
+        if len(fids) != 30 or lyr.GetFeatureCount() != 30:
+            gdaltest.post_reason('fail')
+            print(bulk_load, set_feature, len(fids))
+            return 'fail'
+        lyr.SetSpatialFilter(None)
+
+        # Check that the index is still maintained afterwards
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('POINT (1000 1000)'))
+        lyr.CreateFeature(f)
+        lyr.DeleteFeature(1)
+        lyr.SetSpatialFilterRect(999, 999, 1001, 1001)
+        if lyr.GetFeatureCount() != 1:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        sql_lyr = ds.ExecuteSQL('SELECT COUNT(*) FROM rtree_test_geom')
+        f = sql_lyr.GetNextFeature()
+        count = f.GetField(0)
+        ds.ReleaseResultSet(sql_lyr)
+        if count != 800:
+            gdaltest.post_reason('fail')
+            print(count)
+            return 'fail'
+        ds = None
+
+        gdaltest.gpkg_dr.DeleteDataSource(filename)
+
+    return 'success'
+
 ###############################################################################
 # Remove the test db from the tmp directory
 
@@ -4653,6 +4804,8 @@ gdaltest_list = [
     ogr_gpkg_55,
     ogr_gpkg_56,
     ogr_gpkg_57,
+    ogr_gpkg_58,
+    ogr_gpkg_59,
     ogr_gpkg_test_ogrsf,
     ogr_gpkg_cleanup,
 ]
@@ -179,7 +179,7 @@ def ogr_index_6():
         return 'fail'
 
 ###############################################################################
-# Check that range query that isn't currently implemented using index works.
+# Check that range query works using index.
 
 def ogr_index_7():
 
@@ -234,55 +234,49 @@ def ogr_index_9():
 
     gdaltest.s_ds.Release()
 
-    # After dataset closing, check that the index files do not exist after
+    # After dataset closing, check that the index file does not exist after
     # dropping the index
-    for filename in ['join_t.idm','join_t.ind']:
-        try:
-            os.stat(filename)
-            gdaltest.post_reason("%s should not exist" % filename)
-            return 'fail'
-        except:
-            pass
+    try:
+        os.stat('join_t.oix')
+        gdaltest.post_reason("join_t.oix should not exist")
+        return 'fail'
+    except OSError:
+        pass
 
     # Re-create an index
     gdaltest.s_ds = ogr.OpenShared( 'join_t.dbf', update = 1 )
     gdaltest.s_ds.ExecuteSQL( 'CREATE INDEX ON join_t USING value' )
     gdaltest.s_ds.Release()
 
-    for filename in ['join_t.idm','join_t.ind']:
-        try:
-            os.stat(filename)
-        except:
-            gdaltest.post_reason("%s should exist" % filename)
-            return 'fail'
-            pass
+    try:
+        os.stat('join_t.oix')
+    except OSError:
+        gdaltest.post_reason("join_t.oix should exist")
+        return 'fail'
 
-    f = open('join_t.idm', 'rt')
-    xml = f.read()
+    f = open('join_t.oix', 'rb')
+    data = f.read()
     f.close()
-    if xml.find('VALUE') == -1:
+    if data.find(b'VALUE') == -1:
         gdaltest.post_reason('VALUE column is not indexed (1)')
-        print(xml)
         return 'fail'
 
     # Close the dataset and re-open
     gdaltest.s_ds = ogr.OpenShared( 'join_t.dbf', update = 1 )
-    # At this point the .ind was opened in read-only. Now it
-    # will be re-opened in read-write mode
+    # At this point the .oix was opened in read-only. Now it
+    # will be rewritten
     gdaltest.s_ds.ExecuteSQL( 'CREATE INDEX ON join_t USING skey' )
 
     gdaltest.s_ds.Release()
 
-    f = open('join_t.idm', 'rt')
-    xml = f.read()
+    f = open('join_t.oix', 'rb')
+    data = f.read()
     f.close()
-    if xml.find('VALUE') == -1:
+    if data.find(b'VALUE') == -1:
         gdaltest.post_reason('VALUE column is not indexed (2)')
-        print(xml)
         return 'fail'
-    if xml.find('SKEY') == -1:
+    if data.find(b'SKEY') == -1:
         gdaltest.post_reason('SKEY column is not indexed (2)')
-        print(xml)
         return 'fail'
 
     return 'success'
@@ -493,6 +487,193 @@ def ogr_index_11():
 
     return 'success'
 
+###############################################################################
+# Test range, BETWEEN, LIKE and multi-field index lookups
+
+def ogr_index_12():
+
+    ds = ogr.GetDriverByName( 'ESRI Shapefile' ).CreateDataSource('tmp/ogr_index_12.dbf')
+    lyr = ds.CreateLayer('ogr_index_12', geom_type = ogr.wkbNone)
+    lyr.CreateField(ogr.FieldDefn('intfield', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('realfield', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('strfield', ogr.OFTString))
+
+    for i in range(100):
+        ogrtest.quick_create_feature(lyr, [i % 10, i * 0.5, 'Name %d' % i],
+                                     None)
+
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_12 USING realfield')
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_12 USING strfield')
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_12 USING intfield, realfield')
+    ds = None
+
+    ds = ogr.Open('tmp/ogr_index_12.dbf')
+    lyr = ds.GetLayer(0)
+
+    tests = [ ('realfield > 45', [ i for i in range(91, 100) ]),
+              ('realfield >= 45', [ i for i in range(90, 100) ]),
+              ('2 > realfield', [ 0, 1, 2, 3 ]),
+              ('realfield <= 1.5', [ 0, 1, 2, 3 ]),
+              ('realfield > 1 AND realfield < 3', [ 3, 4, 5 ]),
+              ('realfield BETWEEN 1 AND 2', [ 2, 3, 4 ]),
+              ("strfield LIKE 'name 9%'", [ 9 ] + [ i for i in range(90, 100) ]),
+              ("strfield LIKE 'Name 1_'", [ i for i in range(10, 20) ]),
+              ('intfield = 3 AND realfield > 40', [ 83, 93 ]),
+              ('intfield = 3 AND realfield = 1.5', [ 3 ]),
+              ('intfield = 3 AND realfield BETWEEN 10 AND 20', [ 23, 33 ]),
+              ('intfield IN (1, 2) AND realfield < 3', [ 1, 2 ]),
+              ("intfield = 5 AND strfield LIKE '%5'", [ i for i in range(5, 100, 10) ]),
+              ('realfield < 1 OR realfield > 49', [ 0, 1, 99 ]) ]
+    for (where, expected_fids) in tests:
+        lyr.SetAttributeFilter(where)
+        got_fids = [ feat.GetFID() for feat in lyr ]
+        if got_fids != expected_fids:
+            gdaltest.post_reason('failed')
+            print(where, got_fids)
+            return 'fail'
+
+    ds = None
+
+    # DROP INDEX on a multi-field index
+    ds = ogr.Open('tmp/ogr_index_12.dbf', update = 1)
+    ds.ExecuteSQL('DROP INDEX ON ogr_index_12 USING intfield, realfield')
+    lyr = ds.GetLayer(0)
+    lyr.SetAttributeFilter('intfield = 3 AND realfield > 40')
+    got_fids = [ feat.GetFID() for feat in lyr ]
+    if got_fids != [ 83, 93 ]:
+        gdaltest.post_reason('failed')
+        print(got_fids)
+        return 'fail'
+    ds = None
+
+    return 'success'
+
+###############################################################################
+# Test attribute indexes on CSV and GeoJSON files
+
+def ogr_index_13():
+
+    for (filename, content) in [
+        ('tmp/ogr_index_13.csv',
+         'id,name\n' + ''.join([ '%d,Name %d\n' % (i, i) for i in range(20) ])),
+        ('tmp/ogr_index_13.geojson',
+         '{"type":"FeatureCollection","features":[' +
+         ','.join([ '{"type":"Feature","properties":{"id":%d,"name":"Name %d"},"geometry":null}' % (i, i) for i in range(20) ]) +
+         ']}') ]:
+
+        f = open(filename, 'wt')
+        f.write(content)
+        f.close()
+
+        ds = ogr.Open(filename)
+        lyr = ds.GetLayer(0)
+        ds.ExecuteSQL('CREATE INDEX ON %s USING name' % lyr.GetName())
+        ds = None
+
+        try:
+            os.stat(filename + '.oix')
+        except OSError:
+            gdaltest.post_reason("%s.oix should exist" % filename)
+            return 'fail'
+
+        ds = ogr.Open(filename)
+        lyr = ds.GetLayer(0)
+        lyr.SetAttributeFilter("name = 'Name 12' OR name LIKE 'Name 1_'")
+        got = [ feat.GetField('name') for feat in lyr ]
+        if got != [ 'Name %d' % i for i in range(10, 20) ]:
+            gdaltest.post_reason('failed')
+            print(filename, got)
+            return 'fail'
+        lyr.SetAttributeFilter("name = 'Name 5'")
+        if lyr.GetFeatureCount() != 1:
+            gdaltest.post_reason('failed')
+            return 'fail'
+        ds = None
+
+        os.unlink(filename)
+        os.unlink(filename + '.oix')
+
+    return 'success'
+
+###############################################################################
+# Test that an index is not used once the indexed file has been modified
+
+def ogr_index_14():
+
+    from osgeo import gdal
+
+    filename = 'tmp/ogr_index_14.csv'
+    f = open(filename, 'wt')
+    f.write('id,name,val\n1,alpha,10\n2,beta,20\n3,alps,30\n4,Alpine,40\n5,gamma,50\n')
+    f.close()
+
+    ds = ogr.Open(filename)
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_14 USING name')
+    ds = None
+
+    f = open(filename, 'at')
+    f.write('6,alpine,60\n')
+    f.close()
+
+    for expected_warning in [ True, False ]:
+        gdal.ErrorReset()
+        with gdaltest.error_handler():
+            ds = ogr.Open(filename)
+        if (gdal.GetLastErrorMsg() != '') != expected_warning:
+            gdaltest.post_reason('failed')
+            print(gdal.GetLastErrorMsg())
+            return 'fail'
+        lyr = ds.GetLayer(0)
+        lyr.SetAttributeFilter("name LIKE 'alp%'")
+        got_fids = [ feat.GetFID() for feat in lyr ]
+        if got_fids != [ 1, 3, 4, 6 ]:
+            gdaltest.post_reason('failed')
+            print(got_fids)
+            return 'fail'
+
+        # Rebuild the index
+        lyr.SetAttributeFilter(None)
+        ds.ExecuteSQL('CREATE INDEX ON ogr_index_14 USING name')
+        ds = None
+
+    os.unlink(filename)
+    os.unlink(filename + '.oix')
+
+    # Writes to a shapefile in update mode
+    ds = ogr.GetDriverByName( 'ESRI Shapefile' ).CreateDataSource('tmp/ogr_index_14.dbf')
+    lyr = ds.CreateLayer('ogr_index_14', geom_type = ogr.wkbNone)
+    lyr.CreateField(ogr.FieldDefn('intfield', ogr.OFTInteger))
+    for i in range(10):
+        ogrtest.quick_create_feature(lyr, [i], None)
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_14 USING intfield')
+    ds = None
+
+    ds = ogr.Open('tmp/ogr_index_14.dbf', update = 1)
+    lyr = ds.GetLayer(0)
+    feat = lyr.GetFeature(2)
+    feat.SetField(0, 5)
+    lyr.SetFeature(feat)
+    lyr.SetAttributeFilter('intfield = 5')
+    got_fids = [ feat.GetFID() for feat in lyr ]
+    if got_fids != [ 2, 5 ]:
+        gdaltest.post_reason('failed')
+        print(got_fids)
+        return 'fail'
+    ds = None
+
+    with gdaltest.error_handler():
+        ds = ogr.Open('tmp/ogr_index_14.dbf')
+    lyr = ds.GetLayer(0)
+    lyr.SetAttributeFilter('intfield = 5')
+    got_fids = [ feat.GetFID() for feat in lyr ]
+    if got_fids != [ 2, 5 ]:
+        gdaltest.post_reason('failed')
+        print(got_fids)
+        return 'fail'
+    ds = None
+
+    return 'success'
+
 ###############################################################################
 
 def ogr_index_cleanup():
@@ -510,18 +691,22 @@ def ogr_index_cleanup():
     ogr.GetDriverByName( 'MapInfo File' ).DeleteDataSource( 'index_p.mif' )
     ogr.GetDriverByName( 'ESRI Shapefile' ).DeleteDataSource( 'join_t.dbf' )
 
-    for filename in ['join_t.idm','join_t.ind']:
+    for filename in ['join_t.oix','join_t.idm','join_t.ind']:
         try:
             os.stat(filename)
             gdaltest.post_reason("%s should not exist" % filename)
             return 'fail'
-        except:
+        except OSError:
             pass
 
     ogr.GetDriverByName( 'ESRI Shapefile' ).DeleteDataSource(
         'tmp/ogr_index_10.shp' )
     ogr.GetDriverByName( 'ESRI Shapefile' ).DeleteDataSource(
         'tmp/ogr_index_11.dbf' )
+    ogr.GetDriverByName( 'ESRI Shapefile' ).DeleteDataSource(
+        'tmp/ogr_index_12.dbf' )
+    ogr.GetDriverByName( 'ESRI Shapefile' ).DeleteDataSource(
+        'tmp/ogr_index_14.dbf' )
 
     return 'success'
 
@@ -537,6 +722,9 @@ gdaltest_list = [
     ogr_index_9,
     ogr_index_10,
     ogr_index_11,
+    ogr_index_12,
+    ogr_index_13,
+    ogr_index_14,
     ogr_index_cleanup ]
 
 if __name__ == '__main__':
@@ -838,6 +838,36 @@ def ogr_mem_17():
 
     return 'success'
 
+###############################################################################
+# Test non rectangular spatial filter
+
+def ogr_mem_18():
+
+    ds = gdal.GetDriverByName('Memory').Create('', 0, 0, 0, gdal.GDT_Unknown)
+    lyr = ds.CreateLayer('ogr_mem_18')
+    for wkt in [ 'POINT (5 50)',
+                 'POINT (50 50)',
+                 'LINESTRING (50 5,50 50)',
+                 'POLYGON ((30 30,70 30,70 70,30 70,30 30))' ]:
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetGeometry(ogr.CreateGeometryFromWkt(wkt))
+        lyr.CreateFeature(f)
+
+    # L shaped filter: features in its concave part must be rejected, even
+    # without GEOS
+    lyr.SetSpatialFilter(ogr.CreateGeometryFromWkt(
+        'POLYGON ((0 0,100 0,100 10,10 10,10 100,0 100,0 0))'))
+    fids = [ f.GetFID() for f in lyr ]
+    if fids != [0, 2]:
+        gdaltest.post_reason('fail')
+        print(fids)
+        return 'fail'
+    if lyr.GetFeatureCount() != 2:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    return 'success'
+
 def ogr_mem_cleanup():
 
     if gdaltest.mem_ds is None:
@@ -866,6 +896,7 @@ gdaltest_list = [
     ogr_mem_15,
     ogr_mem_16,
     ogr_mem_17,
+    ogr_mem_18,
     ogr_mem_cleanup ]
 
 if __name__ == '__main__':
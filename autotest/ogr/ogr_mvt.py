@@ -37,6 +37,7 @@ import gdaltest
 import ogrtest
 from osgeo import gdal
 from osgeo import ogr
+from osgeo import osr
 
 ###############################################################################
 
@@ -596,6 +597,119 @@ def ogr_mvt_polygon_larger_than_header():
 
     return 'success'
 
+###############################################################################
+
+def ogr_mvt_write_directory():
+
+    if ogr.GetDriverByName('MVT').GetMetadataItem(gdal.DCAP_CREATE) is None:
+        return 'skip'
+
+    src_ds = gdal.GetDriverByName('Memory').Create('', 0, 0, 0, gdal.GDT_Unknown)
+    lyr = src_ds.CreateLayer('mylayer')
+    lyr.CreateField(ogr.FieldDefn('strfield', ogr.OFTString))
+    lyr.CreateField(ogr.FieldDefn('intfield', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('int64field', ogr.OFTInteger64))
+    lyr.CreateField(ogr.FieldDefn('realfield', ogr.OFTReal))
+    f = ogr.Feature(lyr.GetLayerDefn())
+    f['strfield'] = 'foo'
+    f['intfield'] = -1
+    f['int64field'] = 123456789012345
+    f['realfield'] = 1.25
+    f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(500000 1000000)'))
+    lyr.CreateFeature(f)
+    f = ogr.Feature(lyr.GetLayerDefn())
+    f.SetGeometry(ogr.CreateGeometryFromWkt('POLYGON((-1000000 -1000000,-1000000 1000000,1000000 1000000,1000000 -1000000,-1000000 -1000000),(-100000 -100000,100000 -100000,100000 100000,-100000 100000,-100000 -100000))'))
+    lyr.CreateFeature(f)
+
+    for num_threads in ['1', '2']:
+        out_filename = '/vsimem/outmvt_' + num_threads
+        out_ds = gdal.VectorTranslate(out_filename, src_ds, format='MVT',
+                                      dstSRS='EPSG:3857',
+                                      datasetCreationOptions=['MAXZOOM=2',
+                                        'NUM_THREADS=' + num_threads])
+        if out_ds is None:
+            return 'fail'
+        out_ds = None
+
+    for z, x, y in [(0, 0, 0), (1, 0, 0), (1, 1, 1), (2, 1, 1), (2, 2, 2)]:
+        filename = '/%d/%d/%d.pbf' % (z, x, y)
+        f = gdal.VSIFOpenL('/vsimem/outmvt_1' + filename, 'rb')
+        if f is None:
+            print(filename)
+            return 'fail'
+        data1 = gdal.VSIFReadL(1, 100000, f)
+        gdal.VSIFCloseL(f)
+        f = gdal.VSIFOpenL('/vsimem/outmvt_2' + filename, 'rb')
+        data2 = gdal.VSIFReadL(1, 100000, f)
+        gdal.VSIFCloseL(f)
+        if data1 != data2:
+            print(filename)
+            return 'fail'
+
+    ds = ogr.Open('/vsimem/outmvt_1/0')
+    lyr = ds.GetLayer(0)
+    if lyr.GetName() != 'mylayer' or lyr.GetFeatureCount() != 2:
+        return 'fail'
+    lyr_defn = lyr.GetLayerDefn()
+    idx = lyr_defn.GetFieldIndex('int64field')
+    if lyr_defn.GetFieldDefn(idx).GetType() != ogr.OFTInteger64:
+        return 'fail'
+    f = lyr.GetNextFeature()
+    if f['strfield'] != 'foo' or f['intfield'] != -1 or \
+       f['int64field'] != 123456789012345 or f['realfield'] != 1.25:
+        f.DumpReadable()
+        return 'fail'
+    if ogrtest.check_feature_geometry(f, 'POINT (498980 997961)', max_error=10000) != 0:
+        f.DumpReadable()
+        return 'fail'
+    f = lyr.GetNextFeature()
+    if f.GetGeometryRef().GetGeometryType() != ogr.wkbPolygon or \
+       f.GetGeometryRef().GetGeometryCount() != 2:
+        f.DumpReadable()
+        return 'fail'
+
+    for num_threads in ['1', '2']:
+        gdal.RmdirRecursive('/vsimem/outmvt_' + num_threads)
+
+    return 'success'
+
+###############################################################################
+
+def ogr_mvt_write_mbtiles():
+
+    if ogr.GetDriverByName('MVT').GetMetadataItem(gdal.DCAP_CREATE) is None:
+        return 'skip'
+    if ogr.GetDriverByName('MBTILES') is None:
+        return 'skip'
+
+    src_ds = gdal.GetDriverByName('Memory').Create('', 0, 0, 0, gdal.GDT_Unknown)
+    srs = osr.SpatialReference()
+    srs.SetFromUserInput('WGS84')
+    lyr = src_ds.CreateLayer('mylayer', srs=srs)
+    for wkt in ['POINT(2 49)', 'POINT(-120 35)', 'LINESTRING(150 -30,151 -31)']:
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetGeometry(ogr.CreateGeometryFromWkt(wkt))
+        lyr.CreateFeature(f)
+
+    gdal.VectorTranslate('/vsimem/out.mbtiles', src_ds, format='MVT',
+                         datasetCreationOptions=['MAXZOOM=3',
+                                                 'NUM_THREADS=2'])
+    ds = ogr.Open('/vsimem/out.mbtiles')
+    if ds is None:
+        return 'fail'
+    if ds.GetMetadataItem('maxzoom') != '3' or \
+       ds.GetMetadataItem('format') != 'pbf':
+        print(ds.GetMetadata())
+        return 'fail'
+    lyr = ds.GetLayer(0)
+    if lyr.GetName() != 'mylayer' or lyr.GetFeatureCount() != 3:
+        return 'fail'
+    ds = None
+
+    gdal.Unlink('/vsimem/out.mbtiles')
+
+    return 'success'
+
 ###############################################################################
 #
 
@@ -622,6 +736,8 @@ gdaltest_list = [
     ogr_mvt_mbtiles_test_ogrsf,
     ogr_mvt_x_y_z_filename_scheme,
     ogr_mvt_polygon_larger_than_header,
+    ogr_mvt_write_directory,
+    ogr_mvt_write_mbtiles,
 ]
 
 if __name__ == '__main__':
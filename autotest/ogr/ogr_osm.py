@@ -969,6 +969,44 @@ def ogr_osm_18():
 
     return 'success'
 
+###############################################################################
+# Test that way geometries built by several threads, with and without node
+# compression, are identical to the ones built sequentially
+
+def ogr_osm_19():
+
+    if ogrtest.osm_drv is None:
+        return 'skip'
+
+    ref_wkts = None
+    for compress_nodes in ['NO', 'YES']:
+        for num_threads in ['1', '4']:
+            ds = gdal.OpenEx('data/test.pbf',
+                             open_options=['COMPRESS_NODES=' + compress_nodes,
+                                           'NUM_THREADS=' + num_threads])
+            wkts = []
+            for lyr_name in ['lines', 'multipolygons']:
+                lyr = ds.GetLayerByName(lyr_name)
+                for f in lyr:
+                    wkts.append(f.GetGeometryRef().ExportToWkt())
+            ds = None
+
+            if ref_wkts is None:
+                ref_wkts = wkts
+            elif wkts != ref_wkts:
+                gdaltest.post_reason('fail')
+                print(compress_nodes, num_threads)
+                print(wkts)
+                print(ref_wkts)
+                return 'fail'
+
+    if len(ref_wkts) != 5:
+        gdaltest.post_reason('fail')
+        print(ref_wkts)
+        return 'fail'
+
+    return 'success'
+
 gdaltest_list = [
     ogr_osm_1,
     ogr_osm_2,
@@ -993,6 +1031,7 @@ gdaltest_list = [
     ogr_osm_16,
     ogr_osm_17,
     ogr_osm_18,
+    ogr_osm_19,
     ]
 
 if __name__ == '__main__':
@@ -5273,6 +5273,102 @@ def ogr_shape_108():
 
     return 'success'
 
+###############################################################################
+# Test SPATIAL_SORT=YES creation option
+
+def ogr_shape_109():
+
+    filename = '/vsimem/ogr_shape_109.shp'
+    shape_drv = ogr.GetDriverByName('ESRI Shapefile')
+    ds = shape_drv.CreateDataSource(filename)
+    lyr = ds.CreateLayer('ogr_shape_109', geom_type = ogr.wkbPoint,
+                         options = ['SPATIAL_SORT=YES', 'SPATIAL_INDEX=YES'])
+    lyr.CreateField(ogr.FieldDefn('name', ogr.OFTString))
+    for j in range(4):
+        for i in range(4):
+            f = ogr.Feature(lyr.GetLayerDefn())
+            f['name'] = '%d_%d' % (i, j)
+            f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (i, j)))
+            lyr.CreateFeature(f)
+    # Deleted records must not be written
+    f = ogr.Feature(lyr.GetLayerDefn())
+    f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(1.5 1.5)'))
+    lyr.CreateFeature(f)
+    lyr.DeleteFeature(f.GetFID())
+    ds = None
+
+    if gdal.VSIStatL('/vsimem/ogr_shape_109.qix') is None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    if lyr.GetFeatureCount() != 16:
+        gdaltest.post_reason('fail')
+        print(lyr.GetFeatureCount())
+        return 'fail'
+    # Consecutive features along a Hilbert curve are neighbours
+    prev = None
+    for f in lyr:
+        x = int(f.GetGeometryRef().GetX())
+        y = int(f.GetGeometryRef().GetY())
+        if f['name'] != '%d_%d' % (x, y):
+            gdaltest.post_reason('fail')
+            f.DumpReadable()
+            return 'fail'
+        if prev is not None and abs(x - prev[0]) + abs(y - prev[1]) != 1:
+            gdaltest.post_reason('fail')
+            f.DumpReadable()
+            return 'fail'
+        prev = (x, y)
+    lyr.SetSpatialFilterRect(-0.5, -0.5, 1.5, 1.5)
+    if lyr.GetFeatureCount() != 4:
+        gdaltest.post_reason('fail')
+        print(lyr.GetFeatureCount())
+        return 'fail'
+    ds = None
+
+    shape_drv.DeleteDataSource( filename )
+
+    return 'success'
+
+###############################################################################
+# Test attribute filters evaluated before reading the geometry, and reading
+# with and without SHAPE_READ_BUFFER_SIZE
+
+def ogr_shape_110():
+
+    for buffer_size in [ None, '0', '100' ]:
+        gdal.SetConfigOption('SHAPE_READ_BUFFER_SIZE', buffer_size)
+        ds = ogr.Open('data/poly.shp')
+        gdal.SetConfigOption('SHAPE_READ_BUFFER_SIZE', None)
+        lyr = ds.GetLayer(0)
+
+        for (where, expected_fids) in [
+                ('EAS_ID > 170 OR FID = 2', [1, 2, 3, 4]),
+                ("PRFEDEA = '35043413'", [9]),
+                ('OGR_GEOM_AREA > 300000', [3, 7, 8])]:
+            lyr.SetAttributeFilter(where)
+            fids = []
+            for f in lyr:
+                if f.GetGeometryRef() is None or f['EAS_ID'] is None:
+                    gdaltest.post_reason('fail')
+                    f.DumpReadable()
+                    return 'fail'
+                fids.append(f.GetFID())
+            if fids != expected_fids:
+                gdaltest.post_reason('fail')
+                print(buffer_size, where, fids)
+                return 'fail'
+
+        lyr.SetAttributeFilter(None)
+        if lyr.GetFeatureCount() != 10:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        ds = None
+
+    return 'success'
+
 ###############################################################################
 def ogr_shape_cleanup():
 
@@ -5425,6 +5521,8 @@ gdaltest_list = [
     ogr_shape_106,
     ogr_shape_107,
     ogr_shape_108,
+    ogr_shape_109,
+    ogr_shape_110,
     ogr_shape_cleanup ]
 
 # gdaltest_list = [ ogr_shape_107 ]
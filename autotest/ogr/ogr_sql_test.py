@@ -1543,6 +1543,369 @@ def ogr_sql_48():
     return 'success'
 
 
+###############################################################################
+# Test ORDER BY with spilling of sorted runs to temporary files
+
+def ogr_sql_49():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('test', geom_type = ogr.wkbNone)
+    lyr.CreateField( ogr.FieldDefn( 'int_field', ogr.OFTInteger) )
+    lyr.CreateField( ogr.FieldDefn( 'str_field', ogr.OFTString) )
+    for i in range(1000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if (i % 3) != 0:
+            f.SetField(0, (i * 7) % 100)
+        if (i % 5) != 0:
+            f.SetField(1, 'val%04d' % ((i * 13) % 1000))
+        lyr.CreateFeature(f)
+
+    expected = []
+    for f in lyr:
+        int_val = f['int_field'] if f.IsFieldSetAndNotNull('int_field') else None
+        str_val = f['str_field'] if f.IsFieldSetAndNotNull('str_field') else None
+        expected.append((int_val is not None, int_val,
+                         str_val is not None, str_val, f.GetFID()))
+    # NULL sorts first in ascending order, and last in descending order
+    expected.sort(key=lambda x: x[3] if x[3] is not None else '', reverse=True)
+    expected.sort(key=lambda x: (x[0], x[1] if x[1] is not None else 0))
+    expected_fids = [x[4] for x in expected]
+
+    # Small memory budget and fan-in so that several merge passes are needed
+    with gdaltest.config_options({'OGR_SQL_SORT_MAX_MEMORY': '2000',
+                                  'OGR_SQL_SORT_MAX_MERGED_RUNS': '4'}):
+        sql_lyr = ds.ExecuteSQL(
+            'SELECT * FROM test ORDER BY int_field, str_field DESC')
+        got_fids = [f.GetFID() for f in sql_lyr]
+        if got_fids != expected_fids:
+            gdaltest.post_reason('fail')
+            print(got_fids[0:20])
+            print(expected_fids[0:20])
+            ds.ReleaseResultSet(sql_lyr)
+            return 'fail'
+
+        sql_lyr.SetNextByIndex(500)
+        f = sql_lyr.GetNextFeature()
+        if f.GetFID() != expected_fids[500]:
+            gdaltest.post_reason('fail')
+            ds.ReleaseResultSet(sql_lyr)
+            return 'fail'
+        ds.ReleaseResultSet(sql_lyr)
+
+    return 'success'
+
+###############################################################################
+# Test ORDER BY ... LIMIT ... OFFSET (top-N heap)
+
+def ogr_sql_50():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('test', geom_type = ogr.wkbNone)
+    lyr.CreateField( ogr.FieldDefn( 'int_field', ogr.OFTInteger) )
+    for i in range(1000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetField(0, (i * 7) % 100)
+        lyr.CreateFeature(f)
+
+    # Stable sort on (value, FID)
+    expected_fids = sorted(range(1000), key=lambda i: ((i * 7) % 100, i))
+
+    for (limit, offset) in [(1, 0), (10, 0), (10, 25), (5, 998), (2000, 0)]:
+        sql_lyr = ds.ExecuteSQL(
+            'SELECT * FROM test ORDER BY int_field LIMIT %d OFFSET %d' %
+            (limit, offset))
+        got_fids = [f.GetFID() for f in sql_lyr]
+        ds.ReleaseResultSet(sql_lyr)
+        if got_fids != expected_fids[offset:offset+limit]:
+            gdaltest.post_reason('fail')
+            print(limit, offset, got_fids)
+            return 'fail'
+
+    sql_lyr = ds.ExecuteSQL(
+        'SELECT * FROM test ORDER BY int_field DESC LIMIT 3')
+    got_vals = [f['int_field'] for f in sql_lyr]
+    ds.ReleaseResultSet(sql_lyr)
+    if got_vals != [99, 99, 99]:
+        gdaltest.post_reason('fail')
+        print(got_vals)
+        return 'fail'
+
+    # If the heap cannot be allocated, no feature must be returned rather
+    # than unsorted ones
+    with gdaltest.config_option('OGR_SQL_SORT_MAX_MEMORY',
+                                '4611686018427387904'):
+        sql_lyr = ds.ExecuteSQL(
+            'SELECT * FROM test ORDER BY int_field LIMIT 1000000000000000')
+        gdal.ErrorReset()
+        with gdaltest.error_handler():
+            f = sql_lyr.GetNextFeature()
+        ds.ReleaseResultSet(sql_lyr)
+    if f is not None or gdal.GetLastErrorMsg() == '':
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test that compiled attribute filters give the same results as the
+# evaluation of the expression tree
+
+def ogr_sql_51():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('test', geom_type = ogr.wkbNone)
+    lyr.CreateField( ogr.FieldDefn( 'int_field', ogr.OFTInteger) )
+    lyr.CreateField( ogr.FieldDefn( 'int64_field', ogr.OFTInteger64) )
+    lyr.CreateField( ogr.FieldDefn( 'real_field', ogr.OFTReal) )
+    lyr.CreateField( ogr.FieldDefn( 'str_field', ogr.OFTString) )
+    fld_defn = ogr.FieldDefn( 'bool_field', ogr.OFTInteger)
+    fld_defn.SetSubType(ogr.OFSTBoolean)
+    lyr.CreateField( fld_defn )
+    lyr.CreateField( ogr.FieldDefn( 'dt_field', ogr.OFTDateTime) )
+    for i in range(50):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if (i % 7) != 0:
+            f['int_field'] = i % 10
+        if (i % 11) != 0:
+            f['int64_field'] = 1234567890123 + i
+        if (i % 5) != 0:
+            f['real_field'] = i * 1.5
+        if (i % 6) != 0:
+            f['str_field'] = 'Val%d' % (i % 8)
+        if (i % 4) != 0:
+            f['bool_field'] = i % 2
+        if (i % 3) != 0:
+            f['dt_field'] = '2018/01/%02d 12:34:56' % (1 + i % 28)
+        lyr.CreateFeature(f)
+
+    filters = [
+        'int_field = 3',
+        'int_field <> 3',
+        'int_field > 3 AND int_field <= 8',
+        'int_field < 2 OR int_field >= 8',
+        'NOT (int_field = 5)',
+        'int_field IS NULL',
+        'int_field IS NOT NULL',
+        'int_field IN (1, 3, 5)',
+        'int_field BETWEEN 2 AND 4',
+        'int_field + 1 = 5',
+        'int_field * 2 - 1 > 10',
+        'int_field / 2 = 2',
+        'int_field % 3 = 0',
+        'int64_field > 1234567890140',
+        'int64_field - 1234567890123 < 10',
+        'real_field > 30',
+        'real_field = 7.5',
+        'real_field IN (3, 4.5, 6)',
+        'real_field BETWEEN 10 AND 20.5',
+        'real_field / 0 > 1',
+        'real_field + int_field > 20',
+        'int_field > 3.5',
+        "str_field = 'val3'",
+        "str_field <> 'Val3'",
+        "str_field > 'Val4'",
+        "str_field IN ('Val1', 'val2')",
+        "str_field BETWEEN 'Val2' AND 'Val4'",
+        "str_field LIKE 'Val_'",
+        "str_field LIKE '%3'",
+        "str_field || 'x' = 'Val3x'",
+        "str_field IS NULL OR int_field = 1",
+        "bool_field",
+        "bool_field AND int_field > 2",
+        "NOT bool_field",
+        "bool_field OR int_field = 4",
+        "int_field = 1 OR bool_field",
+        "dt_field > '2018/01/10 00:00:00'",
+        "dt_field > '2018/01/10 00:00:00' AND int_field < 5",
+        "int_field < 5 OR dt_field = '2018/01/05 12:34:56'",
+        "FID > 40",
+        "FID IN (1, 2, 3) OR real_field < 3",
+        "CAST(int_field AS CHARACTER) = '3'",
+        "OGR_GEOMETRY IS NULL",
+    ]
+
+    for flt in filters:
+        results = []
+        for compile_expr in ['YES', 'NO']:
+            with gdaltest.config_option('OGR_SQL_COMPILE_EXPRESSIONS',
+                                        compile_expr):
+                if lyr.SetAttributeFilter(flt) != 0:
+                    gdaltest.post_reason('fail')
+                    print(flt)
+                    return 'fail'
+                results.append([f.GetFID() for f in lyr])
+        lyr.SetAttributeFilter(None)
+        if results[0] != results[1]:
+            gdaltest.post_reason('fail')
+            print(flt)
+            print(results)
+            return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test GROUP BY
+
+def ogr_sql_52():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('test', geom_type = ogr.wkbNone)
+    lyr.CreateField( ogr.FieldDefn( 'cat', ogr.OFTString) )
+    lyr.CreateField( ogr.FieldDefn( 'sub', ogr.OFTInteger) )
+    lyr.CreateField( ogr.FieldDefn( 'val', ogr.OFTReal) )
+    rows = [ ('a', 1, 1.5), ('b', 1, 2.0), ('a', 2, 3.0), (None, 1, 4.0),
+             ('b', 1, None), ('a', 1, 5.5), ('c', 3, 6.0), (None, 2, 7.0) ]
+    for (cat, sub, val) in rows:
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if cat is not None:
+            f['cat'] = cat
+        f['sub'] = sub
+        if val is not None:
+            f['val'] = val
+        lyr.CreateFeature(f)
+
+    # Groups come in order of first occurrence
+    sql_lyr = ds.ExecuteSQL(
+        'SELECT cat, COUNT(*), COUNT(val), SUM(val), AVG(val), MIN(val), '
+        'MAX(val), COUNT(DISTINCT sub) FROM test GROUP BY cat')
+    got = [ [f.GetField(i) for i in range(f.GetFieldCount())]
+            for f in sql_lyr ]
+    ds.ReleaseResultSet(sql_lyr)
+    expected = [ [ 'a', 3, 3, 10.0, 10.0 / 3, 1.5, 5.5, 2 ],
+                 [ 'b', 2, 1, 2.0, 2.0, 2.0, 2.0, 1 ],
+                 [ None, 2, 2, 11.0, 5.5, 4.0, 7.0, 2 ],
+                 [ 'c', 1, 1, 6.0, 6.0, 6.0, 6.0, 1 ] ]
+    if got != expected:
+        gdaltest.post_reason('fail')
+        print(got)
+        return 'fail'
+
+    sql_lyr = ds.ExecuteSQL(
+        'SELECT cat, sub, COUNT(*) AS cnt FROM test WHERE val IS NOT NULL '
+        'GROUP BY cat, sub ORDER BY cnt DESC, cat')
+    if sql_lyr.GetFeatureCount() != 6:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    got = [ (f['cat'], f['sub'], f['cnt']) for f in sql_lyr ]
+    ds.ReleaseResultSet(sql_lyr)
+    expected = [ ('a', 1, 2), (None, 1, 1), (None, 2, 1), ('a', 2, 1),
+                 ('b', 1, 1), ('c', 3, 1) ]
+    if got != expected:
+        gdaltest.post_reason('fail')
+        print(got)
+        return 'fail'
+
+    sql_lyr = ds.ExecuteSQL(
+        'SELECT sub, MAX(val) FROM test GROUP BY sub '
+        'ORDER BY MAX_val DESC LIMIT 2 OFFSET 1')
+    got = [ (f['sub'], f['MAX_val']) for f in sql_lyr ]
+    ds.ReleaseResultSet(sql_lyr)
+    if got != [ (3, 6.0), (1, 5.5) ]:
+        gdaltest.post_reason('fail')
+        print(got)
+        return 'fail'
+
+    # Attribute filter on the result
+    sql_lyr = ds.ExecuteSQL(
+        'SELECT cat, COUNT(*) AS cnt FROM test GROUP BY cat')
+    sql_lyr.SetAttributeFilter('cnt >= 2')
+    got = [ f['cat'] for f in sql_lyr ]
+    ds.ReleaseResultSet(sql_lyr)
+    if got != [ 'a', 'b', None ]:
+        gdaltest.post_reason('fail')
+        print(got)
+        return 'fail'
+
+    for sql in [ 'SELECT cat, sub FROM test GROUP BY cat',
+                 'SELECT cat, COUNT(*) FROM test GROUP BY foo',
+                 'SELECT DISTINCT cat FROM test GROUP BY cat',
+                 'SELECT cat, COUNT(*) FROM test GROUP BY cat ORDER BY val' ]:
+        with gdaltest.error_handler():
+            sql_lyr = ds.ExecuteSQL(sql)
+        if sql_lyr is not None:
+            gdaltest.post_reason('fail')
+            print(sql)
+            ds.ReleaseResultSet(sql_lyr)
+            return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test parallel GROUP BY on a shapefile, including deleted records
+
+class ogr_sql_53_debug_handler:
+    def __init__(self):
+        self.msgs = []
+
+    def handler(self, eErrClass, err_no, msg):
+        if msg.find('GROUP BY') >= 0:
+            self.msgs.append(msg[msg.find('GROUP BY'):])
+
+def ogr_sql_53():
+
+    filename = 'tmp/ogr_sql_53.shp'
+    ds = ogr.GetDriverByName('ESRI Shapefile').CreateDataSource(filename)
+    lyr = ds.CreateLayer('ogr_sql_53', geom_type = ogr.wkbPoint)
+    lyr.CreateField( ogr.FieldDefn( 'cat', ogr.OFTInteger) )
+    lyr.CreateField( ogr.FieldDefn( 'val', ogr.OFTReal) )
+    for i in range(1000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f['cat'] = (i * 13) % 17
+        f['val'] = i * 0.5
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d 0)' % i))
+        lyr.CreateFeature(f)
+    ds = None
+
+    ds = gdal.OpenEx(filename, gdal.OF_VECTOR | gdal.OF_UPDATE,
+                     open_options = ['AUTO_REPACK=NO'])
+    lyr = ds.GetLayer(0)
+    for fid in list(range(240, 260)) + [0, 500, 999]:
+        lyr.DeleteFeature(fid)
+    ds = None
+
+    ds = ogr.Open(filename)
+    sqls = [ 'SELECT cat, COUNT(*), SUM(val), MIN(val), MAX(OGR_GEOM_AREA) '
+             'FROM ogr_sql_53 GROUP BY cat',
+             'SELECT cat, AVG(val) FROM ogr_sql_53 WHERE val > 100 '
+             'GROUP BY cat ORDER BY cat DESC' ]
+    for sql in sqls:
+        results = []
+        for num_threads in [ '1', '4' ]:
+            handler = ogr_sql_53_debug_handler()
+            with gdaltest.config_options(
+                    { 'OGR_SQL_NUM_THREADS': num_threads,
+                      'OGR_SQL_PARALLEL_MIN_FEATURES': '10',
+                      'CPL_DEBUG': 'ON' }):
+                gdal.PushErrorHandler(handler.handler)
+                sql_lyr = ds.ExecuteSQL(sql)
+                results.append(
+                    [ [f.GetField(i) for i in range(f.GetFieldCount())]
+                      for f in sql_lyr ])
+                ds.ReleaseResultSet(sql_lyr)
+                gdal.PopErrorHandler()
+            # Check that the parallel path was actually taken
+            expected = [] if num_threads == '1' else \
+                [ 'GROUP BY aggregated with 4 threads.' ]
+            if handler.msgs != expected:
+                gdaltest.post_reason('fail')
+                print(sql)
+                print(handler.msgs)
+                return 'fail'
+        if results[0] != results[1] or len(results[0]) != 17:
+            gdaltest.post_reason('fail')
+            print(sql)
+            print(results)
+            return 'fail'
+        if sql == sqls[0] and sum(r[1] for r in results[0]) != 977:
+            gdaltest.post_reason('fail')
+            print(results[0])
+            return 'fail'
+    ds = None
+
+    ogr.GetDriverByName('ESRI Shapefile').DeleteDataSource(filename)
+
+    return 'success'
+
 def ogr_sql_cleanup():
     gdaltest.lyr = None
     gdaltest.ds = None
@@ -1600,6 +1963,11 @@ gdaltest_list = [
     ogr_sql_46,
     ogr_sql_47,
     ogr_sql_48,
+    ogr_sql_49,
+    ogr_sql_50,
+    ogr_sql_51,
+    ogr_sql_52,
+    ogr_sql_53,
     ogr_sql_cleanup ]
 
 if __name__ == '__main__':
@@ -37,6 +37,7 @@ sys.path.append( '../pymod' )
 
 from osgeo import gdal
 import gdaltest
+import ogrtest
 from osgeo import osr
 from osgeo import ogr
 
@@ -322,6 +323,71 @@ def osr_ct_8():
 
     return 'success'
 
+###############################################################################
+# Test WGS84 -> WebMercator optimized transform, and transformation of
+# multi-part geometries in a single batch
+
+def osr_ct_9():
+
+    if gdaltest.have_proj4 == 0:
+        return 'skip'
+
+    src_srs = osr.SpatialReference()
+    src_srs.SetWellKnownGeogCS( 'WGS84' )
+
+    dst_srs = osr.SpatialReference()
+    dst_srs.ImportFromEPSG( 3857 )
+
+    ct = osr.CoordinateTransformation( src_srs, dst_srs )
+
+    pnts = [ (0, 49), (8.9831528411952125e-06, 49), (200, 0) ]
+    result = ct.TransformPoints( pnts )
+    expected_result = [ (0.0, 6274861.39400658, 0.0),
+                        (1.0, 6274861.39400658, 0.0),
+                        (-17811118.526923772, 0.0, 0.0) ]
+
+    for i in range(3):
+        for j in range(3):
+            if abs(result[i][j] - expected_result[i][j]) > 1e-6:
+                gdaltest.post_reason( 'Failed to transform from LL to Pseudo Mercator')
+                print('Got:      %s' % str(result))
+                print('Expected: %s' % str(expected_result))
+                return 'fail'
+
+    # Poles cannot be transformed
+    pnt = ogr.CreateGeometryFromWkt( 'POINT(0 90)' )
+    with gdaltest.error_handler():
+        ret = pnt.Transform( ct )
+    if ret == 0:
+        gdaltest.post_reason( 'fail' )
+        return 'fail'
+
+    geom = ogr.CreateGeometryFromWkt( 'MULTIPOLYGON(((0 0,0 2,1 2,0 0)),((0 49,1 49,1 2,0 49),(0 0,0 0,0 0,0 0)))' )
+    if geom.Transform( ct ) != 0:
+        gdaltest.post_reason( 'fail' )
+        return 'fail'
+    expected_geom = ogr.CreateGeometryFromWkt( 'MULTIPOLYGON (((0 0,0 222684.208505545,111319.490793274 222684.208505545,0 0)),((0 6274861.39400658,111319.490793274 6274861.39400658,111319.490793274 222684.208505545,0 6274861.39400658),(0 0,0 0,0 0,0 0)))' )
+    if ogrtest.check_feature_geometry(geom, expected_geom) != 0:
+        gdaltest.post_reason( 'fail' )
+        print(geom.ExportToWkt())
+        return 'fail'
+    if not geom.GetGeometryRef(1).GetSpatialReference().IsSame(dst_srs):
+        gdaltest.post_reason( 'fail' )
+        return 'fail'
+
+    # A failed point makes the transformation fail
+    wkt = 'MULTILINESTRING((0 0,1 1),(0 49,0 90))'
+    geom = ogr.CreateGeometryFromWkt( wkt )
+    with gdaltest.error_handler():
+        ret = geom.Transform( ct )
+    if ret == 0 or geom.GetGeometryRef(1).GetX(0) != 0 or \
+       geom.GetGeometryRef(1).GetY(0) != 49:
+        gdaltest.post_reason( 'fail' )
+        print(geom.ExportToWkt())
+        return 'fail'
+
+    return 'success'
+
 ###############################################################################
 # Cleanup
 
@@ -343,6 +409,7 @@ gdaltest_list = [
     osr_ct_6,
     osr_ct_7,
     osr_ct_8,
+    osr_ct_9,
     osr_ct_cleanup,
     None ]
 
@@ -2737,6 +2737,39 @@ def test_ogr2ogr_67():
     ret = check_identity_transformation(x, y, 4326)
     return ret
 
+###############################################################################
+# Test -nt
+
+def test_ogr2ogr_68():
+    if test_cli_utilities.get_ogr2ogr_path() is None:
+        return 'skip'
+
+    for nt in [1, 4]:
+        gdaltest.runexternal(test_cli_utilities.get_ogr2ogr_path() + ' -f CSV tmp/test_ogr2ogr_68_%d.csv ../ogr/data/poly.shp -t_srs EPSG:4326 -lco GEOMETRY=AS_WKT -nt %d' % (nt, nt))
+
+    ds_ref = ogr.Open('tmp/test_ogr2ogr_68_1.csv')
+    ds = ogr.Open('tmp/test_ogr2ogr_68_4.csv')
+    lyr_ref = ds_ref.GetLayer(0)
+    lyr = ds.GetLayer(0)
+    if lyr_ref.GetFeatureCount() != 10 or lyr.GetFeatureCount() != 10:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    for f_ref in lyr_ref:
+        f = lyr.GetNextFeature()
+        if f.GetField('EAS_ID') != f_ref.GetField('EAS_ID') or \
+           ogrtest.check_feature_geometry(f, f_ref.GetGeometryRef()) != 0:
+            gdaltest.post_reason('fail')
+            f.DumpReadable()
+            f_ref.DumpReadable()
+            return 'fail'
+    ds = None
+    ds_ref = None
+
+    os.unlink('tmp/test_ogr2ogr_68_1.csv')
+    os.unlink('tmp/test_ogr2ogr_68_4.csv')
+
+    return 'success'
+
 gdaltest_list = [
     test_ogr2ogr_1,
     test_ogr2ogr_2,
@@ -2805,7 +2838,8 @@ gdaltest_list = [
     test_ogr2ogr_64,
     test_ogr2ogr_65,
     test_ogr2ogr_66,
-    test_ogr2ogr_67
+    test_ogr2ogr_67,
+    test_ogr2ogr_68
     ]
 
 # gdaltest_list = [ test_ogr2ogr_66 ]
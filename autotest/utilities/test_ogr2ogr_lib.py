@@ -33,7 +33,7 @@ import sys
 
 sys.path.append( '../pymod' )
 
-from osgeo import gdal, ogr
+from osgeo import gdal, ogr, osr
 import gdaltest
 import ogrtest
 
@@ -408,6 +408,41 @@ def test_ogr2ogr_lib_18():
 
     return 'success'
 
+###############################################################################
+# Test -nt on a source layer without SRS, where the coordinate transformation
+# is set up for each feature from the SRS of its geometry.
+
+def test_ogr2ogr_lib_19():
+
+    srs = osr.SpatialReference()
+    srs.ImportFromEPSG(4326)
+    srcDS = gdal.GetDriverByName('Memory').Create('', 0, 0, 0)
+    lyr = srcDS.CreateLayer('test', geom_type = ogr.wkbLineString)
+    for i in range(5000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        geom = ogr.CreateGeometryFromWkt('LINESTRING(%d %d,177 1,-177 2,%d 3)' % (170 + i % 5, i % 7, -170 - i % 3))
+        geom.AssignSpatialReference(srs)
+        f.SetGeometry(geom)
+        lyr.CreateFeature(f)
+
+    ds_ref = gdal.VectorTranslate('', srcDS, format = 'Memory', options = '-wrapdateline')
+    ds = gdal.VectorTranslate('', srcDS, format = 'Memory', options = '-wrapdateline -nt 4')
+    lyr_ref = ds_ref.GetLayer(0)
+    lyr = ds.GetLayer(0)
+    if lyr.GetFeatureCount() != 5000:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    for f_ref in lyr_ref:
+        f = lyr.GetNextFeature()
+        if f.GetGeometryRef().GetGeometryType() != ogr.wkbMultiLineString or \
+           ogrtest.check_feature_geometry(f, f_ref.GetGeometryRef()) != 0:
+            gdaltest.post_reason('fail')
+            f.DumpReadable()
+            f_ref.DumpReadable()
+            return 'fail'
+
+    return 'success'
+
 gdaltest_list = [
     test_ogr2ogr_lib_1,
     test_ogr2ogr_lib_2,
@@ -426,7 +461,8 @@ gdaltest_list = [
     test_ogr2ogr_lib_15,
     test_ogr2ogr_lib_16,
     test_ogr2ogr_lib_17,
-    test_ogr2ogr_lib_18
+    test_ogr2ogr_lib_18,
+    test_ogr2ogr_lib_19
     ]
 
 if __name__ == '__main__':
@@ -49,6 +49,7 @@
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 #include "gdal_alg.h"
 #include "gdal_priv.h"
@@ -340,6 +341,10 @@ struct GDALVectorTranslateOptions
 
     /*! Maximum number of features, or -1 if no limit. */
     GIntBig nLimit;
+
+    /*! Number of worker threads used to translate features (1 = no worker
+        thread). */
+    int nNumThreads;
 };
 
 typedef struct
@@ -401,6 +406,21 @@ public:
                                       GIntBig& nTotalEventsDone);
 };
 
+/* Target feature built from a source feature (one per collection member
+   with -explodecollections) */
+typedef struct
+{
+    OGRFeature  *poDstFeature; // nullptr if it must not be written
+    bool         bSetFromFailed;
+    bool         bReprojectionFailed;
+} TranslatedPart;
+
+typedef struct
+{
+    OGRFeature                 *poSrcFeature;
+    std::vector<TranslatedPart> asParts;
+} TranslatedFeature;
+
 class LayerTranslator
 {
 public:
@@ -423,6 +443,9 @@ public:
     bool                          m_bExplodeCollections;
     bool                          m_bNativeData;
     GIntBig                       m_nLimit;
+    CPLWorkerThreadPool          *m_poWTP = nullptr;
+
+                       ~LayerTranslator() { delete m_poWTP; }
 
     int                 Translate(OGRFeature* poFeatureIn,
                                   TargetLayerInfo* psInfo,
@@ -432,6 +455,32 @@ public:
                                   GDALProgressFunc pfnProgress,
                                   void *pProgressArg,
                                   GDALVectorTranslateOptions *psOptions);
+
+    bool                ReadFeatures(OGRFeature* poFeatureIn,
+                                     TargetLayerInfo* psInfo,
+                                     OGRSpatialReference* poOutputSRS,
+                                     size_t nMaxFeatures,
+                                     std::vector<TranslatedFeature>& asFeatures,
+                                     bool& bEOF,
+                                     bool& bRet,
+                                     GDALVectorTranslateOptions *psOptions);
+    void                TranslateFeature(TranslatedFeature& sFeature,
+                                         TargetLayerInfo* psInfo,
+                                         OGRSpatialReference* poOutputSRS,
+                                         OGRCoordinateTransformation** papoCT);
+    bool                TranslateGeometries(OGRFeature* poFeature,
+                                            OGRFeature* poDstFeature,
+                                            TargetLayerInfo* psInfo,
+                                            OGRSpatialReference* poOutputSRS,
+                                            OGRCoordinateTransformation** papoCT,
+                                            int nParts, int iPart,
+                                            bool& bReprojectionFailed);
+    bool                WriteFeature(TranslatedFeature& sFeature,
+                                     TargetLayerInfo* psInfo,
+                                     int& nFeaturesInTransaction,
+                                     GIntBig& nTotalEventsDone,
+                                     GIntBig& nFeaturesWritten,
+                                     GDALVectorTranslateOptions *psOptions);
 };
 
 static OGRLayer* GetLayerAndOverwriteIfNecessary(GDALDataset *poDstDS,
@@ -2467,6 +2516,16 @@ GDALDatasetH GDALVectorTranslate( const char *pszDest, GDALDatasetH hDstDS, int
     oTranslator.m_bExplodeCollections = psOptions->bExplodeCollections;
     oTranslator.m_bNativeData = psOptions->bNativeData;
     oTranslator.m_nLimit = psOptions->nLimit;
+    if( psOptions->nNumThreads > 1 )
+    {
+        oTranslator.m_poWTP = new CPLWorkerThreadPool();
+        if( !oTranslator.m_poWTP->Setup(psOptions->nNumThreads,
+                                        nullptr, nullptr) )
+        {
+            delete oTranslator.m_poWTP;
+            oTranslator.m_poWTP = nullptr;
+        }
+    }
 
     if( psOptions->nGroupTransactions )
     {
@@ -4269,69 +4328,32 @@ static bool SetupCT( TargetLayerInfo* psInfo,
 }
 
 /************************************************************************/
-/*                     LayerTranslator::Translate()                     */
+/*                    LayerTranslator::ReadFeatures()                   */
+/*                                                                      */
+/*      Read up to nMaxFeatures source features. Returns false if the   */
+/*      coordinate transformation could not be set up.                  */
 /************************************************************************/
 
-int LayerTranslator::Translate( OGRFeature* poFeatureIn,
-                                TargetLayerInfo* psInfo,
-                                GIntBig nCountLayerFeatures,
-                                GIntBig* pnReadFeatureCount,
-                                GIntBig& nTotalEventsDone,
-                                GDALProgressFunc pfnProgress,
-                                void *pProgressArg,
-                                GDALVectorTranslateOptions *psOptions )
+bool LayerTranslator::ReadFeatures( OGRFeature* poFeatureIn,
+                                    TargetLayerInfo* psInfo,
+                                    OGRSpatialReference* poOutputSRS,
+                                    size_t nMaxFeatures,
+                                    std::vector<TranslatedFeature>& asFeatures,
+                                    bool& bEOF,
+                                    bool& bRet,
+                                    GDALVectorTranslateOptions *psOptions )
 {
-    const int eGType = m_eGType;
-    OGRSpatialReference* poOutputSRS = m_poOutputSRS;
-
     OGRLayer *poSrcLayer = psInfo->poSrcLayer;
-    OGRLayer *poDstLayer = psInfo->poDstLayer;
-    int* const panMap = psInfo->panMap;
-    const int iSrcZField = psInfo->iSrcZField;
-    const bool bPreserveFID = psInfo->bPreserveFID;
-    const int nSrcGeomFieldCount = poSrcLayer->GetLayerDefn()->GetGeomFieldCount();
-    const int nDstGeomFieldCount = poDstLayer->GetLayerDefn()->GetGeomFieldCount();
-    const bool bExplodeCollections = m_bExplodeCollections && nDstGeomFieldCount <= 1;
-
-    if( poOutputSRS == nullptr && !m_bNullifyOutputSRS )
-    {
-        if( nSrcGeomFieldCount == 1 )
-        {
-            poOutputSRS = poSrcLayer->GetSpatialRef();
-        }
-        else if( psInfo->iRequestedSrcGeomField > 0 )
-        {
-            poOutputSRS = poSrcLayer->GetLayerDefn()->GetGeomFieldDefn(
-                psInfo->iRequestedSrcGeomField)->GetSpatialRef();
-        }
-    }
 
-/* -------------------------------------------------------------------- */
-/*      Transfer features.                                              */
-/* -------------------------------------------------------------------- */
-    if( psOptions->nGroupTransactions )
-    {
-        if( psOptions->nLayerTransaction )
-        {
-            if( poDstLayer->StartTransaction() == OGRERR_FAILURE )
-                return false;
-        }
-    }
-
-    OGRFeature *poFeature = nullptr;
-    int         nFeaturesInTransaction = 0;
-    GIntBig      nCount = 0; /* written + failed */
-    GIntBig      nFeaturesWritten = 0;
-
-    bool bRet = true;
-    CPLErrorReset();
-    while( true )
+    while( asFeatures.size() < nMaxFeatures )
     {
         if( m_nLimit >= 0 && psInfo->nFeaturesRead >= m_nLimit )
         {
+            bEOF = true;
             break;
         }
 
+        OGRFeature *poFeature = nullptr;
         if( poFeatureIn != nullptr )
             poFeature = poFeatureIn;
         else if( psOptions->nFIDToFetch != OGRNullFID )
@@ -4345,6 +4367,7 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
             {
                 bRet = false;
             }
+            bEOF = true;
             break;
         }
 
@@ -4361,347 +4384,680 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
 
         psInfo->nFeaturesRead ++;
 
-        int nParts = 0;
-        int nIters = 1;
-        if (bExplodeCollections)
+        TranslatedFeature sFeature;
+        sFeature.poSrcFeature = poFeature;
+        asFeatures.push_back(sFeature);
+
+        if( psOptions->nFIDToFetch != OGRNullFID || poFeatureIn != nullptr )
         {
-            OGRGeometry* poSrcGeometry;
-            if( psInfo->iRequestedSrcGeomField >= 0 )
-                poSrcGeometry = poFeature->GetGeomFieldRef(
-                                        psInfo->iRequestedSrcGeomField);
-            else
-                poSrcGeometry = poFeature->GetGeometryRef();
-            if (poSrcGeometry &&
-                OGR_GT_IsSubClassOf(poSrcGeometry->getGeometryType(), wkbGeometryCollection) )
-            {
-                nParts = ((OGRGeometryCollection*)poSrcGeometry)->getNumGeometries();
-                nIters = nParts;
-                if (nIters == 0)
-                    nIters = 1;
-            }
+            bEOF = true;
+            break;
+        }
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                  LayerTranslator::TranslateFeature()                 */
+/*                                                                      */
+/*      Build the target feature(s) of a source feature: field          */
+/*      mapping and geometry operations. Does not write anything, and   */
+/*      may thus be run from a worker thread, provided that papoCT is   */
+/*      not used concurrently by another thread.                        */
+/************************************************************************/
+
+void LayerTranslator::TranslateFeature( TranslatedFeature& sFeature,
+                                        TargetLayerInfo* psInfo,
+                                        OGRSpatialReference* poOutputSRS,
+                                        OGRCoordinateTransformation** papoCT )
+{
+    OGRFeature *poFeature = sFeature.poSrcFeature;
+    OGRLayer *poDstLayer = psInfo->poDstLayer;
+    const int nSrcGeomFieldCount =
+        psInfo->poSrcLayer->GetLayerDefn()->GetGeomFieldCount();
+    const int nDstGeomFieldCount = poDstLayer->GetLayerDefn()->GetGeomFieldCount();
+    const bool bExplodeCollections = m_bExplodeCollections && nDstGeomFieldCount <= 1;
+
+    int nParts = 0;
+    int nIters = 1;
+    if (bExplodeCollections)
+    {
+        OGRGeometry* poSrcGeometry;
+        if( psInfo->iRequestedSrcGeomField >= 0 )
+            poSrcGeometry = poFeature->GetGeomFieldRef(
+                                    psInfo->iRequestedSrcGeomField);
+        else
+            poSrcGeometry = poFeature->GetGeometryRef();
+        if (poSrcGeometry &&
+            OGR_GT_IsSubClassOf(poSrcGeometry->getGeometryType(), wkbGeometryCollection) )
+        {
+            nParts = ((OGRGeometryCollection*)poSrcGeometry)->getNumGeometries();
+            nIters = nParts;
+            if (nIters == 0)
+                nIters = 1;
+        }
+    }
+
+    for(int iPart = 0; iPart < nIters; iPart++)
+    {
+        TranslatedPart sPart;
+        sPart.poDstFeature = nullptr;
+        sPart.bSetFromFailed = false;
+        sPart.bReprojectionFailed = false;
+
+        OGRFeature *poDstFeature =
+            OGRFeature::CreateFeature( poDstLayer->GetLayerDefn() );
+
+        /* Optimization to avoid duplicating the source geometry in the */
+        /* target feature : we steal it from the source feature for now... */
+        OGRGeometry* poStolenGeometry = nullptr;
+        if( !bExplodeCollections && nSrcGeomFieldCount == 1 &&
+            nDstGeomFieldCount == 1 )
+        {
+            poStolenGeometry = poFeature->StealGeometry();
+        }
+        else if( !bExplodeCollections &&
+                 psInfo->iRequestedSrcGeomField >= 0 )
+        {
+            poStolenGeometry = poFeature->StealGeometry(
+                psInfo->iRequestedSrcGeomField);
+        }
+
+        if( poDstFeature->SetFrom( poFeature, psInfo->panMap, TRUE ) != OGRERR_NONE )
+        {
+            OGRFeature::DestroyFeature( poDstFeature );
+            OGRGeometryFactory::destroyGeometry( poStolenGeometry );
+            sPart.bSetFromFailed = true;
+            sFeature.asParts.push_back(sPart);
+            return;
         }
 
-        OGRFeature *poDstFeature = nullptr;
-        for(int iPart = 0; iPart < nIters; iPart++)
+        /* ... and now we can attach the stolen geometry */
+        if( poStolenGeometry )
         {
-            if( psOptions->nLayerTransaction &&
-                ++nFeaturesInTransaction == psOptions->nGroupTransactions )
+            poDstFeature->SetGeometryDirectly(poStolenGeometry);
+        }
+
+        if( psInfo->bPreserveFID )
+            poDstFeature->SetFID( poFeature->GetFID() );
+        else if( psInfo->iSrcFIDField >= 0 &&
+                 poFeature->IsFieldSetAndNotNull(psInfo->iSrcFIDField))
+            poDstFeature->SetFID( poFeature->GetFieldAsInteger64(psInfo->iSrcFIDField) );
+
+        /* Erase native data if asked explicitly */
+        if( !m_bNativeData )
+        {
+            poDstFeature->SetNativeData(nullptr);
+            poDstFeature->SetNativeMediaType(nullptr);
+        }
+
+        if( TranslateGeometries( poFeature, poDstFeature, psInfo, poOutputSRS,
+                                 papoCT, nParts, iPart,
+                                 sPart.bReprojectionFailed ) )
+        {
+            sPart.poDstFeature = poDstFeature;
+        }
+        else
+        {
+            OGRFeature::DestroyFeature( poDstFeature );
+        }
+        sFeature.asParts.push_back(sPart);
+    }
+}
+
+/************************************************************************/
+/*                LayerTranslator::TranslateGeometries()                */
+/*                                                                      */
+/*      Apply the geometry operations to the geometries of a target     */
+/*      feature. Returns false if the feature must be dropped (clipped  */
+/*      out).                                                           */
+/************************************************************************/
+
+bool LayerTranslator::TranslateGeometries( OGRFeature* poFeature,
+                                           OGRFeature* poDstFeature,
+                                           TargetLayerInfo* psInfo,
+                                           OGRSpatialReference* poOutputSRS,
+                                           OGRCoordinateTransformation** papoCT,
+                                           int nParts, int iPart,
+                                           bool& bReprojectionFailed )
+{
+    const int eGType = m_eGType;
+    OGRLayer *poDstLayer = psInfo->poDstLayer;
+    const int iSrcZField = psInfo->iSrcZField;
+    const int nDstGeomFieldCount = poDstLayer->GetLayerDefn()->GetGeomFieldCount();
+
+    for( int iGeom = 0; iGeom < nDstGeomFieldCount; iGeom ++ )
+    {
+        OGRGeometry* poDstGeometry = poDstFeature->StealGeometry(iGeom);
+        if (poDstGeometry == nullptr)
+            continue;
+
+        if (nParts > 0)
+        {
+            /* For -explodecollections, extract the iPart(th) of the geometry */
+            OGRGeometry* poPart = ((OGRGeometryCollection*)poDstGeometry)->getGeometryRef(iPart);
+            ((OGRGeometryCollection*)poDstGeometry)->removeGeometry(iPart, FALSE);
+            delete poDstGeometry;
+            poDstGeometry = poPart;
+        }
+
+        if (iSrcZField != -1)
+        {
+            SetZ(poDstGeometry, poFeature->GetFieldAsDouble(iSrcZField));
+            /* This will correct the coordinate dimension to 3 */
+            OGRGeometry* poDupGeometry = poDstGeometry->clone();
+            delete poDstGeometry;
+            poDstGeometry = poDupGeometry;
+        }
+
+        if (m_nCoordDim == 2 || m_nCoordDim == 3)
+        {
+            poDstGeometry->setCoordinateDimension( m_nCoordDim );
+        }
+        else if (m_nCoordDim == 4)
+        {
+            poDstGeometry->set3D( TRUE );
+            poDstGeometry->setMeasured( TRUE );
+        }
+        else if (m_nCoordDim == COORD_DIM_XYM)
+        {
+            poDstGeometry->set3D( FALSE );
+            poDstGeometry->setMeasured( TRUE );
+        }
+        else if ( m_nCoordDim == COORD_DIM_LAYER_DIM )
+        {
+            const OGRwkbGeometryType eDstLayerGeomType =
+              poDstLayer->GetLayerDefn()->GetGeomFieldDefn(iGeom)->GetType();
+            poDstGeometry->set3D( wkbHasZ(eDstLayerGeomType) );
+            poDstGeometry->setMeasured( wkbHasM(eDstLayerGeomType) );
+        }
+
+        if (m_eGeomOp == GEOMOP_SEGMENTIZE)
+        {
+            if (m_dfGeomOpParam > 0)
+                poDstGeometry->segmentize(m_dfGeomOpParam);
+        }
+        else if (m_eGeomOp == GEOMOP_SIMPLIFY_PRESERVE_TOPOLOGY)
+        {
+            if (m_dfGeomOpParam > 0)
             {
-                if( poDstLayer->CommitTransaction() == OGRERR_FAILURE ||
-                    poDstLayer->StartTransaction() == OGRERR_FAILURE )
+                OGRGeometry* poNewGeom = poDstGeometry->SimplifyPreserveTopology(m_dfGeomOpParam);
+                if (poNewGeom)
                 {
-                    OGRFeature::DestroyFeature( poFeature );
-                    return false;
+                    delete poDstGeometry;
+                    poDstGeometry = poNewGeom;
                 }
-                nFeaturesInTransaction = 0;
             }
-            else if( !psOptions->nLayerTransaction &&
-                     psOptions->nGroupTransactions >= 0 &&
-                     ++nTotalEventsDone >= psOptions->nGroupTransactions )
+        }
+
+        if (m_poClipSrc)
+        {
+            OGRGeometry* poClipped = poDstGeometry->Intersection(m_poClipSrc);
+            delete poDstGeometry;
+            if (poClipped == nullptr || poClipped->IsEmpty())
             {
-                if( m_poODS->CommitTransaction() == OGRERR_FAILURE ||
-                        m_poODS->StartTransaction(psOptions->bForceTransaction) == OGRERR_FAILURE )
-                {
-                    OGRFeature::DestroyFeature( poFeature );
-                    return false;
-                }
-                nTotalEventsDone = 0;
+                delete poClipped;
+                return false;
             }
+            poDstGeometry = poClipped;
+        }
 
-            CPLErrorReset();
-            poDstFeature = OGRFeature::CreateFeature( poDstLayer->GetLayerDefn() );
+        OGRCoordinateTransformation* poCT = papoCT[iGeom];
+        if( !m_bTransform )
+            poCT = m_poGCPCoordTrans;
+        char** papszTransformOptions = psInfo->papapszTransformOptions[iGeom];
 
-            /* Optimization to avoid duplicating the source geometry in the */
-            /* target feature : we steal it from the source feature for now... */
-            OGRGeometry* poStolenGeometry = nullptr;
-            if( !bExplodeCollections && nSrcGeomFieldCount == 1 &&
-                nDstGeomFieldCount == 1 )
-            {
-                poStolenGeometry = poFeature->StealGeometry();
-            }
-            else if( !bExplodeCollections &&
-                     psInfo->iRequestedSrcGeomField >= 0 )
+        if( poCT != nullptr || papszTransformOptions != nullptr)
+        {
+            OGRGeometry* poReprojectedGeom =
+                OGRGeometryFactory::transformWithOptions(poDstGeometry, poCT, papszTransformOptions);
+            if( poReprojectedGeom == nullptr )
             {
-                poStolenGeometry = poFeature->StealGeometry(
-                    psInfo->iRequestedSrcGeomField);
+                // Reported by WriteFeature() so that errors come in order
+                bReprojectionFailed = true;
             }
 
-            if( poDstFeature->SetFrom( poFeature, panMap, TRUE ) != OGRERR_NONE )
-            {
-                if( psOptions->nGroupTransactions )
-                {
-                    if( psOptions->nLayerTransaction )
-                    {
-                        if( poDstLayer->CommitTransaction() != OGRERR_NONE )
-                        {
-                            OGRFeature::DestroyFeature( poFeature );
-                            OGRFeature::DestroyFeature( poDstFeature );
-                            OGRGeometryFactory::destroyGeometry( poStolenGeometry );
-                            return false;
-                        }
-                    }
-                }
-
-                CPLError( CE_Failure, CPLE_AppDefined,
-                        "Unable to translate feature " CPL_FRMT_GIB " from layer %s.",
-                        poFeature->GetFID(), poSrcLayer->GetName() );
+            delete poDstGeometry;
+            poDstGeometry = poReprojectedGeom;
+        }
+        else if (poOutputSRS != nullptr)
+        {
+            poDstGeometry->assignSpatialReference(poOutputSRS);
+        }
 
-                OGRFeature::DestroyFeature( poFeature );
-                OGRFeature::DestroyFeature( poDstFeature );
-                OGRGeometryFactory::destroyGeometry( poStolenGeometry );
+        if (m_poClipDst)
+        {
+            if( poDstGeometry == nullptr )
                 return false;
-            }
 
-            /* ... and now we can attach the stolen geometry */
-            if( poStolenGeometry )
+            OGRGeometry* poClipped = poDstGeometry->Intersection(m_poClipDst);
+            delete poDstGeometry;
+            if (poClipped == nullptr || poClipped->IsEmpty())
             {
-                poDstFeature->SetGeometryDirectly(poStolenGeometry);
+                delete poClipped;
+                return false;
             }
 
-            if( bPreserveFID )
-                poDstFeature->SetFID( poFeature->GetFID() );
-            else if( psInfo->iSrcFIDField >= 0 &&
-                     poFeature->IsFieldSetAndNotNull(psInfo->iSrcFIDField))
-                poDstFeature->SetFID( poFeature->GetFieldAsInteger64(psInfo->iSrcFIDField) );
+            poDstGeometry = poClipped;
+        }
 
-            /* Erase native data if asked explicitly */
-            if( !m_bNativeData )
+        if( eGType != GEOMTYPE_UNCHANGED )
+        {
+            poDstGeometry = OGRGeometryFactory::forceTo(
+                    poDstGeometry, (OGRwkbGeometryType)eGType);
+        }
+        else if( m_eGeomTypeConversion == GTC_PROMOTE_TO_MULTI ||
+                 m_eGeomTypeConversion == GTC_CONVERT_TO_LINEAR ||
+                 m_eGeomTypeConversion == GTC_CONVERT_TO_CURVE )
+        {
+            if( poDstGeometry != nullptr )
             {
-                poDstFeature->SetNativeData(nullptr);
-                poDstFeature->SetNativeMediaType(nullptr);
+                OGRwkbGeometryType eTargetType = poDstGeometry->getGeometryType();
+                eTargetType = ConvertType(m_eGeomTypeConversion, eTargetType);
+                poDstGeometry = OGRGeometryFactory::forceTo(poDstGeometry, eTargetType);
             }
+        }
 
-            for( int iGeom = 0; iGeom < nDstGeomFieldCount; iGeom ++ )
-            {
-                OGRGeometry* poDstGeometry = poDstFeature->StealGeometry(iGeom);
-                if (poDstGeometry == nullptr)
-                    continue;
+        poDstFeature->SetGeomFieldDirectly(iGeom, poDstGeometry);
+    }
 
-                if (nParts > 0)
-                {
-                    /* For -explodecollections, extract the iPart(th) of the geometry */
-                    OGRGeometry* poPart = ((OGRGeometryCollection*)poDstGeometry)->getGeometryRef(iPart);
-                    ((OGRGeometryCollection*)poDstGeometry)->removeGeometry(iPart, FALSE);
-                    delete poDstGeometry;
-                    poDstGeometry = poPart;
-                }
+    return true;
+}
 
-                if (iSrcZField != -1)
-                {
-                    SetZ(poDstGeometry, poFeature->GetFieldAsDouble(iSrcZField));
-                    /* This will correct the coordinate dimension to 3 */
-                    OGRGeometry* poDupGeometry = poDstGeometry->clone();
-                    delete poDstGeometry;
-                    poDstGeometry = poDupGeometry;
-                }
+/************************************************************************/
+/*                    LayerTranslator::WriteFeature()                   */
+/*                                                                      */
+/*      Write the target feature(s) of a translated source feature.     */
+/*      Returns false if the translation must be stopped.               */
+/************************************************************************/
 
-                if (m_nCoordDim == 2 || m_nCoordDim == 3)
-                {
-                    poDstGeometry->setCoordinateDimension( m_nCoordDim );
-                }
-                else if (m_nCoordDim == 4)
-                {
-                    poDstGeometry->set3D( TRUE );
-                    poDstGeometry->setMeasured( TRUE );
-                }
-                else if (m_nCoordDim == COORD_DIM_XYM)
-                {
-                    poDstGeometry->set3D( FALSE );
-                    poDstGeometry->setMeasured( TRUE );
-                }
-                else if ( m_nCoordDim == COORD_DIM_LAYER_DIM )
-                {
-                    const OGRwkbGeometryType eDstLayerGeomType =
-                      poDstLayer->GetLayerDefn()->GetGeomFieldDefn(iGeom)->GetType();
-                    poDstGeometry->set3D( wkbHasZ(eDstLayerGeomType) );
-                    poDstGeometry->setMeasured( wkbHasM(eDstLayerGeomType) );
-                }
+bool LayerTranslator::WriteFeature( TranslatedFeature& sFeature,
+                                    TargetLayerInfo* psInfo,
+                                    int& nFeaturesInTransaction,
+                                    GIntBig& nTotalEventsDone,
+                                    GIntBig& nFeaturesWritten,
+                                    GDALVectorTranslateOptions *psOptions )
+{
+    OGRFeature *poFeature = sFeature.poSrcFeature;
+    OGRLayer *poSrcLayer = psInfo->poSrcLayer;
+    OGRLayer *poDstLayer = psInfo->poDstLayer;
+    const bool bPreserveFID = psInfo->bPreserveFID;
 
-                if (m_eGeomOp == GEOMOP_SEGMENTIZE)
-                {
-                    if (m_dfGeomOpParam > 0)
-                        poDstGeometry->segmentize(m_dfGeomOpParam);
-                }
-                else if (m_eGeomOp == GEOMOP_SIMPLIFY_PRESERVE_TOPOLOGY)
+    for( size_t iPart = 0; iPart < sFeature.asParts.size(); iPart++ )
+    {
+        TranslatedPart& sPart = sFeature.asParts[iPart];
+
+        if( psOptions->nLayerTransaction &&
+            ++nFeaturesInTransaction == psOptions->nGroupTransactions )
+        {
+            if( poDstLayer->CommitTransaction() == OGRERR_FAILURE ||
+                poDstLayer->StartTransaction() == OGRERR_FAILURE )
+            {
+                return false;
+            }
+            nFeaturesInTransaction = 0;
+        }
+        else if( !psOptions->nLayerTransaction &&
+                 psOptions->nGroupTransactions >= 0 &&
+                 ++nTotalEventsDone >= psOptions->nGroupTransactions )
+        {
+            if( m_poODS->CommitTransaction() == OGRERR_FAILURE ||
+                    m_poODS->StartTransaction(psOptions->bForceTransaction) == OGRERR_FAILURE )
+            {
+                return false;
+            }
+            nTotalEventsDone = 0;
+        }
+
+        if( sPart.bSetFromFailed )
+        {
+            if( psOptions->nGroupTransactions )
+            {
+                if( psOptions->nLayerTransaction )
                 {
-                    if (m_dfGeomOpParam > 0)
+                    if( poDstLayer->CommitTransaction() != OGRERR_NONE )
                     {
-                        OGRGeometry* poNewGeom = poDstGeometry->SimplifyPreserveTopology(m_dfGeomOpParam);
-                        if (poNewGeom)
-                        {
-                            delete poDstGeometry;
-                            poDstGeometry = poNewGeom;
-                        }
+                        return false;
                     }
                 }
+            }
+
+            CPLError( CE_Failure, CPLE_AppDefined,
+                    "Unable to translate feature " CPL_FRMT_GIB " from layer %s.",
+                    poFeature->GetFID(), poSrcLayer->GetName() );
+            return false;
+        }
 
-                if (m_poClipSrc)
+        if( sPart.bReprojectionFailed )
+        {
+            if( psOptions->nGroupTransactions )
+            {
+                if( psOptions->nLayerTransaction )
                 {
-                    OGRGeometry* poClipped = poDstGeometry->Intersection(m_poClipSrc);
-                    delete poDstGeometry;
-                    if (poClipped == nullptr || poClipped->IsEmpty())
+                    if( poDstLayer->CommitTransaction() != OGRERR_NONE &&
+                        !psOptions->bSkipFailures )
                     {
-                        delete poClipped;
-                        goto end_loop;
+                        return false;
                     }
-                    poDstGeometry = poClipped;
                 }
+            }
 
-                OGRCoordinateTransformation* poCT = psInfo->papoCT[iGeom];
-                if( !m_bTransform )
-                    poCT = m_poGCPCoordTrans;
-                char** papszTransformOptions = psInfo->papapszTransformOptions[iGeom];
+            CPLError( CE_Failure, CPLE_AppDefined, "Failed to reproject feature " CPL_FRMT_GIB " (geometry probably out of source or destination SRS).",
+                      poFeature->GetFID() );
+            if( !psOptions->bSkipFailures )
+            {
+                return false;
+            }
+        }
 
-                if( poCT != nullptr || papszTransformOptions != nullptr)
-                {
-                    OGRGeometry* poReprojectedGeom =
-                        OGRGeometryFactory::transformWithOptions(poDstGeometry, poCT, papszTransformOptions);
-                    if( poReprojectedGeom == nullptr )
-                    {
-                        if( psOptions->nGroupTransactions )
-                        {
-                            if( psOptions->nLayerTransaction )
-                            {
-                                if( poDstLayer->CommitTransaction() != OGRERR_NONE &&
-                                    !psOptions->bSkipFailures )
-                                {
-                                    OGRFeature::DestroyFeature( poFeature );
-                                    OGRFeature::DestroyFeature( poDstFeature );
-                                    delete poDstGeometry;
-                                    return false;
-                                }
-                            }
-                        }
+        OGRFeature *poDstFeature = sPart.poDstFeature;
+        if( poDstFeature == nullptr )
+            continue;
 
-                        CPLError( CE_Failure, CPLE_AppDefined, "Failed to reproject feature " CPL_FRMT_GIB " (geometry probably out of source or destination SRS).",
-                                  poFeature->GetFID() );
-                        if( !psOptions->bSkipFailures )
-                        {
-                            OGRFeature::DestroyFeature( poFeature );
-                            OGRFeature::DestroyFeature( poDstFeature );
-                            delete poDstGeometry;
-                            return false;
-                        }
-                    }
+        CPLErrorReset();
+        if( poDstLayer->CreateFeature( poDstFeature ) == OGRERR_NONE )
+        {
+            nFeaturesWritten ++;
+            if( (bPreserveFID && poDstFeature->GetFID() != poFeature->GetFID()) ||
+                (!bPreserveFID && psInfo->iSrcFIDField >= 0 && poFeature->IsFieldSetAndNotNull(psInfo->iSrcFIDField) &&
+                 poDstFeature->GetFID() != poFeature->GetFieldAsInteger64(psInfo->iSrcFIDField)) )
+            {
+                CPLError( CE_Warning, CPLE_AppDefined,
+                          "Feature id not preserved");
+            }
+        }
+        else if( !psOptions->bSkipFailures )
+        {
+            if( psOptions->nGroupTransactions )
+            {
+                if( psOptions->nLayerTransaction )
+                    poDstLayer->RollbackTransaction();
+            }
 
-                    delete poDstGeometry;
-                    poDstGeometry = poReprojectedGeom;
+            CPLError( CE_Failure, CPLE_AppDefined,
+                    "Unable to write feature " CPL_FRMT_GIB " from layer %s.",
+                    poFeature->GetFID(), poSrcLayer->GetName() );
+            return false;
+        }
+        else
+        {
+            CPLDebug( "GDALVectorTranslate", "Unable to write feature " CPL_FRMT_GIB " into layer %s.",
+                       poFeature->GetFID(), poSrcLayer->GetName() );
+            if( psOptions->nGroupTransactions )
+            {
+                if( psOptions->nLayerTransaction )
+                {
+                    poDstLayer->RollbackTransaction();
+                    CPL_IGNORE_RET_VAL(poDstLayer->StartTransaction());
                 }
-                else if (poOutputSRS != nullptr)
+                else
                 {
-                    poDstGeometry->assignSpatialReference(poOutputSRS);
+                    m_poODS->RollbackTransaction();
+                    m_poODS->StartTransaction(psOptions->bForceTransaction);
                 }
+            }
+        }
+    }
 
-                if (m_poClipDst)
-                {
-                    if( poDstGeometry == nullptr )
-                        goto end_loop;
+    return true;
+}
 
-                    OGRGeometry* poClipped = poDstGeometry->Intersection(m_poClipDst);
-                    delete poDstGeometry;
-                    if (poClipped == nullptr || poClipped->IsEmpty())
-                    {
-                        delete poClipped;
-                        goto end_loop;
-                    }
+/************************************************************************/
+/*                      FreeTranslatedFeatures()                        */
+/************************************************************************/
 
-                    poDstGeometry = poClipped;
-                }
+static void FreeTranslatedFeatures( std::vector<TranslatedFeature>& asFeatures,
+                                    size_t nStart = 0 )
+{
+    for( size_t i = nStart; i < asFeatures.size(); i++ )
+    {
+        OGRFeature::DestroyFeature( asFeatures[i].poSrcFeature );
+        for( size_t j = 0; j < asFeatures[i].asParts.size(); j++ )
+            OGRFeature::DestroyFeature( asFeatures[i].asParts[j].poDstFeature );
+    }
+    asFeatures.clear();
+}
 
-                if( eGType != GEOMTYPE_UNCHANGED )
-                {
-                    poDstGeometry = OGRGeometryFactory::forceTo(
-                            poDstGeometry, (OGRwkbGeometryType)eGType);
-                }
-                else if( m_eGeomTypeConversion == GTC_PROMOTE_TO_MULTI ||
-                         m_eGeomTypeConversion == GTC_CONVERT_TO_LINEAR ||
-                         m_eGeomTypeConversion == GTC_CONVERT_TO_CURVE )
-                {
-                    if( poDstGeometry != nullptr )
-                    {
-                        OGRwkbGeometryType eTargetType = poDstGeometry->getGeometryType();
-                        eTargetType = ConvertType(m_eGeomTypeConversion, eTargetType);
-                        poDstGeometry = OGRGeometryFactory::forceTo(poDstGeometry, eTargetType);
-                    }
-                }
+/************************************************************************/
+/*                       TranslateFeaturesJob()                         */
+/************************************************************************/
 
-                poDstFeature->SetGeomFieldDirectly(iGeom, poDstGeometry);
-            }
+/* Work item of a worker thread. Features of the batch are taken in turn
+   by the workers, each one having its own coordinate transformations, as
+   OGRCoordinateTransformation objects are not thread-safe. */
+typedef struct
+{
+    LayerTranslator                          *poTranslator;
+    TargetLayerInfo                          *psInfo;
+    OGRSpatialReference                      *poOutputSRS;
+    std::vector<OGRCoordinateTransformation*> apoCT;
+    bool                                      bOwnCT;
+    std::vector<TranslatedFeature>           *pasFeatures;
+    volatile int                             *pnNextFeature;
+} TranslateFeaturesJobData;
+
+static void TranslateFeaturesJob( void* pData )
+{
+    TranslateFeaturesJobData* psJob =
+        static_cast<TranslateFeaturesJobData*>(pData);
+    const int nFeatures = static_cast<int>(psJob->pasFeatures->size());
+    while( true )
+    {
+        const int i = CPLAtomicInc(psJob->pnNextFeature) - 1;
+        if( i >= nFeatures )
+            break;
+        psJob->poTranslator->TranslateFeature(
+            (*psJob->pasFeatures)[i], psJob->psInfo, psJob->poOutputSRS,
+            psJob->apoCT.empty() ? nullptr : &psJob->apoCT[0] );
+    }
+}
 
-            CPLErrorReset();
-            if( poDstLayer->CreateFeature( poDstFeature ) == OGRERR_NONE )
-            {
-                nFeaturesWritten ++;
-                if( (bPreserveFID && poDstFeature->GetFID() != poFeature->GetFID()) ||
-                    (!bPreserveFID && psInfo->iSrcFIDField >= 0 && poFeature->IsFieldSetAndNotNull(psInfo->iSrcFIDField) &&
-                     poDstFeature->GetFID() != poFeature->GetFieldAsInteger64(psInfo->iSrcFIDField)) )
-                {
-                    CPLError( CE_Warning, CPLE_AppDefined,
-                              "Feature id not preserved");
-                }
-            }
-            else if( !psOptions->bSkipFailures )
-            {
-                if( psOptions->nGroupTransactions )
-                {
-                    if( psOptions->nLayerTransaction )
-                        poDstLayer->RollbackTransaction();
-                }
+/************************************************************************/
+/*                     LayerTranslator::Translate()                     */
+/************************************************************************/
 
-                CPLError( CE_Failure, CPLE_AppDefined,
-                        "Unable to write feature " CPL_FRMT_GIB " from layer %s.",
-                        poFeature->GetFID(), poSrcLayer->GetName() );
+int LayerTranslator::Translate( OGRFeature* poFeatureIn,
+                                TargetLayerInfo* psInfo,
+                                GIntBig nCountLayerFeatures,
+                                GIntBig* pnReadFeatureCount,
+                                GIntBig& nTotalEventsDone,
+                                GDALProgressFunc pfnProgress,
+                                void *pProgressArg,
+                                GDALVectorTranslateOptions *psOptions )
+{
+    OGRSpatialReference* poOutputSRS = m_poOutputSRS;
 
-                OGRFeature::DestroyFeature( poFeature );
-                OGRFeature::DestroyFeature( poDstFeature );
+    OGRLayer *poSrcLayer = psInfo->poSrcLayer;
+    OGRLayer *poDstLayer = psInfo->poDstLayer;
+    const int nSrcGeomFieldCount = poSrcLayer->GetLayerDefn()->GetGeomFieldCount();
+    const int nDstGeomFieldCount = poDstLayer->GetLayerDefn()->GetGeomFieldCount();
+
+    if( poOutputSRS == nullptr && !m_bNullifyOutputSRS )
+    {
+        if( nSrcGeomFieldCount == 1 )
+        {
+            poOutputSRS = poSrcLayer->GetSpatialRef();
+        }
+        else if( psInfo->iRequestedSrcGeomField > 0 )
+        {
+            poOutputSRS = poSrcLayer->GetLayerDefn()->GetGeomFieldDefn(
+                psInfo->iRequestedSrcGeomField)->GetSpatialRef();
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Transfer features.                                              */
+/* -------------------------------------------------------------------- */
+    if( psOptions->nGroupTransactions )
+    {
+        if( psOptions->nLayerTransaction )
+        {
+            if( poDstLayer->StartTransaction() == OGRERR_FAILURE )
                 return false;
-            }
-            else
+        }
+    }
+
+    std::vector<TranslatedFeature> asBatch;
+    std::vector<TranslatedFeature> asNextBatch;
+    std::vector<TranslateFeaturesJobData> asJobs;
+    volatile int nNextFeature = 0;
+
+    int         nFeaturesInTransaction = 0;
+    GIntBig      nCount = 0; /* written + failed */
+    GIntBig      nFeaturesWritten = 0;
+
+    bool bRet = true;
+    bool bEOF = false;
+    bool bFatalError = false;
+    CPLErrorReset();
+    if( !ReadFeatures( poFeatureIn, psInfo, poOutputSRS, 1,
+                       asBatch, bEOF, bRet, psOptions ) )
+    {
+        return false;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      With -nt, the source features are read by batches. The         */
+/*      features of a batch are translated by the worker threads        */
+/*      while the next batch is read, and are then written in their     */
+/*      original order. The reading and writing remain sequential.      */
+/*      This can only be decided once the first feature has been read,  */
+/*      since it is what tells whether the coordinate transformation    */
+/*      has to be set up again for each feature, in which case          */
+/*      features are translated one at a time, as soon as read.         */
+/* -------------------------------------------------------------------- */
+    const bool bUseWorkers = m_poWTP != nullptr &&
+                             poFeatureIn == nullptr &&
+                             psOptions->nFIDToFetch == OGRNullFID &&
+                             !psInfo->bPerFeatureCT &&
+                             m_poGCPCoordTrans == nullptr;
+    const size_t nBatchSize = bUseWorkers ?
+        static_cast<size_t>(256) * m_poWTP->GetThreadCount() : 1;
+
+    while( !asBatch.empty() )
+    {
+        if( bUseWorkers && asJobs.empty() )
+        {
+            // The coordinate transformations are set up by the reading of
+            // the first feature.
+            for( int iJob = 0; iJob < m_poWTP->GetThreadCount(); iJob++ )
             {
-                CPLDebug( "GDALVectorTranslate", "Unable to write feature " CPL_FRMT_GIB " into layer %s.",
-                           poFeature->GetFID(), poSrcLayer->GetName() );
-                if( psOptions->nGroupTransactions )
+                TranslateFeaturesJobData sJob;
+                sJob.poTranslator = this;
+                sJob.psInfo = psInfo;
+                sJob.poOutputSRS = poOutputSRS;
+                sJob.bOwnCT = iJob > 0;
+                sJob.pasFeatures = &asBatch;
+                sJob.pnNextFeature = &nNextFeature;
+                bool bOK = true;
+                for( int iGeom = 0; iGeom < nDstGeomFieldCount; iGeom++ )
                 {
-                    if( psOptions->nLayerTransaction )
-                    {
-                        poDstLayer->RollbackTransaction();
-                        CPL_IGNORE_RET_VAL(poDstLayer->StartTransaction());
-                    }
-                    else
+                    OGRCoordinateTransformation* poCT = psInfo->papoCT[iGeom];
+                    if( poCT != nullptr && sJob.bOwnCT )
                     {
-                        m_poODS->RollbackTransaction();
-                        m_poODS->StartTransaction(psOptions->bForceTransaction);
+                        poCT = OGRCreateCoordinateTransformation(
+                            poCT->GetSourceCS(), poCT->GetTargetCS());
+                        if( poCT == nullptr )
+                            bOK = false;
                     }
+                    sJob.apoCT.push_back(poCT);
+                }
+                if( !bOK )
+                {
+                    for( size_t i = 0; i < sJob.apoCT.size(); i++ )
+                        delete sJob.apoCT[i];
+                    break;
                 }
+                asJobs.push_back(sJob);
             }
-
-end_loop:
-            OGRFeature::DestroyFeature( poDstFeature );
+            CPLDebug("GDALVectorTranslate",
+                     "Translating features of layer %s with %d threads",
+                     poSrcLayer->GetName(), static_cast<int>(asJobs.size()));
         }
 
-        OGRFeature::DestroyFeature( poFeature );
-
-        /* Report progress */
-        nCount ++;
-        bool bGoOn = true;
-        if (pfnProgress)
+        if( asJobs.size() > 1 )
         {
-            bGoOn = pfnProgress(nCountLayerFeatures ? nCount * 1.0 / nCountLayerFeatures: 1.0, "", pProgressArg) != FALSE;
+            nNextFeature = 0;
+            std::vector<void*> apJobs;
+            for( size_t i = 0; i < asJobs.size(); i++ )
+            {
+                asJobs[i].pasFeatures = &asBatch;
+                apJobs.push_back(&asJobs[i]);
+            }
+            m_poWTP->SubmitJobs(TranslateFeaturesJob, apJobs);
+            if( !bEOF &&
+                !ReadFeatures( nullptr, psInfo, poOutputSRS, nBatchSize,
+                               asNextBatch, bEOF, bRet, psOptions ) )
+            {
+                bFatalError = true;
+            }
+            m_poWTP->WaitCompletion();
         }
-        if( !bGoOn )
+        else
         {
-            bRet = false;
-            break;
+            for( size_t i = 0; i < asBatch.size(); i++ )
+            {
+                TranslateFeature( asBatch[i], psInfo, poOutputSRS,
+                                  psInfo->papoCT );
+            }
         }
 
-        if (pnReadFeatureCount)
-            *pnReadFeatureCount = nCount;
+        bool bStop = bFatalError;
+        size_t i = 0;
+        for( ; !bStop && i < asBatch.size(); i++ )
+        {
+            if( !WriteFeature( asBatch[i], psInfo, nFeaturesInTransaction,
+                               nTotalEventsDone, nFeaturesWritten,
+                               psOptions ) )
+            {
+                bFatalError = true;
+                bStop = true;
+                break;
+            }
 
-        if( psOptions->nFIDToFetch != OGRNullFID )
+            /* Report progress */
+            nCount ++;
+            bool bGoOn = true;
+            if (pfnProgress)
+            {
+                bGoOn = pfnProgress(nCountLayerFeatures ? nCount * 1.0 / nCountLayerFeatures: 1.0, "", pProgressArg) != FALSE;
+            }
+            if( !bGoOn )
+            {
+                bRet = false;
+                bStop = true;
+            }
+
+            if (pnReadFeatureCount)
+                *pnReadFeatureCount = nCount;
+        }
+        FreeTranslatedFeatures( asBatch );
+        if( bStop )
             break;
-        if( poFeatureIn != nullptr )
+
+        if( asJobs.size() <= 1 && !bEOF &&
+            !ReadFeatures( poFeatureIn, psInfo, poOutputSRS, nBatchSize,
+                           asNextBatch, bEOF, bRet, psOptions ) )
+        {
+            bFatalError = true;
             break;
+        }
+        asBatch.swap( asNextBatch );
+    }
+
+    FreeTranslatedFeatures( asBatch );
+    FreeTranslatedFeatures( asNextBatch );
+    for( size_t i = 0; i < asJobs.size(); i++ )
+    {
+        if( asJobs[i].bOwnCT )
+        {
+            for( size_t j = 0; j < asJobs[i].apoCT.size(); j++ )
+                delete asJobs[i].apoCT[j];
+        }
     }
+    if( bFatalError )
+        return false;
 
     if( psOptions->nGroupTransactions )
     {
@@ -4822,6 +5178,7 @@ GDALVectorTranslateOptions *GDALVectorTranslateOptionsNew(char** papszArgv,
     psOptions->hSpatialFilter = nullptr;
     psOptions->bNativeData = true;
     psOptions->nLimit = -1;
+    psOptions->nNumThreads = 1;
 
     int nArgc = CSLCount(papszArgv);
     for( int i = 0; papszArgv != nullptr && i < nArgc; i++ )
@@ -4998,6 +5355,14 @@ GDALVectorTranslateOptions *GDALVectorTranslateOptionsNew(char** papszArgv,
                     psOptions->nGroupTransactions = atoi(papszArgv[i]);
             }
         }
+        else if( i+1 < nArgc && EQUAL(papszArgv[i],"-nt") )
+        {
+            ++i;
+            if( EQUAL(papszArgv[i], "ALL_CPUS") )
+                psOptions->nNumThreads = CPLGetNumCPUs();
+            else
+                psOptions->nNumThreads = std::max(1, atoi(papszArgv[i]));
+        }
         else if ( EQUAL(papszArgv[i],"-ds_transaction") )
         {
             psOptions->nLayerTransaction = FALSE;
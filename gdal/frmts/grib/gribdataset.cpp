@@ -33,6 +33,7 @@
 #include "gribdataset.h"
 
 #include <cerrno>
+#include <climits>
 #include <cmath>
 #include <cstddef>
 #include <cstdio>
@@ -43,14 +44,17 @@
 #endif
 
 #include <algorithm>
+#include <map>
 #include <string>
 #include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_minixml.h"
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "degrib/degrib/datasource.h"
 #include "degrib/degrib/degrib2.h"
 #include "degrib/degrib/filedatasource.h"
@@ -137,6 +141,38 @@ GRIBRasterBand::GRIBRasterBand( GRIBDataset *poDSIn, int nBandIn,
                     CPLString().Printf("%.0f sec", psInv->foreSec));
 }
 
+/************************************************************************/
+/*                           GRIBRasterBand()                            */
+/*                                                                      */
+/*      Constructor used when the band is restored from a message       */
+/*      index. The caller is responsible for setting the metadata.      */
+/************************************************************************/
+
+GRIBRasterBand::GRIBRasterBand( GRIBDataset *poDSIn, int nBandIn,
+                                sInt4 nStart, int nSubgNum,
+                                int nGribVersion,
+                                const char *pszLongFstLevel ) :
+    start(nStart),
+    subgNum(nSubgNum),
+    longFstLevel(CPLStrdup(pszLongFstLevel)),
+    m_Grib_Data(nullptr),
+    m_Grib_MetaData(nullptr),
+    nGribDataXSize(poDSIn->nRasterXSize),
+    nGribDataYSize(poDSIn->nRasterYSize),
+    m_nGribVersion(nGribVersion),
+    m_bHasLookedForNoData(false),
+    m_dfNoData(0.0),
+    m_bHasNoData(false)
+
+{
+    poDS = poDSIn;
+    nBand = nBandIn;
+    eDataType = GDT_Float64;
+
+    nBlockXSize = poDSIn->nRasterXSize;
+    nBlockYSize = 1;
+}
+
 /************************************************************************/
 /*                          FindPDSTemplate()                           */
 /*                                                                      */
@@ -621,10 +657,32 @@ CPLErr GRIBRasterBand::LoadData()
             }
         }
 
-        FileDataSource grib_fp(poGDS->fp);
+        {
+            // degrib is not re-entrant, so decoding must be serialized with
+            // the other GRIB datasets, including those opened in other
+            // threads.
+            CPLMutexHolderD(&hGRIBMutex);
+
+            // Use the message fetched by PrefetchMessages(), if any.
+            std::map<vsi_l_offset, std::vector<GByte> >::iterator oIter =
+                poGDS->m_oMapPrefetchedMessages.find(start);
+            if( oIter != poGDS->m_oMapPrefetchedMessages.end() &&
+                !oIter->second.empty() )
+            {
+                MemoryDataSource oMemDS(&oIter->second[0],
+                                        static_cast<long>(oIter->second.size()));
+                ReadGribData(oMemDS, 0, subgNum,
+                             &m_Grib_Data, &m_Grib_MetaData);
+            }
+            else
+            {
+                FileDataSource grib_fp(poGDS->fp);
 
-        // we don't seem to have any way to detect errors in this!
-        ReadGribData(grib_fp, start, subgNum, &m_Grib_Data, &m_Grib_MetaData);
+                // we don't seem to have any way to detect errors in this!
+                ReadGribData(grib_fp, start, subgNum,
+                             &m_Grib_Data, &m_Grib_MetaData);
+            }
+        }
         if( !m_Grib_Data )
         {
             CPLError(CE_Failure, CPLE_AppDefined, "Out of memory.");
@@ -851,7 +909,9 @@ GRIBDataset::GRIBDataset() :
         static_cast<GIntBig>(atoi(CPLGetConfigOption("GRIB_CACHEMAX", "100")))
         * 1024 * 1024),
     bCacheOnlyOneBand(FALSE),
-    poLastUsedBand(nullptr)
+    poLastUsedBand(nullptr),
+    m_nNumThreads(-1),
+    m_poThreadPool(nullptr)
 {
     adfGeoTransform[0] = 0.0;
     adfGeoTransform[1] = 1.0;
@@ -873,6 +933,7 @@ GRIBDataset::~GRIBDataset()
         VSIFCloseL(fp);
 
     CPLFree(pszProjection);
+    delete m_poThreadPool;
 }
 
 /************************************************************************/
@@ -892,6 +953,442 @@ CPLErr GRIBDataset::GetGeoTransform( double *padfTransform )
 
 const char *GRIBDataset::GetProjectionRef() { return pszProjection; }
 
+/************************************************************************/
+/*                            GetFileList()                             */
+/************************************************************************/
+
+char **GRIBDataset::GetFileList()
+
+{
+    char **papszFileList = GDALPamDataset::GetFileList();
+    if( !m_osIndexFilename.empty() )
+        papszFileList = CSLAddString(papszFileList, m_osIndexFilename);
+    return papszFileList;
+}
+
+/************************************************************************/
+/*                           GetNumThreads()                            */
+/************************************************************************/
+
+int GRIBDataset::GetNumThreads()
+{
+    if( m_nNumThreads < 0 )
+    {
+        const char* pszValue = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+        m_nNumThreads = 1;
+        if( pszValue )
+        {
+            m_nNumThreads = EQUAL(pszValue, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                          atoi(pszValue);
+            m_nNumThreads = std::max(1, std::min(128, m_nNumThreads));
+        }
+    }
+    return m_nNumThreads;
+}
+
+/************************************************************************/
+/*                          PrefetchMessages()                          */
+/*                                                                      */
+/*      Read concurrently the raw GRIB2 messages of the bands that      */
+/*      are going to be loaded, so that LoadData() only has to decode   */
+/*      them. The decoding itself remains serialized, as degrib has     */
+/*      global state.                                                   */
+/************************************************************************/
+
+namespace {
+
+struct GRIBMessageFetchJob
+{
+    CPLString                          osFilename;
+    std::vector<vsi_l_offset>          anOffsets;
+    std::vector<std::vector<GByte> *>  apabyMessages;
+};
+
+}
+
+static void GRIBMessageFetchJobFunc( void *pData )
+{
+    GRIBMessageFetchJob *psJob = static_cast<GRIBMessageFetchJob *>(pData);
+
+    // The dataset file handle cannot be shared between threads.
+    VSILFILE *fpL = VSIFOpenL(psJob->osFilename, "rb");
+    if( fpL == nullptr )
+        return;
+
+    for( size_t i = 0; i < psJob->anOffsets.size(); i++ )
+    {
+        // Section 0 of a GRIB2 message: "GRIB", 2 reserved bytes,
+        // discipline, edition number and total message length as a 8-byte
+        // big endian integer.
+        GByte abySect0[16];
+        if( VSIFSeekL(fpL, psJob->anOffsets[i], SEEK_SET) != 0 ||
+            VSIFReadL(abySect0, 1, sizeof(abySect0), fpL) != sizeof(abySect0) ||
+            memcmp(abySect0, "GRIB", 4) != 0 || abySect0[7] != 2 )
+        {
+            continue;
+        }
+        GUIntBig nMessageLength = 0;
+        for( int j = 8; j < 16; j++ )
+            nMessageLength = (nMessageLength << 8) | abySect0[j];
+        if( nMessageLength < sizeof(abySect0) ||
+            nMessageLength > static_cast<GUIntBig>(INT_MAX) )
+        {
+            continue;
+        }
+
+        std::vector<GByte> &abyMessage = *(psJob->apabyMessages[i]);
+        try
+        {
+            abyMessage.resize(static_cast<size_t>(nMessageLength));
+        }
+        catch( const std::exception & )
+        {
+            continue;
+        }
+        memcpy(&abyMessage[0], abySect0, sizeof(abySect0));
+        const size_t nToRead = abyMessage.size() - sizeof(abySect0);
+        if( VSIFReadL(&abyMessage[sizeof(abySect0)], 1, nToRead, fpL) !=
+                                                                    nToRead )
+        {
+            // LoadData() will fallback to reading from the file.
+            abyMessage.clear();
+        }
+    }
+
+    VSIFCloseL(fpL);
+}
+
+void GRIBDataset::PrefetchMessages( int nBandCount, int *panBandMap )
+{
+    if( GetNumThreads() < 2 )
+        return;
+
+    for( int i = 0; i < nBandCount; i++ )
+    {
+        GRIBRasterBand *poBand =
+            static_cast<GRIBRasterBand *>(GetRasterBand(panBandMap[i]));
+        // Subgrids of the same message share its offset.
+        if( poBand != nullptr && poBand->m_Grib_Data == nullptr &&
+            poBand->m_nGribVersion == 2 && poBand->start >= 0 )
+        {
+            m_oMapPrefetchedMessages[poBand->start];
+        }
+    }
+    if( m_oMapPrefetchedMessages.size() < 2 )
+    {
+        m_oMapPrefetchedMessages.clear();
+        return;
+    }
+
+    // Give each thread a range of consecutive messages.
+    const int nJobs = static_cast<int>(std::min(
+        static_cast<size_t>(m_nNumThreads), m_oMapPrefetchedMessages.size()));
+    std::vector<GRIBMessageFetchJob> asJobs(nJobs);
+    std::map<vsi_l_offset, std::vector<GByte> >::iterator oIter =
+                                            m_oMapPrefetchedMessages.begin();
+    const size_t nMessages = m_oMapPrefetchedMessages.size();
+    for( size_t i = 0; i < nMessages; ++i, ++oIter )
+    {
+        GRIBMessageFetchJob &sJob = asJobs[i * nJobs / nMessages];
+        sJob.osFilename = GetDescription();
+        sJob.anOffsets.push_back(oIter->first);
+        sJob.apabyMessages.push_back(&(oIter->second));
+    }
+
+    if( m_poThreadPool == nullptr )
+    {
+        CPLDebug("GRIB", "Using %d threads to read messages", m_nNumThreads);
+        m_poThreadPool = new CPLWorkerThreadPool();
+        if( !m_poThreadPool->Setup(m_nNumThreads, nullptr, nullptr) )
+        {
+            delete m_poThreadPool;
+            m_poThreadPool = nullptr;
+            m_nNumThreads = 1;
+            m_oMapPrefetchedMessages.clear();
+            return;
+        }
+    }
+
+    std::vector<void*> apJobs;
+    for( size_t i = 0; i < asJobs.size(); ++i )
+        apJobs.push_back(&asJobs[i]);
+    m_poThreadPool->SubmitJobs(GRIBMessageFetchJobFunc, apJobs);
+    m_poThreadPool->WaitCompletion();
+}
+
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr GRIBDataset::IRasterIO( GDALRWFlag eRWFlag,
+                               int nXOff, int nYOff, int nXSize, int nYSize,
+                               void *pData, int nBufXSize, int nBufYSize,
+                               GDALDataType eBufType,
+                               int nBandCount, int *panBandMap,
+                               GSpacing nPixelSpace, GSpacing nLineSpace,
+                               GSpacing nBandSpace,
+                               GDALRasterIOExtraArg* psExtraArg )
+
+{
+    if( eRWFlag == GF_Read && nBandCount > 1 )
+        PrefetchMessages(nBandCount, panBandMap);
+
+    const CPLErr eErr = GDALPamDataset::IRasterIO(
+        eRWFlag, nXOff, nYOff, nXSize, nYSize, pData, nBufXSize, nBufYSize,
+        eBufType, nBandCount, panBandMap,
+        nPixelSpace, nLineSpace, nBandSpace, psExtraArg);
+
+    m_oMapPrefetchedMessages.clear();
+    return eErr;
+}
+
+/************************************************************************/
+/*                          GetIndexFilename()                          */
+/************************************************************************/
+
+CPLString GRIBDataset::GetIndexFilename( const char *pszFilename )
+{
+    return CPLString(pszFilename) + ".gribidx.xml";
+}
+
+/************************************************************************/
+/*                            GetIndexKey()                             */
+/*                                                                      */
+/*      Return a string identifying the state of the GRIB file and of   */
+/*      the configuration options that affect the content of the        */
+/*      index, or an empty string if the file cannot be stat'ed.        */
+/************************************************************************/
+
+CPLString GRIBDataset::GetIndexKey( const char *pszFilename )
+{
+    VSIStatBufL sStat;
+    if( VSIStatL(pszFilename, &sStat) != 0 )
+        return CPLString();
+
+    return CPLString().Printf(
+        "size=" CPL_FRMT_GUIB ",mtime=" CPL_FRMT_GIB
+        ",normalize_units=%d,pds_all_bands=%d,adjust_longitude_range=%d",
+        static_cast<GUIntBig>(sStat.st_size),
+        static_cast<GIntBig>(sStat.st_mtime),
+        CPLTestBool(CPLGetConfigOption("GRIB_NORMALIZE_UNITS", "YES")),
+        CPLTestBool(CPLGetConfigOption("GRIB_PDS_ALL_BANDS", "ON")),
+        CPLTestBool(CPLGetConfigOption("GRIB_ADJUST_LONGITUDE_RANGE", "YES")));
+}
+
+/************************************************************************/
+/*                             WriteIndex()                             */
+/*                                                                      */
+/*      Save the result of the inventory of the file, so that next      */
+/*      opening does not need to scan the messages again.               */
+/************************************************************************/
+
+void GRIBDataset::WriteIndex()
+{
+    const CPLString osKey = GetIndexKey(GetDescription());
+    if( osKey.empty() )
+        return;
+
+    CPLXMLNode *psRoot = CPLCreateXMLNode(nullptr, CXT_Element, "GRIBIndex");
+    CPLAddXMLAttributeAndValue(psRoot, "version", "1");
+    CPLAddXMLAttributeAndValue(psRoot, "key", osKey);
+
+    CPLXMLNode *psDS = CPLCreateXMLNode(psRoot, CXT_Element, "Dataset");
+    CPLAddXMLAttributeAndValue(psDS, "rasterXSize",
+                               CPLSPrintf("%d", nRasterXSize));
+    CPLAddXMLAttributeAndValue(psDS, "rasterYSize",
+                               CPLSPrintf("%d", nRasterYSize));
+    CPLCreateXMLElementAndValue(psDS, "GeoTransform",
+        CPLSPrintf("%.18g,%.18g,%.18g,%.18g,%.18g,%.18g",
+                   adfGeoTransform[0], adfGeoTransform[1],
+                   adfGeoTransform[2], adfGeoTransform[3],
+                   adfGeoTransform[4], adfGeoTransform[5]));
+    CPLCreateXMLElementAndValue(psDS, "SRS", pszProjection);
+
+    for( int i = 0; i < nBands; i++ )
+    {
+        GRIBRasterBand *poBand =
+            static_cast<GRIBRasterBand *>(GetRasterBand(i + 1));
+        CPLXMLNode *psBand = CPLCreateXMLNode(psDS, CXT_Element, "Band");
+        CPLAddXMLAttributeAndValue(psBand, "start",
+                                   CPLSPrintf("%d", poBand->start));
+        CPLAddXMLAttributeAndValue(psBand, "subgNum",
+                                   CPLSPrintf("%d", poBand->subgNum));
+        CPLAddXMLAttributeAndValue(psBand, "gribVersion",
+                                   CPLSPrintf("%d", poBand->m_nGribVersion));
+        if( poBand->m_bHasLookedForNoData )
+        {
+            CPLAddXMLAttributeAndValue(psBand, "hasNoData",
+                                       poBand->m_bHasNoData ? "1" : "0");
+            if( poBand->m_bHasNoData )
+                CPLAddXMLAttributeAndValue(psBand, "noData",
+                    CPLSPrintf("%.18g", poBand->m_dfNoData));
+        }
+        CPLCreateXMLElementAndValue(psBand, "Description",
+            poBand->longFstLevel ? poBand->longFstLevel : "");
+
+        CPLXMLNode *psMD = CPLCreateXMLNode(psBand, CXT_Element, "Metadata");
+        char **papszMD = poBand->GetMetadata();
+        for( int j = 0; papszMD != nullptr && papszMD[j] != nullptr; j++ )
+        {
+            char *pszKey = nullptr;
+            const char *pszValue = CPLParseNameValue(papszMD[j], &pszKey);
+            if( pszKey != nullptr && pszValue != nullptr )
+            {
+                CPLXMLNode *psMDI =
+                    CPLCreateXMLElementAndValue(psMD, "MDI", pszValue);
+                CPLAddXMLAttributeAndValue(psMDI, "key", pszKey);
+            }
+            CPLFree(pszKey);
+        }
+    }
+
+    // Write to a temporary file first so that concurrent readers never see
+    // a partial index.
+    const CPLString osIndexFilename = GetIndexFilename(GetDescription());
+    CPLString osTmpFilename( CPLSPrintf("%s." CPL_FRMT_GIB ".tmp",
+                                        osIndexFilename.c_str(),
+                                        CPLGetPID()) );
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    bool bOK = CPL_TO_BOOL(CPLSerializeXMLTreeToFile(psRoot, osTmpFilename));
+    bOK = bOK && VSIRename(osTmpFilename, osIndexFilename) == 0;
+    if( !bOK )
+        VSIUnlink(osTmpFilename);
+    CPLPopErrorHandler();
+    CPLErrorReset();
+    CPLDestroyXMLNode(psRoot);
+
+    if( bOK )
+    {
+        CPLDebug("GRIB", "Wrote %s", osIndexFilename.c_str());
+        m_osIndexFilename = osIndexFilename;
+    }
+    else
+    {
+        CPLDebug("GRIB", "Cannot write %s", osIndexFilename.c_str());
+    }
+}
+
+/************************************************************************/
+/*                           OpenFromIndex()                            */
+/*                                                                      */
+/*      Instantiate the dataset from its message index, if it exists    */
+/*      and is up to date. Returns nullptr otherwise.                   */
+/************************************************************************/
+
+GRIBDataset *GRIBDataset::OpenFromIndex( GDALOpenInfo *poOpenInfo )
+{
+    const CPLString osKey = GetIndexKey(poOpenInfo->pszFilename);
+    if( osKey.empty() )
+        return nullptr;
+    const CPLString osIndexFilename =
+        GetIndexFilename(poOpenInfo->pszFilename);
+    VSIStatBufL sStat;
+    if( VSIStatL(osIndexFilename, &sStat) != 0 )
+        return nullptr;
+
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    CPLXMLNode *psRoot = CPLParseXMLFile(osIndexFilename);
+    CPLPopErrorHandler();
+    CPLErrorReset();
+    if( psRoot == nullptr )
+        return nullptr;
+
+    CPLXMLNode *psDS = CPLGetXMLNode(psRoot, "=GRIBIndex.Dataset");
+    char **papszGeoTransform = nullptr;
+    if( psDS != nullptr )
+    {
+        papszGeoTransform = CSLTokenizeString2(
+            CPLGetXMLValue(psDS, "GeoTransform", ""), ",", 0);
+    }
+    const int nXSize = atoi(CPLGetXMLValue(psDS, "rasterXSize", "0"));
+    const int nYSize = atoi(CPLGetXMLValue(psDS, "rasterYSize", "0"));
+    if( psDS == nullptr ||
+        !EQUAL(CPLGetXMLValue(psRoot, "=GRIBIndex.version", ""), "1") ||
+        osKey != CPLGetXMLValue(psRoot, "=GRIBIndex.key", "") ||
+        CSLCount(papszGeoTransform) != 6 ||
+        !GDALCheckDatasetDimensions(nXSize, nYSize) )
+    {
+        CPLDebug("GRIB", "Ignoring invalid or outdated %s",
+                 osIndexFilename.c_str());
+        CSLDestroy(papszGeoTransform);
+        CPLDestroyXMLNode(psRoot);
+        return nullptr;
+    }
+
+    GRIBDataset *poDS = new GRIBDataset();
+    poDS->nRasterXSize = nXSize;
+    poDS->nRasterYSize = nYSize;
+    for( int i = 0; i < 6; i++ )
+        poDS->adfGeoTransform[i] = CPLAtof(papszGeoTransform[i]);
+    CSLDestroy(papszGeoTransform);
+    CPLFree(poDS->pszProjection);
+    poDS->pszProjection = CPLStrdup(CPLGetXMLValue(psDS, "SRS", ""));
+
+    for( CPLXMLNode *psIter = psDS->psChild;
+         psIter != nullptr; psIter = psIter->psNext )
+    {
+        if( psIter->eType != CXT_Element || !EQUAL(psIter->pszValue, "Band") )
+            continue;
+
+        const int nStart = atoi(CPLGetXMLValue(psIter, "start", "-1"));
+        if( nStart < 0 )
+        {
+            CPLDebug("GRIB", "Ignoring invalid %s", osIndexFilename.c_str());
+            delete poDS;
+            CPLDestroyXMLNode(psRoot);
+            return nullptr;
+        }
+        GRIBRasterBand *poBand = new GRIBRasterBand(
+            poDS, poDS->nBands + 1, nStart,
+            atoi(CPLGetXMLValue(psIter, "subgNum", "0")),
+            atoi(CPLGetXMLValue(psIter, "gribVersion", "2")),
+            CPLGetXMLValue(psIter, "Description", ""));
+
+        const char *pszHasNoData = CPLGetXMLValue(psIter, "hasNoData", nullptr);
+        if( pszHasNoData != nullptr )
+        {
+            poBand->m_bHasLookedForNoData = true;
+            poBand->m_bHasNoData = CPLTestBool(pszHasNoData);
+            poBand->m_dfNoData =
+                CPLAtof(CPLGetXMLValue(psIter, "noData", "0"));
+        }
+
+        CPLXMLNode *psMD = CPLGetXMLNode(psIter, "Metadata");
+        for( CPLXMLNode *psMDI = psMD ? psMD->psChild : nullptr;
+             psMDI != nullptr; psMDI = psMDI->psNext )
+        {
+            if( psMDI->eType != CXT_Element || !EQUAL(psMDI->pszValue, "MDI") )
+                continue;
+            const char *pszKey = CPLGetXMLValue(psMDI, "key", nullptr);
+            if( pszKey != nullptr )
+                poBand->SetMetadataItem(pszKey,
+                                        CPLGetXMLValue(psMDI, nullptr, ""));
+        }
+
+        poDS->SetBand(poDS->nBands + 1, poBand);
+    }
+    CPLDestroyXMLNode(psRoot);
+
+    if( poDS->nBands == 0 )
+    {
+        delete poDS;
+        return nullptr;
+    }
+
+    CPLDebug("GRIB", "Using %s", osIndexFilename.c_str());
+    poDS->m_osIndexFilename = osIndexFilename;
+
+    poDS->fp = poOpenInfo->fpL;
+    poOpenInfo->fpL = nullptr;
+
+    poDS->SetDescription(poOpenInfo->pszFilename);
+    poDS->TryLoadXML();
+    poDS->oOvManager.Initialize(poDS, poOpenInfo->pszFilename,
+                                poOpenInfo->GetSiblingFiles());
+
+    return poDS;
+}
+
 /************************************************************************/
 /*                            Identify()                                */
 /************************************************************************/
@@ -961,6 +1458,20 @@ GDALDataset *GRIBDataset::Open( GDALOpenInfo *poOpenInfo )
         return nullptr;
     }
 
+    // Restore the dataset from its message index when it is up to date,
+    // which avoids scanning the whole file.
+    const bool bUseIndex =
+        CPLTestBool(CPLGetConfigOption("GRIB_INDEX_CACHE", "NO")) &&
+        strcmp(poOpenInfo->pszFilename, "/vsistdin/") != 0;
+    if( bUseIndex )
+    {
+        CPLReleaseMutex(hGRIBMutex);
+        GRIBDataset *poDS = OpenFromIndex(poOpenInfo);
+        CPLAcquireMutex(hGRIBMutex, 1000.0);
+        if( poDS != nullptr )
+            return poDS;
+    }
+
     // Create a corresponding GDALDataset.
     GRIBDataset *poDS = new GRIBDataset();
 
@@ -1092,6 +1603,8 @@ GDALDataset *GRIBDataset::Open( GDALOpenInfo *poOpenInfo )
     // Release hGRIBMutex otherwise we'll deadlock with GDALDataset own
     // hGRIBMutex.
     CPLReleaseMutex(hGRIBMutex);
+    if( bUseIndex )
+        poDS->WriteIndex();
     poDS->TryLoadXML();
 
     // Check for external overviews.
@@ -46,13 +46,16 @@
 #endif
 
 #include <algorithm>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "degrib/degrib/datasource.h"
 #include "degrib/degrib/degrib2.h"
 #include "degrib/degrib/filedatasource.h"
@@ -93,9 +96,25 @@ class GRIBDataset : public GDALPamDataset
 
     CPLErr      GetGeoTransform( double *padfTransform ) override;
     const char *GetProjectionRef() override;
+    char      **GetFileList() override;
+
+    CPLErr      IRasterIO( GDALRWFlag, int, int, int, int,
+                           void *, int, int, GDALDataType,
+                           int, int *,
+                           GSpacing, GSpacing, GSpacing,
+                           GDALRasterIOExtraArg* psExtraArg ) override;
 
   private:
     void SetGribMetaData(grib_MetaData *meta);
+
+    static CPLString GetIndexFilename( const char *pszFilename );
+    static CPLString GetIndexKey( const char *pszFilename );
+    static GRIBDataset *OpenFromIndex( GDALOpenInfo *poOpenInfo );
+    void        WriteIndex();
+
+    int         GetNumThreads();
+    void        PrefetchMessages( int nBandCount, int *panBandMap );
+
     VSILFILE *fp;
     char *pszProjection;
     // Calculate and store once as GetGeoTransform may be called multiple times.
@@ -105,6 +124,16 @@ class GRIBDataset : public GDALPamDataset
     GIntBig nCachedBytesThreshold;
     int bCacheOnlyOneBand;
     GRIBRasterBand *poLastUsedBand;
+
+    // Name of the message index file, when one has been read or written.
+    CPLString m_osIndexFilename;
+
+    // Raw GRIB2 messages fetched by PrefetchMessages(), indexed by their
+    // offset in the file. Only valid during IRasterIO().
+    std::map<vsi_l_offset, std::vector<GByte> > m_oMapPrefetchedMessages;
+
+    int m_nNumThreads;
+    CPLWorkerThreadPool *m_poThreadPool;
 };
 
 /************************************************************************/
@@ -119,6 +148,8 @@ class GRIBRasterBand : public GDALPamRasterBand
 
 public:
     GRIBRasterBand( GRIBDataset *, int, inventoryType * );
+    GRIBRasterBand( GRIBDataset *, int, sInt4 nStart, int nSubgNum,
+                    int nGribVersion, const char *pszLongFstLevel );
     virtual ~GRIBRasterBand();
     virtual CPLErr IReadBlock( int, int, void * ) override;
     virtual const char *GetDescription() const override;
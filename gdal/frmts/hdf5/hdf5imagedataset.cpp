@@ -101,6 +101,7 @@ class HDF5ImageDataset : public HDF5Dataset
     bool         bHasGeoTransform;
 
     CPLErr CreateODIMH5Projection();
+    void   SetChunkCache();
 
 public:
     HDF5ImageDataset();
@@ -249,9 +250,19 @@ class HDF5ImageRasterBand : public GDALPamRasterBand
     virtual ~HDF5ImageRasterBand();
 
     virtual CPLErr      IReadBlock( int, int, void * ) override;
+    virtual CPLErr      IRasterIO( GDALRWFlag, int, int, int, int,
+                                   void *, int, int, GDALDataType,
+                                   GSpacing nPixelSpace, GSpacing nLineSpace,
+                                   GDALRasterIOExtraArg* psExtraArg ) override;
     virtual double      GetNoDataValue( int * ) override;
     virtual CPLErr      SetNoDataValue( double ) override;
     // virtual CPLErr IWriteBlock( int, int, void * );
+
+  private:
+    CPLErr              ReadWindow( int nXOff, int nYOff,
+                                    int nXSize, int nYSize,
+                                    int nBufXSize, int nBufYSize,
+                                    void *pBuffer );
 };
 
 /************************************************************************/
@@ -341,20 +352,20 @@ CPLErr HDF5ImageRasterBand::SetNoDataValue( double dfNoData )
 }
 
 /************************************************************************/
-/*                             IReadBlock()                             */
+/*                             ReadWindow()                             */
+/*                                                                      */
+/*      Read the nXSize x nYSize window at (nXOff, nYOff) with a        */
+/*      single H5Dread() into the top-left corner of a nBufXSize x      */
+/*      nBufYSize buffer of the native data type.                       */
 /************************************************************************/
-CPLErr HDF5ImageRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
-                                        void *pImage )
+
+CPLErr HDF5ImageRasterBand::ReadWindow( int nXOff, int nYOff,
+                                        int nXSize, int nYSize,
+                                        int nBufXSize, int nBufYSize,
+                                        void *pBuffer )
 {
     HDF5ImageDataset *poGDS = static_cast<HDF5ImageDataset *>(poDS);
 
-    if( poGDS->eAccess == GA_Update )
-    {
-        memset(pImage, 0,
-               nBlockXSize * nBlockYSize * GDALGetDataTypeSize(eDataType) / 8);
-        return CE_None;
-    }
-
     hsize_t count[3] = {0, 0, 0};
     H5OFFSET_TYPE offset[3] = {0, 0, 0};
     hsize_t col_dims[3] = {0, 0, 0};
@@ -376,23 +387,12 @@ CPLErr HDF5ImageRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
     }
     // Defaults to rank = 2;
 
-    offset[poGDS->GetYIndex()] = nBlockYOff * static_cast<hsize_t>(nBlockYSize);
-    offset[poGDS->GetXIndex()] = nBlockXOff * static_cast<hsize_t>(nBlockXSize);
-    count[poGDS->GetYIndex()] = nBlockYSize;
-    count[poGDS->GetXIndex()] = nBlockXSize;
-
-    const int nSizeOfData = static_cast<int>(H5Tget_size(poGDS->native));
-    memset(pImage, 0, nBlockXSize * nBlockYSize * nSizeOfData);
+    offset[poGDS->GetYIndex()] = nYOff;
+    offset[poGDS->GetXIndex()] = nXOff;
+    count[poGDS->GetYIndex()] = nYSize;
+    count[poGDS->GetXIndex()] = nXSize;
 
-    // Blocksize may not be a multiple of imagesize.
-    count[poGDS->GetYIndex()] =
-        std::min(hsize_t(nBlockYSize),
-                 poDS->GetRasterYSize() - offset[poGDS->GetYIndex()]);
-    count[poGDS->GetXIndex()] =
-        std::min(hsize_t(nBlockXSize),
-                 poDS->GetRasterXSize() - offset[poGDS->GetXIndex()]);
-
-    // Select block from file space.
+    // Select window from file space.
     herr_t status = H5Sselect_hyperslab(poGDS->dataspace_id,
                                         H5S_SELECT_SET,
                                         offset, nullptr,
@@ -401,8 +401,8 @@ CPLErr HDF5ImageRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
         return CE_Failure;
 
     // Create memory space to receive the data.
-    col_dims[poGDS->GetYIndex()] = nBlockYSize;
-    col_dims[poGDS->GetXIndex()] = nBlockXSize;
+    col_dims[poGDS->GetYIndex()] = nBufYSize;
+    col_dims[poGDS->GetXIndex()] = nBufXSize;
 
     const hid_t memspace =
         H5Screate_simple(static_cast<int>(rank), col_dims, nullptr);
@@ -412,10 +412,13 @@ CPLErr HDF5ImageRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
                                   mem_offset, nullptr,
                                   count, nullptr);
     if( status < 0 )
+    {
+        H5Sclose(memspace);
         return CE_Failure;
+    }
 
     status = H5Dread(poGDS->dataset_id, poGDS->native, memspace,
-                     poGDS->dataspace_id, H5P_DEFAULT, pImage);
+                     poGDS->dataspace_id, H5P_DEFAULT, pBuffer);
 
     H5Sclose(memspace);
 
@@ -428,6 +431,92 @@ CPLErr HDF5ImageRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
     return CE_None;
 }
 
+/************************************************************************/
+/*                             IReadBlock()                             */
+/************************************************************************/
+CPLErr HDF5ImageRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
+                                        void *pImage )
+{
+    HDF5ImageDataset *poGDS = static_cast<HDF5ImageDataset *>(poDS);
+
+    if( poGDS->eAccess == GA_Update )
+    {
+        memset(pImage, 0,
+               nBlockXSize * nBlockYSize * GDALGetDataTypeSize(eDataType) / 8);
+        return CE_None;
+    }
+
+    const int nSizeOfData = static_cast<int>(H5Tget_size(poGDS->native));
+    memset(pImage, 0, nBlockXSize * nBlockYSize * nSizeOfData);
+
+    // Blocksize may not be a multiple of imagesize.
+    const int nXOff = nBlockXOff * nBlockXSize;
+    const int nYOff = nBlockYOff * nBlockYSize;
+    return ReadWindow(nXOff, nYOff,
+                      std::min(nBlockXSize, nRasterXSize - nXOff),
+                      std::min(nBlockYSize, nRasterYSize - nYOff),
+                      nBlockXSize, nBlockYSize, pImage);
+}
+
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr HDF5ImageRasterBand::IRasterIO( GDALRWFlag eRWFlag,
+                                       int nXOff, int nYOff,
+                                       int nXSize, int nYSize,
+                                       void *pData,
+                                       int nBufXSize, int nBufYSize,
+                                       GDALDataType eBufType,
+                                       GSpacing nPixelSpace,
+                                       GSpacing nLineSpace,
+                                       GDALRasterIOExtraArg* psExtraArg )
+{
+    HDF5ImageDataset *poGDS = static_cast<HDF5ImageDataset *>(poDS);
+    const int nDTSize = GDALGetDataTypeSizeBytes(eDataType);
+
+    // Requests spanning several blocks, without resampling, are read with a
+    // single H5Dread(), so that the library decodes each chunk only once
+    // and the block cache is not polluted.
+    if( eRWFlag == GF_Read && poGDS->eAccess == GA_ReadOnly &&
+        nXSize == nBufXSize && nYSize == nBufYSize &&
+        (nXSize > nBlockXSize || nYSize > nBlockYSize) &&
+        static_cast<int>(H5Tget_size(poGDS->native)) == nDTSize )
+    {
+        const bool bDirect = eBufType == eDataType &&
+                             nPixelSpace == nDTSize &&
+                             nLineSpace == nPixelSpace * nBufXSize;
+        GByte *pabyTemp = bDirect ? static_cast<GByte *>(pData) :
+            static_cast<GByte *>(VSIMalloc3(nXSize, nYSize, nDTSize));
+        if( pabyTemp != nullptr )
+        {
+            CPLErr eErr = ReadWindow(nXOff, nYOff, nXSize, nYSize,
+                                     nXSize, nYSize, pabyTemp);
+            if( !bDirect )
+            {
+                for( int iY = 0; eErr == CE_None && iY < nYSize; iY++ )
+                {
+                    GDALCopyWords(pabyTemp +
+                                    static_cast<size_t>(iY) * nXSize * nDTSize,
+                                  eDataType, nDTSize,
+                                  static_cast<GByte *>(pData) +
+                                    iY * nLineSpace,
+                                  eBufType, static_cast<int>(nPixelSpace),
+                                  nXSize);
+                }
+                VSIFree(pabyTemp);
+            }
+            if( eErr == CE_None && psExtraArg->pfnProgress != nullptr )
+                psExtraArg->pfnProgress(1.0, "", psExtraArg->pProgressData);
+            return eErr;
+        }
+    }
+
+    return GDALPamRasterBand::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                        pData, nBufXSize, nBufYSize, eBufType,
+                                        nPixelSpace, nLineSpace, psExtraArg);
+}
+
 /************************************************************************/
 /*                              Identify()                              */
 /************************************************************************/
@@ -580,6 +669,8 @@ GDALDataset *HDF5ImageDataset::Open( GDALOpenInfo *poOpenInfo )
         poDS->nBands = 1;
     }
 
+    poDS->SetChunkCache();
+
     for( int i = 1; i <= poDS->nBands; i++ )
     {
         HDF5ImageRasterBand *const poBand =
@@ -601,6 +692,68 @@ GDALDataset *HDF5ImageDataset::Open( GDALOpenInfo *poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                           SetChunkCache()                            */
+/*                                                                      */
+/*      The default HDF5 chunk cache (1 MB) is often too small to hold  */
+/*      a row of chunks, in which case reading a window not aligned on  */
+/*      chunks, or scanline per scanline, decodes the same chunks       */
+/*      several times. Reopen the dataset with a cache large enough     */
+/*      for a row of chunks, within a quarter of the GDAL block cache.  */
+/************************************************************************/
+
+void HDF5ImageDataset::SetChunkCache()
+{
+#ifdef H5_VERSION_GE
+#if H5_VERSION_GE(1,8,3)
+    const hid_t listid = H5Dget_create_plist(dataset_id);
+    if( listid < 0 )
+        return;
+    hsize_t anChunkDims[3] = {0, 0, 0};
+    const bool bChunked = H5Pget_layout(listid) == H5D_CHUNKED &&
+                          ndims <= 3 &&
+                          H5Pget_chunk(listid, 3, anChunkDims) == ndims;
+    H5Pclose(listid);
+    if( !bChunked )
+        return;
+
+    GUIntBig nChunkBytes = H5Tget_size(native);
+    for( int i = 0; i < ndims; i++ )
+        nChunkBytes *= anChunkDims[i];
+    const hsize_t nChunkXSize = anChunkDims[GetXIndex()];
+    if( nChunkBytes == 0 || nChunkXSize == 0 )
+        return;
+    const GUIntBig nChunksPerRow =
+        (static_cast<GUIntBig>(nRasterXSize) + nChunkXSize - 1) / nChunkXSize;
+    const GUIntBig nCacheSize = std::min(
+        nChunksPerRow * nChunkBytes,
+        static_cast<GUIntBig>(GDALGetCacheMax64() / 4));
+    if( nCacheSize <= 1024 * 1024 )
+        return;
+
+    const hid_t dapl = H5Pcreate(H5P_DATASET_ACCESS);
+    if( dapl < 0 )
+        return;
+    const size_t nSlots = static_cast<size_t>(
+        std::max(static_cast<GUIntBig>(521), 10 * nChunksPerRow + 1));
+    if( H5Pset_chunk_cache(dapl, nSlots, static_cast<size_t>(nCacheSize),
+                           H5D_CHUNK_CACHE_W0_DEFAULT) >= 0 )
+    {
+        const hid_t hNewDatasetId =
+            H5Dopen2(hHDF5, poH5Objects->pszPath, dapl);
+        if( hNewDatasetId >= 0 )
+        {
+            CPLDebug("HDF5", "Using a chunk cache of " CPL_FRMT_GUIB " bytes",
+                     nCacheSize);
+            H5Dclose(dataset_id);
+            dataset_id = hNewDatasetId;
+        }
+    }
+    H5Pclose(dapl);
+#endif
+#endif
+}
+
 /************************************************************************/
 /*                        GDALRegister_HDF5Image()                      */
 /************************************************************************/
@@ -103,6 +103,16 @@ class MBTilesDataset : public GDALPamDataset, public GDALGPKGMBTilesLikePseudoDa
     virtual char      **GetMetadata( const char * pszDomain = "" ) override;
     virtual const char *GetMetadataItem( const char* pszName, const char * pszDomain = "" ) override;
 
+    virtual CPLErr      IRasterIO( GDALRWFlag eRWFlag,
+                                   int nXOff, int nYOff,
+                                   int nXSize, int nYSize,
+                                   void * pData,
+                                   int nBufXSize, int nBufYSize,
+                                   GDALDataType eBufType,
+                                   int nBandCount, int *panBandMap,
+                                   GSpacing nPixelSpace, GSpacing nLineSpace,
+                                   GSpacing nBandSpace,
+                                   GDALRasterIOExtraArg* psExtraArg ) override;
     virtual CPLErr    IBuildOverviews(
                         const char * pszResampling,
                         int nOverviews, int * panOverviewList,
@@ -953,6 +963,30 @@ int MBTilesDataset::GetRowFromIntoTopConvention(int nRow)
     return m_nTileMatrixHeight - 1 - nRow;
 }
 
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr MBTilesDataset::IRasterIO( GDALRWFlag eRWFlag,
+                                  int nXOff, int nYOff,
+                                  int nXSize, int nYSize,
+                                  void * pData,
+                                  int nBufXSize, int nBufYSize,
+                                  GDALDataType eBufType,
+                                  int nBandCount, int *panBandMap,
+                                  GSpacing nPixelSpace, GSpacing nLineSpace,
+                                  GSpacing nBandSpace,
+                                  GDALRasterIOExtraArg* psExtraArg )
+{
+    if( eRWFlag == GF_Read && nBands > 0 )
+        PrefetchTiles(nXOff, nYOff, nXSize, nYSize, nBufXSize, nBufYSize);
+    return GDALPamDataset::IRasterIO( eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                      pData, nBufXSize, nBufYSize, eBufType,
+                                      nBandCount, panBandMap,
+                                      nPixelSpace, nLineSpace, nBandSpace,
+                                      psExtraArg );
+}
+
 /************************************************************************/
 /*                          GetGeoTransform()                           */
 /************************************************************************/
@@ -44,13 +44,14 @@
  */
 
 #include "marfa.h"
+#include "cpl_multiproc.h"
 
 CPL_CVSID("$Id$")
 
 NAMESPACE_MRF_START
 
-// Returns a string in /vsimem/ + prefix + count that doesn't exist when this function gets called
-// It is not thread safe, open the result as soon as possible
+// Returns a string in /vsimem/ + prefix + thread + count that doesn't exist when this function gets called
+// Pages can be encoded and decoded by worker threads, the thread id keeps the names apart
 static CPLString uniq_memfname(const char *prefix)
 {
 
@@ -62,7 +63,8 @@ static CPLString uniq_memfname(const char *prefix)
     CPLString fname;
     VSIStatBufL statb;
     static unsigned int cnt=0;
-    do fname.Printf("/vsimem/%s_%08x",prefix, cnt++);
+    do fname.Printf("/vsimem/%s_" CPL_FRMT_GIB "_%08x", prefix,
+                    static_cast<GIntBig>(CPLGetPID()), cnt++);
     while (!VSIStatL(fname, &statb));
     return fname;
 #endif
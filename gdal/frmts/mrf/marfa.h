@@ -52,6 +52,10 @@
 #include <gdal_pam.h>
 #include <ogr_srs_api.h>
 #include <ogr_spatialref.h>
+#include <cpl_worker_thread_pool.h>
+
+#include <map>
+#include <vector>
 
 // For printing values
 #include <ostream>
@@ -296,6 +300,20 @@ enum { SAMPLING_ERR, SAMPLING_Avg, SAMPLING_Near };
 
 GDALMRFRasterBand *newMRFRasterBand(GDALMRFDataset *, const ILImage &, int, int level = 0);
 
+// A page compressed by a worker thread, written by the main thread
+typedef struct {
+    GDALMRFDataset *poDS;
+    GDALMRFRasterBand *poBand; // nullptr when the slot is free
+    GUIntBig infooffset;
+    char *buffer;       // Raw page, followed by space for the compressed page
+    size_t bufsize;     // Allocated size of buffer
+    void *outbuff;      // Compressed page, within buffer
+    size_t outsize;
+    bool swab;          // Swap the raw page before compressing it
+    bool ready;
+    CPLErr ret;
+} MRFCompressionJob;
+
 class GDALMRFDataset : public GDALPamDataset {
     friend class GDALMRFRasterBand;
     friend GDALMRFRasterBand *newMRFRasterBand(GDALMRFDataset *, const ILImage &, int, int level);
@@ -338,6 +356,8 @@ public:
 
     virtual char **GetFileList() override;
 
+    virtual void FlushCache() override;
+
     void SetColorTable(GDALColorTable *pct) { poColorTable = pct; }
     const GDALColorTable *GetColorTable() { return poColorTable; }
     void SetNoDataValue(const char*);
@@ -420,6 +440,25 @@ protected:
     // Read the index record itself
     CPLErr ReadTileIdx(ILIdx &tinfo, const ILSize &pos, const ILImage &img, const GIntBig bias = 0);
 
+    // Worker threads for page compression and decompression, from NUM_THREADS
+    int GetNumThreads();
+    CPLWorkerThreadPool *GetThreadPool();
+
+    // Compress a page in a worker thread, returns false if it can't be done
+    bool SubmitCompressionJob(GDALMRFRasterBand *poBand, const void *page,
+        GUIntBig infooffset, bool swab);
+    static void CompressionJobFunc(void *pData);
+    void WriteCompressionJob(MRFCompressionJob &job);
+    // Wait for and write all the pending compressed pages
+    void FlushCompressionJobs();
+
+    // Write the index records held by WriteTile
+    void FlushIdx();
+
+    // Decode in parallel the pages covering a window, into the block cache
+    void PrefetchBlocks(const std::vector<GDALMRFRasterBand *> &bands,
+        int nXOff, int nYOff, int nXSize, int nYSize);
+
     VSILFILE *IdxFP();
     VSILFILE *DataFP();
     GDALRWFlag IdxMode() {
@@ -501,6 +540,14 @@ protected:
     VF dfp;  // Data file handle
     VF ifp;  // Index file handle
 
+    int nThreads;  // Worker thread count, -1 if not yet known
+    CPLWorkerThreadPool *poThreadPool;
+    std::vector<MRFCompressionJob> compressionJobs;
+    CPLMutex *hJobMutex;
+
+    // Index records not yet written, keyed by their offset in the index file
+    std::map<GUIntBig, ILIdx> pendingIdx;
+
     // statistical values
     std::vector<double> vNoData, vMin, vMax;
 };
@@ -540,6 +587,19 @@ public:
     // de-interlace a buffer in pixel blocks
     CPLErr ReadInterleavedBlock(int xblk, int yblk, void *buffer);
 
+    // Decode a page read from the data file, can be called from any thread
+    CPLErr DecodePage(void *data, size_t size, buf_mgr &dst, bool quiet);
+    // Encode a raw page, followed by space for the compressed one
+    CPLErr EncodePage(buf_mgr &src, bool swab, void **outbuff, size_t *outsize);
+    // Store a decoded page in the block cache, unless already there
+    void CachePage(int xblk, int yblk, void *page);
+
+#if GDAL_VERSION_MAJOR >= 2
+    virtual CPLErr IRasterIO(GDALRWFlag, int, int, int, int,
+        void *, int, int, GDALDataType,
+        GSpacing, GSpacing, GDALRasterIOExtraArg*) override;
+#endif
+
     const char *GetOptionValue(const char *opt, const char *def) const;
     void SetAccess(GDALAccess eA) { eAccess = eA; }
     void SetDeflate(int v) { deflatep = (v != 0); }
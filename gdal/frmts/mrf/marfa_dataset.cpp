@@ -93,7 +93,10 @@ GDALMRFDataset::GDALMRFDataset() :
     bdirty(0),
     bGeoTransformValid(TRUE),
     poColorTable(nullptr),
-    Quality(0)
+    Quality(0),
+    nThreads(-1),
+    poThreadPool(nullptr),
+    hJobMutex(nullptr)
 {
     //                X0   Xx   Xy  Y0    Yx   Yy
     double gt[6] = { 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
@@ -160,11 +163,28 @@ GDALMRFDataset::~GDALMRFDataset()
 
     delete poColorTable;
 
+    delete poThreadPool;
+    for (size_t i = 0; i < compressionJobs.size(); i++)
+        CPLFree(compressionJobs[i].buffer);
+    if (hJobMutex)
+        CPLDestroyMutex(hJobMutex);
+
     // CPLFree ignores being called with NULL
     CPLFree(pbuffer);
     pbsize = 0;
 }
 
+//
+// Pages compressed in worker threads and held index records
+// are written after the dirty blocks get flushed
+//
+void GDALMRFDataset::FlushCache()
+{
+    GDALPamDataset::FlushCache();
+    FlushCompressionJobs();
+    FlushIdx();
+}
+
 #ifdef unused
 /*
  *\brief Called before the IRaster IO gets called
@@ -207,6 +227,18 @@ CPLErr GDALMRFDataset::IRasterIO(GDALRWFlag eRWFlag, int nXOff, int nYOff, int n
         static_cast<int>(nPixelSpace), static_cast<int>(nLineSpace),
         static_cast<int>(nBandSpace));
 
+#if GDAL_VERSION_MAJOR >= 2
+    //
+    // Decode all the pages needed at once, in parallel when possible
+    //
+    if (eRWFlag == GF_Read && cds == nullptr && nXSize == nBufXSize && nYSize == nBufYSize) {
+        vector<GDALMRFRasterBand *> bands;
+        for (int i = 0; i < nBandCount; i++)
+            bands.push_back(reinterpret_cast<GDALMRFRasterBand *>(GetRasterBand(panBandMap[i])));
+        PrefetchBlocks(bands, nXOff, nYOff, nXSize, nYSize);
+    }
+#endif
+
     //
     // Call the parent implementation, which splits it into bands and calls their IRasterIO
     //
@@ -1838,6 +1870,11 @@ void GDALMRFDataset::ProcessOpenOptions(char **papszOptions)
 {
     CPLStringList opt(papszOptions, FALSE);
     no_errors = opt.FetchBoolean("NOERRORS", FALSE);
+
+    const char *val = opt.FetchNameValue("NUM_THREADS");
+    if (val)
+        nThreads = std::max(1, std::min(128,
+            EQUAL(val, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(val)));
 }
 
 // Apply create options to the current dataset, only valid during creation
@@ -1858,6 +1895,11 @@ void GDALMRFDataset::ProcessCreateOptions(char **papszOptions)
     val = opt.FetchNameValue("QUALITY");
     if (val) img.quality = atoi(val);
 
+    val = opt.FetchNameValue("NUM_THREADS");
+    if (val)
+        nThreads = std::max(1, std::min(128,
+            EQUAL(val, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(val)));
+
     val = opt.FetchNameValue("ZSIZE");
     if (val) img.size.z = atoi(val);
 
@@ -2181,6 +2223,15 @@ CPLErr GDALMRFDataset::WriteTile(void *buff, GUIntBig infooffset, GUIntBig size)
     if (nullptr != buff && 0 == size)
         tinfo.offset = net64(GUIntBig(buff));
 
+    // When compressing in worker threads, hold the index records to write them in runs
+    // Not for versioned or multi-process MRFs, which read the index back
+    if (poThreadPool != nullptr && !hasVersions && !mp_safe) {
+        pendingIdx[infooffset] = tinfo;
+        if (pendingIdx.size() >= 4096)
+            FlushIdx();
+        return ret;
+    }
+
     VSIFSeekL(l_ifp, infooffset, SEEK_SET);
     if (sizeof(tinfo) != VSIFWriteL(&tinfo, 1, sizeof(tinfo), l_ifp))
         ret = CE_Failure;
@@ -2221,6 +2272,302 @@ CPLErr GDALMRFDataset::GetGeoTransform(double *gt)
     return CE_None;
 }
 
+/************************************************************************/
+/*                           GetNumThreads()                            */
+/************************************************************************/
+
+//
+// Worker threads used for page compression and decompression, from the
+// NUM_THREADS creation or open option, or the GDAL_NUM_THREADS configuration option
+//
+int GDALMRFDataset::GetNumThreads()
+{
+    if (nThreads < 0) {
+        const char *val = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+        nThreads = 1;
+        if (val)
+            nThreads = std::max(1, std::min(128,
+                EQUAL(val, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(val)));
+    }
+    return nThreads;
+}
+
+CPLWorkerThreadPool *GDALMRFDataset::GetThreadPool()
+{
+    if (poThreadPool == nullptr && GetNumThreads() > 1) {
+        CPLDebug("MRF", "Using %d threads", nThreads);
+        poThreadPool = new CPLWorkerThreadPool();
+        if (!poThreadPool->Setup(nThreads, nullptr, nullptr)) {
+            delete poThreadPool;
+            poThreadPool = nullptr;
+            nThreads = 1;
+        }
+    }
+    return poThreadPool;
+}
+
+/************************************************************************/
+/*                        SubmitCompressionJob()                        */
+/************************************************************************/
+
+void GDALMRFDataset::CompressionJobFunc(void *pData)
+{
+    MRFCompressionJob *psJob = static_cast<MRFCompressionJob *>(pData);
+    buf_mgr src = { psJob->buffer,
+        static_cast<size_t>(psJob->poBand->img.pageSizeBytes) };
+    psJob->ret = psJob->poBand->EncodePage(src, psJob->swab,
+        &psJob->outbuff, &psJob->outsize);
+
+    CPLAcquireMutex(psJob->poDS->hJobMutex, 1000.0);
+    psJob->ready = true;
+    CPLReleaseMutex(psJob->poDS->hJobMutex);
+}
+
+// Write a compressed page and free the job slot
+void GDALMRFDataset::WriteCompressionJob(MRFCompressionJob &job)
+{
+    // Compression failed, write it as an empty tile
+    if (job.ret != CE_None)
+        WriteTile(nullptr, job.infooffset, 0);
+    else
+        WriteTile(job.outbuff, job.infooffset, job.outsize);
+    job.poBand = nullptr;
+    job.ready = false;
+}
+
+//
+// Copies the page and compresses it in a worker thread.  The page gets written
+// by the main thread, once a slot is needed for another page or on flush
+// The number of slots is one more than the number of threads, so the main
+// thread can do the I/O while all the workers are busy
+//
+bool GDALMRFDataset::SubmitCompressionJob(GDALMRFRasterBand *poBand, const void *page,
+    GUIntBig infooffset, bool swab)
+{
+    // The PPNG palette is set up on first use, not safe to do concurrently
+    if (poBand->img.comp == IL_PPNG || GetThreadPool() == nullptr)
+        return false;
+
+    if (compressionJobs.empty()) {
+        MRFCompressionJob empty;
+        memset(&empty, 0, sizeof(empty));
+        compressionJobs.resize(nThreads + 1, empty);
+        hJobMutex = CPLCreateMutex();
+        CPLReleaseMutex(hJobMutex);
+    }
+
+    // Wait for at least one free slot
+    poThreadPool->WaitCompletion(static_cast<int>(compressionJobs.size() - 1));
+    MRFCompressionJob *psJob = nullptr;
+    for (size_t i = 0; i < compressionJobs.size(); i++) {
+        CPLAcquireMutex(hJobMutex, 1000.0);
+        const bool ready = compressionJobs[i].ready;
+        CPLReleaseMutex(hJobMutex);
+        if (ready)
+            WriteCompressionJob(compressionJobs[i]);
+        if (psJob == nullptr && compressionJobs[i].poBand == nullptr)
+            psJob = &compressionJobs[i];
+    }
+    assert(psJob != nullptr);
+
+    const size_t bufsize = static_cast<size_t>(poBand->img.pageSizeBytes) + pbsize;
+    if (psJob->bufsize < bufsize) {
+        void *newbuff = VSIRealloc(psJob->buffer, bufsize);
+        if (newbuff == nullptr)
+            return false; // Compress it in this thread
+        psJob->buffer = static_cast<char *>(newbuff);
+        psJob->bufsize = bufsize;
+    }
+    memcpy(psJob->buffer, page, poBand->img.pageSizeBytes);
+    psJob->poDS = this;
+    psJob->poBand = poBand;
+    psJob->infooffset = infooffset;
+    psJob->swab = swab;
+    psJob->ready = false;
+    psJob->ret = CE_None;
+
+    poThreadPool->SubmitJob(CompressionJobFunc, psJob);
+    return true;
+}
+
+void GDALMRFDataset::FlushCompressionJobs()
+{
+    if (compressionJobs.empty())
+        return;
+    poThreadPool->WaitCompletion();
+    for (size_t i = 0; i < compressionJobs.size(); i++)
+        if (compressionJobs[i].poBand != nullptr)
+            WriteCompressionJob(compressionJobs[i]);
+}
+
+/************************************************************************/
+/*                              FlushIdx()                              */
+/************************************************************************/
+
+//
+// Write the held index records, consecutive records with a single write
+//
+void GDALMRFDataset::FlushIdx()
+{
+    if (pendingIdx.empty())
+        return;
+
+    VSILFILE *l_ifp = IdxFP();
+    vector<ILIdx> run;
+    GUIntBig start = 0;
+    for (std::map<GUIntBig, ILIdx>::const_iterator it = pendingIdx.begin();; ++it) {
+        if (!run.empty() &&
+            (it == pendingIdx.end() || it->first != start + run.size() * sizeof(ILIdx)))
+        {
+            VSIFSeekL(l_ifp, start, SEEK_SET);
+            if (run.size() != VSIFWriteL(&run[0], sizeof(ILIdx), run.size(), l_ifp))
+                CPLError(CE_Failure, CPLE_FileIO, "MRF: Can't write index");
+            run.clear();
+        }
+        if (it == pendingIdx.end())
+            break;
+        if (run.empty())
+            start = it->first;
+        run.push_back(it->second);
+    }
+    pendingIdx.clear();
+}
+
+/************************************************************************/
+/*                           PrefetchBlocks()                           */
+/************************************************************************/
+
+namespace {
+// A page to decode in a worker thread
+typedef struct {
+    GDALMRFRasterBand *poBand;
+    int xblk, yblk;
+    void *data;     // The page as stored, freed by the decoding
+    size_t size;
+    void *page;     // Decoded page
+    CPLErr ret;
+} MRFDecompressionJob;
+}
+
+//
+// Reads the pages of the window which are not in the block cache yet, then
+// decodes them in the worker threads and stores them in the block cache.
+// Anything unusual, such as a missing, cached or failing page, is left to
+// IReadBlock(), which is called afterwards anyhow
+//
+void GDALMRFDataset::PrefetchBlocks(const vector<GDALMRFRasterBand *> &bands,
+    int nXOff, int nYOff, int nXSize, int nYSize)
+{
+    if (bands.empty() || (bypass_cache && !source.empty()) || GetNumThreads() < 2)
+        return;
+
+    int nBlockXSize, nBlockYSize;
+    bands[0]->GetBlockSize(&nBlockXSize, &nBlockYSize);
+    const int bx0 = nXOff / nBlockXSize, bx1 = (nXOff + nXSize - 1) / nBlockXSize;
+    const int by0 = nYOff / nBlockYSize, by1 = (nYOff + nYSize - 1) / nBlockYSize;
+    if (bands.size() == 1 && bx0 == bx1 && by0 == by1)
+        return;
+
+    VSILFILE *l_dfp = DataFP();
+    if (l_dfp == nullptr || GetThreadPool() == nullptr)
+        return;
+
+    // The pages to decode, within half of the block cache
+    const GIntBig cachemax = GDALGetCacheMax64() / 2;
+    GIntBig total = 0;
+    vector<MRFDecompressionJob> pages;
+    vector<ILSize> seen; // Interleaved pages already listed
+    for (size_t ib = 0; ib < bands.size(); ib++) {
+        GDALMRFRasterBand *poBand = bands[ib];
+        const int cstride = poBand->img.pagesize.c;
+        for (int y = by0; y <= by1; y++) {
+            for (int x = bx0; x <= bx1; x++) {
+                if (cstride != 1) {
+                    ILSize req(x, y, 0, (poBand->nBand - 1) / cstride, poBand->m_l);
+                    if (std::find(seen.begin(), seen.end(), req) != seen.end())
+                        continue;
+                    seen.push_back(req);
+                }
+
+                GDALRasterBlock *poBlock = poBand->TryGetLockedBlockRef(x, y);
+                if (poBlock != nullptr) {
+                    poBlock->DropLock();
+                    continue;
+                }
+
+                total += poBand->img.pageSizeBytes;
+                if (total > cachemax)
+                    return;
+
+                MRFDecompressionJob job = { poBand, x, y, nullptr, 0, nullptr, CE_Failure };
+                pages.push_back(job);
+            }
+        }
+    }
+    if (pages.size() < 2)
+        return;
+
+    struct Worker {
+        static void Decode(void *pData) {
+            MRFDecompressionJob *psJob = static_cast<MRFDecompressionJob *>(pData);
+            const ILImage &img = psJob->poBand->img;
+            psJob->page = VSIMalloc(img.pageSizeBytes);
+            if (psJob->page == nullptr) {
+                CPLFree(psJob->data);
+                return;
+            }
+            buf_mgr dst = { static_cast<char *>(psJob->page),
+                static_cast<size_t>(img.pageSizeBytes) };
+            psJob->ret = psJob->poBand->DecodePage(psJob->data, psJob->size, dst, true);
+        }
+    };
+
+    // In batches, to bound the memory used by the pages in flight
+    const size_t batch = static_cast<size_t>(nThreads) * 4;
+    for (size_t start = 0; start < pages.size(); start += batch) {
+        const size_t end = std::min(pages.size(), start + batch);
+
+        // The I/O is done by this thread
+        vector<void *> apData;
+        for (size_t i = start; i < end; i++) {
+            MRFDecompressionJob &job = pages[i];
+            const ILImage &img = job.poBand->img;
+            ILSize req(job.xblk, job.yblk, 0,
+                (job.poBand->nBand - 1) / img.pagesize.c, job.poBand->m_l);
+            ILIdx tinfo;
+            tinfo.size = 0;
+            if (CE_None != ReadTileIdx(tinfo, req, img)
+                || tinfo.size <= 0 || tinfo.size > GIntBig(pbsize) * 2)
+                continue;
+
+            job.data = VSIMalloc(static_cast<size_t>(tinfo.size + PADDING_BYTES));
+            if (job.data == nullptr)
+                continue;
+            VSIFSeekL(l_dfp, tinfo.offset, SEEK_SET);
+            if (1 != VSIFReadL(job.data, static_cast<size_t>(tinfo.size), 1, l_dfp)) {
+                CPLFree(job.data);
+                job.data = nullptr;
+                continue;
+            }
+            memset(static_cast<char *>(job.data) + static_cast<size_t>(tinfo.size), 0, PADDING_BYTES);
+            job.size = static_cast<size_t>(tinfo.size);
+            apData.push_back(&job);
+        }
+
+        if (apData.empty())
+            continue;
+        poThreadPool->SubmitJobs(Worker::Decode, apData);
+        poThreadPool->WaitCompletion();
+
+        for (size_t i = start; i < end; i++) {
+            MRFDecompressionJob &job = pages[i];
+            if (job.ret == CE_None)
+                job.poBand->CachePage(job.xblk, job.yblk, job.page);
+            VSIFree(job.page);
+        }
+    }
+}
+
 /**
 *\brief Read a tile index
 *
@@ -2231,6 +2578,10 @@ CPLErr GDALMRFDataset::GetGeoTransform(double *gt)
 CPLErr GDALMRFDataset::ReadTileIdx(ILIdx &tinfo, const ILSize &pos, const ILImage &img, const GIntBig bias)
 
 {
+    // Tiles being written are not in the index yet
+    FlushCompressionJobs();
+    FlushIdx();
+
     VSILFILE *l_ifp = IdxFP();
 
     // Initialize the tinfo structure, in case the files are missing
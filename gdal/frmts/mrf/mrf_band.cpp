@@ -664,6 +664,134 @@ CPLErr GDALMRFRasterBand::FetchClonedBlock(int xblk, int yblk, void *buffer)
     return IReadBlock(xblk, yblk, buffer);
 }
 
+/**
+*\brief Decode a page read from the data file
+*
+* The data holds size bytes followed by PADDING_BYTES, it gets freed.
+* dst has to be pageSizeBytes.  Only uses the band and image settings, so it
+* can be called from a worker thread.  If quiet is set, the codec errors are not reported.
+*/
+CPLErr GDALMRFRasterBand::DecodePage(void *data, size_t size, buf_mgr &dst, bool quiet)
+{
+    buf_mgr src = {(char *)data, size};
+
+    // We got the data, do we need to decompress it before decoding?
+    if (deflatep) {
+        if( img.pageSizeBytes > INT_MAX - 1440 )
+        {
+            CPLFree(data);
+            CPLError(CE_Failure, CPLE_AppDefined, "Page size too big at %d",
+                     img.pageSizeBytes);
+            return CE_Failure;
+        }
+        buf_mgr zdst;
+        zdst.size = img.pageSizeBytes + 1440; // in case the packed page is a bit larger than the raw one
+        zdst.buffer = (char *)VSIMalloc(zdst.size);
+        if( zdst.buffer == nullptr )
+        {
+            CPLFree(data);
+            CPLError(CE_Failure, CPLE_OutOfMemory, "Cannot allocate %d bytes",
+                     static_cast<int>(zdst.size));
+            return CE_Failure;
+        }
+
+        int Zret = ZUnPack(src, zdst, deflate_flags);
+        if (Zret) {
+            // Got it unpacked, update the pointers
+            CPLFree(data);
+            data = zdst.buffer;
+            size = zdst.size;
+        } else {
+            // assume the page was not gzipped, proceed
+            CPLFree(zdst.buffer);
+            if (!quiet)
+                CPLError(CE_Warning, CPLE_AppDefined, "Can't inflate page!");
+        }
+    }
+
+    src.buffer = (char *)data;
+    src.size = size;
+
+    if (quiet)
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+    CPLErr ret = Decompress(dst, src);
+    if (quiet)
+        CPLPopErrorHandler();
+
+    dst.size = img.pageSizeBytes; // In case the decompress failed, force it back
+
+    // Swap whatever we decompressed if we need to
+    if (is_Endianess_Dependent(img.dt, img.comp) && (img.nbo != NET_ORDER))
+        swab_buff(dst, img);
+
+    CPLFree(data);
+    return ret;
+}
+
+/**
+*\brief Store a decoded page in the block cache
+*
+* For interleaved pages, the blocks of all the bands are filled.
+* Blocks already in the cache are left alone, they might be dirty
+*/
+void GDALMRFRasterBand::CachePage(int xblk, int yblk, void *page)
+{
+    const int cstride = img.pagesize.c;
+    const int first = (1 == cstride) ? nBand - 1 : 0;
+    const int last = (1 == cstride) ? nBand : poDS->nBands;
+
+    for (int i = first; i < last; i++) {
+        GDALRasterBand *b = poDS->GetRasterBand(i + 1);
+        if (b->GetOverviewCount() && 0 != m_l)
+            b = b->GetOverview(m_l - 1);
+
+        GDALRasterBlock *poBlock =
+            reinterpret_cast<GDALMRFRasterBand *>(b)->TryGetLockedBlockRef(xblk, yblk);
+        if (poBlock != nullptr) {
+            poBlock->DropLock();
+            continue;
+        }
+        poBlock = b->GetLockedBlockRef(xblk, yblk, TRUE);
+        if (poBlock == nullptr)
+            continue;
+
+        void *ob = poBlock->GetDataRef();
+        if (1 == cstride) {
+            memcpy(ob, page, blockSizeBytes());
+        }
+        else {
+#define CpySI(T) cpy_stride_in<T> (ob, reinterpret_cast<T *>(page) + i,\
+    blockSizeBytes()/sizeof(T), cstride)
+            switch (GDALGetDataTypeSize(eDataType)/8)
+            {
+            case 1: CpySI(GByte); break;
+            case 2: CpySI(GInt16); break;
+            case 4: CpySI(GInt32); break;
+            case 8: CpySI(GIntBig); break;
+            }
+#undef CpySI
+        }
+        poBlock->DropLock();
+    }
+}
+
+#if GDAL_VERSION_MAJOR >= 2
+/**
+*\brief Decode the pages of the window concurrently before the regular read
+*/
+CPLErr GDALMRFRasterBand::IRasterIO(GDALRWFlag eRWFlag, int nXOff, int nYOff, int nXSize, int nYSize,
+    void *pData, int nBufXSize, int nBufYSize, GDALDataType eBufType,
+    GSpacing nPixelSpace, GSpacing nLineSpace, GDALRasterIOExtraArg* psExtraArg)
+{
+    if (eRWFlag == GF_Read && nXSize == nBufXSize && nYSize == nBufYSize)
+        poDS->PrefetchBlocks(std::vector<GDALMRFRasterBand *>(1, this),
+            nXOff, nYOff, nXSize, nYSize);
+
+    return GDALPamRasterBand::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+        pData, nBufXSize, nBufYSize, eBufType, nPixelSpace, nLineSpace, psExtraArg);
+}
+#endif
+
 /**
 *\brief read a block in the provided buffer
 *
@@ -768,71 +896,20 @@ CPLErr GDALMRFRasterBand::IReadBlock(int xblk, int yblk, void *buffer)
     /* initialize padding bytes */
     memset(((char*)data) + static_cast<size_t>(tinfo.size), 0, PADDING_BYTES);
 
-    buf_mgr src = {(char *)data, static_cast<size_t>(tinfo.size)};
-    buf_mgr dst;
-
-    // We got the data, do we need to decompress it before decoding?
-    if (deflatep) {
-        if( img.pageSizeBytes > INT_MAX - 1440 )
-        {
-            CPLFree(data);
-            CPLError(CE_Failure, CPLE_AppDefined, "Page size too big at %d",
-                     img.pageSizeBytes);
-            return CE_Failure;
-        }
-        dst.size = img.pageSizeBytes + 1440; // in case the packed page is a bit larger than the raw one
-        dst.buffer = (char *)VSIMalloc(dst.size);
-        if( dst.buffer == nullptr )
-        {
-            CPLFree(data);
-            CPLError(CE_Failure, CPLE_OutOfMemory, "Cannot allocate %d bytes",
-                     static_cast<int>(dst.size));
-            return CE_Failure;
-        }
-
-        int Zret = ZUnPack(src, dst, deflate_flags);
-        if (Zret) {
-            // Got it unpacked, update the pointers
-            CPLFree(data);
-            data = dst.buffer;
-            tinfo.size = dst.size;
-        } else {
-            // assume the page was not gzipped, proceed
-            CPLFree(dst.buffer);
-            if (!poDS->no_errors)
-                CPLError(CE_Warning, CPLE_AppDefined, "Can't inflate page!");
-        }
-    }
-
-    src.buffer = (char *)data;
-    src.size = static_cast<size_t>(tinfo.size);
-
     // After unpacking, the size has to be pageSizeBytes
     // If pages are interleaved, use the dataset page buffer instead
+    buf_mgr dst;
     dst.buffer = reinterpret_cast<char *>((1 == cstride) ? buffer : poDS->GetPBuffer());
     dst.size = img.pageSizeBytes;
 
-    if (poDS->no_errors)
-        CPLPushErrorHandler(CPLQuietErrorHandler);
-    CPLErr ret = Decompress(dst, src);
-
-    dst.size = img.pageSizeBytes; // In case the decompress failed, force it back
-
-    // Swap whatever we decompressed if we need to
-    if (is_Endianess_Dependent(img.dt, img.comp) && (img.nbo != NET_ORDER))
-        swab_buff(dst, img);
+    CPLErr ret = DecodePage(data, static_cast<size_t>(tinfo.size), dst, poDS->no_errors != 0);
 
-    CPLFree(data);
-
-    if (poDS->no_errors) {
-        CPLPopErrorHandler();
-        if (ret != CE_None) {
-            // Set each page buffer to the correct no data value, then proceed
-            if (1 == cstride)
-                return FillBlock(buffer);
-            else
-                return FillBlock(xblk, yblk, buffer);
-        }
+    if (poDS->no_errors && ret != CE_None) {
+        // Set each page buffer to the correct no data value, then proceed
+        if (1 == cstride)
+            return FillBlock(buffer);
+        else
+            return FillBlock(xblk, yblk, buffer);
     }
 
     // If pages are separate or we had errors, we're done
@@ -879,6 +956,11 @@ CPLErr GDALMRFRasterBand::IWriteBlock(int xblk, int yblk, void *buffer)
         // Use the pbuffer to hold the compressed page before writing it
         poDS->tile = ILSize(); // Mark it corrupt
 
+        // Or let a worker thread compress it
+        if (poDS->SubmitCompressionJob(this, buffer, infooffset,
+                is_Endianess_Dependent(img.dt, img.comp) && (img.nbo != NET_ORDER)))
+            return CE_None;
+
         buf_mgr src;
         src.buffer = (char *)buffer;
         src.size = static_cast<size_t>(img.pageSizeBytes);
@@ -992,6 +1074,12 @@ CPLErr GDALMRFRasterBand::IWriteBlock(int xblk, int yblk, void *buffer)
         "MRF: IWrite, band dirty mask is " CPL_FRMT_GIB " instead of " CPL_FRMT_GIB,
         poDS->bdirty, AllBandMask());
 
+    if (poDS->SubmitCompressionJob(this, tbuffer, infooffset, false)) {
+        CPLFree(tbuffer);
+        poDS->bdirty = 0;
+        return CE_None;
+    }
+
     buf_mgr src;
     src.buffer = (char *)tbuffer;
     src.size = static_cast<size_t>(img.pageSizeBytes);
@@ -1033,6 +1121,40 @@ CPLErr GDALMRFRasterBand::IWriteBlock(int xblk, int yblk, void *buffer)
     return ret;
 }
 
+/**
+*\brief Encode a page, for a compression job
+*
+* src holds the raw page, followed by pbsize bytes which receive the compressed page.
+* Sets outbuff and outsize to the encoded page, within the src buffer
+*/
+CPLErr GDALMRFRasterBand::EncodePage(buf_mgr &src, bool swab, void **outbuff, size_t *outsize)
+{
+    if (swab)
+        swab_buff(src, img);
+
+    char *cbuff = src.buffer + img.pageSizeBytes;
+    buf_mgr dst = {cbuff, poDS->pbsize};
+    CPLErr ret = Compress(dst, src);
+    if (ret != CE_None)
+        return ret;
+
+    void *usebuff = cbuff;
+    if (deflatep) {
+        // Move the packed part at the start of the buffer, to make more space available
+        memcpy(src.buffer, cbuff, dst.size);
+        dst.buffer = src.buffer;
+        usebuff = DeflateBlock(dst, img.pageSizeBytes + poDS->pbsize - dst.size, deflate_flags);
+        if (!usebuff) {
+            CPLError(CE_Failure,CPLE_AppDefined, "MRF: Deflate error");
+            return CE_Failure;
+        }
+    }
+
+    *outbuff = usebuff;
+    *outsize = dst.size;
+    return CE_None;
+}
+
 int GDALMRFRasterBand::GetOverviewCount()
 {
     // First try internal overviews
@@ -626,6 +626,8 @@ void GDALRegister_mrf()
         "   <Option name='INDEXNAME' type='string' description='Index file name'/>\n"
         "   <Option name='SPACING' type='int' "
                     "description='Leave this many unused bytes before each tile, default=0'/>\n"
+        "   <Option name='NUM_THREADS' type='string' "
+                    "description='Number of worker threads for compression. Integer or ALL_CPUS'/>\n"
         "   <Option name='PHOTOMETRIC' type='string-select' default='DEFAULT' "
                     "description='Band interpretation, may affect block encoding'>\n"
         "       <Value>MULTISPECTRAL</Value>"
@@ -638,6 +640,7 @@ void GDALRegister_mrf()
       GDAL_DMD_OPENOPTIONLIST,
       "<OpenOptionList>"
       "    <Option name='NOERRORS' type='boolean' description='Ignore decompression errors' default='FALSE'/>"
+      "    <Option name='NUM_THREADS' type='string' description='Number of worker threads for decompression. Integer or ALL_CPUS'/>"
       "</OpenOptionList>"
       );
 
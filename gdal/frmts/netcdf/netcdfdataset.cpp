@@ -156,7 +156,13 @@ class netCDFRasterBand : public GDALPamRasterBand
     template <class T> void CheckData ( void *pImage, void *pImageNC,
                                         size_t nTmpBlockXSize,
                                         size_t nTmpBlockYSize,
+                                        size_t nDstXSize,
                                         bool bCheckIsNan=false ) ;
+    CPLErr          ReadWindow( int nXOff, int nYOff,
+                                int nXSize, int nYSize,
+                                int nDstXSize, void *pImage );
+    void            CheckDataOfType( void *pImage,
+                                     size_t nXSize, size_t nYSize );
 
   protected:
     CPLXMLNode *SerializeToXML( const char *pszVRTPath ) override;
@@ -196,6 +202,10 @@ class netCDFRasterBand : public GDALPamRasterBand
     virtual CPLErr SetUnitType( const char * ) override;
     virtual CPLErr IReadBlock( int, int, void * ) override;
     virtual CPLErr IWriteBlock( int, int, void * ) override;
+    virtual CPLErr IRasterIO( GDALRWFlag, int, int, int, int,
+                              void *, int, int, GDALDataType,
+                              GSpacing nPixelSpace, GSpacing nLineSpace,
+                              GDALRasterIOExtraArg* psExtraArg ) override;
 };
 
 /************************************************************************/
@@ -521,6 +531,41 @@ netCDFRasterBand::netCDFRasterBand( netCDFDataset *poNCDFDS,
                      static_cast<long>(chunksize[nZDim - 2]));
             nBlockXSize = (int)chunksize[nZDim - 1];
             nBlockYSize = (int)chunksize[nZDim - 2];
+
+            // The default chunk cache of the library may be too small to
+            // hold a row of chunks, which is what reading a window not
+            // aligned on chunks, or a bottom-up dataset scanline per
+            // scanline, needs to avoid decoding the same chunks several
+            // times. Enlarge it, within a quarter of the GDAL block cache.
+            size_t nCacheSize = 0;
+            size_t nCacheElems = 0;
+            float fCachePreemption = 0.0f;
+            if( nc_get_var_chunk_cache(cdfid, nZId, &nCacheSize,
+                                       &nCacheElems,
+                                       &fCachePreemption) == NC_NOERR &&
+                chunksize[nZDim - 1] > 0 )
+            {
+                GUIntBig nChunkBytes = GDALGetDataTypeSizeBytes(eDataType);
+                for( int i = 0; i < nZDim; i++ )
+                    nChunkBytes *= chunksize[i];
+                const GUIntBig nChunksPerRow =
+                    (static_cast<GUIntBig>(nRasterXSize) +
+                     chunksize[nZDim - 1] - 1) / chunksize[nZDim - 1];
+                const GUIntBig nWantedCacheSize = std::min(
+                    nChunksPerRow * nChunkBytes,
+                    static_cast<GUIntBig>(GDALGetCacheMax64() / 4));
+                if( nWantedCacheSize > nCacheSize )
+                {
+                    CPLDebug("GDAL_netCDF",
+                             "setting chunk cache size to " CPL_FRMT_GUIB,
+                             nWantedCacheSize);
+                    nc_set_var_chunk_cache(
+                        cdfid, nZId, static_cast<size_t>(nWantedCacheSize),
+                        std::max(nCacheElems,
+                                 static_cast<size_t>(10 * nChunksPerRow + 1)),
+                        fCachePreemption);
+                }
+            }
         }
     }
 #endif
@@ -1416,20 +1461,20 @@ CPLErr netCDFRasterBand::CreateBandMetadata( const int *paDimIds,
 template <class T>
 void netCDFRasterBand::CheckData( void *pImage, void *pImageNC,
                                   size_t nTmpBlockXSize, size_t nTmpBlockYSize,
-                                  bool bCheckIsNan )
+                                  size_t nDstXSize, bool bCheckIsNan )
 {
     CPLAssert(pImage != nullptr && pImageNC != nullptr);
 
     // If this block is not a full block (in the x axis), we need to re-arrange
     // the data this is because partial blocks are not arranged the same way in
     // netcdf and gdal.
-    if( nTmpBlockXSize != static_cast<size_t>(nBlockXSize) )
+    if( nTmpBlockXSize != nDstXSize )
     {
         T *ptrWrite = (T *)pImage;
         T *ptrRead = (T *)pImageNC;
         for( size_t j = 0;
              j < nTmpBlockYSize;
-             j++, ptrWrite += nBlockXSize, ptrRead += nTmpBlockXSize)
+             j++, ptrWrite += nDstXSize, ptrRead += nTmpBlockXSize)
         {
             memmove(ptrWrite, ptrRead, nTmpBlockXSize * sizeof(T));
         }
@@ -1443,7 +1488,7 @@ void netCDFRasterBand::CheckData( void *pImage, void *pImageNC,
         for( size_t j = 0; j < nTmpBlockYSize; j++ )
         {
             // k moves along the gdal block, skipping the out-of-range pixels.
-            size_t k = j * nBlockXSize;
+            size_t k = j * nDstXSize;
             for( size_t i = 0; i < nTmpBlockXSize; i++, k++ )
             {
                 // Check for nodata and nan.
@@ -1477,7 +1522,7 @@ void netCDFRasterBand::CheckData( void *pImage, void *pImageNC,
     {
         for( size_t j = 0; j < nTmpBlockYSize; j++ )
         {
-            size_t k = j * nBlockXSize;
+            size_t k = j * nDstXSize;
             for( size_t i = 0; i < nTmpBlockXSize; i++, k++ )
             {
                 if( !CPLIsEqual((double)((T *)pImage)[k], dfNoDataValue) )
@@ -1491,6 +1536,41 @@ void netCDFRasterBand::CheckData( void *pImage, void *pImageNC,
     }
 }
 
+/************************************************************************/
+/*                          CheckDataOfType()                           */
+/*                                                                      */
+/*      Apply CheckData() to a nXSize x nYSize buffer of the band data  */
+/*      type.                                                           */
+/************************************************************************/
+
+void netCDFRasterBand::CheckDataOfType( void *pImage,
+                                        size_t nXSize, size_t nYSize )
+{
+    if( eDataType == GDT_Byte )
+    {
+        if( bSignedData )
+            CheckData<signed char>(pImage, pImage, nXSize, nYSize, nXSize,
+                                   false);
+        else
+            CheckData<unsigned char>(pImage, pImage, nXSize, nYSize, nXSize,
+                                     false);
+    }
+    else if( eDataType == GDT_Int16 )
+        CheckData<short>(pImage, pImage, nXSize, nYSize, nXSize, false);
+    else if( eDataType == GDT_UInt16 )
+        CheckData<unsigned short>(pImage, pImage, nXSize, nYSize, nXSize,
+                                  false);
+    else if( eDataType == GDT_Int32 )
+        CheckData<int>(pImage, pImage, nXSize, nYSize, nXSize, false);
+    else if( eDataType == GDT_UInt32 )
+        CheckData<unsigned int>(pImage, pImage, nXSize, nYSize, nXSize,
+                                false);
+    else if( eDataType == GDT_Float32 )
+        CheckData<float>(pImage, pImage, nXSize, nYSize, nXSize, true);
+    else if( eDataType == GDT_Float64 )
+        CheckData<double>(pImage, pImage, nXSize, nYSize, nXSize, true);
+}
+
 /************************************************************************/
 /*                             IReadBlock()                             */
 /************************************************************************/
@@ -1501,68 +1581,148 @@ CPLErr netCDFRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
 {
     CPLMutexHolderD(&hNCMutex);
 
-    int nd = 0;
-    nc_inq_varndims(cdfid, nZId, &nd);
-
 #ifdef NCDF_DEBUG
     if( (nBlockYOff == 0) || (nBlockYOff == nRasterYSize - 1) )
         CPLDebug("GDAL_netCDF",
-                 "netCDFRasterBand::IReadBlock( %d, %d, ...) nBand=%d nd=%d",
-                 nBlockXOff, nBlockYOff, nBand, nd);
+                 "netCDFRasterBand::IReadBlock( %d, %d, ...) nBand=%d",
+                 nBlockXOff, nBlockYOff, nBand);
+#endif
+
+    // Check block size - return error if not 1.
+    // reading upside-down rasters with nBlockYSize!=1 needs further
+    // development.  perhaps a simple solution is to invert geotransform and
+    // not use bottom-up.
+    if( static_cast<netCDFDataset *>(poDS)->bBottomUp && nBlockYSize != 1 )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "nBlockYSize = %d, only 1 supported when "
+                 "reading bottom-up dataset",
+                 nBlockYSize);
+        return CE_Failure;
+    }
+
+    const int nXOff = nBlockXOff * nBlockXSize;
+    const int nYOff = nBlockYOff * nBlockYSize;
+    return ReadWindow(nXOff, nYOff,
+                      std::min(nBlockXSize, nRasterXSize - nXOff),
+                      std::min(nBlockYSize, nRasterYSize - nYOff),
+                      nBlockXSize, pImage);
+}
+
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr netCDFRasterBand::IRasterIO( GDALRWFlag eRWFlag,
+                                    int nXOff, int nYOff,
+                                    int nXSize, int nYSize,
+                                    void *pData,
+                                    int nBufXSize, int nBufYSize,
+                                    GDALDataType eBufType,
+                                    GSpacing nPixelSpace,
+                                    GSpacing nLineSpace,
+                                    GDALRasterIOExtraArg* psExtraArg )
+{
+    const bool bSupportedType =
+        eDataType == GDT_Byte || eDataType == GDT_Int16 ||
+        eDataType == GDT_Int32 || eDataType == GDT_Float32 ||
+#ifdef NETCDF_HAS_NC4
+        eDataType == GDT_UInt16 || eDataType == GDT_UInt32 ||
 #endif
+        eDataType == GDT_Float64;
+
+    // Requests spanning several blocks, without resampling, are read with a
+    // single nc_get_vara_XXX() call, so that the library reads each chunk
+    // (or each record) only once, the global netCDF lock is taken once for
+    // the whole request, and the block cache is not polluted.
+    if( eRWFlag == GF_Read && poDS->GetAccess() == GA_ReadOnly &&
+        bSupportedType &&
+        nXSize == nBufXSize && nYSize == nBufYSize &&
+        (nXSize > nBlockXSize || nYSize > nBlockYSize) )
+    {
+        const int nDTSize = GDALGetDataTypeSizeBytes(eDataType);
+        const bool bDirect = eBufType == eDataType &&
+                             nPixelSpace == nDTSize &&
+                             nLineSpace == nPixelSpace * nBufXSize;
+        GByte *pabyTemp = bDirect ? static_cast<GByte *>(pData) :
+            static_cast<GByte *>(VSIMalloc3(nXSize, nYSize, nDTSize));
+        if( pabyTemp != nullptr )
+        {
+            CPLErr eErr = CE_None;
+            {
+                CPLMutexHolderD(&hNCMutex);
+                eErr = ReadWindow(nXOff, nYOff, nXSize, nYSize, nXSize,
+                                  pabyTemp);
+            }
+            if( !bDirect )
+            {
+                for( int iY = 0; eErr == CE_None && iY < nYSize; iY++ )
+                {
+                    GDALCopyWords(pabyTemp +
+                                    static_cast<size_t>(iY) * nXSize * nDTSize,
+                                  eDataType, nDTSize,
+                                  static_cast<GByte *>(pData) +
+                                    iY * nLineSpace,
+                                  eBufType, static_cast<int>(nPixelSpace),
+                                  nXSize);
+                }
+                VSIFree(pabyTemp);
+            }
+            if( eErr == CE_None && psExtraArg->pfnProgress != nullptr )
+                psExtraArg->pfnProgress(1.0, "", psExtraArg->pProgressData);
+            return eErr;
+        }
+    }
+
+    return GDALPamRasterBand::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                        pData, nBufXSize, nBufYSize, eBufType,
+                                        nPixelSpace, nLineSpace, psExtraArg);
+}
+
+/************************************************************************/
+/*                             ReadWindow()                             */
+/*                                                                      */
+/*      Read the nXSize x nYSize window at (nXOff, nYOff), in GDAL      */
+/*      (top-down) orientation, into a buffer whose lines are           */
+/*      nDstXSize pixels wide. Must be called with hNCMutex held.       */
+/************************************************************************/
+
+CPLErr netCDFRasterBand::ReadWindow( int nXOff, int nYOff,
+                                     int nXSize, int nYSize,
+                                     int nDstXSize, void *pImage )
+
+{
+    int nd = 0;
+    nc_inq_varndims(cdfid, nZId, &nd);
 
     // Locate X, Y and Z position in the array.
 
     size_t start[MAX_NC_DIMS] = {};
-    start[nBandXPos] = nBlockXOff * nBlockXSize;
+    start[nBandXPos] = nXOff;
 
-    // Check y order.
-    if( static_cast<netCDFDataset *>(poDS)->bBottomUp )
+    // Check y order. Lines of bottom-up datasets are read in their file
+    // order and flipped afterwards.
+    const bool bBottomUp = static_cast<netCDFDataset *>(poDS)->bBottomUp;
+    if( bBottomUp )
     {
-#ifdef NCDF_DEBUG
-        if( (nBlockYOff == 0) || (nBlockYOff == nRasterYSize - 1) )
-            CPLDebug(
-                "GDAL_netCDF",
-                "reading bottom-up dataset, nBlockYSize=%d nRasterYSize=%d",
-                nBlockYSize, nRasterYSize);
-#endif
-        // Check block size - return error if not 1.
-        // reading upside-down rasters with nBlockYSize!=1 needs further
-        // development.  perhaps a simple solution is to invert geotransform and
-        // not use bottom-up.
-        if( nBlockYSize == 1 )
-        {
-            start[nBandYPos] = nRasterYSize - 1 - nBlockYOff;
-        }
-        else
-        {
-            CPLError(CE_Failure, CPLE_AppDefined,
-                     "nBlockYSize = %d, only 1 supported when "
-                     "reading bottom-up dataset",
-                     nBlockYSize);
-            return CE_Failure;
-        }
+        start[nBandYPos] = nRasterYSize - nYOff - nYSize;
     }
     else
     {
-        start[nBandYPos] = nBlockYOff * nBlockYSize;
+        start[nBandYPos] = nYOff;
     }
 
     size_t edge[MAX_NC_DIMS] = {};
 
-    edge[nBandXPos] = nBlockXSize;
-    if( (start[nBandXPos] + edge[nBandXPos]) > (size_t)nRasterXSize )
-        edge[nBandXPos] = nRasterXSize - start[nBandXPos];
-    edge[nBandYPos] = nBlockYSize;
-    if( (start[nBandYPos] + edge[nBandYPos]) > (size_t)nRasterYSize )
-        edge[nBandYPos] = nRasterYSize - start[nBandYPos];
+    edge[nBandXPos] = nXSize;
+    edge[nBandYPos] = nYSize;
 
 #ifdef NCDF_DEBUG
-    if( nBlockYOff == 0 || (nBlockYOff == nRasterYSize - 1) )
+    if( nYOff == 0 || (nYOff == nRasterYSize - 1) )
         CPLDebug("GDAL_netCDF", "start={%ld,%ld} edge={%ld,%ld} bBottomUp=%d",
                   start[nBandXPos], start[nBandYPos],
                   edge[nBandXPos], edge[nBandYPos],
-                  ((netCDFDataset *)poDS)->bBottomUp);
+                  bBottomUp);
 #endif
 
     if( nd == 3 )
@@ -1607,16 +1767,16 @@ CPLErr netCDFRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
     // Make sure we are in data mode.
     static_cast<netCDFDataset *>(poDS)->SetDefineMode(false);
 
-    // If this block is not a full block in the x axis, we need to
+    // If the window is narrower than the buffer, we need to
     // re-arrange the data because partial blocks are not arranged the
     // same way in netcdf and gdal, so we first we read the netcdf data at
-    // the end of the gdal block buffer then re-arrange rows in CheckData().
+    // the end of the gdal buffer then re-arrange rows in CheckData().
+    const int nDTSize = GDALGetDataTypeSizeBytes(eDataType);
     void *pImageNC = pImage;
-    if( edge[nBandXPos] != static_cast<size_t>(nBlockXSize) )
+    if( nXSize != nDstXSize )
     {
         pImageNC = static_cast<GByte *>(pImage)
-            + ((nBlockXSize * nBlockYSize - edge[nBandXPos] * edge[nBandYPos])
-                * (GDALGetDataTypeSize(eDataType) / 8));
+            + static_cast<size_t>(nDstXSize - nXSize) * nYSize * nDTSize;
     }
 
     // Read data according to type.
@@ -1629,7 +1789,7 @@ CPLErr netCDFRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
                                        static_cast<signed char *>(pImageNC));
             if( status == NC_NOERR )
                 CheckData<signed char>(pImage, pImageNC, edge[nBandXPos],
-                                       edge[nBandYPos], false);
+                                       edge[nBandYPos], nDstXSize, false);
         }
         else
         {
@@ -1637,7 +1797,7 @@ CPLErr netCDFRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
                                        static_cast<unsigned char *>(pImageNC));
             if( status == NC_NOERR )
                 CheckData<unsigned char>(pImage, pImageNC, edge[nBandXPos],
-                                         edge[nBandYPos], false);
+                                         edge[nBandYPos], nDstXSize, false);
         }
     }
     else if( eDataType == GDT_Int16 )
@@ -1646,7 +1806,7 @@ CPLErr netCDFRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
                                    static_cast<short *>(pImageNC));
         if( status == NC_NOERR )
             CheckData<short>(pImage, pImageNC, edge[nBandXPos], edge[nBandYPos],
-                             false);
+                             nDstXSize, false);
     }
     else if( eDataType == GDT_Int32 )
     {
@@ -1655,13 +1815,13 @@ CPLErr netCDFRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
                                       static_cast<long *>(pImageNC));
             if( status == NC_NOERR )
                 CheckData<long>(pImage, pImageNC, edge[nBandXPos],
-                                edge[nBandYPos], false);
+                                edge[nBandYPos], nDstXSize, false);
 #else
             status = nc_get_vara_int(cdfid, nZId, start, edge,
                                      static_cast<int *>(pImageNC));
             if( status == NC_NOERR )
                 CheckData<int>(pImage, pImageNC, edge[nBandXPos],
-                               edge[nBandYPos], false);
+                               edge[nBandYPos], nDstXSize, false);
 #endif
     }
     else if( eDataType == GDT_Float32 )
@@ -1670,7 +1830,7 @@ CPLErr netCDFRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
                                    static_cast<float *>(pImageNC));
         if( status == NC_NOERR )
             CheckData<float>(pImage, pImageNC, edge[nBandXPos], edge[nBandYPos],
-                             true);
+                             nDstXSize, true);
     }
     else if( eDataType == GDT_Float64 )
     {
@@ -1678,7 +1838,7 @@ CPLErr netCDFRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
                                     static_cast<double *>(pImageNC));
         if( status == NC_NOERR )
             CheckData<double>(pImage, pImageNC, edge[nBandXPos],
-                              edge[nBandYPos], true);
+                              edge[nBandYPos], nDstXSize, true);
     }
 #ifdef NETCDF_HAS_NC4
     else if( eDataType == GDT_UInt16 )
@@ -1687,7 +1847,7 @@ CPLErr netCDFRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
                                     static_cast<unsigned short *>(pImageNC));
         if( status == NC_NOERR )
             CheckData<unsigned short>(pImage, pImageNC, edge[nBandXPos],
-                                      edge[nBandYPos], false);
+                                      edge[nBandYPos], nDstXSize, false);
     }
     else if( eDataType == GDT_UInt32 )
     {
@@ -1695,7 +1855,7 @@ CPLErr netCDFRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
                                   static_cast<unsigned int *>(pImageNC));
         if( status == NC_NOERR )
             CheckData<unsigned int>(pImage, pImageNC, edge[nBandXPos],
-                                    edge[nBandYPos], false);
+                                    edge[nBandYPos], nDstXSize, false);
     }
 #endif
     else
@@ -1709,6 +1869,21 @@ CPLErr netCDFRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
         return CE_Failure;
     }
 
+    if( bBottomUp && nYSize > 1 )
+    {
+        const size_t nLineSize = static_cast<size_t>(nDstXSize) * nDTSize;
+        std::vector<GByte> abyLine(nLineSize);
+        GByte *pabyImage = static_cast<GByte *>(pImage);
+        for( int iY = 0; iY < nYSize / 2; iY++ )
+        {
+            GByte *pabyTop = pabyImage + iY * nLineSize;
+            GByte *pabyBottom = pabyImage + (nYSize - 1 - iY) * nLineSize;
+            memcpy(&abyLine[0], pabyTop, nLineSize);
+            memcpy(pabyTop, pabyBottom, nLineSize);
+            memcpy(pabyBottom, &abyLine[0], nLineSize);
+        }
+    }
+
     return CE_None;
 }
 
@@ -5091,6 +5266,210 @@ int netCDFDataset::TestCapability(const char *pszCap)
     return FALSE;
 }
 
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr netCDFDataset::IRasterIO( GDALRWFlag eRWFlag,
+                                 int nXOff, int nYOff, int nXSize, int nYSize,
+                                 void *pData, int nBufXSize, int nBufYSize,
+                                 GDALDataType eBufType,
+                                 int nBandCount, int *panBandMap,
+                                 GSpacing nPixelSpace, GSpacing nLineSpace,
+                                 GSpacing nBandSpace,
+                                 GDALRasterIOExtraArg* psExtraArg )
+{
+    if( eRWFlag == GF_Read && eAccess == GA_ReadOnly && nBandCount > 1 &&
+        nXSize == nBufXSize && nYSize == nBufYSize )
+    {
+        CPLErr eErr = CE_None;
+        if( ReadBandsAsHyperslab(nXOff, nYOff, nXSize, nYSize,
+                                 pData, eBufType, nBandCount, panBandMap,
+                                 nPixelSpace, nLineSpace, nBandSpace,
+                                 &eErr) )
+        {
+            if( eErr == CE_None && psExtraArg->pfnProgress != nullptr )
+                psExtraArg->pfnProgress(1.0, "", psExtraArg->pProgressData);
+            return eErr;
+        }
+    }
+
+    return GDALPamDataset::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                     pData, nBufXSize, nBufYSize, eBufType,
+                                     nBandCount, panBandMap,
+                                     nPixelSpace, nLineSpace, nBandSpace,
+                                     psExtraArg);
+}
+
+/************************************************************************/
+/*                        ReadBandsAsHyperslab()                        */
+/*                                                                      */
+/*      Serve a read request on several bands of the same 3D variable,  */
+/*      whose levels are regularly spaced (typically consecutive time   */
+/*      steps), with a single strided nc_get_vars_XXX() call instead    */
+/*      of one call per band and block. Returns false if the request    */
+/*      does not qualify, in which case nothing has been done.          */
+/************************************************************************/
+
+bool netCDFDataset::ReadBandsAsHyperslab( int nXOff, int nYOff,
+                                          int nXSize, int nYSize,
+                                          void *pData, GDALDataType eBufType,
+                                          int nBandCount, int *panBandMap,
+                                          GSpacing nPixelSpace,
+                                          GSpacing nLineSpace,
+                                          GSpacing nBandSpace,
+                                          CPLErr *peErr )
+{
+    netCDFRasterBand *poFirstBand =
+        static_cast<netCDFRasterBand *>(GetRasterBand(panBandMap[0]));
+    if( poFirstBand->nZDim != 3 || poFirstBand->panBandZPos == nullptr )
+        return false;
+
+    int nLevelStep = 0;
+    for( int i = 1; i < nBandCount; i++ )
+    {
+        netCDFRasterBand *poBand =
+            static_cast<netCDFRasterBand *>(GetRasterBand(panBandMap[i]));
+        netCDFRasterBand *poPrevBand =
+            static_cast<netCDFRasterBand *>(GetRasterBand(panBandMap[i - 1]));
+        if( poBand->nZId != poFirstBand->nZId || poBand->nZDim != 3 )
+            return false;
+        const int nStep = poBand->nLevel - poPrevBand->nLevel;
+        if( nStep <= 0 || (i > 1 && nStep != nLevelStep) )
+            return false;
+        nLevelStep = nStep;
+    }
+
+    const GDALDataType eDataType = poFirstBand->GetRasterDataType();
+    if( eDataType != GDT_Byte && eDataType != GDT_Int16 &&
+        eDataType != GDT_Int32 && eDataType != GDT_Float32 &&
+#ifdef NETCDF_HAS_NC4
+        eDataType != GDT_UInt16 && eDataType != GDT_UInt32 &&
+#endif
+        eDataType != GDT_Float64 )
+    {
+        return false;
+    }
+    const int nDTSize = GDALGetDataTypeSizeBytes(eDataType);
+
+    // The hyperslab follows the dimension order of the variable.
+    const int nXPos = poFirstBand->nBandXPos;
+    const int nYPos = poFirstBand->nBandYPos;
+    const int nZPos = poFirstBand->panBandZPos[0];
+    size_t start[MAX_NC_DIMS] = {};
+    size_t edge[MAX_NC_DIMS] = {};
+    ptrdiff_t stride[MAX_NC_DIMS] = { 1, 1, 1 };
+    start[nXPos] = nXOff;
+    edge[nXPos] = nXSize;
+    start[nYPos] = bBottomUp ? nRasterYSize - nYOff - nYSize : nYOff;
+    edge[nYPos] = nYSize;
+    start[nZPos] = poFirstBand->nLevel;
+    edge[nZPos] = nBandCount;
+    stride[nZPos] = nLevelStep;
+
+    // Strides, in elements, of the three dimensions in the hyperslab.
+    size_t anDimStride[3] = { edge[1] * edge[2], edge[2], 1 };
+    if( anDimStride[nXPos] * nDTSize > static_cast<size_t>(INT_MAX) )
+        return false;
+
+    const size_t nPixels = static_cast<size_t>(nXSize) * nYSize;
+    GByte *pabyHyperslab = static_cast<GByte *>(
+        VSIMalloc3(nPixels, nBandCount, nDTSize));
+    GByte *pabyBand = static_cast<GByte *>(VSIMalloc2(nPixels, nDTSize));
+    if( pabyHyperslab == nullptr || pabyBand == nullptr )
+    {
+        VSIFree(pabyHyperslab);
+        VSIFree(pabyBand);
+        return false;
+    }
+
+    int status = NC_NOERR;
+    {
+        CPLMutexHolderD(&hNCMutex);
+
+        // Make sure we are in data mode.
+        SetDefineMode(false);
+
+        if( eDataType == GDT_Byte && poFirstBand->bSignedData )
+            status = nc_get_vars_schar(cdfid, poFirstBand->nZId,
+                                       start, edge, stride,
+                            reinterpret_cast<signed char *>(pabyHyperslab));
+        else if( eDataType == GDT_Byte )
+            status = nc_get_vars_uchar(cdfid, poFirstBand->nZId,
+                                       start, edge, stride,
+                            reinterpret_cast<unsigned char *>(pabyHyperslab));
+        else if( eDataType == GDT_Int16 )
+            status = nc_get_vars_short(cdfid, poFirstBand->nZId,
+                                       start, edge, stride,
+                            reinterpret_cast<short *>(pabyHyperslab));
+        else if( eDataType == GDT_Int32 )
+            status = nc_get_vars_int(cdfid, poFirstBand->nZId,
+                                     start, edge, stride,
+                            reinterpret_cast<int *>(pabyHyperslab));
+        else if( eDataType == GDT_Float32 )
+            status = nc_get_vars_float(cdfid, poFirstBand->nZId,
+                                       start, edge, stride,
+                            reinterpret_cast<float *>(pabyHyperslab));
+        else if( eDataType == GDT_Float64 )
+            status = nc_get_vars_double(cdfid, poFirstBand->nZId,
+                                        start, edge, stride,
+                            reinterpret_cast<double *>(pabyHyperslab));
+#ifdef NETCDF_HAS_NC4
+        else if( eDataType == GDT_UInt16 )
+            status = nc_get_vars_ushort(cdfid, poFirstBand->nZId,
+                                        start, edge, stride,
+                            reinterpret_cast<unsigned short *>(pabyHyperslab));
+        else if( eDataType == GDT_UInt32 )
+            status = nc_get_vars_uint(cdfid, poFirstBand->nZId,
+                                      start, edge, stride,
+                            reinterpret_cast<unsigned int *>(pabyHyperslab));
+#endif
+    }
+
+    *peErr = CE_None;
+    if( status != NC_NOERR )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "netCDF hyperslab fetch failed: #%d (%s)", status,
+                 nc_strerror(status));
+        *peErr = CE_Failure;
+    }
+
+    for( int iBand = 0; *peErr == CE_None && iBand < nBandCount; iBand++ )
+    {
+        netCDFRasterBand *poBand =
+            static_cast<netCDFRasterBand *>(GetRasterBand(panBandMap[iBand]));
+
+        // Extract the band, in GDAL (top-down) order, so that nodata and
+        // valid range are applied as in IReadBlock().
+        for( int iY = 0; iY < nYSize; iY++ )
+        {
+            const int iSrcY = bBottomUp ? nYSize - 1 - iY : iY;
+            GDALCopyWords(pabyHyperslab +
+                            (iBand * anDimStride[nZPos] +
+                             iSrcY * anDimStride[nYPos]) * nDTSize,
+                          eDataType,
+                          static_cast<int>(anDimStride[nXPos] * nDTSize),
+                          pabyBand + static_cast<size_t>(iY) * nXSize * nDTSize,
+                          eDataType, nDTSize, nXSize);
+        }
+        poBand->CheckDataOfType(pabyBand, nXSize, nYSize);
+
+        for( int iY = 0; iY < nYSize; iY++ )
+        {
+            GDALCopyWords(pabyBand + static_cast<size_t>(iY) * nXSize * nDTSize,
+                          eDataType, nDTSize,
+                          static_cast<GByte *>(pData) +
+                            iBand * nBandSpace + iY * nLineSpace,
+                          eBufType, static_cast<int>(nPixelSpace), nXSize);
+        }
+    }
+
+    VSIFree(pabyHyperslab);
+    VSIFree(pabyBand);
+    return true;
+}
+
 /************************************************************************/
 /*                            GetLayer()                                */
 /************************************************************************/
@@ -830,6 +830,15 @@ class netCDFDataset : public GDALPamDataset
 
     CPLErr      ReadAttributes( int, int );
 
+    bool        ReadBandsAsHyperslab( int nXOff, int nYOff,
+                                      int nXSize, int nYSize,
+                                      void *pData, GDALDataType eBufType,
+                                      int nBandCount, int *panBandMap,
+                                      GSpacing nPixelSpace,
+                                      GSpacing nLineSpace,
+                                      GSpacing nBandSpace,
+                                      CPLErr *peErr );
+
     void  CreateSubDatasetList( );
 
     void  SetProjectionFromVar( int, bool bReadSRSOnly );
@@ -869,6 +878,12 @@ class netCDFDataset : public GDALPamDataset
 
     virtual int  TestCapability(const char* pszCap) override;
 
+    virtual CPLErr IRasterIO( GDALRWFlag, int, int, int, int,
+                              void *, int, int, GDALDataType,
+                              int, int *,
+                              GSpacing, GSpacing, GSpacing,
+                              GDALRasterIOExtraArg* psExtraArg ) override;
+
     virtual int  GetLayerCount() override { return nLayers; }
     virtual OGRLayer* GetLayer(int nIdx) override;
 
@@ -31,10 +31,12 @@
 
 #include "cpl_minixml.h"
 #include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal_frmts.h"
 #include "ogr_spatialref.h"
 
 #include <algorithm>
+#include <map>
 #include <typeinfo>
 
 /*! @cond Doxygen_Suppress */
@@ -56,7 +58,9 @@ VRTDataset::VRTDataset( int nXSize, int nYSize ) :
     m_pszVRTPath(nullptr),
     m_poMaskBand(nullptr),
     m_bCompatibleForDatasetIO(-1),
-    m_papszXMLVRTMetadata(nullptr)
+    m_papszXMLVRTMetadata(nullptr),
+    m_nNumThreads(-1),
+    m_poThreadPool(nullptr)
 {
     nRasterXSize = nXSize;
     nRasterYSize = nYSize;
@@ -116,6 +120,7 @@ VRTDataset::~VRTDataset()
     for(size_t i=0;i<m_apoOverviewsBak.size();i++)
         delete m_apoOverviewsBak[i];
     CSLDestroy( m_papszXMLVRTMetadata );
+    delete m_poThreadPool;
 }
 
 /************************************************************************/
@@ -676,6 +681,359 @@ int VRTDataset::Identify( GDALOpenInfo * poOpenInfo )
     return FALSE;
 }
 
+/************************************************************************/
+/*                       VRTSourcesCacheWrite*()                        */
+/*                                                                      */
+/*      Encoding helpers of the binary sources cache. Values are        */
+/*      stored in little endian order.                                  */
+/************************************************************************/
+
+void VRTSourcesCacheWriteInt( CPLString& osBuffer, int nVal )
+{
+    GInt32 nVal32 = nVal;
+    CPL_LSBPTR32(&nVal32);
+    osBuffer.append( reinterpret_cast<const char*>(&nVal32), sizeof(nVal32) );
+}
+
+void VRTSourcesCacheWriteDouble( CPLString& osBuffer, double dfVal )
+{
+    CPL_LSBPTR64(&dfVal);
+    osBuffer.append( reinterpret_cast<const char*>(&dfVal), sizeof(dfVal) );
+}
+
+void VRTSourcesCacheWriteString( CPLString& osBuffer, const CPLString& osStr )
+{
+    VRTSourcesCacheWriteInt( osBuffer, static_cast<int>(osStr.size()) );
+    osBuffer.append( osStr );
+}
+
+/************************************************************************/
+/*                        VRTSourcesCacheRead*()                        */
+/************************************************************************/
+
+bool VRTSourcesCacheReadInt( const GByte** ppabyData, const GByte* pabyEnd,
+                             int* pnVal )
+{
+    GInt32 nVal32 = 0;
+    if( pabyEnd - *ppabyData < static_cast<int>(sizeof(nVal32)) )
+        return false;
+    memcpy( &nVal32, *ppabyData, sizeof(nVal32) );
+    CPL_LSBPTR32(&nVal32);
+    *pnVal = nVal32;
+    *ppabyData += sizeof(nVal32);
+    return true;
+}
+
+bool VRTSourcesCacheReadDouble( const GByte** ppabyData, const GByte* pabyEnd,
+                                double* pdfVal )
+{
+    if( pabyEnd - *ppabyData < static_cast<int>(sizeof(double)) )
+        return false;
+    memcpy( pdfVal, *ppabyData, sizeof(double) );
+    CPL_LSBPTR64(pdfVal);
+    *ppabyData += sizeof(double);
+    return true;
+}
+
+bool VRTSourcesCacheReadString( const GByte** ppabyData, const GByte* pabyEnd,
+                                CPLString& osStr )
+{
+    int nLen = 0;
+    if( !VRTSourcesCacheReadInt( ppabyData, pabyEnd, &nLen ) ||
+        nLen < 0 || pabyEnd - *ppabyData < nLen )
+    {
+        return false;
+    }
+    osStr.assign( reinterpret_cast<const char*>(*ppabyData), nLen );
+    *ppabyData += nLen;
+    return true;
+}
+
+/************************************************************************/
+/*                         Sources cache layout                         */
+/*                                                                      */
+/*      The sources cache is a sidecar file (.srccache) that stores     */
+/*      the content of a VRT file in a form faster to load than XML:    */
+/*        - signature and version                                       */
+/*        - size and modification time of the VRT file, VRT path and    */
+/*          (when relative filenames are involved) current directory,   */
+/*          used to detect stale caches                                 */
+/*        - XML serialization of the dataset without its sources        */
+/*        - number of bands, and for each band, its number of sources   */
+/*          followed by the sources (see                                */
+/*          VRTSimpleSource::WriteInSourcesCache())                     */
+/************************************************************************/
+
+static const char* const pszSOURCES_CACHE_SIGNATURE = "GDAL_VRT_SRC_CACHE";
+constexpr int knSOURCES_CACHE_VERSION = 1;
+constexpr int knMIN_SOURCES_FOR_CACHE = 1000;
+
+constexpr int knSOURCES_CACHE_SIMPLE_SOURCE = 0;
+constexpr int knSOURCES_CACHE_COMPLEX_SOURCE = 1;
+
+/************************************************************************/
+/*                         OpenSourcesCache()                           */
+/*                                                                      */
+/*      Returns nullptr if the cache does not exist, is stale or        */
+/*      corrupted, in which case the VRT must be opened from its XML    */
+/*      content.                                                        */
+/************************************************************************/
+
+VRTDataset *VRTDataset::OpenSourcesCache( const char* pszCacheFilename,
+                                          const VSIStatBufL& sStat,
+                                          const char* pszVRTPath,
+                                          GDALAccess eAccess )
+{
+    GByte* pabyCache = nullptr;
+    vsi_l_offset nCacheSize = 0;
+    VSIStatBufL sCacheStat;
+    if( VSIStatL( pszCacheFilename, &sCacheStat ) != 0 )
+        return nullptr;
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    const bool bIngested = CPL_TO_BOOL(
+        VSIIngestFile( nullptr, pszCacheFilename,
+                       &pabyCache, &nCacheSize, -1 ) );
+    CPLPopErrorHandler();
+    if( !bIngested )
+    {
+        CPLErrorReset();
+        return nullptr;
+    }
+
+    const GByte* pabyData = pabyCache;
+    const GByte* const pabyEnd = pabyCache + nCacheSize;
+    CPLString osSignature;
+    int nVersion = 0;
+    double dfSize = 0.0;
+    double dfMTime = 0.0;
+    CPLString osVRTPath;
+    CPLString osCurDir;
+    CPLString osXML;
+    if( !VRTSourcesCacheReadString( &pabyData, pabyEnd, osSignature ) ||
+        osSignature != pszSOURCES_CACHE_SIGNATURE ||
+        !VRTSourcesCacheReadInt( &pabyData, pabyEnd, &nVersion ) ||
+        nVersion != knSOURCES_CACHE_VERSION ||
+        !VRTSourcesCacheReadDouble( &pabyData, pabyEnd, &dfSize ) ||
+        dfSize != static_cast<double>(sStat.st_size) ||
+        !VRTSourcesCacheReadDouble( &pabyData, pabyEnd, &dfMTime ) ||
+        dfMTime != static_cast<double>(sStat.st_mtime) ||
+        !VRTSourcesCacheReadString( &pabyData, pabyEnd, osVRTPath ) ||
+        osVRTPath != (pszVRTPath ? pszVRTPath : "") ||
+        !VRTSourcesCacheReadString( &pabyData, pabyEnd, osCurDir ) ||
+        !VRTSourcesCacheReadString( &pabyData, pabyEnd, osXML ) )
+    {
+        CPLDebug( "VRT", "%s is stale or corrupted", pszCacheFilename );
+        VSIFree( pabyCache );
+        return nullptr;
+    }
+
+    if( !osCurDir.empty() )
+    {
+        char* pszCurDir = CPLGetCurrentDir();
+        const bool bSameCurDir =
+            pszCurDir != nullptr && osCurDir == pszCurDir;
+        CPLFree( pszCurDir );
+        if( !bSameCurDir )
+        {
+            CPLDebug( "VRT", "%s was written from another current directory",
+                      pszCacheFilename );
+            VSIFree( pabyCache );
+            return nullptr;
+        }
+    }
+
+    VRTDataset* poDS = dynamic_cast<VRTDataset*>(
+        OpenXML( osXML, pszVRTPath, eAccess ) );
+    int nBandCount = 0;
+    bool bOK = poDS != nullptr &&
+        VRTSourcesCacheReadInt( &pabyData, pabyEnd, &nBandCount ) &&
+        nBandCount == poDS->GetRasterCount();
+    for( int iBand = 0; bOK && iBand < nBandCount; iBand++ )
+    {
+        VRTSourcedRasterBand* poBand = dynamic_cast<VRTSourcedRasterBand*>(
+            poDS->GetRasterBand(iBand + 1) );
+        int nSourceCount = 0;
+        bOK = poBand != nullptr && poBand->nSources == 0 &&
+              VRTSourcesCacheReadInt( &pabyData, pabyEnd, &nSourceCount ) &&
+              nSourceCount >= 0;
+        for( int iSource = 0; bOK && iSource < nSourceCount; iSource++ )
+        {
+            int nType = 0;
+            if( !VRTSourcesCacheReadInt( &pabyData, pabyEnd, &nType ) ||
+                (nType != knSOURCES_CACHE_SIMPLE_SOURCE &&
+                 nType != knSOURCES_CACHE_COMPLEX_SOURCE) )
+            {
+                bOK = false;
+                break;
+            }
+            VRTSimpleSource* poSource =
+                nType == knSOURCES_CACHE_SIMPLE_SOURCE ?
+                    new VRTSimpleSource() : new VRTComplexSource();
+            if( !poSource->ReadFromSourcesCache( &pabyData, pabyEnd, poDS ) )
+            {
+                delete poSource;
+                bOK = false;
+                break;
+            }
+            poBand->AddSource( poSource );
+        }
+    }
+    VSIFree( pabyCache );
+
+    if( !bOK || pabyData != pabyEnd )
+    {
+        CPLDebug( "VRT", "%s is corrupted", pszCacheFilename );
+        delete poDS;
+        return nullptr;
+    }
+
+    CPLDebug( "VRT", "Sources loaded from %s", pszCacheFilename );
+    return poDS;
+}
+
+/************************************************************************/
+/*                         WriteSourcesCache()                          */
+/************************************************************************/
+
+void VRTDataset::WriteSourcesCache( const char* pszCacheFilename,
+                                    const VSIStatBufL& sStat,
+                                    const char* pszVRTPath )
+{
+/* -------------------------------------------------------------------- */
+/*      Only plain mosaics with enough sources are worth it. The        */
+/*      other dataset and band classes may hold state that their        */
+/*      XML serialization does not capture. Mask bands are kept in      */
+/*      the XML part.                                                   */
+/* -------------------------------------------------------------------- */
+    if( typeid(*this) != typeid(VRTDataset) ||
+        CPLGetConfigOption("VRT_SHARED_SOURCE", nullptr) != nullptr )
+    {
+        return;
+    }
+
+    bool bDependsOnCurDir =
+        pszVRTPath == nullptr || CPLIsFilenameRelative(pszVRTPath);
+    int nTotalSources = 0;
+    for( int iBand = 0; iBand < nBands; iBand++ )
+    {
+        VRTSourcedRasterBand* poBand =
+            dynamic_cast<VRTSourcedRasterBand*>( papoBands[iBand] );
+        if( poBand == nullptr ||
+            typeid(*poBand) != typeid(VRTSourcedRasterBand) )
+        {
+            return;
+        }
+        for( int iSource = 0; iSource < poBand->nSources; iSource++ )
+        {
+            if( !poBand->papoSources[iSource]->IsSimpleSource() )
+                return;
+            VRTSimpleSource* poSource = reinterpret_cast<VRTSimpleSource*>(
+                poBand->papoSources[iSource] );
+            if( !poSource->CanBeWrittenInSourcesCache() )
+                return;
+            if( CPLIsFilenameRelative(poSource->GetSourceDatasetName()) )
+                bDependsOnCurDir = true;
+        }
+        nTotalSources += poBand->nSources;
+    }
+    if( nTotalSources < knMIN_SOURCES_FOR_CACHE )
+        return;
+
+/* -------------------------------------------------------------------- */
+/*      Serialize the dataset without its sources.                      */
+/* -------------------------------------------------------------------- */
+    std::vector<int> anSourceCount;
+    for( int iBand = 0; iBand < nBands; iBand++ )
+    {
+        VRTSourcedRasterBand* poBand =
+            reinterpret_cast<VRTSourcedRasterBand*>( papoBands[iBand] );
+        anSourceCount.push_back( poBand->nSources );
+        poBand->nSources = 0;
+    }
+    CPLXMLNode* psTree = SerializeToXML( pszVRTPath );
+    for( int iBand = 0; iBand < nBands; iBand++ )
+    {
+        reinterpret_cast<VRTSourcedRasterBand*>( papoBands[iBand] )->
+            nSources = anSourceCount[iBand];
+    }
+    if( psTree == nullptr )
+        return;
+    char* pszXML = CPLSerializeXMLTree( psTree );
+    CPLDestroyXMLNode( psTree );
+    if( pszXML == nullptr )
+        return;
+
+    CPLString osBuffer;
+    VRTSourcesCacheWriteString( osBuffer, pszSOURCES_CACHE_SIGNATURE );
+    VRTSourcesCacheWriteInt( osBuffer, knSOURCES_CACHE_VERSION );
+    VRTSourcesCacheWriteDouble( osBuffer,
+                                static_cast<double>(sStat.st_size) );
+    VRTSourcesCacheWriteDouble( osBuffer,
+                                static_cast<double>(sStat.st_mtime) );
+    VRTSourcesCacheWriteString( osBuffer, pszVRTPath ? pszVRTPath : "" );
+    CPLString osCurDir;
+    if( bDependsOnCurDir )
+    {
+        char* pszCurDir = CPLGetCurrentDir();
+        if( pszCurDir == nullptr )
+        {
+            CPLFree( pszXML );
+            return;
+        }
+        osCurDir = pszCurDir;
+        CPLFree( pszCurDir );
+    }
+    VRTSourcesCacheWriteString( osBuffer, osCurDir );
+    VRTSourcesCacheWriteString( osBuffer, pszXML );
+    CPLFree( pszXML );
+
+/* -------------------------------------------------------------------- */
+/*      Append the sources.                                             */
+/* -------------------------------------------------------------------- */
+    VRTSourcesCacheWriteInt( osBuffer, nBands );
+    for( int iBand = 0; iBand < nBands; iBand++ )
+    {
+        VRTSourcedRasterBand* poBand =
+            reinterpret_cast<VRTSourcedRasterBand*>( papoBands[iBand] );
+        VRTSourcesCacheWriteInt( osBuffer, poBand->nSources );
+        for( int iSource = 0; iSource < poBand->nSources; iSource++ )
+        {
+            VRTSimpleSource* poSource = reinterpret_cast<VRTSimpleSource*>(
+                poBand->papoSources[iSource] );
+            VRTSourcesCacheWriteInt( osBuffer,
+                typeid(*poSource) == typeid(VRTComplexSource) ?
+                    knSOURCES_CACHE_COMPLEX_SOURCE :
+                    knSOURCES_CACHE_SIMPLE_SOURCE );
+            poSource->WriteInSourcesCache( osBuffer );
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Write to a temporary file first so that concurrent readers      */
+/*      never see a partial cache.                                      */
+/* -------------------------------------------------------------------- */
+    CPLString osTmpFilename( CPLSPrintf("%s." CPL_FRMT_GIB ".tmp",
+                                        pszCacheFilename, CPLGetPID()) );
+    bool bOK = false;
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    VSILFILE* fp = VSIFOpenL( osTmpFilename, "wb" );
+    if( fp != nullptr )
+    {
+        bOK = VSIFWriteL( osBuffer.data(), 1, osBuffer.size(), fp )
+                                                    == osBuffer.size();
+        bOK = VSIFCloseL( fp ) == 0 && bOK;
+        bOK = bOK && VSIRename( osTmpFilename, pszCacheFilename ) == 0;
+        if( !bOK )
+            VSIUnlink( osTmpFilename );
+    }
+    CPLPopErrorHandler();
+    CPLErrorReset();
+    if( bOK )
+        CPLDebug( "VRT", "Wrote %s", pszCacheFilename );
+    else
+        CPLDebug( "VRT", "Cannot write %s", pszCacheFilename );
+}
+
 /************************************************************************/
 /*                                Open()                                */
 /************************************************************************/
@@ -833,15 +1191,47 @@ GDALDataset *VRTDataset::Open( GDALOpenInfo * poOpenInfo )
             CSLFetchNameValue( poOpenInfo->papszOpenOptions, "ROOT_PATH" ) );
     }
 
+/* -------------------------------------------------------------------- */
+/*      Try the binary sources cache, if enabled.                       */
+/* -------------------------------------------------------------------- */
+    VRTDataset *poDS = nullptr;
+    CPLString osCacheFilename;
+    VSIStatBufL sStat;
+    if( fp != nullptr && poOpenInfo->eAccess == GA_ReadOnly &&
+        strcmp(poOpenInfo->pszFilename, "/vsistdin/") != 0 &&
+        CPLTestBool(CPLGetConfigOption("VRT_SOURCES_CACHE", "NO")) &&
+        VSIStatL(poOpenInfo->pszFilename, &sStat) == 0 )
+    {
+        osCacheFilename = CPLString(poOpenInfo->pszFilename) + ".srccache";
+        poDS = OpenSourcesCache( osCacheFilename, sStat, pszVRTPath,
+                                 poOpenInfo->eAccess );
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Turn the XML representation into a VRTDataset.                  */
 /* -------------------------------------------------------------------- */
-    VRTDataset *poDS = reinterpret_cast<VRTDataset *>(
-        OpenXML( pszXML, pszVRTPath, poOpenInfo->eAccess ) );
+    if( poDS == nullptr )
+    {
+        poDS = reinterpret_cast<VRTDataset *>(
+            OpenXML( pszXML, pszVRTPath, poOpenInfo->eAccess ) );
+        if( poDS != nullptr && !osCacheFilename.empty() )
+            poDS->WriteSourcesCache( osCacheFilename, sStat, pszVRTPath );
+    }
 
     if( poDS != nullptr )
+    {
         poDS->m_bNeedsFlush = FALSE;
 
+        const char* pszNumThreads =
+            CSLFetchNameValue(poOpenInfo->papszOpenOptions, "NUM_THREADS");
+        if( pszNumThreads != nullptr )
+        {
+            poDS->SetNumThreads( std::max(1, std::min(128,
+                EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                   atoi(pszNumThreads))) );
+        }
+    }
+
     CPLFree( pszXML );
     CPLFree( pszVRTPath );
 
@@ -1332,14 +1722,7 @@ int VRTDataset::CheckCompatibleForDatasetIO()
                 if( !EQUAL(poSource->GetType(), "SimpleSource") )
                     return FALSE;
 
-                GDALRasterBand *srcband = poSource->GetBand();
-                if( srcband == nullptr )
-                    return FALSE;
-                if( srcband->GetDataset() == nullptr )
-                    return FALSE;
-                if( srcband->GetDataset()->GetRasterCount() <= iBand )
-                    return FALSE;
-                if( srcband->GetDataset()->GetRasterBand(iBand + 1) != srcband )
+                if( !poSource->IsSourceDatasetBand(iBand + 1) )
                     return FALSE;
                 osResampling = poSource->GetResampling();
             }
@@ -1365,14 +1748,7 @@ int VRTDataset::CheckCompatibleForDatasetIO()
                 if( !poSource->IsSameExceptBandNumber(poRefSource) )
                     return FALSE;
 
-                GDALRasterBand *srcband = poSource->GetBand();
-                if( srcband == nullptr )
-                    return FALSE;
-                if( srcband->GetDataset() == nullptr )
-                    return FALSE;
-                if( srcband->GetDataset()->GetRasterCount() <= iBand )
-                    return FALSE;
-                if( srcband->GetDataset()->GetRasterBand(iBand + 1) != srcband )
+                if( !poSource->IsSourceDatasetBand(iBand + 1) )
                     return FALSE;
                 if( osResampling.compare(poSource->GetResampling()) != 0 )
                     return FALSE;
@@ -1510,6 +1886,239 @@ CPLErr VRTDataset::AdviseRead( int nXOff, int nYOff, int nXSize, int nYSize,
                                eDT, nBandCount, panBandList, papszOptions);
 }
 
+/************************************************************************/
+/*                           GetNumThreads()                            */
+/************************************************************************/
+
+int VRTDataset::GetNumThreads()
+{
+    if( m_nNumThreads < 0 )
+    {
+        const char* pszValue = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+        m_nNumThreads = 1;
+        if( pszValue )
+        {
+            m_nNumThreads = EQUAL(pszValue, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                          atoi(pszValue);
+            m_nNumThreads = std::max(1, std::min(128, m_nNumThreads));
+        }
+    }
+    return m_nNumThreads;
+}
+
+/************************************************************************/
+/*                       ReadSourcesConcurrently()                      */
+/************************************************************************/
+
+namespace {
+
+struct VRTSourceReadJob
+{
+    std::vector<VRTSimpleSource*> apoSources;
+    VRTSourceReadFunc             pfnRead;
+    void                         *pUserData;
+    GDALRasterIOExtraArg          sExtraArg;
+    CPLErr                        eErr;
+};
+
+struct VRTSourceWindow
+{
+    VRTSimpleSource *poSource;
+    int              nOutXOff;
+    int              nOutYOff;
+    int              nOutXSize;
+    int              nOutYSize;
+};
+
+}
+
+static void VRTSourceReadJobFunc( void* pData )
+{
+    VRTSourceReadJob* psJob = static_cast<VRTSourceReadJob*>(pData);
+    for( size_t i = 0; psJob->eErr == CE_None &&
+                       i < psJob->apoSources.size(); ++i )
+    {
+        psJob->eErr = psJob->pfnRead(psJob->apoSources[i], &psJob->sExtraArg,
+                                     psJob->pUserData);
+    }
+}
+
+/* Read the sources intersecting the request with the worker threads of */
+/* the dataset, when their windows do not overlap in the output buffer, */
+/* so that the order in which they are composited does not matter. */
+/* Sources referencing the same dataset are read by the same thread, since */
+/* a dataset cannot be used by several threads at the same time. */
+/* Returns false, without having done anything, if that is not possible. */
+bool VRTDataset::ReadSourcesConcurrently( int nSources,
+                                          VRTSource **papoSources,
+                                          int nXOff, int nYOff,
+                                          int nXSize, int nYSize,
+                                          int nBufXSize, int nBufYSize,
+                                          VRTSourceReadFunc pfnRead,
+                                          void *pUserData,
+                                          GDALRasterIOExtraArg* psExtraArg,
+                                          CPLErr *peErr )
+{
+    if( nSources < 2 || GetNumThreads() < 2 )
+        return false;
+
+    std::vector<VRTSourceWindow> asWindows;
+    for( int i = 0; i < nSources; i++ )
+    {
+        if( !papoSources[i]->IsSimpleSource() )
+            return false;
+        VRTSimpleSource* poSource =
+            reinterpret_cast<VRTSimpleSource *>( papoSources[i] );
+        double dfReqXOff = 0.0;
+        double dfReqYOff = 0.0;
+        double dfReqXSize = 0.0;
+        double dfReqYSize = 0.0;
+        int nReqXOff = 0;
+        int nReqYOff = 0;
+        int nReqXSize = 0;
+        int nReqYSize = 0;
+        VRTSourceWindow sWindow;
+        sWindow.poSource = poSource;
+        if( !poSource->GetSrcDstWindow( nXOff, nYOff, nXSize, nYSize,
+                                        nBufXSize, nBufYSize,
+                                        &dfReqXOff, &dfReqYOff,
+                                        &dfReqXSize, &dfReqYSize,
+                                        &nReqXOff, &nReqYOff,
+                                        &nReqXSize, &nReqYSize,
+                                        &sWindow.nOutXOff, &sWindow.nOutYOff,
+                                        &sWindow.nOutXSize,
+                                        &sWindow.nOutYSize ) )
+        {
+            continue;
+        }
+        if( poSource->GetBand() == nullptr )
+            return false;
+        asWindows.push_back(sWindow);
+    }
+    if( asWindows.size() < 2 )
+        return false;
+
+    // Check that the output windows do not overlap
+    std::vector<VRTSourceWindow> asSortedWindows(asWindows);
+    std::sort(asSortedWindows.begin(), asSortedWindows.end(),
+              [](const VRTSourceWindow& a, const VRTSourceWindow& b)
+              { return a.nOutYOff < b.nOutYOff; });
+    for( size_t i = 0; i < asSortedWindows.size(); ++i )
+    {
+        const VRTSourceWindow& a = asSortedWindows[i];
+        for( size_t j = i + 1; j < asSortedWindows.size() &&
+                asSortedWindows[j].nOutYOff < a.nOutYOff + a.nOutYSize; ++j )
+        {
+            const VRTSourceWindow& b = asSortedWindows[j];
+            if( b.nOutXOff < a.nOutXOff + a.nOutXSize &&
+                a.nOutXOff < b.nOutXOff + b.nOutXSize )
+            {
+                return false;
+            }
+        }
+    }
+
+    // One job per source dataset, keeping the order of the sources
+    std::vector<VRTSourceReadJob> asJobs;
+    std::map<CPLString, size_t> oMapDatasetToJob;
+    for( size_t i = 0; i < asWindows.size(); ++i )
+    {
+        GDALDataset* poSrcDS = asWindows[i].poSource->GetBand()->GetDataset();
+        if( poSrcDS == nullptr )
+            return false;
+        const CPLString osKey(poSrcDS->GetDescription());
+        std::map<CPLString, size_t>::const_iterator oIter =
+            oMapDatasetToJob.find(osKey);
+        if( oIter == oMapDatasetToJob.end() )
+        {
+            VRTSourceReadJob sJob;
+            sJob.pfnRead = pfnRead;
+            sJob.pUserData = pUserData;
+            sJob.sExtraArg = *psExtraArg;
+            sJob.sExtraArg.pfnProgress = nullptr;
+            sJob.sExtraArg.pProgressData = nullptr;
+            sJob.eErr = CE_None;
+            oMapDatasetToJob[osKey] = asJobs.size();
+            asJobs.push_back(sJob);
+            asJobs.back().apoSources.push_back(asWindows[i].poSource);
+        }
+        else
+        {
+            asJobs[oIter->second].apoSources.push_back(asWindows[i].poSource);
+        }
+    }
+    if( asJobs.size() < 2 )
+        return false;
+
+    if( m_poThreadPool == nullptr )
+    {
+        CPLDebug("VRT", "Using %d threads to read sources", m_nNumThreads);
+        m_poThreadPool = new CPLWorkerThreadPool();
+        if( !m_poThreadPool->Setup(m_nNumThreads, nullptr, nullptr) )
+        {
+            delete m_poThreadPool;
+            m_poThreadPool = nullptr;
+            m_nNumThreads = 1;
+            return false;
+        }
+    }
+
+    std::vector<void*> apJobs;
+    for( size_t i = 0; i < asJobs.size(); ++i )
+        apJobs.push_back(&asJobs[i]);
+    m_poThreadPool->SubmitJobs(VRTSourceReadJobFunc, apJobs);
+    m_poThreadPool->WaitCompletion();
+
+    *peErr = CE_None;
+    for( size_t i = 0; i < asJobs.size(); ++i )
+    {
+        if( asJobs[i].eErr != CE_None )
+            *peErr = asJobs[i].eErr;
+    }
+    if( *peErr == CE_None && psExtraArg->pfnProgress )
+        psExtraArg->pfnProgress(1.0, "", psExtraArg->pProgressData);
+
+    return true;
+}
+
+namespace {
+
+struct VRTDatasetRasterIOArgs
+{
+    int         nXOff;
+    int         nYOff;
+    int         nXSize;
+    int         nYSize;
+    void       *pData;
+    int         nBufXSize;
+    int         nBufYSize;
+    GDALDataType eBufType;
+    int         nBandCount;
+    int        *panBandMap;
+    GSpacing    nPixelSpace;
+    GSpacing    nLineSpace;
+    GSpacing    nBandSpace;
+};
+
+}
+
+static CPLErr VRTSourceDatasetRasterIO( VRTSimpleSource* poSource,
+                                        GDALRasterIOExtraArg* psExtraArg,
+                                        void* pUserData )
+{
+    const VRTDatasetRasterIOArgs* psArgs =
+        static_cast<const VRTDatasetRasterIOArgs*>(pUserData);
+    return poSource->DatasetRasterIO( psArgs->nXOff, psArgs->nYOff,
+                                      psArgs->nXSize, psArgs->nYSize,
+                                      psArgs->pData,
+                                      psArgs->nBufXSize, psArgs->nBufYSize,
+                                      psArgs->eBufType,
+                                      psArgs->nBandCount, psArgs->panBandMap,
+                                      psArgs->nPixelSpace, psArgs->nLineSpace,
+                                      psArgs->nBandSpace,
+                                      psExtraArg );
+}
+
 /************************************************************************/
 /*                              IRasterIO()                             */
 /************************************************************************/
@@ -1570,11 +2179,14 @@ CPLErr VRTDataset::IRasterIO( GDALRWFlag eRWFlag,
             const double dfNoDataValue = poBand->GetNoDataValue(&bHasNoData);
             if( bHasNoData )
             {
-                for( int i = 0; i < poBand->nSources; i++ )
+                std::vector<VRTSource*> apoSourcesInWindow;
+                poBand->GetSourcesInWindow( nXOff, nYOff, nXSize, nYSize,
+                                            apoSourcesInWindow );
+                for( size_t i = 0; i < apoSourcesInWindow.size(); i++ )
                 {
                     VRTSimpleSource* poSource
                         = reinterpret_cast<VRTSimpleSource *>(
-                            poBand->papoSources[i] );
+                            apoSourcesInWindow[i] );
                     int bSrcHasNoData = FALSE;
                     const double dfSrcNoData
                         = poSource->GetBand()->GetNoDataValue(&bSrcHasNoData);
@@ -1622,20 +2234,51 @@ CPLErr VRTDataset::IRasterIO( GDALRWFlag eRWFlag,
         // they don't necessary instantiate all underlying rasterbands.
         VRTSourcedRasterBand* poBand = reinterpret_cast<VRTSourcedRasterBand *>(
             papoBands[nBands - 1] );
+
+        VRTDatasetRasterIOArgs sArgs;
+        sArgs.nXOff = nXOff;
+        sArgs.nYOff = nYOff;
+        sArgs.nXSize = nXSize;
+        sArgs.nYSize = nYSize;
+        sArgs.pData = pData;
+        sArgs.nBufXSize = nBufXSize;
+        sArgs.nBufYSize = nBufYSize;
+        sArgs.eBufType = eBufType;
+        sArgs.nBandCount = nBandCount;
+        sArgs.panBandMap = panBandMap;
+        sArgs.nPixelSpace = nPixelSpace;
+        sArgs.nLineSpace = nLineSpace;
+        sArgs.nBandSpace = nBandSpace;
+        std::vector<VRTSource*> apoSourcesInWindow;
+        poBand->GetSourcesInWindow( nXOff, nYOff, nXSize, nYSize,
+                                    apoSourcesInWindow );
+        const int nSourcesInWindow =
+            static_cast<int>(apoSourcesInWindow.size());
+
+        if( ReadSourcesConcurrently( nSourcesInWindow,
+                                     apoSourcesInWindow.data(),
+                                     nXOff, nYOff, nXSize, nYSize,
+                                     nBufXSize, nBufYSize,
+                                     VRTSourceDatasetRasterIO, &sArgs,
+                                     psExtraArg, &eErr ) )
+        {
+            return eErr;
+        }
+
         for( int iSource = 0;
-             eErr == CE_None && iSource < poBand->nSources;
+             eErr == CE_None && iSource < nSourcesInWindow;
              iSource++ )
         {
             psExtraArg->pfnProgress = GDALScaledProgress;
             psExtraArg->pProgressData =
                 GDALCreateScaledProgress(
-                    1.0 * iSource / poBand->nSources,
-                    1.0 * (iSource + 1) / poBand->nSources,
+                    1.0 * iSource / nSourcesInWindow,
+                    1.0 * (iSource + 1) / nSourcesInWindow,
                     pfnProgressGlobal,
                     pProgressDataGlobal );
 
             VRTSimpleSource* poSource = reinterpret_cast<VRTSimpleSource *>(
-                poBand->papoSources[iSource] );
+                apoSourcesInWindow[iSource] );
 
             eErr = poSource->DatasetRasterIO( nXOff, nYOff, nXSize, nYSize,
                                               pData, nBufXSize, nBufYSize,
@@ -1753,6 +2396,7 @@ void VRTDataset::BuildVirtualOverviews()
         if( nOvrXSize < 128 || nOvrYSize < 128 )
             break;
         VRTDataset* poOvrVDS = new VRTDataset(nOvrXSize, nOvrYSize);
+        poOvrVDS->SetNumThreads(GetNumThreads());
         m_apoOverviews.push_back(poOvrVDS);
 
         for( int i = 0; i < nBands; i++ )
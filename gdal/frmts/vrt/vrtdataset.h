@@ -34,6 +34,7 @@
 #ifndef DOXYGEN_SKIP
 
 #include "cpl_hash_set.h"
+#include "cpl_quad_tree.h"
 #include "gdal_pam.h"
 #include "gdal_priv.h"
 #include "gdal_vrt.h"
@@ -122,11 +123,29 @@ typedef VRTSource *(*VRTSourceParser)(CPLXMLNode *, const char *, void* pUniqueH
 VRTSource *VRTParseCoreSources( CPLXMLNode *psTree, const char *, void* pUniqueHandle );
 VRTSource *VRTParseFilterSources( CPLXMLNode *psTree, const char *, void* pUniqueHandle );
 
+// Encoding helpers for the binary sources cache (see
+// VRTDataset::WriteSourcesCache())
+void VRTSourcesCacheWriteInt( CPLString& osBuffer, int nVal );
+void VRTSourcesCacheWriteDouble( CPLString& osBuffer, double dfVal );
+void VRTSourcesCacheWriteString( CPLString& osBuffer, const CPLString& osStr );
+bool VRTSourcesCacheReadInt( const GByte** ppabyData, const GByte* pabyEnd,
+                             int* pnVal );
+bool VRTSourcesCacheReadDouble( const GByte** ppabyData, const GByte* pabyEnd,
+                                double* pdfVal );
+bool VRTSourcesCacheReadString( const GByte** ppabyData, const GByte* pabyEnd,
+                                CPLString& osStr );
+
 /************************************************************************/
 /*                              VRTDataset                              */
 /************************************************************************/
 
 class VRTRasterBand;
+class VRTSimpleSource;
+class CPLWorkerThreadPool;
+
+typedef CPLErr (*VRTSourceReadFunc)( VRTSimpleSource *poSource,
+                                     GDALRasterIOExtraArg* psExtraArg,
+                                     void *pUserData );
 
 class CPL_DLL VRTDataset : public GDALDataset
 {
@@ -154,6 +173,17 @@ class CPL_DLL VRTDataset : public GDALDataset
     std::vector<GDALDataset*> m_apoOverviewsBak;
     char         **m_papszXMLVRTMetadata;
 
+    int            m_nNumThreads;
+    CPLWorkerThreadPool *m_poThreadPool;
+
+    static VRTDataset *OpenSourcesCache( const char* pszCacheFilename,
+                                         const VSIStatBufL& sStat,
+                                         const char* pszVRTPath,
+                                         GDALAccess eAccess );
+    void           WriteSourcesCache( const char* pszCacheFilename,
+                                      const VSIStatBufL& sStat,
+                                      const char* pszVRTPath );
+
   protected:
     virtual int         CloseDependentDatasets() CPL_OVERRIDE;
 
@@ -218,6 +248,17 @@ class CPL_DLL VRTDataset : public GDALDataset
 
     void                UnsetPreservedRelativeFilenames();
 
+    void                SetNumThreads( int nNumThreads )
+                                { m_nNumThreads = nNumThreads; }
+    int                 GetNumThreads();
+    bool                ReadSourcesConcurrently(
+                               int nSources, VRTSource **papoSources,
+                               int nXOff, int nYOff, int nXSize, int nYSize,
+                               int nBufXSize, int nBufYSize,
+                               VRTSourceReadFunc pfnRead, void *pUserData,
+                               GDALRasterIOExtraArg* psExtraArg,
+                               CPLErr *peErr );
+
     static int          Identify( GDALOpenInfo * );
     static GDALDataset *Open( GDALOpenInfo * );
     static GDALDataset *OpenXML( const char *, const char * = nullptr,
@@ -488,8 +529,15 @@ class CPL_DLL VRTSourcedRasterBand : public VRTRasterBand
     CPLString      m_osLastLocationInfo;
     char         **m_papszSourceList;
 
+    // Spatial index of the destination windows of the sources, built
+    // lazily when there are many of them.
+    CPLQuadTree   *m_hSourcesQuadTree;
+    int            m_nSourcesIndexed;
+    VRTSource    **m_papoSourcesIndexed;
+
     bool           CanUseSourcesMinMaxImplementations();
     void           CheckSource( VRTSimpleSource *poSS );
+    void           InvalidateSourcesIndex();
 
   public:
     int            nSources;
@@ -542,6 +590,9 @@ class CPL_DLL VRTSourcedRasterBand : public VRTRasterBand
                                   void *pProgressData ) CPL_OVERRIDE;
 
     CPLErr         AddSource( VRTSource * );
+    void           GetSourcesInWindow( int nXOff, int nYOff,
+                                       int nXSize, int nYSize,
+                                       std::vector<VRTSource*>& apoSources );
     CPLErr         AddSimpleSource( GDALRasterBand *poSrcBand,
                                     double dfSrcXOff=-1, double dfSrcYOff=-1,
                                     double dfSrcXSize=-1, double dfSrcYSize=-1,
@@ -776,11 +827,28 @@ class CPL_DLL VRTSimpleSource : public VRTSource
 protected:
     friend class VRTSourcedRasterBand;
 
-    GDALRasterBand      *m_poRasterBand;
+    // Use GetRasterBand() rather than accessing it directly, since the
+    // source may not be opened yet.
+    mutable GDALRasterBand *m_poRasterBand;
 
     // When poRasterBand is a mask band, poMaskBandMainBand is the band
     // from which the mask band is taken.
-    GDALRasterBand      *m_poMaskBandMainBand;
+    mutable GDALRasterBand *m_poMaskBandMainBand;
+
+    // When the source properties are known from the XML, the creation of
+    // the proxy dataset is deferred until the source is actually needed.
+    // m_osSrcDSName is then not empty.
+    CPLString           m_osSrcDSName;
+    int                 m_nSrcBand;
+    bool                m_bGetMaskBand;
+    bool                m_bSrcDSShared;
+    GDALDataType        m_eSrcDataType;
+    int                 m_nSrcRasterXSize;
+    int                 m_nSrcRasterYSize;
+    int                 m_nSrcBlockXSize;
+    int                 m_nSrcBlockYSize;
+    char              **m_papszSrcOpenOptions;
+    void               *m_pUniqueHandle;
 
     double              m_dfSrcXOff;
     double              m_dfSrcYOff;
@@ -804,6 +872,12 @@ protected:
 
     int                 NeedMaxValAdjustment() const;
 
+    void                OpenSource() const;
+    GDALRasterBand     *GetRasterBand() const
+        { if( m_poRasterBand == nullptr && !m_osSrcDSName.empty() )
+              OpenSource();
+          return m_poRasterBand; }
+
 public:
             VRTSimpleSource();
             VRTSimpleSource( const VRTSimpleSource* poSrcSource,
@@ -862,7 +936,15 @@ public:
     virtual const char* GetType() { return "SimpleSource"; }
     virtual CPLErr FlushCache() CPL_OVERRIDE;
 
+    virtual bool    CanBeWrittenInSourcesCache();
+    void            WriteInSourcesCache( CPLString& osBuffer );
+    bool            ReadFromSourcesCache( const GByte** ppabyData,
+                                          const GByte* pabyEnd,
+                                          void* pUniqueHandle );
+
     GDALRasterBand* GetBand();
+    const char*     GetSourceDatasetName();
+    int             IsSourceDatasetBand( int nBand );
     int             IsSameExceptBandNumber( VRTSimpleSource* poOtherSource );
     CPLErr          DatasetRasterIO(
                                int nXOff, int nYOff, int nXSize, int nYSize,
@@ -982,6 +1064,7 @@ public:
     virtual CPLXMLNode *SerializeToXML( const char *pszVRTPath ) CPL_OVERRIDE;
     virtual CPLErr XMLInit( CPLXMLNode *, const char *, void* ) CPL_OVERRIDE;
     virtual const char* GetType() CPL_OVERRIDE { return "ComplexSource"; }
+    virtual bool CanBeWrittenInSourcesCache() CPL_OVERRIDE;
 
     double  LookupValue( double dfInput );
 
@@ -182,8 +182,8 @@ VRTFilteredSource::RasterIO( int nXOff, int nYOff, int nXSize, int nYSize,
         eOperDataType = eBufType;
 
     if( eOperDataType == GDT_Unknown
-        && IsTypeSupported( m_poRasterBand->GetRasterDataType() ) )
-        eOperDataType = m_poRasterBand->GetRasterDataType();
+        && IsTypeSupported( GetRasterBand()->GetRasterDataType() ) )
+        eOperDataType = GetRasterBand()->GetRasterDataType();
 
     if( eOperDataType == GDT_Unknown )
     {
@@ -274,15 +274,15 @@ VRTFilteredSource::RasterIO( int nXOff, int nYOff, int nXSize, int nYSize,
         nFileYSize -= nTopFill;
     }
 
-    if( nFileXOff + nFileXSize > m_poRasterBand->GetXSize() )
+    if( nFileXOff + nFileXSize > GetRasterBand()->GetXSize() )
     {
-        nRightFill = nFileXOff + nFileXSize - m_poRasterBand->GetXSize();
+        nRightFill = nFileXOff + nFileXSize - GetRasterBand()->GetXSize();
         nFileXSize -= nRightFill;
     }
 
-    if( nFileYOff + nFileYSize > m_poRasterBand->GetYSize() )
+    if( nFileYOff + nFileYSize > GetRasterBand()->GetYSize() )
     {
-        nBottomFill = nFileYOff + nFileYSize - m_poRasterBand->GetYSize();
+        nBottomFill = nFileYOff + nFileYSize - GetRasterBand()->GetYSize();
         nFileYSize -= nBottomFill;
     }
 
@@ -492,7 +492,7 @@ CPLErr VRTKernelFilteredSource::FilterData( int nXSize, int nYSize,
 
         int bHasNoData = FALSE;
         const float fNoData =
-            static_cast<float>( m_poRasterBand->GetNoDataValue(&bHasNoData) );
+            static_cast<float>( GetRasterBand()->GetNoDataValue(&bHasNoData) );
 
         const int nAxisCount = m_bSeparable ? 2 : 1;
 
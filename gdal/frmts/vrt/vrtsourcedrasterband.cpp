@@ -31,6 +31,7 @@
 #include "gdal_vrt.h"
 #include "vrtdataset.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdio>
@@ -66,6 +67,9 @@ CPL_CVSID("$Id$")
 VRTSourcedRasterBand::VRTSourcedRasterBand( GDALDataset *poDSIn, int nBandIn ) :
     m_nRecursionCounter(0),
     m_papszSourceList(nullptr),
+    m_hSourcesQuadTree(nullptr),
+    m_nSourcesIndexed(0),
+    m_papoSourcesIndexed(nullptr),
     nSources(0),
     papoSources(nullptr),
     bSkipBufferInitialization(FALSE)
@@ -85,6 +89,9 @@ VRTSourcedRasterBand::VRTSourcedRasterBand( GDALDataType eType,
                                             int nXSize, int nYSize ) :
     m_nRecursionCounter(0),
     m_papszSourceList(nullptr),
+    m_hSourcesQuadTree(nullptr),
+    m_nSourcesIndexed(0),
+    m_papoSourcesIndexed(nullptr),
     nSources(0),
     papoSources(nullptr),
     bSkipBufferInitialization(FALSE)
@@ -103,6 +110,9 @@ VRTSourcedRasterBand::VRTSourcedRasterBand( GDALDataset *poDSIn, int nBandIn,
                                             int nXSize, int nYSize ) :
     m_nRecursionCounter(0),
     m_papszSourceList(nullptr),
+    m_hSourcesQuadTree(nullptr),
+    m_nSourcesIndexed(0),
+    m_papoSourcesIndexed(nullptr),
     nSources(0),
     papoSources(nullptr),
     bSkipBufferInitialization(FALSE)
@@ -124,6 +134,40 @@ VRTSourcedRasterBand::~VRTSourcedRasterBand()
 {
     CloseDependentDatasets();
     CSLDestroy(m_papszSourceList);
+    InvalidateSourcesIndex();
+}
+
+namespace {
+
+struct VRTBandRasterIOArgs
+{
+    int         nXOff;
+    int         nYOff;
+    int         nXSize;
+    int         nYSize;
+    void       *pData;
+    int         nBufXSize;
+    int         nBufYSize;
+    GDALDataType eBufType;
+    GSpacing    nPixelSpace;
+    GSpacing    nLineSpace;
+};
+
+}
+
+static CPLErr VRTSourceBandRasterIO( VRTSimpleSource* poSource,
+                                     GDALRasterIOExtraArg* psExtraArg,
+                                     void* pUserData )
+{
+    const VRTBandRasterIOArgs* psArgs =
+        static_cast<const VRTBandRasterIOArgs*>(pUserData);
+    return poSource->RasterIO( psArgs->nXOff, psArgs->nYOff,
+                               psArgs->nXSize, psArgs->nYSize,
+                               psArgs->pData,
+                               psArgs->nBufXSize, psArgs->nBufYSize,
+                               psArgs->eBufType,
+                               psArgs->nPixelSpace, psArgs->nLineSpace,
+                               psExtraArg );
 }
 
 /************************************************************************/
@@ -183,17 +227,20 @@ CPLErr VRTSourcedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
         psExtraArg->eResampleAlg != GRIORA_NearestNeighbour &&
         m_bNoDataValueSet )
     {
-        for( int i = 0; i < nSources; i++ )
+        std::vector<VRTSource*> apoSourcesInWindow;
+        GetSourcesInWindow( nXOff, nYOff, nXSize, nYSize, apoSourcesInWindow );
+        for( size_t i = 0; i < apoSourcesInWindow.size(); i++ )
         {
             bool bFallbackToBase = false;
-            if( !papoSources[i]->IsSimpleSource() )
+            if( !apoSourcesInWindow[i]->IsSimpleSource() )
             {
                 bFallbackToBase = true;
             }
             else
             {
                 VRTSimpleSource* const poSource
-                    = reinterpret_cast<VRTSimpleSource *>( papoSources[i] );
+                    = reinterpret_cast<VRTSimpleSource *>(
+                        apoSourcesInWindow[i] );
                 // The window we will actually request from the source raster band.
                 double dfReqXOff = 0.0;
                 double dfReqYOff = 0.0;
@@ -283,26 +330,64 @@ CPLErr VRTSourcedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
     GDALProgressFunc const pfnProgressGlobal = psExtraArg->pfnProgress;
     void * const pProgressDataGlobal = psExtraArg->pProgressData;
 
+    std::vector<VRTSource*> apoSourcesInWindow;
+    GetSourcesInWindow( nXOff, nYOff, nXSize, nYSize, apoSourcesInWindow );
+    const int nSourcesInWindow = static_cast<int>(apoSourcesInWindow.size());
+
 /* -------------------------------------------------------------------- */
-/*      Overlay each source in turn over top this.                      */
+/*      Read sources that do not overlap concurrently if possible.      */
 /* -------------------------------------------------------------------- */
     CPLErr eErr = CE_None;
-    for( int iSource = 0; eErr == CE_None && iSource < nSources; iSource++ )
+    VRTDataset* poVRTDS = dynamic_cast<VRTDataset*>(poDS);
+    if( poVRTDS != nullptr )
+    {
+        VRTBandRasterIOArgs sArgs;
+        sArgs.nXOff = nXOff;
+        sArgs.nYOff = nYOff;
+        sArgs.nXSize = nXSize;
+        sArgs.nYSize = nYSize;
+        sArgs.pData = pData;
+        sArgs.nBufXSize = nBufXSize;
+        sArgs.nBufYSize = nBufYSize;
+        sArgs.eBufType = eBufType;
+        sArgs.nPixelSpace = nPixelSpace;
+        sArgs.nLineSpace = nLineSpace;
+        if( poVRTDS->ReadSourcesConcurrently( nSourcesInWindow,
+                                              apoSourcesInWindow.data(),
+                                              nXOff, nYOff, nXSize, nYSize,
+                                              nBufXSize, nBufYSize,
+                                              VRTSourceBandRasterIO, &sArgs,
+                                              psExtraArg, &eErr ) )
+        {
+            m_nRecursionCounter--;
+            return eErr;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Overlay each source in turn over top this.                      */
+/* -------------------------------------------------------------------- */
+    for( int iSource = 0;
+         eErr == CE_None && iSource < nSourcesInWindow;
+         iSource++ )
     {
         psExtraArg->pfnProgress = GDALScaledProgress;
         psExtraArg->pProgressData =
-            GDALCreateScaledProgress( 1.0 * iSource / nSources,
-                                      1.0 * (iSource + 1) / nSources,
+            GDALCreateScaledProgress( 1.0 * iSource / nSourcesInWindow,
+                                      1.0 * (iSource + 1) / nSourcesInWindow,
                                       pfnProgressGlobal,
                                       pProgressDataGlobal );
         if( psExtraArg->pProgressData == nullptr )
             psExtraArg->pfnProgress = nullptr;
 
         eErr =
-            papoSources[iSource]->RasterIO( nXOff, nYOff, nXSize, nYSize,
-                                            pData, nBufXSize, nBufYSize,
-                                            eBufType, nPixelSpace, nLineSpace,
-                                            psExtraArg);
+            apoSourcesInWindow[iSource]->RasterIO( nXOff, nYOff,
+                                                   nXSize, nYSize,
+                                                   pData,
+                                                   nBufXSize, nBufYSize,
+                                                   eBufType,
+                                                   nPixelSpace, nLineSpace,
+                                                   psExtraArg);
 
         GDALDestroyScaledProgress( psExtraArg->pProgressData );
     }
@@ -353,15 +438,18 @@ int  VRTSourcedRasterBand::IGetDataCoverageStatus( int nXOff,
     poLR->addPoint( nXOff, nYOff );
     poPolyNonCoveredBySources->addRingDirectly(poLR);
 
-    for( int iSource = 0; iSource < nSources; iSource++ )
+    std::vector<VRTSource*> apoSourcesInWindow;
+    GetSourcesInWindow( nXOff, nYOff, nXSize, nYSize, apoSourcesInWindow );
+    for( size_t iSource = 0; iSource < apoSourcesInWindow.size(); iSource++ )
     {
-        if( !papoSources[iSource]->IsSimpleSource() )
+        if( !apoSourcesInWindow[iSource]->IsSimpleSource() )
         {
             delete poPolyNonCoveredBySources;
             return GDAL_DATA_COVERAGE_STATUS_UNIMPLEMENTED |
                    GDAL_DATA_COVERAGE_STATUS_DATA;
         }
-        VRTSimpleSource* poSS = reinterpret_cast<VRTSimpleSource*>(papoSources[iSource]);
+        VRTSimpleSource* poSS =
+            reinterpret_cast<VRTSimpleSource*>(apoSourcesInWindow[iSource]);
         // Check if the AOI is fully inside the source
         if( nXOff >= poSS->m_dfDstXOff &&
             nYOff >= poSS->m_dfDstYOff &&
@@ -897,6 +985,7 @@ CPLErr VRTSourcedRasterBand::AddSource( VRTSource *poNewSource )
     papoSources = static_cast<VRTSource **>(
         CPLRealloc( papoSources, sizeof(void*) * nSources ) );
     papoSources[nSources-1] = poNewSource;
+    InvalidateSourcesIndex();
 
     reinterpret_cast<VRTDataset *>( poDS )->SetNeedsFlush();
 
@@ -918,6 +1007,133 @@ CPLErr VRTSourcedRasterBand::AddSource( VRTSource *poNewSource )
     return CE_None;
 }
 
+/************************************************************************/
+/*                       InvalidateSourcesIndex()                       */
+/************************************************************************/
+
+void VRTSourcedRasterBand::InvalidateSourcesIndex()
+{
+    if( m_hSourcesQuadTree != nullptr )
+        CPLQuadTreeDestroy( m_hSourcesQuadTree );
+    m_hSourcesQuadTree = nullptr;
+    m_nSourcesIndexed = 0;
+    m_papoSourcesIndexed = nullptr;
+}
+
+/************************************************************************/
+/*                         GetSourcesInWindow()                         */
+/*                                                                      */
+/*      Return, in their original order, the sources that may           */
+/*      contribute to the passed window. This is a superset of the      */
+/*      sources for which GetSrcDstWindow() succeeds. When there are    */
+/*      many sources, a quad tree of their destination windows is       */
+/*      built on first use so that the cost depends on the number of    */
+/*      sources intersecting the window rather than on their total.     */
+/************************************************************************/
+
+static const int knMIN_SOURCES_FOR_INDEX = 64;
+
+void VRTSourcedRasterBand::GetSourcesInWindow(
+                                    int nXOff, int nYOff,
+                                    int nXSize, int nYSize,
+                                    std::vector<VRTSource*>& apoSources )
+{
+    apoSources.clear();
+    if( nSources < knMIN_SOURCES_FOR_INDEX )
+    {
+        apoSources.insert( apoSources.end(),
+                           papoSources, papoSources + nSources );
+        return;
+    }
+
+    if( m_hSourcesQuadTree == nullptr ||
+        m_nSourcesIndexed != nSources ||
+        m_papoSourcesIndexed != papoSources )
+    {
+        InvalidateSourcesIndex();
+
+        // Sources whose destination window is not set, or which are not
+        // simple sources, are given the extent of the band.
+        std::vector<CPLRectObj> asBounds( nSources );
+        CPLRectObj sGlobalBounds;
+        sGlobalBounds.minx = 0;
+        sGlobalBounds.miny = 0;
+        sGlobalBounds.maxx = nRasterXSize;
+        sGlobalBounds.maxy = nRasterYSize;
+        for( int i = 0; i < nSources; i++ )
+        {
+            CPLRectObj& sBounds = asBounds[i];
+            sBounds.minx = 0;
+            sBounds.miny = 0;
+            sBounds.maxx = nRasterXSize;
+            sBounds.maxy = nRasterYSize;
+            if( papoSources[i]->IsSimpleSource() )
+            {
+                VRTSimpleSource* poSS =
+                    reinterpret_cast<VRTSimpleSource*>( papoSources[i] );
+                const bool bDstWinSet =
+                    poSS->m_dfDstXOff != -1 || poSS->m_dfDstXSize != -1 ||
+                    poSS->m_dfDstYOff != -1 || poSS->m_dfDstYSize != -1;
+                if( bDstWinSet &&
+                    CPLIsFinite(poSS->m_dfDstXOff) &&
+                    CPLIsFinite(poSS->m_dfDstYOff) &&
+                    CPLIsFinite(poSS->m_dfDstXSize) &&
+                    CPLIsFinite(poSS->m_dfDstYSize) )
+                {
+                    sBounds.minx = poSS->m_dfDstXOff;
+                    sBounds.miny = poSS->m_dfDstYOff;
+                    sBounds.maxx = poSS->m_dfDstXOff + poSS->m_dfDstXSize;
+                    sBounds.maxy = poSS->m_dfDstYOff + poSS->m_dfDstYSize;
+                    if( sBounds.maxx < sBounds.minx )
+                        std::swap( sBounds.minx, sBounds.maxx );
+                    if( sBounds.maxy < sBounds.miny )
+                        std::swap( sBounds.miny, sBounds.maxy );
+                }
+            }
+            sGlobalBounds.minx = std::min( sGlobalBounds.minx, sBounds.minx );
+            sGlobalBounds.miny = std::min( sGlobalBounds.miny, sBounds.miny );
+            sGlobalBounds.maxx = std::max( sGlobalBounds.maxx, sBounds.maxx );
+            sGlobalBounds.maxy = std::max( sGlobalBounds.maxy, sBounds.maxy );
+        }
+
+        m_hSourcesQuadTree = CPLQuadTreeCreate( &sGlobalBounds, nullptr );
+        CPLQuadTreeSetMaxDepth( m_hSourcesQuadTree,
+                                CPLQuadTreeGetAdvisedMaxDepth( nSources ) );
+        // The features stored are the addresses of the slots of
+        // papoSources, so that the index of a source can be retrieved.
+        for( int i = 0; i < nSources; i++ )
+        {
+            CPLQuadTreeInsertWithBounds( m_hSourcesQuadTree,
+                                         papoSources + i, &asBounds[i] );
+        }
+        m_nSourcesIndexed = nSources;
+        m_papoSourcesIndexed = papoSources;
+    }
+
+    CPLRectObj sAOI;
+    sAOI.minx = nXOff;
+    sAOI.miny = nYOff;
+    sAOI.maxx = static_cast<double>(nXOff) + nXSize;
+    sAOI.maxy = static_cast<double>(nYOff) + nYSize;
+    int nFeatureCount = 0;
+    void** pahFeatures =
+        CPLQuadTreeSearch( m_hSourcesQuadTree, &sAOI, &nFeatureCount );
+    std::vector<int> anIndices;
+    anIndices.reserve( nFeatureCount );
+    for( int i = 0; i < nFeatureCount; i++ )
+    {
+        anIndices.push_back( static_cast<int>(
+            static_cast<VRTSource**>(pahFeatures[i]) - papoSources ) );
+    }
+    CPLFree( pahFeatures );
+
+    // Sources must be composited in the order of the VRT.
+    std::sort( anIndices.begin(), anIndices.end() );
+    apoSources.reserve( anIndices.size() );
+    for( size_t i = 0; i < anIndices.size(); i++ )
+        apoSources.push_back( papoSources[anIndices[i]] );
+}
+
 /*! @endcond */
 
 /************************************************************************/
@@ -1033,15 +1249,18 @@ void VRTSourcedRasterBand::CheckSource( VRTSimpleSource *poSS )
 /* -------------------------------------------------------------------- */
 
     // Note: if one day we do alpha compositing, we will need to check that.
+    // The source band is tested last, so that sources that do not cover
+    // the whole band do not need to be opened.
     if( strcmp(poSS->GetType(), "SimpleSource") == 0 &&
         poSS->m_dfSrcXOff >= 0.0 &&
         poSS->m_dfSrcYOff >= 0.0 &&
-        poSS->m_dfSrcXOff + poSS->m_dfSrcXSize <= poSS->m_poRasterBand->GetXSize() &&
-        poSS->m_dfSrcYOff + poSS->m_dfSrcYSize <= poSS->m_poRasterBand->GetYSize() &&
         poSS->m_dfDstXOff <= 0.0 &&
         poSS->m_dfDstYOff <= 0.0 &&
         poSS->m_dfDstXOff + poSS->m_dfDstXSize >= nRasterXSize &&
-        poSS->m_dfDstYOff + poSS->m_dfDstYSize >= nRasterYSize )
+        poSS->m_dfDstYOff + poSS->m_dfDstYSize >= nRasterYSize &&
+        poSS->GetRasterBand() != nullptr &&
+        poSS->m_dfSrcXOff + poSS->m_dfSrcXSize <= poSS->GetRasterBand()->GetXSize() &&
+        poSS->m_dfSrcYOff + poSS->m_dfSrcYSize <= poSS->GetRasterBand()->GetYSize() )
     {
         bSkipBufferInitialization = TRUE;
     }
@@ -1425,13 +1644,17 @@ const char *VRTSourcedRasterBand::GetMetadataItem( const char * pszName,
                                                       CPLHashSetEqualStr,
                                                       nullptr );
 
-        for( int iSource = 0; iSource < nSources; iSource++ )
+        std::vector<VRTSource*> apoSourcesInWindow;
+        GetSourcesInWindow( iPixel, iLine, 1, 1, apoSourcesInWindow );
+        for( size_t iSource = 0; iSource < apoSourcesInWindow.size();
+             iSource++ )
         {
-            if( !papoSources[iSource]->IsSimpleSource() )
+            if( !apoSourcesInWindow[iSource]->IsSimpleSource() )
                 continue;
 
             VRTSimpleSource * const poSrc
-                = reinterpret_cast<VRTSimpleSource *>( papoSources[iSource] );
+                = reinterpret_cast<VRTSimpleSource *>(
+                    apoSourcesInWindow[iSource] );
 
             double dfReqXOff = 0.0;
             double dfReqYOff = 0.0;
@@ -1594,6 +1817,7 @@ CPLErr VRTSourcedRasterBand::SetMetadataItem( const char *pszName,
         {
             delete papoSources[iSource];
             papoSources[iSource] = poSource;
+            InvalidateSourcesIndex();
             reinterpret_cast<VRTDataset *>( poDS )->SetNeedsFlush();
             return CE_None;
         }
@@ -1625,6 +1849,7 @@ CPLErr VRTSourcedRasterBand::SetMetadata( char **papszNewMD, const char *pszDoma
             CPLFree( papoSources );
             papoSources = nullptr;
             nSources = 0;
+            InvalidateSourcesIndex();
         }
 
         for( int i = 0; i < CSLCount(papszNewMD); i++ )
@@ -1686,6 +1911,7 @@ int VRTSourcedRasterBand::CloseDependentDatasets()
     CPLFree( papoSources );
     papoSources = nullptr;
     nSources = 0;
+    InvalidateSourcesIndex();
 
     return TRUE;
 }
@@ -39,6 +39,7 @@
 #include <cstring>
 #include <algorithm>
 #include <string>
+#include <typeinfo>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -98,6 +99,16 @@ void VRTSource::GetFileList(char*** /* ppapszFileList */,
 VRTSimpleSource::VRTSimpleSource() :
     m_poRasterBand(nullptr),
     m_poMaskBandMainBand(nullptr),
+    m_nSrcBand(0),
+    m_bGetMaskBand(false),
+    m_bSrcDSShared(false),
+    m_eSrcDataType(GDT_Unknown),
+    m_nSrcRasterXSize(0),
+    m_nSrcRasterYSize(0),
+    m_nSrcBlockXSize(0),
+    m_nSrcBlockYSize(0),
+    m_papszSrcOpenOptions(nullptr),
+    m_pUniqueHandle(nullptr),
     m_dfSrcXOff(0.0),
     m_dfSrcYOff(0.0),
     m_dfSrcXSize(0.0),
@@ -119,8 +130,18 @@ VRTSimpleSource::VRTSimpleSource() :
 
 VRTSimpleSource::VRTSimpleSource( const VRTSimpleSource* poSrcSource,
                                   double dfXDstRatio, double dfYDstRatio ) :
-    m_poRasterBand(poSrcSource->m_poRasterBand),
+    m_poRasterBand(poSrcSource->GetRasterBand()),
     m_poMaskBandMainBand(poSrcSource->m_poMaskBandMainBand),
+    m_nSrcBand(0),
+    m_bGetMaskBand(false),
+    m_bSrcDSShared(false),
+    m_eSrcDataType(GDT_Unknown),
+    m_nSrcRasterXSize(0),
+    m_nSrcRasterYSize(0),
+    m_nSrcBlockXSize(0),
+    m_nSrcBlockYSize(0),
+    m_papszSrcOpenOptions(nullptr),
+    m_pUniqueHandle(nullptr),
     m_dfSrcXOff(poSrcSource->m_dfSrcXOff),
     m_dfSrcYOff(poSrcSource->m_dfSrcYOff),
     m_dfSrcXSize(poSrcSource->m_dfSrcXSize),
@@ -154,6 +175,7 @@ VRTSimpleSource::~VRTSimpleSource()
     {
         m_poRasterBand->GetDataset()->ReleaseRef();
     }
+    CSLDestroy( m_papszSrcOpenOptions );
 }
 
 /************************************************************************/
@@ -279,7 +301,7 @@ static const char* const apszSpecialSyntax[] = {
 CPLXMLNode *VRTSimpleSource::SerializeToXML( const char *pszVRTPath )
 
 {
-    if( m_poRasterBand == nullptr )
+    if( GetRasterBand() == nullptr )
         return nullptr;
 
     GDALDataset *poDS = nullptr;
@@ -292,8 +314,8 @@ CPLXMLNode *VRTSimpleSource::SerializeToXML( const char *pszVRTPath )
     }
     else
     {
-        poDS = m_poRasterBand->GetDataset();
-        if( poDS == nullptr || m_poRasterBand->GetBand() < 1 )
+        poDS = GetRasterBand()->GetDataset();
+        if( poDS == nullptr || GetRasterBand()->GetBand() < 1 )
             return nullptr;
     }
 
@@ -423,21 +445,21 @@ CPLXMLNode *VRTSimpleSource::SerializeToXML( const char *pszVRTPath )
                         CPLSPrintf("mask,%d",m_poMaskBandMainBand->GetBand()) );
     else
         CPLSetXMLValue( psSrc, "SourceBand",
-                        CPLSPrintf("%d",m_poRasterBand->GetBand()) );
+                        CPLSPrintf("%d",GetRasterBand()->GetBand()) );
 
     /* Write a few additional useful properties of the dataset */
     /* so that we can use a proxy dataset when re-opening. See XMLInit() */
     /* below */
     CPLSetXMLValue( psSrc, "SourceProperties.#RasterXSize",
-                    CPLSPrintf("%d",m_poRasterBand->GetXSize()) );
+                    CPLSPrintf("%d",GetRasterBand()->GetXSize()) );
     CPLSetXMLValue( psSrc, "SourceProperties.#RasterYSize",
-                    CPLSPrintf("%d",m_poRasterBand->GetYSize()) );
+                    CPLSPrintf("%d",GetRasterBand()->GetYSize()) );
     CPLSetXMLValue( psSrc, "SourceProperties.#DataType",
-                GDALGetDataTypeName( m_poRasterBand->GetRasterDataType() ) );
+                GDALGetDataTypeName( GetRasterBand()->GetRasterDataType() ) );
 
     int nBlockXSize = 0;
     int nBlockYSize = 0;
-    m_poRasterBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+    GetRasterBand()->GetBlockSize(&nBlockXSize, &nBlockYSize);
 
     CPLSetXMLValue( psSrc, "SourceProperties.#BlockXSize",
                     CPLSPrintf("%d",nBlockXSize) );
@@ -666,6 +688,7 @@ CPLErr VRTSimpleSource::XMLInit( CPLXMLNode *psSrc, const char *pszVRTPath,
         eDataType == static_cast<GDALDataType>(-1) ||
         nBlockXSize == 0 || nBlockYSize == 0 )
     {
+        m_osSrcDSName.clear();
         /* ----------------------------------------------------------------- */
         /*      Open the file (shared).                                      */
         /* ----------------------------------------------------------------- */
@@ -679,63 +702,52 @@ CPLErr VRTSimpleSource::XMLInit( CPLXMLNode *psSrc, const char *pszVRTPath,
     else
     {
         /* ----------------------------------------------------------------- */
-        /*      Create a proxy dataset                                       */
+        /*      Defer the creation of a proxy dataset until the source is    */
+        /*      actually needed (see OpenSource()). This saves time and      */
+        /*      memory for VRTs with many sources.                           */
         /* ----------------------------------------------------------------- */
-        CPLString osUniqueHandle( CPLSPrintf("%p", pUniqueHandle) );
-        GDALProxyPoolDataset * const proxyDS =
-            new GDALProxyPoolDataset( pszSrcDSName, nRasterXSize, nRasterYSize,
-                                      GA_ReadOnly, bShared, nullptr, nullptr,
-                                      osUniqueHandle.c_str() );
-        proxyDS->SetOpenOptions(papszOpenOptions);
-        poSrcDS = proxyDS;
-
-        // Only the information of rasterBand nSrcBand will be accurate
-        // but that's OK since we only use that band afterwards.
-        for( int i = 1; i <= nSrcBand; i++ )
-            proxyDS->AddSrcBandDescription(eDataType, nBlockXSize, nBlockYSize);
-
-        if( bGetMaskBand )
-        {
-          GDALProxyPoolRasterBand *poMaskBand =
-              dynamic_cast<GDALProxyPoolRasterBand *>(
-              proxyDS->GetRasterBand(nSrcBand) );
-          if( poMaskBand == nullptr )
-          {
-              CPLError(
-                  CE_Fatal, CPLE_AssertionFailed, "dynamic_cast failed." );
-          }
-          else
-          {
-              poMaskBand->AddSrcMaskBandDescription(
-                  eDataType, nBlockXSize, nBlockYSize );
-          }
-        }
+        m_osSrcDSName = pszSrcDSName;
+        m_nSrcBand = nSrcBand;
+        m_bGetMaskBand = bGetMaskBand;
+        m_bSrcDSShared = bShared;
+        m_eSrcDataType = eDataType;
+        m_nSrcRasterXSize = nRasterXSize;
+        m_nSrcRasterYSize = nRasterYSize;
+        m_nSrcBlockXSize = nBlockXSize;
+        m_nSrcBlockYSize = nBlockYSize;
+        CSLDestroy( m_papszSrcOpenOptions );
+        m_papszSrcOpenOptions = papszOpenOptions;
+        papszOpenOptions = nullptr;
+        m_pUniqueHandle = pUniqueHandle;
     }
 
     CSLDestroy(papszOpenOptions);
 
     CPLFree( pszSrcDSName );
 
-    if( poSrcDS == nullptr )
-        return CE_Failure;
+    if( m_osSrcDSName.empty() )
+    {
+        if( poSrcDS == nullptr )
+            return CE_Failure;
 
 /* -------------------------------------------------------------------- */
 /*      Get the raster band.                                            */
 /* -------------------------------------------------------------------- */
 
-    m_poRasterBand = poSrcDS->GetRasterBand(nSrcBand);
-    if( m_poRasterBand == nullptr )
-    {
-        if( poSrcDS->GetShared() )
-            GDALClose( poSrcDS );
-        return CE_Failure;
-    }
-    if( bGetMaskBand )
-    {
-        m_poMaskBandMainBand = m_poRasterBand;
-        m_poRasterBand = m_poRasterBand->GetMaskBand();
+        m_poRasterBand = poSrcDS->GetRasterBand(nSrcBand);
         if( m_poRasterBand == nullptr )
+        {
+            if( poSrcDS->GetShared() )
+                GDALClose( poSrcDS );
             return CE_Failure;
+        }
+        if( bGetMaskBand )
+        {
+            m_poMaskBandMainBand = m_poRasterBand;
+            m_poRasterBand = m_poRasterBand->GetMaskBand();
+            if( m_poRasterBand == nullptr )
+                return CE_Failure;
+        }
     }
 
 /* -------------------------------------------------------------------- */
@@ -776,6 +788,175 @@ CPLErr VRTSimpleSource::XMLInit( CPLXMLNode *psSrc, const char *pszVRTPath,
     return CE_None;
 }
 
+/************************************************************************/
+/*                             OpenSource()                             */
+/*                                                                      */
+/*      Create the proxy dataset whose creation has been deferred by    */
+/*      XMLInit().                                                      */
+/************************************************************************/
+
+void VRTSimpleSource::OpenSource() const
+{
+    CPLAssert( m_poRasterBand == nullptr && !m_osSrcDSName.empty() );
+
+    CPLString osUniqueHandle( CPLSPrintf("%p", m_pUniqueHandle) );
+    GDALProxyPoolDataset * const proxyDS =
+        new GDALProxyPoolDataset( m_osSrcDSName,
+                                  m_nSrcRasterXSize, m_nSrcRasterYSize,
+                                  GA_ReadOnly, m_bSrcDSShared,
+                                  nullptr, nullptr,
+                                  osUniqueHandle.c_str() );
+    proxyDS->SetOpenOptions(m_papszSrcOpenOptions);
+
+    // Only the information of rasterBand nSrcBand will be accurate
+    // but that's OK since we only use that band afterwards.
+    for( int i = 1; i <= m_nSrcBand; i++ )
+        proxyDS->AddSrcBandDescription(m_eSrcDataType,
+                                       m_nSrcBlockXSize, m_nSrcBlockYSize);
+
+    GDALRasterBand* poBand = proxyDS->GetRasterBand(m_nSrcBand);
+    if( poBand == nullptr )
+    {
+        proxyDS->ReleaseRef();
+        return;
+    }
+    if( m_bGetMaskBand )
+    {
+        GDALProxyPoolRasterBand *poMaskBand =
+            dynamic_cast<GDALProxyPoolRasterBand *>( poBand );
+        if( poMaskBand == nullptr )
+        {
+            CPLError(
+                CE_Fatal, CPLE_AssertionFailed, "dynamic_cast failed." );
+        }
+        else
+        {
+            poMaskBand->AddSrcMaskBandDescription(
+                m_eSrcDataType, m_nSrcBlockXSize, m_nSrcBlockYSize );
+        }
+        m_poMaskBandMainBand = poBand;
+        m_poRasterBand = poBand->GetMaskBand();
+    }
+    else
+    {
+        m_poRasterBand = poBand;
+    }
+}
+
+/************************************************************************/
+/*                     CanBeWrittenInSourcesCache()                     */
+/************************************************************************/
+
+bool VRTSimpleSource::CanBeWrittenInSourcesCache()
+{
+    // Only sources whose opening is deferred can be described by the
+    // content of the cache.
+    return typeid(*this) == typeid(VRTSimpleSource) &&
+           !m_osSrcDSName.empty() &&
+           m_papszSrcOpenOptions == nullptr;
+}
+
+/************************************************************************/
+/*                        WriteInSourcesCache()                         */
+/************************************************************************/
+
+void VRTSimpleSource::WriteInSourcesCache( CPLString& osBuffer )
+{
+    VRTSourcesCacheWriteString( osBuffer, m_osSrcDSName );
+    VRTSourcesCacheWriteString( osBuffer, m_osSourceFileNameOri );
+    VRTSourcesCacheWriteInt( osBuffer, m_bRelativeToVRTOri );
+    VRTSourcesCacheWriteInt( osBuffer, m_nExplicitSharedStatus );
+    VRTSourcesCacheWriteInt( osBuffer, m_nSrcBand );
+    VRTSourcesCacheWriteInt( osBuffer, m_bGetMaskBand ? 1 : 0 );
+    VRTSourcesCacheWriteInt( osBuffer, static_cast<int>(m_eSrcDataType) );
+    VRTSourcesCacheWriteInt( osBuffer, m_nSrcRasterXSize );
+    VRTSourcesCacheWriteInt( osBuffer, m_nSrcRasterYSize );
+    VRTSourcesCacheWriteInt( osBuffer, m_nSrcBlockXSize );
+    VRTSourcesCacheWriteInt( osBuffer, m_nSrcBlockYSize );
+    VRTSourcesCacheWriteDouble( osBuffer, m_dfSrcXOff );
+    VRTSourcesCacheWriteDouble( osBuffer, m_dfSrcYOff );
+    VRTSourcesCacheWriteDouble( osBuffer, m_dfSrcXSize );
+    VRTSourcesCacheWriteDouble( osBuffer, m_dfSrcYSize );
+    VRTSourcesCacheWriteDouble( osBuffer, m_dfDstXOff );
+    VRTSourcesCacheWriteDouble( osBuffer, m_dfDstYOff );
+    VRTSourcesCacheWriteDouble( osBuffer, m_dfDstXSize );
+    VRTSourcesCacheWriteDouble( osBuffer, m_dfDstYSize );
+    VRTSourcesCacheWriteInt( osBuffer, m_bNoDataSet );
+    VRTSourcesCacheWriteDouble( osBuffer, m_dfNoDataValue );
+    VRTSourcesCacheWriteString( osBuffer, m_osResampling );
+}
+
+/************************************************************************/
+/*                       ReadFromSourcesCache()                         */
+/*                                                                      */
+/*      Counterpart of WriteInSourcesCache(). The opening of the        */
+/*      source is deferred, as in XMLInit().                            */
+/************************************************************************/
+
+bool VRTSimpleSource::ReadFromSourcesCache( const GByte** ppabyData,
+                                            const GByte* pabyEnd,
+                                            void* pUniqueHandle )
+{
+    int nGetMaskBand = 0;
+    int nDataType = 0;
+    if( !VRTSourcesCacheReadString( ppabyData, pabyEnd, m_osSrcDSName ) ||
+        !VRTSourcesCacheReadString( ppabyData, pabyEnd,
+                                    m_osSourceFileNameOri ) ||
+        !VRTSourcesCacheReadInt( ppabyData, pabyEnd, &m_bRelativeToVRTOri ) ||
+        !VRTSourcesCacheReadInt( ppabyData, pabyEnd,
+                                 &m_nExplicitSharedStatus ) ||
+        !VRTSourcesCacheReadInt( ppabyData, pabyEnd, &m_nSrcBand ) ||
+        !VRTSourcesCacheReadInt( ppabyData, pabyEnd, &nGetMaskBand ) ||
+        !VRTSourcesCacheReadInt( ppabyData, pabyEnd, &nDataType ) ||
+        !VRTSourcesCacheReadInt( ppabyData, pabyEnd, &m_nSrcRasterXSize ) ||
+        !VRTSourcesCacheReadInt( ppabyData, pabyEnd, &m_nSrcRasterYSize ) ||
+        !VRTSourcesCacheReadInt( ppabyData, pabyEnd, &m_nSrcBlockXSize ) ||
+        !VRTSourcesCacheReadInt( ppabyData, pabyEnd, &m_nSrcBlockYSize ) ||
+        !VRTSourcesCacheReadDouble( ppabyData, pabyEnd, &m_dfSrcXOff ) ||
+        !VRTSourcesCacheReadDouble( ppabyData, pabyEnd, &m_dfSrcYOff ) ||
+        !VRTSourcesCacheReadDouble( ppabyData, pabyEnd, &m_dfSrcXSize ) ||
+        !VRTSourcesCacheReadDouble( ppabyData, pabyEnd, &m_dfSrcYSize ) ||
+        !VRTSourcesCacheReadDouble( ppabyData, pabyEnd, &m_dfDstXOff ) ||
+        !VRTSourcesCacheReadDouble( ppabyData, pabyEnd, &m_dfDstYOff ) ||
+        !VRTSourcesCacheReadDouble( ppabyData, pabyEnd, &m_dfDstXSize ) ||
+        !VRTSourcesCacheReadDouble( ppabyData, pabyEnd, &m_dfDstYSize ) ||
+        !VRTSourcesCacheReadInt( ppabyData, pabyEnd, &m_bNoDataSet ) ||
+        !VRTSourcesCacheReadDouble( ppabyData, pabyEnd, &m_dfNoDataValue ) ||
+        !VRTSourcesCacheReadString( ppabyData, pabyEnd, m_osResampling ) )
+    {
+        return false;
+    }
+
+    if( m_osSrcDSName.empty() ||
+        !GDALCheckBandCount(m_nSrcBand, 0) ||
+        nDataType <= GDT_Unknown || nDataType >= GDT_TypeCount ||
+        m_nSrcRasterXSize <= 0 || m_nSrcRasterYSize <= 0 ||
+        m_nSrcBlockXSize <= 0 || m_nSrcBlockYSize <= 0 )
+    {
+        return false;
+    }
+    m_bGetMaskBand = nGetMaskBand != 0;
+    m_eSrcDataType = static_cast<GDALDataType>(nDataType);
+
+    // Same logic as in XMLInit(), since the VRT_SHARED_SOURCE
+    // configuration option may have changed since the cache was written.
+    const char* pszShared = nullptr;
+    if( m_nExplicitSharedStatus < 0 )
+        pszShared = CPLGetConfigOption("VRT_SHARED_SOURCE", nullptr);
+    if( pszShared != nullptr )
+    {
+        m_bSrcDSShared = CPLTestBool(pszShared);
+        m_nExplicitSharedStatus = m_bSrcDSShared;
+    }
+    else
+    {
+        m_bSrcDSShared = m_nExplicitSharedStatus != 0;
+    }
+    m_pUniqueHandle = pUniqueHandle;
+
+    return true;
+}
+
 /************************************************************************/
 /*                             GetFileList()                            */
 /************************************************************************/
@@ -783,9 +964,8 @@ CPLErr VRTSimpleSource::XMLInit( CPLXMLNode *psSrc, const char *pszVRTPath,
 void VRTSimpleSource::GetFileList( char*** ppapszFileList, int *pnSize,
                                    int *pnMaxSize, CPLHashSet* hSetFiles )
 {
-    const char* pszFilename = nullptr;
-    if( m_poRasterBand != nullptr && m_poRasterBand->GetDataset() != nullptr &&
-        (pszFilename = m_poRasterBand->GetDataset()->GetDescription()) != nullptr )
+    const char* pszFilename = GetSourceDatasetName();
+    if( pszFilename != nullptr )
     {
 /* -------------------------------------------------------------------- */
 /*      Is the filename even a real filesystem object?                  */
@@ -836,7 +1016,48 @@ void VRTSimpleSource::GetFileList( char*** ppapszFileList, int *pnSize,
 
 GDALRasterBand* VRTSimpleSource::GetBand()
 {
-    return m_poMaskBandMainBand ? nullptr : m_poRasterBand;
+    GDALRasterBand* poBand = GetRasterBand();
+    return m_poMaskBandMainBand ? nullptr : poBand;
+}
+
+/************************************************************************/
+/*                        GetSourceDatasetName()                        */
+/*                                                                      */
+/*      Does not require the source to be opened.                       */
+/************************************************************************/
+
+const char* VRTSimpleSource::GetSourceDatasetName()
+{
+    if( m_poRasterBand == nullptr && !m_osSrcDSName.empty() )
+        return m_osSrcDSName.c_str();
+    if( m_poRasterBand != nullptr && m_poRasterBand->GetDataset() != nullptr )
+        return m_poRasterBand->GetDataset()->GetDescription();
+    return nullptr;
+}
+
+/************************************************************************/
+/*                        IsSourceDatasetBand()                         */
+/*                                                                      */
+/*      Returns TRUE if the source is the nBand-th band of its          */
+/*      dataset (and not a mask band). Does not require the source      */
+/*      to be opened.                                                   */
+/************************************************************************/
+
+int VRTSimpleSource::IsSourceDatasetBand( int nBand )
+{
+    if( m_poRasterBand == nullptr && !m_osSrcDSName.empty() )
+        return !m_bGetMaskBand && m_nSrcBand == nBand;
+
+    GDALRasterBand *srcband = GetBand();
+    if( srcband == nullptr )
+        return FALSE;
+    if( srcband->GetDataset() == nullptr )
+        return FALSE;
+    if( srcband->GetDataset()->GetRasterCount() < nBand )
+        return FALSE;
+    if( srcband->GetDataset()->GetRasterBand(nBand) != srcband )
+        return FALSE;
+    return TRUE;
 }
 
 /************************************************************************/
@@ -855,11 +1076,10 @@ int VRTSimpleSource::IsSameExceptBandNumber( VRTSimpleSource* poOtherSource )
            m_dfDstYSize == poOtherSource->m_dfDstYSize &&
            m_bNoDataSet == poOtherSource->m_bNoDataSet &&
            m_dfNoDataValue == poOtherSource->m_dfNoDataValue &&
-           GetBand() != nullptr && poOtherSource->GetBand() != nullptr &&
-           GetBand()->GetDataset() != nullptr &&
-           poOtherSource->GetBand()->GetDataset() != nullptr &&
-           EQUAL(GetBand()->GetDataset()->GetDescription(),
-                 poOtherSource->GetBand()->GetDataset()->GetDescription());
+           GetSourceDatasetName() != nullptr &&
+           poOtherSource->GetSourceDatasetName() != nullptr &&
+           EQUAL(GetSourceDatasetName(),
+                 poOtherSource->GetSourceDatasetName());
 }
 
 /************************************************************************/
@@ -1049,26 +1269,26 @@ VRTSimpleSource::GetSrcDstWindow( int nXOff, int nYOff, int nXSize, int nYSize,
         *pnReqYSize = 1;
 
     if( *pnReqXSize > INT_MAX - *pnReqXOff ||
-        *pnReqXOff + *pnReqXSize > m_poRasterBand->GetXSize() )
+        *pnReqXOff + *pnReqXSize > GetRasterBand()->GetXSize() )
     {
-        *pnReqXSize = m_poRasterBand->GetXSize() - *pnReqXOff;
+        *pnReqXSize = GetRasterBand()->GetXSize() - *pnReqXOff;
         bModifiedX = true;
     }
-    if( *pdfReqXOff + *pdfReqXSize > m_poRasterBand->GetXSize() )
+    if( *pdfReqXOff + *pdfReqXSize > GetRasterBand()->GetXSize() )
     {
-        *pdfReqXSize = m_poRasterBand->GetXSize() - *pdfReqXOff;
+        *pdfReqXSize = GetRasterBand()->GetXSize() - *pdfReqXOff;
         bModifiedX = true;
     }
 
     if( *pnReqYSize > INT_MAX - *pnReqYOff ||
-        *pnReqYOff + *pnReqYSize > m_poRasterBand->GetYSize() )
+        *pnReqYOff + *pnReqYSize > GetRasterBand()->GetYSize() )
     {
-        *pnReqYSize = m_poRasterBand->GetYSize() - *pnReqYOff;
+        *pnReqYSize = GetRasterBand()->GetYSize() - *pnReqYOff;
         bModifiedY = true;
     }
-    if( *pdfReqYOff + *pdfReqYSize > m_poRasterBand->GetYSize() )
+    if( *pdfReqYOff + *pdfReqYSize > GetRasterBand()->GetYSize() )
     {
-        *pdfReqYSize = m_poRasterBand->GetYSize() - *pdfReqYOff;
+        *pdfReqYSize = GetRasterBand()->GetYSize() - *pdfReqYOff;
         bModifiedY = true;
     }
 
@@ -1076,8 +1296,8 @@ VRTSimpleSource::GetSrcDstWindow( int nXOff, int nYOff, int nXSize, int nYSize,
 /*      Don't do anything if the requesting region is completely off    */
 /*      the source image.                                               */
 /* -------------------------------------------------------------------- */
-    if( *pnReqXOff >= m_poRasterBand->GetXSize()
-        || *pnReqYOff >= m_poRasterBand->GetYSize()
+    if( *pnReqXOff >= GetRasterBand()->GetXSize()
+        || *pnReqYOff >= GetRasterBand()->GetYSize()
         || *pnReqXSize <= 0 || *pnReqYSize <= 0 )
     {
         return FALSE;
@@ -1175,7 +1395,7 @@ int VRTSimpleSource::NeedMaxValAdjustment() const
         return FALSE;
 
     const char* pszNBITS =
-        m_poRasterBand->GetMetadataItem("NBITS", "IMAGE_STRUCTURE");
+        GetRasterBand()->GetMetadataItem("NBITS", "IMAGE_STRUCTURE");
     const int nBits = (pszNBITS) ? atoi(pszNBITS) : 0;
     if( nBits >= 1 && nBits <= 31 )
     {
@@ -1263,7 +1483,7 @@ VRTSimpleSource::RasterIO( int nXOff, int nYOff, int nXSize, int nYSize,
         + static_cast<GPtrDiff_t>(nOutYOff) * nLineSpace;
 
     const CPLErr eErr =
-        m_poRasterBand->RasterIO(
+        GetRasterBand()->RasterIO(
             GF_Read,
             nReqXOff, nReqYOff, nReqXSize, nReqYSize,
             pabyOut,
@@ -1322,14 +1542,14 @@ double VRTSimpleSource::GetMinimum( int nXSize, int nYSize, int *pbSuccess )
                           &nReqXOff, &nReqYOff, &nReqXSize, &nReqYSize,
                           &nOutXOff, &nOutYOff, &nOutXSize, &nOutYSize ) ||
         nReqXOff != 0 || nReqYOff != 0 ||
-        nReqXSize != m_poRasterBand->GetXSize() ||
-        nReqYSize != m_poRasterBand->GetYSize())
+        nReqXSize != GetRasterBand()->GetXSize() ||
+        nReqYSize != GetRasterBand()->GetYSize())
     {
         *pbSuccess = FALSE;
         return 0;
     }
 
-    const double dfVal = m_poRasterBand->GetMinimum(pbSuccess);
+    const double dfVal = GetRasterBand()->GetMinimum(pbSuccess);
     if( NeedMaxValAdjustment() && dfVal > m_nMaxValue )
         return m_nMaxValue;
     return dfVal;
@@ -1363,14 +1583,14 @@ double VRTSimpleSource::GetMaximum( int nXSize, int nYSize, int *pbSuccess )
                           &nReqXOff, &nReqYOff, &nReqXSize, &nReqYSize,
                           &nOutXOff, &nOutYOff, &nOutXSize, &nOutYSize ) ||
         nReqXOff != 0 || nReqYOff != 0 ||
-        nReqXSize != m_poRasterBand->GetXSize() ||
-        nReqYSize != m_poRasterBand->GetYSize())
+        nReqXSize != GetRasterBand()->GetXSize() ||
+        nReqYSize != GetRasterBand()->GetYSize())
     {
         *pbSuccess = FALSE;
         return 0;
     }
 
-    const double dfVal = m_poRasterBand->GetMaximum(pbSuccess);
+    const double dfVal = GetRasterBand()->GetMaximum(pbSuccess);
     if( NeedMaxValAdjustment() && dfVal > m_nMaxValue )
         return m_nMaxValue;
     return dfVal;
@@ -1405,14 +1625,14 @@ CPLErr VRTSimpleSource::ComputeRasterMinMax( int nXSize, int nYSize,
                           &nReqXOff, &nReqYOff, &nReqXSize, &nReqYSize,
                           &nOutXOff, &nOutYOff, &nOutXSize, &nOutYSize ) ||
         nReqXOff != 0 || nReqYOff != 0 ||
-        nReqXSize != m_poRasterBand->GetXSize() ||
-        nReqYSize != m_poRasterBand->GetYSize())
+        nReqXSize != GetRasterBand()->GetXSize() ||
+        nReqYSize != GetRasterBand()->GetYSize())
     {
         return CE_Failure;
     }
 
     const CPLErr eErr =
-        m_poRasterBand->ComputeRasterMinMax( bApproxOK, adfMinMax );
+        GetRasterBand()->ComputeRasterMinMax( bApproxOK, adfMinMax );
     if( NeedMaxValAdjustment() )
     {
         if( adfMinMax[0] > m_nMaxValue )
@@ -1457,13 +1677,13 @@ CPLErr VRTSimpleSource::ComputeStatistics(
                           &nReqXOff, &nReqYOff, &nReqXSize, &nReqYSize,
                           &nOutXOff, &nOutYOff, &nOutXSize, &nOutYSize ) ||
         nReqXOff != 0 || nReqYOff != 0 ||
-        nReqXSize != m_poRasterBand->GetXSize() ||
-        nReqYSize != m_poRasterBand->GetYSize())
+        nReqXSize != GetRasterBand()->GetXSize() ||
+        nReqYSize != GetRasterBand()->GetYSize())
     {
         return CE_Failure;
     }
 
-    return m_poRasterBand->ComputeStatistics( bApproxOK, pdfMin, pdfMax,
+    return GetRasterBand()->ComputeStatistics( bApproxOK, pdfMin, pdfMax,
                                               pdfMean, pdfStdDev,
                                               pfnProgress, pProgressData );
 }
@@ -1502,13 +1722,13 @@ CPLErr VRTSimpleSource::GetHistogram(
                           &nReqXOff, &nReqYOff, &nReqXSize, &nReqYSize,
                           &nOutXOff, &nOutYOff, &nOutXSize, &nOutYSize ) ||
         nReqXOff != 0 || nReqYOff != 0 ||
-        nReqXSize != m_poRasterBand->GetXSize() ||
-        nReqYSize != m_poRasterBand->GetYSize())
+        nReqXSize != GetRasterBand()->GetXSize() ||
+        nReqYSize != GetRasterBand()->GetYSize())
     {
         return CE_Failure;
     }
 
-    return m_poRasterBand->GetHistogram( dfMin, dfMax, nBuckets,
+    return GetRasterBand()->GetHistogram( dfMin, dfMax, nBuckets,
                                          panHistogram,
                                          bIncludeOutOfRange, bApproxOK,
                                          pfnProgress, pProgressData );
@@ -1563,7 +1783,7 @@ CPLErr VRTSimpleSource::DatasetRasterIO(
         return CE_None;
     }
 
-    GDALDataset* poDS = m_poRasterBand->GetDataset();
+    GDALDataset* poDS = GetRasterBand()->GetDataset();
     if( poDS == nullptr )
         return CE_Failure;
 
@@ -1734,7 +1954,7 @@ VRTAveragedSource::RasterIO( int nXOff, int nYOff, int nXSize, int nYSize,
     psExtraArg->dfYSize = dfReqYSize;
 
     const CPLErr eErr =
-        m_poRasterBand->RasterIO( GF_Read,
+        GetRasterBand()->RasterIO( GF_Read,
                                   nReqXOff, nReqYOff, nReqXSize, nReqYSize,
                                   pafSrc, nReqXSize, nReqYSize, GDT_Float32,
                                   0, 0, psExtraArg );
@@ -2255,6 +2475,21 @@ VRTComplexSource::LookupValue( double dfInput )
           (m_padfLUTInputs[i] - m_padfLUTInputs[i - 1]) );
 }
 
+/************************************************************************/
+/*                     CanBeWrittenInSourcesCache()                     */
+/************************************************************************/
+
+bool VRTComplexSource::CanBeWrittenInSourcesCache()
+{
+    // Of the complex parameters, only NODATA is saved in the cache.
+    return typeid(*this) == typeid(VRTComplexSource) &&
+           !m_osSrcDSName.empty() &&
+           m_papszSrcOpenOptions == nullptr &&
+           m_eScalingType == VRT_SCALING_NONE &&
+           m_nLUTItemCount == 0 &&
+           m_nColorTableComponent == 0;
+}
+
 /************************************************************************/
 /*                         SetLinearScaling()                           */
 /************************************************************************/
@@ -2446,7 +2681,7 @@ CPLErr VRTComplexSource::RasterIOInternal( int nReqXOff, int nReqYOff,
         }
 
         const CPLErr eErr =
-            m_poRasterBand->RasterIO( GF_Read,
+            GetRasterBand()->RasterIO( GF_Read,
                                       nReqXOff, nReqYOff,
                                       nReqXSize, nReqYSize,
                                       pafData,
@@ -2467,7 +2702,7 @@ CPLErr VRTComplexSource::RasterIOInternal( int nReqXOff, int nReqYOff,
 
         if( m_nColorTableComponent != 0 )
         {
-            poColorTable = m_poRasterBand->GetColorTable();
+            poColorTable = GetRasterBand()->GetColorTable();
             if( poColorTable == nullptr )
             {
                 CPLError( CE_Failure, CPLE_AppDefined,
@@ -2542,10 +2777,10 @@ CPLErr VRTComplexSource::RasterIOInternal( int nReqXOff, int nReqYOff,
                         int bSuccessMin = FALSE;
                         int bSuccessMax = FALSE;
                         double adfMinMax[2] = {
-                            m_poRasterBand->GetMinimum(&bSuccessMin),
-                            m_poRasterBand->GetMaximum(&bSuccessMax) };
+                            GetRasterBand()->GetMinimum(&bSuccessMin),
+                            GetRasterBand()->GetMaximum(&bSuccessMax) };
                         if( (bSuccessMin && bSuccessMax) ||
-                            m_poRasterBand->ComputeRasterMinMax( TRUE,
+                            GetRasterBand()->ComputeRasterMinMax( TRUE,
                                                                  adfMinMax )
                             == CE_None )
                         {
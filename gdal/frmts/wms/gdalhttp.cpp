@@ -30,6 +30,7 @@
  ****************************************************************************/
 
 #include "wmsdriver.h"
+#include "cpl_multiproc.h"
 #include <algorithm>
 
 CPL_CVSID("$Id$")
@@ -112,7 +113,7 @@ WMSHTTPRequest::~WMSHTTPRequest() {
 // Like CPLHTTPFetch, but multiple requests in parallel
 // By default it uses 5 connections
 //
-CPLErr WMSHTTPFetchMulti(WMSHTTPRequest *pasRequest, int nRequestCount) {
+static CPLErr WMSHTTPFetchMultiInternal(WMSHTTPRequest **papsRequest, int nRequestCount) {
     CPLErr ret = CE_None;
     CURLM *curl_multi = nullptr;
     int still_running;
@@ -123,28 +124,28 @@ CPLErr WMSHTTPFetchMulti(WMSHTTPRequest *pasRequest, int nRequestCount) {
     if (nRequestCount == 0)
         return CE_None;
 
-    const char *max_conn_opt = CSLFetchNameValue(const_cast<char **>(pasRequest->options), "MAXCONN");
+    const char *max_conn_opt = CSLFetchNameValue(const_cast<char **>(papsRequest[0]->options), "MAXCONN");
     max_conn = (max_conn_opt == nullptr) ? 5 : MAX(1, MIN(atoi(max_conn_opt), 1000));
 
     // If the first url starts with vsimem, assume all do and defer to CPLHTTPFetch
-    if( STARTS_WITH(pasRequest[0].URL.c_str(), "/vsimem/") &&
+    if( STARTS_WITH(papsRequest[0]->URL.c_str(), "/vsimem/") &&
         /* Disabled by default for potential security issues */
         CPLTestBool(CPLGetConfigOption("CPL_CURL_ENABLE_VSIMEM", "FALSE")) )
     {
         for(i = 0; i< nRequestCount;i++)
         {
-            CPLHTTPResult* psResult = CPLHTTPFetch(pasRequest[i].URL.c_str(),
-                                                    const_cast<char**>(pasRequest[i].options));
-            pasRequest[i].pabyData = psResult->pabyData;
-            pasRequest[i].nDataLen = psResult->nDataLen;
-            pasRequest[i].Error = psResult->pszErrBuf ? psResult->pszErrBuf : "";
+            CPLHTTPResult* psResult = CPLHTTPFetch(papsRequest[i]->URL.c_str(),
+                                                    const_cast<char**>(papsRequest[i]->options));
+            papsRequest[i]->pabyData = psResult->pabyData;
+            papsRequest[i]->nDataLen = psResult->nDataLen;
+            papsRequest[i]->Error = psResult->pszErrBuf ? psResult->pszErrBuf : "";
             // Conventions are different between this module and cpl_http...
             if( psResult->pszErrBuf != nullptr &&
                 strcmp(psResult->pszErrBuf, "HTTP error code : 404") == 0 )
-                pasRequest[i].nStatus = 404;
+                papsRequest[i]->nStatus = 404;
             else
-                pasRequest[i].nStatus = 200;
-            pasRequest[i].ContentType = psResult->pszContentType ? psResult->pszContentType : "";
+                papsRequest[i]->nStatus = 200;
+            papsRequest[i]->ContentType = psResult->pszContentType ? psResult->pszContentType : "";
             // took ownership of content, we're done with the rest
             psResult->pabyData = nullptr;
             psResult->nDataLen = 0;
@@ -160,9 +161,9 @@ CPLErr WMSHTTPFetchMulti(WMSHTTPRequest *pasRequest, int nRequestCount) {
 
     // add at most max_conn requests
     for (conn_i = 0; conn_i < std::min(nRequestCount, max_conn); ++conn_i) {
-        WMSHTTPRequest *const psRequest = &pasRequest[conn_i];
+        WMSHTTPRequest *const psRequest = papsRequest[conn_i];
         CPLDebug("HTTP", "Requesting [%d/%d] %s", conn_i + 1, nRequestCount,
-            pasRequest[conn_i].URL.c_str());
+            papsRequest[conn_i]->URL.c_str());
         curl_multi_add_handle(curl_multi, psRequest->m_curl_handle);
     }
 
@@ -182,9 +183,9 @@ CPLErr WMSHTTPFetchMulti(WMSHTTPRequest *pasRequest, int nRequestCount) {
                 if (msg->msg == CURLMSG_DONE) {
                     // transfer completed, add more handles if available
                     if (conn_i < nRequestCount) {
-                        WMSHTTPRequest *const psRequest = &pasRequest[conn_i];
+                        WMSHTTPRequest *const psRequest = papsRequest[conn_i];
                         CPLDebug("HTTP", "Requesting [%d/%d] %s", conn_i + 1,
-                                    nRequestCount, pasRequest[conn_i].URL.c_str());
+                                    nRequestCount, papsRequest[conn_i]->URL.c_str());
                         curl_multi_add_handle(curl_multi, psRequest->m_curl_handle);
                         ++conn_i;
                     }
@@ -231,7 +232,7 @@ CPLErr WMSHTTPFetchMulti(WMSHTTPRequest *pasRequest, int nRequestCount) {
     }
 
     for (i = 0; i < nRequestCount; ++i) {
-        WMSHTTPRequest *const psRequest = &pasRequest[i];
+        WMSHTTPRequest *const psRequest = papsRequest[i];
 
         long response_code;
         curl_easy_getinfo(psRequest->m_curl_handle, CURLINFO_RESPONSE_CODE, &response_code);
@@ -262,10 +263,186 @@ CPLErr WMSHTTPFetchMulti(WMSHTTPRequest *pasRequest, int nRequestCount) {
                  !psRequest->ContentType.empty() ? psRequest->ContentType.c_str() : "(null)",
                  !psRequest->Error.empty() ? psRequest->Error.c_str() : "(null)");
 
-        curl_multi_remove_handle(curl_multi, pasRequest->m_curl_handle);
+        curl_multi_remove_handle(curl_multi, psRequest->m_curl_handle);
     }
 
     curl_multi_cleanup(curl_multi);
 
     return ret;
 }
+
+/************************************************************************/
+/*                      Table of in-flight requests                     */
+/************************************************************************/
+
+// Identical requests issued concurrently, by several threads or datasets
+// reading the same tiles, are only sent once. The thread that registers a
+// request first fetches it, the others wait for it to publish its result.
+
+namespace {
+struct WMSInFlightRequest {
+    WMSInFlightRequest() : bDone(false), nWaiters(0), nStatus(0) {}
+
+    bool bDone;
+    int nWaiters;
+    int nStatus;
+    CPLString ContentType;
+    CPLString Error;
+    std::vector<GByte> abyData;
+};
+}
+
+static CPLMutex *hInFlightMutex = nullptr;
+static CPLCond *hInFlightCond = nullptr;
+static std::map<CPLString, WMSInFlightRequest> oMapInFlight;
+
+// Configuration options read by CPLHTTPSetOptions() that select the
+// credentials, headers or route of a request, and thus its response.
+static const char * const apszResponseConfigOptions[] = {
+    "GDAL_HTTP_AUTH", "GDAL_HTTP_USERPWD", "GDAL_HTTP_NETRC",
+    "GDAL_HTTP_PROXY", "GDAL_HTTP_PROXYUSERPWD", "GDAL_PROXY_AUTH",
+    "GDAL_HTTP_COOKIE", "GDAL_HTTP_HEADER_FILE", "GDAL_HTTP_USERAGENT",
+    "GDAL_HTTP_UNSAFESSL", "CURL_CA_BUNDLE", "SSL_CERT_FILE"
+};
+
+// Requests are only coalesced if they have the same URL and range, and are
+// sent with the same options (USERPWD, HEADERS, COOKIE...), since those may
+// change the response. MAXCONN only limits the parallelism of the caller.
+static CPLString WMSHTTPGetRequestKey(const WMSHTTPRequest *psRequest) {
+    CPLString osKey(psRequest->URL);
+    osKey += "\nrange=";
+    osKey += psRequest->Range;
+    for (const char *const *papszIter = psRequest->options;
+         papszIter != nullptr && *papszIter != nullptr; ++papszIter) {
+        if (STARTS_WITH_CI(*papszIter, "MAXCONN="))
+            continue;
+        osKey += "\n";
+        osKey += *papszIter;
+    }
+    for (size_t i = 0; i < CPL_ARRAYSIZE(apszResponseConfigOptions); ++i) {
+        const char *pszVal =
+            CPLGetConfigOption(apszResponseConfigOptions[i], nullptr);
+        if (pszVal != nullptr)
+            osKey += CPLSPrintf("\n%s=%s", apszResponseConfigOptions[i], pszVal);
+    }
+    return osKey;
+}
+
+CPLErr WMSHTTPFetchMulti(WMSHTTPRequest *pasRequest, int nRequestCount) {
+    CPLAssert(nRequestCount >= 0);
+    if (nRequestCount == 0)
+        return CE_None;
+
+    std::vector<WMSHTTPRequest *> apsOwned;
+    std::vector<WMSHTTPRequest *> apsWaiting;
+    const bool bCoalesce = CPLTestBool(
+        CPLGetConfigOption("GDAL_WMS_COALESCE_REQUESTS", "YES"));
+    if (!bCoalesce) {
+        for (int i = 0; i < nRequestCount; ++i)
+            apsOwned.push_back(&pasRequest[i]);
+        return WMSHTTPFetchMultiInternal(&apsOwned[0], nRequestCount);
+    }
+
+    {
+        CPLMutexHolderD(&hInFlightMutex);
+        if (hInFlightCond == nullptr)
+            hInFlightCond = CPLCreateCond();
+        for (int i = 0; i < nRequestCount; ++i) {
+            const CPLString osKey(WMSHTTPGetRequestKey(&pasRequest[i]));
+            std::map<CPLString, WMSInFlightRequest>::iterator oIter =
+                oMapInFlight.find(osKey);
+            if (oIter != oMapInFlight.end()) {
+                oIter->second.nWaiters++;
+                apsWaiting.push_back(&pasRequest[i]);
+            } else {
+                oMapInFlight[osKey] = WMSInFlightRequest();
+                apsOwned.push_back(&pasRequest[i]);
+            }
+        }
+    }
+
+    CPLErr ret = CE_None;
+    if (!apsOwned.empty())
+        ret = WMSHTTPFetchMultiInternal(&apsOwned[0],
+                                        static_cast<int>(apsOwned.size()));
+
+    // Publish our results before waiting for the ones of other threads, so
+    // that two threads waiting for each other cannot dead-lock.
+    {
+        CPLMutexHolderD(&hInFlightMutex);
+        for (size_t i = 0; i < apsOwned.size(); ++i) {
+            const WMSHTTPRequest *psRequest = apsOwned[i];
+            std::map<CPLString, WMSInFlightRequest>::iterator oIter =
+                oMapInFlight.find(WMSHTTPGetRequestKey(psRequest));
+            if (oIter == oMapInFlight.end())
+                continue;
+            WMSInFlightRequest &oEntry = oIter->second;
+            if (oEntry.nWaiters == 0) {
+                oMapInFlight.erase(oIter);
+                continue;
+            }
+            oEntry.nStatus = psRequest->nStatus;
+            oEntry.ContentType = psRequest->ContentType;
+            oEntry.Error = psRequest->Error;
+            if (psRequest->pabyData != nullptr)
+                oEntry.abyData.assign(psRequest->pabyData,
+                                      psRequest->pabyData + psRequest->nDataLen);
+            oEntry.bDone = true;
+        }
+        if (!apsOwned.empty())
+            CPLCondBroadcast(hInFlightCond);
+    }
+
+    if (apsWaiting.empty())
+        return ret;
+
+    CPLMutexHolderD(&hInFlightMutex);
+    for (size_t i = 0; i < apsWaiting.size(); ++i) {
+        WMSHTTPRequest *psRequest = apsWaiting[i];
+        const CPLString osKey(WMSHTTPGetRequestKey(psRequest));
+        std::map<CPLString, WMSInFlightRequest>::iterator oIter;
+        while (true) {
+            oIter = oMapInFlight.find(osKey);
+            if (oIter == oMapInFlight.end() || oIter->second.bDone)
+                break;
+            CPLCondWait(hInFlightCond, hInFlightMutex);
+        }
+        if (oIter == oMapInFlight.end()) { // Should not happen
+            psRequest->nStatus = 0;
+            psRequest->Error = "Coalesced request vanished";
+            continue;
+        }
+        WMSInFlightRequest &oEntry = oIter->second;
+        CPLDebug("HTTP", "Reusing result of in-flight request %s",
+                 psRequest->URL.c_str());
+        psRequest->nStatus = oEntry.nStatus;
+        psRequest->ContentType = oEntry.ContentType;
+        psRequest->Error = oEntry.Error;
+        if (!oEntry.abyData.empty()) {
+            const size_t nSize = oEntry.abyData.size();
+            psRequest->pabyData = static_cast<GByte *>(VSIMalloc(nSize + 1));
+            if (psRequest->pabyData != nullptr) {
+                memcpy(psRequest->pabyData, &oEntry.abyData[0], nSize);
+                psRequest->pabyData[nSize] = 0;
+                psRequest->nDataLen = nSize;
+                psRequest->nDataAlloc = nSize + 1;
+            } else {
+                psRequest->nStatus = 0;
+                psRequest->Error = "Out of memory";
+            }
+        }
+        if (--oEntry.nWaiters == 0)
+            oMapInFlight.erase(oIter);
+    }
+
+    return ret;
+}
+
+void WMSHTTPCleanup() {
+    if (hInFlightCond != nullptr)
+        CPLDestroyCond(hInFlightCond);
+    hInFlightCond = nullptr;
+    if (hInFlightMutex != nullptr)
+        CPLDestroyMutex(hInFlightMutex);
+    hInFlightMutex = nullptr;
+}
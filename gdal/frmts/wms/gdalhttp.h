@@ -66,6 +66,10 @@ struct WMSHTTPRequest {
 
 // Not public, only for use within WMS
 void WMSHTTPInitializeRequest(WMSHTTPRequest *psRequest);
+// Identical requests (same URL, range and options) already in flight in another
+// thread are not sent again, their result is shared (unless
+// GDAL_WMS_COALESCE_REQUESTS=NO)
 CPLErr WMSHTTPFetchMulti(WMSHTTPRequest *psRequest, int nRequestCount = 1);
+void WMSHTTPCleanup();
 
 #endif /*  GDALHTTP_H */
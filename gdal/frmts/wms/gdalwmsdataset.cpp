@@ -62,6 +62,7 @@ GDALWMSDataset::GDALWMSDataset() :
     m_verify_advise_read(0),
     m_offline_mode(0),
     m_http_max_conn(0),
+    m_read_ahead(0),
     m_http_timeout(0),
     m_http_options(nullptr),
     m_tileOO(nullptr),
@@ -160,10 +161,17 @@ CPLErr GDALWMSDataset::Initialize(CPLXMLNode *config, char **l_papszOpenOptions)
             m_http_max_conn = atoi(max_conn);
         }
         else {
-            m_http_max_conn = 2;
+            m_http_max_conn = atoi(CPLGetConfigOption("GDAL_WMS_MAX_CONNECTIONS", "2"));
         }
     }
 
+    if (ret == CE_None) {
+        const char *read_ahead = CPLGetXMLValue(config, "ReadAhead", "");
+        if (read_ahead[0] == '\0')
+            read_ahead = CPLGetConfigOption("GDAL_WMS_READ_AHEAD", "0");
+        m_read_ahead = MAX(0, MIN(atoi(read_ahead), 16));
+    }
+
     if (ret == CE_None) {
         const char *timeout = CPLGetXMLValue(config, "Timeout", "");
         if (timeout[0] != '\0') {
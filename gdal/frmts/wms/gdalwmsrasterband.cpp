@@ -275,6 +275,15 @@ CPLErr GDALWMSRasterBand::IReadBlock(int x, int y, void *buffer) {
             by1 = tby1;
         }
     }
+    else if (m_parent_dataset->m_read_ahead > 0 && !m_parent_dataset->m_offline_mode) {
+        // Isolated block read, also fetch the neighbouring blocks in the same
+        // batch of requests. They end up in the block cache.
+        const int n = m_parent_dataset->m_read_ahead;
+        bx0 = MAX(0, x - n);
+        by0 = MAX(0, y - n);
+        bx1 = MIN(nBlocksPerRow - 1, x + n);
+        by1 = MIN(nBlocksPerColumn - 1, y + n);
+    }
 
     CPLErr eErr = ReadBlocks(x, y, buffer, bx0, by0, bx1, by1, 0);
 
@@ -421,6 +421,8 @@ protected:
     int m_verify_advise_read;
     int m_offline_mode;
     int m_http_max_conn;
+    // Number of neighbouring blocks fetched with a block read outside of RasterIO()
+    int m_read_ahead;
     int m_http_timeout;
     char **m_http_options;
     // Open Option list for tiles
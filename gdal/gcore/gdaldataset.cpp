@@ -41,6 +41,7 @@
 #include <new>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -4679,13 +4680,49 @@ OGRLayer *GDALDataset::GetLayerByName( const char *pszName )
 }
 
 //! @cond Doxygen_Suppress
+/************************************************************************/
+/*                      GDALSQLGetIndexFields()                         */
+/*                                                                      */
+/*      Resolve the comma separated list of field names that follows    */
+/*      USING in CREATE INDEX and DROP INDEX statements.                */
+/************************************************************************/
+
+static bool GDALSQLGetIndexFields( OGRLayer *poLayer, char **papszTokens,
+                                   int iFirstToken,
+                                   std::vector<int>& anFields )
+{
+    CPLString osFieldList;
+    for( int i = iFirstToken; papszTokens[i] != nullptr; i++ )
+    {
+        if( !osFieldList.empty() )
+            osFieldList += " ";
+        osFieldList += papszTokens[i];
+    }
+
+    char **papszFields =
+        CSLTokenizeString2(osFieldList, ",",
+                           CSLT_STRIPLEADSPACES | CSLT_STRIPENDSPACES);
+    bool bOK = CSLCount(papszFields) > 0;
+    for( int i = 0; bOK && papszFields[i] != nullptr; i++ )
+    {
+        const int iField =
+            poLayer->GetLayerDefn()->GetFieldIndex(papszFields[i]);
+        if( iField < 0 )
+            bOK = false;
+        anFields.push_back(iField);
+    }
+    CSLDestroy(papszFields);
+
+    return bOK;
+}
+
 /************************************************************************/
 /*                       ProcessSQLCreateIndex()                        */
 /*                                                                      */
 /*      The correct syntax for creating an index in our dialect of      */
 /*      SQL is:                                                         */
 /*                                                                      */
-/*        CREATE INDEX ON <layername> USING <columnname>                */
+/*        CREATE INDEX ON <layername> USING <columnname>[,<columnname>] */
 /************************************************************************/
 
 OGRErr GDALDataset::ProcessSQLCreateIndex( const char *pszSQLCommand )
@@ -4696,7 +4733,7 @@ OGRErr GDALDataset::ProcessSQLCreateIndex( const char *pszSQLCommand )
 /* -------------------------------------------------------------------- */
 /*      Do some general syntax checking.                                */
 /* -------------------------------------------------------------------- */
-    if( CSLCount(papszTokens) != 6
+    if( CSLCount(papszTokens) < 6
         || !EQUAL(papszTokens[0], "CREATE")
         || !EQUAL(papszTokens[1], "INDEX")
         || !EQUAL(papszTokens[2], "ON")
@@ -4706,7 +4743,8 @@ OGRErr GDALDataset::ProcessSQLCreateIndex( const char *pszSQLCommand )
         CPLError(CE_Failure, CPLE_AppDefined,
                  "Syntax error in CREATE INDEX command.\n"
                  "Was '%s'\n"
-                 "Should be of form 'CREATE INDEX ON <table> USING <field>'",
+                 "Should be of form "
+                 "'CREATE INDEX ON <table> USING <field>[,<field>]...'",
                  pszSQLCommand);
         return OGRERR_FAILURE;
     }
@@ -4736,13 +4774,15 @@ OGRErr GDALDataset::ProcessSQLCreateIndex( const char *pszSQLCommand )
     }
 
 /* -------------------------------------------------------------------- */
-/*      Find the named field.                                           */
+/*      Find the named field(s).                                        */
 /* -------------------------------------------------------------------- */
-    int i = poLayer->GetLayerDefn()->GetFieldIndex(papszTokens[5]);
+    std::vector<int> anFields;
+    const bool bFieldsFound =
+        GDALSQLGetIndexFields(poLayer, papszTokens, 5, anFields);
 
     CSLDestroy(papszTokens);
 
-    if( i >= poLayer->GetLayerDefn()->GetFieldCount() )
+    if( !bFieldsFound )
     {
         CPLError(CE_Failure, CPLE_AppDefined,
                  "`%s' failed, field not found.",
@@ -4753,7 +4793,11 @@ OGRErr GDALDataset::ProcessSQLCreateIndex( const char *pszSQLCommand )
 /* -------------------------------------------------------------------- */
 /*      Attempt to create the index.                                    */
 /* -------------------------------------------------------------------- */
-    OGRErr eErr = poLayer->GetIndex()->CreateIndex(i);
+    const int i = anFields[0];
+    OGRErr eErr = anFields.size() == 1 ?
+        poLayer->GetIndex()->CreateIndex(i) :
+        poLayer->GetIndex()->CreateMultiFieldIndex(
+            static_cast<int>(anFields.size()), &anFields[0]);
     if( eErr == OGRERR_NONE )
     {
         eErr = poLayer->GetIndex()->IndexAllFeatures(i);
@@ -4773,7 +4817,7 @@ OGRErr GDALDataset::ProcessSQLCreateIndex( const char *pszSQLCommand )
 /*      The correct syntax for dropping one or more indexes in          */
 /*      the OGR SQL dialect is:                                         */
 /*                                                                      */
-/*          DROP INDEX ON <layername> [USING <columnname>]              */
+/*      DROP INDEX ON <layername> [USING <columnname>[,<columnname>]]   */
 /************************************************************************/
 
 OGRErr GDALDataset::ProcessSQLDropIndex( const char *pszSQLCommand )
@@ -4784,17 +4828,18 @@ OGRErr GDALDataset::ProcessSQLDropIndex( const char *pszSQLCommand )
 /* -------------------------------------------------------------------- */
 /*      Do some general syntax checking.                                */
 /* -------------------------------------------------------------------- */
-    if( (CSLCount(papszTokens) != 4 && CSLCount(papszTokens) != 6)
+    if( (CSLCount(papszTokens) != 4 && CSLCount(papszTokens) < 6)
         || !EQUAL(papszTokens[0], "DROP")
         || !EQUAL(papszTokens[1], "INDEX")
         || !EQUAL(papszTokens[2], "ON")
-        || (CSLCount(papszTokens) == 6 && !EQUAL(papszTokens[4], "USING")) )
+        || (CSLCount(papszTokens) >= 6 && !EQUAL(papszTokens[4], "USING")) )
     {
         CSLDestroy(papszTokens);
         CPLError(CE_Failure, CPLE_AppDefined,
                  "Syntax error in DROP INDEX command.\n"
                  "Was '%s'\n"
-                 "Should be of form 'DROP INDEX ON <table> [USING <field>]'",
+                 "Should be of form "
+                 "'DROP INDEX ON <table> [USING <field>[,<field>]...]'",
                  pszSQLCommand);
         return OGRERR_FAILURE;
     }
@@ -4849,12 +4894,14 @@ OGRErr GDALDataset::ProcessSQLDropIndex( const char *pszSQLCommand )
     }
 
 /* -------------------------------------------------------------------- */
-/*      Find the named field.                                           */
+/*      Find the named field(s).                                        */
 /* -------------------------------------------------------------------- */
-    int i = poLayer->GetLayerDefn()->GetFieldIndex(papszTokens[5]);
+    std::vector<int> anFields;
+    const bool bFieldsFound =
+        GDALSQLGetIndexFields(poLayer, papszTokens, 5, anFields);
     CSLDestroy(papszTokens);
 
-    if( i >= poLayer->GetLayerDefn()->GetFieldCount() )
+    if( !bFieldsFound )
     {
         CPLError(CE_Failure, CPLE_AppDefined, "`%s' failed, field not found.",
                  pszSQLCommand);
@@ -4864,7 +4911,10 @@ OGRErr GDALDataset::ProcessSQLDropIndex( const char *pszSQLCommand )
 /* -------------------------------------------------------------------- */
 /*      Attempt to drop the index.                                      */
 /* -------------------------------------------------------------------- */
-    const OGRErr eErr = poLayer->GetIndex()->DropIndex(i);
+    const OGRErr eErr = anFields.size() == 1 ?
+        poLayer->GetIndex()->DropIndex(anFields[0]) :
+        poLayer->GetIndex()->DropMultiFieldIndex(
+            static_cast<int>(anFields.size()), &anFields[0]);
 
     return eErr;
 }
@@ -34,6 +34,10 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <map>
+#include <string>
+#include <unordered_map>
+
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_hash_set.h"
@@ -56,7 +60,8 @@ CPL_CVSID("$Id$")
 /* ******************************************************************** */
 
 /* This class is a singleton that maintains a pool of opened datasets */
-/* The cache uses a LRU strategy */
+/* The cache uses a LRU strategy, and entries are looked up by filename */
+/* through a hash map */
 
 class GDALDatasetPool;
 static GDALDatasetPool* singleton = nullptr;
@@ -73,6 +78,11 @@ struct _GDALProxyPoolCacheEntry
     /* Ref count of the cached dataset */
     int           refCount;
 
+    /* Set while poDS is opened by thread nOpeningThread, without */
+    /* holding the mutex */
+    bool          bOpening;
+    GIntBig       nOpeningThread;
+
     GDALProxyPoolCacheEntry* prev;
     GDALProxyPoolCacheEntry* next;
 };
@@ -93,6 +103,15 @@ class GDALDatasetPool
         GDALProxyPoolCacheEntry* firstEntry;
         GDALProxyPoolCacheEntry* lastEntry;
 
+        /* Entries with a non empty filename, indexed by filename */
+        std::unordered_multimap<std::string, GDALProxyPoolCacheEntry*>
+                                                        oMapFileNameToEntry;
+
+        /* Statistics, reported as debug messages on destruction */
+        GIntBig nHits;
+        GIntBig nMisses;
+        GIntBig nEvictions;
+
         /* This variable prevents a dataset that is going to be opened in GDALDatasetPool::_RefDataset */
         /* from increasing refCount if, during its opening, it creates a GDALProxyPoolDataset */
         /* We increment it before opening or closing a cached dataset and decrement it afterwards */
@@ -101,6 +120,11 @@ class GDALDatasetPool
         /* a high chance that this reference will not be dropped and the pool remain ghost */
         int refCountOfDisableRefCount;
 
+        /* Same as refCountOfDisableRefCount, but for the threads that open */
+        /* or close a cached dataset without holding the mutex. Indexed by */
+        /* CPLGetPID() */
+        std::map<GIntBig, int> oMapThreadToDisableRefCount;
+
         /* Caution : to be sure that we don't run out of entries, size must be at */
         /* least greater or equal than the maximum number of threads */
         explicit GDALDatasetPool(int maxSize);
@@ -113,6 +137,11 @@ class GDALDatasetPool
                                              const char* pszOwner);
         void _CloseDataset(const char* pszFileName, GDALAccess eAccess);
 
+        bool IsRefCountDisabled() const;
+        void AddToIndex(GDALProxyPoolCacheEntry* entry);
+        void RemoveFromIndex(GDALProxyPoolCacheEntry* entry);
+        void MoveToFront(GDALProxyPoolCacheEntry* entry);
+
 #ifdef DEBUG_PROXY_POOL
         // cppcheck-suppress unusedPrivateFunction
         void ShowContent();
@@ -148,6 +177,9 @@ GDALDatasetPool::GDALDatasetPool(int maxSizeIn)
     lastEntry = nullptr;
     refCount = 0;
     refCountOfDisableRefCount = 0;
+    nHits = 0;
+    nMisses = 0;
+    nEvictions = 0;
 }
 
 /************************************************************************/
@@ -157,6 +189,10 @@ GDALDatasetPool::GDALDatasetPool(int maxSizeIn)
 GDALDatasetPool::~GDALDatasetPool()
 {
     bInDestruction = true;
+    CPLDebug("GDAL", "Dataset pool of size %d: " CPL_FRMT_GIB " hits, "
+             CPL_FRMT_GIB " misses, " CPL_FRMT_GIB " evictions",
+             maxSize, nHits, nMisses, nEvictions);
+    oMapFileNameToEntry.clear();
     GDALProxyPoolCacheEntry* cur = firstEntry;
     GIntBig responsiblePID = GDALGetResponsiblePIDForCurrentThread();
     while(cur)
@@ -216,8 +252,75 @@ void GDALDatasetPool::CheckLinks()
 }
 #endif
 
+/************************************************************************/
+/*                        IsRefCountDisabled()                          */
+/************************************************************************/
+
+bool GDALDatasetPool::IsRefCountDisabled() const
+{
+    return refCountOfDisableRefCount != 0 ||
+           oMapThreadToDisableRefCount.find(CPLGetPID()) !=
+                                        oMapThreadToDisableRefCount.end();
+}
+
+/************************************************************************/
+/*                            AddToIndex()                              */
+/************************************************************************/
+
+void GDALDatasetPool::AddToIndex(GDALProxyPoolCacheEntry* entry)
+{
+    oMapFileNameToEntry.insert(
+        std::pair<std::string, GDALProxyPoolCacheEntry*>(entry->pszFileName,
+                                                         entry));
+}
+
+/************************************************************************/
+/*                          RemoveFromIndex()                           */
+/************************************************************************/
+
+void GDALDatasetPool::RemoveFromIndex(GDALProxyPoolCacheEntry* entry)
+{
+    auto oRange = oMapFileNameToEntry.equal_range(entry->pszFileName);
+    for( auto oIter = oRange.first; oIter != oRange.second; ++oIter )
+    {
+        if( oIter->second == entry )
+        {
+            oMapFileNameToEntry.erase(oIter);
+            return;
+        }
+    }
+}
+
+/************************************************************************/
+/*                            MoveToFront()                             */
+/************************************************************************/
+
+void GDALDatasetPool::MoveToFront(GDALProxyPoolCacheEntry* cur)
+{
+    if (cur == firstEntry)
+        return;
+
+    if (cur->next)
+        cur->next->prev = cur->prev;
+    else
+        lastEntry = cur->prev;
+    cur->prev->next = cur->next;
+    cur->prev = nullptr;
+    firstEntry->prev = cur;
+    cur->next = firstEntry;
+    firstEntry = cur;
+
+#ifdef DEBUG_PROXY_POOL
+    CheckLinks();
+#endif
+}
+
 /************************************************************************/
 /*                            _RefDataset()                             */
+/*                                                                      */
+/*      Must be called with the mutex held. It is released while the    */
+/*      dataset is opened (and while the dataset of the recycled entry  */
+/*      is closed), so that other threads can use the pool meanwhile.   */
 /************************************************************************/
 
 GDALProxyPoolCacheEntry* GDALDatasetPool::_RefDataset(const char* pszFileName,
@@ -230,54 +333,45 @@ GDALProxyPoolCacheEntry* GDALDatasetPool::_RefDataset(const char* pszFileName,
     if( bInDestruction )
         return nullptr;
 
-    GDALProxyPoolCacheEntry* cur = firstEntry;
     GIntBig responsiblePID = GDALGetResponsiblePIDForCurrentThread();
-    GDALProxyPoolCacheEntry* lastEntryWithZeroRefCount = nullptr;
+    const GIntBig nThreadId = CPLGetPID();
 
-    while(cur)
+    auto oRange = oMapFileNameToEntry.equal_range(pszFileName);
+    for( auto oIter = oRange.first; oIter != oRange.second; ++oIter )
     {
-        GDALProxyPoolCacheEntry* next = cur->next;
-
-        if (strcmp(cur->pszFileName, pszFileName) == 0 &&
-            ((bShared && cur->responsiblePID == responsiblePID &&
-              ((cur->pszOwner == nullptr && pszOwner == nullptr) ||
-                (cur->pszOwner != nullptr && pszOwner != nullptr &&
-                 strcmp(cur->pszOwner, pszOwner) == 0))) ||
-             (!bShared && cur->refCount == 0)) )
-        {
-            if (cur != firstEntry)
-            {
-                /* Move to begin */
-                if (cur->next)
-                    cur->next->prev = cur->prev;
-                else
-                    lastEntry = cur->prev;
-                cur->prev->next = cur->next;
-                cur->prev = nullptr;
-                firstEntry->prev = cur;
-                cur->next = firstEntry;
-                firstEntry = cur;
+        GDALProxyPoolCacheEntry* cur = oIter->second;
 
-#ifdef DEBUG_PROXY_POOL
-                CheckLinks();
-#endif
-            }
+        /* An entry being opened by another thread cannot be used yet */
+        if( cur->bOpening && cur->nOpeningThread != nThreadId )
+            continue;
 
+        if ((bShared && cur->responsiblePID == responsiblePID &&
+             ((cur->pszOwner == nullptr && pszOwner == nullptr) ||
+              (cur->pszOwner != nullptr && pszOwner != nullptr &&
+               strcmp(cur->pszOwner, pszOwner) == 0))) ||
+            (!bShared && cur->refCount == 0))
+        {
+            MoveToFront(cur);
             cur->refCount ++;
+            nHits ++;
             return cur;
         }
-
-        if (cur->refCount == 0)
-            lastEntryWithZeroRefCount = cur;
-
-        cur = next;
     }
 
     if( !bForceOpen )
         return nullptr;
 
+    GDALProxyPoolCacheEntry* cur = nullptr;
+    GDALDataset* poDSToClose = nullptr;
+    GIntBig responsiblePIDToClose = 0;
     if (currentSize == maxSize)
     {
+        GDALProxyPoolCacheEntry* lastEntryWithZeroRefCount = lastEntry;
+        while( lastEntryWithZeroRefCount != nullptr &&
+               lastEntryWithZeroRefCount->refCount != 0 )
+        {
+            lastEntryWithZeroRefCount = lastEntryWithZeroRefCount->prev;
+        }
         if (lastEntryWithZeroRefCount == nullptr)
         {
             CPLError(CE_Failure, CPLE_AppDefined,
@@ -287,45 +381,21 @@ GDALProxyPoolCacheEntry* GDALDatasetPool::_RefDataset(const char* pszFileName,
             return nullptr;
         }
 
-        lastEntryWithZeroRefCount->pszFileName[0] = '\0';
-        if (lastEntryWithZeroRefCount->poDS)
-        {
-            /* Close by pretending we are the thread that GDALOpen'ed this */
-            /* dataset */
-            GDALSetResponsiblePIDForCurrentThread(lastEntryWithZeroRefCount->responsiblePID);
-
-            refCountOfDisableRefCount ++;
-            GDALClose(lastEntryWithZeroRefCount->poDS);
-            refCountOfDisableRefCount --;
-
-            lastEntryWithZeroRefCount->poDS = nullptr;
-            GDALSetResponsiblePIDForCurrentThread(responsiblePID);
-        }
+        /* Recycle this entry for the to-be-opened dataset and */
+        /* moves it to the top of the list. Its dataset is closed */
+        /* below */
+        if (lastEntryWithZeroRefCount->pszFileName[0] != '\0')
+            RemoveFromIndex(lastEntryWithZeroRefCount);
+        poDSToClose = lastEntryWithZeroRefCount->poDS;
+        responsiblePIDToClose = lastEntryWithZeroRefCount->responsiblePID;
+        lastEntryWithZeroRefCount->poDS = nullptr;
         CPLFree(lastEntryWithZeroRefCount->pszFileName);
         CPLFree(lastEntryWithZeroRefCount->pszOwner);
+        if( poDSToClose )
+            nEvictions ++;
 
-        /* Recycle this entry for the to-be-opened dataset and */
-        /* moves it to the top of the list */
-        if (lastEntryWithZeroRefCount->prev)
-            lastEntryWithZeroRefCount->prev->next = lastEntryWithZeroRefCount->next;
-        else {
-            CPLAssert(false);
-        }
-        if (lastEntryWithZeroRefCount->next)
-            lastEntryWithZeroRefCount->next->prev = lastEntryWithZeroRefCount->prev;
-        else
-        {
-            CPLAssert(lastEntryWithZeroRefCount == lastEntry);
-            lastEntry->prev->next = nullptr;
-            lastEntry = lastEntry->prev;
-        }
-        lastEntryWithZeroRefCount->prev = nullptr;
-        lastEntryWithZeroRefCount->next = firstEntry;
-        firstEntry->prev = lastEntryWithZeroRefCount;
-        cur = firstEntry = lastEntryWithZeroRefCount;
-#ifdef DEBUG_PROXY_POOL
-        CheckLinks();
-#endif
+        cur = lastEntryWithZeroRefCount;
+        MoveToFront(cur);
     }
     else
     {
@@ -348,13 +418,45 @@ GDALProxyPoolCacheEntry* GDALDatasetPool::_RefDataset(const char* pszFileName,
     cur->pszOwner = (pszOwner) ? CPLStrdup(pszOwner) : nullptr;
     cur->responsiblePID = responsiblePID;
     cur->refCount = 1;
+    cur->poDS = nullptr;
+    cur->bOpening = true;
+    cur->nOpeningThread = nThreadId;
+    AddToIndex(cur);
+    nMisses ++;
+
+/* -------------------------------------------------------------------- */
+/*      Close the dataset of the recycled entry and open the new one    */
+/*      without holding the mutex. The entry cannot be recycled or      */
+/*      used by other threads meanwhile, since its ref count is not     */
+/*      zero and it is marked as being opened.                          */
+/* -------------------------------------------------------------------- */
+    oMapThreadToDisableRefCount[nThreadId] ++;
+    CPLMutex* hMutex = *GDALGetphDLMutex();
+    CPLReleaseMutex(hMutex);
+
+    if (poDSToClose)
+    {
+        /* Close by pretending we are the thread that GDALOpen'ed this */
+        /* dataset */
+        GDALSetResponsiblePIDForCurrentThread(responsiblePIDToClose);
+        GDALClose(poDSToClose);
+        GDALSetResponsiblePIDForCurrentThread(responsiblePID);
+    }
 
-    refCountOfDisableRefCount ++;
-    int nFlag = ((eAccess == GA_Update) ? GDAL_OF_UPDATE : GDAL_OF_READONLY) | GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR;
-    CPLConfigOptionSetter oSetter("CPL_ALLOW_VSISTDIN", "NO", true);
-    cur->poDS = (GDALDataset*) GDALOpenEx( pszFileName, nFlag, nullptr,
-                           (const char* const* )papszOpenOptions, nullptr );
-    refCountOfDisableRefCount --;
+    GDALDataset* poDS = nullptr;
+    {
+        int nFlag = ((eAccess == GA_Update) ? GDAL_OF_UPDATE : GDAL_OF_READONLY) | GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR;
+        CPLConfigOptionSetter oSetter("CPL_ALLOW_VSISTDIN", "NO", true);
+        poDS = (GDALDataset*) GDALOpenEx( pszFileName, nFlag, nullptr,
+                               (const char* const* )papszOpenOptions, nullptr );
+    }
+
+    CPLAcquireMutex(hMutex, 1000.0);
+    if( --oMapThreadToDisableRefCount[nThreadId] == 0 )
+        oMapThreadToDisableRefCount.erase(nThreadId);
+
+    cur->poDS = poDS;
+    cur->bOpening = false;
 
     return cur;
 }
@@ -366,17 +468,17 @@ GDALProxyPoolCacheEntry* GDALDatasetPool::_RefDataset(const char* pszFileName,
 void GDALDatasetPool::_CloseDataset( const char* pszFileName,
                                      GDALAccess /* eAccess */ )
 {
-    GDALProxyPoolCacheEntry* cur = firstEntry;
     GIntBig responsiblePID = GDALGetResponsiblePIDForCurrentThread();
 
-    while(cur)
+    auto oRange = oMapFileNameToEntry.equal_range(pszFileName);
+    for( auto oIter = oRange.first; oIter != oRange.second; ++oIter )
     {
-        GDALProxyPoolCacheEntry* next = cur->next;
+        GDALProxyPoolCacheEntry* cur = oIter->second;
 
-        CPLAssert(cur->pszFileName);
-        if (strcmp(cur->pszFileName, pszFileName) == 0 && cur->refCount == 0 &&
-            cur->poDS != nullptr )
+        if (cur->refCount == 0 && cur->poDS != nullptr )
         {
+            oMapFileNameToEntry.erase(oIter);
+
             /* Close by pretending we are the thread that GDALOpen'ed this */
             /* dataset */
             GDALSetResponsiblePIDForCurrentThread(cur->responsiblePID);
@@ -393,8 +495,6 @@ void GDALDatasetPool::_CloseDataset( const char* pszFileName,
             cur->pszOwner = nullptr;
             break;
         }
-
-        cur = next;
     }
 }
 
@@ -412,7 +512,7 @@ void GDALDatasetPool::Ref()
             l_maxSize = 100;
         singleton = new GDALDatasetPool(l_maxSize);
     }
-    if (singleton->refCountOfDisableRefCount == 0)
+    if (!singleton->IsRefCountDisabled())
       singleton->refCount++;
 }
 
@@ -445,7 +545,7 @@ void GDALDatasetPool::Unref()
         CPLAssert(false);
         return;
     }
-    if (singleton->refCountOfDisableRefCount == 0)
+    if (!singleton->IsRefCountDisabled())
     {
       singleton->refCount--;
       if (singleton->refCount == 0)
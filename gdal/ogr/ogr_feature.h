@@ -488,12 +488,15 @@ class CPL_DLL OGRFeature
 class OGRLayer;
 class swq_expr_node;
 class swq_custom_func_registrar;
+class OGRFeatureQueryProgram;
 
 class CPL_DLL OGRFeatureQuery
 {
   private:
     OGRFeatureDefn *poTargetDefn;
     void           *pSWQExpr;
+    OGRFeatureQueryProgram *poProgram;
+    bool            bProgramCompiled;
 
     char      **FieldCollector( void *, char ** );
 
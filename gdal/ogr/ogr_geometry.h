@@ -517,6 +517,11 @@ class CPL_DLL OGRSimpleCurve: public OGRCurve
                                        int& nMaxPoints,
                                        double*& padfZIn );
 
+    void        importPointsFromWkb( const unsigned char* pabyData,
+                                     bool bSwap );
+    void        exportPointsToWkb( unsigned char* pabyData, int nWkbFlags,
+                                   bool bSwap ) const;
+
 //! @endcond
 
     virtual double get_LinearArea() const;
@@ -1822,6 +1827,9 @@ class CPL_DLL OGRGeometryFactory
     static OGRGeometry* transformWithOptions( const OGRGeometry* poSrcGeom,
                                               OGRCoordinateTransformation *poCT,
                                               char** papszOptions );
+    static OGRErr transformGeometries( int nCount, OGRGeometry** papoGeoms,
+                                       OGRCoordinateTransformation *poCT,
+                                       OGRErr* paeErrors = nullptr );
 
     static OGRGeometry*
         approximateArcAngles( double dfX, double dfY, double dfZ,
@@ -179,4 +179,8 @@ void CPL_DLL OGRUpdateFieldType( OGRFieldDefn* poFDefn,
                                  OGRFieldType eNewType,
                                  OGRFieldSubType eNewSubType );
 
+int OGRTransformGeometriesBatched( int nCount, OGRGeometry** papoGeoms,
+                                   OGRCoordinateTransformation *poCT,
+                                   bool* pabDone );
+
 #endif /* ndef OGR_P_H_INCLUDED */
@@ -0,0 +1,435 @@
+/******************************************************************************
+ *
+ * Project:  OGR
+ * Purpose:  Read-only view over a WKB / EWKB geometry buffer
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "ogr_wkb.h"
+
+#include <cstring>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+
+CPL_CVSID("$Id$")
+
+//! @cond Doxygen_Suppress
+
+// Same limit as OGRGeometryFactory::createFromWkb()
+constexpr int knMAX_WKB_REC_LEVEL = 32;
+
+namespace {
+
+struct OGRWKBWalkState
+{
+    const GByte*        pabyData;
+    size_t              nSize;
+    // When set, only iterate over points, with no envelope computation.
+    OGRWKBPointCallback pfnCallback;
+    void*               pUserData;
+    bool                bStopped;
+    GUIntBig            nPointCount;
+    bool                bHasCurve;
+    bool                bEnvelopeValid;
+    OGREnvelope3D       sEnvelope;
+};
+
+} // namespace
+
+/************************************************************************/
+/*                         OGRWKBReadUInt32()                           */
+/************************************************************************/
+
+static inline GUInt32 OGRWKBReadUInt32( const GByte* pabyData, bool bSwap )
+{
+    GUInt32 nVal;
+    memcpy(&nVal, pabyData, sizeof(nVal));
+    if( bSwap )
+        CPL_SWAP32PTR(&nVal);
+    return nVal;
+}
+
+/************************************************************************/
+/*                         OGRWKBReadDouble()                           */
+/************************************************************************/
+
+static inline double OGRWKBReadDouble( const GByte* pabyData, bool bSwap )
+{
+    double dfVal;
+    memcpy(&dfVal, pabyData, sizeof(dfVal));
+    if( bSwap )
+        CPL_SWAP64PTR(&dfVal);
+    return dfVal;
+}
+
+/************************************************************************/
+/*                         OGRWKBReadHeader()                           */
+/*                                                                      */
+/*      Read the byte order, the geometry type and the optional EWKB    */
+/*      SRID of a geometry.                                             */
+/************************************************************************/
+
+static bool OGRWKBReadHeader( OGRWKBWalkState* psState, size_t& nOffset,
+                              bool& bSwap, int& nFlatType,
+                              bool& bHasZ, bool& bHasM,
+                              bool& bHasSRID, int& nSRID )
+{
+    if( psState->nSize - nOffset < 5 )
+        return false;
+    const GByte byOrder = psState->pabyData[nOffset];
+    if( byOrder != wkbXDR && byOrder != wkbNDR )
+        return false;
+#if CPL_IS_LSB
+    bSwap = byOrder == wkbXDR;
+#else
+    bSwap = byOrder == wkbNDR;
+#endif
+    GUInt32 nType = OGRWKBReadUInt32(psState->pabyData + nOffset + 1, bSwap);
+    nOffset += 5;
+
+    // OGC 2.5D / EWKB flags
+    bHasZ = (nType & 0x80000000U) != 0;
+    bHasM = (nType & 0x40000000U) != 0;
+    bHasSRID = (nType & 0x20000000U) != 0;
+    nType &= 0x1FFFFFFFU;
+
+    // ISO SQL/MM dimensions
+    if( nType >= 1000 && nType < 4000 )
+    {
+        const GUInt32 nDim = nType / 1000;
+        nType %= 1000;
+        if( nDim == 1 || nDim == 3 )
+            bHasZ = true;
+        if( nDim >= 2 )
+            bHasM = true;
+    }
+
+    // Curve (13) and Surface (14) are abstract types
+    if( nType < wkbPoint || nType > wkbTriangle ||
+        nType == wkbCurve || nType == wkbSurface )
+    {
+        return false;
+    }
+    nFlatType = static_cast<int>(nType);
+
+    nSRID = 0;
+    if( bHasSRID )
+    {
+        if( psState->nSize - nOffset < 4 )
+            return false;
+        nSRID = static_cast<int>(
+            OGRWKBReadUInt32(psState->pabyData + nOffset, bSwap));
+        nOffset += 4;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                          OGRWKBReadPoints()                          */
+/************************************************************************/
+
+static bool OGRWKBReadPoints( OGRWKBWalkState* psState, size_t& nOffset,
+                              GUInt32 nPoints, bool bSwap,
+                              bool bHasZ, bool bHasM,
+                              bool bSinglePoint )
+{
+    const size_t nDim = 2 + (bHasZ ? 1 : 0) + (bHasM ? 1 : 0);
+    const size_t nPointSize = nDim * sizeof(double);
+    if( nPoints > (psState->nSize - nOffset) / nPointSize )
+        return false;
+
+    for( GUInt32 i = 0; i < nPoints; i++ )
+    {
+        const GByte* pabyPoint = psState->pabyData + nOffset;
+        nOffset += nPointSize;
+        if( psState->bStopped )
+            continue;
+
+        const double dfX = OGRWKBReadDouble(pabyPoint, bSwap);
+        const double dfY = OGRWKBReadDouble(pabyPoint + 8, bSwap);
+        // POINT EMPTY is encoded with NaN coordinates
+        if( bSinglePoint && CPLIsNan(dfX) && CPLIsNan(dfY) )
+            continue;
+        const double dfZ = bHasZ ? OGRWKBReadDouble(pabyPoint + 16, bSwap)
+                                 : 0.0;
+        const double dfM = bHasM ?
+            OGRWKBReadDouble(pabyPoint + (bHasZ ? 24 : 16), bSwap) : 0.0;
+
+        if( psState->pfnCallback )
+        {
+            if( !psState->pfnCallback(dfX, dfY, dfZ, dfM,
+                                      psState->pUserData) )
+            {
+                psState->bStopped = true;
+            }
+            continue;
+        }
+
+        psState->nPointCount++;
+        OGREnvelope3D& sEnv = psState->sEnvelope;
+        if( !psState->bEnvelopeValid )
+        {
+            psState->bEnvelopeValid = true;
+            sEnv.MinX = sEnv.MaxX = dfX;
+            sEnv.MinY = sEnv.MaxY = dfY;
+            sEnv.MinZ = sEnv.MaxZ = dfZ;
+        }
+        else
+        {
+            if( dfX < sEnv.MinX ) sEnv.MinX = dfX;
+            if( dfX > sEnv.MaxX ) sEnv.MaxX = dfX;
+            if( dfY < sEnv.MinY ) sEnv.MinY = dfY;
+            if( dfY > sEnv.MaxY ) sEnv.MaxY = dfY;
+            if( dfZ < sEnv.MinZ ) sEnv.MinZ = dfZ;
+            if( dfZ > sEnv.MaxZ ) sEnv.MaxZ = dfZ;
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                           OGRWKBWalk()                               */
+/*                                                                      */
+/*      Validate a (sub-)geometry starting at nOffset, and advance      */
+/*      nOffset past it.                                                */
+/************************************************************************/
+
+static bool OGRWKBWalk( OGRWKBWalkState* psState, size_t& nOffset,
+                        int nRecLevel,
+                        int* pnFlatType, bool* pbHasZ, bool* pbHasM,
+                        bool* pbHasSRID, int* pnSRID, GUInt32* pnPartCount )
+{
+    if( nRecLevel == knMAX_WKB_REC_LEVEL )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Too many recursion levels (%d) while parsing WKB geometry.",
+                 knMAX_WKB_REC_LEVEL);
+        return false;
+    }
+
+    bool bSwap = false;
+    int nFlatType = 0;
+    bool bHasZ = false;
+    bool bHasM = false;
+    bool bHasSRID = false;
+    int nSRID = 0;
+    if( !OGRWKBReadHeader(psState, nOffset, bSwap, nFlatType,
+                          bHasZ, bHasM, bHasSRID, nSRID) )
+        return false;
+    if( pnFlatType )
+    {
+        *pnFlatType = nFlatType;
+        *pbHasZ = bHasZ;
+        *pbHasM = bHasM;
+        *pbHasSRID = bHasSRID;
+        *pnSRID = nSRID;
+    }
+
+    if( nFlatType == wkbPoint )
+    {
+        const GUIntBig nPointCountBefore = psState->nPointCount;
+        if( !OGRWKBReadPoints(psState, nOffset, 1, bSwap, bHasZ, bHasM,
+                              true) )
+            return false;
+        if( pnPartCount )
+            *pnPartCount =
+                psState->nPointCount != nPointCountBefore ? 1 : 0;
+        return true;
+    }
+
+    if( psState->nSize - nOffset < 4 )
+        return false;
+    const GUInt32 nCount =
+        OGRWKBReadUInt32(psState->pabyData + nOffset, bSwap);
+    nOffset += 4;
+    if( pnPartCount )
+        *pnPartCount = nCount;
+
+    if( nFlatType == wkbLineString || nFlatType == wkbCircularString )
+    {
+        if( nFlatType == wkbCircularString )
+            psState->bHasCurve = true;
+        return OGRWKBReadPoints(psState, nOffset, nCount, bSwap,
+                                bHasZ, bHasM, false);
+    }
+
+    if( nFlatType == wkbPolygon || nFlatType == wkbTriangle )
+    {
+        if( nCount > (psState->nSize - nOffset) / 4 )
+            return false;
+        for( GUInt32 i = 0; i < nCount; i++ )
+        {
+            if( psState->nSize - nOffset < 4 )
+                return false;
+            const GUInt32 nPoints =
+                OGRWKBReadUInt32(psState->pabyData + nOffset, bSwap);
+            nOffset += 4;
+            if( !OGRWKBReadPoints(psState, nOffset, nPoints, bSwap,
+                                  bHasZ, bHasM, false) )
+                return false;
+        }
+        return true;
+    }
+
+    // Collections, compound curves and curve polygons: a list of
+    // full WKB sub-geometries. A sub-geometry is at least 9 bytes long.
+    if( nCount > (psState->nSize - nOffset) / 9 )
+        return false;
+    for( GUInt32 i = 0; i < nCount; i++ )
+    {
+        if( !OGRWKBWalk(psState, nOffset, nRecLevel + 1,
+                        nullptr, nullptr, nullptr, nullptr, nullptr,
+                        nullptr) )
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                                Init()                                */
+/************************************************************************/
+
+/** Validate a WKB geometry and compute its properties.
+ *
+ * @param pabyWKB WKB buffer.
+ * @param nWKBSize size of the buffer. May be larger than the geometry.
+ * @return true if the buffer contains a valid WKB geometry.
+ */
+bool OGRWKBGeometryView::Init( const GByte* pabyWKB, size_t nWKBSize )
+{
+    m_pabyData = nullptr;
+    m_nSize = 0;
+    m_eGeomType = wkbUnknown;
+    m_nSRID = 0;
+    m_bHasSRID = false;
+    m_nPartCount = 0;
+    m_nPointCount = 0;
+    m_bHasCurve = false;
+    m_bEnvelopeValid = false;
+
+    if( pabyWKB == nullptr )
+        return false;
+
+    OGRWKBWalkState sState;
+    sState.pabyData = pabyWKB;
+    sState.nSize = nWKBSize;
+    sState.pfnCallback = nullptr;
+    sState.pUserData = nullptr;
+    sState.bStopped = false;
+    sState.nPointCount = 0;
+    sState.bHasCurve = false;
+    sState.bEnvelopeValid = false;
+
+    size_t nOffset = 0;
+    int nFlatType = 0;
+    bool bHasZ = false;
+    bool bHasM = false;
+    if( !OGRWKBWalk(&sState, nOffset, 0, &nFlatType, &bHasZ, &bHasM,
+                    &m_bHasSRID, &m_nSRID, &m_nPartCount) )
+    {
+        m_bHasSRID = false;
+        m_nSRID = 0;
+        m_nPartCount = 0;
+        return false;
+    }
+
+    m_pabyData = pabyWKB;
+    m_nSize = nOffset;
+    m_eGeomType = OGR_GT_SetModifier(
+        static_cast<OGRwkbGeometryType>(nFlatType), bHasZ, bHasM);
+    m_nPointCount = sState.nPointCount;
+    m_bHasCurve = sState.bHasCurve;
+    m_bEnvelopeValid = sState.bEnvelopeValid;
+    m_sEnvelope = sState.sEnvelope;
+    return true;
+}
+
+/************************************************************************/
+/*                            GetEnvelope()                             */
+/************************************************************************/
+
+/** Return the 2D envelope of the geometry.
+ *
+ * @return false if the geometry is empty, or contains circular arcs (in
+ * which case the envelope must be computed on the OGRGeometry).
+ */
+bool OGRWKBGeometryView::GetEnvelope( OGREnvelope& sEnvelope ) const
+{
+    if( !m_bEnvelopeValid || m_bHasCurve )
+        return false;
+    sEnvelope.MinX = m_sEnvelope.MinX;
+    sEnvelope.MinY = m_sEnvelope.MinY;
+    sEnvelope.MaxX = m_sEnvelope.MaxX;
+    sEnvelope.MaxY = m_sEnvelope.MaxY;
+    return true;
+}
+
+/** Return the 3D envelope of the geometry.
+ *
+ * Z is considered to be 0 for 2D geometries.
+ *
+ * @return false if the geometry is empty, or contains circular arcs.
+ */
+bool OGRWKBGeometryView::GetEnvelope( OGREnvelope3D& sEnvelope ) const
+{
+    if( !m_bEnvelopeValid || m_bHasCurve )
+        return false;
+    sEnvelope = m_sEnvelope;
+    return true;
+}
+
+/************************************************************************/
+/*                           ForEachPoint()                             */
+/************************************************************************/
+
+/** Call pfnCallback on each point of the geometry, in the order of the
+ * WKB buffer. Empty points are skipped.
+ *
+ * @return false if the iteration was stopped by the callback.
+ */
+bool OGRWKBGeometryView::ForEachPoint( OGRWKBPointCallback pfnCallback,
+                                       void* pUserData ) const
+{
+    if( m_pabyData == nullptr )
+        return true;
+
+    OGRWKBWalkState sState;
+    sState.pabyData = m_pabyData;
+    sState.nSize = m_nSize;
+    sState.pfnCallback = pfnCallback;
+    sState.pUserData = pUserData;
+    sState.bStopped = false;
+    sState.nPointCount = 0;
+    sState.bHasCurve = false;
+    sState.bEnvelopeValid = false;
+
+    size_t nOffset = 0;
+    OGRWKBWalk(&sState, nOffset, 0, nullptr, nullptr, nullptr, nullptr,
+               nullptr, nullptr);
+    return !sState.bStopped;
+}
+
+//! @endcond
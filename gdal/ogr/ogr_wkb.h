@@ -0,0 +1,112 @@
+/******************************************************************************
+ *
+ * Project:  OGR
+ * Purpose:  Read-only view over a WKB / EWKB geometry buffer
+ * Author:   Even Rouault, <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef OGR_WKB_H_INCLUDED
+#define OGR_WKB_H_INCLUDED
+
+#include "cpl_port.h"
+#include "ogr_core.h"
+
+//! @cond Doxygen_Suppress
+
+/** Callback for OGRWKBGeometryView::ForEachPoint(). dfZ and dfM are set to
+ * 0 when the geometry has no such dimension. Must return false to stop the
+ * iteration. */
+typedef bool (*OGRWKBPointCallback)( double dfX, double dfY,
+                                     double dfZ, double dfM,
+                                     void* pUserData );
+
+/************************************************************************/
+/*                         OGRWKBGeometryView                           */
+/************************************************************************/
+
+/** Read-only view over a WKB geometry.
+ *
+ * The buffer is validated once by Init(), which also computes the point
+ * count and the envelope, without allocating any OGRGeometry. The buffer
+ * must remain valid as long as the view is used.
+ *
+ * ISO WKB, OGC 2.5D WKB (wkb25DBit) and PostGIS EWKB (Z, M and SRID flags)
+ * are accepted, in any byte order, for all the geometry types known by
+ * OGRGeometryFactory::createFromWkb().
+ */
+class CPL_DLL OGRWKBGeometryView
+{
+        const GByte        *m_pabyData = nullptr;
+        size_t              m_nSize = 0;
+        OGRwkbGeometryType  m_eGeomType = wkbUnknown;
+        int                 m_nSRID = 0;
+        bool                m_bHasSRID = false;
+        GUInt32             m_nPartCount = 0;
+        GUIntBig            m_nPointCount = 0;
+        bool                m_bHasCurve = false;
+        bool                m_bEnvelopeValid = false;
+        OGREnvelope3D       m_sEnvelope{};
+
+    public:
+        OGRWKBGeometryView() = default;
+
+        bool                Init( const GByte* pabyWKB, size_t nWKBSize );
+
+        /** Number of bytes of the WKB geometry (may be less than the size
+         * passed to Init()). */
+        size_t              GetSize() const { return m_nSize; }
+
+        /** Geometry type, with its Z/M modifiers. */
+        OGRwkbGeometryType  GetGeometryType() const { return m_eGeomType; }
+
+        /** Whether the EWKB SRID flag was set. */
+        bool                HasSRID() const { return m_bHasSRID; }
+
+        /** EWKB SRID, or 0. */
+        int                 GetSRID() const { return m_nSRID; }
+
+        /** Number of sub-geometries of a collection, number of rings of a
+         * (curve) polygon, number of curves of a compound curve, number of
+         * points of a simple curve, 0 or 1 for a point. */
+        GUInt32             GetPartCount() const { return m_nPartCount; }
+
+        /** Total number of (non-empty) points. */
+        GUIntBig            GetPointCount() const { return m_nPointCount; }
+
+        /** Whether the geometry contains circular arcs, in which case the
+         * envelope of the vertices is not the envelope of the geometry. */
+        bool                HasCurve() const { return m_bHasCurve; }
+
+        bool                IsEmpty() const { return m_nPointCount == 0; }
+
+        bool                GetEnvelope( OGREnvelope& sEnvelope ) const;
+        bool                GetEnvelope( OGREnvelope3D& sEnvelope ) const;
+
+        bool                ForEachPoint( OGRWKBPointCallback pfnCallback,
+                                          void* pUserData ) const;
+};
+
+//! @endcond
+
+#endif /* ndef OGR_WKB_H_INCLUDED */
@@ -140,6 +140,7 @@ class OGRProj4CT : public OGRCoordinateTransformation
 
     bool        bIdentityTransform;
     bool        bWebMercatorToWGS84;
+    bool        bWGS84ToWebMercator;
 
     int         nErrorCount;
 
@@ -506,6 +507,7 @@ OGRProj4CT::OGRProj4CT() :
     dfTargetWrapLong(0.0),
     bIdentityTransform(false),
     bWebMercatorToWGS84(false),
+    bWGS84ToWebMercator(false),
     nErrorCount(0),
     bCheckWithInvertProj(false),
     dfThreshold(0.0),
@@ -770,6 +772,12 @@ int OGRProj4CT::InitializeNoLock( OGRSpatialReference * poSourceIn,
             pszSrc = pszDst + strlen("+wktext ");
             memmove(pszDst, pszSrc, strlen(pszSrc)+1);
         }
+        bWGS84ToWebMercator =
+            strcmp(pszSrcProj4Defn,
+                   "+proj=longlat +ellps=WGS84 +no_defs") == 0 &&
+            strcmp(pszDstProj4Defn,
+                   "+proj=merc +a=6378137 +b=6378137 +lat_ts=0.0 +lon_0=0.0 "
+                   "+x_0=0.0 +y_0=0 +k=1.0 +units=m +no_defs") == 0;
     }
     else
     if( (strstr(pszDstProj4Defn, "+datum=WGS84") != nullptr ||
@@ -810,7 +818,7 @@ int OGRProj4CT::InitializeNoLock( OGRSpatialReference * poSourceIn,
 /* -------------------------------------------------------------------- */
 /*      Establish PROJ.4 handle for source if projection.               */
 /* -------------------------------------------------------------------- */
-    if( !bWebMercatorToWGS84 )
+    if( !bWebMercatorToWGS84 && !bWGS84ToWebMercator )
     {
         if( pjctx )
             psPJSource = pfn_pj_init_plus_ctx( pjctx, pszSrcProj4Defn );
@@ -850,7 +858,8 @@ int OGRProj4CT::InitializeNoLock( OGRSpatialReference * poSourceIn,
     if( nDebugReportCount < 10 )
         CPLDebug( "OGRCT", "Source: %s", pszSrcProj4Defn );
 
-    if( !bWebMercatorToWGS84 && psPJSource == nullptr )
+    if( !bWebMercatorToWGS84 && !bWGS84ToWebMercator &&
+        psPJSource == nullptr )
     {
         CPLFree( pszSrcProj4Defn );
         CPLFree( pszDstProj4Defn );
@@ -860,7 +869,7 @@ int OGRProj4CT::InitializeNoLock( OGRSpatialReference * poSourceIn,
 /* -------------------------------------------------------------------- */
 /*      Establish PROJ.4 handle for target if projection.               */
 /* -------------------------------------------------------------------- */
-    if( !bWebMercatorToWGS84 )
+    if( !bWebMercatorToWGS84 && !bWGS84ToWebMercator )
     {
         if( pjctx )
             psPJTarget = pfn_pj_init_plus_ctx( pjctx, pszDstProj4Defn );
@@ -878,7 +887,8 @@ int OGRProj4CT::InitializeNoLock( OGRSpatialReference * poSourceIn,
         nDebugReportCount++;
     }
 
-    if( !bWebMercatorToWGS84 && psPJTarget == nullptr )
+    if( !bWebMercatorToWGS84 && !bWGS84ToWebMercator &&
+        psPJTarget == nullptr )
     {
         CPLFree( pszSrcProj4Defn );
         CPLFree( pszDstProj4Defn );
@@ -931,23 +941,22 @@ OGRSpatialReference *OGRProj4CT::GetTargetCS()
 int OGRProj4CT::Transform( int nCount, double *x, double *y, double *z )
 
 {
-    int *pabSuccess = static_cast<int *>(CPLMalloc(sizeof(int) * nCount));
+    if( bNoTransform )
+        return TRUE;
 
-    bool bOverallSuccess =
-        CPL_TO_BOOL(TransformEx( nCount, x, y, z, pabSuccess ));
+    // TransformEx() flags as failed exactly the points set to HUGE_VAL, so
+    // there is no need to allocate a success array for each call (this is
+    // a hot path for OGRPoint::transform()).
+    if( !TransformEx( nCount, x, y, z, nullptr ) )
+        return FALSE;
 
     for( int i = 0; i < nCount; i++ )
     {
-        if( !pabSuccess[i] )
-        {
-            bOverallSuccess = false;
-            break;
-        }
+        if( x[i] == HUGE_VAL || y[i] == HUGE_VAL )
+            return FALSE;
     }
 
-    CPLFree( pabSuccess );
-
-    return bOverallSuccess;
+    return TRUE;
 }
 
 /************************************************************************/
@@ -1109,6 +1118,51 @@ int OGRProj4CT::TransformEx( int nCount, double *x, double *y, double *z,
             }
         }
 
+        bTransformDone = true;
+    }
+/* -------------------------------------------------------------------- */
+/*      Optimized transform from WGS84 to WebMercator                   */
+/* -------------------------------------------------------------------- */
+    else if( bWGS84ToWebMercator )
+    {
+        constexpr double SPHERE_RADIUS = 6378137.0;
+        // Same validity checks as pj_fwd() and PJ_merc.c
+        constexpr double EPS = 1e-12;
+        constexpr double EPS10 = 1e-10;
+
+        // Cache of the last computed latitude, for the case where we are
+        // provided a whole line of same latitude.
+        double dfLastLat = HUGE_VAL;
+        double dfLastY = 0.0;
+        for( int i = 0; i < nCount; i++ )
+        {
+            if( x[i] == HUGE_VAL )
+                continue;
+            const double dfLatAbs = fabs(y[i]);
+            if( dfLatAbs - M_PI / 2 > EPS || fabs(x[i]) > 10.0 ||
+                fabs(dfLatAbs - M_PI / 2) <= EPS10 )
+            {
+                x[i] = HUGE_VAL;
+                y[i] = HUGE_VAL;
+                continue;
+            }
+            double dfLong = x[i];
+            // Same as adjlon()
+            if( fabs(dfLong) >= 3.14159265359 )
+            {
+                dfLong += M_PI;
+                dfLong -= 2 * M_PI * floor(dfLong / (2 * M_PI));
+                dfLong -= M_PI;
+            }
+            x[i] = dfLong * SPHERE_RADIUS;
+            if( y[i] != dfLastLat )
+            {
+                dfLastLat = y[i];
+                dfLastY = SPHERE_RADIUS * log(tan(M_PI / 4 + 0.5 * y[i]));
+            }
+            y[i] = dfLastY;
+        }
+
         bTransformDone = true;
     }
     else if( bIdentityTransform )
@@ -714,6 +714,11 @@ OGRCurve* OGRCurveCollection::stealCurve( int i )
 OGRErr OGRCurveCollection::transform( OGRGeometry* poGeom,
                                       OGRCoordinateTransformation *poCT )
 {
+    // Transform all curves with a single call when possible.
+    bool bDone = false;
+    if( OGRTransformGeometriesBatched(1, &poGeom, poCT, &bDone) == 1 )
+        return OGRERR_NONE;
+
     for( int iGeom = 0; iGeom < nCurveCount; iGeom++ )
     {
         const OGRErr eErr = papoCurves[iGeom]->transform( poCT );
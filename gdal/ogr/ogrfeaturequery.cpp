@@ -32,9 +32,13 @@
 #include "ogr_feature.h"
 #include "swq.h"
 
+#include <climits>
+#include <cmath>
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -57,13 +61,110 @@ const char *const SpecialFieldNames[SPECIAL_FIELD_COUNT] = {
 const swq_field_type SpecialFieldTypes[SPECIAL_FIELD_COUNT] = {
     SWQ_INTEGER, SWQ_STRING, SWQ_STRING, SWQ_STRING, SWQ_FLOAT};
 
+/************************************************************************/
+/*                        OGRFeatureQueryProgram                        */
+/*                                                                      */
+/*      Flat, stack based, translation of a swq_expr_node tree, so      */
+/*      that attribute filters can be evaluated without allocating a    */
+/*      swq_expr_node for each intermediate value of each feature.      */
+/*      Only the logical, comparison and arithmetic operators of        */
+/*      SWQGeneralEvaluator() on integer, float and string values are   */
+/*      translated, with the same semantics (including the handling     */
+/*      of NULL values).  Other sub-expressions are evaluated with      */
+/*      swq_expr_node::Evaluate().                                      */
+/************************************************************************/
+
+class OGRFeatureQueryProgram
+{
+    typedef enum
+    {
+        VK_INTEGER,
+        VK_FLOAT,
+        VK_STRING
+    } ValueKind;
+
+    typedef enum
+    {
+        OP_FIELD_INTEGER,
+        OP_FIELD_INTEGER64,
+        OP_FIELD_FLOAT,
+        OP_FIELD_STRING,
+        OP_CONSTANT,
+        OP_EVALUATE_NODE,
+        OP_INTEGER_TO_FLOAT,
+        OP_COMPARE_INTEGER,
+        OP_COMPARE_FLOAT,
+        OP_COMPARE_STRING,
+        OP_LIKE,
+        OP_ISNULL,
+        OP_NOT,
+        OP_AND_SHORTCUT,
+        OP_OR_SHORTCUT,
+        OP_AND,
+        OP_OR,
+        OP_ARITHMETIC_INTEGER,
+        OP_ARITHMETIC_FLOAT
+    } Opcode;
+
+    typedef struct
+    {
+        GIntBig     nInt;
+        double      dfFloat;
+        const char *pszStr;
+        bool        bNull;
+    } Value;
+
+    typedef struct
+    {
+        Opcode          eOpcode;
+        int             nOperation;
+        // Field index, number of operands, or jump target.
+        int             nArg;
+        Value           sValue;
+        swq_expr_node  *poNode;
+    } Instruction;
+
+    OGRFeatureDefn             *m_poDefn;
+    std::vector<Instruction>    m_asInstructions;
+    std::vector<Value>          m_asStack;
+    std::vector<swq_expr_node*> m_apoTempNodes;
+    ValueKind                   m_eResultKind;
+
+    void        Emit( Opcode eOpcode, int nOperation = 0, int nArg = 0,
+                      swq_expr_node *poNode = nullptr );
+    bool        CompileNode( swq_expr_node *poNode, bool &bMayBeNull,
+                             bool &bMayFail );
+    bool        CompileOperation( swq_expr_node *poNode, bool &bMayBeNull,
+                                  bool &bMayFail );
+    bool        CompileOperands( swq_expr_node *poNode, ValueKind eKind,
+                                 bool &bMayBeNull, bool &bMayFail );
+    void        FreeTempNodes();
+
+    static bool GetValueKind( swq_field_type eType, ValueKind &eKind );
+    static bool CompareIntegers( int nOperation, GIntBig a, GIntBig b );
+    static bool CompareFloats( int nOperation, double a, double b );
+    static bool CompareStrings( int nOperation, const char *a,
+                                const char *b );
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRFeatureQueryProgram)
+
+  public:
+    explicit    OGRFeatureQueryProgram( OGRFeatureDefn *poDefn );
+               ~OGRFeatureQueryProgram();
+
+    bool        Compile( swq_expr_node *poExpr );
+    bool        Evaluate( OGRFeature *poFeature, int &bResult );
+};
+
 /************************************************************************/
 /*                          OGRFeatureQuery()                           */
 /************************************************************************/
 
 OGRFeatureQuery::OGRFeatureQuery() :
     poTargetDefn(nullptr),
-    pSWQExpr(nullptr)
+    pSWQExpr(nullptr),
+    poProgram(nullptr),
+    bProgramCompiled(false)
 {}
 
 /************************************************************************/
@@ -73,6 +174,7 @@ OGRFeatureQuery::OGRFeatureQuery() :
 OGRFeatureQuery::~OGRFeatureQuery()
 
 {
+    delete poProgram;
     delete static_cast<swq_expr_node *>(pSWQExpr);
 }
 
@@ -117,6 +219,9 @@ OGRFeatureQuery::Compile( OGRLayer *poLayer,
                           swq_custom_func_registrar *poCustomFuncRegistrar )
 {
     // Clear any existing expression.
+    delete poProgram;
+    poProgram = nullptr;
+    bProgramCompiled = false;
     if( pSWQExpr != nullptr )
     {
         delete static_cast<swq_expr_node *>(pSWQExpr);
@@ -324,409 +429,1741 @@ static swq_expr_node *OGRFeatureFetcher( swq_expr_node *op, void *pFeatureIn )
 }
 
 /************************************************************************/
-/*                              Evaluate()                              */
+/*                       OGRFeatureQueryProgram()                       */
 /************************************************************************/
 
-int OGRFeatureQuery::Evaluate( OGRFeature *poFeature )
+OGRFeatureQueryProgram::OGRFeatureQueryProgram( OGRFeatureDefn *poDefn ) :
+    m_poDefn(poDefn),
+    m_eResultKind(VK_INTEGER)
+{}
 
-{
-    if( pSWQExpr == nullptr )
-        return FALSE;
+/************************************************************************/
+/*                      ~OGRFeatureQueryProgram()                       */
+/************************************************************************/
 
-    swq_expr_node *poResult =
-        static_cast<swq_expr_node *>(pSWQExpr)->
-            Evaluate(OGRFeatureFetcher, poFeature);
+OGRFeatureQueryProgram::~OGRFeatureQueryProgram()
+{
+    FreeTempNodes();
+}
 
-    if( poResult == nullptr )
-        return FALSE;
+/************************************************************************/
+/*                            FreeTempNodes()                           */
+/************************************************************************/
 
-    bool bLogicalResult = false;
-    if( poResult->field_type == SWQ_INTEGER ||
-        poResult->field_type == SWQ_INTEGER64 ||
-        poResult->field_type == SWQ_BOOLEAN )
-        bLogicalResult = CPL_TO_BOOL(static_cast<int>(poResult->int_value));
+void OGRFeatureQueryProgram::FreeTempNodes()
+{
+    for( size_t i = 0; i < m_apoTempNodes.size(); i++ )
+        delete m_apoTempNodes[i];
+    m_apoTempNodes.clear();
+}
 
-    delete poResult;
+/************************************************************************/
+/*                            GetValueKind()                            */
+/************************************************************************/
 
-    return bLogicalResult;
+bool OGRFeatureQueryProgram::GetValueKind( swq_field_type eType,
+                                           ValueKind &eKind )
+{
+    switch( eType )
+    {
+        case SWQ_INTEGER:
+        case SWQ_INTEGER64:
+        case SWQ_BOOLEAN:
+            eKind = VK_INTEGER;
+            return true;
+
+        case SWQ_FLOAT:
+            eKind = VK_FLOAT;
+            return true;
+
+        case SWQ_STRING:
+            eKind = VK_STRING;
+            return true;
+
+        default:
+            return false;
+    }
 }
 
 /************************************************************************/
-/*                            CanUseIndex()                             */
+/*                                Emit()                                */
 /************************************************************************/
 
-int OGRFeatureQuery::CanUseIndex( OGRLayer *poLayer )
+void OGRFeatureQueryProgram::Emit( Opcode eOpcode, int nOperation, int nArg,
+                                   swq_expr_node *poNode )
 {
-    swq_expr_node *psExpr = static_cast<swq_expr_node *>(pSWQExpr);
+    Instruction sInstr;
+    sInstr.eOpcode = eOpcode;
+    sInstr.nOperation = nOperation;
+    sInstr.nArg = nArg;
+    sInstr.sValue.nInt = 0;
+    sInstr.sValue.dfFloat = 0.0;
+    sInstr.sValue.pszStr = nullptr;
+    sInstr.sValue.bNull = false;
+    sInstr.poNode = poNode;
+    m_asInstructions.push_back(sInstr);
+}
 
-    // Do we have an index on the targeted layer?
-    if( poLayer->GetIndex() == nullptr )
-        return FALSE;
+/************************************************************************/
+/*                              Compile()                               */
+/*                                                                      */
+/*      Returns false if the expression cannot be usefully compiled.    */
+/************************************************************************/
 
-    return CanUseIndex(psExpr, poLayer);
+bool OGRFeatureQueryProgram::Compile( swq_expr_node *poExpr )
+{
+    bool bMayBeNull = false;
+    bool bMayFail = false;
+    if( !CompileNode(poExpr, bMayBeNull, bMayFail) ||
+        (m_asInstructions.size() == 1 &&
+         m_asInstructions[0].eOpcode == OP_EVALUATE_NODE) )
+    {
+        return false;
+    }
+    GetValueKind(poExpr->field_type, m_eResultKind);
+    return true;
 }
 
-int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
-                                  OGRLayer *poLayer )
+/************************************************************************/
+/*                            CompileNode()                             */
+/*                                                                      */
+/*      Emit the instructions pushing the value of poNode on the        */
+/*      stack.  Sub-expressions that cannot be translated are           */
+/*      evaluated with swq_expr_node::Evaluate() if their type is       */
+/*      supported.                                                      */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::CompileNode( swq_expr_node *poNode,
+                                          bool &bMayBeNull, bool &bMayFail )
 {
-    // Does the expression meet our requirements?
-    if( psExpr == nullptr || psExpr->eNodeType != SNT_OPERATION )
-        return FALSE;
+    ValueKind eKind = VK_INTEGER;
+    if( !GetValueKind(poNode->field_type, eKind) )
+        return false;
 
-    if( (psExpr->nOperation == SWQ_OR || psExpr->nOperation == SWQ_AND) &&
-         psExpr->nSubExprCount == 2 )
+    const size_t nStartInstr = m_asInstructions.size();
+
+    if( poNode->eNodeType == SNT_CONSTANT )
     {
-        return CanUseIndex(psExpr->papoSubExpr[0], poLayer) &&
-               CanUseIndex(psExpr->papoSubExpr[1], poLayer);
+        Emit( OP_CONSTANT );
+        Value &sValue = m_asInstructions.back().sValue;
+        sValue.nInt = poNode->int_value;
+        sValue.dfFloat = poNode->float_value;
+        sValue.pszStr = poNode->string_value;
+        sValue.bNull = CPL_TO_BOOL(poNode->is_null);
+        if( eKind == VK_STRING && sValue.pszStr == nullptr )
+        {
+            m_asInstructions.resize(nStartInstr);
+            return false;
+        }
+        bMayBeNull = sValue.bNull;
+        bMayFail = false;
+        return true;
     }
 
-    if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN)
-        || psExpr->nSubExprCount < 2 )
-        return FALSE;
-
-    swq_expr_node *poColumn = psExpr->papoSubExpr[0];
-    swq_expr_node *poValue = psExpr->papoSubExpr[1];
-
-    if( poColumn->eNodeType != SNT_COLUMN
-        || poValue->eNodeType != SNT_CONSTANT )
-        return FALSE;
+    if( poNode->eNodeType == SNT_COLUMN )
+    {
+        if( poNode->table_index != 0 )
+            return false;
+        const int idx = OGRFeatureFetcherFixFieldIndex(m_poDefn,
+                                                       poNode->field_index);
+        switch( poNode->field_type )
+        {
+            case SWQ_INTEGER:
+            case SWQ_BOOLEAN:
+                Emit( OP_FIELD_INTEGER, 0, idx );
+                break;
+            case SWQ_INTEGER64:
+                Emit( OP_FIELD_INTEGER64, 0, idx );
+                break;
+            case SWQ_FLOAT:
+                Emit( OP_FIELD_FLOAT, 0, idx );
+                break;
+            default:
+                // GetFieldAsString() returns a temporary buffer for
+                // non-string fields, so only regular string fields are
+                // directly fetched.
+                if( idx < m_poDefn->GetFieldCount() &&
+                    m_poDefn->GetFieldDefn(idx)->GetType() == OFTString )
+                    Emit( OP_FIELD_STRING, 0, idx );
+                else
+                    Emit( OP_EVALUATE_NODE, 0, 0, poNode );
+                break;
+        }
+        bMayBeNull = true;
+        bMayFail = false;
+        return true;
+    }
 
-    OGRAttrIndex *poIndex =
-        poLayer->GetIndex()->GetFieldIndex(
-            OGRFeatureFetcherFixFieldIndex(poLayer->GetLayerDefn(),
-                                           poColumn->field_index));
-    if( poIndex == nullptr )
-        return FALSE;
+    if( CompileOperation(poNode, bMayBeNull, bMayFail) )
+        return true;
 
-    // Have an index.
-    return TRUE;
+    // Fallback to the generic evaluator for that sub-expression.
+    m_asInstructions.resize(nStartInstr);
+    Emit( OP_EVALUATE_NODE, 0, 0, poNode );
+    bMayBeNull = true;
+    bMayFail = true;
+    return true;
 }
 
 /************************************************************************/
-/*                       EvaluateAgainstIndices()                       */
-/*                                                                      */
-/*      Attempt to return a list of FIDs matching the given             */
-/*      attribute query conditions utilizing attribute indices.         */
-/*      Returns NULL if the result cannot be computed from the          */
-/*      available indices, or an "OGRNullFID" terminated list of        */
-/*      FIDs if it can.                                                 */
+/*                          CompileOperands()                           */
 /*                                                                      */
-/*      For now we only support equality tests on a single indexed      */
-/*      attribute field.  Eventually we should make this support        */
-/*      multi-part queries with ranges.                                 */
+/*      Emit the operands of an operation, which must all be of kind    */
+/*      eKind, except for the two first ones of float operations        */
+/*      that can be integers (they are then converted, as done in       */
+/*      SWQGeneralEvaluator()).                                         */
 /************************************************************************/
 
-static int CompareGIntBig( const void *pa, const void *pb )
+bool OGRFeatureQueryProgram::CompileOperands( swq_expr_node *poNode,
+                                              ValueKind eKind,
+                                              bool &bMayBeNull,
+                                              bool &bMayFail )
 {
-    const GIntBig a = *(reinterpret_cast<const GIntBig *>(pa));
-    const GIntBig b = *(reinterpret_cast<const GIntBig *>(pb));
-    if( a < b )
-        return -1;
-    else if( a > b )
-        return 1;
-    else
-        return 0;
+    bMayBeNull = false;
+    bMayFail = false;
+    for( int i = 0; i < poNode->nSubExprCount; i++ )
+    {
+        swq_expr_node *poSubExpr = poNode->papoSubExpr[i];
+        ValueKind eSubKind = VK_INTEGER;
+        if( !GetValueKind(poSubExpr->field_type, eSubKind) )
+            return false;
+        const bool bConvert = eKind == VK_FLOAT && eSubKind == VK_INTEGER &&
+                              i < 2;
+        if( eSubKind != eKind && !bConvert )
+            return false;
+
+        bool bSubMayBeNull = false;
+        bool bSubMayFail = false;
+        if( !CompileNode(poSubExpr, bSubMayBeNull, bSubMayFail) )
+            return false;
+        if( bConvert )
+            Emit( OP_INTEGER_TO_FLOAT );
+        bMayBeNull |= bSubMayBeNull;
+        bMayFail |= bSubMayFail;
+    }
+    return true;
 }
 
-GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( OGRLayer *poLayer,
-                                                  OGRErr *peErr )
+/************************************************************************/
+/*                          CompileOperation()                          */
+/************************************************************************/
 
+bool OGRFeatureQueryProgram::CompileOperation( swq_expr_node *poNode,
+                                               bool &bMayBeNull,
+                                               bool &bMayFail )
 {
-    swq_expr_node *psExpr = static_cast<swq_expr_node *>(pSWQExpr);
-
-    if( peErr != nullptr )
-        *peErr = OGRERR_NONE;
-
-    // Do we have an index on the targeted layer?
-    if( poLayer->GetIndex() == nullptr )
-        return nullptr;
-
-    GIntBig nFIDCount = 0;
-    return EvaluateAgainstIndices(psExpr, poLayer, nFIDCount);
-}
+    const int nOperation = poNode->nOperation;
+    const int nSubExprCount = poNode->nSubExprCount;
+    if( nSubExprCount < 1 )
+        return false;
 
-// The input arrays must be sorted.
-static
-GIntBig* OGRORGIntBigArray( GIntBig panFIDList1[], GIntBig nFIDCount1,
-                            GIntBig panFIDList2[], GIntBig nFIDCount2,
-                            GIntBig& nFIDCount )
-{
-    const GIntBig nMaxCount = nFIDCount1 + nFIDCount2;
-    GIntBig* panFIDList = static_cast<GIntBig *>(
-        CPLMalloc(static_cast<size_t>(nMaxCount + 1) * sizeof(GIntBig)));
-    nFIDCount = 0;
+    if( nOperation == SWQ_ISNULL )
+    {
+        if( nSubExprCount != 1 ||
+            !CompileNode(poNode->papoSubExpr[0], bMayBeNull, bMayFail) )
+            return false;
+        Emit( OP_ISNULL );
+        bMayBeNull = false;
+        return true;
+    }
 
-    for( GIntBig i1 = 0, i2 = 0; i1<nFIDCount1 || i2<nFIDCount2; )
+    // Determine the branch of SWQGeneralEvaluator() that would be taken.
+    ValueKind eKind0 = VK_INTEGER;
+    ValueKind eKind1 = VK_INTEGER;
+    if( !GetValueKind(poNode->papoSubExpr[0]->field_type, eKind0) )
+        return false;
+    if( nSubExprCount > 1 &&
+        !GetValueKind(poNode->papoSubExpr[1]->field_type, eKind1) )
+        return false;
+    ValueKind eKind = VK_STRING;
+    if( eKind0 == VK_FLOAT || (nSubExprCount > 1 && eKind1 == VK_FLOAT) )
+        eKind = VK_FLOAT;
+    else if( eKind0 == VK_INTEGER )
+        eKind = VK_INTEGER;
+
+    switch( nOperation )
     {
-        if( i1 < nFIDCount1 && i2 < nFIDCount2 )
+        case SWQ_NOT:
         {
-            const GIntBig nVal1 = panFIDList1[i1];
-            const GIntBig nVal2 = panFIDList2[i2];
-            if( nVal1 < nVal2 )
-            {
-                if( i1 + 1 < nFIDCount1 && panFIDList1[i1+1] <= nVal2 )
-                {
-                    panFIDList[nFIDCount++] = nVal1;
-                    i1++;
-                }
-                else
-                {
-                    panFIDList[nFIDCount++] = nVal1;
-                    panFIDList[nFIDCount++] = nVal2;
-                    i1++;
-                    i2++;
-                }
-            }
-            else if( nVal1 == nVal2 )
+            if( nSubExprCount != 1 || eKind != VK_INTEGER ||
+                poNode->field_type != SWQ_BOOLEAN ||
+                !CompileOperands(poNode, eKind, bMayBeNull, bMayFail) )
+                return false;
+            Emit( OP_NOT );
+            bMayBeNull = false;
+            return true;
+        }
+
+        case SWQ_AND:
+        case SWQ_OR:
+        {
+            if( nSubExprCount != 2 || eKind != VK_INTEGER ||
+                eKind1 != VK_INTEGER ||
+                poNode->field_type != SWQ_BOOLEAN )
+                return false;
+
+            bool bMayBeNull0 = false;
+            bool bMayFail0 = false;
+            if( !CompileNode(poNode->papoSubExpr[0], bMayBeNull0, bMayFail0) )
+                return false;
+            const size_t iShortcut = m_asInstructions.size();
+            Emit( nOperation == SWQ_AND ? OP_AND_SHORTCUT : OP_OR_SHORTCUT,
+                  0, -1 );
+            bool bMayBeNull1 = false;
+            bool bMayFail1 = false;
+            if( !CompileNode(poNode->papoSubExpr[1], bMayBeNull1, bMayFail1) )
+                return false;
+            Emit( nOperation == SWQ_AND ? OP_AND : OP_OR );
+
+            // The second operand can only be skipped if this does not
+            // change the result: it must not fail, and for OR, a NULL
+            // second operand turns TRUE into FALSE.
+            if( !bMayFail1 && (nOperation == SWQ_AND || !bMayBeNull1) )
             {
-                panFIDList[nFIDCount++] = nVal1;
-                i1++;
-                i2++;
+                m_asInstructions[iShortcut].nArg =
+                    static_cast<int>(m_asInstructions.size());
             }
-            else
+            else if( nOperation == SWQ_OR && !bMayFail1 )
             {
-                if( i2 + 1 < nFIDCount2 && panFIDList2[i2+1] <= nVal1 )
-                {
-                    panFIDList[nFIDCount++] = nVal2;
-                    i2++;
-                }
-                else
-                {
-                    panFIDList[nFIDCount++] = nVal2;
-                    panFIDList[nFIDCount++] = nVal1;
-                    i1++;
-                    i2++;
-                }
+                // Only skip if the first operand is NULL.
+                m_asInstructions[iShortcut].nOperation = 1;
+                m_asInstructions[iShortcut].nArg =
+                    static_cast<int>(m_asInstructions.size());
             }
+
+            bMayBeNull = false;
+            bMayFail = bMayFail0 || bMayFail1;
+            return true;
         }
-        else if( i1 < nFIDCount1 )
+
+        case SWQ_EQ:
+        case SWQ_NE:
+        case SWQ_GT:
+        case SWQ_LT:
+        case SWQ_GE:
+        case SWQ_LE:
+        case SWQ_IN:
+        case SWQ_BETWEEN:
         {
-            const GIntBig nVal1 = panFIDList1[i1];
-            panFIDList[nFIDCount++] = nVal1;
-            i1++;
+            if( poNode->field_type != SWQ_BOOLEAN || nSubExprCount < 2 ||
+                (nOperation == SWQ_BETWEEN && nSubExprCount != 3) ||
+                (nOperation != SWQ_BETWEEN && nOperation != SWQ_IN &&
+                 nSubExprCount != 2) ||
+                !CompileOperands(poNode, eKind, bMayBeNull, bMayFail) )
+                return false;
+            Emit( eKind == VK_INTEGER ? OP_COMPARE_INTEGER :
+                  eKind == VK_FLOAT ? OP_COMPARE_FLOAT : OP_COMPARE_STRING,
+                  nOperation, nSubExprCount );
+            bMayBeNull = false;
+            return true;
         }
-        else if( i2 < nFIDCount2 )
+
+        case SWQ_LIKE:
         {
-            const GIntBig nVal2 = panFIDList2[i2];
-            panFIDList[nFIDCount++] = nVal2;
-            i2++;
+            if( poNode->field_type != SWQ_BOOLEAN || eKind != VK_STRING ||
+                (nSubExprCount != 2 && nSubExprCount != 3) ||
+                !CompileOperands(poNode, eKind, bMayBeNull, bMayFail) )
+                return false;
+            Emit( OP_LIKE, nOperation, nSubExprCount );
+            bMayBeNull = false;
+            return true;
         }
-    }
-
-    panFIDList[nFIDCount] = OGRNullFID;
-
-    return panFIDList;
-}
-
-// The input arrays must be sorted.
-static
-GIntBig* OGRANDGIntBigArray( GIntBig panFIDList1[], GIntBig nFIDCount1,
-                             GIntBig panFIDList2[], GIntBig nFIDCount2,
-                             GIntBig& nFIDCount )
-{
-    GIntBig nMaxCount = std::max(nFIDCount1, nFIDCount2);
-    GIntBig* panFIDList = static_cast<GIntBig *>(
-        CPLMalloc(static_cast<size_t>(nMaxCount + 1) * sizeof(GIntBig)));
-    nFIDCount = 0;
 
-    for( GIntBig i1 = 0, i2 = 0; i1 < nFIDCount1 && i2 < nFIDCount2; )
-    {
-        const GIntBig nVal1 = panFIDList1[i1];
-        const GIntBig nVal2 = panFIDList2[i2];
-        if( nVal1 < nVal2 )
+        case SWQ_ADD:
+        case SWQ_SUBTRACT:
+        case SWQ_MULTIPLY:
+        case SWQ_DIVIDE:
+        case SWQ_MODULUS:
         {
-            if( i1+1 < nFIDCount1 && panFIDList1[i1+1] <= nVal2 )
-            {
-                i1++;
-            }
-            else
+            if( nSubExprCount != 2 )
+                return false;
+            if( eKind == VK_INTEGER )
             {
-                i1++;
-                i2++;
+                if( !SWQ_IS_INTEGER(poNode->field_type) )
+                    return false;
             }
-        }
-        else if( nVal1 == nVal2 )
-        {
-            panFIDList[nFIDCount++] = nVal1;
-            i1++;
-            i2++;
-        }
-        else
-        {
-            if( i2 + 1 < nFIDCount2 && panFIDList2[i2+1] <= nVal1 )
+            else if( eKind == VK_FLOAT )
             {
-                i2++;
+                // MODULUS on floats returns an integer.
+                if( poNode->field_type != SWQ_FLOAT ||
+                    nOperation == SWQ_MODULUS )
+                    return false;
             }
             else
             {
-                i1++;
-                i2++;
+                // String concatenation.
+                return false;
             }
+            if( !CompileOperands(poNode, eKind, bMayBeNull, bMayFail) )
+                return false;
+            Emit( eKind == VK_INTEGER ? OP_ARITHMETIC_INTEGER :
+                                        OP_ARITHMETIC_FLOAT, nOperation );
+            return true;
         }
+
+        default:
+            return false;
     }
+}
 
-    panFIDList[nFIDCount] = OGRNullFID;
+/************************************************************************/
+/*                          CompareIntegers()                           */
+/************************************************************************/
 
-    return panFIDList;
+bool OGRFeatureQueryProgram::CompareIntegers( int nOperation,
+                                              GIntBig a, GIntBig b )
+{
+    switch( nOperation )
+    {
+        case SWQ_EQ: return a == b;
+        case SWQ_NE: return a != b;
+        case SWQ_GT: return a > b;
+        case SWQ_LT: return a < b;
+        case SWQ_GE: return a >= b;
+        case SWQ_LE: return a <= b;
+        default: return false;
+    }
 }
 
-GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
-                                                  OGRLayer *poLayer,
-                                                  GIntBig& nFIDCount )
+/************************************************************************/
+/*                           CompareFloats()                            */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::CompareFloats( int nOperation,
+                                            double a, double b )
 {
-    // Does the expression meet our requirements?
-    if( psExpr == nullptr ||
-        psExpr->eNodeType != SNT_OPERATION )
-        return nullptr;
+    switch( nOperation )
+    {
+        case SWQ_EQ: return a == b;
+        case SWQ_NE: return a != b;
+        case SWQ_GT: return a > b;
+        case SWQ_LT: return a < b;
+        case SWQ_GE: return a >= b;
+        case SWQ_LE: return a <= b;
+        default: return false;
+    }
+}
 
-    if( (psExpr->nOperation == SWQ_OR || psExpr->nOperation == SWQ_AND) &&
-         psExpr->nSubExprCount == 2 )
+/************************************************************************/
+/*                           CompareStrings()                           */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::CompareStrings( int nOperation,
+                                             const char *a, const char *b )
+{
+    switch( nOperation )
     {
-        GIntBig nFIDCount1 = 0;
-        GIntBig nFIDCount2 = 0;
-        GIntBig* panFIDList1 =
-            EvaluateAgainstIndices(psExpr->papoSubExpr[0], poLayer, nFIDCount1);
-        GIntBig* panFIDList2 =
-            panFIDList1 == nullptr ? nullptr :
-            EvaluateAgainstIndices(psExpr->papoSubExpr[1], poLayer, nFIDCount2);
-        GIntBig* panFIDList = nullptr;
-        if( panFIDList1 != nullptr && panFIDList2 != nullptr )
-        {
-            if( psExpr->nOperation == SWQ_OR )
-                panFIDList = OGRORGIntBigArray(panFIDList1, nFIDCount1,
-                                            panFIDList2, nFIDCount2, nFIDCount);
-            else if( psExpr->nOperation == SWQ_AND )
-                panFIDList = OGRANDGIntBigArray(panFIDList1, nFIDCount1,
-                                            panFIDList2, nFIDCount2, nFIDCount);
-        }
-        CPLFree(panFIDList1);
-        CPLFree(panFIDList2);
-        return panFIDList;
+        case SWQ_EQ: return swq_test_string_equal(a, b) != 0;
+        case SWQ_NE: return strcasecmp(a, b) != 0;
+        case SWQ_GT: return strcasecmp(a, b) > 0;
+        case SWQ_LT: return strcasecmp(a, b) < 0;
+        case SWQ_GE: return strcasecmp(a, b) >= 0;
+        case SWQ_LE: return strcasecmp(a, b) <= 0;
+        default: return false;
     }
+}
 
-    if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN)
-        || psExpr->nSubExprCount < 2 )
-        return nullptr;
-
-    swq_expr_node *poColumn = psExpr->papoSubExpr[0];
-    swq_expr_node *poValue = psExpr->papoSubExpr[1];
+/************************************************************************/
+/*                              Evaluate()                              */
+/*                                                                      */
+/*      Returns false if the program could not be evaluated on this     */
+/*      feature, in which case the expression tree must be evaluated.   */
+/************************************************************************/
 
-    if( poColumn->eNodeType != SNT_COLUMN
-        || poValue->eNodeType != SNT_CONSTANT )
-        return nullptr;
+bool OGRFeatureQueryProgram::Evaluate( OGRFeature *poFeature, int &bResult )
+{
+    if( poFeature->GetDefnRef() != m_poDefn )
+        return false;
 
-    const int nIdx = OGRFeatureFetcherFixFieldIndex(
-        poLayer->GetLayerDefn(), poColumn->field_index);
+    m_asStack.clear();
+    bool bOK = true;
+    const int nInstructions = static_cast<int>(m_asInstructions.size());
+    for( int iPC = 0; bOK && iPC < nInstructions; iPC++ )
+    {
+        const Instruction &sInstr = m_asInstructions[iPC];
+        switch( sInstr.eOpcode )
+        {
+            case OP_FIELD_INTEGER:
+            case OP_FIELD_INTEGER64:
+            case OP_FIELD_FLOAT:
+            case OP_FIELD_STRING:
+            {
+                Value sValue;
+                sValue.nInt = 0;
+                sValue.dfFloat = 0.0;
+                sValue.pszStr = nullptr;
+                if( sInstr.eOpcode == OP_FIELD_INTEGER )
+                    sValue.nInt = poFeature->GetFieldAsInteger(sInstr.nArg);
+                else if( sInstr.eOpcode == OP_FIELD_INTEGER64 )
+                    sValue.nInt = poFeature->GetFieldAsInteger64(sInstr.nArg);
+                else if( sInstr.eOpcode == OP_FIELD_FLOAT )
+                    sValue.dfFloat = poFeature->GetFieldAsDouble(sInstr.nArg);
+                else
+                    sValue.pszStr = poFeature->GetFieldAsString(sInstr.nArg);
+                sValue.bNull = !poFeature->IsFieldSetAndNotNull(sInstr.nArg);
+                m_asStack.push_back(sValue);
+                break;
+            }
 
-    OGRAttrIndex *poIndex =
-        poLayer->GetIndex()->GetFieldIndex(nIdx);
-    if( poIndex == nullptr )
-        return nullptr;
+            case OP_CONSTANT:
+                m_asStack.push_back(sInstr.sValue);
+                break;
 
-    // Have an index, now we need to query it.
-    OGRField sValue;
-    OGRFieldDefn *poFieldDefn =
-        poLayer->GetLayerDefn()->GetFieldDefn(nIdx);
+            case OP_EVALUATE_NODE:
+            {
+                swq_expr_node *poRet =
+                    sInstr.poNode->Evaluate(OGRFeatureFetcher, poFeature);
+                if( poRet == nullptr )
+                {
+                    // Same as an evaluation error of the whole tree.
+                    FreeTempNodes();
+                    bResult = FALSE;
+                    return true;
+                }
+                ValueKind eExpectedKind = VK_INTEGER;
+                ValueKind eKind = VK_INTEGER;
+                GetValueKind(sInstr.poNode->field_type, eExpectedKind);
+                if( !GetValueKind(poRet->field_type, eKind) ||
+                    eKind != eExpectedKind ||
+                    (eKind == VK_STRING && poRet->string_value == nullptr) )
+                {
+                    delete poRet;
+                    bOK = false;
+                    break;
+                }
+                m_apoTempNodes.push_back(poRet);
+                Value sValue;
+                sValue.nInt = poRet->int_value;
+                sValue.dfFloat = poRet->float_value;
+                sValue.pszStr = poRet->string_value;
+                sValue.bNull = CPL_TO_BOOL(poRet->is_null);
+                m_asStack.push_back(sValue);
+                break;
+            }
 
-    // Handle the case of an IN operation.
-    if( psExpr->nOperation == SWQ_IN )
-    {
-        int nLength = 0;
-        GIntBig *panFIDs = nullptr;
-        nFIDCount = 0;
+            case OP_INTEGER_TO_FLOAT:
+            {
+                Value &sValue = m_asStack.back();
+                sValue.dfFloat = static_cast<double>(sValue.nInt);
+                break;
+            }
 
-        for( int iIN = 1; iIN < psExpr->nSubExprCount; iIN++ )
-        {
-            switch( poFieldDefn->GetType() )
+            case OP_COMPARE_INTEGER:
+            case OP_COMPARE_FLOAT:
+            case OP_COMPARE_STRING:
+            case OP_LIKE:
             {
-              case OFTInteger:
-                if( psExpr->papoSubExpr[iIN]->field_type == SWQ_FLOAT )
-                    sValue.Integer =
-                        static_cast<int>(psExpr->papoSubExpr[iIN]->float_value);
+                const size_t nFirst = m_asStack.size() - sInstr.nArg;
+                const Value *pasArgs = &m_asStack[nFirst];
+                bool bRet = true;
+                for( int i = 0; i < sInstr.nArg; i++ )
+                {
+                    if( pasArgs[i].bNull )
+                        bRet = false;
+                }
+                if( !bRet )
+                {
+                    // NULL operand: FALSE.
+                }
+                else if( sInstr.eOpcode == OP_LIKE )
+                {
+                    const char chEscape =
+                        sInstr.nArg == 3 ? pasArgs[2].pszStr[0] : '\0';
+                    bRet = swq_test_like(pasArgs[0].pszStr,
+                                         pasArgs[1].pszStr, chEscape) != 0;
+                }
+                else if( sInstr.nOperation == SWQ_IN )
+                {
+                    bRet = false;
+                    for( int i = 1; !bRet && i < sInstr.nArg; i++ )
+                    {
+                        if( sInstr.eOpcode == OP_COMPARE_INTEGER )
+                            bRet = pasArgs[0].nInt == pasArgs[i].nInt;
+                        else if( sInstr.eOpcode == OP_COMPARE_FLOAT )
+                            bRet = pasArgs[0].dfFloat == pasArgs[i].dfFloat;
+                        else
+                            bRet = strcasecmp(pasArgs[0].pszStr,
+                                              pasArgs[i].pszStr) == 0;
+                    }
+                }
+                else if( sInstr.nOperation == SWQ_BETWEEN )
+                {
+                    if( sInstr.eOpcode == OP_COMPARE_INTEGER )
+                        bRet = pasArgs[0].nInt >= pasArgs[1].nInt &&
+                               pasArgs[0].nInt <= pasArgs[2].nInt;
+                    else if( sInstr.eOpcode == OP_COMPARE_FLOAT )
+                        bRet = pasArgs[0].dfFloat >= pasArgs[1].dfFloat &&
+                               pasArgs[0].dfFloat <= pasArgs[2].dfFloat;
+                    else
+                        bRet = strcasecmp(pasArgs[0].pszStr,
+                                          pasArgs[1].pszStr) >= 0 &&
+                               strcasecmp(pasArgs[0].pszStr,
+                                          pasArgs[2].pszStr) <= 0;
+                }
+                else if( sInstr.eOpcode == OP_COMPARE_INTEGER )
+                {
+                    bRet = CompareIntegers(sInstr.nOperation,
+                                           pasArgs[0].nInt, pasArgs[1].nInt);
+                }
+                else if( sInstr.eOpcode == OP_COMPARE_FLOAT )
+                {
+                    bRet = CompareFloats(sInstr.nOperation,
+                                         pasArgs[0].dfFloat,
+                                         pasArgs[1].dfFloat);
+                }
                 else
-                    sValue.Integer =
-                        static_cast<int>(psExpr->papoSubExpr[iIN]->int_value);
+                {
+                    bRet = CompareStrings(sInstr.nOperation,
+                                          pasArgs[0].pszStr,
+                                          pasArgs[1].pszStr);
+                }
+                m_asStack.resize(nFirst + 1);
+                m_asStack[nFirst].nInt = bRet;
+                m_asStack[nFirst].bNull = false;
+                break;
+            }
+
+            case OP_ISNULL:
+            {
+                Value &sValue = m_asStack.back();
+                sValue.nInt = sValue.bNull;
+                sValue.bNull = false;
                 break;
+            }
+
+            case OP_NOT:
+            {
+                Value &sValue = m_asStack.back();
+                sValue.nInt = !sValue.bNull && sValue.nInt == 0;
+                sValue.bNull = false;
+                break;
+            }
+
+            case OP_AND_SHORTCUT:
+            {
+                Value &sValue = m_asStack.back();
+                if( sInstr.nArg >= 0 && (sValue.bNull || sValue.nInt == 0) )
+                {
+                    sValue.nInt = FALSE;
+                    sValue.bNull = false;
+                    iPC = sInstr.nArg - 1;
+                }
+                break;
+            }
+
+            case OP_OR_SHORTCUT:
+            {
+                Value &sValue = m_asStack.back();
+                if( sInstr.nArg >= 0 &&
+                    (sValue.bNull ||
+                     (sInstr.nOperation == 0 && sValue.nInt != 0)) )
+                {
+                    sValue.nInt = !sValue.bNull && sValue.nInt != 0;
+                    sValue.bNull = false;
+                    iPC = sInstr.nArg - 1;
+                }
+                break;
+            }
 
-              case OFTInteger64:
-                if( psExpr->papoSubExpr[iIN]->field_type == SWQ_FLOAT )
-                    sValue.Integer64 = static_cast<GIntBig>(
-                        psExpr->papoSubExpr[iIN]->float_value);
+            case OP_AND:
+            case OP_OR:
+            {
+                const Value sRight = m_asStack.back();
+                m_asStack.pop_back();
+                Value &sLeft = m_asStack.back();
+                if( sLeft.bNull || sRight.bNull )
+                    sLeft.nInt = FALSE;
+                else if( sInstr.eOpcode == OP_AND )
+                    sLeft.nInt = sLeft.nInt && sRight.nInt;
                 else
-                    sValue.Integer64 = psExpr->papoSubExpr[iIN]->int_value;
+                    sLeft.nInt = sLeft.nInt || sRight.nInt;
+                sLeft.bNull = false;
                 break;
+            }
 
-              case OFTReal:
-                sValue.Real = psExpr->papoSubExpr[iIN]->float_value;
+            case OP_ARITHMETIC_INTEGER:
+            {
+                const Value sRight = m_asStack.back();
+                m_asStack.pop_back();
+                Value &sLeft = m_asStack.back();
+                if( sLeft.bNull || sRight.bNull )
+                {
+                    sLeft.nInt = 0;
+                    sLeft.bNull = true;
+                    break;
+                }
+                switch( sInstr.nOperation )
+                {
+                    case SWQ_ADD:
+                        sLeft.nInt = sLeft.nInt + sRight.nInt;
+                        break;
+                    case SWQ_SUBTRACT:
+                        sLeft.nInt = sLeft.nInt - sRight.nInt;
+                        break;
+                    case SWQ_MULTIPLY:
+                        sLeft.nInt = sLeft.nInt * sRight.nInt;
+                        break;
+                    case SWQ_DIVIDE:
+                        sLeft.nInt = sRight.nInt == 0 ? INT_MAX :
+                                            sLeft.nInt / sRight.nInt;
+                        break;
+                    default:
+                        sLeft.nInt = sRight.nInt == 0 ? INT_MAX :
+                                            sLeft.nInt % sRight.nInt;
+                        break;
+                }
                 break;
+            }
 
-              case OFTString:
-                sValue.String = psExpr->papoSubExpr[iIN]->string_value;
+            case OP_ARITHMETIC_FLOAT:
+            {
+                const Value sRight = m_asStack.back();
+                m_asStack.pop_back();
+                Value &sLeft = m_asStack.back();
+                if( sLeft.bNull || sRight.bNull )
+                {
+                    sLeft.dfFloat = 0.0;
+                    sLeft.bNull = true;
+                    break;
+                }
+                switch( sInstr.nOperation )
+                {
+                    case SWQ_ADD:
+                        sLeft.dfFloat = sLeft.dfFloat + sRight.dfFloat;
+                        break;
+                    case SWQ_SUBTRACT:
+                        sLeft.dfFloat = sLeft.dfFloat - sRight.dfFloat;
+                        break;
+                    case SWQ_MULTIPLY:
+                        sLeft.dfFloat = sLeft.dfFloat * sRight.dfFloat;
+                        break;
+                    default:
+                        sLeft.dfFloat = sRight.dfFloat == 0 ? INT_MAX :
+                                            sLeft.dfFloat / sRight.dfFloat;
+                        break;
+                }
                 break;
+            }
+        }
+    }
 
-              default:
-                CPLAssert(false);
-                return nullptr;
+    if( bOK )
+    {
+        CPLAssert( m_asStack.size() == 1 );
+        bResult = m_eResultKind == VK_INTEGER &&
+                  static_cast<int>(m_asStack.back().nInt) != 0;
+    }
+    FreeTempNodes();
+    return bOK;
+}
+
+/************************************************************************/
+/*                              Evaluate()                              */
+/************************************************************************/
+
+int OGRFeatureQuery::Evaluate( OGRFeature *poFeature )
+
+{
+    if( pSWQExpr == nullptr )
+        return FALSE;
+
+    // Translate the expression on first use, since some drivers
+    // inspect (and possibly modify) the expression tree after Compile().
+    if( !bProgramCompiled )
+    {
+        bProgramCompiled = true;
+        if( CPLTestBool(CPLGetConfigOption("OGR_SQL_COMPILE_EXPRESSIONS",
+                                           "YES")) )
+        {
+            poProgram = new OGRFeatureQueryProgram(poTargetDefn);
+            if( !poProgram->Compile(static_cast<swq_expr_node *>(pSWQExpr)) )
+            {
+                delete poProgram;
+                poProgram = nullptr;
             }
+        }
+    }
+
+    int bProgramResult = FALSE;
+    if( poProgram != nullptr && poProgram->Evaluate(poFeature, bProgramResult) )
+        return bProgramResult;
+
+    swq_expr_node *poResult =
+        static_cast<swq_expr_node *>(pSWQExpr)->
+            Evaluate(OGRFeatureFetcher, poFeature);
+
+    if( poResult == nullptr )
+        return FALSE;
+
+    bool bLogicalResult = false;
+    if( poResult->field_type == SWQ_INTEGER ||
+        poResult->field_type == SWQ_INTEGER64 ||
+        poResult->field_type == SWQ_BOOLEAN )
+        bLogicalResult = CPL_TO_BOOL(static_cast<int>(poResult->int_value));
+
+    delete poResult;
+
+    return bLogicalResult;
+}
+
+/************************************************************************/
+/*                       OGRFeatureQueryIndexTerm                       */
+/*                                                                      */
+/*      A comparison between an attribute field and constant            */
+/*      value(s), normalized so that the column is on the left.         */
+/************************************************************************/
+
+struct OGRFeatureQueryIndexTerm
+{
+    swq_expr_node *poExpr;
+    int            iField;
+    int            nOperation;
+    swq_expr_node *poValue;
+    swq_expr_node *poValue2;    // Upper bound of BETWEEN.
+    CPLString      osPrefix;    // Literal prefix of a LIKE pattern.
+    bool           bConsumed;
+
+    OGRFeatureQueryIndexTerm() :
+        poExpr(nullptr), iField(-1), nOperation(SWQ_EQ),
+        poValue(nullptr), poValue2(nullptr), bConsumed(false) {}
+};
+
+/************************************************************************/
+/*                     OGRFeatureQueryAnalyzeTerm()                     */
+/************************************************************************/
+
+static bool OGRFeatureQueryAnalyzeTerm( swq_expr_node *psExpr,
+                                        OGRLayer *poLayer,
+                                        OGRFeatureQueryIndexTerm& oTerm )
+{
+    oTerm.poExpr = psExpr;
+    oTerm.iField = -1;
+
+    if( psExpr == nullptr || psExpr->eNodeType != SNT_OPERATION ||
+        psExpr->nSubExprCount < 2 )
+        return false;
+
+    int nOperation = psExpr->nOperation;
+    swq_expr_node *poColumn = psExpr->papoSubExpr[0];
+    swq_expr_node *poValue = psExpr->papoSubExpr[1];
+
+    switch( nOperation )
+    {
+      case SWQ_EQ:
+      case SWQ_GT:
+      case SWQ_GE:
+      case SWQ_LT:
+      case SWQ_LE:
+        if( psExpr->nSubExprCount != 2 )
+            return false;
+        // Accept "constant op column" by mirroring the operator.
+        if( poColumn->eNodeType == SNT_CONSTANT &&
+            poValue->eNodeType == SNT_COLUMN )
+        {
+            std::swap(poColumn, poValue);
+            if( nOperation == SWQ_GT )
+                nOperation = SWQ_LT;
+            else if( nOperation == SWQ_GE )
+                nOperation = SWQ_LE;
+            else if( nOperation == SWQ_LT )
+                nOperation = SWQ_GT;
+            else if( nOperation == SWQ_LE )
+                nOperation = SWQ_GE;
+        }
+        break;
+
+      case SWQ_IN:
+        for( int i = 2; i < psExpr->nSubExprCount; i++ )
+        {
+            if( psExpr->papoSubExpr[i]->eNodeType != SNT_CONSTANT )
+                return false;
+        }
+        break;
 
-            int nFIDCount32 = static_cast<int>(nFIDCount);
-            panFIDs = poIndex->GetAllMatches(&sValue, panFIDs,
-                                             &nFIDCount32, &nLength);
-            nFIDCount = nFIDCount32;
+      case SWQ_BETWEEN:
+        if( psExpr->nSubExprCount != 3 ||
+            psExpr->papoSubExpr[2]->eNodeType != SNT_CONSTANT ||
+            psExpr->papoSubExpr[2]->is_null )
+            return false;
+        oTerm.poValue2 = psExpr->papoSubExpr[2];
+        break;
+
+      case SWQ_LIKE:
+      {
+        if( poValue->eNodeType != SNT_CONSTANT ||
+            poValue->field_type != SWQ_STRING ||
+            poValue->string_value == nullptr )
+            return false;
+
+        char chEscape = '\0';
+        if( psExpr->nSubExprCount == 3 )
+        {
+            const swq_expr_node *poEscape = psExpr->papoSubExpr[2];
+            if( poEscape->eNodeType != SNT_CONSTANT ||
+                poEscape->field_type != SWQ_STRING ||
+                poEscape->string_value == nullptr )
+                return false;
+            chEscape = poEscape->string_value[0];
         }
 
-        if( nFIDCount > 1 )
+        // Only the literal part before the first wildcard can be
+        // looked up.
+        CPLString osPrefix;
+        for( const char *pszIter = poValue->string_value;
+             *pszIter != '\0'; pszIter++ )
         {
-            // The returned FIDs are expected to be in sorted order.
-            qsort(panFIDs, static_cast<size_t>(nFIDCount),
-                  sizeof(GIntBig), CompareGIntBig);
+            if( chEscape != '\0' && *pszIter == chEscape )
+            {
+                if( pszIter[1] == '\0' )
+                    break;
+                pszIter++;
+            }
+            else if( *pszIter == '%' || *pszIter == '_' )
+            {
+                break;
+            }
+            osPrefix += *pszIter;
         }
-        return panFIDs;
+        if( osPrefix.empty() )
+            return false;
+        oTerm.osPrefix = osPrefix;
+        break;
+      }
+
+      default:
+        return false;
     }
 
-    // Handle equality test.
-    switch( poFieldDefn->GetType() )
+    if( poColumn->eNodeType != SNT_COLUMN ||
+        poValue->eNodeType != SNT_CONSTANT ||
+        poValue->is_null )
+        return false;
+
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    const int iField =
+        OGRFeatureFetcherFixFieldIndex(poDefn, poColumn->field_index);
+    if( iField < 0 || iField >= poDefn->GetFieldCount() )
+        return false;
+
+    oTerm.iField = iField;
+    oTerm.nOperation = nOperation;
+    oTerm.poValue = poValue;
+    return true;
+}
+
+/************************************************************************/
+/*                    OGRFeatureQueryGetTermIndex()                     */
+/*                                                                      */
+/*      Return the index that can answer the term on its own, if any.   */
+/************************************************************************/
+
+static OGRAttrIndex *
+OGRFeatureQueryGetTermIndex( const OGRFeatureQueryIndexTerm& oTerm,
+                             OGRLayer *poLayer )
+{
+    if( oTerm.iField < 0 )
+        return nullptr;
+
+    OGRAttrIndex *poIndex = poLayer->GetIndex()->GetFieldIndex(oTerm.iField);
+    if( poIndex == nullptr )
+        return nullptr;
+
+    if( oTerm.nOperation == SWQ_EQ || oTerm.nOperation == SWQ_IN )
+        return poIndex;
+
+    if( !poIndex->SupportsRangeScan() )
+        return nullptr;
+
+    if( oTerm.nOperation == SWQ_LIKE &&
+        poLayer->GetLayerDefn()->GetFieldDefn(oTerm.iField)->GetType()
+                                                            != OFTString )
+        return nullptr;
+
+    return poIndex;
+}
+
+/************************************************************************/
+/*                     OGRFeatureQueryGetIndexKey()                     */
+/*                                                                      */
+/*      Convert a constant to the key of an equality lookup.            */
+/************************************************************************/
+
+static bool OGRFeatureQueryGetIndexKey( const swq_expr_node *poValue,
+                                        OGRFieldType eType,
+                                        OGRField& sValue )
+{
+    switch( eType )
     {
       case OFTInteger:
         if( poValue->field_type == SWQ_FLOAT )
             sValue.Integer = static_cast<int>(poValue->float_value);
         else
             sValue.Integer = static_cast<int>(poValue->int_value);
-        break;
+        return true;
 
       case OFTInteger64:
         if( poValue->field_type == SWQ_FLOAT )
             sValue.Integer64 = static_cast<GIntBig>(poValue->float_value);
         else
             sValue.Integer64 = poValue->int_value;
-        break;
+        return true;
 
       case OFTReal:
         sValue.Real = poValue->float_value;
-        break;
+        return true;
 
       case OFTString:
         sValue.String = poValue->string_value;
-        break;
+        return sValue.String != nullptr;
 
       default:
-        CPLAssert(false);
-        return nullptr;
+        return false;
     }
+}
 
-    int nLength = 0;
-    int nFIDCount32 = 0;
-    GIntBig* panFIDs =
-        poIndex->GetAllMatches(&sValue, nullptr, &nFIDCount32, &nLength);
-    nFIDCount = nFIDCount32;
-    if( nFIDCount > 1 )
+/************************************************************************/
+/*                    OGRFeatureQueryGetIndexBound()                    */
+/*                                                                      */
+/*      Convert a constant to the lower or upper bound of a range       */
+/*      scan.  Non integral bounds on integer fields are rounded        */
+/*      inwards, and bounds beyond the range of the field type are      */
+/*      either clamped or reported as an empty range (bEmpty).          */
+/************************************************************************/
+
+static bool OGRFeatureQueryGetIndexBound( const swq_expr_node *poValue,
+                                          OGRFieldType eType,
+                                          bool bLower,
+                                          OGRField& sValue,
+                                          int& bIncluded,
+                                          bool& bEmpty )
+{
+    if( eType == OFTString )
     {
-        // The returned FIDs are expected to be sorted.
-        // TODO(schwehr): Use std::sort.
-        qsort(panFIDs, static_cast<size_t>(nFIDCount),
-              sizeof(GIntBig), CompareGIntBig);
+        if( poValue->field_type != SWQ_STRING )
+            return false;
+        sValue.String = poValue->string_value;
+        return sValue.String != nullptr;
     }
-    return panFIDs;
+
+    if( !SWQ_IS_INTEGER(poValue->field_type) &&
+        poValue->field_type != SWQ_FLOAT )
+        return false;
+
+    if( eType == OFTReal )
+    {
+        sValue.Real = poValue->field_type == SWQ_FLOAT ?
+            poValue->float_value : static_cast<double>(poValue->int_value);
+        return !CPLIsNan(sValue.Real);
+    }
+
+    if( eType != OFTInteger && eType != OFTInteger64 )
+        return false;
+
+    const GIntBig nMin = eType == OFTInteger ? INT_MIN : GINTBIG_MIN;
+    const GIntBig nMax = eType == OFTInteger ? INT_MAX : GINTBIG_MAX;
+    GIntBig nVal = 0;
+    bool bAboveMax = false;
+    bool bBelowMin = false;
+
+    if( poValue->field_type == SWQ_FLOAT )
+    {
+        const double dfVal = poValue->float_value;
+        if( CPLIsNan(dfVal) )
+            return false;
+        const double dfRounded = bLower ? ceil(dfVal) : floor(dfVal);
+        if( dfRounded != dfVal )
+            bIncluded = TRUE;
+        // 2^63 is exactly representable as a double.
+        if( dfRounded >= 9223372036854775808.0 )
+            bAboveMax = true;
+        else if( dfRounded < -9223372036854775808.0 )
+            bBelowMin = true;
+        else
+            nVal = static_cast<GIntBig>(dfRounded);
+    }
+    else
+    {
+        nVal = poValue->int_value;
+    }
+
+    if( bAboveMax || nVal > nMax )
+    {
+        if( bLower )
+            bEmpty = true;
+        nVal = nMax;
+        bIncluded = TRUE;
+    }
+    else if( bBelowMin || nVal < nMin )
+    {
+        if( !bLower )
+            bEmpty = true;
+        nVal = nMin;
+        bIncluded = TRUE;
+    }
+
+    if( eType == OFTInteger )
+        sValue.Integer = static_cast<int>(nVal);
+    else
+        sValue.Integer64 = nVal;
+    return true;
+}
+
+/************************************************************************/
+/*                    OGRFeatureQueryApplyBounds()                      */
+/************************************************************************/
+
+static bool OGRFeatureQueryApplyBounds( const OGRFeatureQueryIndexTerm& oTerm,
+                                        OGRFieldType eType,
+                                        OGRField& sMin, bool& bHasMin,
+                                        int& bMinIncluded,
+                                        OGRField& sMax, bool& bHasMax,
+                                        int& bMaxIncluded,
+                                        bool& bEmpty )
+{
+    const int nOp = oTerm.nOperation;
+    if( nOp == SWQ_GT || nOp == SWQ_GE || nOp == SWQ_BETWEEN )
+    {
+        bMinIncluded = nOp != SWQ_GT;
+        if( !OGRFeatureQueryGetIndexBound(oTerm.poValue, eType, true,
+                                          sMin, bMinIncluded, bEmpty) )
+            return false;
+        bHasMin = true;
+    }
+    if( nOp == SWQ_LT || nOp == SWQ_LE || nOp == SWQ_BETWEEN )
+    {
+        bMaxIncluded = nOp != SWQ_LT;
+        if( !OGRFeatureQueryGetIndexBound(
+                nOp == SWQ_BETWEEN ? oTerm.poValue2 : oTerm.poValue,
+                eType, false, sMax, bMaxIncluded, bEmpty) )
+            return false;
+        bHasMax = true;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                    OGRFeatureQueryEvaluateTerm()                     */
+/*                                                                      */
+/*      Query poIndex for oTerm, optionally combined with the other     */
+/*      bound of a range (poOtherBound) and with equality keys on       */
+/*      the leading fields of a multi-field index (asEqualKeys).        */
+/*      Returns a sorted, OGRNullFID terminated list, or NULL if the    */
+/*      index cannot answer.                                            */
+/************************************************************************/
+
+static int CompareGIntBig( const void *pa, const void *pb );
+
+static GIntBig *
+OGRFeatureQueryEvaluateTerm( OGRAttrIndex *poIndex, OGRFieldType eType,
+                             const OGRFeatureQueryIndexTerm& oTerm,
+                             const OGRFeatureQueryIndexTerm *poOtherBound,
+                             std::vector<OGRField>& asEqualKeys,
+                             GIntBig& nFIDCount )
+{
+    const int nEqualCount = static_cast<int>(asEqualKeys.size());
+    int nFIDCount32 = 0;
+    int nLength = 0;
+    GIntBig *panFIDs = nullptr;
+    nFIDCount = 0;
+
+    if( oTerm.nOperation == SWQ_EQ || oTerm.nOperation == SWQ_IN )
+    {
+        const int nLast = oTerm.nOperation == SWQ_EQ ?
+            2 : oTerm.poExpr->nSubExprCount;
+        for( int iValue = 1; iValue < nLast; iValue++ )
+        {
+            const swq_expr_node *poValue = iValue == 1 ?
+                oTerm.poValue : oTerm.poExpr->papoSubExpr[iValue];
+            OGRField sValue;
+            if( !OGRFeatureQueryGetIndexKey(poValue, eType, sValue) )
+            {
+                CPLFree(panFIDs);
+                return nullptr;
+            }
+            if( nEqualCount == 0 )
+            {
+                panFIDs = poIndex->GetAllMatches(&sValue, panFIDs,
+                                                 &nFIDCount32, &nLength);
+            }
+            else
+            {
+                asEqualKeys.push_back(sValue);
+                panFIDs = poIndex->GetRangeMatches(
+                    nEqualCount + 1, &asEqualKeys[0], nullptr, TRUE,
+                    nullptr, TRUE, panFIDs, &nFIDCount32, &nLength);
+                asEqualKeys.pop_back();
+            }
+            if( panFIDs == nullptr )
+                return nullptr;
+        }
+    }
+    else if( oTerm.nOperation == SWQ_LIKE )
+    {
+        panFIDs = poIndex->GetPrefixMatches(
+            nEqualCount, nEqualCount ? &asEqualKeys[0] : nullptr,
+            oTerm.osPrefix, nullptr, &nFIDCount32, &nLength);
+    }
+    else
+    {
+        OGRField sMin;
+        OGRField sMax;
+        bool bHasMin = false;
+        bool bHasMax = false;
+        int bMinIncluded = TRUE;
+        int bMaxIncluded = TRUE;
+        bool bEmpty = false;
+        if( !OGRFeatureQueryApplyBounds(oTerm, eType, sMin, bHasMin,
+                                        bMinIncluded, sMax, bHasMax,
+                                        bMaxIncluded, bEmpty) ||
+            (poOtherBound != nullptr &&
+             !OGRFeatureQueryApplyBounds(*poOtherBound, eType, sMin, bHasMin,
+                                         bMinIncluded, sMax, bHasMax,
+                                         bMaxIncluded, bEmpty)) )
+            return nullptr;
+
+        if( bEmpty )
+        {
+            panFIDs = static_cast<GIntBig *>(CPLMalloc(sizeof(GIntBig)));
+            panFIDs[0] = OGRNullFID;
+            return panFIDs;
+        }
+
+        panFIDs = poIndex->GetRangeMatches(
+            nEqualCount, nEqualCount ? &asEqualKeys[0] : nullptr,
+            bHasMin ? &sMin : nullptr, bMinIncluded,
+            bHasMax ? &sMax : nullptr, bMaxIncluded,
+            nullptr, &nFIDCount32, &nLength);
+    }
+
+    if( panFIDs == nullptr )
+        return nullptr;
+
+    nFIDCount = nFIDCount32;
+    if( nFIDCount > 1 )
+    {
+        // The returned FIDs are expected to be sorted.
+        qsort(panFIDs, static_cast<size_t>(nFIDCount),
+              sizeof(GIntBig), CompareGIntBig);
+    }
+    return panFIDs;
+}
+
+/************************************************************************/
+/*               OGRFeatureQueryEvaluateMultiFieldIndex()               */
+/*                                                                      */
+/*      Find the multi-field index matching the longest run of          */
+/*      equality terms on its leading fields, possibly followed by      */
+/*      a range or prefix term on the next field, and evaluate it.      */
+/*      The terms answered by the index are flagged as consumed.        */
+/************************************************************************/
+
+static GIntBig *OGRFeatureQueryEvaluateMultiFieldIndex(
+    std::vector<OGRFeatureQueryIndexTerm>& aoTerms,
+    OGRLayer *poLayer, GIntBig& nFIDCount )
+{
+    OGRLayerAttrIndex *poLayerIndex = poLayer->GetIndex();
+    OGRAttrIndex *poBestIndex = nullptr;
+    std::vector<size_t> anBestEqual;
+    int iBestLower = -1;
+    int iBestUpper = -1;
+    size_t nBestScore = 1;
+
+    const int nIndexCount = poLayerIndex->GetIndexCount();
+    for( int iIndex = 0; iIndex < nIndexCount; iIndex++ )
+    {
+        OGRAttrIndex *poIndex = poLayerIndex->GetIndexByPosition(iIndex);
+        if( poIndex == nullptr || !poIndex->SupportsRangeScan() )
+            continue;
+        const int nKeyCount = poIndex->GetKeyFieldCount();
+        if( nKeyCount < 2 )
+            continue;
+
+        std::vector<size_t> anEqual;
+        for( int iKey = 0; iKey < nKeyCount; iKey++ )
+        {
+            const int iKeyField = poIndex->GetKeyField(iKey);
+            size_t iTerm = 0;
+            for( ; iTerm < aoTerms.size(); iTerm++ )
+            {
+                if( !aoTerms[iTerm].bConsumed &&
+                    aoTerms[iTerm].iField == iKeyField &&
+                    aoTerms[iTerm].nOperation == SWQ_EQ )
+                    break;
+            }
+            if( iTerm == aoTerms.size() )
+                break;
+            anEqual.push_back(iTerm);
+        }
+
+        int iLower = -1;
+        int iUpper = -1;
+        if( static_cast<int>(anEqual.size()) < nKeyCount )
+        {
+            const int iNextField =
+                poIndex->GetKeyField(static_cast<int>(anEqual.size()));
+            for( size_t iTerm = 0; iTerm < aoTerms.size(); iTerm++ )
+            {
+                const OGRFeatureQueryIndexTerm& oTerm = aoTerms[iTerm];
+                if( oTerm.bConsumed || oTerm.iField != iNextField )
+                    continue;
+                const int nOp = oTerm.nOperation;
+                if( nOp == SWQ_BETWEEN ||
+                    (nOp == SWQ_LIKE && poLayer->GetLayerDefn()->
+                        GetFieldDefn(iNextField)->GetType() == OFTString) )
+                {
+                    iLower = static_cast<int>(iTerm);
+                    iUpper = -1;
+                    break;
+                }
+                if( (nOp == SWQ_GT || nOp == SWQ_GE) && iLower < 0 )
+                    iLower = static_cast<int>(iTerm);
+                else if( (nOp == SWQ_LT || nOp == SWQ_LE) && iUpper < 0 )
+                    iUpper = static_cast<int>(iTerm);
+            }
+        }
+
+        const size_t nScore =
+            anEqual.size() + ((iLower >= 0 || iUpper >= 0) ? 1 : 0);
+        if( nScore > nBestScore && !anEqual.empty() )
+        {
+            poBestIndex = poIndex;
+            anBestEqual = anEqual;
+            iBestLower = iLower;
+            iBestUpper = iUpper;
+            nBestScore = nScore;
+        }
+    }
+
+    if( poBestIndex == nullptr )
+        return nullptr;
+
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    std::vector<OGRField> asEqualKeys;
+    for( size_t i = 0; i < anBestEqual.size(); i++ )
+    {
+        const OGRFeatureQueryIndexTerm& oTerm = aoTerms[anBestEqual[i]];
+        OGRField sValue;
+        if( !OGRFeatureQueryGetIndexKey(
+                oTerm.poValue,
+                poDefn->GetFieldDefn(oTerm.iField)->GetType(), sValue) )
+            return nullptr;
+        asEqualKeys.push_back(sValue);
+    }
+
+    GIntBig *panFIDs = nullptr;
+    if( iBestLower >= 0 || iBestUpper >= 0 )
+    {
+        const OGRFeatureQueryIndexTerm& oTerm =
+            aoTerms[iBestLower >= 0 ? iBestLower : iBestUpper];
+        panFIDs = OGRFeatureQueryEvaluateTerm(
+            poBestIndex, poDefn->GetFieldDefn(oTerm.iField)->GetType(),
+            oTerm,
+            (iBestLower >= 0 && iBestUpper >= 0) ?
+                &aoTerms[iBestUpper] : nullptr,
+            asEqualKeys, nFIDCount);
+    }
+    else
+    {
+        // Equality on every key field: the last one is the looked up term.
+        const OGRFeatureQueryIndexTerm& oTerm = aoTerms[anBestEqual.back()];
+        asEqualKeys.pop_back();
+        panFIDs = OGRFeatureQueryEvaluateTerm(
+            poBestIndex, poDefn->GetFieldDefn(oTerm.iField)->GetType(),
+            oTerm, nullptr, asEqualKeys, nFIDCount);
+    }
+
+    if( panFIDs != nullptr )
+    {
+        for( size_t i = 0; i < anBestEqual.size(); i++ )
+            aoTerms[anBestEqual[i]].bConsumed = true;
+        if( iBestLower >= 0 )
+            aoTerms[iBestLower].bConsumed = true;
+        if( iBestUpper >= 0 )
+            aoTerms[iBestUpper].bConsumed = true;
+    }
+    return panFIDs;
+}
+
+/************************************************************************/
+/*                   OGRFeatureQueryCollectANDTerms()                   */
+/************************************************************************/
+
+static void OGRFeatureQueryCollectANDTerms(
+    swq_expr_node *psExpr, std::vector<swq_expr_node *>& apoTerms )
+{
+    if( psExpr->eNodeType == SNT_OPERATION &&
+        psExpr->nOperation == SWQ_AND && psExpr->nSubExprCount == 2 )
+    {
+        OGRFeatureQueryCollectANDTerms(psExpr->papoSubExpr[0], apoTerms);
+        OGRFeatureQueryCollectANDTerms(psExpr->papoSubExpr[1], apoTerms);
+    }
+    else
+    {
+        apoTerms.push_back(psExpr);
+    }
+}
+
+/************************************************************************/
+/*                            CanUseIndex()                             */
+/************************************************************************/
+
+int OGRFeatureQuery::CanUseIndex( OGRLayer *poLayer )
+{
+    swq_expr_node *psExpr = static_cast<swq_expr_node *>(pSWQExpr);
+
+    // Do we have an index on the targeted layer?
+    if( poLayer->GetIndex() == nullptr )
+        return FALSE;
+
+    return CanUseIndex(psExpr, poLayer);
+}
+
+int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
+                                  OGRLayer *poLayer )
+{
+    // Does the expression meet our requirements?
+    if( psExpr == nullptr || psExpr->eNodeType != SNT_OPERATION )
+        return FALSE;
+
+    // A disjunction needs both sides, while a conjunction can be
+    // narrowed down by either side.
+    if( psExpr->nOperation == SWQ_OR && psExpr->nSubExprCount == 2 )
+    {
+        return CanUseIndex(psExpr->papoSubExpr[0], poLayer) &&
+               CanUseIndex(psExpr->papoSubExpr[1], poLayer);
+    }
+
+    if( psExpr->nOperation == SWQ_AND && psExpr->nSubExprCount == 2 )
+    {
+        return CanUseIndex(psExpr->papoSubExpr[0], poLayer) ||
+               CanUseIndex(psExpr->papoSubExpr[1], poLayer);
+    }
+
+    OGRFeatureQueryIndexTerm oTerm;
+    if( !OGRFeatureQueryAnalyzeTerm(psExpr, poLayer, oTerm) )
+        return FALSE;
+
+    return OGRFeatureQueryGetTermIndex(oTerm, poLayer) != nullptr;
+}
+
+/************************************************************************/
+/*                       EvaluateAgainstIndices()                       */
+/*                                                                      */
+/*      Attempt to return a list of FIDs matching the given             */
+/*      attribute query conditions utilizing attribute indices.         */
+/*      Returns NULL if the result cannot be computed from the          */
+/*      available indices, or an "OGRNullFID" terminated list of        */
+/*      FIDs if it can.                                                 */
+/*                                                                      */
+/*      Equality, IN, range (<, <=, >, >=, BETWEEN) and LIKE 'prefix%'  */
+/*      comparisons are supported, combined with AND and OR.  The       */
+/*      returned list may be a superset of the matching features        */
+/*      (truncated string keys, LIKE patterns, conjunctions whose       */
+/*      terms are not all indexed), so callers must still evaluate      */
+/*      the query on the fetched features.                              */
+/************************************************************************/
+
+static int CompareGIntBig( const void *pa, const void *pb )
+{
+    const GIntBig a = *(reinterpret_cast<const GIntBig *>(pa));
+    const GIntBig b = *(reinterpret_cast<const GIntBig *>(pb));
+    if( a < b )
+        return -1;
+    else if( a > b )
+        return 1;
+    else
+        return 0;
+}
+
+GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( OGRLayer *poLayer,
+                                                  OGRErr *peErr )
+
+{
+    swq_expr_node *psExpr = static_cast<swq_expr_node *>(pSWQExpr);
+
+    if( peErr != nullptr )
+        *peErr = OGRERR_NONE;
+
+    // Do we have an index on the targeted layer?
+    if( poLayer->GetIndex() == nullptr )
+        return nullptr;
+
+    GIntBig nFIDCount = 0;
+    return EvaluateAgainstIndices(psExpr, poLayer, nFIDCount);
+}
+
+// The input arrays must be sorted.
+static
+GIntBig* OGRORGIntBigArray( GIntBig panFIDList1[], GIntBig nFIDCount1,
+                            GIntBig panFIDList2[], GIntBig nFIDCount2,
+                            GIntBig& nFIDCount )
+{
+    const GIntBig nMaxCount = nFIDCount1 + nFIDCount2;
+    GIntBig* panFIDList = static_cast<GIntBig *>(
+        CPLMalloc(static_cast<size_t>(nMaxCount + 1) * sizeof(GIntBig)));
+    nFIDCount = 0;
+
+    for( GIntBig i1 = 0, i2 = 0; i1<nFIDCount1 || i2<nFIDCount2; )
+    {
+        if( i1 < nFIDCount1 && i2 < nFIDCount2 )
+        {
+            const GIntBig nVal1 = panFIDList1[i1];
+            const GIntBig nVal2 = panFIDList2[i2];
+            if( nVal1 < nVal2 )
+            {
+                if( i1 + 1 < nFIDCount1 && panFIDList1[i1+1] <= nVal2 )
+                {
+                    panFIDList[nFIDCount++] = nVal1;
+                    i1++;
+                }
+                else
+                {
+                    panFIDList[nFIDCount++] = nVal1;
+                    panFIDList[nFIDCount++] = nVal2;
+                    i1++;
+                    i2++;
+                }
+            }
+            else if( nVal1 == nVal2 )
+            {
+                panFIDList[nFIDCount++] = nVal1;
+                i1++;
+                i2++;
+            }
+            else
+            {
+                if( i2 + 1 < nFIDCount2 && panFIDList2[i2+1] <= nVal1 )
+                {
+                    panFIDList[nFIDCount++] = nVal2;
+                    i2++;
+                }
+                else
+                {
+                    panFIDList[nFIDCount++] = nVal2;
+                    panFIDList[nFIDCount++] = nVal1;
+                    i1++;
+                    i2++;
+                }
+            }
+        }
+        else if( i1 < nFIDCount1 )
+        {
+            const GIntBig nVal1 = panFIDList1[i1];
+            panFIDList[nFIDCount++] = nVal1;
+            i1++;
+        }
+        else if( i2 < nFIDCount2 )
+        {
+            const GIntBig nVal2 = panFIDList2[i2];
+            panFIDList[nFIDCount++] = nVal2;
+            i2++;
+        }
+    }
+
+    panFIDList[nFIDCount] = OGRNullFID;
+
+    return panFIDList;
+}
+
+// The input arrays must be sorted.
+static
+GIntBig* OGRANDGIntBigArray( GIntBig panFIDList1[], GIntBig nFIDCount1,
+                             GIntBig panFIDList2[], GIntBig nFIDCount2,
+                             GIntBig& nFIDCount )
+{
+    GIntBig nMaxCount = std::max(nFIDCount1, nFIDCount2);
+    GIntBig* panFIDList = static_cast<GIntBig *>(
+        CPLMalloc(static_cast<size_t>(nMaxCount + 1) * sizeof(GIntBig)));
+    nFIDCount = 0;
+
+    for( GIntBig i1 = 0, i2 = 0; i1 < nFIDCount1 && i2 < nFIDCount2; )
+    {
+        const GIntBig nVal1 = panFIDList1[i1];
+        const GIntBig nVal2 = panFIDList2[i2];
+        if( nVal1 < nVal2 )
+        {
+            if( i1+1 < nFIDCount1 && panFIDList1[i1+1] <= nVal2 )
+            {
+                i1++;
+            }
+            else
+            {
+                i1++;
+                i2++;
+            }
+        }
+        else if( nVal1 == nVal2 )
+        {
+            panFIDList[nFIDCount++] = nVal1;
+            i1++;
+            i2++;
+        }
+        else
+        {
+            if( i2 + 1 < nFIDCount2 && panFIDList2[i2+1] <= nVal1 )
+            {
+                i2++;
+            }
+            else
+            {
+                i1++;
+                i2++;
+            }
+        }
+    }
+
+    panFIDList[nFIDCount] = OGRNullFID;
+
+    return panFIDList;
+}
+
+GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
+                                                  OGRLayer *poLayer,
+                                                  GIntBig& nFIDCount )
+{
+    // Does the expression meet our requirements?
+    if( psExpr == nullptr ||
+        psExpr->eNodeType != SNT_OPERATION )
+        return nullptr;
+
+    if( psExpr->nOperation == SWQ_OR && psExpr->nSubExprCount == 2 )
+    {
+        GIntBig nFIDCount1 = 0;
+        GIntBig nFIDCount2 = 0;
+        GIntBig* panFIDList1 =
+            EvaluateAgainstIndices(psExpr->papoSubExpr[0], poLayer, nFIDCount1);
+        GIntBig* panFIDList2 =
+            panFIDList1 == nullptr ? nullptr :
+            EvaluateAgainstIndices(psExpr->papoSubExpr[1], poLayer, nFIDCount2);
+        GIntBig* panFIDList = nullptr;
+        if( panFIDList1 != nullptr && panFIDList2 != nullptr )
+        {
+            panFIDList = OGRORGIntBigArray(panFIDList1, nFIDCount1,
+                                           panFIDList2, nFIDCount2, nFIDCount);
+        }
+        CPLFree(panFIDList1);
+        CPLFree(panFIDList2);
+        return panFIDList;
+    }
+
+    if( psExpr->nOperation == SWQ_AND && psExpr->nSubExprCount == 2 )
+    {
+        std::vector<swq_expr_node *> apoNodes;
+        OGRFeatureQueryCollectANDTerms(psExpr, apoNodes);
+        std::vector<OGRFeatureQueryIndexTerm> aoTerms(apoNodes.size());
+        for( size_t i = 0; i < apoNodes.size(); i++ )
+            OGRFeatureQueryAnalyzeTerm(apoNodes[i], poLayer, aoTerms[i]);
+
+        GIntBig *panFIDList = nullptr;
+        nFIDCount = 0;
+
+        // Intersect the list of each term that can be answered, and
+        // leave the other terms to the caller.
+        for( int iPass = 0; iPass < 3; iPass++ )
+        {
+            for( size_t i = 0; i < aoTerms.size(); i++ )
+            {
+                if( panFIDList != nullptr && nFIDCount == 0 )
+                    return panFIDList;
+
+                GIntBig nNewCount = 0;
+                GIntBig *panNewList = nullptr;
+                OGRFeatureQueryIndexTerm& oTerm = aoTerms[i];
+                if( iPass == 0 )
+                {
+                    // Multi-field indices first, as they are the most
+                    // selective.
+                    panNewList = OGRFeatureQueryEvaluateMultiFieldIndex(
+                        aoTerms, poLayer, nNewCount);
+                    if( panNewList == nullptr )
+                        break;
+                }
+                else if( iPass == 1 )
+                {
+                    if( oTerm.bConsumed || oTerm.iField < 0 )
+                        continue;
+                    oTerm.bConsumed = true;
+                    OGRAttrIndex *poIndex =
+                        OGRFeatureQueryGetTermIndex(oTerm, poLayer);
+                    if( poIndex == nullptr )
+                        continue;
+
+                    // Merge a lower and an upper bound on the same field
+                    // in a single scan.
+                    OGRFeatureQueryIndexTerm *poOtherBound = nullptr;
+                    const int nOp = oTerm.nOperation;
+                    const bool bLower = nOp == SWQ_GT || nOp == SWQ_GE;
+                    const bool bUpper = nOp == SWQ_LT || nOp == SWQ_LE;
+                    for( size_t j = i + 1;
+                         (bLower || bUpper) && j < aoTerms.size(); j++ )
+                    {
+                        const int nOtherOp = aoTerms[j].nOperation;
+                        if( !aoTerms[j].bConsumed &&
+                            aoTerms[j].iField == oTerm.iField &&
+                            ((bLower && (nOtherOp == SWQ_LT ||
+                                         nOtherOp == SWQ_LE)) ||
+                             (bUpper && (nOtherOp == SWQ_GT ||
+                                         nOtherOp == SWQ_GE))) )
+                        {
+                            poOtherBound = &aoTerms[j];
+                            poOtherBound->bConsumed = true;
+                            break;
+                        }
+                    }
+
+                    std::vector<OGRField> asEqualKeys;
+                    panNewList = OGRFeatureQueryEvaluateTerm(
+                        poIndex,
+                        poLayer->GetLayerDefn()->GetFieldDefn(
+                            oTerm.iField)->GetType(),
+                        oTerm, poOtherBound, asEqualKeys, nNewCount);
+                }
+                else
+                {
+                    // Nested OR and other compound terms.
+                    if( oTerm.iField >= 0 )
+                        continue;
+                    panNewList = EvaluateAgainstIndices(oTerm.poExpr, poLayer,
+                                                        nNewCount);
+                }
+
+                if( panNewList == nullptr )
+                    continue;
+                if( panFIDList == nullptr )
+                {
+                    panFIDList = panNewList;
+                    nFIDCount = nNewCount;
+                }
+                else
+                {
+                    GIntBig nANDCount = 0;
+                    GIntBig *panANDList =
+                        OGRANDGIntBigArray(panFIDList, nFIDCount,
+                                           panNewList, nNewCount, nANDCount);
+                    CPLFree(panFIDList);
+                    CPLFree(panNewList);
+                    panFIDList = panANDList;
+                    nFIDCount = nANDCount;
+                }
+            }
+        }
+        return panFIDList;
+    }
+
+    OGRFeatureQueryIndexTerm oTerm;
+    if( !OGRFeatureQueryAnalyzeTerm(psExpr, poLayer, oTerm) )
+        return nullptr;
+
+    OGRAttrIndex *poIndex = OGRFeatureQueryGetTermIndex(oTerm, poLayer);
+    if( poIndex == nullptr )
+        return nullptr;
+
+    // Have an index, now we need to query it.
+    std::vector<OGRField> asEqualKeys;
+    return OGRFeatureQueryEvaluateTerm(
+        poIndex,
+        poLayer->GetLayerDefn()->GetFieldDefn(oTerm.iField)->GetType(),
+        oTerm, nullptr, asEqualKeys, nFIDCount);
 }
 
 /************************************************************************/
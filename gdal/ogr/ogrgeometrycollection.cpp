@@ -1063,6 +1063,12 @@ OGRBoolean OGRGeometryCollection::Equals( OGRGeometry * poOther ) const
 OGRErr OGRGeometryCollection::transform( OGRCoordinateTransformation *poCT )
 
 {
+    // Transform all parts with a single call when possible.
+    OGRGeometry* poThis = this;
+    bool bDone = false;
+    if( OGRTransformGeometriesBatched(1, &poThis, poCT, &bDone) == 1 )
+        return OGRERR_NONE;
+
     for( int iGeom = 0; iGeom < nGeomCount; iGeom++ )
     {
         const OGRErr eErr = papoGeoms[iGeom]->transform( poCT );
@@ -3783,6 +3783,328 @@ OGRGeometry* OGRGeometryFactory::transformWithOptions(
     return poDstGeom;
 }
 
+/************************************************************************/
+/*                      OGRCollectTransformParts()                      */
+/*                                                                      */
+/*      Collect the points and simple curves that make a geometry, in   */
+/*      the same order as the recursive transform() methods visit       */
+/*      them. Return false if the geometry contains a type we do not    */
+/*      know how to decompose.                                          */
+/************************************************************************/
+
+namespace {
+struct OGRTransformPart
+{
+    OGRGeometry *poLeaf;
+    bool         bIsPoint;
+    bool         bIsClosedRing;
+    size_t       nOffset;
+    int          nPoints;
+};
+} // namespace
+
+static bool OGRCollectTransformParts( OGRGeometry* poGeom,
+                                      std::vector<OGRTransformPart>& aoParts,
+                                      size_t& nTotalPoints )
+{
+    const OGRwkbGeometryType eType = wkbFlatten(poGeom->getGeometryType());
+    if( eType == wkbPoint )
+    {
+        OGRTransformPart sPart;
+        sPart.poLeaf = poGeom;
+        sPart.bIsPoint = true;
+        sPart.bIsClosedRing = false;
+        sPart.nOffset = nTotalPoints;
+        sPart.nPoints = 1;
+        aoParts.push_back(sPart);
+        nTotalPoints++;
+        return true;
+    }
+    if( eType == wkbLineString || eType == wkbCircularString )
+    {
+        OGRSimpleCurve* poSC = static_cast<OGRSimpleCurve*>(poGeom);
+        OGRTransformPart sPart;
+        sPart.poLeaf = poGeom;
+        sPart.bIsPoint = false;
+        // Replicate the safety belt of OGRLinearRing::transform()
+        sPart.bIsClosedRing =
+            EQUAL(poGeom->getGeometryName(), "LINEARRING") &&
+            poSC->getNumPoints() > 2 && CPL_TO_BOOL(poSC->get_IsClosed());
+        sPart.nOffset = nTotalPoints;
+        sPart.nPoints = poSC->getNumPoints();
+        aoParts.push_back(sPart);
+        nTotalPoints += sPart.nPoints;
+        return true;
+    }
+    if( eType == wkbCompoundCurve )
+    {
+        OGRCompoundCurve* poCC = static_cast<OGRCompoundCurve*>(poGeom);
+        for( int i = 0; i < poCC->getNumCurves(); i++ )
+        {
+            if( !OGRCollectTransformParts(poCC->getCurve(i), aoParts,
+                                          nTotalPoints) )
+                return false;
+        }
+        return true;
+    }
+    if( OGR_GT_IsSubClassOf(eType, wkbCurvePolygon) )
+    {
+        OGRCurvePolygon* poCP = static_cast<OGRCurvePolygon*>(poGeom);
+        if( poCP->getExteriorRingCurve() == nullptr )
+            return true;
+        if( !OGRCollectTransformParts(poCP->getExteriorRingCurve(), aoParts,
+                                      nTotalPoints) )
+            return false;
+        for( int i = 0; i < poCP->getNumInteriorRings(); i++ )
+        {
+            if( !OGRCollectTransformParts(poCP->getInteriorRingCurve(i),
+                                          aoParts, nTotalPoints) )
+                return false;
+        }
+        return true;
+    }
+    if( OGR_GT_IsSubClassOf(eType, wkbGeometryCollection) )
+    {
+        OGRGeometryCollection* poGC =
+            static_cast<OGRGeometryCollection*>(poGeom);
+        for( int i = 0; i < poGC->getNumGeometries(); i++ )
+        {
+            if( !OGRCollectTransformParts(poGC->getGeometryRef(i), aoParts,
+                                          nTotalPoints) )
+                return false;
+        }
+        return true;
+    }
+    if( OGR_GT_IsSubClassOf(eType, wkbPolyhedralSurface) )
+    {
+        OGRPolyhedralSurface* poPS =
+            static_cast<OGRPolyhedralSurface*>(poGeom);
+        for( int i = 0; i < poPS->getNumGeometries(); i++ )
+        {
+            if( !OGRCollectTransformParts(poPS->getGeometryRef(i), aoParts,
+                                          nTotalPoints) )
+                return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                   OGRTransformGeometriesBatched()                    */
+/*                                                                      */
+/*      Transform all the coordinates of several geometries with a      */
+/*      single call to OGRCoordinateTransformation::TransformEx(),      */
+/*      instead of one call per point, ring or part. Only geometries    */
+/*      whose points all transform successfully are modified, and       */
+/*      pabDone[i] is set accordingly. The other ones are left          */
+/*      untouched, so that the caller can fall back to their            */
+/*      transform() method which takes care of partial reprojection     */
+/*      and error reporting. Returns the number of geometries done.     */
+/************************************************************************/
+
+int OGRTransformGeometriesBatched( int nCount, OGRGeometry** papoGeoms,
+                                   OGRCoordinateTransformation *poCT,
+                                   bool* pabDone )
+{
+    for( int i = 0; i < nCount; i++ )
+        pabDone[i] = false;
+
+    std::vector<OGRTransformPart> aoParts;
+    std::vector<size_t> anFirstPart(nCount + 1);
+    std::vector<bool> abCollected(nCount);
+    size_t nTotalPoints = 0;
+    for( int i = 0; i < nCount; i++ )
+    {
+        anFirstPart[i] = aoParts.size();
+        const size_t nTotalPointsBefore = nTotalPoints;
+        abCollected[i] = papoGeoms[i] != nullptr &&
+            OGRCollectTransformParts(papoGeoms[i], aoParts, nTotalPoints);
+        if( !abCollected[i] )
+        {
+            aoParts.resize(anFirstPart[i]);
+            nTotalPoints = nTotalPointsBefore;
+        }
+    }
+    anFirstPart[nCount] = aoParts.size();
+
+    // Not worth it if there is a single part: the caller will do the
+    // same TransformEx() call without the gather/scatter.
+    if( aoParts.size() < 2 ||
+        nTotalPoints > static_cast<size_t>(INT_MAX) / 3 )
+    {
+        return 0;
+    }
+
+    std::vector<double> adfXYZ;
+    std::vector<int> abSuccess;
+    try
+    {
+        adfXYZ.resize(nTotalPoints * 3);
+        abSuccess.resize(nTotalPoints);
+    }
+    catch( const std::bad_alloc& )
+    {
+        return 0;
+    }
+    double* padfX = &adfXYZ[0];
+    double* padfY = padfX + nTotalPoints;
+    double* padfZ = padfY + nTotalPoints;
+
+/* -------------------------------------------------------------------- */
+/*      Gather.                                                         */
+/* -------------------------------------------------------------------- */
+    for( const auto& sPart: aoParts )
+    {
+        if( sPart.bIsPoint )
+        {
+            OGRPoint* poPoint = static_cast<OGRPoint*>(sPart.poLeaf);
+            padfX[sPart.nOffset] = poPoint->getX();
+            padfY[sPart.nOffset] = poPoint->getY();
+            padfZ[sPart.nOffset] = poPoint->getZ();
+        }
+        else if( sPart.nPoints )
+        {
+            static_cast<OGRSimpleCurve*>(sPart.poLeaf)->getPoints(
+                padfX + sPart.nOffset, sizeof(double),
+                padfY + sPart.nOffset, sizeof(double),
+                padfZ + sPart.nOffset, sizeof(double));
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Transform. Errors are not emitted here since failed geometries  */
+/*      are transformed again by the caller.                            */
+/* -------------------------------------------------------------------- */
+    const bool bEmitErrors = poCT->GetEmitErrors();
+    poCT->SetEmitErrors(false);
+    const int bRet = poCT->TransformEx( static_cast<int>(nTotalPoints),
+                                        padfX, padfY, padfZ,
+                                        &abSuccess[0] );
+    poCT->SetEmitErrors(bEmitErrors);
+    if( !bRet )
+        return 0;
+
+/* -------------------------------------------------------------------- */
+/*      Scatter back geometries whose points all succeeded.             */
+/* -------------------------------------------------------------------- */
+    int nDone = 0;
+    for( int i = 0; i < nCount; i++ )
+    {
+        if( !abCollected[i] )
+            continue;
+
+        bool bOK = true;
+        for( size_t iPart = anFirstPart[i];
+             bOK && iPart < anFirstPart[i+1]; iPart++ )
+        {
+            const OGRTransformPart& sPart = aoParts[iPart];
+            for( int j = 0; j < sPart.nPoints; j++ )
+            {
+                if( !abSuccess[sPart.nOffset + j] )
+                {
+                    bOK = false;
+                    break;
+                }
+            }
+        }
+        if( !bOK )
+            continue;
+
+        for( size_t iPart = anFirstPart[i];
+             iPart < anFirstPart[i+1]; iPart++ )
+        {
+            const OGRTransformPart& sPart = aoParts[iPart];
+            if( sPart.bIsPoint )
+            {
+                OGRPoint* poPoint = static_cast<OGRPoint*>(sPart.poLeaf);
+                poPoint->setX(padfX[sPart.nOffset]);
+                poPoint->setY(padfY[sPart.nOffset]);
+                if( poPoint->Is3D() )
+                    poPoint->setZ(padfZ[sPart.nOffset]);
+            }
+            else if( sPart.nPoints )
+            {
+                OGRSimpleCurve* poSC =
+                    static_cast<OGRSimpleCurve*>(sPart.poLeaf);
+                poSC->setPoints( sPart.nPoints,
+                                 padfX + sPart.nOffset,
+                                 padfY + sPart.nOffset,
+                                 poSC->Is3D() ? padfZ + sPart.nOffset :
+                                                nullptr );
+                if( sPart.bIsClosedRing && !poSC->get_IsClosed() )
+                {
+                    CPLDebug("OGR", "Linearring is not closed after "
+                             "coordinate transformation. Forcing last point "
+                             "to be identical to first one");
+                    OGRPoint oStartPoint;
+                    poSC->StartPoint( &oStartPoint );
+                    poSC->setPoint( sPart.nPoints - 1, &oStartPoint );
+                }
+            }
+        }
+        papoGeoms[i]->assignSpatialReference( poCT->GetTargetCS() );
+        pabDone[i] = true;
+        nDone++;
+    }
+
+    return nDone;
+}
+
+/************************************************************************/
+/*                        transformGeometries()                         */
+/************************************************************************/
+
+/**
+ * \brief Transform several geometries with the same transformation.
+ *
+ * This is equivalent to calling OGRGeometry::transform() on each geometry,
+ * except that the coordinates of all geometries are transformed with a
+ * single call to OGRCoordinateTransformation::TransformEx(), which greatly
+ * reduces the per-call overhead when transforming many small geometries
+ * (typically a batch of features). Geometries for which some points fail
+ * to transform are processed individually with OGRGeometry::transform(),
+ * so that partial reprojection and error reporting behave the same.
+ *
+ * @param nCount number of geometries.
+ * @param papoGeoms array of nCount geometries, modified in place. Null
+ * entries are ignored.
+ * @param poCT coordinate transformation object.
+ * @param paeErrors optional array of nCount error codes, set to the
+ * result of the transformation of each geometry.
+ * @return OGRERR_NONE if all geometries were transformed successfully, or
+ * the error code of the last failed transformation.
+ *
+ * @since GDAL 2.3
+ */
+
+OGRErr OGRGeometryFactory::transformGeometries(
+                                        int nCount, OGRGeometry** papoGeoms,
+                                        OGRCoordinateTransformation *poCT,
+                                        OGRErr* paeErrors )
+{
+    if( nCount <= 0 )
+        return OGRERR_NONE;
+
+    bool* pabDone = static_cast<bool*>(CPLMalloc(sizeof(bool) * nCount));
+    OGRTransformGeometriesBatched(nCount, papoGeoms, poCT, pabDone);
+
+    OGRErr eRet = OGRERR_NONE;
+    for( int i = 0; i < nCount; i++ )
+    {
+        OGRErr eErr = OGRERR_NONE;
+        if( !pabDone[i] && papoGeoms[i] != nullptr )
+            eErr = papoGeoms[i]->transform(poCT);
+        if( paeErrors )
+            paeErrors[i] = eErr;
+        if( eErr != OGRERR_NONE )
+            eRet = eErr;
+    }
+    CPLFree(pabDone);
+
+    return eRet;
+}
+
 /************************************************************************/
 /*                       OGRGF_GetDefaultStepSize()                     */
 /************************************************************************/
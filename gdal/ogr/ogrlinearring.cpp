@@ -242,59 +242,7 @@ OGRErr OGRLinearRing::_importFromWkb( OGRwkbByteOrder eByteOrder, int _flags,
 /* -------------------------------------------------------------------- */
 /*      Get the vertices                                                */
 /* -------------------------------------------------------------------- */
-    if( (flags & OGR_G_3D) && (flags & OGR_G_MEASURED) )
-    {
-        for( int i = 0; i < nPointCount; i++ )
-        {
-            memcpy( &(paoPoints[i].x), pabyData + 4 + 32 * i, 8 );
-            memcpy( &(paoPoints[i].y), pabyData + 4 + 32 * i + 8, 8 );
-            memcpy( padfZ + i, pabyData + 4 + 32 * i + 16, 8 );
-            memcpy( padfM + i, pabyData + 4 + 32 * i + 24, 8 );
-        }
-    }
-    else if( flags & OGR_G_MEASURED )
-    {
-        for( int i = 0; i < nPointCount; i++ )
-        {
-            memcpy( &(paoPoints[i].x), pabyData + 4 + 24 * i, 8 );
-            memcpy( &(paoPoints[i].y), pabyData + 4 + 24 * i + 8, 8 );
-            memcpy( padfM + i, pabyData + 4 + 24 * i + 16, 8 );
-        }
-    }
-    else if( flags & OGR_G_3D )
-    {
-        for( int i = 0; i < nPointCount; i++ )
-        {
-            memcpy( &(paoPoints[i].x), pabyData + 4 + 24 * i, 8 );
-            memcpy( &(paoPoints[i].y), pabyData + 4 + 24 * i + 8, 8 );
-            memcpy( padfZ + i, pabyData + 4 + 24 * i + 16, 8 );
-        }
-    }
-    else
-    {
-        memcpy( paoPoints, pabyData + 4, 16 * nPointCount );
-    }
-
-/* -------------------------------------------------------------------- */
-/*      Byte swap if needed.                                            */
-/* -------------------------------------------------------------------- */
-    if( OGR_SWAP( eByteOrder ) )
-    {
-        for( int i = 0; i < nPointCount; i++ )
-        {
-            CPL_SWAPDOUBLE( &(paoPoints[i].x) );
-            CPL_SWAPDOUBLE( &(paoPoints[i].y) );
-
-            if( flags & OGR_G_3D )
-            {
-                CPL_SWAPDOUBLE( padfZ + i );
-            }
-            if( flags & OGR_G_MEASURED )
-            {
-                CPL_SWAPDOUBLE( padfM + i );
-            }
-        }
-    }
+    importPointsFromWkb( pabyData + 4, OGR_SWAP( eByteOrder ) );
 
     return OGRERR_NONE;
 }
@@ -319,68 +267,12 @@ OGRErr OGRLinearRing::_exportToWkb( OGRwkbByteOrder eByteOrder, int _flags,
 /* -------------------------------------------------------------------- */
 /*      Copy in the raw data.                                           */
 /* -------------------------------------------------------------------- */
-    int nWords = 0;
-    if( (_flags & OGR_G_3D) && (_flags & OGR_G_MEASURED) )
-    {
-        nWords = 4 * nPointCount;
-        for( int i = 0; i < nPointCount; i++ )
-        {
-            memcpy( pabyData+4+i*32, &(paoPoints[i].x), 8 );
-            memcpy( pabyData+4+i*32+8, &(paoPoints[i].y), 8 );
-            if( padfZ == nullptr )
-                memset( pabyData+4+i*32+16, 0, 8 );
-            else
-                memcpy( pabyData+4+i*32+16, padfZ + i, 8 );
-            if( padfM == nullptr )
-                memset( pabyData+4+i*32+24, 0, 8 );
-            else
-                memcpy( pabyData+4+i*32+24, padfM + i, 8 );
-        }
-    }
-    else if( _flags & OGR_G_MEASURED )
-    {
-        nWords = 3 * nPointCount;
-        for( int i = 0; i < nPointCount; i++ )
-        {
-            memcpy( pabyData+4+i*24, &(paoPoints[i].x), 8 );
-            memcpy( pabyData+4+i*24+8, &(paoPoints[i].y), 8 );
-            if( padfM == nullptr )
-                memset( pabyData+4+i*24+16, 0, 8 );
-            else
-                memcpy( pabyData+4+i*24+16, padfM + i, 8 );
-        }
-    }
-    else if( _flags & OGR_G_3D )
-    {
-        nWords = 3 * nPointCount;
-        for( int i = 0; i < nPointCount; i++ )
-        {
-            memcpy( pabyData+4+i*24, &(paoPoints[i].x), 8 );
-            memcpy( pabyData+4+i*24+8, &(paoPoints[i].y), 8 );
-            if( padfZ == nullptr )
-                memset( pabyData+4+i*24+16, 0, 8 );
-            else
-                memcpy( pabyData+4+i*24+16, padfZ + i, 8 );
-        }
-    }
-    else
-    {
-        nWords = 2 * nPointCount;
-        memcpy( pabyData+4, paoPoints, 16 * nPointCount );
-    }
+    exportPointsToWkb( pabyData + 4, _flags, OGR_SWAP( eByteOrder ) );
 
-/* -------------------------------------------------------------------- */
-/*      Swap if needed.                                                 */
-/* -------------------------------------------------------------------- */
     if( OGR_SWAP( eByteOrder ) )
     {
         int nCount = CPL_SWAP32( nPointCount );
         memcpy( pabyData, &nCount, 4 );
-
-        for( int i = 0; i < nWords; i++ )
-        {
-            CPL_SWAPDOUBLE( pabyData + 4 + 8 * i );
-        }
     }
 
     return OGRERR_NONE;
@@ -1486,6 +1486,162 @@ void OGRSimpleCurve::addSubLineString( const OGRLineString *poOtherLine,
     }
 }
 
+/************************************************************************/
+/*                   OGRReadWkbDouble() / OGRWriteWkbDouble()           */
+/************************************************************************/
+
+template<bool bSwap> static inline double OGRReadWkbDouble(
+                                                const unsigned char* pabyData )
+{
+    double dfVal;
+    memcpy(&dfVal, pabyData, sizeof(double));
+    if( bSwap )
+        CPL_SWAP64PTR(&dfVal);
+    return dfVal;
+}
+
+template<bool bSwap> static inline void OGRWriteWkbDouble(
+                                        unsigned char* pabyData, double dfVal )
+{
+    if( bSwap )
+        CPL_SWAP64PTR(&dfVal);
+    memcpy(pabyData, &dfVal, sizeof(double));
+}
+
+/************************************************************************/
+/*                        OGRScatterWkbPoints()                         */
+/*                                                                      */
+/*      Single pass de-interleaving of WKB XY[Z][M] tuples, with the    */
+/*      byte swapping folded in, instead of one memcpy() per ordinate   */
+/*      followed by a separate swapping pass.                           */
+/************************************************************************/
+
+template<bool bSwap, bool bHasZ, bool bHasM> static void OGRScatterWkbPoints(
+                    const unsigned char* pabyData, int nPointCount,
+                    OGRRawPoint* paoPoints, double* padfZ, double* padfM )
+{
+    constexpr int nStride = 8 * (2 + (bHasZ ? 1 : 0) + (bHasM ? 1 : 0));
+    for( int i = 0; i < nPointCount; i++ )
+    {
+        const unsigned char* pabyPoint = pabyData + i * nStride;
+        paoPoints[i].x = OGRReadWkbDouble<bSwap>(pabyPoint);
+        paoPoints[i].y = OGRReadWkbDouble<bSwap>(pabyPoint + 8);
+        if( bHasZ )
+            padfZ[i] = OGRReadWkbDouble<bSwap>(pabyPoint + 16);
+        if( bHasM )
+            padfM[i] = OGRReadWkbDouble<bSwap>(pabyPoint + (bHasZ ? 24 : 16));
+    }
+}
+
+/************************************************************************/
+/*                        OGRGatherWkbPoints()                          */
+/*                                                                      */
+/*      Reverse of OGRScatterWkbPoints(). A missing Z or M array is     */
+/*      written as zeroes.                                              */
+/************************************************************************/
+
+template<bool bSwap, bool bHasZ, bool bHasM> static void OGRGatherWkbPoints(
+                    unsigned char* pabyData, int nPointCount,
+                    const OGRRawPoint* paoPoints, const double* padfZ,
+                    const double* padfM )
+{
+    constexpr int nStride = 8 * (2 + (bHasZ ? 1 : 0) + (bHasM ? 1 : 0));
+    for( int i = 0; i < nPointCount; i++ )
+    {
+        unsigned char* pabyPoint = pabyData + i * nStride;
+        OGRWriteWkbDouble<bSwap>(pabyPoint, paoPoints[i].x);
+        OGRWriteWkbDouble<bSwap>(pabyPoint + 8, paoPoints[i].y);
+        if( bHasZ )
+            OGRWriteWkbDouble<bSwap>(pabyPoint + 16,
+                                     padfZ ? padfZ[i] : 0.0);
+        if( bHasM )
+            OGRWriteWkbDouble<bSwap>(pabyPoint + (bHasZ ? 24 : 16),
+                                     padfM ? padfM[i] : 0.0);
+    }
+}
+
+//! @cond Doxygen_Suppress
+
+/************************************************************************/
+/*                        importPointsFromWkb()                         */
+/*                                                                      */
+/*      Fill the already allocated point arrays from nPointCount        */
+/*      WKB tuples, whose dimension is given by the current flags.      */
+/************************************************************************/
+
+void OGRSimpleCurve::importPointsFromWkb( const unsigned char* pabyData,
+                                          bool bSwap )
+{
+    const bool bHasZ = (flags & OGR_G_3D) != 0;
+    const bool bHasM = (flags & OGR_G_MEASURED) != 0;
+
+    if( !bSwap && !bHasZ && !bHasM )
+    {
+        if( nPointCount )
+            memcpy( paoPoints, pabyData, 16 * nPointCount );
+        return;
+    }
+
+#define SCATTER(bS, bZ, bM) \
+    OGRScatterWkbPoints<bS, bZ, bM>(pabyData, nPointCount, \
+                                    paoPoints, padfZ, padfM)
+    if( bSwap )
+    {
+        if( bHasZ && bHasM )  SCATTER(true, true, true);
+        else if( bHasZ )      SCATTER(true, true, false);
+        else if( bHasM )      SCATTER(true, false, true);
+        else                  SCATTER(true, false, false);
+    }
+    else
+    {
+        if( bHasZ && bHasM )  SCATTER(false, true, true);
+        else if( bHasZ )      SCATTER(false, true, false);
+        else                  SCATTER(false, false, true);
+    }
+#undef SCATTER
+}
+
+/************************************************************************/
+/*                         exportPointsToWkb()                          */
+/*                                                                      */
+/*      Write nPointCount WKB tuples with the dimension given by        */
+/*      nWkbFlags (OGR_G_3D / OGR_G_MEASURED).                          */
+/************************************************************************/
+
+void OGRSimpleCurve::exportPointsToWkb( unsigned char* pabyData,
+                                        int nWkbFlags, bool bSwap ) const
+{
+    const bool bHasZ = (nWkbFlags & OGR_G_3D) != 0;
+    const bool bHasM = (nWkbFlags & OGR_G_MEASURED) != 0;
+
+    if( !bSwap && !bHasZ && !bHasM )
+    {
+        if( nPointCount )
+            memcpy( pabyData, paoPoints, 16 * nPointCount );
+        return;
+    }
+
+#define GATHER(bS, bZ, bM) \
+    OGRGatherWkbPoints<bS, bZ, bM>(pabyData, nPointCount, \
+                                   paoPoints, padfZ, padfM)
+    if( bSwap )
+    {
+        if( bHasZ && bHasM )  GATHER(true, true, true);
+        else if( bHasZ )      GATHER(true, true, false);
+        else if( bHasM )      GATHER(true, false, true);
+        else                  GATHER(true, false, false);
+    }
+    else
+    {
+        if( bHasZ && bHasM )  GATHER(false, true, true);
+        else if( bHasZ )      GATHER(false, true, false);
+        else                  GATHER(false, false, true);
+    }
+#undef GATHER
+}
+
+//! @endcond
+
 /************************************************************************/
 /*                           importFromWkb()                            */
 /*                                                                      */
@@ -1540,65 +1696,7 @@ OGRErr OGRSimpleCurve::importFromWkb( const unsigned char *pabyData,
 /* -------------------------------------------------------------------- */
 /*      Get the vertex.                                                 */
 /* -------------------------------------------------------------------- */
-    int i = 0;
-
-    if( (flags & OGR_G_3D) && (flags & OGR_G_MEASURED) )
-    {
-        for( i = 0; i < nPointCount; i++ )
-        {
-            memcpy( paoPoints + i, pabyData + 9 + i*32, 16 );
-            memcpy( padfZ + i, pabyData + 9 + 16 + i*32, 8 );
-            memcpy( padfM + i, pabyData + 9 + 24 + i*32, 8 );
-        }
-    }
-    else if( flags & OGR_G_MEASURED )
-    {
-        for( i = 0; i < nPointCount; i++ )
-        {
-            memcpy( paoPoints + i, pabyData + 9 + i*24, 16 );
-            memcpy( padfM + i, pabyData + 9 + 16 + i*24, 8 );
-        }
-    }
-    else if( flags & OGR_G_3D )
-    {
-        for( i = 0; i < nPointCount; i++ )
-        {
-            memcpy( paoPoints + i, pabyData + 9 + i*24, 16 );
-            memcpy( padfZ + i, pabyData + 9 + 16 + i*24, 8 );
-        }
-    }
-    else if( nPointCount )
-    {
-        memcpy( paoPoints, pabyData + 9, 16 * nPointCount );
-    }
-
-/* -------------------------------------------------------------------- */
-/*      Byte swap if needed.                                            */
-/* -------------------------------------------------------------------- */
-    if( OGR_SWAP( eByteOrder ) )
-    {
-        for( i = 0; i < nPointCount; i++ )
-        {
-            CPL_SWAPDOUBLE( &(paoPoints[i].x) );
-            CPL_SWAPDOUBLE( &(paoPoints[i].y) );
-        }
-
-        if( flags & OGR_G_3D )
-        {
-            for( i = 0; i < nPointCount; i++ )
-            {
-                CPL_SWAPDOUBLE( padfZ + i );
-            }
-        }
-
-        if( flags & OGR_G_MEASURED )
-        {
-            for( i = 0; i < nPointCount; i++ )
-            {
-                CPL_SWAPDOUBLE( padfM + i );
-            }
-        }
-    }
+    importPointsFromWkb( pabyData + 9, OGR_SWAP( eByteOrder ) );
 
     return OGRERR_NONE;
 }
@@ -1655,46 +1753,12 @@ OGRErr OGRSimpleCurve::exportToWkb( OGRwkbByteOrder eByteOrder,
 /* -------------------------------------------------------------------- */
 /*      Copy in the raw data.                                           */
 /* -------------------------------------------------------------------- */
-    if( (flags & OGR_G_3D) && (flags & OGR_G_MEASURED) )
-    {
-        for( int i = 0; i < nPointCount; i++ )
-        {
-            memcpy( pabyData + 9 + 32*i, paoPoints+i, 16 );
-            memcpy( pabyData + 9 + 16 + 32*i, padfZ+i, 8 );
-            memcpy( pabyData + 9 + 24 + 32*i, padfM+i, 8 );
-        }
-    }
-    else if( flags & OGR_G_MEASURED )
-    {
-        for( int i = 0; i < nPointCount; i++ )
-        {
-            memcpy( pabyData + 9 + 24*i, paoPoints+i, 16 );
-            memcpy( pabyData + 9 + 16 + 24*i, padfM+i, 8 );
-        }
-    }
-    else if( flags & OGR_G_3D )
-    {
-        for( int i = 0; i < nPointCount; i++ )
-        {
-            memcpy( pabyData + 9 + 24*i, paoPoints+i, 16 );
-            memcpy( pabyData + 9 + 16 + 24*i, padfZ+i, 8 );
-        }
-    }
-    else if( nPointCount )
-        memcpy( pabyData+9, paoPoints, 16 * nPointCount );
+    exportPointsToWkb( pabyData + 9, flags, OGR_SWAP( eByteOrder ) );
 
-/* -------------------------------------------------------------------- */
-/*      Swap if needed.                                                 */
-/* -------------------------------------------------------------------- */
     if( OGR_SWAP( eByteOrder ) )
     {
         int nCount = CPL_SWAP32( nPointCount );
         memcpy( pabyData+5, &nCount, 4 );
-
-        for( int i = CoordinateDimension() * nPointCount - 1; i >= 0; i-- )
-        {
-            CPL_SWAP64PTR( pabyData + 9 + 8 * i );
-        }
     }
 
     return OGRERR_NONE;
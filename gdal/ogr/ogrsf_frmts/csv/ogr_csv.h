@@ -127,6 +127,11 @@ class OGRCSVLayer : public OGRLayer
 
     bool                bEmptyStringNull;
 
+    // FIDs of the candidate features returned by the attribute index.
+    GIntBig            *panMatchingFIDs;
+    GIntBig             iNextMatchingFID;
+    bool                bMatchingFIDsComputed;
+
     char              **GetNextLineTokens();
 
     static bool         Matches( const char *pszFieldName,
@@ -822,6 +822,11 @@ bool OGRCSVDataSource::OpenTable( const char *pszFilename,
     {
         poLayer = new OGRCSVEditableLayer(poCSVLayer, papszOpenOptionsIn);
     }
+    else if( !EQUAL(pszFilename, "/vsistdin/") )
+    {
+        // Attribute indexes are stored in a <filename>.oix sidecar file.
+        poLayer->InitializeIndexSupport(CPLSPrintf("%s.oix", pszFilename));
+    }
     papoLayers[nLayers - 1] = poLayer;
 
     return true;
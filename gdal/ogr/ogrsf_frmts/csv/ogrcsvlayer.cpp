@@ -266,7 +266,10 @@ OGRCSVLayer::OGRCSVLayer( const char *pszLayerNameIn,
     bKeepSourceColumns(false),
     bKeepGeomColumns(true),
     bMergeDelimiter(false),
-    bEmptyStringNull(false)
+    bEmptyStringNull(false),
+    panMatchingFIDs(nullptr),
+    iNextMatchingFID(0),
+    bMatchingFIDsComputed(false)
 {
     poFeatureDefn = new OGRFeatureDefn(pszLayerNameIn);
     SetDescription(poFeatureDefn->GetName());
@@ -1330,6 +1333,7 @@ OGRCSVLayer::~OGRCSVLayer()
         WriteHeader();
 
     CPLFree(panGeomFieldIndex);
+    CPLFree(panMatchingFIDs);
 
     poFeatureDefn->Release();
     CPLFree(pszFilename);
@@ -1355,6 +1359,11 @@ void OGRCSVLayer::ResetReading()
     bNeedRewindBeforeRead = false;
 
     nNextFID = 1;
+
+    CPLFree(panMatchingFIDs);
+    panMatchingFIDs = nullptr;
+    iNextMatchingFID = 0;
+    bMatchingFIDsComputed = false;
 }
 
 /************************************************************************/
@@ -1748,10 +1757,41 @@ OGRFeature *OGRCSVLayer::GetNextFeature()
     if( bNeedRewindBeforeRead )
         ResetReading();
 
+    // If the attribute filter can be answered by an index, only the
+    // lines of the candidate features need to be parsed.
+    if( !bMatchingFIDsComputed )
+    {
+        bMatchingFIDsComputed = true;
+        if( m_poAttrQuery != nullptr && !bInWriteMode && nNextFID == 1 &&
+            m_poAttrQuery->CanUseIndex(this) )
+        {
+            panMatchingFIDs =
+                m_poAttrQuery->EvaluateAgainstIndices(this, nullptr);
+        }
+    }
+
     // Read features till we find one that satisfies our current
     // spatial criteria.
     while( true )
     {
+        if( panMatchingFIDs != nullptr )
+        {
+            const GIntBig nFID = panMatchingFIDs[iNextMatchingFID];
+            if( nFID == OGRNullFID )
+                return nullptr;
+            iNextMatchingFID++;
+            if( nFID < nNextFID )
+                continue;
+            while( nNextFID < nFID )
+            {
+                char **papszTokens = GetNextLineTokens();
+                if( papszTokens == nullptr )
+                    return nullptr;
+                CSLDestroy(papszTokens);
+                nNextFID++;
+            }
+        }
+
         OGRFeature *poFeature = GetNextUnfilteredFeature();
         if( poFeature == nullptr )
             return nullptr;
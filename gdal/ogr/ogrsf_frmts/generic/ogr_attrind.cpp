@@ -59,6 +59,67 @@ OGRLayerAttrIndex::~OGRLayerAttrIndex()
     pszIndexPath = nullptr;
 }
 
+/************************************************************************/
+/*                       CreateMultiFieldIndex()                        */
+/************************************************************************/
+
+OGRErr OGRLayerAttrIndex::CreateMultiFieldIndex( int nFieldCount,
+                                                 const int *panFields )
+
+{
+    if( nFieldCount == 1 )
+        return CreateIndex( panFields[0] );
+
+    CPLError( CE_Failure, CPLE_NotSupported,
+              "Multi-column indexes not supported by this index type." );
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                        DropMultiFieldIndex()                         */
+/************************************************************************/
+
+OGRErr OGRLayerAttrIndex::DropMultiFieldIndex( int nFieldCount,
+                                               const int *panFields )
+
+{
+    if( nFieldCount == 1 )
+        return DropIndex( panFields[0] );
+
+    CPLError( CE_Failure, CPLE_NotSupported,
+              "Multi-column indexes not supported by this index type." );
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                           GetIndexCount()                            */
+/************************************************************************/
+
+int OGRLayerAttrIndex::GetIndexCount()
+
+{
+    return 0;
+}
+
+/************************************************************************/
+/*                         GetIndexByPosition()                         */
+/************************************************************************/
+
+OGRAttrIndex *OGRLayerAttrIndex::GetIndexByPosition( int /* iIndex */ )
+
+{
+    return nullptr;
+}
+
+/************************************************************************/
+/*                             Invalidate()                             */
+/************************************************************************/
+
+void OGRLayerAttrIndex::Invalidate()
+
+{
+}
+
 /************************************************************************/
 /* ==================================================================== */
 /*                             OGRAttrIndex                             */
@@ -77,4 +138,69 @@ OGRAttrIndex::OGRAttrIndex() {}
 
 OGRAttrIndex::~OGRAttrIndex() {}
 
+/************************************************************************/
+/*                          GetKeyFieldCount()                          */
+/************************************************************************/
+
+int OGRAttrIndex::GetKeyFieldCount()
+
+{
+    return 1;
+}
+
+/************************************************************************/
+/*                            GetKeyField()                             */
+/*                                                                      */
+/*      -1 means that the implementation does not report it.            */
+/************************************************************************/
+
+int OGRAttrIndex::GetKeyField( int /* iKey */ )
+
+{
+    return -1;
+}
+
+/************************************************************************/
+/*                         SupportsRangeScan()                          */
+/************************************************************************/
+
+int OGRAttrIndex::SupportsRangeScan()
+
+{
+    return FALSE;
+}
+
+/************************************************************************/
+/*                          GetRangeMatches()                           */
+/************************************************************************/
+
+GIntBig *OGRAttrIndex::GetRangeMatches( int /* nEqualCount */,
+                                        const OGRField * /* pasEqualKeys */,
+                                        const OGRField * /* psMin */,
+                                        int /* bMinIncluded */,
+                                        const OGRField * /* psMax */,
+                                        int /* bMaxIncluded */,
+                                        GIntBig* /* panFIDList */,
+                                        int* /* nFIDCount */,
+                                        int* /* nLength */ )
+
+{
+    return nullptr;
+}
+
+/************************************************************************/
+/*                          GetPrefixMatches()                          */
+/************************************************************************/
+
+GIntBig *OGRAttrIndex::GetPrefixMatches( int /* nEqualCount */,
+                                         const OGRField * /* pasEqualKeys */,
+                                         const char * /* pszPrefix */,
+                                         GIntBig* /* panFIDList */,
+                                         int* /* nFIDCount */,
+                                         int* /* nLength */ )
+
+{
+    return nullptr;
+}
+
 //! @endcond
@@ -0,0 +1,1842 @@
+/******************************************************************************
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Implements a persistent B+tree attribute index, stored in a
+ *           .oix sidecar file, supporting range scans and multi-column keys.
+ * Author:   Frank Warmerdam, warmerdam@pobox.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2003, Frank Warmerdam
+ * Copyright (c) 2008-2018, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_attrind.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+CPL_CVSID("$Id$")
+
+//! @cond Doxygen_Suppress
+
+/************************************************************************/
+/*      File layout of the .oix file (all integers little endian):      */
+/*                                                                      */
+/*      Header (48 bytes)                                               */
+/*        char[8]  "OGRBTIX\0"                                          */
+/*        uint32   version (2)                                          */
+/*        uint32   number of indexes                                    */
+/*        uint64   offset of the directory                              */
+/*        uint32   size of the directory                                */
+/*        uint32   flags (1: out of date)                               */
+/*        uint64   size of the indexed file when the index was built    */
+/*        int64    modification time of the indexed file, same time     */
+/*                                                                      */
+/*      An index that is flagged out of date, or whose indexed file no  */
+/*      longer has the recorded size and modification time, is not      */
+/*      used until it is rebuilt.                                       */
+/*                                                                      */
+/*      For each index, a bulk loaded B+tree made of fixed size nodes.  */
+/*      Leaf nodes are written consecutively in key order, followed     */
+/*      by interior levels up to the root:                              */
+/*        uint32   entry count                                          */
+/*        leaf entries:     key, int64 FID                              */
+/*        interior entries: key of first entry of child, uint64 offset  */
+/*                                                                      */
+/*      Keys are the concatenation of fixed width, memcmp() ordered     */
+/*      encodings of each key field: 8 bytes for integer and real       */
+/*      values, and zero padded ASCII lower-cased bytes for strings,    */
+/*      consistently with the case insensitive comparisons of OGR SQL.  */
+/*      Strings longer than the key width are truncated, in which case  */
+/*      index lookups return a superset of the matching features.       */
+/*                                                                      */
+/*      Directory, for each index:                                      */
+/*        uint32   number of key fields                                 */
+/*        for each key field:                                           */
+/*          int32 field index, uint32 OGRFieldType, uint32 key width,   */
+/*          uint32 name length, name bytes                              */
+/*        uint32   node size                                            */
+/*        uint32   depth (0 for an empty index, 1 if root is a leaf)    */
+/*        uint64   root node offset                                     */
+/*        uint64   first leaf offset                                    */
+/*        uint64   number of leaves                                     */
+/*        uint64   number of entries                                    */
+/************************************************************************/
+
+static const char OIX_SIGNATURE[8] = { 'O','G','R','B','T','I','X','\0' };
+static const GUInt32 OIX_VERSION = 2;
+static const GUInt32 OIX_FLAG_OUT_OF_DATE = 1;
+static const int OIX_HEADER_SIZE = 48;
+static const int OIX_MIN_NODE_SIZE = 4096;
+static const int OIX_MIN_ENTRIES_PER_NODE = 16;
+static const int OIX_MAX_STRING_KEY_WIDTH = 255;
+
+/************************************************************************/
+/*                      Little endian buffer helpers                    */
+/************************************************************************/
+
+static void OIXWriteUInt32( std::vector<GByte>& abyBuf, GUInt32 nVal )
+{
+    CPL_LSBPTR32(&nVal);
+    const GByte* pabyVal = reinterpret_cast<const GByte*>(&nVal);
+    abyBuf.insert(abyBuf.end(), pabyVal, pabyVal + sizeof(nVal));
+}
+
+static void OIXWriteUInt64( std::vector<GByte>& abyBuf, GUIntBig nVal )
+{
+    CPL_LSBPTR64(&nVal);
+    const GByte* pabyVal = reinterpret_cast<const GByte*>(&nVal);
+    abyBuf.insert(abyBuf.end(), pabyVal, pabyVal + sizeof(nVal));
+}
+
+static GUInt32 OIXGetUInt32( const GByte* pabyData )
+{
+    GUInt32 nVal = 0;
+    memcpy(&nVal, pabyData, sizeof(nVal));
+    CPL_LSBPTR32(&nVal);
+    return nVal;
+}
+
+static GUIntBig OIXGetUInt64( const GByte* pabyData )
+{
+    GUIntBig nVal = 0;
+    memcpy(&nVal, pabyData, sizeof(nVal));
+    CPL_LSBPTR64(&nVal);
+    return nVal;
+}
+
+static void OIXSetUInt32( GByte* pabyData, GUInt32 nVal )
+{
+    CPL_LSBPTR32(&nVal);
+    memcpy(pabyData, &nVal, sizeof(nVal));
+}
+
+static void OIXSetUInt64( GByte* pabyData, GUIntBig nVal )
+{
+    CPL_LSBPTR64(&nVal);
+    memcpy(pabyData, &nVal, sizeof(nVal));
+}
+
+/************************************************************************/
+/*                        Order preserving keys                         */
+/************************************************************************/
+
+static void OIXEncodeInt64( GIntBig nVal, GByte* pabyOut )
+{
+    GUIntBig nBits = static_cast<GUIntBig>(nVal) ^ (static_cast<GUIntBig>(1) << 63);
+    for( int i = 7; i >= 0; i-- )
+    {
+        pabyOut[i] = static_cast<GByte>(nBits & 0xff);
+        nBits >>= 8;
+    }
+}
+
+static void OIXEncodeDouble( double dfVal, GByte* pabyOut )
+{
+    // -0.0 and 0.0 compare equal.
+    if( dfVal == 0.0 )
+        dfVal = 0.0;
+    GUIntBig nBits = 0;
+    memcpy(&nBits, &dfVal, sizeof(nBits));
+    if( nBits & (static_cast<GUIntBig>(1) << 63) )
+        nBits = ~nBits;
+    else
+        nBits |= static_cast<GUIntBig>(1) << 63;
+    for( int i = 7; i >= 0; i-- )
+    {
+        pabyOut[i] = static_cast<GByte>(nBits & 0xff);
+        nBits >>= 8;
+    }
+}
+
+static std::string OIXEncodeString( const char* pszVal, size_t nMaxLen )
+{
+    std::string osRet;
+    for( size_t i = 0; pszVal[i] != '\0' && i < nMaxLen; i++ )
+    {
+        const char ch = pszVal[i];
+        osRet += (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch - 'A' + 'a')
+                                          : ch;
+    }
+    return osRet;
+}
+
+static bool OIXIsSupportedType( OGRFieldType eType )
+{
+    return eType == OFTInteger || eType == OFTInteger64 ||
+           eType == OFTReal || eType == OFTString;
+}
+
+/************************************************************************/
+/*                            OGRBTreeEntry                             */
+/*                                                                      */
+/*      In memory form of an index entry while the index is being       */
+/*      built or modified.  The key is made of one segment per key      */
+/*      field, each prefixed by its length on one byte.                 */
+/************************************************************************/
+
+struct OGRBTreeEntry
+{
+    std::string osKey;
+    GIntBig     nFID;
+};
+
+class OGRBTreeLayerAttrIndex;
+
+/************************************************************************/
+/*                          OGRBTreeAttrIndex                           */
+/************************************************************************/
+
+class OGRBTreeAttrIndex : public OGRAttrIndex
+{
+    friend class OGRBTreeLayerAttrIndex;
+
+    OGRBTreeLayerAttrIndex     *poLIndex;
+    std::vector<int>            anFields;
+    std::vector<OGRFieldType>   aeTypes;
+    std::vector<int>            anWidths;
+
+    int             nKeySize;
+    int             nNodeSize;
+    int             nDepth;
+    vsi_l_offset    nRootOffset;
+    vsi_l_offset    nFirstLeafOffset;
+    GUIntBig        nLeafCount;
+    GUIntBig        nEntryCount;
+
+    // When true, aoEntries is the authoritative content of the index,
+    // and the tree in the file (if any) is out of date.
+    bool            bInMemory;
+    std::vector<OGRBTreeEntry> aoEntries;
+
+    bool            BuildEntryKey( OGRFeature *poFeature,
+                                   std::string& osKey ) const;
+    bool            AppendKeyField( int iKey, const OGRField *psField,
+                                    std::vector<GByte>& abyKey,
+                                    bool bPad, bool& bTruncated ) const;
+    GIntBig        *Scan( const std::vector<GByte>& abyLow, bool bLowIncluded,
+                          const std::vector<GByte>& abyHigh,
+                          bool bHighIncluded,
+                          GIntBig* panFIDList, int* pnFIDCount,
+                          int* pnLength );
+    bool            LoadEntries();
+
+  public:
+                    OGRBTreeAttrIndex( OGRBTreeLayerAttrIndex *poLIndexIn,
+                                       int nFieldCount, const int *panFields,
+                                       const OGRFieldType *paeTypes );
+    virtual        ~OGRBTreeAttrIndex() {}
+
+    GIntBig         GetFirstMatch( OGRField *psKey ) override;
+    GIntBig        *GetAllMatches( OGRField *psKey ) override;
+    GIntBig        *GetAllMatches( OGRField *psKey, GIntBig* panFIDList,
+                                   int* nFIDCount, int* nLength ) override;
+
+    OGRErr          AddEntry( OGRField *psKey, GIntBig nFID ) override;
+    OGRErr          RemoveEntry( OGRField *psKey, GIntBig nFID ) override;
+
+    OGRErr          Clear() override;
+
+    int             GetKeyFieldCount() override
+                        { return static_cast<int>(anFields.size()); }
+    int             GetKeyField( int iKey ) override { return anFields[iKey]; }
+    int             SupportsRangeScan() override { return TRUE; }
+
+    GIntBig        *GetRangeMatches( int nEqualCount,
+                                     const OGRField *pasEqualKeys,
+                                     const OGRField *psMin, int bMinIncluded,
+                                     const OGRField *psMax, int bMaxIncluded,
+                                     GIntBig* panFIDList, int* nFIDCount,
+                                     int* nLength ) override;
+    GIntBig        *GetPrefixMatches( int nEqualCount,
+                                      const OGRField *pasEqualKeys,
+                                      const char *pszPrefix,
+                                      GIntBig* panFIDList, int* nFIDCount,
+                                      int* nLength ) override;
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                        OGRBTreeLayerAttrIndex                        */
+/* ==================================================================== */
+/************************************************************************/
+
+class OGRBTreeLayerAttrIndex : public OGRLayerAttrIndex
+{
+    friend class OGRBTreeAttrIndex;
+
+    CPLString       osFilename;
+    VSILFILE       *fp;
+    bool            bDirty;
+    bool            bBulkLoading;
+    std::vector<OGRBTreeAttrIndex*> apoIndexes;
+
+    // Indexed file, and its size and modification time when the indexes
+    // were built.  When bStale is set, the indexes no longer reflect the
+    // content of the layer and are hidden from queries.
+    CPLString       osSourceFilename;
+    GUIntBig        nSourceSize;
+    GIntBig         nSourceMTime;
+    bool            bStale;
+    bool            bRebuilt;
+    bool            bInvalidated;
+
+    void            StatSource( GUIntBig& nSize, GIntBig& nMTime ) const;
+    void            UpdateHeaderState();
+    OGRErr          LoadDirectory();
+    OGRErr          Flush();
+    bool            WriteTree( VSILFILE* fpOut, OGRBTreeAttrIndex* poIndex );
+    bool            ReadNode( vsi_l_offset nOffset, int nNodeSize,
+                              std::vector<GByte>& abyNode );
+    OGRBTreeAttrIndex *FindIndex( int nFieldCount,
+                                  const int *panFields ) const;
+
+  public:
+                    OGRBTreeLayerAttrIndex();
+    virtual        ~OGRBTreeLayerAttrIndex();
+
+    OGRErr          Initialize( const char *pszIndexPath, OGRLayer * ) override;
+    OGRErr          CreateIndex( int iField ) override;
+    OGRErr          DropIndex( int iField ) override;
+    OGRErr          IndexAllFeatures( int iField = -1 ) override;
+
+    OGRErr          AddToIndex( OGRFeature *poFeature,
+                                int iField = -1 ) override;
+    OGRErr          RemoveFromIndex( OGRFeature *poFeature ) override;
+
+    OGRAttrIndex   *GetFieldIndex( int iField ) override;
+    void            Invalidate() override;
+
+    OGRErr          CreateMultiFieldIndex( int nFieldCount,
+                                           const int *panFields ) override;
+    OGRErr          DropMultiFieldIndex( int nFieldCount,
+                                         const int *panFields ) override;
+    int             GetIndexCount() override
+                        { return bStale ? 0 :
+                                 static_cast<int>(apoIndexes.size()); }
+    OGRAttrIndex   *GetIndexByPosition( int iIndex ) override;
+};
+
+/************************************************************************/
+/*                       OGRBTreeLayerAttrIndex()                       */
+/************************************************************************/
+
+OGRBTreeLayerAttrIndex::OGRBTreeLayerAttrIndex() :
+    fp(nullptr),
+    bDirty(false),
+    bBulkLoading(false),
+    nSourceSize(0),
+    nSourceMTime(0),
+    bStale(false),
+    bRebuilt(false),
+    bInvalidated(false)
+{}
+
+/************************************************************************/
+/*                      ~OGRBTreeLayerAttrIndex()                       */
+/************************************************************************/
+
+OGRBTreeLayerAttrIndex::~OGRBTreeLayerAttrIndex()
+
+{
+    if( bDirty )
+        Flush();
+
+    if( fp != nullptr )
+        VSIFCloseL( fp );
+    fp = nullptr;
+
+    // Drivers may still write to the indexed file when the layer is
+    // closed, e.g. the .dbf header, which happens before we are destroyed.
+    // So record its final state if the indexes were built during this
+    // session, or that they became out of date.
+    if( bInvalidated || (bRebuilt && !bStale) )
+    {
+        if( !bStale )
+            StatSource( nSourceSize, nSourceMTime );
+        UpdateHeaderState();
+    }
+
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+        delete apoIndexes[i];
+}
+
+/************************************************************************/
+/*                             Initialize()                             */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::Initialize( const char *pszIndexPathIn,
+                                           OGRLayer *poLayerIn )
+
+{
+    if( poLayerIn == poLayer )
+        return OGRERR_NONE;
+
+    poLayer = poLayerIn;
+    pszIndexPath = CPLStrdup( pszIndexPathIn );
+    osFilename = CPLResetExtension( pszIndexPathIn, "oix" );
+
+    // CSV and GeoJSON pass <file>.oix, and Shapefile passes its .shp,
+    // whose attributes are in the .dbf.
+    if( EQUAL(CPLGetExtension(pszIndexPathIn), "oix") )
+    {
+        osSourceFilename = pszIndexPathIn;
+        osSourceFilename.resize( osSourceFilename.size() - 4 );
+    }
+    else if( EQUAL(CPLGetExtension(pszIndexPathIn), "shp") )
+    {
+        VSIStatBufL sStat;
+        osSourceFilename = CPLResetExtension( pszIndexPathIn, "dbf" );
+        if( VSIStatL( osSourceFilename, &sStat ) != 0 )
+            osSourceFilename = CPLResetExtension( pszIndexPathIn, "DBF" );
+    }
+    else
+    {
+        osSourceFilename = pszIndexPathIn;
+    }
+
+    VSIStatBufL sStat;
+    if( VSIStatL( osFilename, &sStat ) == 0 )
+        return LoadDirectory();
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                             StatSource()                             */
+/************************************************************************/
+
+void OGRBTreeLayerAttrIndex::StatSource( GUIntBig& nSize,
+                                         GIntBig& nMTime ) const
+
+{
+    VSIStatBufL sStat;
+    if( VSIStatL( osSourceFilename, &sStat ) == 0 )
+    {
+        nSize = static_cast<GUIntBig>(sStat.st_size);
+        nMTime = static_cast<GIntBig>(sStat.st_mtime);
+    }
+    else
+    {
+        nSize = 0;
+        nMTime = 0;
+    }
+}
+
+/************************************************************************/
+/*                         UpdateHeaderState()                          */
+/*                                                                      */
+/*      Rewrite the flags and indexed file state in the header of an   */
+/*      existing .oix file.                                             */
+/************************************************************************/
+
+void OGRBTreeLayerAttrIndex::UpdateHeaderState()
+
+{
+    VSIStatBufL sStat;
+    if( VSIStatL( osFilename, &sStat ) != 0 )
+        return;
+
+    VSILFILE *fpUpdate = VSIFOpenL( osFilename, "rb+" );
+    if( fpUpdate == nullptr )
+    {
+        CPLError( CE_Warning, CPLE_FileIO,
+                  "Cannot update attribute index %s.", osFilename.c_str() );
+        return;
+    }
+
+    GByte abyState[20] = {};
+    OIXSetUInt32( abyState, bStale ? OIX_FLAG_OUT_OF_DATE : 0 );
+    OIXSetUInt64( abyState + 4, nSourceSize );
+    OIXSetUInt64( abyState + 12, static_cast<GUIntBig>(nSourceMTime) );
+    if( VSIFSeekL( fpUpdate, 28, SEEK_SET ) != 0 ||
+        VSIFWriteL( abyState, sizeof(abyState), 1, fpUpdate ) != 1 )
+    {
+        CPLError( CE_Warning, CPLE_FileIO,
+                  "Cannot update attribute index %s.", osFilename.c_str() );
+    }
+    VSIFCloseL( fpUpdate );
+}
+
+/************************************************************************/
+/*                           LoadDirectory()                            */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::LoadDirectory()
+
+{
+    fp = VSIFOpenL( osFilename, "rb" );
+    if( fp == nullptr )
+    {
+        CPLError( CE_Failure, CPLE_OpenFailed,
+                  "Failed to open index file %s.", osFilename.c_str() );
+        return OGRERR_FAILURE;
+    }
+
+    GByte abyHeader[OIX_HEADER_SIZE] = {};
+    if( VSIFReadL( abyHeader, OIX_HEADER_SIZE, 1, fp ) != 1 ||
+        memcmp( abyHeader, OIX_SIGNATURE, sizeof(OIX_SIGNATURE) ) != 0 ||
+        OIXGetUInt32( abyHeader + 8 ) != OIX_VERSION )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "%s is not a valid attribute index file.",
+                  osFilename.c_str() );
+        VSIFCloseL( fp );
+        fp = nullptr;
+        return OGRERR_FAILURE;
+    }
+
+    const GUInt32 nIndexCount = OIXGetUInt32( abyHeader + 12 );
+    const GUIntBig nDirOffset = OIXGetUInt64( abyHeader + 16 );
+    const GUInt32 nDirSize = OIXGetUInt32( abyHeader + 24 );
+    nSourceSize = OIXGetUInt64( abyHeader + 32 );
+    nSourceMTime = static_cast<GIntBig>( OIXGetUInt64( abyHeader + 40 ) );
+
+/* -------------------------------------------------------------------- */
+/*      If the indexed file has been modified since the indexes were    */
+/*      built, keep their definitions, so that they can be rebuilt,     */
+/*      but do not use them.                                            */
+/* -------------------------------------------------------------------- */
+    GUIntBig nCurSize = 0;
+    GIntBig nCurMTime = 0;
+    StatSource( nCurSize, nCurMTime );
+    if( (OIXGetUInt32( abyHeader + 28 ) & OIX_FLAG_OUT_OF_DATE) != 0 ||
+        nCurSize != nSourceSize || nCurMTime != nSourceMTime )
+    {
+        CPLError( CE_Warning, CPLE_AppDefined,
+                  "%s has been modified since the attribute index %s was "
+                  "built. The index is ignored. Use CREATE INDEX to "
+                  "rebuild it.",
+                  osSourceFilename.c_str(), osFilename.c_str() );
+        bStale = true;
+    }
+    if( nDirSize > 10 * 1024 * 1024 )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Corrupted directory in %s.", osFilename.c_str() );
+        return OGRERR_FAILURE;
+    }
+
+    std::vector<GByte> abyDir( nDirSize );
+    if( nDirSize > 0 &&
+        ( VSIFSeekL( fp, nDirOffset, SEEK_SET ) != 0 ||
+          VSIFReadL( &abyDir[0], nDirSize, 1, fp ) != 1 ) )
+    {
+        CPLError( CE_Failure, CPLE_FileIO,
+                  "Cannot read directory of %s.", osFilename.c_str() );
+        return OGRERR_FAILURE;
+    }
+
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    size_t nPos = 0;
+    for( GUInt32 iIndex = 0; iIndex < nIndexCount; iIndex++ )
+    {
+        if( nPos + 4 > nDirSize )
+            break;
+        const GUInt32 nFieldCount = OIXGetUInt32( &abyDir[nPos] );
+        nPos += 4;
+        if( nFieldCount == 0 || nFieldCount > 64 )
+            break;
+
+        std::vector<int> anFields;
+        std::vector<OGRFieldType> aeTypes;
+        std::vector<int> anWidths;
+        bool bValid = true;
+        for( GUInt32 iKey = 0; iKey < nFieldCount; iKey++ )
+        {
+            if( nPos + 16 > nDirSize )
+                return OGRERR_FAILURE;
+            int iField = static_cast<int>( OIXGetUInt32( &abyDir[nPos] ) );
+            const OGRFieldType eType =
+                static_cast<OGRFieldType>( OIXGetUInt32( &abyDir[nPos+4] ) );
+            const int nWidth =
+                static_cast<int>( OIXGetUInt32( &abyDir[nPos+8] ) );
+            const GUInt32 nNameLen = OIXGetUInt32( &abyDir[nPos+12] );
+            nPos += 16;
+            if( nNameLen > nDirSize - nPos )
+                return OGRERR_FAILURE;
+            const CPLString osName(
+                reinterpret_cast<const char*>(&abyDir[nPos]), nNameLen );
+            nPos += nNameLen;
+
+            // The field order may have changed since the index was written.
+            if( iField < 0 || iField >= poDefn->GetFieldCount() ||
+                !EQUAL(poDefn->GetFieldDefn(iField)->GetNameRef(), osName) )
+            {
+                iField = poDefn->GetFieldIndex( osName );
+            }
+            if( iField < 0 ||
+                poDefn->GetFieldDefn(iField)->GetType() != eType ||
+                nWidth <= 0 || nWidth > OIX_MAX_STRING_KEY_WIDTH )
+            {
+                bValid = false;
+            }
+            anFields.push_back( iField );
+            aeTypes.push_back( eType );
+            anWidths.push_back( nWidth );
+        }
+
+        if( nPos + 40 > nDirSize )
+            return OGRERR_FAILURE;
+
+        OGRBTreeAttrIndex *poIndex =
+            new OGRBTreeAttrIndex( this, static_cast<int>(nFieldCount),
+                                   &anFields[0], &aeTypes[0] );
+        poIndex->anWidths = anWidths;
+        poIndex->nKeySize = 0;
+        for( size_t i = 0; i < anWidths.size(); i++ )
+            poIndex->nKeySize += anWidths[i];
+        poIndex->nNodeSize = static_cast<int>(OIXGetUInt32( &abyDir[nPos] ));
+        poIndex->nDepth = static_cast<int>(OIXGetUInt32( &abyDir[nPos+4] ));
+        poIndex->nRootOffset = OIXGetUInt64( &abyDir[nPos+8] );
+        poIndex->nFirstLeafOffset = OIXGetUInt64( &abyDir[nPos+16] );
+        poIndex->nLeafCount = OIXGetUInt64( &abyDir[nPos+24] );
+        poIndex->nEntryCount = OIXGetUInt64( &abyDir[nPos+32] );
+        poIndex->bInMemory = false;
+        nPos += 40;
+
+        if( !bValid || poIndex->nDepth < 0 || poIndex->nDepth > 32 ||
+            poIndex->nNodeSize < OIX_MIN_NODE_SIZE ||
+            poIndex->nNodeSize > 64 * 1024 * 1024 )
+        {
+            CPLError( CE_Warning, CPLE_AppDefined,
+                      "Ignoring index #%d of %s that does not match "
+                      "the layer definition.",
+                      static_cast<int>(iIndex), osFilename.c_str() );
+            delete poIndex;
+            continue;
+        }
+
+        apoIndexes.push_back( poIndex );
+    }
+
+    CPLDebug( "OGR", "Restored %d field indexes for layer %s from %s.",
+              static_cast<int>(apoIndexes.size()),
+              poDefn->GetName(), osFilename.c_str() );
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                              ReadNode()                              */
+/************************************************************************/
+
+bool OGRBTreeLayerAttrIndex::ReadNode( vsi_l_offset nOffset, int nNodeSize,
+                                       std::vector<GByte>& abyNode )
+
+{
+    abyNode.resize( nNodeSize );
+    if( fp == nullptr ||
+        VSIFSeekL( fp, nOffset, SEEK_SET ) != 0 ||
+        VSIFReadL( &abyNode[0], nNodeSize, 1, fp ) != 1 )
+    {
+        CPLError( CE_Failure, CPLE_FileIO,
+                  "Cannot read node at offset " CPL_FRMT_GUIB " of %s.",
+                  static_cast<GUIntBig>(nOffset), osFilename.c_str() );
+        return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                             WriteTree()                              */
+/*                                                                      */
+/*      Bulk load the in-memory entries of an index as a B+tree at      */
+/*      the current position of fpOut.                                  */
+/************************************************************************/
+
+bool OGRBTreeLayerAttrIndex::WriteTree( VSILFILE* fpOut,
+                                        OGRBTreeAttrIndex* poIndex )
+
+{
+    const size_t nKeyFields = poIndex->anFields.size();
+
+/* -------------------------------------------------------------------- */
+/*      Compute the key width of each field.                            */
+/* -------------------------------------------------------------------- */
+    poIndex->anWidths.assign( nKeyFields, 1 );
+    for( size_t iEntry = 0; iEntry < poIndex->aoEntries.size(); iEntry++ )
+    {
+        const std::string& osKey = poIndex->aoEntries[iEntry].osKey;
+        size_t nPos = 0;
+        for( size_t iKey = 0; iKey < nKeyFields; iKey++ )
+        {
+            const int nLen = static_cast<GByte>(osKey[nPos]);
+            poIndex->anWidths[iKey] =
+                std::max( poIndex->anWidths[iKey], nLen );
+            nPos += 1 + nLen;
+        }
+    }
+    poIndex->nKeySize = 0;
+    for( size_t iKey = 0; iKey < nKeyFields; iKey++ )
+    {
+        if( poIndex->aeTypes[iKey] != OFTString )
+            poIndex->anWidths[iKey] = 8;
+        poIndex->nKeySize += poIndex->anWidths[iKey];
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Build fixed width keys and sort them.                           */
+/* -------------------------------------------------------------------- */
+    const size_t nEntries = poIndex->aoEntries.size();
+    const int nKeySize = poIndex->nKeySize;
+    std::vector<GByte> abyKeys;
+    std::vector<GIntBig> anFIDs;
+    try
+    {
+        abyKeys.resize( nEntries * nKeySize );
+        anFIDs.resize( nEntries );
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError( CE_Failure, CPLE_OutOfMemory,
+                  "Cannot allocate memory for index of %s.",
+                  osFilename.c_str() );
+        return false;
+    }
+
+    for( size_t iEntry = 0; iEntry < nEntries; iEntry++ )
+    {
+        const std::string& osKey = poIndex->aoEntries[iEntry].osKey;
+        GByte *pabyOut = &abyKeys[iEntry * nKeySize];
+        size_t nPos = 0;
+        for( size_t iKey = 0; iKey < nKeyFields; iKey++ )
+        {
+            const int nLen = static_cast<GByte>(osKey[nPos]);
+            memcpy( pabyOut, osKey.data() + nPos + 1, nLen );
+            pabyOut += poIndex->anWidths[iKey];
+            nPos += 1 + nLen;
+        }
+        anFIDs[iEntry] = poIndex->aoEntries[iEntry].nFID;
+    }
+    poIndex->aoEntries.clear();
+    std::vector<OGRBTreeEntry>().swap( poIndex->aoEntries );
+
+    std::vector<size_t> anOrder( nEntries );
+    for( size_t i = 0; i < nEntries; i++ )
+        anOrder[i] = i;
+
+    struct KeyComparator
+    {
+        const GByte *pabyKeys;
+        const GIntBig *panFIDs;
+        size_t nKeySize;
+
+        bool operator()( size_t a, size_t b ) const
+        {
+            const int nCmp = memcmp( pabyKeys + a * nKeySize,
+                                     pabyKeys + b * nKeySize, nKeySize );
+            if( nCmp != 0 )
+                return nCmp < 0;
+            return panFIDs[a] < panFIDs[b];
+        }
+    };
+    KeyComparator oComparator;
+    oComparator.pabyKeys = nEntries ? &abyKeys[0] : nullptr;
+    oComparator.panFIDs = nEntries ? &anFIDs[0] : nullptr;
+    oComparator.nKeySize = nKeySize;
+    std::sort( anOrder.begin(), anOrder.end(), oComparator );
+
+/* -------------------------------------------------------------------- */
+/*      Pick a node size so that each node holds a reasonable number    */
+/*      of entries, even with long string keys.                         */
+/* -------------------------------------------------------------------- */
+    const int nEntrySize = nKeySize + 8;
+    int nNodeSize = OIX_MIN_NODE_SIZE;
+    while( (nNodeSize - 4) / nEntrySize < OIX_MIN_ENTRIES_PER_NODE )
+        nNodeSize *= 2;
+    const size_t nPerNode = static_cast<size_t>((nNodeSize - 4) / nEntrySize);
+
+    poIndex->nNodeSize = nNodeSize;
+    poIndex->nEntryCount = nEntries;
+    poIndex->nDepth = 0;
+    poIndex->nRootOffset = 0;
+    poIndex->nFirstLeafOffset = 0;
+    poIndex->nLeafCount = 0;
+    poIndex->bInMemory = false;
+    if( nEntries == 0 )
+        return true;
+
+/* -------------------------------------------------------------------- */
+/*      Write the leaves, remembering the first key of each.            */
+/* -------------------------------------------------------------------- */
+    std::vector<GByte> abyNode( nNodeSize );
+    std::vector<GByte> abyLevelKeys;
+    std::vector<GUIntBig> anLevelOffsets;
+
+    poIndex->nFirstLeafOffset = VSIFTellL( fpOut );
+    for( size_t iStart = 0; iStart < nEntries; iStart += nPerNode )
+    {
+        const size_t nCount = std::min( nPerNode, nEntries - iStart );
+        std::fill( abyNode.begin(), abyNode.end(), 0 );
+        OIXSetUInt32( &abyNode[0], static_cast<GUInt32>(nCount) );
+        for( size_t i = 0; i < nCount; i++ )
+        {
+            const size_t iEntry = anOrder[iStart + i];
+            GByte *pabyEntry = &abyNode[4 + i * nEntrySize];
+            memcpy( pabyEntry, &abyKeys[iEntry * nKeySize], nKeySize );
+            OIXSetUInt64( pabyEntry + nKeySize,
+                          static_cast<GUIntBig>(anFIDs[iEntry]) );
+        }
+        const size_t iFirst = anOrder[iStart];
+        abyLevelKeys.insert( abyLevelKeys.end(),
+                             abyKeys.begin() + iFirst * nKeySize,
+                             abyKeys.begin() + (iFirst + 1) * nKeySize );
+        anLevelOffsets.push_back( VSIFTellL( fpOut ) );
+        if( VSIFWriteL( &abyNode[0], nNodeSize, 1, fpOut ) != 1 )
+            return false;
+    }
+    poIndex->nLeafCount = anLevelOffsets.size();
+    poIndex->nDepth = 1;
+
+/* -------------------------------------------------------------------- */
+/*      Write interior levels until we reach a single root.             */
+/* -------------------------------------------------------------------- */
+    while( anLevelOffsets.size() > 1 )
+    {
+        std::vector<GByte> abyParentKeys;
+        std::vector<GUIntBig> anParentOffsets;
+        const size_t nChildren = anLevelOffsets.size();
+        for( size_t iStart = 0; iStart < nChildren; iStart += nPerNode )
+        {
+            const size_t nCount = std::min( nPerNode, nChildren - iStart );
+            std::fill( abyNode.begin(), abyNode.end(), 0 );
+            OIXSetUInt32( &abyNode[0], static_cast<GUInt32>(nCount) );
+            for( size_t i = 0; i < nCount; i++ )
+            {
+                GByte *pabyEntry = &abyNode[4 + i * nEntrySize];
+                memcpy( pabyEntry, &abyLevelKeys[(iStart + i) * nKeySize],
+                        nKeySize );
+                OIXSetUInt64( pabyEntry + nKeySize,
+                              anLevelOffsets[iStart + i] );
+            }
+            abyParentKeys.insert(
+                abyParentKeys.end(),
+                abyLevelKeys.begin() + iStart * nKeySize,
+                abyLevelKeys.begin() + (iStart + 1) * nKeySize );
+            anParentOffsets.push_back( VSIFTellL( fpOut ) );
+            if( VSIFWriteL( &abyNode[0], nNodeSize, 1, fpOut ) != 1 )
+                return false;
+        }
+        abyLevelKeys.swap( abyParentKeys );
+        anLevelOffsets.swap( anParentOffsets );
+        poIndex->nDepth++;
+    }
+    poIndex->nRootOffset = anLevelOffsets[0];
+
+    return true;
+}
+
+/************************************************************************/
+/*                               Flush()                                */
+/*                                                                      */
+/*      Rewrite the whole .oix file from the current state of all       */
+/*      indexes.  Trees are bulk loaded, which is much faster than      */
+/*      incremental insertions, and keeps them fully packed.            */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::Flush()
+
+{
+    bDirty = false;
+
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+    {
+        if( !apoIndexes[i]->bInMemory && !apoIndexes[i]->LoadEntries() )
+            return OGRERR_FAILURE;
+    }
+
+    if( fp != nullptr )
+    {
+        VSIFCloseL( fp );
+        fp = nullptr;
+    }
+
+    if( apoIndexes.empty() )
+    {
+        VSIStatBufL sStat;
+        if( VSIStatL( osFilename, &sStat ) == 0 )
+            VSIUnlink( osFilename );
+        return OGRERR_NONE;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Write the new file aside, and then rename it over the old one.  */
+/* -------------------------------------------------------------------- */
+    const CPLString osTmpFilename = osFilename + ".tmp";
+    VSILFILE *fpOut = VSIFOpenL( osTmpFilename, "wb" );
+    if( fpOut == nullptr )
+    {
+        CPLError( CE_Failure, CPLE_OpenFailed,
+                  "Failed to create %s.", osTmpFilename.c_str() );
+        return OGRERR_FAILURE;
+    }
+
+    GByte abyHeader[OIX_HEADER_SIZE] = {};
+    bool bOK = VSIFWriteL( abyHeader, OIX_HEADER_SIZE, 1, fpOut ) == 1;
+
+    std::vector<GByte> abyDir;
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    for( size_t i = 0; bOK && i < apoIndexes.size(); i++ )
+    {
+        OGRBTreeAttrIndex *poIndex = apoIndexes[i];
+        bOK = WriteTree( fpOut, poIndex );
+
+        OIXWriteUInt32( abyDir, static_cast<GUInt32>(poIndex->anFields.size()) );
+        for( size_t iKey = 0; iKey < poIndex->anFields.size(); iKey++ )
+        {
+            const char *pszName =
+                poDefn->GetFieldDefn( poIndex->anFields[iKey] )->GetNameRef();
+            OIXWriteUInt32( abyDir,
+                            static_cast<GUInt32>(poIndex->anFields[iKey]) );
+            OIXWriteUInt32( abyDir,
+                            static_cast<GUInt32>(poIndex->aeTypes[iKey]) );
+            OIXWriteUInt32( abyDir,
+                            static_cast<GUInt32>(poIndex->anWidths[iKey]) );
+            OIXWriteUInt32( abyDir, static_cast<GUInt32>(strlen(pszName)) );
+            abyDir.insert( abyDir.end(), pszName, pszName + strlen(pszName) );
+        }
+        OIXWriteUInt32( abyDir, static_cast<GUInt32>(poIndex->nNodeSize) );
+        OIXWriteUInt32( abyDir, static_cast<GUInt32>(poIndex->nDepth) );
+        OIXWriteUInt64( abyDir, poIndex->nRootOffset );
+        OIXWriteUInt64( abyDir, poIndex->nFirstLeafOffset );
+        OIXWriteUInt64( abyDir, poIndex->nLeafCount );
+        OIXWriteUInt64( abyDir, poIndex->nEntryCount );
+    }
+
+    const GUIntBig nDirOffset = VSIFTellL( fpOut );
+    if( bOK && !abyDir.empty() )
+        bOK = VSIFWriteL( &abyDir[0], abyDir.size(), 1, fpOut ) == 1;
+
+    memcpy( abyHeader, OIX_SIGNATURE, sizeof(OIX_SIGNATURE) );
+    OIXSetUInt32( abyHeader + 8, OIX_VERSION );
+    OIXSetUInt32( abyHeader + 12, static_cast<GUInt32>(apoIndexes.size()) );
+    OIXSetUInt64( abyHeader + 16, nDirOffset );
+    OIXSetUInt32( abyHeader + 24, static_cast<GUInt32>(abyDir.size()) );
+    OIXSetUInt32( abyHeader + 28, bStale ? OIX_FLAG_OUT_OF_DATE : 0 );
+    OIXSetUInt64( abyHeader + 32, nSourceSize );
+    OIXSetUInt64( abyHeader + 40, static_cast<GUIntBig>(nSourceMTime) );
+    bOK = bOK && VSIFSeekL( fpOut, 0, SEEK_SET ) == 0 &&
+          VSIFWriteL( abyHeader, OIX_HEADER_SIZE, 1, fpOut ) == 1;
+
+    if( VSIFCloseL( fpOut ) != 0 )
+        bOK = false;
+
+    if( !bOK || VSIRename( osTmpFilename, osFilename ) != 0 )
+    {
+        CPLError( CE_Failure, CPLE_FileIO,
+                  "Failed to write attribute index %s.", osFilename.c_str() );
+        VSIUnlink( osTmpFilename );
+        return OGRERR_FAILURE;
+    }
+
+    fp = VSIFOpenL( osFilename, "rb" );
+    if( fp == nullptr )
+        return OGRERR_FAILURE;
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                             FindIndex()                              */
+/************************************************************************/
+
+OGRBTreeAttrIndex *OGRBTreeLayerAttrIndex::FindIndex(
+    int nFieldCount, const int *panFields ) const
+
+{
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+    {
+        if( static_cast<int>(apoIndexes[i]->anFields.size()) == nFieldCount &&
+            std::equal( panFields, panFields + nFieldCount,
+                        apoIndexes[i]->anFields.begin() ) )
+            return apoIndexes[i];
+    }
+    return nullptr;
+}
+
+/************************************************************************/
+/*                            CreateIndex()                             */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::CreateIndex( int iField )
+
+{
+    return CreateMultiFieldIndex( 1, &iField );
+}
+
+/************************************************************************/
+/*                       CreateMultiFieldIndex()                        */
+/*                                                                      */
+/*      Create an index on the indicated fields, but do not populate    */
+/*      it.  Use IndexAllFeatures() with the first field for that.      */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::CreateMultiFieldIndex( int nFieldCount,
+                                                      const int *panFields )
+
+{
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    std::vector<OGRFieldType> aeTypes;
+
+    for( int i = 0; i < nFieldCount; i++ )
+    {
+        if( panFields[i] < 0 || panFields[i] >= poDefn->GetFieldCount() )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Invalid field index %d.", panFields[i] );
+            return OGRERR_FAILURE;
+        }
+        OGRFieldDefn *poFldDefn = poDefn->GetFieldDefn(panFields[i]);
+        if( !OIXIsSupportedType( poFldDefn->GetType() ) )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Indexing not support for the field type of field %s.",
+                      poFldDefn->GetNameRef() );
+            return OGRERR_FAILURE;
+        }
+        for( int j = 0; j < i; j++ )
+        {
+            if( panFields[j] == panFields[i] )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "Field %s appears several times in index.",
+                          poFldDefn->GetNameRef() );
+                return OGRERR_FAILURE;
+            }
+        }
+        aeTypes.push_back( poFldDefn->GetType() );
+    }
+
+    if( FindIndex( nFieldCount, panFields ) != nullptr )
+    {
+        // Out of date indexes are rebuilt by IndexAllFeatures().
+        if( bStale )
+            return OGRERR_NONE;
+
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "It seems we already have an index for field %d/%s\n"
+                  "of layer %s.",
+                  panFields[0],
+                  poDefn->GetFieldDefn(panFields[0])->GetNameRef(),
+                  poDefn->GetName() );
+        return OGRERR_FAILURE;
+    }
+
+    apoIndexes.push_back(
+        new OGRBTreeAttrIndex( this, nFieldCount, panFields, &aeTypes[0] ) );
+    bDirty = true;
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                             DropIndex()                              */
+/*                                                                      */
+/*      Drop all indexes whose first key field is iField.               */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::DropIndex( int iField )
+
+{
+    bool bFound = false;
+    for( size_t i = 0; i < apoIndexes.size(); )
+    {
+        if( apoIndexes[i]->anFields[0] == iField )
+        {
+            delete apoIndexes[i];
+            apoIndexes.erase( apoIndexes.begin() + i );
+            bFound = true;
+        }
+        else
+            i++;
+    }
+
+    if( !bFound )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "DROP INDEX on field (%s) that doesn't have an index.",
+                  poLayer->GetLayerDefn()->GetFieldDefn(iField)->GetNameRef() );
+        return OGRERR_FAILURE;
+    }
+
+    return Flush();
+}
+
+/************************************************************************/
+/*                        DropMultiFieldIndex()                         */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::DropMultiFieldIndex( int nFieldCount,
+                                                    const int *panFields )
+
+{
+    OGRBTreeAttrIndex *poIndex = FindIndex( nFieldCount, panFields );
+    if( poIndex == nullptr )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "DROP INDEX on fields that don't have an index." );
+        return OGRERR_FAILURE;
+    }
+
+    apoIndexes.erase( std::find( apoIndexes.begin(), apoIndexes.end(),
+                                 poIndex ) );
+    delete poIndex;
+
+    return Flush();
+}
+
+/************************************************************************/
+/*                          IndexAllFeatures()                          */
+/*                                                                      */
+/*      (Re)build all indexes whose first key field is iField, or all   */
+/*      indexes if iField is -1 or if they are out of date.             */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::IndexAllFeatures( int iField )
+
+{
+    if( bStale )
+        iField = -1;
+
+    // Record the state of the indexed file before reading it, so that a
+    // modification during the scan makes the index out of date.
+    StatSource( nSourceSize, nSourceMTime );
+
+    std::vector<OGRBTreeAttrIndex*> apoTargets;
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+    {
+        if( iField == -1 || apoIndexes[i]->anFields[0] == iField )
+        {
+            apoIndexes[i]->Clear();
+            apoTargets.push_back( apoIndexes[i] );
+        }
+    }
+
+    // Prevent the layer from querying the index while we are building it.
+    bBulkLoading = true;
+
+    poLayer->ResetReading();
+
+    OGRFeature *poFeature = nullptr;
+    OGRErr eErr = OGRERR_NONE;
+    while( eErr == OGRERR_NONE &&
+           (poFeature = poLayer->GetNextFeature()) != nullptr )
+    {
+        if( poFeature->GetFID() == OGRNullFID )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Attempt to index feature with no FID." );
+            eErr = OGRERR_FAILURE;
+        }
+
+        for( size_t i = 0; eErr == OGRERR_NONE && i < apoTargets.size(); i++ )
+        {
+            OGRBTreeEntry oEntry;
+            if( apoTargets[i]->BuildEntryKey( poFeature, oEntry.osKey ) )
+            {
+                oEntry.nFID = poFeature->GetFID();
+                apoTargets[i]->aoEntries.push_back( oEntry );
+            }
+        }
+
+        delete poFeature;
+    }
+
+    bBulkLoading = false;
+
+    poLayer->ResetReading();
+
+    if( eErr != OGRERR_NONE )
+        return eErr;
+
+    bStale = false;
+    bRebuilt = true;
+
+    return Flush();
+}
+
+/************************************************************************/
+/*                             AddToIndex()                             */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::AddToIndex( OGRFeature *poFeature,
+                                           int iTargetField )
+
+{
+    if( poFeature->GetFID() == OGRNullFID )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Attempt to index feature with no FID." );
+        return OGRERR_FAILURE;
+    }
+
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+    {
+        OGRBTreeAttrIndex *poIndex = apoIndexes[i];
+        if( iTargetField != -1 && iTargetField != poIndex->anFields[0] )
+            continue;
+
+        OGRBTreeEntry oEntry;
+        if( !poIndex->BuildEntryKey( poFeature, oEntry.osKey ) )
+            continue;
+        if( !poIndex->bInMemory && !poIndex->LoadEntries() )
+            return OGRERR_FAILURE;
+        oEntry.nFID = poFeature->GetFID();
+        poIndex->aoEntries.push_back( oEntry );
+        bDirty = true;
+    }
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          RemoveFromIndex()                           */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::RemoveFromIndex( OGRFeature *poFeature )
+
+{
+    const GIntBig nFID = poFeature->GetFID();
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+    {
+        OGRBTreeAttrIndex *poIndex = apoIndexes[i];
+        if( !poIndex->bInMemory && !poIndex->LoadEntries() )
+            return OGRERR_FAILURE;
+
+        std::vector<OGRBTreeEntry>& aoEntries = poIndex->aoEntries;
+        for( size_t j = 0; j < aoEntries.size(); )
+        {
+            if( aoEntries[j].nFID == nFID )
+            {
+                aoEntries[j] = aoEntries.back();
+                aoEntries.pop_back();
+            }
+            else
+                j++;
+        }
+        bDirty = true;
+    }
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                           GetFieldIndex()                            */
+/*                                                                      */
+/*      Prefer a single column index, otherwise return a multi-column   */
+/*      index whose first key field is the requested one.               */
+/************************************************************************/
+
+OGRAttrIndex *OGRBTreeLayerAttrIndex::GetFieldIndex( int iField )
+
+{
+    if( bStale )
+        return nullptr;
+
+    OGRAttrIndex *poRet = nullptr;
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+    {
+        if( apoIndexes[i]->anFields[0] == iField )
+        {
+            if( apoIndexes[i]->anFields.size() == 1 )
+                return apoIndexes[i];
+            if( poRet == nullptr )
+                poRet = apoIndexes[i];
+        }
+    }
+
+    return poRet;
+}
+
+/************************************************************************/
+/*                         GetIndexByPosition()                         */
+/************************************************************************/
+
+OGRAttrIndex *OGRBTreeLayerAttrIndex::GetIndexByPosition( int iIndex )
+
+{
+    if( bStale ||
+        iIndex < 0 || iIndex >= static_cast<int>(apoIndexes.size()) )
+        return nullptr;
+    return apoIndexes[iIndex];
+}
+
+/************************************************************************/
+/*                             Invalidate()                             */
+/************************************************************************/
+
+void OGRBTreeLayerAttrIndex::Invalidate()
+
+{
+    bStale = true;
+    bInvalidated = true;
+}
+
+/************************************************************************/
+/*                     OGRCreateDefaultLayerIndex()                     */
+/************************************************************************/
+
+OGRLayerAttrIndex *OGRCreateDefaultLayerIndex()
+
+{
+    return new OGRBTreeLayerAttrIndex();
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                          OGRBTreeAttrIndex                           */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                         OGRBTreeAttrIndex()                          */
+/************************************************************************/
+
+OGRBTreeAttrIndex::OGRBTreeAttrIndex( OGRBTreeLayerAttrIndex *poLIndexIn,
+                                      int nFieldCount, const int *panFields,
+                                      const OGRFieldType *paeTypes ) :
+    poLIndex(poLIndexIn),
+    anFields(panFields, panFields + nFieldCount),
+    aeTypes(paeTypes, paeTypes + nFieldCount),
+    nKeySize(0),
+    nNodeSize(0),
+    nDepth(0),
+    nRootOffset(0),
+    nFirstLeafOffset(0),
+    nLeafCount(0),
+    nEntryCount(0),
+    bInMemory(true)
+{}
+
+/************************************************************************/
+/*                           BuildEntryKey()                            */
+/*                                                                      */
+/*      Build the variable length key of a feature.  Features whose     */
+/*      first key field is null are not indexed.  Null values of other  */
+/*      key fields sort first, which is harmless since index lookups    */
+/*      are always refined by evaluating the attribute filter.          */
+/************************************************************************/
+
+bool OGRBTreeAttrIndex::BuildEntryKey( OGRFeature *poFeature,
+                                       std::string& osKey ) const
+
+{
+    osKey.clear();
+    for( size_t iKey = 0; iKey < anFields.size(); iKey++ )
+    {
+        const int iField = anFields[iKey];
+        const bool bSet = CPL_TO_BOOL(poFeature->IsFieldSetAndNotNull(iField));
+        const OGRField *psField = poFeature->GetRawFieldRef(iField);
+        GByte abyNum[8] = {};
+        std::string osSegment;
+
+        if( bSet && aeTypes[iKey] == OFTInteger )
+        {
+            OIXEncodeInt64( psField->Integer, abyNum );
+            osSegment.assign( reinterpret_cast<char*>(abyNum), 8 );
+        }
+        else if( bSet && aeTypes[iKey] == OFTInteger64 )
+        {
+            OIXEncodeInt64( psField->Integer64, abyNum );
+            osSegment.assign( reinterpret_cast<char*>(abyNum), 8 );
+        }
+        else if( bSet && aeTypes[iKey] == OFTReal &&
+                 !CPLIsNan(psField->Real) )
+        {
+            OIXEncodeDouble( psField->Real, abyNum );
+            osSegment.assign( reinterpret_cast<char*>(abyNum), 8 );
+        }
+        else if( bSet && aeTypes[iKey] == OFTString )
+        {
+            osSegment = OIXEncodeString( psField->String,
+                                         OIX_MAX_STRING_KEY_WIDTH );
+        }
+        else if( iKey == 0 )
+        {
+            return false;
+        }
+
+        osKey += static_cast<char>(osSegment.size());
+        osKey += osSegment;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                            LoadEntries()                             */
+/*                                                                      */
+/*      Load the content of the on-disk tree in memory, so that it      */
+/*      can be modified and later rewritten.                            */
+/************************************************************************/
+
+bool OGRBTreeAttrIndex::LoadEntries()
+
+{
+    aoEntries.clear();
+    bInMemory = true;
+    if( nDepth == 0 )
+        return true;
+
+    const int nEntrySize = nKeySize + 8;
+    std::vector<GByte> abyNode;
+    for( GUIntBig iLeaf = 0; iLeaf < nLeafCount; iLeaf++ )
+    {
+        if( !poLIndex->ReadNode( nFirstLeafOffset + iLeaf * nNodeSize,
+                                 nNodeSize, abyNode ) )
+            return false;
+        const GUInt32 nCount = OIXGetUInt32( &abyNode[0] );
+        if( nCount > static_cast<GUInt32>((nNodeSize - 4) / nEntrySize) )
+            return false;
+        for( GUInt32 i = 0; i < nCount; i++ )
+        {
+            const GByte *pabyEntry = &abyNode[4 + i * nEntrySize];
+            OGRBTreeEntry oEntry;
+            for( size_t iKey = 0; iKey < anFields.size(); iKey++ )
+            {
+                size_t nLen = anWidths[iKey];
+                if( aeTypes[iKey] == OFTString )
+                {
+                    nLen = 0;
+                    while( nLen < static_cast<size_t>(anWidths[iKey]) &&
+                           pabyEntry[nLen] != 0 )
+                        nLen++;
+                }
+                oEntry.osKey += static_cast<char>(nLen);
+                oEntry.osKey.append(
+                    reinterpret_cast<const char*>(pabyEntry), nLen );
+                pabyEntry += anWidths[iKey];
+            }
+            oEntry.nFID = static_cast<GIntBig>( OIXGetUInt64( pabyEntry ) );
+            aoEntries.push_back( oEntry );
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                           AppendKeyField()                           */
+/*                                                                      */
+/*      Append the fixed width encoding of a query value.  When bPad    */
+/*      is false, strings are not padded to the key width (prefix       */
+/*      lookups).  bTruncated is set if the value did not fit.          */
+/************************************************************************/
+
+bool OGRBTreeAttrIndex::AppendKeyField( int iKey, const OGRField *psField,
+                                        std::vector<GByte>& abyKey,
+                                        bool bPad, bool& bTruncated ) const
+
+{
+    GByte abyNum[8] = {};
+    switch( aeTypes[iKey] )
+    {
+      case OFTInteger:
+        OIXEncodeInt64( psField->Integer, abyNum );
+        break;
+
+      case OFTInteger64:
+        OIXEncodeInt64( psField->Integer64, abyNum );
+        break;
+
+      case OFTReal:
+        if( CPLIsNan(psField->Real) )
+            return false;
+        OIXEncodeDouble( psField->Real, abyNum );
+        break;
+
+      case OFTString:
+      {
+        if( psField->String == nullptr )
+            return false;
+        const size_t nWidth = static_cast<size_t>(anWidths[iKey]);
+        const std::string osVal = OIXEncodeString( psField->String, nWidth );
+        if( strlen(psField->String) > nWidth )
+            bTruncated = true;
+        abyKey.insert( abyKey.end(), osVal.begin(), osVal.end() );
+        if( bPad )
+            abyKey.resize( abyKey.size() + nWidth - osVal.size(), 0 );
+        return true;
+      }
+
+      default:
+        return false;
+    }
+
+    abyKey.insert( abyKey.end(), abyNum, abyNum + 8 );
+    return true;
+}
+
+/************************************************************************/
+/*                                Scan()                                */
+/*                                                                      */
+/*      Append the FIDs of all entries whose key prefix is between      */
+/*      abyLow and abyHigh.  Each bound is compared with the same       */
+/*      number of leading bytes of the entry keys, and an empty bound   */
+/*      means unbounded.                                                */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::Scan( const std::vector<GByte>& abyLow,
+                                  bool bLowIncluded,
+                                  const std::vector<GByte>& abyHigh,
+                                  bool bHighIncluded,
+                                  GIntBig* panFIDList, int* pnFIDCount,
+                                  int* pnLength )
+
+{
+    if( panFIDList == nullptr )
+    {
+        panFIDList = static_cast<GIntBig *>(CPLMalloc(sizeof(GIntBig) * 2));
+        *pnFIDCount = 0;
+        *pnLength = 2;
+    }
+    panFIDList[*pnFIDCount] = OGRNullFID;
+
+    if( nDepth == 0 )
+        return panFIDList;
+
+    const int nEntrySize = nKeySize + 8;
+    const size_t nLowLen = abyLow.size();
+    const size_t nHighLen = abyHigh.size();
+    std::vector<GByte> abyNode;
+
+/* -------------------------------------------------------------------- */
+/*      Descend to the leftmost leaf that may hold the low bound.       */
+/* -------------------------------------------------------------------- */
+    vsi_l_offset nOffset = nRootOffset;
+    for( int iLevel = nDepth; iLevel > 1; iLevel-- )
+    {
+        if( !poLIndex->ReadNode( nOffset, nNodeSize, abyNode ) )
+            return panFIDList;
+        const int nCount = static_cast<int>(OIXGetUInt32( &abyNode[0] ));
+        if( nCount <= 0 || nCount > (nNodeSize - 4) / nEntrySize )
+            return panFIDList;
+
+        // Find the last child whose first key is strictly lower than
+        // the low bound: duplicates of the bound may start there.
+        int nLo = 0;
+        int nHi = nCount;
+        while( nLowLen > 0 && nLo < nHi )
+        {
+            const int nMid = (nLo + nHi) / 2;
+            if( memcmp( &abyNode[4 + nMid * nEntrySize], &abyLow[0],
+                        nLowLen ) < 0 )
+                nLo = nMid + 1;
+            else
+                nHi = nMid;
+        }
+        const int iChild = nLo > 0 ? nLo - 1 : 0;
+        nOffset = OIXGetUInt64( &abyNode[4 + iChild * nEntrySize + nKeySize] );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Scan the leaves forward.                                        */
+/* -------------------------------------------------------------------- */
+    GUIntBig iLeaf = (nOffset - nFirstLeafOffset) / nNodeSize;
+    bool bFirstLeaf = true;
+    for( ; iLeaf < nLeafCount; iLeaf++ )
+    {
+        if( !poLIndex->ReadNode( nFirstLeafOffset + iLeaf * nNodeSize,
+                                 nNodeSize, abyNode ) )
+            break;
+        const int nCount = static_cast<int>(OIXGetUInt32( &abyNode[0] ));
+        if( nCount > (nNodeSize - 4) / nEntrySize )
+            break;
+
+        int i = 0;
+        if( bFirstLeaf && nLowLen > 0 )
+        {
+            int nHi = nCount;
+            while( i < nHi )
+            {
+                const int nMid = (i + nHi) / 2;
+                const int nCmp = memcmp( &abyNode[4 + nMid * nEntrySize],
+                                         &abyLow[0], nLowLen );
+                if( nCmp < 0 || (nCmp == 0 && !bLowIncluded) )
+                    i = nMid + 1;
+                else
+                    nHi = nMid;
+            }
+        }
+
+        for( ; i < nCount; i++ )
+        {
+            const GByte *pabyEntry = &abyNode[4 + i * nEntrySize];
+            if( !bFirstLeaf && nLowLen > 0 && !bLowIncluded &&
+                memcmp( pabyEntry, &abyLow[0], nLowLen ) == 0 )
+                continue;
+            if( nHighLen > 0 )
+            {
+                const int nCmp = memcmp( pabyEntry, &abyHigh[0], nHighLen );
+                if( nCmp > 0 || (nCmp == 0 && !bHighIncluded) )
+                    return panFIDList;
+            }
+
+            if( *pnFIDCount >= *pnLength - 1 )
+            {
+                *pnLength = (*pnLength) * 2 + 10;
+                panFIDList = static_cast<GIntBig *>(
+                    CPLRealloc(panFIDList, sizeof(GIntBig) * (*pnLength)));
+            }
+            panFIDList[(*pnFIDCount)++] =
+                static_cast<GIntBig>( OIXGetUInt64( pabyEntry + nKeySize ) );
+            panFIDList[*pnFIDCount] = OGRNullFID;
+        }
+        bFirstLeaf = false;
+    }
+
+    return panFIDList;
+}
+
+/************************************************************************/
+/*                          GetRangeMatches()                           */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::GetRangeMatches( int nEqualCount,
+                                             const OGRField *pasEqualKeys,
+                                             const OGRField *psMin,
+                                             int bMinIncluded,
+                                             const OGRField *psMax,
+                                             int bMaxIncluded,
+                                             GIntBig* panFIDList,
+                                             int* nFIDCount, int* nLength )
+
+{
+    const int nKeyFields = static_cast<int>(anFields.size());
+    if( nEqualCount > nKeyFields ||
+        (nEqualCount == nKeyFields && (psMin != nullptr || psMax != nullptr)) )
+        return panFIDList;
+
+    // Flush now, so that key widths are known.
+    if( poLIndex->bBulkLoading ||
+        ((bInMemory || poLIndex->bDirty) &&
+         poLIndex->Flush() != OGRERR_NONE) )
+        return panFIDList;
+
+    std::vector<GByte> abyPrefix;
+    bool bTruncated = false;
+    for( int i = 0; i < nEqualCount; i++ )
+    {
+        if( !AppendKeyField( i, pasEqualKeys + i, abyPrefix, true,
+                             bTruncated ) )
+            return panFIDList;
+    }
+
+    std::vector<GByte> abyLow( abyPrefix );
+    std::vector<GByte> abyHigh( abyPrefix );
+    bool bLowIncluded = true;
+    bool bHighIncluded = true;
+    if( psMin != nullptr )
+    {
+        bool bMinTruncated = false;
+        if( !AppendKeyField( nEqualCount, psMin, abyLow, true,
+                             bMinTruncated ) )
+            return panFIDList;
+        bLowIncluded = bMinIncluded || bMinTruncated;
+    }
+    if( psMax != nullptr )
+    {
+        bool bMaxTruncated = false;
+        if( !AppendKeyField( nEqualCount, psMax, abyHigh, true,
+                             bMaxTruncated ) )
+            return panFIDList;
+        bHighIncluded = bMaxIncluded || bMaxTruncated;
+    }
+
+    int nLocalCount = 0;
+    int nLocalLength = 0;
+    if( nFIDCount == nullptr || nLength == nullptr )
+    {
+        nFIDCount = &nLocalCount;
+        nLength = &nLocalLength;
+    }
+    return Scan( abyLow, bLowIncluded, abyHigh, bHighIncluded,
+                 panFIDList, nFIDCount, nLength );
+}
+
+/************************************************************************/
+/*                          GetPrefixMatches()                          */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::GetPrefixMatches( int nEqualCount,
+                                              const OGRField *pasEqualKeys,
+                                              const char *pszPrefix,
+                                              GIntBig* panFIDList,
+                                              int* nFIDCount, int* nLength )
+
+{
+    if( nEqualCount >= static_cast<int>(anFields.size()) ||
+        aeTypes[nEqualCount] != OFTString )
+        return panFIDList;
+
+    if( poLIndex->bBulkLoading ||
+        ((bInMemory || poLIndex->bDirty) &&
+         poLIndex->Flush() != OGRERR_NONE) )
+        return panFIDList;
+
+    std::vector<GByte> abyPrefix;
+    bool bTruncated = false;
+    for( int i = 0; i < nEqualCount; i++ )
+    {
+        if( !AppendKeyField( i, pasEqualKeys + i, abyPrefix, true,
+                             bTruncated ) )
+            return panFIDList;
+    }
+
+    OGRField sPrefix;
+    sPrefix.String = const_cast<char*>(pszPrefix);
+    if( !AppendKeyField( nEqualCount, &sPrefix, abyPrefix, false,
+                         bTruncated ) )
+        return panFIDList;
+
+    int nLocalCount = 0;
+    int nLocalLength = 0;
+    if( nFIDCount == nullptr || nLength == nullptr )
+    {
+        nFIDCount = &nLocalCount;
+        nLength = &nLocalLength;
+    }
+    return Scan( abyPrefix, true, abyPrefix, true,
+                 panFIDList, nFIDCount, nLength );
+}
+
+/************************************************************************/
+/*                           GetAllMatches()                            */
+/*                                                                      */
+/*      Equality on the first key field.                                */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::GetAllMatches( OGRField *psKey,
+                                           GIntBig* panFIDList,
+                                           int* nFIDCount, int* nLength )
+
+{
+    return GetRangeMatches( 1, psKey, nullptr, TRUE, nullptr, TRUE,
+                            panFIDList, nFIDCount, nLength );
+}
+
+GIntBig *OGRBTreeAttrIndex::GetAllMatches( OGRField *psKey )
+
+{
+    int nFIDCount = 0;
+    int nLength = 0;
+    return GetAllMatches( psKey, nullptr, &nFIDCount, &nLength );
+}
+
+/************************************************************************/
+/*                           GetFirstMatch()                            */
+/************************************************************************/
+
+GIntBig OGRBTreeAttrIndex::GetFirstMatch( OGRField *psKey )
+
+{
+    GIntBig *panFIDs = GetAllMatches( psKey );
+    const GIntBig nFID = panFIDs ? panFIDs[0] : OGRNullFID;
+    CPLFree( panFIDs );
+    return nFID;
+}
+
+/************************************************************************/
+/*                              AddEntry()                              */
+/************************************************************************/
+
+OGRErr OGRBTreeAttrIndex::AddEntry( OGRField *psKey, GIntBig nFID )
+
+{
+    if( psKey == nullptr || anFields.size() != 1 )
+        return OGRERR_FAILURE;
+
+    OGRBTreeEntry oEntry;
+    GByte abyNum[8] = {};
+    switch( aeTypes[0] )
+    {
+      case OFTInteger:
+        OIXEncodeInt64( psKey->Integer, abyNum );
+        oEntry.osKey.assign( reinterpret_cast<char*>(abyNum), 8 );
+        break;
+      case OFTInteger64:
+        OIXEncodeInt64( psKey->Integer64, abyNum );
+        oEntry.osKey.assign( reinterpret_cast<char*>(abyNum), 8 );
+        break;
+      case OFTReal:
+        OIXEncodeDouble( psKey->Real, abyNum );
+        oEntry.osKey.assign( reinterpret_cast<char*>(abyNum), 8 );
+        break;
+      default:
+        oEntry.osKey = OIXEncodeString( psKey->String,
+                                        OIX_MAX_STRING_KEY_WIDTH );
+        break;
+    }
+    oEntry.osKey.insert( 0, 1, static_cast<char>(oEntry.osKey.size()) );
+    oEntry.nFID = nFID;
+
+    if( !bInMemory && !LoadEntries() )
+        return OGRERR_FAILURE;
+    aoEntries.push_back( oEntry );
+    poLIndex->bDirty = true;
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                            RemoveEntry()                             */
+/************************************************************************/
+
+OGRErr OGRBTreeAttrIndex::RemoveEntry( OGRField * /*psKey*/, GIntBig nFID )
+
+{
+    if( !bInMemory && !LoadEntries() )
+        return OGRERR_FAILURE;
+
+    for( size_t i = 0; i < aoEntries.size(); )
+    {
+        if( aoEntries[i].nFID == nFID )
+        {
+            aoEntries[i] = aoEntries.back();
+            aoEntries.pop_back();
+        }
+        else
+            i++;
+    }
+    poLIndex->bDirty = true;
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                               Clear()                                */
+/************************************************************************/
+
+OGRErr OGRBTreeAttrIndex::Clear()
+
+{
+    aoEntries.clear();
+    bInMemory = true;
+    poLIndex->bDirty = true;
+
+    return OGRERR_NONE;
+}
+
+//! @endcond
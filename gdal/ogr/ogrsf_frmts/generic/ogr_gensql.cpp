@@ -33,7 +33,10 @@
 #include "cpl_string.h"
 #include "ogr_api.h"
 #include "cpl_time.h"
+#include "cpl_worker_thread_pool.h"
 #include <algorithm>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 //! @cond Doxygen_Suppress
@@ -100,12 +103,15 @@ OGRGenSQLResultsLayer::OGRGenSQLResultsLayer( GDALDataset *poSrcDSIn,
     nIndexSize(0),
     panFIDIndex(nullptr),
     bOrderByValid(FALSE),
+    m_bOrderByFailed(false),
+    fpFIDIndex(nullptr),
     nNextIndexFID(0),
     poSummaryFeature(nullptr),
     iFIDFieldIndex(),
     nExtraDSCount(0),
     papoExtraDS(nullptr),
-    nIteratedFeatures(-1)
+    nIteratedFeatures(-1),
+    m_bGroupsPrepared(false)
 {
     swq_select *psSelectInfo = (swq_select *) pSelectInfoIn;
 
@@ -513,10 +519,11 @@ OGRGenSQLResultsLayer::~OGRGenSQLResultsLayer()
     CPLFree( papoTableLayers );
     papoTableLayers = nullptr;
 
-    CPLFree( panFIDIndex );
+    InvalidateOrderByIndex();
     CPLFree( panGeomFieldToSrcGeomField );
 
     delete poSummaryFeature;
+    ClearGroups();
     delete (swq_select *) pSelectInfo;
 
     if( poDefn != nullptr )
@@ -660,7 +667,8 @@ OGRErr OGRGenSQLResultsLayer::SetNextByIndex( GIntBig nIndex )
 
     if( psSelectInfo->query_mode == SWQM_SUMMARY_RECORD
         || psSelectInfo->query_mode == SWQM_DISTINCT_LIST
-        || panFIDIndex != nullptr )
+        || psSelectInfo->query_mode == SWQM_GROUP_BY
+        || HasFIDIndex() )
     {
         nNextIndexFID = nIndex + psSelectInfo->offset;
         return OGRERR_NONE;
@@ -729,6 +737,22 @@ GIntBig OGRGenSQLResultsLayer::GetFeatureCount( int bForce )
 
         nRet = psSelectInfo->column_summary[0].count;
     }
+    else if( psSelectInfo->query_mode == SWQM_GROUP_BY )
+    {
+        if( !PrepareGroups() )
+            return 0;
+
+        if( m_poAttrQuery == nullptr )
+            nRet = static_cast<GIntBig>(m_apoGroupFeatures.size());
+        else
+        {
+            for( size_t i = 0; i < m_apoGroupFeatures.size(); i++ )
+            {
+                if( m_poAttrQuery->Evaluate( m_apoGroupFeatures[i] ) )
+                    nRet++;
+            }
+        }
+    }
     else if( psSelectInfo->query_mode != SWQM_RECORDSET )
         return 1;
     else if( m_poAttrQuery == nullptr && !MustEvaluateSpatialFilterOnGenSQL() )
@@ -759,7 +783,8 @@ int OGRGenSQLResultsLayer::TestCapability( const char *pszCap )
     {
         if( psSelectInfo->query_mode == SWQM_SUMMARY_RECORD
             || psSelectInfo->query_mode == SWQM_DISTINCT_LIST
-            || panFIDIndex != nullptr )
+            || psSelectInfo->query_mode == SWQM_GROUP_BY
+            || HasFIDIndex() )
             return TRUE;
         else
             return poSrcLayer->TestCapability( pszCap );
@@ -813,6 +838,104 @@ int OGRGenSQLResultsLayer::ContainGeomSpecialField(swq_expr_node* expr)
     return FALSE;
 }
 
+/************************************************************************/
+/*                       MustReadSourceGeometry()                       */
+/*                                                                      */
+/*      Whether a summary or GROUP BY scan of the source layer needs    */
+/*      geometries: if a spatial filter is in place, or if the where    */
+/*      clause or a column references the geometry or the               */
+/*      OGR_GEOMETRY, OGR_GEOM_WKT or OGR_GEOM_AREA special fields.     */
+/************************************************************************/
+
+bool OGRGenSQLResultsLayer::MustReadSourceGeometry()
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+
+    if( m_poFilterGeom != nullptr ||
+        (psSelectInfo->where_expr != nullptr &&
+         ContainGeomSpecialField(psSelectInfo->where_expr)) )
+        return true;
+
+    for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
+    {
+        swq_col_def *psColDef = psSelectInfo->column_defs + iField;
+        if (psColDef->table_index == 0 && psColDef->field_index != -1)
+        {
+            OGRLayer* poLayer = papoTableLayers[psColDef->table_index];
+            int nSpecialFieldIdx = psColDef->field_index -
+                            poLayer->GetLayerDefn()->GetFieldCount();
+            if (nSpecialFieldIdx == SPF_OGR_GEOMETRY ||
+                nSpecialFieldIdx == SPF_OGR_GEOM_WKT ||
+                nSpecialFieldIdx == SPF_OGR_GEOM_AREA)
+                return true;
+            if( psColDef->field_index ==
+                    GEOM_FIELD_INDEX_TO_ALL_FIELD_INDEX(poLayer->GetLayerDefn(), 0) )
+                return true;
+        }
+        if (psColDef->expr != nullptr && ContainGeomSpecialField(psColDef->expr))
+            return true;
+    }
+
+    return false;
+}
+
+/************************************************************************/
+/*                        SetSummaryFieldValue()                        */
+/*                                                                      */
+/*      Set the value of an aggregate column from its summary.          */
+/************************************************************************/
+
+static void SetSummaryFieldValue( OGRFeature *poFeature, int iField,
+                                  const swq_col_def *psColDef,
+                                  const swq_summary& oSummary )
+
+{
+    if( psColDef->col_func == SWQCF_AVG && oSummary.count > 0 )
+    {
+        if( psColDef->field_type == SWQ_DATE ||
+            psColDef->field_type == SWQ_TIME ||
+            psColDef->field_type == SWQ_TIMESTAMP)
+        {
+            struct tm brokendowntime;
+            double dfAvg = oSummary.sum / oSummary.count;
+            CPLUnixTimeToYMDHMS((GIntBig)dfAvg, &brokendowntime);
+            poFeature->SetField( iField,
+                                 brokendowntime.tm_year + 1900,
+                                 brokendowntime.tm_mon + 1,
+                                 brokendowntime.tm_mday,
+                                 brokendowntime.tm_hour,
+                                 brokendowntime.tm_min,
+                                 static_cast<float>(brokendowntime.tm_sec + fmod(dfAvg, 1)),
+                                 0);
+        }
+        else
+            poFeature->SetField( iField, oSummary.sum / oSummary.count );
+    }
+    else if( psColDef->col_func == SWQCF_MIN && oSummary.count > 0 )
+    {
+        if( psColDef->field_type == SWQ_DATE ||
+            psColDef->field_type == SWQ_TIME ||
+            psColDef->field_type == SWQ_TIMESTAMP)
+            poFeature->SetField( iField, oSummary.osMin.c_str() );
+        else
+            poFeature->SetField( iField, oSummary.min );
+    }
+    else if( psColDef->col_func == SWQCF_MAX && oSummary.count > 0 )
+    {
+        if( psColDef->field_type == SWQ_DATE ||
+            psColDef->field_type == SWQ_TIME ||
+            psColDef->field_type == SWQ_TIMESTAMP)
+            poFeature->SetField( iField, oSummary.osMax.c_str() );
+        else
+            poFeature->SetField( iField, oSummary.max );
+    }
+    else if( psColDef->col_func == SWQCF_COUNT )
+        poFeature->SetField( iField, oSummary.count );
+    else if( psColDef->col_func == SWQCF_SUM && oSummary.count > 0 )
+        poFeature->SetField( iField, oSummary.sum );
+}
+
 /************************************************************************/
 /*                           PrepareSummary()                           */
 /************************************************************************/
@@ -840,41 +963,8 @@ int OGRGenSQLResultsLayer::PrepareSummary()
 /*      OGR_GEOM_WKT or OGR_GEOM_AREA special fields.                   */
 /* -------------------------------------------------------------------- */
     int bSaveIsGeomIgnored = poSrcLayer->GetLayerDefn()->IsGeometryIgnored();
-    if ( m_poFilterGeom == nullptr && ( psSelectInfo->where_expr == nullptr ||
-                !ContainGeomSpecialField(psSelectInfo->where_expr) ) )
-    {
-        int bFoundGeomExpr = FALSE;
-        for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
-        {
-            swq_col_def *psColDef = psSelectInfo->column_defs + iField;
-            if (psColDef->table_index == 0 && psColDef->field_index != -1)
-            {
-                OGRLayer* poLayer = papoTableLayers[psColDef->table_index];
-                int nSpecialFieldIdx = psColDef->field_index -
-                                poLayer->GetLayerDefn()->GetFieldCount();
-                if (nSpecialFieldIdx == SPF_OGR_GEOMETRY ||
-                    nSpecialFieldIdx == SPF_OGR_GEOM_WKT ||
-                    nSpecialFieldIdx == SPF_OGR_GEOM_AREA)
-                {
-                    bFoundGeomExpr = TRUE;
-                    break;
-                }
-                if( psColDef->field_index ==
-                        GEOM_FIELD_INDEX_TO_ALL_FIELD_INDEX(poLayer->GetLayerDefn(), 0) )
-                {
-                    bFoundGeomExpr = TRUE;
-                    break;
-                }
-            }
-            if (psColDef->expr != nullptr && ContainGeomSpecialField(psColDef->expr))
-            {
-                bFoundGeomExpr = TRUE;
-                break;
-            }
-        }
-        if (!bFoundGeomExpr)
-            poSrcLayer->GetLayerDefn()->SetGeometryIgnored(TRUE);
-    }
+    if( !MustReadSourceGeometry() )
+        poSrcLayer->GetLayerDefn()->SetGeometryIgnored(TRUE);
 
 /* -------------------------------------------------------------------- */
 /*      We treat COUNT(*) as a special case, and fill with              */
@@ -1005,52 +1095,8 @@ int OGRGenSQLResultsLayer::PrepareSummary()
             swq_col_def *psColDef = psSelectInfo->column_defs + iField;
             if (!psSelectInfo->column_summary.empty() )
             {
-                swq_summary& oSummary = psSelectInfo->column_summary[iField];
-
-                if( psColDef->col_func == SWQCF_AVG && oSummary.count > 0 )
-                {
-                    if( psColDef->field_type == SWQ_DATE ||
-                        psColDef->field_type == SWQ_TIME ||
-                        psColDef->field_type == SWQ_TIMESTAMP)
-                    {
-                        struct tm brokendowntime;
-                        double dfAvg = oSummary.sum / oSummary.count;
-                        CPLUnixTimeToYMDHMS((GIntBig)dfAvg, &brokendowntime);
-                        poSummaryFeature->SetField( iField,
-                                                    brokendowntime.tm_year + 1900,
-                                                    brokendowntime.tm_mon + 1,
-                                                    brokendowntime.tm_mday,
-                                                    brokendowntime.tm_hour,
-                                                    brokendowntime.tm_min,
-                                                    static_cast<float>(brokendowntime.tm_sec + fmod(dfAvg, 1)),
-                                                    0);
-                    }
-                    else
-                        poSummaryFeature->SetField( iField,
-                                                    oSummary.sum / oSummary.count );
-                }
-                else if( psColDef->col_func == SWQCF_MIN && oSummary.count > 0 )
-                {
-                    if( psColDef->field_type == SWQ_DATE ||
-                        psColDef->field_type == SWQ_TIME ||
-                        psColDef->field_type == SWQ_TIMESTAMP)
-                        poSummaryFeature->SetField( iField, oSummary.osMin.c_str() );
-                    else
-                        poSummaryFeature->SetField( iField, oSummary.min );
-                }
-                else if( psColDef->col_func == SWQCF_MAX && oSummary.count > 0 )
-                {
-                    if( psColDef->field_type == SWQ_DATE ||
-                        psColDef->field_type == SWQ_TIME ||
-                        psColDef->field_type == SWQ_TIMESTAMP)
-                        poSummaryFeature->SetField( iField, oSummary.osMax.c_str() );
-                    else
-                        poSummaryFeature->SetField( iField, oSummary.max );
-                }
-                else if( psColDef->col_func == SWQCF_COUNT )
-                    poSummaryFeature->SetField( iField, oSummary.count );
-                else if( psColDef->col_func == SWQCF_SUM && oSummary.count > 0 )
-                    poSummaryFeature->SetField( iField, oSummary.sum );
+                SetSummaryFieldValue( poSummaryFeature, iField, psColDef,
+                                      psSelectInfo->column_summary[iField] );
             }
             else if ( psColDef->col_func == SWQCF_COUNT )
                 poSummaryFeature->SetField( iField, 0 );
@@ -1558,7 +1604,9 @@ OGRFeature *OGRGenSQLResultsLayer::GetNextFeature()
         return nullptr;
 
     CreateOrderByIndex();
-    if( panFIDIndex == nullptr &&
+    if( m_bOrderByFailed )
+        return nullptr;
+    if( !HasFIDIndex() &&
         nIteratedFeatures < 0 && psSelectInfo->offset > 0 &&
         psSelectInfo->query_mode == SWQM_RECORDSET )
     {
@@ -1577,6 +1625,29 @@ OGRFeature *OGRGenSQLResultsLayer::GetNextFeature()
         return GetFeature( nNextIndexFID++ );
     }
 
+/* -------------------------------------------------------------------- */
+/*      Handle GROUP BY results, on which an attribute filter may be    */
+/*      set.                                                            */
+/* -------------------------------------------------------------------- */
+    if( psSelectInfo->query_mode == SWQM_GROUP_BY )
+    {
+        while( true )
+        {
+            OGRFeature *poFeature = GetFeature( nNextIndexFID++ );
+            if( poFeature == nullptr )
+                return nullptr;
+
+            if( m_poAttrQuery == nullptr
+                || m_poAttrQuery->Evaluate( poFeature ) )
+            {
+                nIteratedFeatures ++;
+                return poFeature;
+            }
+
+            delete poFeature;
+        }
+    }
+
     int bEvaluateSpatialFilter = MustEvaluateSpatialFilterOnGenSQL();
 
 /* -------------------------------------------------------------------- */
@@ -1586,7 +1657,7 @@ OGRFeature *OGRGenSQLResultsLayer::GetNextFeature()
     {
         OGRFeature *poFeature = nullptr;
 
-        if( panFIDIndex != nullptr )
+        if( HasFIDIndex() )
             poFeature = GetFeature( nNextIndexFID++ );
         else
         {
@@ -1639,6 +1710,18 @@ OGRFeature *OGRGenSQLResultsLayer::GetFeature( GIntBig nFID )
             return poSummaryFeature->Clone();
     }
 
+/* -------------------------------------------------------------------- */
+/*      Handle request for a GROUP BY record.                           */
+/* -------------------------------------------------------------------- */
+    if( psSelectInfo->query_mode == SWQM_GROUP_BY )
+    {
+        if( !PrepareGroups() || nFID < 0 ||
+            nFID >= static_cast<GIntBig>(m_apoGroupFeatures.size()) )
+            return nullptr;
+
+        return m_apoGroupFeatures[static_cast<size_t>(nFID)]->Clone();
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Handle request for distinct list record.                        */
 /* -------------------------------------------------------------------- */
@@ -1711,12 +1794,12 @@ OGRFeature *OGRGenSQLResultsLayer::GetFeature( GIntBig nFID )
 /*      Are we running in sorted mode?  If so, run the fid through      */
 /*      the index.                                                      */
 /* -------------------------------------------------------------------- */
-    if( panFIDIndex != nullptr )
+    if( HasFIDIndex() )
     {
         if( nFID < 0 || nFID >= static_cast<GIntBig>(nIndexSize) )
             return nullptr;
         else
-            nFID = panFIDIndex[nFID];
+            nFID = GetFIDFromIndex( nFID );
     }
 
 /* -------------------------------------------------------------------- */
@@ -1895,6 +1978,37 @@ void OGRGenSQLResultsLayer::ReadIndexFields( OGRFeature* poSrcFeat,
     }
 }
 
+/************************************************************************/
+/*                        GetOrderByMaxMemory()                         */
+/*                                                                      */
+/*      Memory budget, in bytes, for the ORDER BY key values.           */
+/************************************************************************/
+
+static GIntBig GetOrderByMaxMemory()
+{
+    const char *pszMaxMemory =
+        CPLGetConfigOption("OGR_SQL_SORT_MAX_MEMORY", nullptr);
+    if( pszMaxMemory != nullptr )
+        return std::max(static_cast<GIntBig>(1),
+                        CPLAtoGIntBig(pszMaxMemory));
+
+    // Default to a quarter of the RAM, and 256 MB if unknown.
+    const GIntBig nUsableRAM = CPLGetUsablePhysicalRAM();
+    if( nUsableRAM > 0 )
+        return nUsableRAM / 4;
+    return static_cast<GIntBig>(256) * 1024 * 1024;
+}
+
+/************************************************************************/
+/*                           UnlinkSortRuns()                           */
+/************************************************************************/
+
+static void UnlinkSortRuns( const std::vector<CPLString>& aosRuns )
+{
+    for( size_t i = 0; i < aosRuns.size(); i++ )
+        VSIUnlink( aosRuns[i] );
+}
+
 /************************************************************************/
 /*                         CreateOrderByIndex()                         */
 /*                                                                      */
@@ -1908,8 +2022,12 @@ void OGRGenSQLResultsLayer::ReadIndexFields( OGRFeature* poSrcFeat,
 /*      this in memory copy of the order-by fields to create the        */
 /*      required index.                                                 */
 /*                                                                      */
-/*      Keeping all the key values in memory will *not* scale up to     */
-/*      very large input datasets.                                      */
+/*      When the key values do not fit in OGR_SQL_SORT_MAX_MEMORY       */
+/*      bytes, sorted runs are spilled to temporary files and merged,   */
+/*      and the resulting FID index is kept on disk.                    */
+/*                                                                      */
+/*      If the index cannot be built, m_bOrderByFailed is set so that   */
+/*      GetNextFeature() returns no feature rather than unsorted ones.  */
 /************************************************************************/
 
 void OGRGenSQLResultsLayer::CreateOrderByIndex()
@@ -1931,48 +2049,27 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
     ResetReading();
 
 /* -------------------------------------------------------------------- */
-/*      Optimize (memory-wise) ORDER BY ... LIMIT 1 [OFFSET 0] case.    */
+/*      Optimize (memory-wise) ORDER BY ... LIMIT n [OFFSET m] case     */
+/*      by only retaining the n+m best records in a heap.               */
 /* -------------------------------------------------------------------- */
-    if( psSelectInfo->offset == 0 && psSelectInfo->limit == 1 )
+    const GIntBig nMaxMemory = GetOrderByMaxMemory();
+    const GIntBig nRecordSize =
+        static_cast<GIntBig>(sizeof(OGRField)) * nOrderItems +
+        2 * static_cast<GIntBig>(sizeof(GIntBig));
+    if( psSelectInfo->limit >= 0 &&
+        psSelectInfo->limit <= nMaxMemory / nRecordSize &&
+        psSelectInfo->offset >= 0 &&
+        psSelectInfo->offset <= nMaxMemory / nRecordSize &&
+        m_poAttrQuery == nullptr && !MustEvaluateSpatialFilterOnGenSQL() )
     {
-        OGRFeature* poSrcFeat = poSrcLayer->GetNextFeature();
-        if( poSrcFeat == nullptr )
+        const GIntBig nTopN = psSelectInfo->offset + psSelectInfo->limit;
+        if( nTopN > 0 && nTopN <= nMaxMemory / 2 / nRecordSize )
         {
-            panFIDIndex = nullptr;
-            nIndexSize = 0;
+            if( !CreateTopNOrderByIndex( nTopN ) )
+                m_bOrderByFailed = true;
+            ResetReading();
             return;
         }
-
-        OGRField *pasCurrentFields = static_cast<OGRField *>(
-                                    CPLCalloc(sizeof(OGRField), nOrderItems));
-        OGRField *pasBestFields = static_cast<OGRField *>(
-                                    CPLCalloc(sizeof(OGRField), nOrderItems));
-        GIntBig nBestFID = poSrcFeat->GetFID();
-        ReadIndexFields( poSrcFeat, nOrderItems, pasBestFields);
-        delete poSrcFeat;
-        while( (poSrcFeat = poSrcLayer->GetNextFeature()) != nullptr )
-        {
-            ReadIndexFields( poSrcFeat, nOrderItems, pasCurrentFields);
-            if( Compare( pasCurrentFields, pasBestFields ) < 0 )
-            {
-                nBestFID = poSrcFeat->GetFID();
-                FreeIndexFields( pasBestFields, 1, false);
-                memcpy( pasBestFields, pasCurrentFields,
-                        sizeof(OGRField) * nOrderItems );
-            }
-            else
-            {
-                FreeIndexFields( pasCurrentFields, 1, false);
-            }
-            memset( pasCurrentFields, 0, sizeof(OGRField) * nOrderItems );
-            delete poSrcFeat;
-        }
-        VSIFree( pasCurrentFields );
-        FreeIndexFields( pasBestFields, 1 );
-        panFIDIndex = static_cast<GIntBig *>(CPLMalloc(sizeof(GIntBig)));
-        panFIDIndex[0] = nBestFID;
-        nIndexSize = 1;
-        return;
     }
 
 /* -------------------------------------------------------------------- */
@@ -1987,10 +2084,14 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
         CPLMalloc(sizeof(GIntBig) * nFeaturesAlloc));
 
 /* -------------------------------------------------------------------- */
-/*      Read in all the key values.                                     */
+/*      Read in all the key values.  When the memory budget is          */
+/*      exceeded, the records read so far are sorted and spilled to     */
+/*      a temporary file (a "run"), to be merged at the end.            */
 /* -------------------------------------------------------------------- */
     OGRFeature *poSrcFeat = nullptr;
     nIndexSize = 0;
+    GIntBig nMemoryUsed = 0;
+    std::vector<CPLString> aosRuns;
 
     while( (poSrcFeat = poSrcLayer->GetNextFeature()) != nullptr )
     {
@@ -2008,7 +2109,9 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
                          "Cannot allocate pasIndexFields");
                 FreeIndexFields( pasIndexFields, nIndexSize );
                 VSIFree(panFIDList);
+                UnlinkSortRuns(aosRuns);
                 nIndexSize = 0;
+                m_bOrderByFailed = true;
                 delete poSrcFeat;
                 return;
             }
@@ -2022,7 +2125,9 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
                          "Cannot allocate pasIndexFields");
                 FreeIndexFields( pasIndexFields, nIndexSize );
                 VSIFree(panFIDList);
+                UnlinkSortRuns(aosRuns);
                 nIndexSize = 0;
+                m_bOrderByFailed = true;
                 delete poSrcFeat;
                 return;
             }
@@ -2035,7 +2140,9 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
             {
                 FreeIndexFields( pasIndexFields, nIndexSize );
                 VSIFree(panFIDList);
+                UnlinkSortRuns(aosRuns);
                 nIndexSize = 0;
+                m_bOrderByFailed = true;
                 delete poSrcFeat;
                 return;
             }
@@ -2048,17 +2155,59 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
             nFeaturesAlloc = static_cast<size_t>(nNewFeaturesAlloc);
         }
 
-        ReadIndexFields( poSrcFeat, nOrderItems,
-                         pasIndexFields + nIndexSize * nOrderItems );
+        OGRField *pasCurFields = pasIndexFields + nIndexSize * nOrderItems;
+        ReadIndexFields( poSrcFeat, nOrderItems, pasCurFields );
 
         panFIDList[nIndexSize] = poSrcFeat->GetFID();
         delete poSrcFeat;
 
         nIndexSize++;
+
+        nMemoryUsed += GetIndexFieldsSize( pasCurFields, nOrderItems );
+        if( nMemoryUsed > nMaxMemory )
+        {
+            if( !WriteSortedRun( pasIndexFields, panFIDList, aosRuns ) )
+            {
+                FreeIndexFields( pasIndexFields, nIndexSize );
+                VSIFree(panFIDList);
+                UnlinkSortRuns(aosRuns);
+                nIndexSize = 0;
+                m_bOrderByFailed = true;
+                return;
+            }
+            FreeIndexFields( pasIndexFields, nIndexSize, false );
+            memset( pasIndexFields, 0,
+                    sizeof(OGRField) * nOrderItems * nIndexSize );
+            nIndexSize = 0;
+            nMemoryUsed = 0;
+        }
     }
 
     //CPLDebug("GenSQL", "CreateOrderByIndex() = %d features", nIndexSize);
 
+/* -------------------------------------------------------------------- */
+/*      If we had to spill to disk, write the last run and merge all    */
+/*      runs into an on-disk FID index.                                 */
+/* -------------------------------------------------------------------- */
+    if( !aosRuns.empty() )
+    {
+        bool bOK = nIndexSize == 0 ||
+                   WriteSortedRun( pasIndexFields, panFIDList, aosRuns );
+        FreeIndexFields( pasIndexFields, nIndexSize );
+        VSIFree(panFIDList);
+        nIndexSize = 0;
+        if( bOK )
+            bOK = CreateExternalOrderByIndex( aosRuns );
+        UnlinkSortRuns(aosRuns);
+        if( !bOK )
+        {
+            nIndexSize = 0;
+            m_bOrderByFailed = true;
+        }
+        ResetReading();
+        return;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Initialize panFIDIndex                                          */
 /* -------------------------------------------------------------------- */
@@ -2068,6 +2217,7 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
         FreeIndexFields( pasIndexFields, nIndexSize );
         VSIFree(panFIDList);
         nIndexSize = 0;
+        m_bOrderByFailed = true;
         return;
     }
     for( size_t i = 0; i < nIndexSize; i++ )
@@ -2086,6 +2236,7 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
         nIndexSize = 0;
         VSIFree(panFIDIndex);
         panFIDIndex = nullptr;
+        m_bOrderByFailed = true;
         return;
     }
 
@@ -2123,173 +2274,1487 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
 }
 
 /************************************************************************/
-/*                          SortIndexSection()                          */
+/*                       CreateTopNOrderByIndex()                       */
 /*                                                                      */
-/*      Sort the records in a section of the index.                     */
+/*      Build the index for ORDER BY ... LIMIT, by keeping the          */
+/*      nTopN best records in a max-heap whose top is the worst         */
+/*      retained record.  Ties are broken on the reading order, so      */
+/*      that the result is the same as with a full (stable) sort.       */
 /************************************************************************/
 
-void OGRGenSQLResultsLayer::SortIndexSection( const OGRField *pasIndexFields,
-                                              GIntBig *panMerged,
-                                              size_t nStart, size_t nEntries )
+bool OGRGenSQLResultsLayer::CreateTopNOrderByIndex( GIntBig nTopN )
 
 {
-    if( nEntries < 2 )
-        return;
-
     swq_select *psSelectInfo = (swq_select *) pSelectInfo;
-    const int   nOrderItems = psSelectInfo->order_specs;
+    const int nOrderItems = psSelectInfo->order_specs;
 
-    size_t nFirstGroup = nEntries / 2;
-    size_t nFirstStart = nStart;
-    size_t nSecondGroup = nEntries - nFirstGroup;
-    size_t nSecondStart = nStart + nFirstGroup;
+    panFIDIndex = nullptr;
+    nIndexSize = 0;
 
-    SortIndexSection( pasIndexFields, panMerged, nFirstStart,
-                      nFirstGroup );
-    SortIndexSection( pasIndexFields, panMerged, nSecondStart,
-                      nSecondGroup );
+    // One extra slot is used as scratch space for the candidate record.
+    const size_t nSlots = static_cast<size_t>(nTopN) + 1;
+    OGRField *pasIndexFields = static_cast<OGRField *>(
+        VSI_CALLOC_VERBOSE(sizeof(OGRField) * nOrderItems, nSlots));
+    if( pasIndexFields == nullptr )
+        return false;
+
+    std::vector<GIntBig> anFIDs;
+    std::vector<GIntBig> anSeq;
+    std::vector<size_t> anHeap;
+    try
+    {
+        anFIDs.resize(nSlots);
+        anSeq.resize(nSlots);
+        anHeap.reserve(nSlots);
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate ORDER BY index");
+        VSIFree(pasIndexFields);
+        return false;
+    }
 
-    for( size_t iMerge = 0; iMerge < nEntries; ++iMerge )
+    const auto lessThan = [this, pasIndexFields, nOrderItems, &anSeq]
+                                                    (size_t a, size_t b)
     {
-        int  nResult = 0;
+        const int nResult = Compare( pasIndexFields + a * nOrderItems,
+                                     pasIndexFields + b * nOrderItems );
+        if( nResult != 0 )
+            return nResult < 0;
+        return anSeq[a] < anSeq[b];
+    };
+
+    const size_t nMaxHeapSize = static_cast<size_t>(nTopN);
+    size_t iScratch = nMaxHeapSize;
+    GIntBig nSeq = 0;
+    OGRFeature *poSrcFeat = nullptr;
+    while( (poSrcFeat = poSrcLayer->GetNextFeature()) != nullptr )
+    {
+        const bool bFull = anHeap.size() == nMaxHeapSize;
+        const size_t iSlot = bFull ? iScratch : anHeap.size();
+        OGRField *pasCurFields = pasIndexFields + iSlot * nOrderItems;
+        ReadIndexFields( poSrcFeat, nOrderItems, pasCurFields );
+        anFIDs[iSlot] = poSrcFeat->GetFID();
+        anSeq[iSlot] = nSeq++;
+        delete poSrcFeat;
 
-        if( nFirstGroup == 0 )
-            nResult = 1;
-        else if( nSecondGroup == 0 )
-            nResult = -1;
+        if( !bFull )
+        {
+            anHeap.push_back(iSlot);
+            std::push_heap(anHeap.begin(), anHeap.end(), lessThan);
+        }
+        else if( lessThan(iSlot, anHeap.front()) )
+        {
+            // Evict the worst retained record, and recycle its slot
+            // as the new scratch slot.
+            std::pop_heap(anHeap.begin(), anHeap.end(), lessThan);
+            iScratch = anHeap.back();
+            anHeap.back() = iSlot;
+            std::push_heap(anHeap.begin(), anHeap.end(), lessThan);
+
+            OGRField *pasEvicted = pasIndexFields + iScratch * nOrderItems;
+            FreeIndexFields( pasEvicted, 1, false );
+            memset( pasEvicted, 0, sizeof(OGRField) * nOrderItems );
+        }
         else
-            nResult = Compare( pasIndexFields
-                               + panFIDIndex[nFirstStart] * nOrderItems,
-                               pasIndexFields
-                               + panFIDIndex[nSecondStart] * nOrderItems );
+        {
+            FreeIndexFields( pasCurFields, 1, false );
+            memset( pasCurFields, 0, sizeof(OGRField) * nOrderItems );
+        }
+    }
 
-        if( nResult > 0 )
+    std::sort_heap(anHeap.begin(), anHeap.end(), lessThan);
+
+    bool bRet = true;
+    if( !anHeap.empty() )
+    {
+        panFIDIndex = static_cast<GIntBig *>(
+            VSI_MALLOC_VERBOSE(sizeof(GIntBig) * anHeap.size()));
+        if( panFIDIndex == nullptr )
         {
-            panMerged[iMerge] = panFIDIndex[nSecondStart];
-            nSecondStart++;
-            nSecondGroup--;
+            bRet = false;
         }
         else
         {
-            panMerged[iMerge] = panFIDIndex[nFirstStart];
-            nFirstStart++;
-            nFirstGroup--;
+            for( size_t i = 0; i < anHeap.size(); i++ )
+                panFIDIndex[i] = anFIDs[anHeap[i]];
+            nIndexSize = anHeap.size();
         }
     }
 
-    /* Copy the merge list back into the main index */
-    memcpy( panFIDIndex + nStart, panMerged, sizeof(GIntBig) * nEntries );
+    FreeIndexFields( pasIndexFields, nSlots );
+    return bRet;
 }
 
 /************************************************************************/
-/*                           ComparePrimitive()                         */
+/*                          IsStringOrderKey()                          */
 /************************************************************************/
 
-template<class T> static inline int ComparePrimitive(const T& a, const T& b)
+bool OGRGenSQLResultsLayer::IsStringOrderKey( int iKey )
+
 {
-    if( a < b )
-        return -1;
-    if( a > b )
-        return 1;
-    return 0;
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    const swq_order_def *psKeyDef = psSelectInfo->order_defs + iKey;
+
+    if( psKeyDef->field_index >= iFIDFieldIndex )
+        return SpecialFieldTypes[psKeyDef->field_index - iFIDFieldIndex] ==
+                                                                SWQ_STRING;
+
+    return poSrcLayer->GetLayerDefn()->GetFieldDefn(
+                            psKeyDef->field_index )->GetType() == OFTString;
 }
 
 /************************************************************************/
-/*                              Compare()                               */
+/*                         GetIndexFieldsSize()                         */
+/*                                                                      */
+/*      Return the approximate memory used by one record of the         */
+/*      ORDER BY index.                                                 */
 /************************************************************************/
 
-int OGRGenSQLResultsLayer::Compare( const OGRField *pasFirstTuple,
-                                    const OGRField *pasSecondTuple )
+size_t OGRGenSQLResultsLayer::GetIndexFieldsSize(
+                                            const OGRField *pasIndexFields,
+                                            int nOrderItems )
+
+{
+    size_t nSize = sizeof(OGRField) * nOrderItems + sizeof(GIntBig);
+    for( int iKey = 0; iKey < nOrderItems; iKey++ )
+    {
+        const OGRField *psField = pasIndexFields + iKey;
+        if( IsStringOrderKey(iKey) &&
+            !OGR_RawField_IsUnset(psField) &&
+            !OGR_RawField_IsNull(psField) )
+        {
+            nSize += strlen(psField->String) + 1;
+        }
+    }
+    return nSize;
+}
+
+/************************************************************************/
+/*                          WriteIndexRecord()                          */
+/*                                                                      */
+/*      Serialize a FID and its ORDER BY key values in a run file.      */
+/*      Runs are only read back by the same process, so non-string      */
+/*      values are written in their native in-memory representation.   */
+/************************************************************************/
+
+bool OGRGenSQLResultsLayer::WriteIndexRecord( VSILFILE *fp,
+                                              const OGRField *pasIndexFields,
+                                              GIntBig nFID )
 
 {
     swq_select *psSelectInfo = (swq_select *) pSelectInfo;
-    int  nResult = 0, iKey;
+    const int nOrderItems = psSelectInfo->order_specs;
 
-    for( iKey = 0; nResult == 0 && iKey < psSelectInfo->order_specs; iKey++ )
+    bool bOK = VSIFWriteL( &nFID, sizeof(nFID), 1, fp ) == 1;
+    for( int iKey = 0; bOK && iKey < nOrderItems; iKey++ )
     {
-        swq_order_def *psKeyDef = psSelectInfo->order_defs + iKey;
-        OGRFieldDefn *poFDefn = nullptr;
-
-        if( psKeyDef->field_index >= iFIDFieldIndex )
-            poFDefn = nullptr;
+        const OGRField *psField = pasIndexFields + iKey;
+        if( IsStringOrderKey(iKey) &&
+            !OGR_RawField_IsUnset(psField) &&
+            !OGR_RawField_IsNull(psField) )
+        {
+            const GByte byIsString = 1;
+            const GUInt32 nLen = static_cast<GUInt32>(strlen(psField->String));
+            bOK = VSIFWriteL( &byIsString, 1, 1, fp ) == 1 &&
+                  VSIFWriteL( &nLen, sizeof(nLen), 1, fp ) == 1 &&
+                  VSIFWriteL( psField->String, 1, nLen, fp ) == nLen;
+        }
         else
-            poFDefn = poSrcLayer->GetLayerDefn()->GetFieldDefn(
-                psKeyDef->field_index );
-
-        if( OGR_RawField_IsUnset(&pasFirstTuple[iKey]) ||
-            OGR_RawField_IsNull(&pasFirstTuple[iKey]) )
         {
-            if( OGR_RawField_IsUnset(&pasSecondTuple[iKey]) ||
-                OGR_RawField_IsNull(&pasSecondTuple[iKey]) )
-                nResult = 0;
-            else
-                nResult = -1;
+            const GByte byIsString = 0;
+            bOK = VSIFWriteL( &byIsString, 1, 1, fp ) == 1 &&
+                  VSIFWriteL( psField, sizeof(OGRField), 1, fp ) == 1;
+        }
+    }
+    if( !bOK )
+    {
+        CPLError(CE_Failure, CPLE_FileIO,
+                 "Cannot write temporary file for ORDER BY");
+    }
+    return bOK;
+}
+
+/************************************************************************/
+/*                          ReadIndexRecord()                           */
+/*                                                                      */
+/*      Read back a record written by WriteIndexRecord().  Returns      */
+/*      false at end of file or on error, in which case *pbError is     */
+/*      set.                                                            */
+/************************************************************************/
+
+bool OGRGenSQLResultsLayer::ReadIndexRecord( VSILFILE *fp,
+                                             OGRField *pasIndexFields,
+                                             GIntBig *pnFID,
+                                             bool *pbError )
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    const int nOrderItems = psSelectInfo->order_specs;
+
+    if( VSIFReadL( pnFID, sizeof(GIntBig), 1, fp ) != 1 )
+        return false;
+
+    for( int iKey = 0; iKey < nOrderItems; iKey++ )
+    {
+        OGRField *psField = pasIndexFields + iKey;
+        GByte byIsString = 0;
+        bool bOK = VSIFReadL( &byIsString, 1, 1, fp ) == 1;
+        if( bOK && byIsString )
+        {
+            GUInt32 nLen = 0;
+            bOK = VSIFReadL( &nLen, sizeof(nLen), 1, fp ) == 1;
+            char *pszStr = bOK ?
+                static_cast<char *>(VSI_MALLOC_VERBOSE(nLen + 1)) : nullptr;
+            if( pszStr != nullptr &&
+                VSIFReadL( pszStr, 1, nLen, fp ) == nLen )
+            {
+                pszStr[nLen] = '\0';
+                psField->String = pszStr;
+            }
+            else
+            {
+                VSIFree( pszStr );
+                bOK = false;
+            }
+        }
+        else if( bOK )
+        {
+            bOK = VSIFReadL( psField, sizeof(OGRField), 1, fp ) == 1;
+        }
+
+        if( !bOK )
+        {
+            CPLError(CE_Failure, CPLE_FileIO,
+                     "Cannot read temporary file for ORDER BY");
+            *pbError = true;
+            // Do not try to free a partially read value.
+            memset( psField, 0, sizeof(OGRField) );
+            FreeIndexFields( pasIndexFields, 1, false );
+            memset( pasIndexFields, 0, sizeof(OGRField) * nOrderItems );
+            return false;
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                           WriteSortedRun()                           */
+/*                                                                      */
+/*      Sort the nIndexSize records currently in memory and write       */
+/*      them in a new temporary run file.                               */
+/************************************************************************/
+
+bool OGRGenSQLResultsLayer::WriteSortedRun( OGRField *pasIndexFields,
+                                            const GIntBig *panFIDList,
+                                            std::vector<CPLString>& aosRuns )
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    const int nOrderItems = psSelectInfo->order_specs;
+
+    panFIDIndex = (GIntBig *) VSI_MALLOC_VERBOSE(sizeof(GIntBig) * nIndexSize);
+    GIntBig *panMerged = (GIntBig *)
+        VSI_MALLOC_VERBOSE( sizeof(GIntBig) * nIndexSize );
+    if( panFIDIndex == nullptr || panMerged == nullptr )
+    {
+        VSIFree(panFIDIndex);
+        panFIDIndex = nullptr;
+        VSIFree(panMerged);
+        return false;
+    }
+    for( size_t i = 0; i < nIndexSize; i++ )
+        panFIDIndex[i] = static_cast<GIntBig>(i);
+
+    SortIndexSection( pasIndexFields, panMerged, 0, nIndexSize );
+    VSIFree( panMerged );
+
+    const CPLString osRunFilename(CPLGenerateTempFilename("ogr_sql_sort"));
+    VSILFILE *fp = VSIFOpenL( osRunFilename, "wb" );
+    bool bOK = fp != nullptr;
+    if( fp == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_FileIO,
+                 "Cannot create temporary file %s for ORDER BY",
+                 osRunFilename.c_str());
+    }
+    else
+    {
+        aosRuns.push_back(osRunFilename);
+        for( size_t i = 0; bOK && i < nIndexSize; i++ )
+        {
+            const size_t iRecord = static_cast<size_t>(panFIDIndex[i]);
+            bOK = WriteIndexRecord( fp,
+                                    pasIndexFields + iRecord * nOrderItems,
+                                    panFIDList[iRecord] );
+        }
+        if( VSIFCloseL( fp ) != 0 )
+            bOK = false;
+
+        CPLDebug("GenSQL", "ORDER BY: spilled run of " CPL_FRMT_GUIB
+                 " records to %s", static_cast<GUIntBig>(nIndexSize),
+                 osRunFilename.c_str());
+    }
+
+    VSIFree( panFIDIndex );
+    panFIDIndex = nullptr;
+    return bOK;
+}
+
+/************************************************************************/
+/*                          MergeSortedRuns()                           */
+/*                                                                      */
+/*      k-way merge of sorted run files into fpOut.  If bFIDOnly is     */
+/*      set, only the FIDs are written (final FID index), otherwise     */
+/*      full records are written (intermediate run).  Ties are          */
+/*      resolved on run order, which preserves the sort stability.      */
+/************************************************************************/
+
+bool OGRGenSQLResultsLayer::MergeSortedRuns(
+                                    const std::vector<CPLString>& aosRuns,
+                                    VSILFILE *fpOut, bool bFIDOnly,
+                                    GIntBig *pnMerged )
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    const int nOrderItems = psSelectInfo->order_specs;
+    const size_t nRuns = aosRuns.size();
+
+    std::vector<VSILFILE*> apoRunFiles(nRuns, nullptr);
+    std::vector<OGRField> asFields(nRuns * nOrderItems);
+    std::vector<GIntBig> anFIDs(nRuns);
+    std::vector<size_t> anHeap;
+
+    bool bOK = true;
+    bool bReadError = false;
+    for( size_t i = 0; i < nRuns; i++ )
+    {
+        apoRunFiles[i] = VSIFOpenL( aosRuns[i], "rb" );
+        if( apoRunFiles[i] == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_FileIO,
+                     "Cannot open temporary file %s for ORDER BY",
+                     aosRuns[i].c_str());
+            bOK = false;
+            break;
+        }
+        if( ReadIndexRecord( apoRunFiles[i], &asFields[i * nOrderItems],
+                             &anFIDs[i], &bReadError ) )
+        {
+            anHeap.push_back(i);
+        }
+    }
+
+    // Min-heap on the current record of each run.
+    const auto greaterThan = [this, &asFields, nOrderItems](size_t a,
+                                                            size_t b)
+    {
+        const int nResult = Compare( &asFields[a * nOrderItems],
+                                     &asFields[b * nOrderItems] );
+        if( nResult != 0 )
+            return nResult > 0;
+        return a > b;
+    };
+    std::make_heap(anHeap.begin(), anHeap.end(), greaterThan);
+
+    while( bOK && !anHeap.empty() )
+    {
+        std::pop_heap(anHeap.begin(), anHeap.end(), greaterThan);
+        const size_t iRun = anHeap.back();
+        anHeap.pop_back();
+
+        OGRField *pasRunFields = &asFields[iRun * nOrderItems];
+        if( bFIDOnly )
+        {
+            bOK = VSIFWriteL( &anFIDs[iRun], sizeof(GIntBig), 1, fpOut ) == 1;
+            if( !bOK )
+            {
+                CPLError(CE_Failure, CPLE_FileIO,
+                         "Cannot write temporary file for ORDER BY");
+            }
+        }
+        else
+        {
+            bOK = WriteIndexRecord( fpOut, pasRunFields, anFIDs[iRun] );
+        }
+        (*pnMerged)++;
+
+        FreeIndexFields( pasRunFields, 1, false );
+        memset( pasRunFields, 0, sizeof(OGRField) * nOrderItems );
+
+        if( bOK && ReadIndexRecord( apoRunFiles[iRun], pasRunFields,
+                                    &anFIDs[iRun], &bReadError ) )
+        {
+            anHeap.push_back(iRun);
+            std::push_heap(anHeap.begin(), anHeap.end(), greaterThan);
+        }
+    }
+
+    if( bReadError )
+        bOK = false;
+
+    for( size_t i = 0; i < nRuns; i++ )
+    {
+        FreeIndexFields( &asFields[i * nOrderItems], 1, false );
+        if( apoRunFiles[i] != nullptr )
+            VSIFCloseL( apoRunFiles[i] );
+    }
+
+    return bOK;
+}
+
+/************************************************************************/
+/*                     CreateExternalOrderByIndex()                     */
+/*                                                                      */
+/*      Merge the sorted runs into the on-disk FID index.  If there     */
+/*      are too many runs to be merged at once, they are first merged   */
+/*      by groups into larger runs.                                     */
+/************************************************************************/
+
+bool OGRGenSQLResultsLayer::CreateExternalOrderByIndex(
+                                        std::vector<CPLString>& aosRuns )
+
+{
+    const size_t nMaxMergedRuns = static_cast<size_t>(std::max(2, atoi(
+        CPLGetConfigOption("OGR_SQL_SORT_MAX_MERGED_RUNS", "64"))));
+
+    while( aosRuns.size() > nMaxMergedRuns )
+    {
+        std::vector<CPLString> aosNewRuns;
+        for( size_t i = 0; i < aosRuns.size(); i += nMaxMergedRuns )
+        {
+            const size_t nGroupSize =
+                std::min(nMaxMergedRuns, aosRuns.size() - i);
+            std::vector<CPLString> aosGroup(
+                aosRuns.begin() + i, aosRuns.begin() + i + nGroupSize );
+            if( nGroupSize == 1 )
+            {
+                aosNewRuns.push_back(aosGroup[0]);
+                continue;
+            }
+
+            const CPLString osRunFilename(
+                                CPLGenerateTempFilename("ogr_sql_sort"));
+            VSILFILE *fp = VSIFOpenL( osRunFilename, "wb" );
+            if( fp == nullptr )
+            {
+                CPLError(CE_Failure, CPLE_FileIO,
+                         "Cannot create temporary file %s for ORDER BY",
+                         osRunFilename.c_str());
+            }
+            GIntBig nMerged = 0;
+            bool bOK = fp != nullptr &&
+                       MergeSortedRuns( aosGroup, fp, false, &nMerged );
+            if( fp != nullptr && VSIFCloseL( fp ) != 0 )
+            {
+                CPLError(CE_Failure, CPLE_FileIO,
+                         "Cannot write temporary file %s for ORDER BY",
+                         osRunFilename.c_str());
+                bOK = false;
+            }
+            UnlinkSortRuns(aosGroup);
+            aosNewRuns.push_back(osRunFilename);
+            if( !bOK )
+            {
+                aosNewRuns.insert( aosNewRuns.end(),
+                                   aosRuns.begin() + i + nGroupSize,
+                                   aosRuns.end() );
+                aosRuns = aosNewRuns;
+                return false;
+            }
+        }
+        aosRuns = aosNewRuns;
+    }
+
+    osFIDIndexFilename = CPLGenerateTempFilename("ogr_sql_sort");
+    fpFIDIndex = VSIFOpenL( osFIDIndexFilename, "wb+" );
+    if( fpFIDIndex == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_FileIO,
+                 "Cannot create temporary file %s for ORDER BY",
+                 osFIDIndexFilename.c_str());
+        osFIDIndexFilename.clear();
+        return false;
+    }
+
+    GIntBig nMerged = 0;
+    if( !MergeSortedRuns( aosRuns, fpFIDIndex, true, &nMerged ) )
+    {
+        VSIFCloseL( fpFIDIndex );
+        fpFIDIndex = nullptr;
+        VSIUnlink( osFIDIndexFilename );
+        osFIDIndexFilename.clear();
+        return false;
+    }
+
+    nIndexSize = static_cast<size_t>(nMerged);
+    return true;
+}
+
+/************************************************************************/
+/*                          GetFIDFromIndex()                           */
+/************************************************************************/
+
+GIntBig OGRGenSQLResultsLayer::GetFIDFromIndex( GIntBig nIdx )
+
+{
+    if( panFIDIndex != nullptr )
+        return panFIDIndex[nIdx];
+
+    GIntBig nFID = OGRNullFID;
+    if( VSIFSeekL( fpFIDIndex, static_cast<vsi_l_offset>(nIdx) *
+                                                sizeof(GIntBig), SEEK_SET ) != 0 ||
+        VSIFReadL( &nFID, sizeof(GIntBig), 1, fpFIDIndex ) != 1 )
+    {
+        CPLError(CE_Failure, CPLE_FileIO,
+                 "Cannot read temporary file for ORDER BY");
+        return OGRNullFID;
+    }
+    return nFID;
+}
+
+/************************************************************************/
+/*                          SortIndexSection()                          */
+/*                                                                      */
+/*      Sort the records in a section of the index.                     */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::SortIndexSection( const OGRField *pasIndexFields,
+                                              GIntBig *panMerged,
+                                              size_t nStart, size_t nEntries )
+
+{
+    if( nEntries < 2 )
+        return;
+
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    const int   nOrderItems = psSelectInfo->order_specs;
+
+    size_t nFirstGroup = nEntries / 2;
+    size_t nFirstStart = nStart;
+    size_t nSecondGroup = nEntries - nFirstGroup;
+    size_t nSecondStart = nStart + nFirstGroup;
+
+    SortIndexSection( pasIndexFields, panMerged, nFirstStart,
+                      nFirstGroup );
+    SortIndexSection( pasIndexFields, panMerged, nSecondStart,
+                      nSecondGroup );
+
+    for( size_t iMerge = 0; iMerge < nEntries; ++iMerge )
+    {
+        int  nResult = 0;
+
+        if( nFirstGroup == 0 )
+            nResult = 1;
+        else if( nSecondGroup == 0 )
+            nResult = -1;
+        else
+            nResult = Compare( pasIndexFields
+                               + panFIDIndex[nFirstStart] * nOrderItems,
+                               pasIndexFields
+                               + panFIDIndex[nSecondStart] * nOrderItems );
+
+        if( nResult > 0 )
+        {
+            panMerged[iMerge] = panFIDIndex[nSecondStart];
+            nSecondStart++;
+            nSecondGroup--;
+        }
+        else
+        {
+            panMerged[iMerge] = panFIDIndex[nFirstStart];
+            nFirstStart++;
+            nFirstGroup--;
+        }
+    }
+
+    /* Copy the merge list back into the main index */
+    memcpy( panFIDIndex + nStart, panMerged, sizeof(GIntBig) * nEntries );
+}
+
+/************************************************************************/
+/*                           ComparePrimitive()                         */
+/************************************************************************/
+
+template<class T> static inline int ComparePrimitive(const T& a, const T& b)
+{
+    if( a < b )
+        return -1;
+    if( a > b )
+        return 1;
+    return 0;
+}
+
+/************************************************************************/
+/*                              Compare()                               */
+/************************************************************************/
+
+int OGRGenSQLResultsLayer::Compare( const OGRField *pasFirstTuple,
+                                    const OGRField *pasSecondTuple )
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    int  nResult = 0, iKey;
+
+    for( iKey = 0; nResult == 0 && iKey < psSelectInfo->order_specs; iKey++ )
+    {
+        swq_order_def *psKeyDef = psSelectInfo->order_defs + iKey;
+        OGRFieldDefn *poFDefn = nullptr;
+
+        if( psKeyDef->field_index >= iFIDFieldIndex )
+            poFDefn = nullptr;
+        else
+            poFDefn = poSrcLayer->GetLayerDefn()->GetFieldDefn(
+                psKeyDef->field_index );
+
+        if( OGR_RawField_IsUnset(&pasFirstTuple[iKey]) ||
+            OGR_RawField_IsNull(&pasFirstTuple[iKey]) )
+        {
+            if( OGR_RawField_IsUnset(&pasSecondTuple[iKey]) ||
+                OGR_RawField_IsNull(&pasSecondTuple[iKey]) )
+                nResult = 0;
+            else
+                nResult = -1;
         }
         else if ( OGR_RawField_IsUnset(&pasSecondTuple[iKey]) ||
                   OGR_RawField_IsNull(&pasSecondTuple[iKey]) )
         {
-            nResult = 1;
+            nResult = 1;
+        }
+        else if ( poFDefn == nullptr )
+        {
+            CPLAssert( psKeyDef->field_index <
+                                    iFIDFieldIndex + SPECIAL_FIELD_COUNT );
+            switch (SpecialFieldTypes[psKeyDef->field_index - iFIDFieldIndex])
+            {
+              case SWQ_INTEGER:
+                  // Yes, read Integer in Integer64.
+                  // This is consistent with what is done ReadIndexFields()
+              case SWQ_INTEGER64:
+                nResult = ComparePrimitive( pasFirstTuple[iKey].Integer64,
+                                            pasSecondTuple[iKey].Integer64 );
+                break;
+              case SWQ_FLOAT:
+                nResult = ComparePrimitive( pasFirstTuple[iKey].Real,
+                                            pasSecondTuple[iKey].Real );
+                break;
+              case SWQ_STRING:
+                nResult = strcmp(pasFirstTuple[iKey].String,
+                                 pasSecondTuple[iKey].String);
+                break;
+
+              default:
+                CPLAssert( false );
+                nResult = 0;
+            }
+        }
+        else if( poFDefn->GetType() == OFTInteger )
+        {
+            nResult = ComparePrimitive( pasFirstTuple[iKey].Integer,
+                                        pasSecondTuple[iKey].Integer );
+        }
+        else if( poFDefn->GetType() == OFTInteger64 )
+        {
+            nResult = ComparePrimitive( pasFirstTuple[iKey].Integer64,
+                                        pasSecondTuple[iKey].Integer64 );
+        }
+        else if( poFDefn->GetType() == OFTString )
+        {
+            nResult = strcmp(pasFirstTuple[iKey].String,
+                             pasSecondTuple[iKey].String);
+        }
+        else if( poFDefn->GetType() == OFTReal )
+        {
+            nResult = ComparePrimitive( pasFirstTuple[iKey].Real,
+                                        pasSecondTuple[iKey].Real );
+        }
+        else if( poFDefn->GetType() == OFTDate ||
+                 poFDefn->GetType() == OFTTime ||
+                 poFDefn->GetType() == OFTDateTime)
+        {
+            nResult = OGRCompareDate(&pasFirstTuple[iKey],
+                                     &pasSecondTuple[iKey]);
+        }
+
+        if( !(psKeyDef->ascending_flag) )
+            nResult *= -1;
+    }
+
+    return nResult;
+}
+
+/************************************************************************/
+/*                         OGRGenSQLGroupTable                          */
+/*                                                                      */
+/*      Hash table of the groups of a GROUP BY query.  Each group       */
+/*      holds a result feature with its grouping columns set, and       */
+/*      the running summaries of its aggregate columns.  Groups are     */
+/*      kept in the order in which they are first met.                  */
+/************************************************************************/
+
+class OGRGenSQLGroupTable
+{
+    swq_select     *psSelectInfo;
+    OGRFeatureDefn *poDefn;
+
+    std::unordered_map<std::string, size_t> oMapKeyToGroup;
+    std::vector<const std::string*> apsKeys;
+    std::string     osKey;
+
+    void            AppendKeyString( const char *pszValue );
+    void            AppendKeyValue( OGRFeature *poSrcFeature, int iField );
+    OGRFeature     *CreateGroupFeature( OGRFeature *poSrcFeature );
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRGenSQLGroupTable)
+
+  public:
+    std::vector<OGRFeature*> apoFeatures;
+    std::vector<std::vector<swq_summary> > aoSummaries;
+
+                    OGRGenSQLGroupTable( swq_select *psSelectInfoIn,
+                                         OGRFeatureDefn *poDefnIn ) :
+                        psSelectInfo(psSelectInfoIn), poDefn(poDefnIn) {}
+                   ~OGRGenSQLGroupTable();
+
+    const char     *Accumulate( OGRFeature *poSrcFeature );
+    bool            Merge( OGRGenSQLGroupTable& oOther );
+    void            Swap( OGRGenSQLGroupTable& oOther );
+    void            Finalize();
+};
+
+/************************************************************************/
+/*                        ~OGRGenSQLGroupTable()                        */
+/************************************************************************/
+
+OGRGenSQLGroupTable::~OGRGenSQLGroupTable()
+{
+    for( size_t i = 0; i < apoFeatures.size(); i++ )
+        delete apoFeatures[i];
+}
+
+/************************************************************************/
+/*                          AppendKeyString()                           */
+/************************************************************************/
+
+void OGRGenSQLGroupTable::AppendKeyString( const char *pszValue )
+{
+    const GUInt32 nLen = static_cast<GUInt32>(strlen(pszValue));
+    osKey.append( reinterpret_cast<const char*>(&nLen), sizeof(nLen) );
+    osKey.append( pszValue, nLen );
+}
+
+/************************************************************************/
+/*                           AppendKeyValue()                           */
+/*                                                                      */
+/*      Append the binary representation of a grouping value to the    */
+/*      key being built.                                                */
+/************************************************************************/
+
+void OGRGenSQLGroupTable::AppendKeyValue( OGRFeature *poSrcFeature,
+                                          int iField )
+{
+    OGRFeatureDefn *poSrcDefn = poSrcFeature->GetDefnRef();
+    if( iField >= poSrcDefn->GetFieldCount() )
+    {
+        // Special field.
+        AppendKeyString( poSrcFeature->GetFieldAsString(iField) );
+        return;
+    }
+
+    if( !poSrcFeature->IsFieldSetAndNotNull(iField) )
+    {
+        osKey += '\0';
+        return;
+    }
+    osKey += '\1';
+
+    const OGRField *psField = poSrcFeature->GetRawFieldRef(iField);
+    switch( poSrcDefn->GetFieldDefn(iField)->GetType() )
+    {
+      case OFTInteger:
+        osKey.append( reinterpret_cast<const char*>(&psField->Integer),
+                      sizeof(psField->Integer) );
+        break;
+
+      case OFTInteger64:
+        osKey.append( reinterpret_cast<const char*>(&psField->Integer64),
+                      sizeof(psField->Integer64) );
+        break;
+
+      case OFTReal:
+      {
+        // Make -0.0 and 0.0 fall in the same group.
+        const double dfVal = psField->Real == 0.0 ? 0.0 : psField->Real;
+        osKey.append( reinterpret_cast<const char*>(&dfVal),
+                      sizeof(dfVal) );
+        break;
+      }
+
+      case OFTDate:
+      case OFTTime:
+      case OFTDateTime:
+      {
+        GByte abyDate[2 + 5 + sizeof(float)];
+        memcpy( abyDate, &psField->Date.Year, 2 );
+        abyDate[2] = psField->Date.Month;
+        abyDate[3] = psField->Date.Day;
+        abyDate[4] = psField->Date.Hour;
+        abyDate[5] = psField->Date.Minute;
+        abyDate[6] = psField->Date.TZFlag;
+        memcpy( abyDate + 7, &psField->Date.Second, sizeof(float) );
+        osKey.append( reinterpret_cast<const char*>(abyDate),
+                      sizeof(abyDate) );
+        break;
+      }
+
+      case OFTString:
+        AppendKeyString( psField->String );
+        break;
+
+      default:
+        AppendKeyString( poSrcFeature->GetFieldAsString(iField) );
+        break;
+    }
+}
+
+/************************************************************************/
+/*                         CreateGroupFeature()                         */
+/*                                                                      */
+/*      Create the result feature of a new group, and set its           */
+/*      grouping columns from the first source feature of the group.    */
+/************************************************************************/
+
+OGRFeature *OGRGenSQLGroupTable::CreateGroupFeature( OGRFeature *poSrcFeature )
+{
+    OGRFeature *poFeature = new OGRFeature( poDefn );
+    const int nSrcFieldCount = poSrcFeature->GetDefnRef()->GetFieldCount();
+
+    for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
+    {
+        swq_col_def *psColDef = psSelectInfo->column_defs + iField;
+        if( psColDef->col_func != SWQCF_NONE )
+            continue;
+
+        const int iSrcField = psColDef->field_index;
+        if( iSrcField < nSrcFieldCount )
+        {
+            if( poSrcFeature->IsFieldSetAndNotNull(iSrcField) )
+                poFeature->SetField( iField,
+                                     poSrcFeature->GetRawFieldRef(iSrcField) );
+            else
+                poFeature->SetFieldNull( iField );
+            continue;
+        }
+
+        switch( SpecialFieldTypes[iSrcField - nSrcFieldCount] )
+        {
+          case SWQ_INTEGER:
+          case SWQ_INTEGER64:
+            poFeature->SetField( iField,
+                        poSrcFeature->GetFieldAsInteger64(iSrcField) );
+            break;
+          case SWQ_FLOAT:
+            poFeature->SetField( iField,
+                        poSrcFeature->GetFieldAsDouble(iSrcField) );
+            break;
+          default:
+            poFeature->SetField( iField,
+                        poSrcFeature->GetFieldAsString(iSrcField) );
+            break;
+        }
+    }
+
+    return poFeature;
+}
+
+/************************************************************************/
+/*                             Accumulate()                             */
+/*                                                                      */
+/*      Find (or create) the group of a source feature, and add its     */
+/*      values to the summaries of this group.                          */
+/************************************************************************/
+
+const char *OGRGenSQLGroupTable::Accumulate( OGRFeature *poSrcFeature )
+{
+    osKey.clear();
+    for( int iGroup = 0; iGroup < psSelectInfo->group_specs; iGroup++ )
+        AppendKeyValue( poSrcFeature,
+                        psSelectInfo->group_defs[iGroup].field_index );
+
+    size_t nGroupIdx = 0;
+    std::unordered_map<std::string, size_t>::const_iterator oIter =
+        oMapKeyToGroup.find( osKey );
+    if( oIter == oMapKeyToGroup.end() )
+    {
+        try
+        {
+            nGroupIdx = apoFeatures.size();
+            apsKeys.push_back(
+                &(oMapKeyToGroup.insert(
+                    std::pair<std::string, size_t>(osKey, nGroupIdx)).first->first) );
+            aoSummaries.push_back( std::vector<swq_summary>() );
+            swq_select_init_summary( psSelectInfo, aoSummaries.back() );
+            apoFeatures.push_back( CreateGroupFeature( poSrcFeature ) );
         }
-        else if ( poFDefn == nullptr )
+        catch( std::bad_alloc& )
         {
-            CPLAssert( psKeyDef->field_index <
-                                    iFIDFieldIndex + SPECIAL_FIELD_COUNT );
-            switch (SpecialFieldTypes[psKeyDef->field_index - iFIDFieldIndex])
+            return "Out of memory";
+        }
+    }
+    else
+    {
+        nGroupIdx = oIter->second;
+    }
+
+    std::vector<swq_summary>& aoSummary = aoSummaries[nGroupIdx];
+    OGRFeatureDefn *poSrcDefn = poSrcFeature->GetDefnRef();
+
+    for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
+    {
+        swq_col_def *psColDef = psSelectInfo->column_defs + iField;
+        if( psColDef->col_func == SWQCF_NONE )
+            continue;
+
+        const int iSrcField = psColDef->field_index;
+        const char *pszError = nullptr;
+
+        if( psColDef->col_func == SWQCF_COUNT )
+        {
+            /* psColDef->field_index can be -1 in the case of a COUNT(*) */
+            if( iSrcField < 0 )
+                aoSummary[iField].count++;
+            else if( IS_GEOM_FIELD_INDEX(poSrcDefn, iSrcField) )
             {
-              case SWQ_INTEGER:
-                  // Yes, read Integer in Integer64.
-                  // This is consistent with what is done ReadIndexFields()
-              case SWQ_INTEGER64:
-                nResult = ComparePrimitive( pasFirstTuple[iKey].Integer64,
-                                            pasSecondTuple[iKey].Integer64 );
-                break;
-              case SWQ_FLOAT:
-                nResult = ComparePrimitive( pasFirstTuple[iKey].Real,
-                                            pasSecondTuple[iKey].Real );
-                break;
-              case SWQ_STRING:
-                nResult = strcmp(pasFirstTuple[iKey].String,
-                                 pasSecondTuple[iKey].String);
-                break;
+                if( poSrcFeature->GetGeomFieldRef(
+                        ALL_FIELD_INDEX_TO_GEOM_FIELD_INDEX(
+                            poSrcDefn, iSrcField)) != nullptr )
+                {
+                    pszError = swq_select_summarize( psSelectInfo, aoSummary,
+                                                     iField, "" );
+                }
+            }
+            else if( poSrcFeature->IsFieldSetAndNotNull(iSrcField) )
+            {
+                if( psColDef->distinct_flag )
+                    pszError = swq_select_summarize( psSelectInfo, aoSummary,
+                                    iField,
+                                    poSrcFeature->GetFieldAsString(iSrcField) );
+                else
+                    aoSummary[iField].count++;
+            }
+        }
+        else if( iSrcField < poSrcDefn->GetFieldCount() &&
+                 (poSrcDefn->GetFieldDefn(iSrcField)->GetType() ==
+                                                            OFTInteger ||
+                  poSrcDefn->GetFieldDefn(iSrcField)->GetType() ==
+                                                            OFTInteger64 ||
+                  poSrcDefn->GetFieldDefn(iSrcField)->GetType() == OFTReal) )
+        {
+            // Numeric fields are accumulated directly, without going
+            // through their string representation.
+            if( poSrcFeature->IsFieldSetAndNotNull(iSrcField) )
+            {
+                const double dfVal =
+                    poSrcFeature->GetFieldAsDouble(iSrcField);
+                swq_summary& oSummary = aoSummary[iField];
+                oSummary.count++;
+                oSummary.sum += dfVal;
+                if( dfVal < oSummary.min )
+                    oSummary.min = dfVal;
+                if( dfVal > oSummary.max )
+                    oSummary.max = dfVal;
+            }
+        }
+        else
+        {
+            const char* pszVal = nullptr;
+            if( poSrcFeature->IsFieldSetAndNotNull(iSrcField) )
+                pszVal = poSrcFeature->GetFieldAsString(iSrcField);
+            pszError = swq_select_summarize( psSelectInfo, aoSummary,
+                                             iField, pszVal );
+        }
 
-              default:
-                CPLAssert( false );
-                nResult = 0;
+        if( pszError != nullptr )
+            return pszError;
+    }
+
+    return nullptr;
+}
+
+/************************************************************************/
+/*                               Merge()                                */
+/*                                                                      */
+/*      Merge the groups of another table, built over records that      */
+/*      come after ours, into this one.  The other table is emptied.    */
+/************************************************************************/
+
+bool OGRGenSQLGroupTable::Merge( OGRGenSQLGroupTable& oOther )
+{
+    try
+    {
+        for( size_t i = 0; i < oOther.apoFeatures.size(); i++ )
+        {
+            const std::string& osOtherKey = *(oOther.apsKeys[i]);
+            std::unordered_map<std::string, size_t>::const_iterator oIter =
+                oMapKeyToGroup.find( osOtherKey );
+            if( oIter == oMapKeyToGroup.end() )
+            {
+                const size_t nGroupIdx = apoFeatures.size();
+                apsKeys.push_back(
+                    &(oMapKeyToGroup.insert(
+                        std::pair<std::string, size_t>(osOtherKey,
+                                                       nGroupIdx)).first->first) );
+                aoSummaries.push_back( std::vector<swq_summary>() );
+                aoSummaries.back().swap( oOther.aoSummaries[i] );
+                apoFeatures.push_back( oOther.apoFeatures[i] );
+            }
+            else
+            {
+                std::vector<swq_summary>& aoSummary =
+                    aoSummaries[oIter->second];
+                for( int iField = 0; iField < psSelectInfo->result_columns;
+                     iField++ )
+                {
+                    swq_summary_merge( aoSummary[iField],
+                                       oOther.aoSummaries[i][iField],
+                                       psSelectInfo->column_defs + iField );
+                }
+                delete oOther.apoFeatures[i];
             }
+            oOther.apoFeatures[i] = nullptr;
         }
-        else if( poFDefn->GetType() == OFTInteger )
+    }
+    catch( std::bad_alloc& )
+    {
+        CPLError( CE_Failure, CPLE_OutOfMemory, "Out of memory" );
+        return false;
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                                Swap()                                */
+/************************************************************************/
+
+void OGRGenSQLGroupTable::Swap( OGRGenSQLGroupTable& oOther )
+{
+    // apsKeys point into the nodes of oMapKeyToGroup, which are not
+    // moved by the swap.
+    oMapKeyToGroup.swap( oOther.oMapKeyToGroup );
+    apsKeys.swap( oOther.apsKeys );
+    apoFeatures.swap( oOther.apoFeatures );
+    aoSummaries.swap( oOther.aoSummaries );
+}
+
+/************************************************************************/
+/*                              Finalize()                              */
+/*                                                                      */
+/*      Set the aggregate columns of the group features from their      */
+/*      summaries.                                                      */
+/************************************************************************/
+
+void OGRGenSQLGroupTable::Finalize()
+{
+    for( size_t i = 0; i < apoFeatures.size(); i++ )
+    {
+        for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
         {
-            nResult = ComparePrimitive( pasFirstTuple[iKey].Integer,
-                                        pasSecondTuple[iKey].Integer );
+            swq_col_def *psColDef = psSelectInfo->column_defs + iField;
+            if( psColDef->col_func != SWQCF_NONE )
+                SetSummaryFieldValue( apoFeatures[i], iField, psColDef,
+                                      aoSummaries[i][iField] );
         }
-        else if( poFDefn->GetType() == OFTInteger64 )
+    }
+    aoSummaries.clear();
+}
+
+/************************************************************************/
+/*                         OGRGenSQLGroupByJob                          */
+/************************************************************************/
+
+typedef struct
+{
+    swq_select          *psSelectInfo;
+    CPLString            osFilename;
+    CPLString            osDriverName;
+    char               **papszOpenOptions;
+    CPLString            osLayerName;
+    int                  nFieldCount;
+    const char          *pszWHERE;
+    char               **papszIgnoredFields;
+    GIntBig              nStart;
+    GIntBig              nEnd;
+    GIntBig              nTotal;
+    OGRGenSQLGroupTable *poGroups;
+    bool                 bSuccess;
+} OGRGenSQLGroupByJob;
+
+/************************************************************************/
+/*                       OGRGenSQLGroupByWorker()                       */
+/*                                                                      */
+/*      Aggregate one partition of the source layer, on a dataset       */
+/*      handle of its own.  A partition covers the features read        */
+/*      from index nStart, up to the feature found at index nEnd,       */
+/*      identified by its FID.                                          */
+/************************************************************************/
+
+static void OGRGenSQLGroupByWorker( void *pData )
+{
+    OGRGenSQLGroupByJob *psJob = static_cast<OGRGenSQLGroupByJob*>(pData);
+
+    const char* const apszAllowedDrivers[] = { psJob->osDriverName.c_str(),
+                                               nullptr };
+    GDALDataset *poDS = static_cast<GDALDataset*>(
+        GDALOpenEx( psJob->osFilename, GDAL_OF_VECTOR,
+                    apszAllowedDrivers, psJob->papszOpenOptions, nullptr ));
+    if( poDS == nullptr )
+        return;
+
+    OGRLayer *poLayer = poDS->GetLayerByName( psJob->osLayerName );
+    OGRFeatureQuery oQuery;
+    if( poLayer == nullptr ||
+        !poLayer->TestCapability(OLCFastSetNextByIndex) ||
+        poLayer->GetLayerDefn()->GetFieldCount() != psJob->nFieldCount )
+    {
+        GDALClose( poDS );
+        return;
+    }
+
+    poLayer->SetIgnoredFields(
+        const_cast<const char**>(psJob->papszIgnoredFields) );
+    if( psJob->pszWHERE != nullptr &&
+        oQuery.Compile( poLayer, psJob->pszWHERE ) != OGRERR_NONE )
+    {
+        GDALClose( poDS );
+        return;
+    }
+
+    // Find the first feature of the next partition, where to stop.
+    GIntBig nStopFID = OGRNullFID;
+    bool bOK = true;
+    if( psJob->nEnd < psJob->nTotal )
+    {
+        if( poLayer->SetNextByIndex( psJob->nEnd ) != OGRERR_NONE )
+            bOK = false;
+        else
         {
-            nResult = ComparePrimitive( pasFirstTuple[iKey].Integer64,
-                                        pasSecondTuple[iKey].Integer64 );
+            OGRFeature *poFeature = poLayer->GetNextFeature();
+            if( poFeature != nullptr )
+            {
+                nStopFID = poFeature->GetFID();
+                bOK = nStopFID != OGRNullFID;
+                delete poFeature;
+            }
         }
-        else if( poFDefn->GetType() == OFTString )
+    }
+
+    if( bOK && poLayer->SetNextByIndex( psJob->nStart ) != OGRERR_NONE )
+        bOK = false;
+
+    OGRFeature *poFeature = nullptr;
+    while( bOK && (poFeature = poLayer->GetNextFeature()) != nullptr )
+    {
+        const GIntBig nFID = poFeature->GetFID();
+        if( nFID == OGRNullFID )
+            bOK = false;
+        else if( nFID == nStopFID )
         {
-            nResult = strcmp(pasFirstTuple[iKey].String,
-                             pasSecondTuple[iKey].String);
+            delete poFeature;
+            break;
         }
-        else if( poFDefn->GetType() == OFTReal )
+        else if( psJob->pszWHERE == nullptr || oQuery.Evaluate( poFeature ) )
         {
-            nResult = ComparePrimitive( pasFirstTuple[iKey].Real,
-                                        pasSecondTuple[iKey].Real );
+            const char *pszError = psJob->poGroups->Accumulate( poFeature );
+            if( pszError != nullptr )
+            {
+                CPLDebug( "GenSQL", "%s", pszError );
+                bOK = false;
+            }
         }
-        else if( poFDefn->GetType() == OFTDate ||
-                 poFDefn->GetType() == OFTTime ||
-                 poFDefn->GetType() == OFTDateTime)
+        delete poFeature;
+    }
+
+    GDALClose( poDS );
+    psJob->bSuccess = bOK;
+}
+
+/************************************************************************/
+/*                     AggregateGroupsInParallel()                      */
+/*                                                                      */
+/*      Split the scan of the source layer into contiguous              */
+/*      partitions, aggregated by OGR_SQL_NUM_THREADS threads, each     */
+/*      one on its own dataset handle.  Returns false if the source     */
+/*      cannot be partitioned or if the parallel scan fails, in which   */
+/*      case oGroups is left empty and the caller must do a sequential  */
+/*      scan.                                                           */
+/************************************************************************/
+
+bool OGRGenSQLResultsLayer::AggregateGroupsInParallel(
+                                            OGRGenSQLGroupTable& oGroups )
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+
+    const char *pszNumThreads =
+        CPLGetConfigOption( "OGR_SQL_NUM_THREADS", "1" );
+    int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+        CPLGetNumCPUs() : atoi(pszNumThreads);
+    if( nThreads <= 1 ||
+        psSelectInfo->join_count > 0 ||
+        psSelectInfo->table_defs[0].data_source != nullptr ||
+        m_poFilterGeom != nullptr ||
+        poSrcDS->GetAccess() != GA_ReadOnly ||
+        poSrcDS->GetDriver() == nullptr ||
+        poSrcDS->GetDescription()[0] == '\0' )
+    {
+        return false;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Partitions are ranges of the natural reading order of the       */
+/*      source layer, so it must be able to seek to a feature index     */
+/*      and to report its feature count quickly.                        */
+/* -------------------------------------------------------------------- */
+    poSrcLayer->SetAttributeFilter( nullptr );
+    poSrcLayer->SetSpatialFilter( nullptr );
+    if( !poSrcLayer->TestCapability(OLCFastSetNextByIndex) ||
+        !poSrcLayer->TestCapability(OLCFastFeatureCount) )
+    {
+        return false;
+    }
+
+    const GIntBig nTotal = poSrcLayer->GetFeatureCount( TRUE );
+    const GIntBig nMinFeaturesPerThread = std::max(static_cast<GIntBig>(1),
+        CPLAtoGIntBig(CPLGetConfigOption("OGR_SQL_PARALLEL_MIN_FEATURES",
+                                         "10000")));
+    nThreads = static_cast<int>(
+        std::min(static_cast<GIntBig>(nThreads),
+                 nTotal / nMinFeaturesPerThread));
+    if( nThreads <= 1 )
+        return false;
+
+/* -------------------------------------------------------------------- */
+/*      Workers ignore the same fields as the source layer.             */
+/* -------------------------------------------------------------------- */
+    OGRFeatureDefn *poSrcDefn = poSrcLayer->GetLayerDefn();
+    char **papszIgnoredFields = nullptr;
+    for( int iField = 0; iField < poSrcDefn->GetFieldCount(); iField++ )
+    {
+        OGRFieldDefn *poFDefn = poSrcDefn->GetFieldDefn(iField);
+        if( poFDefn->IsIgnored() )
+            papszIgnoredFields =
+                CSLAddString( papszIgnoredFields, poFDefn->GetNameRef() );
+    }
+    if( !MustReadSourceGeometry() )
+        papszIgnoredFields =
+            CSLAddString( papszIgnoredFields, "OGR_GEOMETRY" );
+
+    std::vector<OGRGenSQLGroupByJob> asJobs(nThreads);
+    std::vector<void*> apJobs;
+    for( int i = 0; i < nThreads; i++ )
+    {
+        OGRGenSQLGroupByJob& sJob = asJobs[i];
+        sJob.psSelectInfo = psSelectInfo;
+        sJob.osFilename = poSrcDS->GetDescription();
+        sJob.osDriverName = poSrcDS->GetDriver()->GetDescription();
+        sJob.papszOpenOptions = poSrcDS->GetOpenOptions();
+        sJob.osLayerName = poSrcLayer->GetName();
+        sJob.nFieldCount = poSrcDefn->GetFieldCount();
+        sJob.pszWHERE = pszWHERE;
+        sJob.papszIgnoredFields = papszIgnoredFields;
+        sJob.nStart = nTotal * i / nThreads;
+        sJob.nEnd = nTotal * (i + 1) / nThreads;
+        sJob.nTotal = nTotal;
+        sJob.poGroups = new OGRGenSQLGroupTable( psSelectInfo, poDefn );
+        sJob.bSuccess = false;
+        apJobs.push_back( &sJob );
+    }
+
+    CPLWorkerThreadPool oPool;
+    bool bOK = oPool.Setup( nThreads, nullptr, nullptr ) &&
+               oPool.SubmitJobs( OGRGenSQLGroupByWorker, apJobs );
+    oPool.WaitCompletion();
+
+    for( int i = 0; i < nThreads; i++ )
+        bOK = bOK && asJobs[i].bSuccess;
+
+    if( bOK )
+    {
+        // Merge in partition order, so that groups are reported in the
+        // same order as with a sequential scan.  Partitions are merged in
+        // a scratch table, so that oGroups is left empty for the
+        // sequential scan if a merge fails.
+        OGRGenSQLGroupTable oMerged( psSelectInfo, poDefn );
+        for( int i = 0; bOK && i < nThreads; i++ )
+            bOK = oMerged.Merge( *(asJobs[i].poGroups) );
+        if( bOK )
+        {
+            oGroups.Swap( oMerged );
+            CPLDebug( "GenSQL", "GROUP BY aggregated with %d threads.",
+                      nThreads );
+        }
+    }
+
+    if( !bOK )
+    {
+        CPLDebug( "GenSQL", "Parallel GROUP BY failed. "
+                  "Falling back to a sequential scan." );
+    }
+
+    for( int i = 0; i < nThreads; i++ )
+        delete asJobs[i].poGroups;
+    CSLDestroy( papszIgnoredFields );
+
+    return bOK;
+}
+
+/************************************************************************/
+/*                           PrepareGroups()                            */
+/*                                                                      */
+/*      Run the hash aggregation of a GROUP BY query, and build the     */
+/*      list of result features.                                        */
+/************************************************************************/
+
+bool OGRGenSQLResultsLayer::PrepareGroups()
+
+{
+    if( m_bGroupsPrepared )
+        return true;
+    m_bGroupsPrepared = true;
+
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    OGRGenSQLGroupTable oGroups( psSelectInfo, poDefn );
+
+    if( !AggregateGroupsInParallel( oGroups ) )
+    {
+        ApplyFiltersToSource();
+
+        const int bSaveIsGeomIgnored =
+            poSrcLayer->GetLayerDefn()->IsGeometryIgnored();
+        if( !MustReadSourceGeometry() )
+            poSrcLayer->GetLayerDefn()->SetGeometryIgnored(TRUE);
+
+        OGRFeature *poSrcFeature = nullptr;
+        while( (poSrcFeature = poSrcLayer->GetNextFeature()) != nullptr )
         {
-            nResult = OGRCompareDate(&pasFirstTuple[iKey],
-                                     &pasSecondTuple[iKey]);
+            const char *pszError = oGroups.Accumulate( poSrcFeature );
+            delete poSrcFeature;
+
+            if( pszError != nullptr )
+            {
+                poSrcLayer->GetLayerDefn()->SetGeometryIgnored(
+                                                        bSaveIsGeomIgnored);
+                CPLError( CE_Failure, CPLE_AppDefined, "%s", pszError );
+                return false;
+            }
         }
 
-        if( !(psKeyDef->ascending_flag) )
-            nResult *= -1;
+        poSrcLayer->GetLayerDefn()->SetGeometryIgnored(bSaveIsGeomIgnored);
+        ClearFilters();
     }
 
-    return nResult;
+    oGroups.Finalize();
+    m_apoGroupFeatures.swap( oGroups.apoFeatures );
+    SortGroups();
+
+    return true;
+}
+
+/************************************************************************/
+/*                         CompareGroupField()                          */
+/************************************************************************/
+
+static int CompareGroupField( OGRFeature *poFirst, OGRFeature *poSecond,
+                              int iField )
+{
+    const bool bFirstNull = !poFirst->IsFieldSetAndNotNull(iField);
+    const bool bSecondNull = !poSecond->IsFieldSetAndNotNull(iField);
+    if( bFirstNull || bSecondNull )
+        return bFirstNull == bSecondNull ? 0 : bFirstNull ? -1 : 1;
+
+    const OGRField *psFirst = poFirst->GetRawFieldRef(iField);
+    const OGRField *psSecond = poSecond->GetRawFieldRef(iField);
+    switch( poFirst->GetFieldDefnRef(iField)->GetType() )
+    {
+      case OFTInteger:
+        return ComparePrimitive( psFirst->Integer, psSecond->Integer );
+      case OFTInteger64:
+        return ComparePrimitive( psFirst->Integer64, psSecond->Integer64 );
+      case OFTReal:
+        return ComparePrimitive( psFirst->Real, psSecond->Real );
+      case OFTString:
+        return strcmp( psFirst->String, psSecond->String );
+      case OFTDate:
+      case OFTTime:
+      case OFTDateTime:
+        return OGRCompareDate( psFirst, psSecond );
+      default:
+      {
+        const CPLString osFirst( poFirst->GetFieldAsString(iField) );
+        return strcmp( osFirst, poSecond->GetFieldAsString(iField) );
+      }
+    }
+}
+
+/************************************************************************/
+/*                       OGRGenSQLGroupComparator                       */
+/************************************************************************/
+
+class OGRGenSQLGroupComparator
+{
+    swq_select *psSelectInfo;
+
+  public:
+    explicit OGRGenSQLGroupComparator( swq_select *psSelectInfoIn ) :
+        psSelectInfo(psSelectInfoIn) {}
+
+    bool operator()( OGRFeature *poFirst, OGRFeature *poSecond ) const
+    {
+        for( int iKey = 0; iKey < psSelectInfo->order_specs; iKey++ )
+        {
+            swq_order_def *psKeyDef = psSelectInfo->order_defs + iKey;
+            const int nResult =
+                CompareGroupField( poFirst, poSecond, psKeyDef->field_index );
+            if( nResult != 0 )
+                return psKeyDef->ascending_flag ? nResult < 0 : nResult > 0;
+        }
+        return false;
+    }
+};
+
+/************************************************************************/
+/*                             SortGroups()                             */
+/*                                                                      */
+/*      Apply the ORDER BY clause, which references result columns,     */
+/*      to the groups, and number them.                                 */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::SortGroups()
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+
+    if( psSelectInfo->order_specs > 0 )
+    {
+        std::stable_sort( m_apoGroupFeatures.begin(),
+                          m_apoGroupFeatures.end(),
+                          OGRGenSQLGroupComparator(psSelectInfo) );
+    }
+
+    for( size_t i = 0; i < m_apoGroupFeatures.size(); i++ )
+        m_apoGroupFeatures[i]->SetFID( static_cast<GIntBig>(i) );
+}
+
+/************************************************************************/
+/*                            ClearGroups()                             */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::ClearGroups()
+{
+    for( size_t i = 0; i < m_apoGroupFeatures.size(); i++ )
+        delete m_apoGroupFeatures[i];
+    m_apoGroupFeatures.clear();
+    m_bGroupsPrepared = false;
 }
 
 /************************************************************************/
@@ -2361,7 +3826,15 @@ void OGRGenSQLResultsLayer::FindAndSetIgnoredFields()
         ExploreExprForIgnoredFields(psJoinDef->poExpr, hSet);
     }
 
-    for( int iOrder = 0; iOrder < psSelectInfo->order_specs; iOrder++ )
+    for( int iGroup = 0; iGroup < psSelectInfo->group_specs; iGroup++ )
+    {
+        swq_group_def *psGroupDef = psSelectInfo->group_defs + iGroup;
+        AddFieldDefnToSet(psGroupDef->table_index, psGroupDef->field_index, hSet);
+    }
+
+    // ORDER BY of GROUP BY queries references result columns.
+    for( int iOrder = 0; psSelectInfo->query_mode != SWQM_GROUP_BY &&
+                         iOrder < psSelectInfo->order_specs; iOrder++ )
     {
         swq_order_def *psOrderDef = psSelectInfo->order_defs + iOrder;
         AddFieldDefnToSet(psOrderDef->table_index, psOrderDef->field_index, hSet);
@@ -2403,8 +3876,17 @@ void OGRGenSQLResultsLayer::InvalidateOrderByIndex()
     CPLFree( panFIDIndex );
     panFIDIndex = nullptr;
 
+    if( fpFIDIndex != nullptr )
+    {
+        VSIFCloseL( fpFIDIndex );
+        fpFIDIndex = nullptr;
+        VSIUnlink( osFIDIndexFilename );
+        osFIDIndexFilename.clear();
+    }
+
     nIndexSize = 0;
     bOrderByValid = FALSE;
+    m_bOrderByFailed = false;
 }
 
 /************************************************************************/
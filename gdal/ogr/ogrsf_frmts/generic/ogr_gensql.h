@@ -50,6 +50,8 @@
 #define ALL_FIELD_INDEX_TO_GEOM_FIELD_INDEX(poFDefn, idx) \
     ((idx) - ((poFDefn)->GetFieldCount() + SPECIAL_FIELD_COUNT))
 
+class OGRGenSQLGroupTable;
+
 /************************************************************************/
 /*                        OGRGenSQLResultsLayer                         */
 /************************************************************************/
@@ -72,6 +74,13 @@ class CPL_DLL OGRGenSQLResultsLayer : public OGRLayer
     size_t      nIndexSize;
     GIntBig    *panFIDIndex;
     int         bOrderByValid;
+    // Set when the ORDER BY index could not be built: no feature is
+    // returned rather than unsorted ones.
+    bool        m_bOrderByFailed;
+
+    // Sorted FIDs spilled to disk when ORDER BY exceeds the memory budget.
+    CPLString   osFIDIndexFilename;
+    VSILFILE   *fpFIDIndex;
 
     GIntBig      nNextIndexFID;
     OGRFeature  *poSummaryFeature;
@@ -84,10 +93,37 @@ class CPL_DLL OGRGenSQLResultsLayer : public OGRLayer
     GIntBig     nIteratedFeatures;
     std::vector<CPLString> m_oDistinctList;
 
+    // Result of a GROUP BY query, one feature per group.
+    std::vector<OGRFeature*> m_apoGroupFeatures;
+    bool        m_bGroupsPrepared;
+
     int         PrepareSummary();
+    bool        MustReadSourceGeometry();
+    bool        PrepareGroups();
+    bool        AggregateGroupsInParallel( OGRGenSQLGroupTable& oGroups );
+    void        SortGroups();
+    void        ClearGroups();
 
     OGRFeature *TranslateFeature( OGRFeature * );
     void        CreateOrderByIndex();
+    bool        CreateTopNOrderByIndex( GIntBig nTopN );
+    bool        HasFIDIndex() const
+                    { return panFIDIndex != nullptr || fpFIDIndex != nullptr; }
+    GIntBig     GetFIDFromIndex( GIntBig nIdx );
+    bool        IsStringOrderKey( int iKey );
+    size_t      GetIndexFieldsSize( const OGRField *pasIndexFields,
+                                    int nOrderItems );
+    bool        WriteSortedRun( OGRField *pasIndexFields,
+                                const GIntBig *panFIDList,
+                                std::vector<CPLString>& aosRuns );
+    bool        WriteIndexRecord( VSILFILE *fp, const OGRField *pasIndexFields,
+                                  GIntBig nFID );
+    bool        ReadIndexRecord( VSILFILE *fp, OGRField *pasIndexFields,
+                                 GIntBig *pnFID, bool *pbError );
+    bool        MergeSortedRuns( const std::vector<CPLString>& aosRuns,
+                                 VSILFILE *fpOut, bool bFIDOnly,
+                                 GIntBig *pnMerged );
+    bool        CreateExternalOrderByIndex( std::vector<CPLString>& aosRuns );
     void        ReadIndexFields( OGRFeature* poSrcFeat,
                                  int nOrderItems,
                                  OGRField *pasIndexFields );
@@ -651,10 +651,14 @@ OGRErr OGRMILayerAttrIndex::RemoveFromIndex( OGRFeature * /*poFeature*/ )
 }
 
 /************************************************************************/
-/*                     OGRCreateDefaultLayerIndex()                     */
+/*                       OGRCreateMILayerIndex()                        */
+/*                                                                      */
+/*      Legacy MapInfo .idm/.ind based attribute index.  Still used     */
+/*      for the MITAB driver and for datasets indexed by older GDAL     */
+/*      versions.                                                       */
 /************************************************************************/
 
-OGRLayerAttrIndex *OGRCreateDefaultLayerIndex()
+OGRLayerAttrIndex *OGRCreateMILayerIndex()
 
 {
     return new OGRMILayerAttrIndex();
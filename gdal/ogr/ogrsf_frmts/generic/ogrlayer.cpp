@@ -30,12 +30,402 @@
 #include "ogrsf_frmts.h"
 #include "ogr_api.h"
 #include "ogr_p.h"
+#include "ogr_wkb.h"
 #include "ogr_attrind.h"
 #include "swq.h"
 #include "ograpispy.h"
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
 CPL_CVSID("$Id$")
 
+/************************************************************************/
+/*                         OGRLayerFilterGrid                           */
+/*                                                                      */
+/*      Rasterized coverage of a polygonal spatial filter. Each cell    */
+/*      of a regular grid over the filter envelope is either fully      */
+/*      outside the filter, fully inside it, or crossed by its          */
+/*      boundary. This allows most features to be accepted or           */
+/*      rejected without converting them to GEOS.                       */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+class OGRLayerFilterGrid
+{
+        CPL_DISALLOW_COPY_ASSIGN(OGRLayerFilterGrid)
+
+        static constexpr GByte CELL_OUTSIDE = 0;
+        static constexpr GByte CELL_INSIDE = 1;
+        static constexpr GByte CELL_BOUNDARY = 2;
+
+        // Margin, in cells, used to make the rasterization conservative
+        // regarding rounding errors.
+        static constexpr double EPS = 1e-6;
+
+        int                     m_nSize;
+        OGREnvelope             m_sEnvelope;
+        double                  m_dfResX;
+        double                  m_dfResY;
+        std::vector<GByte>      m_abyCells{};
+        // Per row prefix counts of the cells that are not outside, and of
+        // the cells that are not inside.
+        std::vector<GUInt16>    m_anNotOutside{};
+        std::vector<GUInt16>    m_anNotInside{};
+
+        OGRLayerFilterGrid( const OGREnvelope& sEnvelope, int nSize );
+
+        void    BurnSegment( double dfX0, double dfY0,
+                             double dfX1, double dfY1 );
+        void    FillInterior( const std::vector<const OGRPolygon*>& apoParts );
+
+    public:
+        static OGRLayerFilterGrid* Create( const OGRGeometry* poFilter,
+                                           const OGREnvelope& sEnvelope );
+
+        int     ClassifyEnvelope( const OGREnvelope& sEnvelope ) const;
+        bool    IsPointInside( double dfX, double dfY ) const;
+        bool    HasVertexInside( const OGRGeometry* poGeom ) const;
+};
+
+constexpr GByte OGRLayerFilterGrid::CELL_OUTSIDE;
+constexpr GByte OGRLayerFilterGrid::CELL_INSIDE;
+constexpr GByte OGRLayerFilterGrid::CELL_BOUNDARY;
+constexpr double OGRLayerFilterGrid::EPS;
+
+OGRLayerFilterGrid::OGRLayerFilterGrid( const OGREnvelope& sEnvelope,
+                                        int nSize ) :
+    m_nSize(nSize),
+    m_sEnvelope(sEnvelope),
+    m_dfResX((sEnvelope.MaxX - sEnvelope.MinX) / nSize),
+    m_dfResY((sEnvelope.MaxY - sEnvelope.MinY) / nSize),
+    m_abyCells(static_cast<size_t>(nSize) * nSize, CELL_OUTSIDE)
+{
+}
+
+/************************************************************************/
+/*                               Create()                               */
+/*                                                                      */
+/*      Returns nullptr if the filter is not a (multi)polygon.          */
+/************************************************************************/
+
+OGRLayerFilterGrid* OGRLayerFilterGrid::Create( const OGRGeometry* poFilter,
+                                                const OGREnvelope& sEnvelope )
+{
+    std::vector<const OGRPolygon*> apoParts;
+    const OGRwkbGeometryType eType = wkbFlatten(poFilter->getGeometryType());
+    if( eType == wkbPolygon )
+    {
+        apoParts.push_back(static_cast<const OGRPolygon*>(poFilter));
+    }
+    else if( eType == wkbMultiPolygon )
+    {
+        const OGRMultiPolygon* poMP =
+            static_cast<const OGRMultiPolygon*>(poFilter);
+        for( int i = 0; i < poMP->getNumGeometries(); i++ )
+            apoParts.push_back(
+                static_cast<const OGRPolygon*>(poMP->getGeometryRef(i)));
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    if( poFilter->IsEmpty() ||
+        !(sEnvelope.MaxX > sEnvelope.MinX) ||
+        !(sEnvelope.MaxY > sEnvelope.MinY) )
+    {
+        return nullptr;
+    }
+
+    const int nSize = std::max(1, std::min(1024, atoi(
+        CPLGetConfigOption("OGR_SPATIAL_FILTER_GRID_SIZE", "256"))));
+    OGRLayerFilterGrid* poGrid = new OGRLayerFilterGrid(sEnvelope, nSize);
+
+    for( size_t iPart = 0; iPart < apoParts.size(); iPart++ )
+    {
+        const OGRPolygon* poPoly = apoParts[iPart];
+        for( int iRing = -1; iRing < poPoly->getNumInteriorRings(); iRing++ )
+        {
+            const OGRLinearRing* poRing = iRing < 0 ?
+                poPoly->getExteriorRing() : poPoly->getInteriorRing(iRing);
+            if( poRing == nullptr )
+                continue;
+            const int nPoints = poRing->getNumPoints();
+            for( int i = 0; i + 1 < nPoints; i++ )
+            {
+                poGrid->BurnSegment(poRing->getX(i), poRing->getY(i),
+                                    poRing->getX(i+1), poRing->getY(i+1));
+            }
+        }
+    }
+
+    poGrid->FillInterior(apoParts);
+
+    const int nStride = nSize + 1;
+    poGrid->m_anNotOutside.resize(static_cast<size_t>(nSize) * nStride);
+    poGrid->m_anNotInside.resize(static_cast<size_t>(nSize) * nStride);
+    for( int iRow = 0; iRow < nSize; iRow++ )
+    {
+        GUInt16* panNotOutside = &poGrid->m_anNotOutside[iRow * nStride];
+        GUInt16* panNotInside = &poGrid->m_anNotInside[iRow * nStride];
+        const GByte* pabyCells = &poGrid->m_abyCells[iRow * nSize];
+        panNotOutside[0] = 0;
+        panNotInside[0] = 0;
+        for( int iCol = 0; iCol < nSize; iCol++ )
+        {
+            panNotOutside[iCol+1] = static_cast<GUInt16>(panNotOutside[iCol] +
+                (pabyCells[iCol] != CELL_OUTSIDE ? 1 : 0));
+            panNotInside[iCol+1] = static_cast<GUInt16>(panNotInside[iCol] +
+                (pabyCells[iCol] != CELL_INSIDE ? 1 : 0));
+        }
+    }
+
+    return poGrid;
+}
+
+/************************************************************************/
+/*                            BurnSegment()                             */
+/*                                                                      */
+/*      Mark as boundary all the cells touched by a segment. The cells  */
+/*      are processed column by column, with the y range of the         */
+/*      segment over each column, slightly enlarged.                    */
+/************************************************************************/
+
+void OGRLayerFilterGrid::BurnSegment( double dfX0, double dfY0,
+                                      double dfX1, double dfY1 )
+{
+    // Grid coordinates
+    const double dfGX0 = (dfX0 - m_sEnvelope.MinX) / m_dfResX;
+    const double dfGY0 = (dfY0 - m_sEnvelope.MinY) / m_dfResY;
+    const double dfGX1 = (dfX1 - m_sEnvelope.MinX) / m_dfResX;
+    const double dfGY1 = (dfY1 - m_sEnvelope.MinY) / m_dfResY;
+    const double dfGXMin = std::min(dfGX0, dfGX1);
+    const double dfGXMax = std::max(dfGX0, dfGX1);
+
+    const int nColStart = std::max(0,
+                        static_cast<int>(floor(dfGXMin - EPS)));
+    const int nColEnd = std::min(m_nSize - 1,
+                        static_cast<int>(floor(dfGXMax + EPS)));
+    for( int iCol = nColStart; iCol <= nColEnd; iCol++ )
+    {
+        double dfYA = dfGY0;
+        double dfYB = dfGY1;
+        if( dfGX1 != dfGX0 )
+        {
+            const double dfXA = std::max(dfGXMin, iCol - EPS);
+            const double dfXB = std::min(dfGXMax, iCol + 1 + EPS);
+            const double dfSlope = (dfGY1 - dfGY0) / (dfGX1 - dfGX0);
+            dfYA = dfGY0 + (dfXA - dfGX0) * dfSlope;
+            dfYB = dfGY0 + (dfXB - dfGX0) * dfSlope;
+        }
+        const int nRowStart = std::max(0,
+                    static_cast<int>(floor(std::min(dfYA, dfYB) - EPS)));
+        const int nRowEnd = std::min(m_nSize - 1,
+                    static_cast<int>(floor(std::max(dfYA, dfYB) + EPS)));
+        for( int iRow = nRowStart; iRow <= nRowEnd; iRow++ )
+            m_abyCells[iRow * m_nSize + iCol] = CELL_BOUNDARY;
+    }
+}
+
+/************************************************************************/
+/*                            FillInterior()                            */
+/*                                                                      */
+/*      The cells not crossed by the boundary are entirely inside or    */
+/*      outside the filter, which is determined by testing their        */
+/*      center with an even-odd scanline over each polygon.             */
+/************************************************************************/
+
+void OGRLayerFilterGrid::FillInterior(
+                            const std::vector<const OGRPolygon*>& apoParts )
+{
+    std::vector<OGREnvelope> asPartEnvelopes(apoParts.size());
+    for( size_t iPart = 0; iPart < apoParts.size(); iPart++ )
+        apoParts[iPart]->getEnvelope(&asPartEnvelopes[iPart]);
+
+    std::vector<double> adfCrossings;
+    for( int iRow = 0; iRow < m_nSize; iRow++ )
+    {
+        const double dfY = m_sEnvelope.MinY + (iRow + 0.5) * m_dfResY;
+        GByte* pabyCells = &m_abyCells[iRow * m_nSize];
+
+        for( size_t iPart = 0; iPart < apoParts.size(); iPart++ )
+        {
+            if( dfY < asPartEnvelopes[iPart].MinY ||
+                dfY > asPartEnvelopes[iPart].MaxY )
+                continue;
+
+            const OGRPolygon* poPoly = apoParts[iPart];
+            adfCrossings.clear();
+            for( int iRing = -1; iRing < poPoly->getNumInteriorRings(); iRing++ )
+            {
+                const OGRLinearRing* poRing = iRing < 0 ?
+                    poPoly->getExteriorRing() : poPoly->getInteriorRing(iRing);
+                if( poRing == nullptr )
+                    continue;
+                const int nPoints = poRing->getNumPoints();
+                for( int i = 0; i + 1 < nPoints; i++ )
+                {
+                    const double dfYA = poRing->getY(i);
+                    const double dfYB = poRing->getY(i+1);
+                    if( (dfYA > dfY) != (dfYB > dfY) )
+                    {
+                        const double dfXA = poRing->getX(i);
+                        const double dfXB = poRing->getX(i+1);
+                        adfCrossings.push_back(
+                            dfXA + (dfY - dfYA) * (dfXB - dfXA) / (dfYB - dfYA));
+                    }
+                }
+            }
+            if( adfCrossings.empty() )
+                continue;
+            std::sort(adfCrossings.begin(), adfCrossings.end());
+
+            size_t iCrossing = 0;
+            for( int iCol = 0; iCol < m_nSize; iCol++ )
+            {
+                const double dfX = m_sEnvelope.MinX + (iCol + 0.5) * m_dfResX;
+                while( iCrossing < adfCrossings.size() &&
+                       adfCrossings[iCrossing] < dfX )
+                {
+                    iCrossing++;
+                }
+                if( iCrossing == adfCrossings.size() )
+                    break;
+                if( (iCrossing % 2) == 1 && pabyCells[iCol] == CELL_OUTSIDE )
+                    pabyCells[iCol] = CELL_INSIDE;
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                          ClassifyEnvelope()                          */
+/*                                                                      */
+/*      Returns -1 if the envelope only covers cells outside of the     */
+/*      filter (no intersection), 1 if it only covers cells inside the  */
+/*      filter (any geometry with that envelope intersects), and 0      */
+/*      otherwise.                                                      */
+/************************************************************************/
+
+int OGRLayerFilterGrid::ClassifyEnvelope( const OGREnvelope& sEnvelope ) const
+{
+    const double dfColStart = (sEnvelope.MinX - m_sEnvelope.MinX) / m_dfResX;
+    const double dfColEnd = (sEnvelope.MaxX - m_sEnvelope.MinX) / m_dfResX;
+    const double dfRowStart = (sEnvelope.MinY - m_sEnvelope.MinY) / m_dfResY;
+    const double dfRowEnd = (sEnvelope.MaxY - m_sEnvelope.MinY) / m_dfResY;
+
+    // Parts of the envelope beyond the filter envelope are outside
+    const bool bBeyond = dfColStart < 0 || dfRowStart < 0 ||
+                         dfColEnd > m_nSize || dfRowEnd > m_nSize;
+    const int nColStart = std::max(0, std::min(m_nSize - 1,
+                                static_cast<int>(floor(dfColStart - EPS))));
+    const int nColEnd = std::max(0, std::min(m_nSize - 1,
+                                static_cast<int>(floor(dfColEnd + EPS))));
+    const int nRowStart = std::max(0, std::min(m_nSize - 1,
+                                static_cast<int>(floor(dfRowStart - EPS))));
+    const int nRowEnd = std::max(0, std::min(m_nSize - 1,
+                                static_cast<int>(floor(dfRowEnd + EPS))));
+
+    const int nStride = m_nSize + 1;
+    bool bAllOutside = true;
+    bool bAllInside = !bBeyond;
+    for( int iRow = nRowStart; iRow <= nRowEnd; iRow++ )
+    {
+        const int iOffset = iRow * nStride;
+        if( m_anNotOutside[iOffset + nColEnd + 1] !=
+                                        m_anNotOutside[iOffset + nColStart] )
+            bAllOutside = false;
+        if( m_anNotInside[iOffset + nColEnd + 1] !=
+                                        m_anNotInside[iOffset + nColStart] )
+            bAllInside = false;
+        if( !bAllOutside && !bAllInside )
+            return 0;
+    }
+    return bAllOutside ? -1 : bAllInside ? 1 : 0;
+}
+
+/************************************************************************/
+/*                           IsPointInside()                            */
+/*                                                                      */
+/*      Whether a point is in a cell fully inside the filter.           */
+/************************************************************************/
+
+bool OGRLayerFilterGrid::IsPointInside( double dfX, double dfY ) const
+{
+    OGREnvelope sEnvelope;
+    sEnvelope.MinX = dfX;
+    sEnvelope.MaxX = dfX;
+    sEnvelope.MinY = dfY;
+    sEnvelope.MaxY = dfY;
+    return ClassifyEnvelope(sEnvelope) > 0;
+}
+
+/************************************************************************/
+/*                          HasVertexInside()                           */
+/*                                                                      */
+/*      All the vertices of (simple or circular) curves belong to the   */
+/*      geometry, so one of them being inside the filter means that the */
+/*      geometry intersects it.                                         */
+/************************************************************************/
+
+bool OGRLayerFilterGrid::HasVertexInside( const OGRGeometry* poGeom ) const
+{
+    const OGRwkbGeometryType eType = wkbFlatten(poGeom->getGeometryType());
+    if( eType == wkbPoint )
+    {
+        const OGRPoint* poPoint = static_cast<const OGRPoint*>(poGeom);
+        return !poPoint->IsEmpty() &&
+               IsPointInside(poPoint->getX(), poPoint->getY());
+    }
+    if( OGR_GT_IsSubClassOf(eType, wkbCurvePolygon) )
+    {
+        const OGRCurvePolygon* poPoly =
+            static_cast<const OGRCurvePolygon*>(poGeom);
+        if( poPoly->getExteriorRingCurve() == nullptr )
+            return false;
+        // Vertices of the interior rings are inside the exterior one
+        return HasVertexInside(poPoly->getExteriorRingCurve());
+    }
+    if( eType == wkbCompoundCurve )
+    {
+        const OGRCompoundCurve* poCC =
+            static_cast<const OGRCompoundCurve*>(poGeom);
+        for( int i = 0; i < poCC->getNumCurves(); i++ )
+        {
+            if( HasVertexInside(poCC->getCurve(i)) )
+                return true;
+        }
+        return false;
+    }
+    if( OGR_GT_IsSubClassOf(eType, wkbGeometryCollection) )
+    {
+        const OGRGeometryCollection* poGC =
+            static_cast<const OGRGeometryCollection*>(poGeom);
+        for( int i = 0; i < poGC->getNumGeometries(); i++ )
+        {
+            if( HasVertexInside(poGC->getGeometryRef(i)) )
+                return true;
+        }
+        return false;
+    }
+    if( eType == wkbLineString || eType == wkbCircularString )
+    {
+        const OGRSimpleCurve* poSC =
+            static_cast<const OGRSimpleCurve*>(poGeom);
+        const int nPoints = poSC->getNumPoints();
+        for( int i = 0; i < nPoints; i++ )
+        {
+            if( IsPointInside(poSC->getX(i), poSC->getY(i)) )
+                return true;
+        }
+    }
+    return false;
+}
+//! @endcond
+
 /************************************************************************/
 /*                              OGRLayer()                              */
 /************************************************************************/
@@ -44,6 +434,8 @@ OGRLayer::OGRLayer() :
     m_bFilterIsEnvelope(FALSE),
     m_poFilterGeom(nullptr),
     m_pPreparedFilterGeom(nullptr),
+    m_poFilterGrid(nullptr),
+    m_bFilterGridBuilt(false),
     m_iGeomFieldFilter(0),
     m_poStyleTable(nullptr),
     m_poAttrQuery(nullptr),
@@ -91,6 +483,8 @@ OGRLayer::~OGRLayer()
         OGRDestroyPreparedGeometry(m_pPreparedFilterGeom);
         m_pPreparedFilterGeom = nullptr;
     }
+
+    delete m_poFilterGrid;
 }
 
 /************************************************************************/
@@ -1280,6 +1674,10 @@ int OGRLayer::InstallFilter( OGRGeometry * poFilter )
         m_pPreparedFilterGeom = nullptr;
     }
 
+    delete m_poFilterGrid;
+    m_poFilterGrid = nullptr;
+    m_bFilterGridBuilt = false;
+
     if( poFilter != nullptr )
         m_poFilterGeom = poFilter->clone();
 
@@ -1336,6 +1734,30 @@ int OGRLayer::InstallFilter( OGRGeometry * poFilter )
 }
 //! @endcond
 
+/************************************************************************/
+/*                           GetFilterGrid()                            */
+/*                                                                      */
+/*      Return the coverage grid of a non rectangular polygonal         */
+/*      filter, building it on first use, or nullptr.                   */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+OGRLayerFilterGrid* OGRLayer::GetFilterGrid()
+{
+    if( !m_bFilterGridBuilt )
+    {
+        m_bFilterGridBuilt = true;
+        if( m_poFilterGeom != nullptr && !m_bFilterIsEnvelope &&
+            CPLTestBool(CPLGetConfigOption("OGR_SPATIAL_FILTER_GRID", "YES")) )
+        {
+            m_poFilterGrid =
+                OGRLayerFilterGrid::Create(m_poFilterGeom, m_sFilterEnvelope);
+        }
+    }
+    return m_poFilterGrid;
+}
+//! @endcond
+
 /************************************************************************/
 /*                           FilterGeometry()                           */
 /*                                                                      */
@@ -1438,6 +1860,24 @@ int OGRLayer::FilterGeometry( OGRGeometry *poGeometry )
             }
         }
 
+/* -------------------------------------------------------------------- */
+/*      Otherwise, use the coverage grid of a polygonal filter to       */
+/*      reject geometries in cells outside of it, and to accept the     */
+/*      ones with a vertex in a cell inside of it.                      */
+/* -------------------------------------------------------------------- */
+        else
+        {
+            const OGRLayerFilterGrid* poGrid = GetFilterGrid();
+            if( poGrid != nullptr )
+            {
+                const int nClass = poGrid->ClassifyEnvelope(sGeomEnv);
+                if( nClass < 0 )
+                    return FALSE;
+                if( nClass > 0 || poGrid->HasVertexInside(poGeometry) )
+                    return TRUE;
+            }
+        }
+
 /* -------------------------------------------------------------------- */
 /*      Fallback to full intersect test (using GEOS) if we still        */
 /*      don't know for sure.                                            */
@@ -1457,6 +1897,151 @@ int OGRLayer::FilterGeometry( OGRGeometry *poGeometry )
 }
 //! @endcond
 
+/************************************************************************/
+/*                         FilterWKBGeometry()                          */
+/*                                                                      */
+/*      Same as FilterGeometry(), but working on a WKB (or EWKB)        */
+/*      geometry, so that drivers can discard features before          */
+/*      building them. The envelope and the point-in-rectangle tests    */
+/*      are done on a OGRWKBGeometryView, and an OGRGeometry is only    */
+/*      instantiated when the full GEOS intersection test is needed.    */
+/*                                                                      */
+/*      If bEnvelopeAlreadySet is true, sEnvelope must be set to the    */
+/*      envelope of the geometry (for example from a GeoPackage         */
+/*      header). Otherwise it is set by this method when it can be      */
+/*      computed.                                                       */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+
+namespace {
+struct OGRLayerPointInEnvelopeData
+{
+    const OGREnvelope* psEnvelope;
+    bool               bFound;
+};
+}
+
+static bool OGRLayerPointInEnvelope( double dfX, double dfY,
+                                     double /* dfZ */, double /* dfM */,
+                                     void* pUserData )
+{
+    OGRLayerPointInEnvelopeData* psData =
+        static_cast<OGRLayerPointInEnvelopeData*>(pUserData);
+    const OGREnvelope* psEnv = psData->psEnvelope;
+    if( dfX >= psEnv->MinX && dfY >= psEnv->MinY &&
+        dfX <= psEnv->MaxX && dfY <= psEnv->MaxY )
+    {
+        psData->bFound = true;
+        return false;
+    }
+    return true;
+}
+
+namespace {
+struct OGRLayerPointInGridData
+{
+    const OGRLayerFilterGrid* poGrid;
+    bool                      bFound;
+};
+}
+
+static bool OGRLayerPointInGrid( double dfX, double dfY,
+                                 double /* dfZ */, double /* dfM */,
+                                 void* pUserData )
+{
+    OGRLayerPointInGridData* psData =
+        static_cast<OGRLayerPointInGridData*>(pUserData);
+    if( psData->poGrid->IsPointInside(dfX, dfY) )
+    {
+        psData->bFound = true;
+        return false;
+    }
+    return true;
+}
+
+int OGRLayer::FilterWKBGeometry( const GByte* pabyWKB, size_t nWKBSize,
+                                 bool bEnvelopeAlreadySet,
+                                 OGREnvelope& sEnvelope )
+{
+    if( m_poFilterGeom == nullptr )
+        return TRUE;
+
+    OGRWKBGeometryView oView;
+    if( oView.Init(pabyWKB, nWKBSize) )
+    {
+        if( oView.IsEmpty() )
+            return FALSE;
+
+        if( bEnvelopeAlreadySet || oView.GetEnvelope(sEnvelope) )
+        {
+            if( sEnvelope.MaxX < m_sFilterEnvelope.MinX
+                || sEnvelope.MaxY < m_sFilterEnvelope.MinY
+                || m_sFilterEnvelope.MaxX < sEnvelope.MinX
+                || m_sFilterEnvelope.MaxY < sEnvelope.MinY )
+                return FALSE;
+
+            if( m_bFilterIsEnvelope )
+            {
+                if( sEnvelope.MinX >= m_sFilterEnvelope.MinX &&
+                    sEnvelope.MinY >= m_sFilterEnvelope.MinY &&
+                    sEnvelope.MaxX <= m_sFilterEnvelope.MaxX &&
+                    sEnvelope.MaxY <= m_sFilterEnvelope.MaxY )
+                {
+                    return TRUE;
+                }
+
+                // A line, or polygon without hole, with at least one point
+                // inside the filter rectangle intersects it.
+                const OGRwkbGeometryType eFlatType =
+                    wkbFlatten(oView.GetGeometryType());
+                if( eFlatType == wkbLineString ||
+                    (eFlatType == wkbPolygon && oView.GetPartCount() == 1) )
+                {
+                    OGRLayerPointInEnvelopeData sData;
+                    sData.psEnvelope = &m_sFilterEnvelope;
+                    sData.bFound = false;
+                    oView.ForEachPoint(OGRLayerPointInEnvelope, &sData);
+                    if( sData.bFound )
+                        return TRUE;
+                }
+            }
+            else if( GetFilterGrid() != nullptr )
+            {
+                const int nClass = m_poFilterGrid->ClassifyEnvelope(sEnvelope);
+                if( nClass < 0 )
+                    return FALSE;
+                if( nClass > 0 )
+                    return TRUE;
+                // The envelope is only available without circular arcs, so
+                // all the points are vertices of the geometry.
+                OGRLayerPointInGridData sData;
+                sData.poGrid = m_poFilterGrid;
+                sData.bFound = false;
+                oView.ForEachPoint(OGRLayerPointInGrid, &sData);
+                if( sData.bFound )
+                    return TRUE;
+            }
+
+            if( !OGRGeometryFactory::haveGEOS() )
+                return TRUE;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Fallback to the test on the full geometry.                      */
+/* -------------------------------------------------------------------- */
+    OGRGeometry* poGeom = nullptr;
+    OGRGeometryFactory::createFromWkb(
+        const_cast<GByte*>(pabyWKB), nullptr, &poGeom,
+        static_cast<int>(std::min(nWKBSize,
+                                  static_cast<size_t>(INT_MAX))));
+    const int bRet = FilterGeometry(poGeom);
+    delete poGeom;
+    return bRet;
+}
+//! @endcond
+
 /************************************************************************/
 /*                         OGR_L_ResetReading()                         */
 /************************************************************************/
@@ -1491,7 +2076,27 @@ OGRErr OGRLayer::InitializeIndexSupport( const char *pszFilename )
     if (m_poAttrIndex != nullptr)
         return OGRERR_NONE;
 
-    m_poAttrIndex = OGRCreateDefaultLayerIndex();
+/* -------------------------------------------------------------------- */
+/*      Use the legacy MapInfo based index for inline XML definitions  */
+/*      (MITAB), when explicitly requested, or when only a .idm file    */
+/*      written by an older version exists.                             */
+/* -------------------------------------------------------------------- */
+    bool bUseMIIndex =
+        STARTS_WITH_CI(pszFilename, "<OGRMILayerAttrIndex>") ||
+        EQUAL(CPLGetConfigOption("OGR_ATTR_INDEX_FORMAT", "BTREE"),
+              "MAPINFO");
+    if( !bUseMIIndex )
+    {
+        VSIStatBufL sStat;
+        bUseMIIndex =
+            VSIStatL(CPLResetExtension(pszFilename, "oix"), &sStat) != 0 &&
+            VSIStatL(CPLResetExtension(pszFilename, "idm"), &sStat) == 0;
+    }
+
+    if( bUseMIIndex )
+        m_poAttrIndex = OGRCreateMILayerIndex();
+    else
+        m_poAttrIndex = OGRCreateDefaultLayerIndex();
 
     eErr = m_poAttrIndex->Initialize( pszFilename, this );
     if( eErr != OGRERR_NONE )
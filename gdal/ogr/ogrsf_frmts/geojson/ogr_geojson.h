@@ -115,7 +115,15 @@ class OGRGeoJSONLayer : public OGRMemLayer
     GIntBig nTotalFeatureCount_;
     GIntBig nNextFID_;
 
+    // Sorted FIDs of the candidate features returned by the attribute
+    // index, and how many of them have been returned so far.
+    GIntBig* panMatchingFIDs_;
+    GIntBig nMatchingFIDCount_;
+    GIntBig nMatchingFIDsRead_;
+    bool bMatchingFIDsComputed_;
+
     bool IngestAll();
+    void ComputeMatchingFIDs();
     void TerminateAppendSession();
 };
 
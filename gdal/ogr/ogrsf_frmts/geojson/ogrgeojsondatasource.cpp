@@ -204,6 +204,18 @@ int OGRGeoJSONDataSource::Open( GDALOpenInfo* poOpenInfo,
         return FALSE;
     }
 
+/* -------------------------------------------------------------------- */
+/*      Attribute indexes of read-only files are stored in a            */
+/*      <filename>.oix sidecar file.                                    */
+/* -------------------------------------------------------------------- */
+    if( eGeoJSONSourceFile == nSrcType && !bUpdatable_ && nLayers_ == 1 &&
+        EQUAL(pszJSonFlavor, "GeoJSON") &&
+        !STARTS_WITH(pszUnprefixed, "/vsistdin/") )
+    {
+        papoLayers_[0]->InitializeIndexSupport(
+            CPLSPrintf("%s.oix", pszUnprefixed));
+    }
+
     return TRUE;
 }
 
@@ -82,7 +82,11 @@ OGRGeoJSONLayer::OGRGeoJSONLayer( const char* pszName,
     bUpdated_(false),
     bOriginalIdModified_(false),
     nTotalFeatureCount_(0),
-    nNextFID_(0)
+    nNextFID_(0),
+    panMatchingFIDs_(nullptr),
+    nMatchingFIDCount_(0),
+    nMatchingFIDsRead_(0),
+    bMatchingFIDsComputed_(false)
 {
     SetAdvertizeUTF8(true);
     SetUpdatable( poDS->IsUpdatable() );
@@ -96,6 +100,7 @@ OGRGeoJSONLayer::~OGRGeoJSONLayer()
 {
     TerminateAppendSession();
     delete poReader_;
+    CPLFree(panMatchingFIDs_);
 }
 
 /************************************************************************/
@@ -136,6 +141,12 @@ void OGRGeoJSONLayer::SetFIDColumn( const char* pszFIDColumn )
 
 void OGRGeoJSONLayer::ResetReading()
 {
+    CPLFree(panMatchingFIDs_);
+    panMatchingFIDs_ = nullptr;
+    nMatchingFIDCount_ = 0;
+    nMatchingFIDsRead_ = 0;
+    bMatchingFIDsComputed_ = false;
+
     if( poReader_ )
     {
         TerminateAppendSession();
@@ -152,14 +163,23 @@ void OGRGeoJSONLayer::ResetReading()
 
 OGRFeature* OGRGeoJSONLayer::GetNextFeature()
 {
+    if( poReader_ && bHasAppendedFeatures_ )
+    {
+        ResetReading();
+    }
+
+    if( !bMatchingFIDsComputed_ )
+        ComputeMatchingFIDs();
+
     if( poReader_ )
     {
-        if( bHasAppendedFeatures_ )
-        {
-            ResetReading();
-        }
         while ( true )
         {
+            // All the candidate features have been read.
+            if( panMatchingFIDs_ != nullptr &&
+                nMatchingFIDsRead_ == nMatchingFIDCount_ )
+                return nullptr;
+
             OGRFeature* poFeature = poReader_->GetNextFeature(this);
             if( poFeature == nullptr )
                 return nullptr;
@@ -168,6 +188,17 @@ OGRFeature* OGRGeoJSONLayer::GetNextFeature()
                 poFeature->SetFID(nNextFID_);
                 nNextFID_ ++;
             }
+            if( panMatchingFIDs_ != nullptr )
+            {
+                if( !std::binary_search(panMatchingFIDs_,
+                                        panMatchingFIDs_ + nMatchingFIDCount_,
+                                        poFeature->GetFID()) )
+                {
+                    delete poFeature;
+                    continue;
+                }
+                nMatchingFIDsRead_ ++;
+            }
             if( (m_poFilterGeom == nullptr ||
                 FilterGeometry(poFeature->GetGeomFieldRef(m_iGeomFieldFilter)) )
                 && (m_poAttrQuery == nullptr ||
@@ -178,12 +209,60 @@ OGRFeature* OGRGeoJSONLayer::GetNextFeature()
             delete poFeature;
         }
     }
+    else if( panMatchingFIDs_ != nullptr )
+    {
+        // Fetch the candidate features directly from memory.
+        while( nMatchingFIDsRead_ < nMatchingFIDCount_ )
+        {
+            OGRFeature* poFeature = OGRMemLayer::GetFeature(
+                panMatchingFIDs_[nMatchingFIDsRead_++]);
+            if( poFeature == nullptr )
+                continue;
+            if( (m_poFilterGeom == nullptr ||
+                FilterGeometry(poFeature->GetGeomFieldRef(m_iGeomFieldFilter)) )
+                && m_poAttrQuery->Evaluate(poFeature) )
+            {
+                return poFeature;
+            }
+            delete poFeature;
+        }
+        return nullptr;
+    }
     else
     {
         return OGRMemLayer::GetNextFeature();
     }
 }
 
+/************************************************************************/
+/*                        ComputeMatchingFIDs()                         */
+/*                                                                      */
+/*      Use the attribute index, if any, to restrict the features       */
+/*      to evaluate against the attribute filter.                       */
+/************************************************************************/
+
+void OGRGeoJSONLayer::ComputeMatchingFIDs()
+{
+    bMatchingFIDsComputed_ = true;
+    if( m_poAttrQuery == nullptr || bUpdated_ ||
+        !m_poAttrQuery->CanUseIndex(this) )
+        return;
+
+    panMatchingFIDs_ = m_poAttrQuery->EvaluateAgainstIndices(this, nullptr);
+    if( panMatchingFIDs_ == nullptr )
+        return;
+
+    // The list is sorted, but may contain duplicates.
+    GIntBig nCount = 0;
+    for( GIntBig i = 0; panMatchingFIDs_[i] != OGRNullFID; i++ )
+    {
+        if( nCount == 0 || panMatchingFIDs_[nCount - 1] != panMatchingFIDs_[i] )
+            panMatchingFIDs_[nCount++] = panMatchingFIDs_[i];
+    }
+    panMatchingFIDs_[nCount] = OGRNullFID;
+    nMatchingFIDCount_ = nCount;
+}
+
 /************************************************************************/
 /*                          GetFeatureCount()                           */
 /************************************************************************/
@@ -45,7 +45,9 @@ CPL_CVSID("$Id$")
 
 static
 OGRGeometry* OGRGeoJSONReadGeometry( json_object* poObj,
-                                     OGRSpatialReference* poParentSRS );
+                                     OGRSpatialReference* poParentSRS,
+                                     const OGRGeoJSONStreamedCoordinates*
+                                                        psCoords = nullptr );
 
 const size_t MAX_OBJECT_SIZE = 100 * 1024 * 1024;
 
@@ -103,7 +105,19 @@ class OGRGeoJSONReaderStreamingParser: public CPLJSonStreamingParser
         std::vector<OGRFeature*> m_apoFeatures;
         size_t m_nCurFeatureIdx;
 
+        // The "coordinates" member of feature geometries is not turned into
+        // a json_object tree: it is skipped in the first pass, and captured
+        // in m_oStreamedCoords in the second one.
+        bool m_bGeometryKey;
+        bool m_bInFeatureGeometry;
+        bool m_bCoordinatesKey;
+        bool m_bInStreamedCoords;
+        int m_nStreamedCoordsDepth;
+        bool m_bHasStreamedCoords;
+        OGRGeoJSONStreamedCoordinates m_oStreamedCoords;
+
         void AppendObject(json_object* poNewObj);
+        void StreamedCoordsToObject();
         void AnalyzeFeature();
         void TooComplex();
 
@@ -267,7 +281,13 @@ OGRGeoJSONReaderStreamingParser::OGRGeoJSONReaderStreamingParser(
                 m_bKeySet(false),
                 m_bNeedFID64(false),
                 m_bStoreNativeData(bStoreNativeData),
-                m_nCurFeatureIdx(0)
+                m_nCurFeatureIdx(0),
+                m_bGeometryKey(false),
+                m_bInFeatureGeometry(false),
+                m_bCoordinatesKey(false),
+                m_bInStreamedCoords(false),
+                m_nStreamedCoordsDepth(0),
+                m_bHasStreamedCoords(false)
 {
 }
 
@@ -338,6 +358,54 @@ void OGRGeoJSONReaderStreamingParser::AppendObject(json_object* poNewObj)
     }
 }
 
+/************************************************************************/
+/*                       StreamedCoordsToObject()                       */
+/************************************************************************/
+
+// Turn the coordinates captured so far into json_object arrays, so that
+// parsing can go on the regular way when an unexpected value (string,
+// null, object...) is met in them.
+void OGRGeoJSONReaderStreamingParser::StreamedCoordsToObject()
+{
+    CPLAssert( m_bInStreamedCoords );
+    CPLAssert(
+        json_object_get_type(m_apoCurObj.back()) == json_type_object );
+
+    const std::vector<char>& achStructure = m_oStreamedCoords.achStructure;
+    const std::vector<double>& adfValues = m_oStreamedCoords.adfValues;
+    json_object* poGeomObj = m_apoCurObj.back();
+    size_t iValue = 0;
+    for( size_t i = 0; i < achStructure.size(); i++ )
+    {
+        if( achStructure[i] == '[' )
+        {
+            json_object* poNewObj = json_object_new_array();
+            if( i == 0 )
+                json_object_object_add( poGeomObj, "coordinates", poNewObj );
+            else
+                json_object_array_add( m_apoCurObj.back(), poNewObj );
+            m_apoCurObj.push_back( poNewObj );
+            m_nCurObjMemEstimate += ESTIMATE_ARRAY_SIZE;
+        }
+        else if( achStructure[i] == ']' )
+        {
+            m_apoCurObj.pop_back();
+        }
+        else
+        {
+            json_object_array_add( m_apoCurObj.back(),
+                        json_object_new_double(adfValues[iValue++]) );
+            m_nCurObjMemEstimate += ESTIMATE_BASE_OBJECT_SIZE +
+                                    ESTIMATE_ARRAY_ELT_SIZE;
+        }
+    }
+
+    m_bInStreamedCoords = false;
+    m_bHasStreamedCoords = false;
+    m_oStreamedCoords.achStructure.clear();
+    m_oStreamedCoords.adfValues.clear();
+}
+
 /************************************************************************/
 /*                          AnalyzeFeature()                            */
 /************************************************************************/
@@ -448,6 +516,21 @@ void OGRGeoJSONReaderStreamingParser::StartObject()
             m_abFirstMember.push_back(true);
         }
 
+        if( m_bInStreamedCoords )
+        {
+            if( m_bFirstPass )
+            {
+                m_nDepth ++;
+                return;
+            }
+            StreamedCoordsToObject();
+        }
+
+        if( m_bGeometryKey && m_nDepth == 3 && m_bInFeaturesArray )
+        {
+            m_bInFeatureGeometry = true;
+        }
+
         m_nCurObjMemEstimate += ESTIMATE_OBJECT_SIZE;
 
         json_object* poNewObj = json_object_new_object();
@@ -505,7 +588,9 @@ void OGRGeoJSONReaderStreamingParser::EndObject()
         else
         {
             OGRFeature* poFeat = m_oReader.ReadFeature(m_poLayer, m_poCurObj,
-                                                       m_osJson.c_str());
+                                                       m_osJson.c_str(),
+                                   m_bHasStreamedCoords ? &m_oStreamedCoords :
+                                                          nullptr);
             if( poFeat )
             {
                 m_apoFeatures.push_back( poFeat );
@@ -520,6 +605,12 @@ void OGRGeoJSONReaderStreamingParser::EndObject()
         m_nTotalOGRFeatureMemEstimate += sizeof(OGRFeature);
         m_osJson.clear();
         m_abFirstMember.clear();
+        m_bGeometryKey = false;
+        m_bInFeatureGeometry = false;
+        m_bCoordinatesKey = false;
+        m_bHasStreamedCoords = false;
+        m_oStreamedCoords.achStructure.clear();
+        m_oStreamedCoords.adfValues.clear();
     }
     else if( m_poCurObj )
     {
@@ -529,7 +620,12 @@ void OGRGeoJSONReaderStreamingParser::EndObject()
             m_osJson += "}";
         }
 
-        m_apoCurObj.pop_back();
+        if( !m_bInStreamedCoords )
+        {
+            m_apoCurObj.pop_back();
+            if( m_bInFeatureGeometry && m_nDepth == 3 )
+                m_bInFeatureGeometry = false;
+        }
     }
     else if( m_nDepth == 1 )
     {
@@ -573,6 +669,18 @@ void OGRGeoJSONReaderStreamingParser::StartObjectMember(const char* pszKey,
     {
         m_bInCoordinates = strcmp(pszKey, "coordinates") == 0 ||
                            strcmp(pszKey, "geometries") == 0;
+        m_bGeometryKey = strcmp(pszKey, "geometry") == 0;
+        if( m_bGeometryKey )
+        {
+            // Only the coordinates of the last geometry member matter.
+            m_bHasStreamedCoords = false;
+            m_oStreamedCoords.achStructure.clear();
+            m_oStreamedCoords.adfValues.clear();
+        }
+    }
+    else if( m_nDepth == 4 && m_bInFeatureGeometry && !m_bInStreamedCoords )
+    {
+        m_bCoordinatesKey = strcmp(pszKey, "coordinates") == 0;
     }
 
     if( m_poCurObj )
@@ -585,6 +693,14 @@ void OGRGeoJSONReaderStreamingParser::StartObjectMember(const char* pszKey,
             m_osJson += CPLJSonStreamingParser::GetSerializedString(pszKey) + ":";
         }
 
+        if( m_bInStreamedCoords )
+        {
+            if( m_bFirstPass )
+                return;
+            // Only reached from an object inside the coordinates, that
+            // has already turned them into json_object.
+        }
+
         m_nCurObjMemEstimate += ESTIMATE_OBJECT_ELT_SIZE;
         m_osCurKey.assign(pszKey, nKeyLen);
         m_bKeySet = true;
@@ -615,11 +731,36 @@ void OGRGeoJSONReaderStreamingParser::StartArray()
             m_abFirstMember.push_back(true);
         }
 
-        m_nCurObjMemEstimate += ESTIMATE_ARRAY_SIZE;
+        if( !m_bInStreamedCoords && m_bCoordinatesKey &&
+            m_bInFeatureGeometry && m_nDepth == 4 )
+        {
+            // Start of the "coordinates" member of the feature geometry.
+            m_bInStreamedCoords = true;
+            m_nStreamedCoordsDepth = m_nDepth;
+            m_bCoordinatesKey = false;
+            m_bHasStreamedCoords = false;
+            m_oStreamedCoords.achStructure.clear();
+            m_oStreamedCoords.adfValues.clear();
+            m_osCurKey.clear();
+            m_bKeySet = false;
+        }
 
-        json_object* poNewObj = json_object_new_array();
-        AppendObject(poNewObj);
-        m_apoCurObj.push_back( poNewObj );
+        if( m_bInStreamedCoords )
+        {
+            if( !m_bFirstPass )
+            {
+                m_oStreamedCoords.achStructure.push_back('[');
+                m_nCurObjMemEstimate += 1;
+            }
+        }
+        else
+        {
+            m_nCurObjMemEstimate += ESTIMATE_ARRAY_SIZE;
+
+            json_object* poNewObj = json_object_new_array();
+            AppendObject(poNewObj);
+            m_apoCurObj.push_back( poNewObj );
+        }
     }
     m_nDepth ++;
 }
@@ -632,7 +773,8 @@ void OGRGeoJSONReaderStreamingParser::StartArrayMember()
 {
     if( m_poCurObj )
     {
-        m_nCurObjMemEstimate += ESTIMATE_ARRAY_ELT_SIZE;
+        if( !m_bInStreamedCoords )
+            m_nCurObjMemEstimate += ESTIMATE_ARRAY_ELT_SIZE;
 
         if( m_bInFeaturesArray && m_bStoreNativeData && m_nDepth >= 3 )
         {
@@ -668,7 +810,20 @@ void OGRGeoJSONReaderStreamingParser::EndArray()
             m_osJson += "]";
         }
 
-        m_apoCurObj.pop_back();
+        if( m_bInStreamedCoords )
+        {
+            if( !m_bFirstPass )
+                m_oStreamedCoords.achStructure.push_back(']');
+            if( m_nDepth == m_nStreamedCoordsDepth )
+            {
+                m_bInStreamedCoords = false;
+                m_bHasStreamedCoords = !m_bFirstPass;
+            }
+        }
+        else
+        {
+            m_apoCurObj.pop_back();
+        }
     }
 }
 
@@ -703,6 +858,12 @@ void OGRGeoJSONReaderStreamingParser::String(const char* pszValue, size_t nLen)
         {
             m_osJson += CPLJSonStreamingParser::GetSerializedString(pszValue);
         }
+        if( m_bInStreamedCoords )
+        {
+            if( m_bFirstPass )
+                return;
+            StreamedCoordsToObject();
+        }
         AppendObject(json_object_new_string(pszValue));
     }
 }
@@ -725,20 +886,30 @@ void OGRGeoJSONReaderStreamingParser::Number(const char* pszValue, size_t nLen)
         {
             if( m_bInFeaturesArray )
             {
-                if( m_bInCoordinates )
+                if( m_bInCoordinates || m_bInStreamedCoords )
                     m_nTotalOGRFeatureMemEstimate += sizeof(double);
                 else
                     m_nTotalOGRFeatureMemEstimate += sizeof(OGRField);
             }
 
-            m_nCurObjMemEstimate += ESTIMATE_BASE_OBJECT_SIZE;
+            if( !m_bInStreamedCoords )
+                m_nCurObjMemEstimate += ESTIMATE_BASE_OBJECT_SIZE;
         }
         if( m_bInFeaturesArray && m_bStoreNativeData && m_nDepth >= 3 )
         {
             m_osJson.append(pszValue, nLen);
         }
 
-        if( CPLGetValueType(pszValue) == CPL_VALUE_REAL )
+        if( m_bInStreamedCoords )
+        {
+            if( !m_bFirstPass )
+            {
+                m_oStreamedCoords.achStructure.push_back('n');
+                m_oStreamedCoords.adfValues.push_back(CPLAtof(pszValue));
+                m_nCurObjMemEstimate += 1 + sizeof(double);
+            }
+        }
+        else if( CPLGetValueType(pszValue) == CPL_VALUE_REAL )
         {
             AppendObject(json_object_new_double(CPLAtof(pszValue)));
         }
@@ -774,6 +945,12 @@ void OGRGeoJSONReaderStreamingParser::Boolean(bool bVal)
         {
             m_osJson += bVal ? "true": "false";
         }
+        if( m_bInStreamedCoords )
+        {
+            if( m_bFirstPass )
+                return;
+            StreamedCoordsToObject();
+        }
 
         AppendObject( json_object_new_boolean(bVal) );
     }
@@ -797,6 +974,12 @@ void OGRGeoJSONReaderStreamingParser::Null()
         {
             m_osJson += "null";
         }
+        if( m_bInStreamedCoords )
+        {
+            if( m_bFirstPass )
+                return;
+            StreamedCoordsToObject();
+        }
 
         m_nCurObjMemEstimate += ESTIMATE_BASE_OBJECT_SIZE;
         AppendObject( nullptr );
@@ -2073,9 +2256,11 @@ bool OGRGeoJSONReader::AddFeature( OGRGeoJSONLayer* poLayer,
 /************************************************************************/
 
 OGRGeometry* OGRGeoJSONReader::ReadGeometry( json_object* poObj,
-                                             OGRSpatialReference* poLayerSRS )
+                                             OGRSpatialReference* poLayerSRS,
+                                const OGRGeoJSONStreamedCoordinates* psCoords )
 {
-    OGRGeometry* poGeometry = OGRGeoJSONReadGeometry( poObj, poLayerSRS );
+    OGRGeometry* poGeometry =
+        OGRGeoJSONReadGeometry( poObj, poLayerSRS, psCoords );
 
 /* -------------------------------------------------------------------- */
 /*      Wrap geometry with GeometryCollection as a common denominator.  */
@@ -2289,7 +2474,8 @@ void OGRGeoJSONReaderSetField( OGRLayer* poLayer,
 
 OGRFeature* OGRGeoJSONReader::ReadFeature( OGRGeoJSONLayer* poLayer,
                                            json_object* poObj,
-                                           const char* pszSerializedObj )
+                                           const char* pszSerializedObj,
+                                const OGRGeoJSONStreamedCoordinates* psCoords )
 {
     CPLAssert( nullptr != poObj );
 
@@ -2425,7 +2611,8 @@ OGRFeature* OGRGeoJSONReader::ReadFeature( OGRGeoJSONLayer* poLayer,
         //       then NULL geometry is assigned to a feature and
         //       geometry type for layer is classified as wkbUnknown.
         OGRGeometry* poGeometry = ReadGeometry( poObjGeom,
-                                                poLayer->GetSpatialRef() );
+                                                poLayer->GetSpatialRef(),
+                                                psCoords );
         if( nullptr != poGeometry )
         {
             poFeature->SetGeometryDirectly( poGeometry );
@@ -2596,6 +2783,337 @@ GeoJSONObject::Type OGRGeoJSONGetType( json_object* poObj )
         return GeoJSONObject::eUnknown;
 }
 
+/************************************************************************/
+/*                       SkipStreamedCoordinates()                      */
+/************************************************************************/
+
+// Skip the number or array at the current position of the coordinates
+// captured by the streaming parser.
+static void SkipStreamedCoordinates( const OGRGeoJSONStreamedCoordinates& oCoords,
+                                     size_t& iStruct, size_t& iValue )
+{
+    const std::vector<char>& achStructure = oCoords.achStructure;
+    int nDepth = 0;
+    do
+    {
+        if( achStructure[iStruct] == '[' )
+            nDepth ++;
+        else if( achStructure[iStruct] == ']' )
+            nDepth --;
+        else
+            iValue ++;
+        iStruct ++;
+    } while( nDepth > 0 && iStruct < achStructure.size() );
+}
+
+/************************************************************************/
+/*                      CountStreamedCoordinates()                      */
+/************************************************************************/
+
+// Return the number of elements of the array at the current position.
+static int CountStreamedCoordinates( const OGRGeoJSONStreamedCoordinates& oCoords,
+                                     size_t iStruct )
+{
+    const std::vector<char>& achStructure = oCoords.achStructure;
+    int nDepth = 0;
+    int nCount = 0;
+    for( ++iStruct; iStruct < achStructure.size(); ++iStruct )
+    {
+        if( nDepth == 0 && achStructure[iStruct] != ']' )
+            nCount ++;
+        if( achStructure[iStruct] == '[' )
+            nDepth ++;
+        else if( achStructure[iStruct] == ']' )
+        {
+            if( nDepth == 0 )
+                break;
+            nDepth --;
+        }
+    }
+    return nCount;
+}
+
+/************************************************************************/
+/*                    SerializeStreamedCoordinates()                    */
+/************************************************************************/
+
+// Serialize the array at the current position the way json-c does, for
+// error messages.
+static CPLString SerializeStreamedCoordinates(
+    const OGRGeoJSONStreamedCoordinates& oCoords,
+    size_t iStruct, size_t iValue )
+{
+    const std::vector<char>& achStructure = oCoords.achStructure;
+    CPLString osRet;
+    int nDepth = 0;
+    bool bFirst = true;
+    do
+    {
+        if( achStructure[iStruct] == ']' )
+        {
+            osRet += bFirst ? "]" : " ]";
+            nDepth --;
+            bFirst = false;
+        }
+        else
+        {
+            if( !bFirst )
+                osRet += ",";
+            osRet += " ";
+            if( achStructure[iStruct] == '[' )
+            {
+                osRet += "[";
+                nDepth ++;
+                bFirst = true;
+            }
+            else
+            {
+                osRet += CPLSPrintf("%.15g", oCoords.adfValues[iValue]);
+                iValue ++;
+                bFirst = false;
+            }
+        }
+        iStruct ++;
+    } while( nDepth > 0 && iStruct < achStructure.size() );
+    return osRet.substr(1);
+}
+
+/************************************************************************/
+/*                      OGRGeoJSONReadStreamedRawPoint()                */
+/************************************************************************/
+
+static bool OGRGeoJSONReadStreamedRawPoint(
+    const OGRGeoJSONStreamedCoordinates& oCoords,
+    size_t& iStruct, size_t& iValue, OGRPoint& point )
+{
+    const std::vector<char>& achStructure = oCoords.achStructure;
+    if( achStructure[iStruct] != '[' )
+    {
+        SkipStreamedCoordinates(oCoords, iStruct, iValue);
+        return false;
+    }
+    iStruct ++;
+
+    const char* const apszCoordName[] = { "x", "y", "z" };
+    double adfCoord[3] = { 0.0, 0.0, 0.0 };
+    int nSize = 0;
+    bool bValid = true;
+    while( iStruct < achStructure.size() && achStructure[iStruct] != ']' )
+    {
+        if( achStructure[iStruct] == 'n' )
+        {
+            if( nSize < 3 )
+                adfCoord[nSize] = oCoords.adfValues[iValue];
+            iStruct ++;
+            iValue ++;
+        }
+        else
+        {
+            if( nSize < 3 )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "Invalid '%s' coordinate. "
+                          "Type is not double or integer for \'%s\'.",
+                          apszCoordName[nSize],
+                          SerializeStreamedCoordinates(
+                              oCoords, iStruct, iValue).c_str() );
+                bValid = false;
+            }
+            SkipStreamedCoordinates(oCoords, iStruct, iValue);
+        }
+        nSize ++;
+    }
+    iStruct ++;
+
+    if( nSize < GeoJSONObject::eMinCoordinateDimension )
+    {
+        CPLDebug( "GeoJSON",
+                  "Invalid coord dimension. "
+                  "At least 2 dimensions must be present." );
+        return false;
+    }
+
+    point.setX(adfCoord[0]);
+    point.setY(adfCoord[1]);
+    if( nSize >= GeoJSONObject::eMaxCoordinateDimension )
+        point.setZ(adfCoord[2]);
+    else
+        point.flattenTo2D();
+    return bValid;
+}
+
+/************************************************************************/
+/*                    OGRGeoJSONReadStreamedLineString()                */
+/************************************************************************/
+
+static OGRLineString* OGRGeoJSONReadStreamedLineString(
+    const OGRGeoJSONStreamedCoordinates& oCoords,
+    size_t& iStruct, size_t& iValue, bool bRing )
+{
+    if( oCoords.achStructure[iStruct] != '[' )
+    {
+        SkipStreamedCoordinates(oCoords, iStruct, iValue);
+        return nullptr;
+    }
+
+    const size_t iStructStart = iStruct;
+    const size_t iValueStart = iValue;
+    const int nPoints = CountStreamedCoordinates(oCoords, iStruct);
+    OGRLineString* poLine = bRing ? new OGRLinearRing() : new OGRLineString();
+    poLine->setNumPoints( nPoints );
+
+    iStruct ++;
+    for( int i = 0; i < nPoints; ++i )
+    {
+        OGRPoint pt;
+        if( !OGRGeoJSONReadStreamedRawPoint( oCoords, iStruct, iValue, pt ) )
+        {
+            delete poLine;
+            CPLDebug( "GeoJSON", bRing ?
+                      "LinearRing: raw point parsing failure." :
+                      "LineString: raw point parsing failure." );
+            iStruct = iStructStart;
+            iValue = iValueStart;
+            SkipStreamedCoordinates(oCoords, iStruct, iValue);
+            return nullptr;
+        }
+        if( pt.getCoordinateDimension() == 2 )
+            poLine->setPoint( i, pt.getX(), pt.getY());
+        else
+            poLine->setPoint( i, pt.getX(), pt.getY(), pt.getZ() );
+    }
+    iStruct ++;
+
+    return poLine;
+}
+
+/************************************************************************/
+/*                     OGRGeoJSONReadStreamedPolygon()                  */
+/************************************************************************/
+
+static OGRPolygon* OGRGeoJSONReadStreamedPolygon(
+    const OGRGeoJSONStreamedCoordinates& oCoords,
+    size_t& iStruct, size_t& iValue )
+{
+    if( oCoords.achStructure[iStruct] != '[' )
+    {
+        SkipStreamedCoordinates(oCoords, iStruct, iValue);
+        return nullptr;
+    }
+
+    const int nRings = CountStreamedCoordinates(oCoords, iStruct);
+    iStruct ++;
+
+    OGRPolygon* poPolygon = nullptr;
+    for( int i = 0; i < nRings; ++i )
+    {
+        if( i > 0 && poPolygon == nullptr )
+        {
+            SkipStreamedCoordinates(oCoords, iStruct, iValue);
+            continue;
+        }
+        OGRLinearRing* poRing = static_cast<OGRLinearRing*>(
+            OGRGeoJSONReadStreamedLineString(oCoords, iStruct, iValue, true));
+        if( poRing != nullptr )
+        {
+            if( poPolygon == nullptr )
+                poPolygon = new OGRPolygon();
+            poPolygon->addRingDirectly( poRing );
+        }
+    }
+    iStruct ++;
+
+    return poPolygon;
+}
+
+/************************************************************************/
+/*                    OGRGeoJSONReadStreamedGeometry()                  */
+/************************************************************************/
+
+// Build a geometry of the given type from the "coordinates" member captured
+// by the streaming parser. This is the counterpart of OGRGeoJSONReadPoint(),
+// OGRGeoJSONReadLineString(), etc. for json_object trees.
+static OGRGeometry* OGRGeoJSONReadStreamedGeometry(
+    GeoJSONObject::Type objType,
+    const OGRGeoJSONStreamedCoordinates& oCoords )
+{
+    if( oCoords.achStructure.empty() )
+        return nullptr;
+
+    size_t iStruct = 0;
+    size_t iValue = 0;
+
+    if( GeoJSONObject::ePoint == objType )
+    {
+        OGRPoint* poPoint = new OGRPoint();
+        if( !OGRGeoJSONReadStreamedRawPoint( oCoords, iStruct, iValue,
+                                             *poPoint ) )
+        {
+            CPLDebug( "GeoJSON", "Point: raw point parsing failure." );
+            delete poPoint;
+            return nullptr;
+        }
+        return poPoint;
+    }
+
+    if( GeoJSONObject::eLineString == objType )
+    {
+        return OGRGeoJSONReadStreamedLineString( oCoords, iStruct, iValue,
+                                                 false );
+    }
+
+    if( GeoJSONObject::ePolygon == objType )
+    {
+        return OGRGeoJSONReadStreamedPolygon( oCoords, iStruct, iValue );
+    }
+
+    const int nParts = CountStreamedCoordinates(oCoords, iStruct);
+    iStruct ++;
+
+    if( GeoJSONObject::eMultiPoint == objType )
+    {
+        OGRMultiPoint* poMultiPoint = new OGRMultiPoint();
+        for( int i = 0; i < nParts; ++i )
+        {
+            OGRPoint pt;
+            if( !OGRGeoJSONReadStreamedRawPoint( oCoords, iStruct, iValue,
+                                                 pt ) )
+            {
+                delete poMultiPoint;
+                CPLDebug( "GeoJSON",
+                          "LineString: raw point parsing failure." );
+                return nullptr;
+            }
+            poMultiPoint->addGeometry( &pt );
+        }
+        return poMultiPoint;
+    }
+
+    if( GeoJSONObject::eMultiLineString == objType )
+    {
+        OGRMultiLineString* poMultiLine = new OGRMultiLineString();
+        for( int i = 0; i < nParts; ++i )
+        {
+            OGRLineString* poLine = OGRGeoJSONReadStreamedLineString(
+                oCoords, iStruct, iValue, false );
+            if( nullptr != poLine )
+                poMultiLine->addGeometryDirectly( poLine );
+        }
+        return poMultiLine;
+    }
+
+    CPLAssert( GeoJSONObject::eMultiPolygon == objType );
+    OGRMultiPolygon* poMultiPoly = new OGRMultiPolygon();
+    for( int i = 0; i < nParts; ++i )
+    {
+        OGRPolygon* poPoly =
+            OGRGeoJSONReadStreamedPolygon( oCoords, iStruct, iValue );
+        if( nullptr != poPoly )
+            poMultiPoly->addGeometryDirectly( poPoly );
+    }
+    return poMultiPoly;
+}
+
 /************************************************************************/
 /*                           OGRGeoJSONReadGeometry                     */
 /************************************************************************/
@@ -2607,7 +3125,9 @@ OGRGeometry* OGRGeoJSONReadGeometry( json_object* poObj )
 
 static
 OGRGeometry* OGRGeoJSONReadGeometry( json_object* poObj,
-                                     OGRSpatialReference* poParentSRS )
+                                     OGRSpatialReference* poParentSRS,
+                                     const OGRGeoJSONStreamedCoordinates*
+                                                                psCoords )
 {
 
     OGRGeometry* poGeometry = nullptr;
@@ -2638,7 +3158,10 @@ OGRGeometry* OGRGeoJSONReadGeometry( json_object* poObj,
     }
 
     GeoJSONObject::Type objType = OGRGeoJSONGetType( poObj );
-    if( GeoJSONObject::ePoint == objType )
+    if( psCoords != nullptr && objType >= GeoJSONObject::ePoint &&
+        objType <= GeoJSONObject::eMultiPolygon )
+        poGeometry = OGRGeoJSONReadStreamedGeometry( objType, *psCoords );
+    else if( GeoJSONObject::ePoint == objType )
         poGeometry = OGRGeoJSONReadPoint( poObj );
     else if( GeoJSONObject::eMultiPoint == objType )
         poGeometry = OGRGeoJSONReadMultiPoint( poObj );
@@ -38,6 +38,7 @@
 #include "ogrgeojsonutils.h"
 
 #include <set>
+#include <vector>
 
 /************************************************************************/
 /*                         FORWARD DECLARATIONS                         */
@@ -91,6 +92,15 @@ struct GeoJSONObject
 class OGRGeoJSONDataSource;
 class OGRGeoJSONReaderStreamingParser;
 
+/* Compact copy of the "coordinates" member of a feature geometry, as */
+/* captured by the streaming parser instead of a json_object tree. */
+struct OGRGeoJSONStreamedCoordinates
+{
+    /* Sequence of '[' (array start), ']' (array end) and 'n' (number) */
+    std::vector<char>   achStructure;
+    std::vector<double> adfValues;
+};
+
 class OGRGeoJSONReader
 {
   public:
@@ -170,9 +180,11 @@ class OGRGeoJSONReader
     static bool AddFeature( OGRGeoJSONLayer* poLayer, OGRGeometry* poGeometry );
     static bool AddFeature( OGRGeoJSONLayer* poLayer, OGRFeature* poFeature );
 
-    OGRGeometry* ReadGeometry( json_object* poObj, OGRSpatialReference* poLayerSRS );
+    OGRGeometry* ReadGeometry( json_object* poObj, OGRSpatialReference* poLayerSRS,
+                               const OGRGeoJSONStreamedCoordinates* psCoords = nullptr );
     OGRFeature* ReadFeature( OGRGeoJSONLayer* poLayer, json_object* poObj,
-                             const char* pszSerializedObj );
+                             const char* pszSerializedObj,
+                             const OGRGeoJSONStreamedCoordinates* psCoords = nullptr );
     void ReadFeatureCollection( OGRGeoJSONLayer* poLayer, json_object* poObj );
     size_t SkipPrologEpilogAndUpdateJSonPLikeWrapper( size_t nRead );
 };
@@ -31,7 +31,10 @@
 #include "gdal_alg_priv.h"
 
 #include <algorithm>
+#include <climits>
 #include <limits>
+#include <map>
+#include <vector>
 
 CPL_CVSID("$Id$")
 
@@ -77,6 +80,8 @@ GDALGPKGMBTilesLikePseudoDataset::GDALGPKGMBTilesLikePseudoDataset() :
     m_nAge(0),
     m_nTileInsertionCount(0),
     m_poParentDS(nullptr),
+    m_nNumThreads(-1),
+    m_poThreadPool(nullptr),
     m_bInWriteTile(false)
 {
     for( int i = 0; i < 4; i++ )
@@ -109,6 +114,7 @@ GDALGPKGMBTilesLikePseudoDataset::~GDALGPKGMBTilesLikePseudoDataset()
             CPLFree(m_pMyVFS);
         }
     }
+    delete m_poThreadPool;
     CPLFree(m_pabyCachedTiles);
     delete m_poCT;
     CPLFree(m_pabyHugeColorArray);
@@ -1005,6 +1011,278 @@ GByte* GDALGPKGMBTilesLikePseudoDataset::ReadTile( int nRow, int nCol, GByte *pa
     return pabyData;
 }
 
+/************************************************************************/
+/*                           GetNumThreads()                            */
+/************************************************************************/
+
+// Worker threads used to decode tiles, from the GDAL_NUM_THREADS
+// configuration option
+int GDALGPKGMBTilesLikePseudoDataset::GetNumThreads()
+{
+    if( m_poParentDS != nullptr )
+        return m_poParentDS->GetNumThreads();
+    if( m_nNumThreads < 0 )
+    {
+        const char* pszVal = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+        m_nNumThreads = 1;
+        if( pszVal )
+            m_nNumThreads = std::max(1, std::min(128,
+                EQUAL(pszVal, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(pszVal)));
+    }
+    return m_nNumThreads;
+}
+
+/************************************************************************/
+/*                           GetThreadPool()                            */
+/************************************************************************/
+
+// The pool is shared by the overview datasets
+CPLWorkerThreadPool* GDALGPKGMBTilesLikePseudoDataset::GetThreadPool()
+{
+    if( m_poParentDS != nullptr )
+        return m_poParentDS->GetThreadPool();
+    if( m_poThreadPool == nullptr && GetNumThreads() > 1 )
+    {
+        CPLDebug("GPKG", "Using %d threads", m_nNumThreads);
+        m_poThreadPool = new CPLWorkerThreadPool();
+        if( !m_poThreadPool->Setup(m_nNumThreads, nullptr, nullptr) )
+        {
+            delete m_poThreadPool;
+            m_poThreadPool = nullptr;
+            m_nNumThreads = 1;
+        }
+    }
+    return m_poThreadPool;
+}
+
+/************************************************************************/
+/*                           PrefetchTiles()                            */
+/************************************************************************/
+
+namespace {
+struct GPKGTileDecodeJob
+{
+    GDALGPKGMBTilesLikePseudoDataset* poDS = nullptr;
+    int                 nBlockXOff = 0;
+    int                 nBlockYOff = 0;
+    GIntBig             nTileId = 0;
+    double              dfTileOffset = 0.0;
+    double              dfTileScale = 1.0;
+    bool                bHasData = false;
+    std::vector<GByte>  abyRawData{};
+    std::vector<GByte>  abyTileData{};
+    CPLErr              eErr = CE_None;
+};
+}
+
+static void GPKGDecodeTileJob(void* pData)
+{
+    GPKGTileDecodeJob* psJob = static_cast<GPKGTileDecodeJob*>(pData);
+    CPLString osMemFileName;
+    osMemFileName.Printf("/vsimem/gpkg_prefetch_tile_%p", psJob);
+    VSILFILE * fp = VSIFileFromMemBuffer(
+        osMemFileName.c_str(), &psJob->abyRawData[0],
+        psJob->abyRawData.size(), FALSE );
+    VSIFCloseL(fp);
+    psJob->eErr = psJob->poDS->ReadTile(osMemFileName, &psJob->abyTileData[0],
+                                        psJob->dfTileOffset,
+                                        psJob->dfTileScale);
+    VSIUnlink(osMemFileName);
+}
+
+// Loads in the block cache the blocks of a RasterIO() request that are not
+// there yet: the tiles are fetched with a single SELECT on a range of
+// tile_column/tile_row, and decoded in parallel if GDAL_NUM_THREADS is set.
+// Only done for read-only datasets whose blocks are aligned on tiles.
+// Anything not prefetched is left to IReadBlock().
+void GDALGPKGMBTilesLikePseudoDataset::PrefetchTiles(int nXOff, int nYOff,
+                                                     int nXSize, int nYSize,
+                                                     int nBufXSize,
+                                                     int nBufYSize)
+{
+    if( IGetUpdate() || m_nShiftXPixelsMod != 0 || m_nShiftYPixelsMod != 0 ||
+        nXSize <= 0 || nYSize <= 0 )
+        return;
+    // Sub-sampled requests are likely to be served by an overview
+    if( (nBufXSize < nXSize || nBufYSize < nYSize) &&
+        IGetRasterBand(1)->GetOverviewCount() > 0 )
+        return;
+
+    const int nBands = IGetRasterCount();
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    IGetRasterBand(1)->GetBlockSize(&nBlockXSize, &nBlockYSize);
+    const size_t nBandBlockSize =
+        static_cast<size_t>(nBlockXSize) * nBlockYSize * m_nDTSize;
+    const int nBlockXOff0 = nXOff / nBlockXSize;
+    const int nBlockYOff0 = nYOff / nBlockYSize;
+    const int nBlockXOff1 = (nXOff + nXSize - 1) / nBlockXSize;
+    const int nBlockYOff1 = (nYOff + nYSize - 1) / nBlockYSize;
+
+    // Do not load more than half of the block cache
+    const GIntBig nMaxBlocks = GDALGetCacheMax64() / 2 /
+        static_cast<GIntBig>(nBandBlockSize * nBands);
+
+    std::vector<GPKGTileDecodeJob> asJobs;
+    std::map<std::pair<int, int>, size_t> oMapTileToJob;
+    int nRowMin = INT_MAX;
+    int nRowMax = -1;
+    int nColMin = INT_MAX;
+    int nColMax = -1;
+    for( int nBlockYOff = nBlockYOff0; nBlockYOff <= nBlockYOff1; nBlockYOff++ )
+    {
+        for( int nBlockXOff = nBlockXOff0;
+             nBlockXOff <= nBlockXOff1 &&
+             static_cast<GIntBig>(asJobs.size()) < nMaxBlocks; nBlockXOff++ )
+        {
+            bool bMissing = false;
+            for( int iBand = 1; iBand <= nBands && !bMissing; iBand++ )
+            {
+                GDALGPKGMBTilesLikeRasterBand* poBand =
+                    reinterpret_cast<GDALGPKGMBTilesLikeRasterBand*>(
+                        IGetRasterBand(iBand));
+                GDALRasterBlock* poBlock =
+                    poBand->AccessibleTryGetLockedBlockRef(nBlockXOff,
+                                                           nBlockYOff);
+                if( poBlock )
+                    poBlock->DropLock();
+                else
+                    bMissing = true;
+            }
+            if( !bMissing )
+                continue;
+            const int nRow = nBlockYOff + m_nShiftYTiles;
+            const int nCol = nBlockXOff + m_nShiftXTiles;
+            GPKGTileDecodeJob sJob;
+            sJob.poDS = this;
+            sJob.nBlockXOff = nBlockXOff;
+            sJob.nBlockYOff = nBlockYOff;
+            if( nRow >= 0 && nCol >= 0 && nRow < m_nTileMatrixHeight &&
+                nCol < m_nTileMatrixWidth )
+            {
+                oMapTileToJob[std::pair<int, int>(nRow, nCol)] = asJobs.size();
+                nRowMin = std::min(nRowMin, nRow);
+                nRowMax = std::max(nRowMax, nRow);
+                nColMin = std::min(nColMin, nCol);
+                nColMax = std::max(nColMax, nCol);
+            }
+            asJobs.push_back(sJob);
+        }
+    }
+    if( asJobs.size() < 2 )
+        return;
+
+    if( !oMapTileToJob.empty() )
+    {
+        const int nRow1 = GetRowFromIntoTopConvention(nRowMin);
+        const int nRow2 = GetRowFromIntoTopConvention(nRowMax);
+        char *pszSQL = sqlite3_mprintf( "SELECT tile_row, tile_column, "
+            "tile_data%s FROM \"%w\" WHERE zoom_level = %d AND "
+            "tile_row BETWEEN %d AND %d AND tile_column BETWEEN %d AND %d%s",
+            m_eDT != GDT_Byte ? ", id" : "", // MBTiles do not have an id
+            m_osRasterTable.c_str(), m_nZoomLevel,
+            std::min(nRow1, nRow2), std::max(nRow1, nRow2), nColMin, nColMax,
+            !m_osWHERE.empty() ? CPLSPrintf(" AND (%s)", m_osWHERE.c_str()): "");
+#ifdef DEBUG_VERBOSE
+        CPLDebug("GPKG", "%s", pszSQL);
+#endif
+        sqlite3_stmt *hStmt = nullptr;
+        int rc = sqlite3_prepare_v2( IGetDB(), pszSQL, -1, &hStmt, nullptr );
+        sqlite3_free(pszSQL);
+        if( rc != SQLITE_OK )
+            return;
+        while( sqlite3_step(hStmt) == SQLITE_ROW )
+        {
+            if( sqlite3_column_type( hStmt, 2 ) != SQLITE_BLOB )
+                continue;
+            const int nRow =
+                GetRowFromIntoTopConvention(sqlite3_column_int(hStmt, 0));
+            const int nCol = sqlite3_column_int(hStmt, 1);
+            std::map<std::pair<int, int>, size_t>::iterator oIter =
+                oMapTileToJob.find(std::pair<int, int>(nRow, nCol));
+            if( oIter == oMapTileToJob.end() )
+                continue;
+            GPKGTileDecodeJob& sJob = asJobs[oIter->second];
+            if( sJob.bHasData )
+                continue;
+            const GByte* pabyRawData = static_cast<const GByte*>(
+                sqlite3_column_blob(hStmt, 2));
+            sJob.abyRawData.assign(pabyRawData,
+                                   pabyRawData + sqlite3_column_bytes(hStmt, 2));
+            sJob.nTileId = (m_eDT == GDT_Byte) ? 0 : sqlite3_column_int64(hStmt, 3);
+            sJob.bHasData = true;
+        }
+        sqlite3_finalize(hStmt);
+    }
+
+    for( size_t i = 0; i < asJobs.size(); i++ )
+    {
+        if( asJobs[i].bHasData )
+            GetTileOffsetAndScale(asJobs[i].nTileId,
+                                  asJobs[i].dfTileOffset,
+                                  asJobs[i].dfTileScale);
+    }
+
+    // Establish the color table now, as ReadTile() would do it lazily
+    IGetRasterBand(1)->GetColorTable();
+
+    CPLWorkerThreadPool* poPool = GetThreadPool();
+    const size_t nBatchSize =
+        static_cast<size_t>(std::max(1, GetNumThreads()) * 4);
+    for( size_t iStart = 0; iStart < asJobs.size(); iStart += nBatchSize )
+    {
+        const size_t iEnd = std::min(asJobs.size(), iStart + nBatchSize);
+        std::vector<void*> apJobs;
+        for( size_t i = iStart; i < iEnd; i++ )
+        {
+            GPKGTileDecodeJob& sJob = asJobs[i];
+            sJob.abyTileData.resize(nBands * nBandBlockSize);
+            if( !sJob.bHasData )
+                FillEmptyTile(&sJob.abyTileData[0]);
+            else if( poPool )
+                apJobs.push_back(&sJob);
+            else
+                GPKGDecodeTileJob(&sJob);
+        }
+        if( !apJobs.empty() )
+        {
+            poPool->SubmitJobs(GPKGDecodeTileJob, apJobs);
+            poPool->WaitCompletion();
+        }
+
+        for( size_t i = iStart; i < iEnd; i++ )
+        {
+            GPKGTileDecodeJob& sJob = asJobs[i];
+            // Let IReadBlock() report the error in the calling thread
+            if( sJob.eErr == CE_None )
+            {
+                for( int iBand = 1; iBand <= nBands; iBand++ )
+                {
+                    GDALGPKGMBTilesLikeRasterBand* poBand =
+                        reinterpret_cast<GDALGPKGMBTilesLikeRasterBand*>(
+                            IGetRasterBand(iBand));
+                    GDALRasterBlock* poBlock =
+                        poBand->AccessibleTryGetLockedBlockRef(
+                            sJob.nBlockXOff, sJob.nBlockYOff);
+                    if( poBlock == nullptr )
+                    {
+                        poBlock = poBand->GetLockedBlockRef(
+                            sJob.nBlockXOff, sJob.nBlockYOff, TRUE);
+                        if( poBlock == nullptr )
+                            continue;
+                        memcpy(poBlock->GetDataRef(),
+                               &sJob.abyTileData[(iBand - 1) * nBandBlockSize],
+                               nBandBlockSize);
+                    }
+                    poBlock->DropLock();
+                }
+            }
+            std::vector<GByte>().swap(sJob.abyTileData);
+            std::vector<GByte>().swap(sJob.abyRawData);
+        }
+    }
+}
+
 /************************************************************************/
 /*                         IReadBlock()                                 */
 /************************************************************************/
@@ -1218,6 +1496,28 @@ retry:
     return CE_None;
 }
 
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr GDALGPKGMBTilesLikeRasterBand::IRasterIO( GDALRWFlag eRWFlag,
+                                                 int nXOff, int nYOff,
+                                                 int nXSize, int nYSize,
+                                                 void * pData,
+                                                 int nBufXSize, int nBufYSize,
+                                                 GDALDataType eBufType,
+                                                 GSpacing nPixelSpace,
+                                                 GSpacing nLineSpace,
+                                                 GDALRasterIOExtraArg* psExtraArg )
+{
+    if( eRWFlag == GF_Read )
+        m_poTPD->PrefetchTiles(nXOff, nYOff, nXSize, nYSize,
+                               nBufXSize, nBufYSize);
+    return GDALPamRasterBand::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                        pData, nBufXSize, nBufYSize, eBufType,
+                                        nPixelSpace, nLineSpace, psExtraArg);
+}
+
 /************************************************************************/
 /*                       WEBPSupports4Bands()                           */
 /************************************************************************/
@@ -31,6 +31,7 @@
 #define GPKGMBTILESCOMMON_H_INCLUDED
 
 #include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal_pam.h"
 #include "ogr_sqlite.h" // for sqlite3*
 
@@ -104,6 +105,9 @@ class GDALGPKGMBTilesLikePseudoDataset
 
     GDALGPKGMBTilesLikePseudoDataset* m_poParentDS;
 
+    int                 m_nNumThreads;
+    CPLWorkerThreadPool* m_poThreadPool;
+
   private:
         bool                    m_bInWriteTile;
         CPLErr                  WriteTileInternal(); /* should only be called by WriteTile() */
@@ -116,6 +120,8 @@ class GDALGPKGMBTilesLikePseudoDataset
         void                    FillBuffer(GByte* pabyData, size_t nPixels);
         void                    FillEmptyTile(GByte* pabyData);
         void                    FillEmptyTileSingleBand(GByte* pabyData);
+        int                     GetNumThreads();
+        CPLWorkerThreadPool*    GetThreadPool();
 
   public:
                                 GDALGPKGMBTilesLikePseudoDataset();
@@ -134,6 +140,10 @@ class GDALGPKGMBTilesLikePseudoDataset
         GByte*                  ReadTile(int nRow, int nCol, GByte* pabyData,
                                          bool* pbIsLossyFormat = nullptr);
 
+        void                    PrefetchTiles(int nXOff, int nYOff,
+                                              int nXSize, int nYSize,
+                                              int nBufXSize, int nBufYSize);
+
         CPLErr                  WriteTile();
 
         CPLErr                  FlushTiles();
@@ -171,6 +181,15 @@ class GDALGPKGMBTilesLikeRasterBand: public GDALPamRasterBand
                                            void* pData) override;
         virtual CPLErr          IWriteBlock(int nBlockXOff, int nBlockYOff,
                                            void* pData) override;
+        virtual CPLErr          IRasterIO( GDALRWFlag eRWFlag,
+                                           int nXOff, int nYOff,
+                                           int nXSize, int nYSize,
+                                           void * pData,
+                                           int nBufXSize, int nBufYSize,
+                                           GDALDataType eBufType,
+                                           GSpacing nPixelSpace,
+                                           GSpacing nLineSpace,
+                                           GDALRasterIOExtraArg* psExtraArg ) override;
         virtual CPLErr          FlushCache() override;
 
         virtual GDALColorTable* GetColorTable() override;
@@ -232,6 +232,16 @@ class GDALGeoPackageDataset CPL_FINAL : public OGRSQLiteBaseDataSource, public G
         virtual CPLErr      SetGeoTransform( double* padfGeoTransform ) override;
 
         virtual void        FlushCache() override;
+        virtual CPLErr      IRasterIO( GDALRWFlag eRWFlag,
+                                       int nXOff, int nYOff,
+                                       int nXSize, int nYSize,
+                                       void * pData,
+                                       int nBufXSize, int nBufYSize,
+                                       GDALDataType eBufType,
+                                       int nBandCount, int *panBandMap,
+                                       GSpacing nPixelSpace, GSpacing nLineSpace,
+                                       GSpacing nBandSpace,
+                                       GDALRasterIOExtraArg* psExtraArg ) override;
         virtual CPLErr      IBuildOverviews( const char *, int, int *,
                                              int, int *, GDALProgressFunc, void * ) override;
 
@@ -360,6 +370,7 @@ class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
                                            sqlite3_stmt *hStmt );
 
     OGRFeature*         TranslateFeature(sqlite3_stmt* hStmt);
+    bool                FilterGPKGBlob(sqlite3_stmt* hStmt, int& bPassFilter);
 
   public:
 
@@ -379,6 +390,19 @@ class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
                                          OGRGeometry* /*poFilterGeom*/) override { return ""; }
 };
 
+/************************************************************************/
+/*                           GPKGRTreeEntry                             */
+/************************************************************************/
+
+typedef struct
+{
+    GIntBig nId;
+    double  dfMinX;
+    double  dfMinY;
+    double  dfMaxX;
+    double  dfMaxY;
+} GPKGRTreeEntry;
+
 /************************************************************************/
 /*                        OGRGeoPackageTableLayer                       */
 /************************************************************************/
@@ -409,6 +433,10 @@ class OGRGeoPackageTableLayer CPL_FINAL : public OGRGeoPackageLayer
     bool                        m_bInsertStatementWithFID;
     sqlite3_stmt*               m_poInsertStatement;
     bool                        m_bDeferredSpatialIndexCreation;
+    // Envelopes of the features inserted while the spatial index creation
+    // is deferred, so as to avoid re-reading the table when building it.
+    std::vector<GPKGRTreeEntry> m_aoRTreeEntries;
+    bool                        m_bRTreeEntriesComplete;
     // m_bHasSpatialIndex cannot be bool.  -1 is unset.
     int                         m_bHasSpatialIndex;
     bool                        m_bDropRTreeTable;
@@ -500,7 +528,9 @@ class OGRGeoPackageTableLayer CPL_FINAL : public OGRGeoPackageLayer
                                                const char* pszIdentifier,
                                                const char* pszDescription );
     void                SetDeferredSpatialIndexCreation( bool bFlag )
-                                { m_bDeferredSpatialIndexCreation = bFlag; }
+                                { m_bDeferredSpatialIndexCreation = bFlag;
+                                  m_bRTreeEntriesComplete = bFlag;
+                                  m_aoRTreeEntries.clear(); }
     void                SetASpatialVariant( GPKGASpatialVariant eASPatialVariant )
                                 { m_eASPatialVariant = eASPatialVariant; }
 
@@ -29,6 +29,7 @@
 
 #include "ogr_geopackage.h"
 #include "ogr_p.h"
+#include "ogr_wkb.h"
 #include "swq.h"
 #include "gdalwarper.h"
 #include "ogrgeopackageutility.h"
@@ -2183,6 +2184,30 @@ CPLErr GDALGeoPackageDataset::FinalizeRasterRegistration()
     return CE_None;
 }
 
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr GDALGeoPackageDataset::IRasterIO( GDALRWFlag eRWFlag,
+                                         int nXOff, int nYOff,
+                                         int nXSize, int nYSize,
+                                         void * pData,
+                                         int nBufXSize, int nBufYSize,
+                                         GDALDataType eBufType,
+                                         int nBandCount, int *panBandMap,
+                                         GSpacing nPixelSpace, GSpacing nLineSpace,
+                                         GSpacing nBandSpace,
+                                         GDALRasterIOExtraArg* psExtraArg )
+{
+    if( eRWFlag == GF_Read && nBands > 0 )
+        PrefetchTiles(nXOff, nYOff, nXSize, nYSize, nBufXSize, nBufYSize);
+    return OGRSQLiteBaseDataSource::IRasterIO( eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                               pData, nBufXSize, nBufYSize, eBufType,
+                                               nBandCount, panBandMap,
+                                               nPixelSpace, nLineSpace, nBandSpace,
+                                               psExtraArg );
+}
+
 /************************************************************************/
 /*                             FlushCache()                             */
 /************************************************************************/
@@ -5486,6 +5511,26 @@ static bool OGRGeoPackageGetHeader( sqlite3_context* pContext,
     }
     else if( !(psHeader->bExtentHasXY) && bNeedExtent )
     {
+        // Compute the envelope from the WKB without building the geometry,
+        // unless it has circular arcs.
+        OGRWKBGeometryView oView;
+        OGREnvelope sEnvelope;
+        if( oView.Init(pabyBLOB + psHeader->nHeaderLen,
+                       nBLOBLen - psHeader->nHeaderLen) &&
+            oView.GetEnvelope(sEnvelope) )
+        {
+            psHeader->MinX = sEnvelope.MinX;
+            psHeader->MaxX = sEnvelope.MaxX;
+            psHeader->MinY = sEnvelope.MinY;
+            psHeader->MaxY = sEnvelope.MaxY;
+            return true;
+        }
+        if( oView.GetSize() != 0 && oView.IsEmpty() )
+        {
+            sqlite3_result_null(pContext);
+            return false;
+        }
+
         OGRGeometry *poGeom = GPkgGeometryToOGR(pabyBLOB, nBLOBLen, nullptr);
         if( poGeom == nullptr || poGeom->IsEmpty() )
         {
@@ -5493,7 +5538,6 @@ static bool OGRGeoPackageGetHeader( sqlite3_context* pContext,
             delete poGeom;
             return false;
         }
-        OGREnvelope sEnvelope;
         poGeom->getEnvelope(&sEnvelope);
         psHeader->MinX = sEnvelope.MinX;
         psHeader->MaxX = sEnvelope.MaxX;
@@ -136,9 +136,28 @@ OGRFeature *OGRGeoPackageLayer::GetNextFeature()
             bDoStep = true;
         }
 
+        // Evaluate the spatial filter on the geometry blob, to avoid
+        // building features that will be discarded.
+        bool bFilterGeometryDone = false;
+        if( m_poFilterGeom != nullptr && iGeomCol >= 0 &&
+            m_iGeomFieldFilter == 0 )
+        {
+            int bPassFilter = TRUE;
+            if( FilterGPKGBlob(m_poQueryStatement, bPassFilter) )
+            {
+                if( !bPassFilter )
+                {
+                    iNextShapeId++;
+                    m_nFeaturesRead++;
+                    continue;
+                }
+                bFilterGeometryDone = true;
+            }
+        }
+
         OGRFeature *poFeature = TranslateFeature(m_poQueryStatement);
 
-        if( (m_poFilterGeom == nullptr
+        if( (m_poFilterGeom == nullptr || bFilterGeometryDone
             || FilterGeometry( poFeature->GetGeomFieldRef(m_iGeomFieldFilter) ) )
             && (m_poAttrQuery == nullptr
                 || m_poAttrQuery->Evaluate( poFeature )) )
@@ -148,6 +167,59 @@ OGRFeature *OGRGeoPackageLayer::GetNextFeature()
     }
 }
 
+/************************************************************************/
+/*                          FilterGPKGBlob()                            */
+/*                                                                      */
+/*      Evaluate the spatial filter directly on the GeoPackage          */
+/*      geometry blob of the current row, using the envelope of the     */
+/*      header when available. Returns false if the blob is not a       */
+/*      GeoPackage geometry (e.g. a SpatiaLite one), in which case the  */
+/*      filter must be evaluated on the feature.                        */
+/************************************************************************/
+
+bool OGRGeoPackageLayer::FilterGPKGBlob( sqlite3_stmt* hStmt,
+                                         int& bPassFilter )
+{
+    if( m_poFeatureDefn->GetGeomFieldDefn(0)->IsIgnored() )
+        return false;
+
+    if( sqlite3_column_type(hStmt, iGeomCol) == SQLITE_NULL )
+    {
+        bPassFilter = FALSE;
+        return true;
+    }
+
+    const int nBytes = sqlite3_column_bytes(hStmt, iGeomCol);
+    // coverity[tainted_data_return]
+    const GByte* pabyGpkg = static_cast<const GByte*>(
+                                sqlite3_column_blob(hStmt, iGeomCol));
+    GPkgHeader oHeader;
+    if( pabyGpkg == nullptr ||
+        GPkgHeaderFromWKB(pabyGpkg, nBytes, &oHeader) != OGRERR_NONE )
+    {
+        return false;
+    }
+
+    if( oHeader.bEmpty )
+    {
+        bPassFilter = FALSE;
+        return true;
+    }
+
+    OGREnvelope sEnvelope;
+    if( oHeader.bExtentHasXY )
+    {
+        sEnvelope.MinX = oHeader.MinX;
+        sEnvelope.MinY = oHeader.MinY;
+        sEnvelope.MaxX = oHeader.MaxX;
+        sEnvelope.MaxY = oHeader.MaxY;
+    }
+    bPassFilter = FilterWKBGeometry(pabyGpkg + oHeader.nHeaderLen,
+                                    nBytes - oHeader.nHeaderLen,
+                                    oHeader.bExtentHasXY, sEnvelope);
+    return true;
+}
+
 /************************************************************************/
 /*                         TranslateFeature()                           */
 /************************************************************************/
@@ -33,6 +33,9 @@
 #include "cpl_time.h"
 #include "ogr_p.h"
 
+#include <algorithm>
+#include <cmath>
+
 CPL_CVSID("$Id$")
 
 static const char UNSUPPORTED_OP_READ_ONLY[] =
@@ -1141,6 +1144,7 @@ OGRGeoPackageTableLayer::OGRGeoPackageTableLayer(
     m_bInsertStatementWithFID(false),
     m_poInsertStatement(nullptr),
     m_bDeferredSpatialIndexCreation(false),
+    m_bRTreeEntriesComplete(false),
     m_bHasSpatialIndex(-1),
     m_bDropRTreeTable(false),
     m_bPreservePrecision(true),
@@ -1637,6 +1641,20 @@ void OGRGeoPackageTableLayer::CheckGeometryType( OGRFeature *poFeature )
     }
 }
 
+/************************************************************************/
+/*                     GPKGGetMaxRTreeEntriesInRAM()                    */
+/************************************************************************/
+
+/* Maximum number of envelopes held in RAM when building the RTree */
+static size_t GPKGGetMaxRTreeEntriesInRAM()
+{
+    GIntBig nMaxRAM = CPLGetUsablePhysicalRAM() / 10;
+    if( nMaxRAM <= 0 )
+        nMaxRAM = 100 * 1024 * 1024;
+    return std::max(static_cast<size_t>(100000),
+                    static_cast<size_t>(nMaxRAM / sizeof(GPKGRTreeEntry)));
+}
+
 /************************************************************************/
 /*                      ICreateFeature()                                 */
 /************************************************************************/
@@ -1769,14 +1787,16 @@ OGRErr OGRGeoPackageTableLayer::ICreateFeature( OGRFeature *poFeature )
     }
 
     /* Update the layer extents with this new object */
+    OGREnvelope oEnv;
+    bool bHasEnvelope = false;
     if( IsGeomFieldSet(poFeature) )
     {
         OGRGeometry* poGeom = poFeature->GetGeomFieldRef(0);
         if( !poGeom->IsEmpty() )
         {
-            OGREnvelope oEnv;
             poGeom->getEnvelope(&oEnv);
             UpdateExtent(&oEnv);
+            bHasEnvelope = true;
         }
     }
 
@@ -1793,6 +1813,29 @@ OGRErr OGRGeoPackageTableLayer::ICreateFeature( OGRFeature *poFeature )
         poFeature->SetFID(OGRNullFID);
     }
 
+    /* Collect the envelope for the deferred creation of the spatial index */
+    if( m_bRTreeEntriesComplete && bHasEnvelope )
+    {
+        if( poFeature->GetFID() == OGRNullFID ||
+            (m_aoRTreeEntries.size() == m_aoRTreeEntries.capacity() &&
+             m_aoRTreeEntries.size() >= GPKGGetMaxRTreeEntriesInRAM()) )
+        {
+            // Too many features: the table will be read back
+            m_bRTreeEntriesComplete = false;
+            m_aoRTreeEntries = std::vector<GPKGRTreeEntry>();
+        }
+        else
+        {
+            GPKGRTreeEntry sEntry;
+            sEntry.nId = poFeature->GetFID();
+            sEntry.dfMinX = oEnv.MinX;
+            sEntry.dfMinY = oEnv.MinY;
+            sEntry.dfMaxX = oEnv.MaxX;
+            sEntry.dfMaxY = oEnv.MaxY;
+            m_aoRTreeEntries.push_back(sEntry);
+        }
+    }
+
 #ifdef ENABLE_GPKG_OGR_CONTENTS
     if( m_nTotalFeatureCount >= 0 )
         m_nTotalFeatureCount++;
@@ -1828,6 +1871,11 @@ OGRErr OGRGeoPackageTableLayer::ISetFeature( OGRFeature *poFeature )
         return OGRERR_FAILURE;
     }
 
+    /* The envelopes collected for the deferred spatial index might become */
+    /* outdated: the table will be read back */
+    m_bRTreeEntriesComplete = false;
+    m_aoRTreeEntries = std::vector<GPKGRTreeEntry>();
+
     /* In case the FID column has also been created as a regular field */
     if( m_iFIDAsRegularColumnIndex >= 0 )
     {
@@ -2196,6 +2244,9 @@ OGRErr OGRGeoPackageTableLayer::DeleteFeature(GIntBig nFID)
     /* Clear out any existing query */
     ResetReading();
 
+    m_bRTreeEntriesComplete = false;
+    m_aoRTreeEntries = std::vector<GPKGRTreeEntry>();
+
     /* No filters apply, just use the FID */
     CPLString soSQL;
     soSQL.Printf("DELETE FROM \"%s\" WHERE \"%s\" = " CPL_FRMT_GIB,
@@ -2541,17 +2592,256 @@ void OGRGeoPackageTableLayer::CreateSpatialIndexIfNecessary()
 }
 
 /************************************************************************/
-/*                       CreateSpatialIndex()                           */
+/*                         GPKGBulkLoadRTree()                          */
 /************************************************************************/
 
+/* Cell of a node of a SQLite RTree: the rowid of a feature for a leaf */
+/* node, or a child node number, and single-precision bounds */
 typedef struct
 {
     GIntBig nId;
-    double  dfMinX;
-    double  dfMinY;
-    double  dfMaxX;
-    double  dfMaxY;
-} GPKGRTreeEntry;
+    float   fMinX;
+    float   fMaxX;
+    float   fMinY;
+    float   fMaxY;
+} GPKGRTreeCell;
+
+/* Same rounding as the SQLite RTree module, so that the stored box */
+/* always contains the double-precision one */
+static float GPKGRTreeValueDown( double dfVal )
+{
+    float fVal = static_cast<float>(dfVal);
+    if( fVal > dfVal )
+    {
+        fVal = static_cast<float>(dfVal * (dfVal < 0 ?
+                        1.0 + 1.0 / 8388608.0 : 1.0 - 1.0 / 8388608.0));
+    }
+    return fVal;
+}
+
+static float GPKGRTreeValueUp( double dfVal )
+{
+    float fVal = static_cast<float>(dfVal);
+    if( fVal < dfVal )
+    {
+        fVal = static_cast<float>(dfVal * (dfVal < 0 ?
+                        1.0 - 1.0 / 8388608.0 : 1.0 + 1.0 / 8388608.0));
+    }
+    return fVal;
+}
+
+/* Sort cells along the Sort-Tile-Recursive order: cells are sorted by the */
+/* X of their center, cut into vertical slices of sqrt(N/M) nodes of M */
+/* cells, and each slice is sorted by the Y of the center. */
+static void GPKGSortRTreeCells( std::vector<GPKGRTreeCell>& aoCells,
+                                size_t nNodeCapacity )
+{
+    const size_t nCount = aoCells.size();
+    std::sort(aoCells.begin(), aoCells.end(),
+              [](const GPKGRTreeCell& a, const GPKGRTreeCell& b)
+              { return a.fMinX + a.fMaxX < b.fMinX + b.fMaxX; });
+
+    const size_t nNodeCount = (nCount + nNodeCapacity - 1) / nNodeCapacity;
+    const size_t nSliceCount = static_cast<size_t>(
+        std::ceil(std::sqrt(static_cast<double>(nNodeCount))));
+    const size_t nSliceSize =
+        nNodeCapacity * ((nNodeCount + nSliceCount - 1) / nSliceCount);
+    for( size_t i = 0; i < nCount; i += nSliceSize )
+    {
+        std::sort(aoCells.begin() + i,
+                  aoCells.begin() + std::min(i + nSliceSize, nCount),
+                  [](const GPKGRTreeCell& a, const GPKGRTreeCell& b)
+                  { return a.fMinY + a.fMaxY < b.fMinY + b.fMaxY; });
+    }
+}
+
+/* Build a packed RTree bottom-up from the entries, and write its nodes */
+/* directly in the _node, _parent and _rowid shadow tables of the (empty) */
+/* virtual table. Returns OGRERR_UNSUPPORTED_OPERATION without modifying */
+/* anything if the entries must be inserted through the virtual table. */
+static OGRErr GPKGBulkLoadRTree( sqlite3* hDB, const char* pszRTreeName,
+                                 const std::vector<GPKGRTreeEntry>& aoEntries )
+{
+    if( aoEntries.empty() ||
+        !CPLTestBool(CPLGetConfigOption("OGR_GPKG_RTREE_BULK_LOAD", "YES")) )
+    {
+        return OGRERR_UNSUPPORTED_OPERATION;
+    }
+
+    /* The node size has been determined at the creation of the RTree */
+    /* from the page size */
+    char* pszSQL = sqlite3_mprintf(
+        "SELECT length(data) FROM \"%w_node\" WHERE nodeno = 1",
+        pszRTreeName);
+    OGRErr err = OGRERR_NONE;
+    const int nNodeSize = SQLGetInteger(hDB, pszSQL, &err);
+    sqlite3_free(pszSQL);
+    const int nCellSize = 8 + 4 * static_cast<int>(sizeof(float));
+    if( err != OGRERR_NONE || nNodeSize < 4 + 2 * nCellSize )
+        return OGRERR_UNSUPPORTED_OPERATION;
+    const size_t nNodeCapacity = static_cast<size_t>((nNodeSize - 4) / nCellSize);
+
+    std::vector<GPKGRTreeCell> aoCells;
+    aoCells.reserve(aoEntries.size());
+    for( size_t i = 0; i < aoEntries.size(); ++i )
+    {
+        const GPKGRTreeEntry& sEntry = aoEntries[i];
+        // Let the virtual table report invalid boxes
+        if( !(sEntry.dfMinX <= sEntry.dfMaxX) ||
+            !(sEntry.dfMinY <= sEntry.dfMaxY) )
+        {
+            return OGRERR_UNSUPPORTED_OPERATION;
+        }
+        GPKGRTreeCell sCell;
+        sCell.nId = sEntry.nId;
+        sCell.fMinX = GPKGRTreeValueDown(sEntry.dfMinX);
+        sCell.fMaxX = GPKGRTreeValueUp(sEntry.dfMaxX);
+        sCell.fMinY = GPKGRTreeValueDown(sEntry.dfMinY);
+        sCell.fMaxY = GPKGRTreeValueUp(sEntry.dfMaxY);
+        aoCells.push_back(sCell);
+    }
+
+    sqlite3_stmt* hInsertNodeStmt = nullptr;
+    sqlite3_stmt* hUpdateRootStmt = nullptr;
+    sqlite3_stmt* hInsertParentStmt = nullptr;
+    sqlite3_stmt* hInsertRowidStmt = nullptr;
+    const char* const apszSQL[] = {
+        "INSERT INTO \"%w_node\" (nodeno, data) VALUES (?, ?)",
+        "UPDATE \"%w_node\" SET data = ? WHERE nodeno = 1",
+        "INSERT INTO \"%w_parent\" (nodeno, parentnode) VALUES (?, ?)",
+        "INSERT INTO \"%w_rowid\" (rowid, nodeno) VALUES (?, ?)" };
+    sqlite3_stmt** const pahStmt[] = {
+        &hInsertNodeStmt, &hUpdateRootStmt,
+        &hInsertParentStmt, &hInsertRowidStmt };
+    bool bOK = true;
+    for( size_t i = 0; bOK && i < CPL_ARRAYSIZE(apszSQL); ++i )
+    {
+        pszSQL = sqlite3_mprintf(apszSQL[i], pszRTreeName);
+        if( sqlite3_prepare_v2(hDB, pszSQL, -1, pahStmt[i], nullptr)
+                                                            != SQLITE_OK )
+        {
+            bOK = false;
+        }
+        sqlite3_free(pszSQL);
+    }
+    if( !bOK )
+    {
+        for( size_t i = 0; i < CPL_ARRAYSIZE(apszSQL); ++i )
+            sqlite3_finalize(*pahStmt[i]);
+        return OGRERR_UNSUPPORTED_OPERATION;
+    }
+
+    /* Group the cells of each level into nodes, from the leaves up to the */
+    /* root, which is node 1 */
+    std::vector<GByte> abyNode(nNodeSize);
+    std::vector<GPKGRTreeCell> aoParentCells;
+    GIntBig nLastNodeNo = 1;
+    int nDepth = 0;
+    while( bOK )
+    {
+        const bool bIsRoot = aoCells.size() <= nNodeCapacity;
+        if( !bIsRoot )
+            GPKGSortRTreeCells(aoCells, nNodeCapacity);
+
+        aoParentCells.clear();
+        for( size_t iStart = 0; bOK && iStart < aoCells.size();
+                                                    iStart += nNodeCapacity )
+        {
+            const size_t nCells =
+                std::min(nNodeCapacity, aoCells.size() - iStart);
+            const GIntBig nNodeNo = bIsRoot ? 1 : ++nLastNodeNo;
+
+            /* Node blob: big-endian depth of the tree (for the root only) */
+            /* and cell count, followed by the cells */
+            std::fill(abyNode.begin(), abyNode.end(), static_cast<GByte>(0));
+            if( bIsRoot )
+            {
+                abyNode[0] = static_cast<GByte>(nDepth >> 8);
+                abyNode[1] = static_cast<GByte>(nDepth & 0xff);
+            }
+            abyNode[2] = static_cast<GByte>(nCells >> 8);
+            abyNode[3] = static_cast<GByte>(nCells & 0xff);
+
+            GPKGRTreeCell sParentCell;
+            sParentCell.nId = nNodeNo;
+            sParentCell.fMinX = aoCells[iStart].fMinX;
+            sParentCell.fMaxX = aoCells[iStart].fMaxX;
+            sParentCell.fMinY = aoCells[iStart].fMinY;
+            sParentCell.fMaxY = aoCells[iStart].fMaxY;
+            GByte* pabyCell = &abyNode[4];
+            for( size_t i = iStart; bOK && i < iStart + nCells; ++i )
+            {
+                const GPKGRTreeCell& sCell = aoCells[i];
+                sParentCell.fMinX = std::min(sParentCell.fMinX, sCell.fMinX);
+                sParentCell.fMaxX = std::max(sParentCell.fMaxX, sCell.fMaxX);
+                sParentCell.fMinY = std::min(sParentCell.fMinY, sCell.fMinY);
+                sParentCell.fMaxY = std::max(sParentCell.fMaxY, sCell.fMaxY);
+
+                GIntBig nId = sCell.nId;
+                CPL_MSBPTR64(&nId);
+                memcpy(pabyCell, &nId, 8);
+                const float afCoords[4] = { sCell.fMinX, sCell.fMaxX,
+                                            sCell.fMinY, sCell.fMaxY };
+                for( int j = 0; j < 4; ++j )
+                {
+                    GUInt32 nCoord;
+                    memcpy(&nCoord, &afCoords[j], 4);
+                    CPL_MSBPTR32(&nCoord);
+                    memcpy(pabyCell + 8 + 4 * j, &nCoord, 4);
+                }
+                pabyCell += nCellSize;
+
+                /* Link the feature to its leaf node, or the child node to */
+                /* its parent */
+                sqlite3_stmt* hStmt =
+                    nDepth == 0 ? hInsertRowidStmt : hInsertParentStmt;
+                sqlite3_reset(hStmt);
+                sqlite3_bind_int64(hStmt, 1, sCell.nId);
+                sqlite3_bind_int64(hStmt, 2, nNodeNo);
+                bOK = sqlite3_step(hStmt) == SQLITE_DONE;
+            }
+            aoParentCells.push_back(sParentCell);
+
+            if( !bOK )
+                break;
+            if( bIsRoot )
+            {
+                sqlite3_reset(hUpdateRootStmt);
+                sqlite3_bind_blob(hUpdateRootStmt, 1, &abyNode[0], nNodeSize,
+                                  SQLITE_STATIC);
+                bOK = sqlite3_step(hUpdateRootStmt) == SQLITE_DONE;
+            }
+            else
+            {
+                sqlite3_reset(hInsertNodeStmt);
+                sqlite3_bind_int64(hInsertNodeStmt, 1, nNodeNo);
+                sqlite3_bind_blob(hInsertNodeStmt, 2, &abyNode[0], nNodeSize,
+                                  SQLITE_STATIC);
+                bOK = sqlite3_step(hInsertNodeStmt) == SQLITE_DONE;
+            }
+        }
+
+        if( bIsRoot )
+            break;
+        aoCells.swap(aoParentCells);
+        nDepth++;
+    }
+
+    if( !bOK )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "failed to write nodes of %s: %s",
+                  pszRTreeName, sqlite3_errmsg(hDB) );
+    }
+    for( size_t i = 0; i < CPL_ARRAYSIZE(apszSQL); ++i )
+        sqlite3_finalize(*pahStmt[i]);
+
+    return bOK ? OGRERR_NONE : OGRERR_FAILURE;
+}
+
+/************************************************************************/
+/*                       CreateSpatialIndex()                           */
+/************************************************************************/
 
 bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
 {
@@ -2565,6 +2855,12 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
 
     m_bDeferredSpatialIndexCreation = false;
 
+    // Take ownership of the envelopes collected by ICreateFeature()
+    std::vector<GPKGRTreeEntry> aoEntries;
+    aoEntries.swap(m_aoRTreeEntries);
+    const bool bRTreeEntriesComplete = m_bRTreeEntriesComplete;
+    m_bRTreeEntriesComplete = false;
+
     if( m_pszFidColumn == nullptr )
         return false;
 
@@ -2627,105 +2923,136 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
         return false;
     }
 #else
-    pszSQL = sqlite3_mprintf(
-        "SELECT \"%w\", ST_MinX(\"%w\"), ST_MaxX(\"%w\"), "
-        "ST_MinY(\"%w\"), ST_MaxY(\"%w\") FROM \"%w\" "
-        "WHERE \"%w\" NOT NULL AND NOT ST_IsEmpty(\"%w\")",
-            pszI, pszC, pszC, pszC, pszC, pszT, pszC, pszC );
+    // Entries are read by chunks of at most nChunkSize. If they all fit in
+    // one chunk, the RTree is packed and written directly, otherwise they
+    // are inserted one by one.
+    const size_t nChunkSize = GPKGGetMaxRTreeEntriesInRAM();
+    const bool bUseBufferedEntries = bRTreeEntriesComplete &&
+                                     aoEntries.size() <= nChunkSize;
     sqlite3_stmt* hIterStmt = nullptr;
-    if ( sqlite3_prepare_v2(m_poDS->GetDB(), pszSQL, -1, &hIterStmt, nullptr)
-                                                            != SQLITE_OK )
+    if( !bUseBufferedEntries )
     {
-        CPLError( CE_Failure, CPLE_AppDefined,
-                    "failed to prepare SQL: %s", pszSQL);
+        aoEntries = std::vector<GPKGRTreeEntry>();
+        pszSQL = sqlite3_mprintf(
+            "SELECT \"%w\", ST_MinX(\"%w\"), ST_MaxX(\"%w\"), "
+            "ST_MinY(\"%w\"), ST_MaxY(\"%w\") FROM \"%w\" "
+            "WHERE \"%w\" NOT NULL AND NOT ST_IsEmpty(\"%w\")",
+                pszI, pszC, pszC, pszC, pszC, pszT, pszC, pszC );
+        if ( sqlite3_prepare_v2(m_poDS->GetDB(), pszSQL, -1, &hIterStmt,
+                                nullptr) != SQLITE_OK )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                        "failed to prepare SQL: %s", pszSQL);
+            sqlite3_free(pszSQL);
+            m_poDS->SoftRollbackTransaction();
+            return false;
+        }
         sqlite3_free(pszSQL);
-        m_poDS->SoftRollbackTransaction();
-        return false;
     }
-    sqlite3_free(pszSQL);
 
-    pszSQL = sqlite3_mprintf(
-        "INSERT INTO \"%w\" VALUES (?,?,?,?,?)",
-        m_osRTreeName.c_str());
     sqlite3_stmt* hInsertStmt = nullptr;
-    if ( sqlite3_prepare_v2(m_poDS->GetDB(), pszSQL, -1, &hInsertStmt, nullptr)
-                                                            != SQLITE_OK )
-    {
-        CPLError( CE_Failure, CPLE_AppDefined,
-                    "failed to prepare SQL: %s", pszSQL);
-        sqlite3_free(pszSQL);
-        sqlite3_finalize(hIterStmt);
-        m_poDS->SoftRollbackTransaction();
-        return false;
-    }
-    sqlite3_free(pszSQL);
-
-    // Insert entries in RTree by chuncks of 100000
-    std::vector<GPKGRTreeEntry> aoEntries;
     GUIntBig nEntryCount = 0;
-    const size_t nChunkSize = 100000;
     while( true )
     {
-        int sqlite_err = sqlite3_step(hIterStmt);
-        bool bFinished = false;
-        if( sqlite_err == SQLITE_ROW )
+        // When using the envelopes collected by ICreateFeature(), there is
+        // no need to read back the table.
+        bool bFinished = bUseBufferedEntries;
+        while( !bFinished && aoEntries.size() < nChunkSize )
         {
-            GPKGRTreeEntry sEntry;
-            sEntry.nId = sqlite3_column_int64(hIterStmt, 0);
-            sEntry.dfMinX = sqlite3_column_double(hIterStmt, 1);
-            sEntry.dfMaxX = sqlite3_column_double(hIterStmt, 2);
-            sEntry.dfMinY = sqlite3_column_double(hIterStmt, 3);
-            sEntry.dfMaxY = sqlite3_column_double(hIterStmt, 4);
-            aoEntries.push_back(sEntry);
+            int sqlite_err = sqlite3_step(hIterStmt);
+            if( sqlite_err == SQLITE_ROW )
+            {
+                GPKGRTreeEntry sEntry;
+                sEntry.nId = sqlite3_column_int64(hIterStmt, 0);
+                sEntry.dfMinX = sqlite3_column_double(hIterStmt, 1);
+                sEntry.dfMaxX = sqlite3_column_double(hIterStmt, 2);
+                sEntry.dfMinY = sqlite3_column_double(hIterStmt, 3);
+                sEntry.dfMaxY = sqlite3_column_double(hIterStmt, 4);
+                aoEntries.push_back(sEntry);
+            }
+            else if( sqlite_err == SQLITE_DONE )
+            {
+                bFinished = true;
+            }
+            else
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "failed to iterate over features while inserting in "
+                          "RTree: %s",
+                          sqlite3_errmsg( m_poDS->GetDB() ) );
+                sqlite3_finalize(hIterStmt);
+                sqlite3_finalize(hInsertStmt);
+                m_poDS->SoftRollbackTransaction();
+                return false;
+            }
         }
-        else if( sqlite_err == SQLITE_DONE )
+
+        if( bFinished && nEntryCount == 0 )
         {
-            bFinished = true;
+            err = GPKGBulkLoadRTree(m_poDS->GetDB(), m_osRTreeName,
+                                    aoEntries);
+            if( err == OGRERR_FAILURE )
+            {
+                sqlite3_finalize(hIterStmt);
+                m_poDS->SoftRollbackTransaction();
+                return false;
+            }
+            if( err == OGRERR_NONE )
+            {
+                CPLDebug("GPKG", "%d rows bulk loaded into %s",
+                         static_cast<int>(aoEntries.size()),
+                         m_osRTreeName.c_str());
+                break;
+            }
         }
-        else
+
+        if( hInsertStmt == nullptr )
         {
-            CPLError( CE_Failure, CPLE_AppDefined,
-                      "failed to iterate over features while inserting in "
-                      "RTree: %s",
-                      sqlite3_errmsg( m_poDS->GetDB() ) );
-            sqlite3_finalize(hIterStmt);
-            sqlite3_finalize(hInsertStmt);
-            m_poDS->SoftRollbackTransaction();
-            return false;
+            pszSQL = sqlite3_mprintf(
+                "INSERT INTO \"%w\" VALUES (?,?,?,?,?)",
+                m_osRTreeName.c_str());
+            if ( sqlite3_prepare_v2(m_poDS->GetDB(), pszSQL, -1, &hInsertStmt,
+                                    nullptr) != SQLITE_OK )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                            "failed to prepare SQL: %s", pszSQL);
+                sqlite3_free(pszSQL);
+                sqlite3_finalize(hIterStmt);
+                m_poDS->SoftRollbackTransaction();
+                return false;
+            }
+            sqlite3_free(pszSQL);
         }
 
-        if( aoEntries.size() == nChunkSize || bFinished )
+        for( size_t i = 0; i < aoEntries.size(); ++i )
         {
-            for( size_t i = 0; i < aoEntries.size(); ++i )
+            sqlite3_reset(hInsertStmt);
+
+            sqlite3_bind_int64(hInsertStmt,1,aoEntries[i].nId);
+            sqlite3_bind_double(hInsertStmt,2,aoEntries[i].dfMinX);
+            sqlite3_bind_double(hInsertStmt,3,aoEntries[i].dfMaxX);
+            sqlite3_bind_double(hInsertStmt,4,aoEntries[i].dfMinY);
+            sqlite3_bind_double(hInsertStmt,5,aoEntries[i].dfMaxY);
+            int sqlite_err = sqlite3_step(hInsertStmt);
+            if ( sqlite_err != SQLITE_OK && sqlite_err != SQLITE_DONE )
             {
-                sqlite3_reset(hInsertStmt);
-
-                sqlite3_bind_int64(hInsertStmt,1,aoEntries[i].nId);
-                sqlite3_bind_double(hInsertStmt,2,aoEntries[i].dfMinX);
-                sqlite3_bind_double(hInsertStmt,3,aoEntries[i].dfMaxX);
-                sqlite3_bind_double(hInsertStmt,4,aoEntries[i].dfMinY);
-                sqlite3_bind_double(hInsertStmt,5,aoEntries[i].dfMaxY);
-                sqlite_err = sqlite3_step(hInsertStmt);
-                if ( sqlite_err != SQLITE_OK && sqlite_err != SQLITE_DONE )
-                {
-                    CPLError( CE_Failure, CPLE_AppDefined,
-                              "failed to execute insertion in RTree : %s",
-                              sqlite3_errmsg( m_poDS->GetDB() ) );
-                    sqlite3_finalize(hIterStmt);
-                    sqlite3_finalize(hInsertStmt);
-                    m_poDS->SoftRollbackTransaction();
-                    return false;
-                }
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "failed to execute insertion in RTree : %s",
+                          sqlite3_errmsg( m_poDS->GetDB() ) );
+                sqlite3_finalize(hIterStmt);
+                sqlite3_finalize(hInsertStmt);
+                m_poDS->SoftRollbackTransaction();
+                return false;
             }
+        }
 
-            nEntryCount += aoEntries.size();
-            CPLDebug("GPKG", CPL_FRMT_GUIB " rows inserted into %s",
-                     nEntryCount, m_osRTreeName.c_str());
+        nEntryCount += aoEntries.size();
+        CPLDebug("GPKG", CPL_FRMT_GUIB " rows inserted into %s",
+                 nEntryCount, m_osRTreeName.c_str());
 
-            aoEntries.clear();
-            if( bFinished )
-                break;
-        }
+        aoEntries.clear();
+        if( bFinished )
+            break;
     }
 
     sqlite3_finalize(hIterStmt);
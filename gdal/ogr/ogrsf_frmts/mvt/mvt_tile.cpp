@@ -0,0 +1,453 @@
+/******************************************************************************
+ *
+ * Project:  MVT Translator
+ * Purpose:  Mapbox Vector Tile encoder
+ * Author:   Even Rouault, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "mvt_tile.h"
+
+#include <cstring>
+
+CPL_CVSID("$Id$")
+
+/* See https://github.com/mapbox/vector-tile-spec/blob/master/2.1/vector_tile.proto */
+constexpr int knWT_VARINT = 0;
+constexpr int knWT_64BIT = 1;
+constexpr int knWT_DATA = 2;
+constexpr int knWT_32BIT = 5;
+
+constexpr int knTILE_LAYER = 3;
+
+constexpr int knLAYER_NAME = 1;
+constexpr int knLAYER_FEATURES = 2;
+constexpr int knLAYER_KEYS = 3;
+constexpr int knLAYER_VALUES = 4;
+constexpr int knLAYER_EXTENT = 5;
+constexpr int knLAYER_VERSION = 15;
+
+constexpr int knVALUE_STRING = 1;
+constexpr int knVALUE_FLOAT = 2;
+constexpr int knVALUE_DOUBLE = 3;
+constexpr int knVALUE_INT = 4;
+constexpr int knVALUE_UINT = 5;
+constexpr int knVALUE_SINT = 6;
+constexpr int knVALUE_BOOL = 7;
+
+constexpr int knFEATURE_ID = 1;
+constexpr int knFEATURE_TAGS = 2;
+constexpr int knFEATURE_TYPE = 3;
+constexpr int knFEATURE_GEOMETRY = 4;
+
+/************************************************************************/
+/*                           WriteVarUInt()                             */
+/************************************************************************/
+
+static void WriteVarUInt(CPLString& osOut, GUIntBig nVal)
+{
+    while( nVal >= 0x80 )
+    {
+        osOut += static_cast<char>((nVal & 0x7f) | 0x80);
+        nVal >>= 7;
+    }
+    osOut += static_cast<char>(nVal);
+}
+
+/************************************************************************/
+/*                            WriteKey()                                */
+/************************************************************************/
+
+static void WriteKey(CPLString& osOut, int nFieldNumber, int nWireType)
+{
+    WriteVarUInt(osOut, static_cast<GUIntBig>((nFieldNumber << 3) |
+                                              nWireType));
+}
+
+/************************************************************************/
+/*                            WriteData()                               */
+/************************************************************************/
+
+static void WriteData(CPLString& osOut, int nFieldNumber,
+                      const CPLString& osData)
+{
+    WriteKey(osOut, nFieldNumber, knWT_DATA);
+    WriteVarUInt(osOut, osData.size());
+    osOut += osData;
+}
+
+/************************************************************************/
+/*                          WritePackedUInt()                           */
+/************************************************************************/
+
+static void WritePackedUInt(CPLString& osOut, int nFieldNumber,
+                            const std::vector<GUInt32>& anValues)
+{
+    CPLString osPacked;
+    for( const auto nVal: anValues )
+        WriteVarUInt(osPacked, nVal);
+    WriteData(osOut, nFieldNumber, osPacked);
+}
+
+/************************************************************************/
+/*                           ReadVarUInt()                              */
+/************************************************************************/
+
+static bool ReadVarUInt(const GByte*& pabyData, const GByte* pabyDataEnd,
+                        GUIntBig& nVal)
+{
+    nVal = 0;
+    int nShift = 0;
+    while( pabyData < pabyDataEnd && nShift < 64 )
+    {
+        const GByte byVal = *pabyData;
+        ++pabyData;
+        nVal |= static_cast<GUIntBig>(byVal & 0x7f) << nShift;
+        if( (byVal & 0x80) == 0 )
+            return true;
+        nShift += 7;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                          setStringValue()                            */
+/************************************************************************/
+
+void MVTTileLayerValue::setStringValue(const CPLString& osValue)
+{
+    m_eType = ValueType::STRING;
+    m_osValue = osValue;
+}
+
+/************************************************************************/
+/*                          setDoubleValue()                            */
+/************************************************************************/
+
+void MVTTileLayerValue::setDoubleValue(double dfValue)
+{
+    // Use the more compact float encoding when it is lossless
+    const float fValue = static_cast<float>(dfValue);
+    m_eType = (static_cast<double>(fValue) == dfValue) ? ValueType::FLOAT :
+                                                         ValueType::DOUBLE;
+    m_dfValue = dfValue;
+}
+
+/************************************************************************/
+/*                         setIntegerValue()                            */
+/************************************************************************/
+
+void MVTTileLayerValue::setIntegerValue(GIntBig nValue)
+{
+    if( nValue >= 0 )
+    {
+        m_eType = ValueType::UINT;
+        m_nUIntValue = static_cast<GUIntBig>(nValue);
+    }
+    else
+    {
+        m_eType = ValueType::SINT;
+        m_nIntValue = nValue;
+    }
+}
+
+/************************************************************************/
+/*                           setBoolValue()                             */
+/************************************************************************/
+
+void MVTTileLayerValue::setBoolValue(bool bValue)
+{
+    m_eType = ValueType::BOOL;
+    m_nUIntValue = bValue ? 1 : 0;
+}
+
+/************************************************************************/
+/*                             operator< ()                             */
+/************************************************************************/
+
+bool MVTTileLayerValue::operator< (const MVTTileLayerValue& other) const
+{
+    if( m_eType != other.m_eType )
+        return m_eType < other.m_eType;
+    switch( m_eType )
+    {
+        case ValueType::STRING:
+            return m_osValue < other.m_osValue;
+        case ValueType::FLOAT:
+        case ValueType::DOUBLE:
+            return m_dfValue < other.m_dfValue;
+        case ValueType::INT:
+        case ValueType::SINT:
+            return m_nIntValue < other.m_nIntValue;
+        case ValueType::UINT:
+        case ValueType::BOOL:
+            return m_nUIntValue < other.m_nUIntValue;
+        case ValueType::NONE:
+            break;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                               write()                                */
+/************************************************************************/
+
+void MVTTileLayerValue::write(CPLString& osOut) const
+{
+    switch( m_eType )
+    {
+        case ValueType::STRING:
+            WriteData(osOut, knVALUE_STRING, m_osValue);
+            break;
+        case ValueType::FLOAT:
+        {
+            WriteKey(osOut, knVALUE_FLOAT, knWT_32BIT);
+            float fValue = static_cast<float>(m_dfValue);
+            CPL_LSBPTR32(&fValue);
+            osOut.append(reinterpret_cast<const char*>(&fValue),
+                         sizeof(fValue));
+            break;
+        }
+        case ValueType::DOUBLE:
+        {
+            WriteKey(osOut, knVALUE_DOUBLE, knWT_64BIT);
+            double dfValue = m_dfValue;
+            CPL_LSBPTR64(&dfValue);
+            osOut.append(reinterpret_cast<const char*>(&dfValue),
+                         sizeof(dfValue));
+            break;
+        }
+        case ValueType::INT:
+            WriteKey(osOut, knVALUE_INT, knWT_VARINT);
+            WriteVarUInt(osOut, static_cast<GUIntBig>(m_nIntValue));
+            break;
+        case ValueType::UINT:
+            WriteKey(osOut, knVALUE_UINT, knWT_VARINT);
+            WriteVarUInt(osOut, m_nUIntValue);
+            break;
+        case ValueType::SINT:
+            WriteKey(osOut, knVALUE_SINT, knWT_VARINT);
+            WriteVarUInt(osOut,
+                (static_cast<GUIntBig>(m_nIntValue) << 1) ^
+                static_cast<GUIntBig>(m_nIntValue >> 63));
+            break;
+        case ValueType::BOOL:
+            WriteKey(osOut, knVALUE_BOOL, knWT_VARINT);
+            WriteVarUInt(osOut, m_nUIntValue);
+            break;
+        case ValueType::NONE:
+            break;
+    }
+}
+
+/************************************************************************/
+/*                               read()                                 */
+/************************************************************************/
+
+bool MVTTileLayerValue::read(const GByte* pabyData, const GByte* pabyDataEnd)
+{
+    GUIntBig nKey = 0;
+    if( !ReadVarUInt(pabyData, pabyDataEnd, nKey) )
+        return false;
+    const int nFieldNumber = static_cast<int>(nKey >> 3);
+    const int nWireType = static_cast<int>(nKey & 0x7);
+    if( nFieldNumber == knVALUE_STRING && nWireType == knWT_DATA )
+    {
+        GUIntBig nSize = 0;
+        if( !ReadVarUInt(pabyData, pabyDataEnd, nSize) ||
+            nSize > static_cast<GUIntBig>(pabyDataEnd - pabyData) )
+        {
+            return false;
+        }
+        m_eType = ValueType::STRING;
+        m_osValue.assign(reinterpret_cast<const char*>(pabyData),
+                         static_cast<size_t>(nSize));
+        return true;
+    }
+    if( nFieldNumber == knVALUE_FLOAT && nWireType == knWT_32BIT )
+    {
+        float fValue = 0.0f;
+        if( pabyDataEnd - pabyData < static_cast<int>(sizeof(fValue)) )
+            return false;
+        memcpy(&fValue, pabyData, sizeof(fValue));
+        CPL_LSBPTR32(&fValue);
+        m_eType = ValueType::FLOAT;
+        m_dfValue = fValue;
+        return true;
+    }
+    if( nFieldNumber == knVALUE_DOUBLE && nWireType == knWT_64BIT )
+    {
+        double dfValue = 0.0;
+        if( pabyDataEnd - pabyData < static_cast<int>(sizeof(dfValue)) )
+            return false;
+        memcpy(&dfValue, pabyData, sizeof(dfValue));
+        CPL_LSBPTR64(&dfValue);
+        m_eType = ValueType::DOUBLE;
+        m_dfValue = dfValue;
+        return true;
+    }
+    GUIntBig nVal = 0;
+    if( nWireType != knWT_VARINT ||
+        !ReadVarUInt(pabyData, pabyDataEnd, nVal) )
+    {
+        return false;
+    }
+    switch( nFieldNumber )
+    {
+        case knVALUE_INT:
+            m_eType = ValueType::INT;
+            m_nIntValue = static_cast<GIntBig>(nVal);
+            return true;
+        case knVALUE_UINT:
+            m_eType = ValueType::UINT;
+            m_nUIntValue = nVal;
+            return true;
+        case knVALUE_SINT:
+            m_eType = ValueType::SINT;
+            m_nIntValue = static_cast<GIntBig>(nVal >> 1) ^
+                          -static_cast<GIntBig>(nVal & 1);
+            return true;
+        case knVALUE_BOOL:
+            m_eType = ValueType::BOOL;
+            m_nUIntValue = nVal != 0 ? 1 : 0;
+            return true;
+        default:
+            break;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                    MVTTileLayerFeature::write()                      */
+/************************************************************************/
+
+void MVTTileLayerFeature::write(CPLString& osOut) const
+{
+    if( bHasId )
+    {
+        WriteKey(osOut, knFEATURE_ID, knWT_VARINT);
+        WriteVarUInt(osOut, nId);
+    }
+    if( !anTags.empty() )
+        WritePackedUInt(osOut, knFEATURE_TAGS, anTags);
+    WriteKey(osOut, knFEATURE_TYPE, knWT_VARINT);
+    WriteVarUInt(osOut, nType);
+    WritePackedUInt(osOut, knFEATURE_GEOMETRY, anGeometry);
+}
+
+/************************************************************************/
+/*                              addKey()                                */
+/************************************************************************/
+
+GUInt32 MVTTileLayer::addKey(const CPLString& osKey)
+{
+    auto oIter = m_oMapKeys.find(osKey);
+    if( oIter != m_oMapKeys.end() )
+        return oIter->second;
+    const GUInt32 nIdx = static_cast<GUInt32>(m_aosKeys.size());
+    m_aosKeys.push_back(osKey);
+    m_oMapKeys[osKey] = nIdx;
+    return nIdx;
+}
+
+/************************************************************************/
+/*                             addValue()                               */
+/************************************************************************/
+
+GUInt32 MVTTileLayer::addValue(const MVTTileLayerValue& oValue)
+{
+    auto oIter = m_oMapValues.find(oValue);
+    if( oIter != m_oMapValues.end() )
+        return oIter->second;
+    const GUInt32 nIdx = static_cast<GUInt32>(m_aoValues.size());
+    m_aoValues.push_back(oValue);
+    m_oMapValues[oValue] = nIdx;
+    return nIdx;
+}
+
+/************************************************************************/
+/*                            addFeature()                              */
+/************************************************************************/
+
+MVTTileLayerFeature& MVTTileLayer::addFeature()
+{
+    m_aoFeatures.resize(m_aoFeatures.size() + 1);
+    return m_aoFeatures.back();
+}
+
+/************************************************************************/
+/*                        MVTTileLayer::write()                         */
+/************************************************************************/
+
+void MVTTileLayer::write(CPLString& osOut) const
+{
+    WriteKey(osOut, knLAYER_VERSION, knWT_VARINT);
+    WriteVarUInt(osOut, 2);
+    WriteData(osOut, knLAYER_NAME, m_osName);
+    CPLString osTmp;
+    for( const auto& oFeature: m_aoFeatures )
+    {
+        osTmp.clear();
+        oFeature.write(osTmp);
+        WriteData(osOut, knLAYER_FEATURES, osTmp);
+    }
+    for( const auto& osKey: m_aosKeys )
+    {
+        WriteData(osOut, knLAYER_KEYS, osKey);
+    }
+    for( const auto& oValue: m_aoValues )
+    {
+        osTmp.clear();
+        oValue.write(osTmp);
+        WriteData(osOut, knLAYER_VALUES, osTmp);
+    }
+    WriteKey(osOut, knLAYER_EXTENT, knWT_VARINT);
+    WriteVarUInt(osOut, m_nExtent);
+}
+
+/************************************************************************/
+/*                             addLayer()                               */
+/************************************************************************/
+
+MVTTileLayer& MVTTile::addLayer(const CPLString& osName, unsigned int nExtent)
+{
+    m_aoLayers.push_back(MVTTileLayer(osName, nExtent));
+    return m_aoLayers.back();
+}
+
+/************************************************************************/
+/*                          MVTTile::write()                            */
+/************************************************************************/
+
+void MVTTile::write(CPLString& osOut) const
+{
+    CPLString osTmp;
+    for( const auto& oLayer: m_aoLayers )
+    {
+        if( oLayer.isEmpty() )
+            continue;
+        osTmp.clear();
+        oLayer.write(osTmp);
+        WriteData(osOut, knTILE_LAYER, osTmp);
+    }
+}
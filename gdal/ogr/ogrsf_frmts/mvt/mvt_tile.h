@@ -0,0 +1,165 @@
+/******************************************************************************
+ *
+ * Project:  MVT Translator
+ * Purpose:  Mapbox Vector Tile encoder
+ * Author:   Even Rouault, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, Even Rouault <even dot rouault at spatialys dot com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef MVT_TILE_H
+#define MVT_TILE_H
+
+#include "cpl_port.h"
+#include "cpl_string.h"
+
+#include <map>
+#include <vector>
+
+/************************************************************************/
+/*                         MVTTileLayerValue                            */
+/************************************************************************/
+
+class MVTTileLayerValue
+{
+    public:
+        enum class ValueType
+        {
+            NONE,
+            STRING,
+            FLOAT,
+            DOUBLE,
+            INT,
+            UINT,
+            SINT,
+            BOOL
+        };
+
+    private:
+        ValueType       m_eType = ValueType::NONE;
+        CPLString       m_osValue{};
+        double          m_dfValue = 0.0;
+        GIntBig         m_nIntValue = 0;
+        GUIntBig        m_nUIntValue = 0;
+
+    public:
+        ValueType       getType() const { return m_eType; }
+        const CPLString& getStringValue() const { return m_osValue; }
+        double          getDoubleValue() const { return m_dfValue; }
+        GIntBig         getIntValue() const { return m_nIntValue; }
+        GUIntBig        getUIntValue() const { return m_nUIntValue; }
+        bool            getBoolValue() const { return m_nUIntValue != 0; }
+
+        void            setStringValue(const CPLString& osValue);
+        void            setDoubleValue(double dfValue);
+        void            setIntegerValue(GIntBig nValue);
+        void            setBoolValue(bool bValue);
+
+        bool            operator< (const MVTTileLayerValue& other) const;
+
+        // Append the serialized Value message (without its key and size)
+        void            write(CPLString& osOut) const;
+        bool            read(const GByte* pabyData, const GByte* pabyDataEnd);
+};
+
+/************************************************************************/
+/*                        MVTTileLayerFeature                           */
+/************************************************************************/
+
+struct MVTTileLayerFeature
+{
+    GUIntBig                nId = 0;
+    bool                    bHasId = false;
+    std::vector<GUInt32>    anTags{};
+    unsigned int            nType = 0;
+    std::vector<GUInt32>    anGeometry{};
+
+    void                    write(CPLString& osOut) const;
+};
+
+/************************************************************************/
+/*                           MVTTileLayer                               */
+/************************************************************************/
+
+class MVTTileLayer
+{
+        CPLString                               m_osName;
+        unsigned int                            m_nExtent;
+        std::vector<CPLString>                  m_aosKeys{};
+        std::map<CPLString, GUInt32>            m_oMapKeys{};
+        std::vector<MVTTileLayerValue>          m_aoValues{};
+        std::map<MVTTileLayerValue, GUInt32>    m_oMapValues{};
+        std::vector<MVTTileLayerFeature>        m_aoFeatures{};
+
+    public:
+        MVTTileLayer(const CPLString& osName, unsigned int nExtent) :
+            m_osName(osName), m_nExtent(nExtent) {}
+
+        GUInt32         addKey(const CPLString& osKey);
+        GUInt32         addValue(const MVTTileLayerValue& oValue);
+        MVTTileLayerFeature& addFeature();
+        bool            isEmpty() const { return m_aoFeatures.empty(); }
+
+        void            write(CPLString& osOut) const;
+};
+
+/************************************************************************/
+/*                               MVTTile                                */
+/************************************************************************/
+
+class MVTTile
+{
+        std::vector<MVTTileLayer>   m_aoLayers{};
+
+    public:
+        MVTTileLayer&   addLayer(const CPLString& osName, unsigned int nExtent);
+        int             getLayerCount() const
+                            { return static_cast<int>(m_aoLayers.size()); }
+        MVTTileLayer&   getLayer(int i) { return m_aoLayers[i]; }
+
+        void            write(CPLString& osOut) const;
+};
+
+/* See https://github.com/mapbox/vector-tile-spec/blob/master/2.1/vector_tile.proto */
+constexpr unsigned int knMVT_GEOM_TYPE_POINT = 1;
+constexpr unsigned int knMVT_GEOM_TYPE_LINESTRING = 2;
+constexpr unsigned int knMVT_GEOM_TYPE_POLYGON = 3;
+
+constexpr unsigned int knMVT_CMD_MOVETO = 1;
+constexpr unsigned int knMVT_CMD_LINETO = 2;
+constexpr unsigned int knMVT_CMD_CLOSEPATH = 7;
+
+/* Combine a command id and a command count into a drawing instruction */
+inline GUInt32 MVTGetCmdCountCombined(unsigned int nCmdId,
+                                      unsigned int nCmdCount)
+{
+    return (nCmdId | (nCmdCount << 3));
+}
+
+/* ZigZag encoding of a signed integer */
+inline GUInt32 MVTEncodeSInt32(int nVal)
+{
+    return (static_cast<GUInt32>(nVal) << 1) ^
+           static_cast<GUInt32>(nVal >> 31);
+}
+
+#endif // MVT_TILE_H
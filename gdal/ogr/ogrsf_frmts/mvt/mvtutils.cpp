@@ -59,6 +59,12 @@ void OGRMVTInitFields(OGRFeatureDefn* poFeatureDefn,
                         oField.GetName().c_str(), OFTInteger );
                     poFeatureDefn->AddFieldDefn(&oFieldDefn);
                 }
+                else if( oField.ToString() == "Integer64" ) // GDAL extension
+                {
+                    OGRFieldDefn oFieldDefn(
+                        oField.GetName().c_str(), OFTInteger64 );
+                    poFeatureDefn->AddFieldDefn(&oFieldDefn);
+                }
                 else if( oField.ToString() == "Boolean" )
                 {
                     OGRFieldDefn oFieldDefn(
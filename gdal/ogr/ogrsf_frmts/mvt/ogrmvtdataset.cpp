@@ -40,6 +40,18 @@
 #include <memory>
 #include <vector>
 
+#ifdef HAVE_MVT_WRITE_SUPPORT
+#include "cpl_worker_thread_pool.h"
+#include "mvt_tile.h"
+#include "ogr_spatialref.h"
+
+#include "sqlite3.h"
+#include "zlib.h"
+
+#include <map>
+#include <set>
+#endif
+
 CPL_CVSID("$Id$")
 
 /* See https://github.com/mapbox/vector-tile-spec/blob/master/2.1/vector_tile.proto */
@@ -2756,46 +2768,1748 @@ end_error:
     return nullptr;
 }
 
+#ifdef HAVE_MVT_WRITE_SUPPORT
+
 /************************************************************************/
-/*                           RegisterOGRMVT()                           */
+/*                         OGRMVTWriterLayer                            */
 /************************************************************************/
 
-void RegisterOGRMVT()
+class OGRMVTWriterDataset;
 
+class OGRMVTWriterLayer : public OGRLayer
 {
-    if( GDALGetDriverByName( "MVT" ) != nullptr )
-        return;
+    friend class OGRMVTWriterDataset;
+
+    OGRMVTWriterDataset            *m_poDS = nullptr;
+    int                             m_nLayerIdx = 0;
+    OGRFeatureDefn                 *m_poFeatureDefn = nullptr;
+    OGRCoordinateTransformation    *m_poCT = nullptr;
+    int                             m_nMinZoom = 0;
+    int                             m_nMaxZoom = 5;
+    CPLString                       m_osTargetName{};
+    CPLString                       m_osDescription{};
+    GIntBig                         m_nFeatureCount = 0;
+    bool                            m_bHasPoint = false;
+    bool                            m_bHasLineString = false;
+    bool                            m_bHasPolygon = false;
 
-    GDALDriver  *poDriver = new GDALDriver();
+  public:
+                        OGRMVTWriterLayer(OGRMVTWriterDataset* poDS,
+                                          int nLayerIdx,
+                                          const char* pszLayerName,
+                                          OGRSpatialReference* poSRS);
+                       virtual ~OGRMVTWriterLayer();
+
+    virtual void        ResetReading() override {}
+    virtual OGRFeature *GetNextFeature() override { return nullptr; }
+    virtual OGRFeatureDefn *GetLayerDefn() override { return m_poFeatureDefn; }
+    virtual int         TestCapability(const char*) override;
+    virtual OGRErr      ICreateFeature(OGRFeature*) override;
+    virtual OGRErr      CreateField(OGRFieldDefn*, int) override;
+};
 
-    poDriver->SetDescription( "MVT" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
-                               "MapBox Vector Tiles" );
-    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_mvt.html" );
-    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
-    poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "mvt mvt.gz pbf" );
+/************************************************************************/
+/*                        OGRMVTWriterDataset                           */
+/************************************************************************/
 
-    poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
-"<OpenOptionList>"
-"  <Option name='X' type='int' description='X coordinate of tile'/>"
-"  <Option name='Y' type='int' description='Y coordinate of tile'/>"
-"  <Option name='Z' type='int' description='Z coordinate of tile'/>"
-"  <Option name='METADATA_FILE' type='string' "
-                                "description='Path to metadata.json'/>"
-"  <Option name='CLIP' type='boolean' "
-    "description='Whether to clip geometries to tile extent' default='YES'/>"
-"  <Option name='TILE_EXTENSION' type='string' default='pbf' description="
-    "'For tilesets, extension of tiles'/>"
-"  <Option name='TILE_COUNT_TO_ESTABLISH_FEATURE_DEFN' type='int' description="
-    "'For tilesets without metadata file, maximum number of tiles to use to "
-    "establish the layer schemas' default='1000'/>"
-"  <Option name='JSON_FIELD' type='string' description='For tilesets, "
-        "whether to put all attributes as a serialized JSon dictionary'/>"
-"</OpenOptionList>" );
+/* A feature of a tile, as spooled in the temporary database */
+typedef struct
+{
+    int         nLayerIdx;
+    GIntBig     nFID;
+    CPLString   osGeom;     // WKB, in EPSG:3857
+    CPLString   osAttrs;    // see OGRMVTWriterLayer::ICreateFeature()
+} OGRMVTWriterTileFeature;
+
+typedef struct
+{
+    OGRMVTWriterDataset                 *poDS;
+    int                                  nZ;
+    int                                  nX;
+    int                                  nY;
+    std::vector<OGRMVTWriterTileFeature> asFeatures;
+    CPLString                            osTileData;
+} OGRMVTWriterTileJob;
+
+class OGRMVTWriterDataset : public GDALDataset
+{
+    friend class OGRMVTWriterLayer;
+
+    std::vector<std::unique_ptr<OGRMVTWriterLayer>> m_apoLayers{};
+    CPLString           m_osTempDB{};
+    sqlite3            *m_hTempDB = nullptr;
+    sqlite3_stmt       *m_hInsertFeatureStmt = nullptr;
+    sqlite3_stmt       *m_hInsertTileStmt = nullptr;
+    bool                m_bMBTiles = false;
+    sqlite3            *m_hDBMBTiles = nullptr;
+    sqlite3_stmt       *m_hInsertMBTilesStmt = nullptr;
+    std::set<CPLString> m_oSetCreatedDirs{};
+    int                 m_nMinZoom = 0;
+    int                 m_nMaxZoom = 5;
+    unsigned int        m_nExtent = 4096;
+    unsigned int        m_nBuffer = 80;
+    double              m_dfSimplification = 0.0;
+    bool                m_bGZip = true;
+    CPLString           m_osName{};
+    CPLString           m_osDescription{};
+    CPLString           m_osType{"overlay"};
+    OGREnvelope         m_oEnvelope{};
+    CPLWorkerThreadPool *m_poWTP = nullptr;
+    int                 m_nNumThreads = 1;
+    bool                m_bFinalized = false;
+    bool                m_bError = false;
+
+    bool                CreateTempDB();
+    bool                Finalize();
+    bool                GenerateTiles();
+    bool                ProcessTileJobs(std::vector<OGRMVTWriterTileJob>& asJobs);
+    bool                WriteTile(int nZ, int nX, int nY,
+                                  const CPLString& osTileData);
+    bool                WriteMetadata();
+    static void         GenerateTileJob(void* pData);
+
+  public:
+                        OGRMVTWriterDataset() = default;
+                       virtual ~OGRMVTWriterDataset();
+
+    virtual int         GetLayerCount() override
+                        { return static_cast<int>(m_apoLayers.size()); }
+    virtual OGRLayer   *GetLayer( int ) override;
+    virtual int         TestCapability( const char * ) override;
+
+    virtual OGRLayer   *ICreateLayer( const char *pszName,
+                                      OGRSpatialReference *poSRS,
+                                      OGRwkbGeometryType eGType,
+                                      char ** papszOptions ) override;
+
+    static GDALDataset* Create( const char * pszFilename,
+                                int nXSize, int nYSize, int nBandsIn,
+                                GDALDataType eDT,
+                                char ** papszOptions );
+};
+
+/************************************************************************/
+/*                    OGRMVTLongLatToWebMercator                        */
+/************************************************************************/
+
+/* Spherical mercator transformation from WGS84 long/lat, which is the most
+ * common case, and does not require PROJ.4 */
+class OGRMVTLongLatToWebMercator : public OGRCoordinateTransformation
+{
+    OGRSpatialReference *m_poSourceCS;
+    OGRSpatialReference *m_poTargetCS;
+
+  public:
+    OGRMVTLongLatToWebMercator(OGRSpatialReference* poSourceCS,
+                               OGRSpatialReference* poTargetCS) :
+        m_poSourceCS(poSourceCS->Clone()),
+        m_poTargetCS(poTargetCS->Clone()) {}
+
+    virtual ~OGRMVTLongLatToWebMercator()
+    {
+        m_poSourceCS->Release();
+        m_poTargetCS->Release();
+    }
+
+    virtual OGRSpatialReference *GetSourceCS() override
+                                                { return m_poSourceCS; }
+    virtual OGRSpatialReference *GetTargetCS() override
+                                                { return m_poTargetCS; }
+
+    virtual int Transform( int nCount, double *x, double *y,
+                           double *z = nullptr ) override
+    {
+        return TransformEx(nCount, x, y, z, nullptr);
+    }
+
+    virtual int TransformEx( int nCount, double *x, double *y,
+                             double * /* z */ = nullptr,
+                             int *pabSuccess = nullptr ) override
+    {
+        // Latitude of the edges of the EPSG:3857 square
+        constexpr double dfMAX_LAT = 85.0511287798066;
+        for( int i = 0; i < nCount; i++ )
+        {
+            y[i] = std::max(-dfMAX_LAT, std::min(dfMAX_LAT, y[i]));
+            LongLatToSphericalMercator(&x[i], &y[i]);
+            if( pabSuccess )
+                pabSuccess[i] = TRUE;
+        }
+        return TRUE;
+    }
+};
+
+/************************************************************************/
+/*                         OGRMVTWriterLayer()                          */
+/************************************************************************/
+
+OGRMVTWriterLayer::OGRMVTWriterLayer(OGRMVTWriterDataset* poDS,
+                                     int nLayerIdx,
+                                     const char* pszLayerName,
+                                     OGRSpatialReference* poSRS) :
+    m_poDS(poDS),
+    m_nLayerIdx(nLayerIdx),
+    m_nMinZoom(poDS->m_nMinZoom),
+    m_nMaxZoom(poDS->m_nMaxZoom),
+    m_osTargetName(pszLayerName)
+{
+    m_poFeatureDefn = new OGRFeatureDefn(pszLayerName);
+    SetDescription(m_poFeatureDefn->GetName());
+    m_poFeatureDefn->Reference();
+
+    OGRSpatialReference* poSRS3857 = new OGRSpatialReference();
+    poSRS3857->SetFromUserInput(SRS_EPSG_3857);
+    m_poFeatureDefn->GetGeomFieldDefn(0)->SetSpatialRef(poSRS3857);
+    if( poSRS != nullptr && !poSRS->IsSame(poSRS3857) )
+    {
+        OGRSpatialReference oSRS4326;
+        oSRS4326.SetWellKnownGeogCS("WGS84");
+        if( poSRS->IsSame(&oSRS4326) )
+            m_poCT = new OGRMVTLongLatToWebMercator(poSRS, poSRS3857);
+        else
+            m_poCT = OGRCreateCoordinateTransformation(poSRS, poSRS3857);
+    }
+    poSRS3857->Release();
+}
+
+/************************************************************************/
+/*                        ~OGRMVTWriterLayer()                          */
+/************************************************************************/
+
+OGRMVTWriterLayer::~OGRMVTWriterLayer()
+{
+    m_poFeatureDefn->Release();
+    delete m_poCT;
+}
+
+/************************************************************************/
+/*                           TestCapability()                           */
+/************************************************************************/
+
+int OGRMVTWriterLayer::TestCapability(const char* pszCap)
+{
+    if( EQUAL(pszCap, OLCSequentialWrite) ||
+        EQUAL(pszCap, OLCCreateField) )
+    {
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/************************************************************************/
+/*                            CreateField()                             */
+/************************************************************************/
+
+OGRErr OGRMVTWriterLayer::CreateField(OGRFieldDefn* poFieldDefn, int)
+{
+    if( m_nFeatureCount > 0 )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "CreateField() not supported after features have been "
+                 "written");
+        return OGRERR_FAILURE;
+    }
+    m_poFeatureDefn->AddFieldDefn(poFieldDefn);
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                        CollectGeometryKinds()                        */
+/************************************************************************/
+
+static void CollectGeometryKinds(const OGRGeometry* poGeom,
+                                 bool& bHasPoint,
+                                 bool& bHasLineString,
+                                 bool& bHasPolygon)
+{
+    const OGRwkbGeometryType eType = wkbFlatten(poGeom->getGeometryType());
+    if( eType == wkbPoint || eType == wkbMultiPoint )
+        bHasPoint = true;
+    else if( eType == wkbLineString || eType == wkbMultiLineString )
+        bHasLineString = true;
+    else if( eType == wkbPolygon || eType == wkbMultiPolygon )
+        bHasPolygon = true;
+    else if( eType == wkbGeometryCollection )
+    {
+        const OGRGeometryCollection* poGC =
+            static_cast<const OGRGeometryCollection*>(poGeom);
+        for( int i = 0; i < poGC->getNumGeometries(); i++ )
+        {
+            CollectGeometryKinds(poGC->getGeometryRef(i),
+                                 bHasPoint, bHasLineString, bHasPolygon);
+        }
+    }
+}
+
+/************************************************************************/
+/*                          ICreateFeature()                            */
+/************************************************************************/
+
+OGRErr OGRMVTWriterLayer::ICreateFeature(OGRFeature* poFeature)
+{
+    if( m_poDS->m_bError )
+        return OGRERR_FAILURE;
+
+    OGRGeometry* poSrcGeom = poFeature->GetGeometryRef();
+    // MVT features without a geometry cannot be represented
+    if( poSrcGeom == nullptr || poSrcGeom->IsEmpty() )
+        return OGRERR_NONE;
+
+    std::unique_ptr<OGRGeometry> poGeom;
+    if( poSrcGeom->hasCurveGeometry() )
+        poGeom.reset(poSrcGeom->getLinearGeometry());
+    else
+        poGeom.reset(poSrcGeom->clone());
+    if( m_poCT != nullptr && poGeom->transform(m_poCT) != OGRERR_NONE )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Cannot reproject feature " CPL_FRMT_GIB " to EPSG:3857",
+                 poFeature->GetFID());
+        return OGRERR_FAILURE;
+    }
+    poGeom->flattenTo2D();
+
+    OGREnvelope sEnvelope;
+    poGeom->getEnvelope(&sEnvelope);
+    if( !(sEnvelope.MaxX >= -kmMAX_GM && sEnvelope.MinX <= kmMAX_GM &&
+          sEnvelope.MaxY >= -kmMAX_GM && sEnvelope.MinY <= kmMAX_GM) )
+    {
+        CPLDebug("MVT", "Feature " CPL_FRMT_GIB " out of tiling extent",
+                 poFeature->GetFID());
+        return OGRERR_NONE;
+    }
+    m_poDS->m_oEnvelope.Merge(sEnvelope);
+    CollectGeometryKinds(poGeom.get(),
+                         m_bHasPoint, m_bHasLineString, m_bHasPolygon);
+
+    // Attributes are serialized as a sequence of (field index, value size,
+    // MVT Value message) items, so that the worker threads do not need
+    // to access the OGRFeature.
+    CPLString osAttrs;
+    for( int i = 0; i < m_poFeatureDefn->GetFieldCount(); i++ )
+    {
+        if( !poFeature->IsFieldSetAndNotNull(i) )
+            continue;
+        OGRFieldDefn* poFDefn = m_poFeatureDefn->GetFieldDefn(i);
+        MVTTileLayerValue oValue;
+        const OGRFieldType eType = poFDefn->GetType();
+        if( eType == OFTInteger || eType == OFTInteger64 )
+        {
+            if( poFDefn->GetSubType() == OFSTBoolean )
+                oValue.setBoolValue(poFeature->GetFieldAsInteger(i) != 0);
+            else
+                oValue.setIntegerValue(poFeature->GetFieldAsInteger64(i));
+        }
+        else if( eType == OFTReal )
+        {
+            oValue.setDoubleValue(poFeature->GetFieldAsDouble(i));
+        }
+        else
+        {
+            oValue.setStringValue(poFeature->GetFieldAsString(i));
+        }
+        CPLString osValue;
+        oValue.write(osValue);
+        GUInt32 anHeader[2] = { static_cast<GUInt32>(i),
+                                static_cast<GUInt32>(osValue.size()) };
+        CPL_LSBPTR32(&anHeader[0]);
+        CPL_LSBPTR32(&anHeader[1]);
+        osAttrs.append(reinterpret_cast<const char*>(anHeader),
+                       sizeof(anHeader));
+        osAttrs += osValue;
+    }
+
+    const int nWKBSize = poGeom->WkbSize();
+    std::vector<GByte> abyWKB(nWKBSize);
+    poGeom->exportToWkb(wkbNDR, &abyWKB[0], wkbVariantIso);
+
+    sqlite3_stmt* hStmt = m_poDS->m_hInsertFeatureStmt;
+    sqlite3_reset(hStmt);
+    sqlite3_bind_int(hStmt, 1, m_nLayerIdx);
+    sqlite3_bind_int64(hStmt, 2, poFeature->GetFID());
+    sqlite3_bind_blob(hStmt, 3, &abyWKB[0], nWKBSize, SQLITE_STATIC);
+    sqlite3_bind_blob(hStmt, 4, osAttrs.c_str(),
+                      static_cast<int>(osAttrs.size()), SQLITE_STATIC);
+    if( sqlite3_step(hStmt) != SQLITE_DONE )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Insertion failed: %s",
+                 sqlite3_errmsg(m_poDS->m_hTempDB));
+        m_poDS->m_bError = true;
+        return OGRERR_FAILURE;
+    }
+    const GIntBig nTempId = sqlite3_last_insert_rowid(m_poDS->m_hTempDB);
+
+    // Register the feature in each tile it intersects, taking into account
+    // the tile buffer.
+    hStmt = m_poDS->m_hInsertTileStmt;
+    for( int nZ = m_nMinZoom; nZ <= m_nMaxZoom; nZ++ )
+    {
+        const int nTileCount = 1 << nZ;
+        const double dfTileDim = 2 * kmMAX_GM / nTileCount;
+        const double dfBuffer = dfTileDim * m_poDS->m_nBuffer /
+                                m_poDS->m_nExtent;
+        const int nX0 = std::max(0, static_cast<int>(
+            floor((sEnvelope.MinX - dfBuffer + kmMAX_GM) / dfTileDim)));
+        const int nX1 = std::min(nTileCount - 1, static_cast<int>(
+            floor((sEnvelope.MaxX + dfBuffer + kmMAX_GM) / dfTileDim)));
+        const int nY0 = std::max(0, static_cast<int>(
+            floor((kmMAX_GM - (sEnvelope.MaxY + dfBuffer)) / dfTileDim)));
+        const int nY1 = std::min(nTileCount - 1, static_cast<int>(
+            floor((kmMAX_GM - (sEnvelope.MinY - dfBuffer)) / dfTileDim)));
+        for( int nX = nX0; nX <= nX1; nX++ )
+        {
+            for( int nY = nY0; nY <= nY1; nY++ )
+            {
+                sqlite3_reset(hStmt);
+                sqlite3_bind_int(hStmt, 1, nZ);
+                sqlite3_bind_int(hStmt, 2, nX);
+                sqlite3_bind_int(hStmt, 3, nY);
+                sqlite3_bind_int64(hStmt, 4, nTempId);
+                if( sqlite3_step(hStmt) != SQLITE_DONE )
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "Insertion failed: %s",
+                             sqlite3_errmsg(m_poDS->m_hTempDB));
+                    m_poDS->m_bError = true;
+                    return OGRERR_FAILURE;
+                }
+            }
+        }
+    }
+
+    m_nFeatureCount ++;
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                        ~OGRMVTWriterDataset()                        */
+/************************************************************************/
+
+OGRMVTWriterDataset::~OGRMVTWriterDataset()
+{
+    Finalize();
+
+    if( m_hInsertFeatureStmt )
+        sqlite3_finalize(m_hInsertFeatureStmt);
+    if( m_hInsertTileStmt )
+        sqlite3_finalize(m_hInsertTileStmt);
+    if( m_hTempDB )
+    {
+        sqlite3_close(m_hTempDB);
+        VSIUnlink(m_osTempDB);
+    }
+    if( m_hInsertMBTilesStmt )
+        sqlite3_finalize(m_hInsertMBTilesStmt);
+    if( m_hDBMBTiles )
+        sqlite3_close(m_hDBMBTiles);
+    delete m_poWTP;
+}
+
+/************************************************************************/
+/*                              GetLayer()                              */
+/************************************************************************/
+
+OGRLayer* OGRMVTWriterDataset::GetLayer(int i)
+{
+    if( i < 0 || i >= GetLayerCount() )
+        return nullptr;
+    return m_apoLayers[i].get();
+}
+
+/************************************************************************/
+/*                           TestCapability()                           */
+/************************************************************************/
+
+int OGRMVTWriterDataset::TestCapability(const char* pszCap)
+{
+    if( EQUAL(pszCap, ODsCCreateLayer) )
+        return !m_bFinalized;
+    return FALSE;
+}
+
+/************************************************************************/
+/*                            ICreateLayer()                            */
+/************************************************************************/
+
+OGRLayer* OGRMVTWriterDataset::ICreateLayer( const char *pszLayerName,
+                                             OGRSpatialReference *poSRS,
+                                             OGRwkbGeometryType,
+                                             char ** papszOptions )
+{
+    OGRMVTWriterLayer* poLayer = new OGRMVTWriterLayer(
+        this, static_cast<int>(m_apoLayers.size()), pszLayerName, poSRS);
+    if( poSRS != nullptr && poLayer->m_poCT == nullptr &&
+        !poLayer->GetLayerDefn()->GetGeomFieldDefn(0)->GetSpatialRef()->
+                                                        IsSame(poSRS) )
+    {
+        delete poLayer;
+        return nullptr;
+    }
+    poLayer->m_nMinZoom = atoi(CSLFetchNameValueDef(papszOptions, "MINZOOM",
+                                        CPLSPrintf("%d", m_nMinZoom)));
+    poLayer->m_nMaxZoom = atoi(CSLFetchNameValueDef(papszOptions, "MAXZOOM",
+                                        CPLSPrintf("%d", m_nMaxZoom)));
+    if( poLayer->m_nMinZoom < 0 || poLayer->m_nMinZoom > 22 ||
+        poLayer->m_nMaxZoom < poLayer->m_nMinZoom ||
+        poLayer->m_nMaxZoom > 22 )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Invalid MINZOOM / MAXZOOM values");
+        delete poLayer;
+        return nullptr;
+    }
+    poLayer->m_osTargetName = CSLFetchNameValueDef(papszOptions, "NAME",
+                                                   pszLayerName);
+    poLayer->m_osDescription = CSLFetchNameValueDef(papszOptions,
+                                                    "DESCRIPTION", "");
+    m_apoLayers.push_back(std::unique_ptr<OGRMVTWriterLayer>(poLayer));
+    return poLayer;
+}
+
+/************************************************************************/
+/*                            CreateTempDB()                            */
+/************************************************************************/
+
+bool OGRMVTWriterDataset::CreateTempDB()
+{
+    if( sqlite3_open_v2(m_osTempDB, &m_hTempDB,
+                        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                        nullptr) != SQLITE_OK )
+    {
+        CPLError(CE_Failure, CPLE_OpenFailed, "Cannot create %s",
+                 m_osTempDB.c_str());
+        return false;
+    }
+    // The temporary database is thrown away at the end, so no need for
+    // durability.
+    const char* const apszSQL[] = {
+        "PRAGMA synchronous = OFF",
+        "PRAGMA journal_mode = OFF",
+        "CREATE TABLE temp_features(id INTEGER PRIMARY KEY, layer INTEGER, "
+            "fid INTEGER, geom BLOB, attrs BLOB)",
+        "CREATE TABLE temp_tiles(z INTEGER, x INTEGER, y INTEGER, "
+            "feature INTEGER)",
+        "BEGIN" };
+    for( const char* pszSQL: apszSQL )
+    {
+        if( sqlite3_exec(m_hTempDB, pszSQL, nullptr, nullptr, nullptr) !=
+                                                                SQLITE_OK )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "%s failed: %s",
+                     pszSQL, sqlite3_errmsg(m_hTempDB));
+            return false;
+        }
+    }
+    if( sqlite3_prepare_v2(m_hTempDB,
+            "INSERT INTO temp_features(layer, fid, geom, attrs) "
+            "VALUES (?,?,?,?)", -1, &m_hInsertFeatureStmt,
+            nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(m_hTempDB,
+            "INSERT INTO temp_tiles(z, x, y, feature) VALUES (?,?,?,?)",
+            -1, &m_hInsertTileStmt, nullptr) != SQLITE_OK )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Cannot prepare statement: %s",
+                 sqlite3_errmsg(m_hTempDB));
+        return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                          Tile geometry encoding                      */
+/************************************************************************/
+
+/* Parameters to convert EPSG:3857 coordinates into tile coordinates, and
+ * to clip them to the buffered tile extent */
+typedef struct
+{
+    double  dfX0;
+    double  dfY0;
+    double  dfScale;
+    double  dfClipMin;
+    double  dfClipMax;
+    double  dfTolerance;
+} OGRMVTTileTransform;
+
+/* State of the command encoder of a feature geometry */
+typedef struct
+{
+    std::vector<GUInt32>   *panGeometry;
+    int                     nLastX;
+    int                     nLastY;
+} OGRMVTGeomEncoder;
+
+typedef std::vector<OGRRawPoint> OGRMVTPath;
+
+/************************************************************************/
+/*                           ToTileCoords()                             */
+/************************************************************************/
+
+static void ToTileCoords(const OGRSimpleCurve* poCurve,
+                         const OGRMVTTileTransform& sTransform,
+                         OGRMVTPath& aoPath)
+{
+    const int nPoints = poCurve->getNumPoints();
+    aoPath.resize(nPoints);
+    for( int i = 0; i < nPoints; i++ )
+    {
+        aoPath[i].x = (poCurve->getX(i) - sTransform.dfX0) *
+                                                    sTransform.dfScale;
+        aoPath[i].y = (sTransform.dfY0 - poCurve->getY(i)) *
+                                                    sTransform.dfScale;
+    }
+}
+
+/************************************************************************/
+/*                          IsInsideClipBox()                           */
+/************************************************************************/
+
+static bool IsInsideClipBox(const OGRMVTPath& aoPath,
+                            const OGRMVTTileTransform& sTransform)
+{
+    for( const auto& oPoint: aoPath )
+    {
+        if( oPoint.x < sTransform.dfClipMin ||
+            oPoint.x > sTransform.dfClipMax ||
+            oPoint.y < sTransform.dfClipMin ||
+            oPoint.y > sTransform.dfClipMax )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                              ClipLine()                              */
+/************************************************************************/
+
+// Liang-Barsky clipping of each segment against the clip box. Returns the
+// resulting parts.
+static std::vector<OGRMVTPath> ClipLine(const OGRMVTPath& aoPath,
+                                        const OGRMVTTileTransform& sTransform)
+{
+    const double dfMin = sTransform.dfClipMin;
+    const double dfMax = sTransform.dfClipMax;
+    std::vector<OGRMVTPath> aoParts;
+    bool bInPart = false;
+    for( size_t i = 0; i + 1 < aoPath.size(); i++ )
+    {
+        const double dfX0 = aoPath[i].x;
+        const double dfY0 = aoPath[i].y;
+        const double dfDX = aoPath[i+1].x - dfX0;
+        const double dfDY = aoPath[i+1].y - dfY0;
+        double dfT0 = 0.0;
+        double dfT1 = 1.0;
+        const double adfP[4] = { -dfDX, dfDX, -dfDY, dfDY };
+        const double adfQ[4] = { dfX0 - dfMin, dfMax - dfX0,
+                                 dfY0 - dfMin, dfMax - dfY0 };
+        bool bVisible = true;
+        for( int k = 0; k < 4 && bVisible; k++ )
+        {
+            if( adfP[k] == 0.0 )
+            {
+                if( adfQ[k] < 0.0 )
+                    bVisible = false;
+            }
+            else
+            {
+                const double dfR = adfQ[k] / adfP[k];
+                if( adfP[k] < 0.0 )
+                {
+                    if( dfR > dfT1 )
+                        bVisible = false;
+                    else if( dfR > dfT0 )
+                        dfT0 = dfR;
+                }
+                else
+                {
+                    if( dfR < dfT0 )
+                        bVisible = false;
+                    else if( dfR < dfT1 )
+                        dfT1 = dfR;
+                }
+            }
+        }
+        if( !bVisible )
+        {
+            bInPart = false;
+            continue;
+        }
+        if( !bInPart || dfT0 > 0.0 )
+        {
+            aoParts.resize(aoParts.size() + 1);
+            OGRRawPoint oStart;
+            oStart.x = dfX0 + dfT0 * dfDX;
+            oStart.y = dfY0 + dfT0 * dfDY;
+            aoParts.back().push_back(oStart);
+        }
+        OGRRawPoint oEnd;
+        oEnd.x = dfX0 + dfT1 * dfDX;
+        oEnd.y = dfY0 + dfT1 * dfDY;
+        aoParts.back().push_back(oEnd);
+        bInPart = dfT1 == 1.0;
+    }
+    return aoParts;
+}
+
+/************************************************************************/
+/*                              ClipRing()                              */
+/************************************************************************/
+
+// Sutherland-Hodgman clipping of a closed ring against the clip box.
+// The resulting ring may have degenerate edges along the box, which is
+// harmless for rendering.
+static OGRMVTPath ClipRing(const OGRMVTPath& aoRing,
+                           const OGRMVTTileTransform& sTransform)
+{
+    OGRMVTPath aoIn(aoRing);
+    if( !aoIn.empty() )
+        aoIn.pop_back(); // remove closing point
+    OGRMVTPath aoOut;
+    for( int nEdge = 0; nEdge < 4 && !aoIn.empty(); nEdge++ )
+    {
+        const bool bX = (nEdge % 2) == 0;
+        const bool bMin = nEdge < 2;
+        const double dfLimit = bMin ? sTransform.dfClipMin :
+                                      sTransform.dfClipMax;
+        auto IsInside = [bX, bMin, dfLimit](const OGRRawPoint& oP)
+        {
+            const double dfV = bX ? oP.x : oP.y;
+            return bMin ? dfV >= dfLimit : dfV <= dfLimit;
+        };
+        auto Intersect = [bX, dfLimit](const OGRRawPoint& oA,
+                                       const OGRRawPoint& oB)
+        {
+            OGRRawPoint oP;
+            if( bX )
+            {
+                const double dfT = (dfLimit - oA.x) / (oB.x - oA.x);
+                oP.x = dfLimit;
+                oP.y = oA.y + dfT * (oB.y - oA.y);
+            }
+            else
+            {
+                const double dfT = (dfLimit - oA.y) / (oB.y - oA.y);
+                oP.x = oA.x + dfT * (oB.x - oA.x);
+                oP.y = dfLimit;
+            }
+            return oP;
+        };
+
+        aoOut.clear();
+        OGRRawPoint oPrev = aoIn.back();
+        bool bPrevInside = IsInside(oPrev);
+        for( const auto& oCur: aoIn )
+        {
+            const bool bCurInside = IsInside(oCur);
+            if( bCurInside )
+            {
+                if( !bPrevInside )
+                    aoOut.push_back(Intersect(oPrev, oCur));
+                aoOut.push_back(oCur);
+            }
+            else if( bPrevInside )
+            {
+                aoOut.push_back(Intersect(oPrev, oCur));
+            }
+            oPrev = oCur;
+            bPrevInside = bCurInside;
+        }
+        std::swap(aoIn, aoOut);
+    }
+    if( !aoIn.empty() )
+        aoIn.push_back(aoIn.front());
+    return aoIn;
+}
+
+/************************************************************************/
+/*                           SimplifyPath()                             */
+/************************************************************************/
+
+// Douglas-Peucker simplification, in tile coordinates.
+static void SimplifyPath(OGRMVTPath& aoPath, double dfTolerance)
+{
+    const size_t nPoints = aoPath.size();
+    if( dfTolerance <= 0.0 || nPoints <= 2 )
+        return;
+    const double dfTolerance2 = dfTolerance * dfTolerance;
+    std::vector<bool> abKeep(nPoints, false);
+    abKeep[0] = true;
+    abKeep[nPoints - 1] = true;
+    std::vector<std::pair<size_t, size_t>> aoStack;
+    aoStack.push_back(std::pair<size_t, size_t>(0, nPoints - 1));
+    while( !aoStack.empty() )
+    {
+        const size_t iFirst = aoStack.back().first;
+        const size_t iLast = aoStack.back().second;
+        aoStack.pop_back();
+        const double dfX0 = aoPath[iFirst].x;
+        const double dfY0 = aoPath[iFirst].y;
+        const double dfDX = aoPath[iLast].x - dfX0;
+        const double dfDY = aoPath[iLast].y - dfY0;
+        const double dfLen2 = dfDX * dfDX + dfDY * dfDY;
+        double dfMaxDist2 = -1.0;
+        size_t iMax = iFirst;
+        for( size_t i = iFirst + 1; i < iLast; i++ )
+        {
+            double dfX = aoPath[i].x - dfX0;
+            double dfY = aoPath[i].y - dfY0;
+            if( dfLen2 > 0.0 )
+            {
+                const double dfT = std::max(0.0, std::min(1.0,
+                                    (dfX * dfDX + dfY * dfDY) / dfLen2));
+                dfX -= dfT * dfDX;
+                dfY -= dfT * dfDY;
+            }
+            const double dfDist2 = dfX * dfX + dfY * dfY;
+            if( dfDist2 > dfMaxDist2 )
+            {
+                dfMaxDist2 = dfDist2;
+                iMax = i;
+            }
+        }
+        if( dfMaxDist2 > dfTolerance2 )
+        {
+            abKeep[iMax] = true;
+            aoStack.push_back(std::pair<size_t, size_t>(iFirst, iMax));
+            aoStack.push_back(std::pair<size_t, size_t>(iMax, iLast));
+        }
+    }
+    size_t j = 0;
+    for( size_t i = 0; i < nPoints; i++ )
+    {
+        if( abKeep[i] )
+            aoPath[j++] = aoPath[i];
+    }
+    aoPath.resize(j);
+}
+
+/************************************************************************/
+/*                           QuantizePath()                             */
+/************************************************************************/
+
+// Round to the tile integer grid, and remove repeated points.
+static void QuantizePath(const OGRMVTPath& aoPath,
+                         std::vector<std::pair<int, int>>& aoOut)
+{
+    aoOut.clear();
+    for( const auto& oPoint: aoPath )
+    {
+        const std::pair<int, int> oIntPoint(
+            static_cast<int>(floor(oPoint.x + 0.5)),
+            static_cast<int>(floor(oPoint.y + 0.5)));
+        if( aoOut.empty() || aoOut.back() != oIntPoint )
+            aoOut.push_back(oIntPoint);
+    }
+}
+
+/************************************************************************/
+/*                            EncodePath()                              */
+/************************************************************************/
+
+static void EncodePath(OGRMVTGeomEncoder& sEncoder,
+                       const std::vector<std::pair<int, int>>& aoPoints,
+                       size_t nPoints,
+                       bool bClosePath)
+{
+    std::vector<GUInt32>& anGeometry = *(sEncoder.panGeometry);
+    for( size_t i = 0; i < nPoints; i++ )
+    {
+        if( i == 0 )
+        {
+            anGeometry.push_back(
+                MVTGetCmdCountCombined(knMVT_CMD_MOVETO, 1));
+        }
+        else if( i == 1 )
+        {
+            anGeometry.push_back(MVTGetCmdCountCombined(
+                knMVT_CMD_LINETO, static_cast<unsigned>(nPoints - 1)));
+        }
+        anGeometry.push_back(
+            MVTEncodeSInt32(aoPoints[i].first - sEncoder.nLastX));
+        anGeometry.push_back(
+            MVTEncodeSInt32(aoPoints[i].second - sEncoder.nLastY));
+        sEncoder.nLastX = aoPoints[i].first;
+        sEncoder.nLastY = aoPoints[i].second;
+    }
+    if( bClosePath )
+    {
+        anGeometry.push_back(
+            MVTGetCmdCountCombined(knMVT_CMD_CLOSEPATH, 1));
+    }
+}
+
+/************************************************************************/
+/*                         EncodeLineString()                           */
+/************************************************************************/
+
+static void EncodeLineString(const OGRLineString* poLS,
+                             const OGRMVTTileTransform& sTransform,
+                             OGRMVTGeomEncoder& sEncoder)
+{
+    OGRMVTPath aoPath;
+    ToTileCoords(poLS, sTransform, aoPath);
+    std::vector<OGRMVTPath> aoParts;
+    if( IsInsideClipBox(aoPath, sTransform) )
+        aoParts.push_back(aoPath);
+    else
+        aoParts = ClipLine(aoPath, sTransform);
+
+    std::vector<std::pair<int, int>> aoIntPoints;
+    for( auto& aoPart: aoParts )
+    {
+        SimplifyPath(aoPart, sTransform.dfTolerance);
+        QuantizePath(aoPart, aoIntPoints);
+        if( aoIntPoints.size() >= 2 )
+            EncodePath(sEncoder, aoIntPoints, aoIntPoints.size(), false);
+    }
+}
+
+/************************************************************************/
+/*                            GetRingArea()                             */
+/************************************************************************/
+
+// Surveyor's formula, in tile coordinates (y down).
+static GIntBig GetRingArea(const std::vector<std::pair<int, int>>& aoRing)
+{
+    GIntBig nArea2 = 0;
+    for( size_t i = 0; i + 1 < aoRing.size(); i++ )
+    {
+        nArea2 += static_cast<GIntBig>(aoRing[i].first) *
+                                            aoRing[i+1].second -
+                  static_cast<GIntBig>(aoRing[i+1].first) *
+                                            aoRing[i].second;
+    }
+    return nArea2;
+}
+
+/************************************************************************/
+/*                           EncodePolygon()                            */
+/************************************************************************/
+
+static void EncodePolygon(const OGRPolygon* poPoly,
+                          const OGRMVTTileTransform& sTransform,
+                          OGRMVTGeomEncoder& sEncoder)
+{
+    OGRMVTPath aoPath;
+    std::vector<std::pair<int, int>> aoIntPoints;
+    for( int i = 0; i < 1 + poPoly->getNumInteriorRings(); i++ )
+    {
+        const OGRLinearRing* poRing = (i == 0) ?
+            poPoly->getExteriorRing() : poPoly->getInteriorRing(i - 1);
+        ToTileCoords(poRing, sTransform, aoPath);
+        if( !IsInsideClipBox(aoPath, sTransform) )
+            aoPath = ClipRing(aoPath, sTransform);
+        SimplifyPath(aoPath, sTransform.dfTolerance);
+        QuantizePath(aoPath, aoIntPoints);
+        if( !aoIntPoints.empty() && aoIntPoints.front() != aoIntPoints.back() )
+            aoIntPoints.push_back(aoIntPoints.front());
+        const GIntBig nArea2 = GetRingArea(aoIntPoints);
+        if( aoIntPoints.size() < 4 || nArea2 == 0 )
+        {
+            // A polygon without its exterior ring is dropped entirely
+            if( i == 0 )
+                return;
+            continue;
+        }
+        // Exterior rings must have a positive area, and interior rings a
+        // negative one.
+        if( (i == 0) != (nArea2 > 0) )
+            std::reverse(aoIntPoints.begin(), aoIntPoints.end());
+        EncodePath(sEncoder, aoIntPoints, aoIntPoints.size() - 1, true);
+    }
+}
+
+/************************************************************************/
+/*                          EncodeGeometry()                            */
+/************************************************************************/
+
+// Encode the parts of poGeom of the given MVT geometry type.
+static void EncodeGeometry(const OGRGeometry* poGeom,
+                           unsigned int nMVTType,
+                           const OGRMVTTileTransform& sTransform,
+                           OGRMVTGeomEncoder& sEncoder,
+                           std::vector<std::pair<int, int>>& aoPoints)
+{
+    const OGRwkbGeometryType eType = wkbFlatten(poGeom->getGeometryType());
+    if( eType == wkbPoint )
+    {
+        if( nMVTType != knMVT_GEOM_TYPE_POINT )
+            return;
+        const OGRPoint* poPoint = static_cast<const OGRPoint*>(poGeom);
+        if( poPoint->IsEmpty() )
+            return;
+        const double dfX = (poPoint->getX() - sTransform.dfX0) *
+                                                    sTransform.dfScale;
+        const double dfY = (sTransform.dfY0 - poPoint->getY()) *
+                                                    sTransform.dfScale;
+        if( dfX >= sTransform.dfClipMin && dfX <= sTransform.dfClipMax &&
+            dfY >= sTransform.dfClipMin && dfY <= sTransform.dfClipMax )
+        {
+            aoPoints.push_back(std::pair<int, int>(
+                static_cast<int>(floor(dfX + 0.5)),
+                static_cast<int>(floor(dfY + 0.5))));
+        }
+    }
+    else if( eType == wkbLineString )
+    {
+        if( nMVTType == knMVT_GEOM_TYPE_LINESTRING )
+        {
+            EncodeLineString(static_cast<const OGRLineString*>(poGeom),
+                             sTransform, sEncoder);
+        }
+    }
+    else if( eType == wkbPolygon )
+    {
+        if( nMVTType == knMVT_GEOM_TYPE_POLYGON )
+        {
+            EncodePolygon(static_cast<const OGRPolygon*>(poGeom),
+                          sTransform, sEncoder);
+        }
+    }
+    else if( OGR_GT_IsSubClassOf(eType, wkbGeometryCollection) )
+    {
+        const OGRGeometryCollection* poGC =
+            static_cast<const OGRGeometryCollection*>(poGeom);
+        for( int i = 0; i < poGC->getNumGeometries(); i++ )
+        {
+            EncodeGeometry(poGC->getGeometryRef(i), nMVTType, sTransform,
+                           sEncoder, aoPoints);
+        }
+    }
+}
+
+/************************************************************************/
+/*                          GenerateTileJob()                           */
+/************************************************************************/
+
+// Build the content of a tile from its features. Runs in worker threads:
+// it only reads from the dataset and layer definitions.
+void OGRMVTWriterDataset::GenerateTileJob(void* pData)
+{
+    OGRMVTWriterTileJob* psJob = static_cast<OGRMVTWriterTileJob*>(pData);
+    OGRMVTWriterDataset* poDS = psJob->poDS;
+
+    const double dfTileDim = 2 * kmMAX_GM / (1 << psJob->nZ);
+    OGRMVTTileTransform sTransform;
+    sTransform.dfX0 = -kmMAX_GM + psJob->nX * dfTileDim;
+    sTransform.dfY0 = kmMAX_GM - psJob->nY * dfTileDim;
+    sTransform.dfScale = poDS->m_nExtent / dfTileDim;
+    sTransform.dfClipMin = -static_cast<double>(poDS->m_nBuffer);
+    sTransform.dfClipMax = static_cast<double>(poDS->m_nExtent) +
+                           poDS->m_nBuffer;
+    sTransform.dfTolerance = poDS->m_dfSimplification;
+
+    // Tile layers are created in the order of the dataset layers
+    MVTTile oTile;
+    std::vector<bool> abUsedLayers(poDS->m_apoLayers.size(), false);
+    for( const auto& sFeature: psJob->asFeatures )
+        abUsedLayers[sFeature.nLayerIdx] = true;
+    std::vector<int> anTileLayerIdx(abUsedLayers.size(), -1);
+    for( size_t i = 0; i < abUsedLayers.size(); i++ )
+    {
+        if( abUsedLayers[i] )
+        {
+            anTileLayerIdx[i] = oTile.getLayerCount();
+            oTile.addLayer(poDS->m_apoLayers[i]->m_osTargetName,
+                           poDS->m_nExtent);
+        }
+    }
+
+    std::vector<std::pair<int, int>> aoPoints;
+    for( auto& sFeature: psJob->asFeatures )
+    {
+        OGRGeometry* poGeom = nullptr;
+        OGRGeometryFactory::createFromWkb(
+            reinterpret_cast<GByte*>(&sFeature.osGeom[0]),
+            nullptr, &poGeom, static_cast<int>(sFeature.osGeom.size()));
+        if( poGeom == nullptr )
+            continue;
+        bool bHasPoint = false;
+        bool bHasLineString = false;
+        bool bHasPolygon = false;
+        CollectGeometryKinds(poGeom, bHasPoint, bHasLineString, bHasPolygon);
+
+        MVTTileLayer& oTileLayer =
+                        oTile.getLayer(anTileLayerIdx[sFeature.nLayerIdx]);
+        OGRFeatureDefn* poFDefn =
+            poDS->m_apoLayers[sFeature.nLayerIdx]->m_poFeatureDefn;
+        const unsigned int anTypes[3] = { knMVT_GEOM_TYPE_POINT,
+                                          knMVT_GEOM_TYPE_LINESTRING,
+                                          knMVT_GEOM_TYPE_POLYGON };
+        const bool abHasType[3] = { bHasPoint, bHasLineString, bHasPolygon };
+        // A geometry collection mixing types results in one MVT feature per
+        // geometry type.
+        for( int iType = 0; iType < 3; iType++ )
+        {
+            if( !abHasType[iType] )
+                continue;
+            std::vector<GUInt32> anGeometry;
+            OGRMVTGeomEncoder sEncoder;
+            sEncoder.panGeometry = &anGeometry;
+            sEncoder.nLastX = 0;
+            sEncoder.nLastY = 0;
+            aoPoints.clear();
+            EncodeGeometry(poGeom, anTypes[iType], sTransform, sEncoder,
+                           aoPoints);
+            if( anTypes[iType] == knMVT_GEOM_TYPE_POINT && !aoPoints.empty() )
+            {
+                anGeometry.push_back(MVTGetCmdCountCombined(
+                    knMVT_CMD_MOVETO, static_cast<unsigned>(aoPoints.size())));
+                for( const auto& oPoint: aoPoints )
+                {
+                    anGeometry.push_back(
+                        MVTEncodeSInt32(oPoint.first - sEncoder.nLastX));
+                    anGeometry.push_back(
+                        MVTEncodeSInt32(oPoint.second - sEncoder.nLastY));
+                    sEncoder.nLastX = oPoint.first;
+                    sEncoder.nLastY = oPoint.second;
+                }
+            }
+            if( anGeometry.empty() )
+                continue;
+
+            MVTTileLayerFeature& oFeature = oTileLayer.addFeature();
+            if( sFeature.nFID >= 0 )
+            {
+                oFeature.bHasId = true;
+                oFeature.nId = static_cast<GUIntBig>(sFeature.nFID);
+            }
+            oFeature.nType = anTypes[iType];
+            oFeature.anGeometry = std::move(anGeometry);
+
+            const GByte* pabyAttrs =
+                reinterpret_cast<const GByte*>(sFeature.osAttrs.data());
+            const GByte* pabyAttrsEnd = pabyAttrs + sFeature.osAttrs.size();
+            while( pabyAttrsEnd - pabyAttrs >= 8 )
+            {
+                GUInt32 anHeader[2];
+                memcpy(anHeader, pabyAttrs, sizeof(anHeader));
+                CPL_LSBPTR32(&anHeader[0]);
+                CPL_LSBPTR32(&anHeader[1]);
+                pabyAttrs += sizeof(anHeader);
+                if( anHeader[1] > static_cast<GUInt32>(
+                                            pabyAttrsEnd - pabyAttrs) ||
+                    static_cast<int>(anHeader[0]) >=
+                                            poFDefn->GetFieldCount() )
+                {
+                    break;
+                }
+                MVTTileLayerValue oValue;
+                if( oValue.read(pabyAttrs, pabyAttrs + anHeader[1]) )
+                {
+                    oFeature.anTags.push_back(oTileLayer.addKey(
+                        poFDefn->GetFieldDefn(anHeader[0])->GetNameRef()));
+                    oFeature.anTags.push_back(oTileLayer.addValue(oValue));
+                }
+                pabyAttrs += anHeader[1];
+            }
+        }
+        delete poGeom;
+    }
+
+    CPLString osTileData;
+    oTile.write(osTileData);
+    psJob->osTileData.clear();
+    if( osTileData.empty() )
+        return;
+    if( !poDS->m_bGZip )
+    {
+        psJob->osTileData = std::move(osTileData);
+        return;
+    }
+
+    z_stream sStream;
+    memset(&sStream, 0, sizeof(sStream));
+    // 15 + 16: gzip header, as expected by MVT readers
+    if( deflateInit2(&sStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16,
+                     8, Z_DEFAULT_STRATEGY) != Z_OK )
+    {
+        return;
+    }
+    psJob->osTileData.resize(deflateBound(&sStream,
+                                    static_cast<uLong>(osTileData.size())));
+    sStream.next_in = reinterpret_cast<Bytef*>(&osTileData[0]);
+    sStream.avail_in = static_cast<uInt>(osTileData.size());
+    sStream.next_out = reinterpret_cast<Bytef*>(&psJob->osTileData[0]);
+    sStream.avail_out = static_cast<uInt>(psJob->osTileData.size());
+    if( deflate(&sStream, Z_FINISH) == Z_STREAM_END )
+        psJob->osTileData.resize(sStream.total_out);
+    else
+        psJob->osTileData.clear();
+    deflateEnd(&sStream);
+}
+
+/************************************************************************/
+/*                             WriteTile()                              */
+/************************************************************************/
+
+bool OGRMVTWriterDataset::WriteTile(int nZ, int nX, int nY,
+                                    const CPLString& osTileData)
+{
+    if( m_bMBTiles )
+    {
+        sqlite3_reset(m_hInsertMBTilesStmt);
+        sqlite3_bind_int(m_hInsertMBTilesStmt, 1, nZ);
+        sqlite3_bind_int(m_hInsertMBTilesStmt, 2, nX);
+        // MBTiles y origin is bottom based
+        sqlite3_bind_int(m_hInsertMBTilesStmt, 3, (1 << nZ) - 1 - nY);
+        sqlite3_bind_blob(m_hInsertMBTilesStmt, 4, osTileData.data(),
+                          static_cast<int>(osTileData.size()),
+                          SQLITE_STATIC);
+        if( sqlite3_step(m_hInsertMBTilesStmt) != SQLITE_DONE )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "Insertion failed: %s",
+                     sqlite3_errmsg(m_hDBMBTiles));
+            return false;
+        }
+        return true;
+    }
+
+    CPLString osZDir(CPLFormFilename(GetDescription(),
+                                     CPLSPrintf("%d", nZ), nullptr));
+    CPLString osXDir(CPLFormFilename(osZDir, CPLSPrintf("%d", nX), nullptr));
+    if( m_oSetCreatedDirs.find(osXDir) == m_oSetCreatedDirs.end() )
+    {
+        if( m_oSetCreatedDirs.find(osZDir) == m_oSetCreatedDirs.end() )
+        {
+            VSIMkdir(osZDir, 0755);
+            m_oSetCreatedDirs.insert(osZDir);
+        }
+        VSIMkdir(osXDir, 0755);
+        m_oSetCreatedDirs.insert(osXDir);
+    }
+    CPLString osTileFilename(CPLFormFilename(osXDir, CPLSPrintf("%d", nY),
+                                             "pbf"));
+    VSILFILE* fp = VSIFOpenL(osTileFilename, "wb");
+    if( fp == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s",
+                 osTileFilename.c_str());
+        return false;
+    }
+    const bool bRet = VSIFWriteL(osTileData.data(), 1, osTileData.size(),
+                                 fp) == osTileData.size();
+    VSIFCloseL(fp);
+    return bRet;
+}
+
+/************************************************************************/
+/*                          ProcessTileJobs()                           */
+/************************************************************************/
+
+bool OGRMVTWriterDataset::ProcessTileJobs(
+                                std::vector<OGRMVTWriterTileJob>& asJobs)
+{
+    if( m_poWTP != nullptr && asJobs.size() > 1 )
+    {
+        std::vector<void*> ahJobs;
+        for( auto& sJob: asJobs )
+            ahJobs.push_back(&sJob);
+        m_poWTP->SubmitJobs(GenerateTileJob, ahJobs);
+        m_poWTP->WaitCompletion();
+    }
+    else
+    {
+        for( auto& sJob: asJobs )
+            GenerateTileJob(&sJob);
+    }
+
+    // Tiles are written in the same order whatever the number of threads
+    for( const auto& sJob: asJobs )
+    {
+        if( !sJob.osTileData.empty() &&
+            !WriteTile(sJob.nZ, sJob.nX, sJob.nY, sJob.osTileData) )
+        {
+            return false;
+        }
+    }
+    asJobs.clear();
+    return true;
+}
+
+/************************************************************************/
+/*                           GenerateTiles()                            */
+/************************************************************************/
+
+bool OGRMVTWriterDataset::GenerateTiles()
+{
+    if( sqlite3_exec(m_hTempDB, "CREATE INDEX temp_tiles_idx ON "
+                     "temp_tiles(z, x, y, feature)",
+                     nullptr, nullptr, nullptr) != SQLITE_OK )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Cannot create index: %s",
+                 sqlite3_errmsg(m_hTempDB));
+        return false;
+    }
+
+    sqlite3_stmt* hStmt = nullptr;
+    if( sqlite3_prepare_v2(m_hTempDB,
+            "SELECT t.z, t.x, t.y, f.layer, f.fid, f.geom, f.attrs "
+            "FROM temp_tiles t JOIN temp_features f ON f.id = t.feature "
+            "ORDER BY t.z, t.x, t.y, t.feature",
+            -1, &hStmt, nullptr) != SQLITE_OK )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Cannot prepare statement: %s",
+                 sqlite3_errmsg(m_hTempDB));
+        return false;
+    }
+
+    // Tiles are processed by batches, whose features are read from the
+    // temporary database by the main thread, while tile generation is done
+    // by the worker threads.
+    const size_t nMaxJobs = 16 * static_cast<size_t>(m_nNumThreads);
+    const size_t nMaxBatchBytes = 100 * 1024 * 1024;
+    std::vector<OGRMVTWriterTileJob> asJobs;
+    size_t nBatchBytes = 0;
+    bool bRet = true;
+    while( bRet && sqlite3_step(hStmt) == SQLITE_ROW )
+    {
+        const int nZ = sqlite3_column_int(hStmt, 0);
+        const int nX = sqlite3_column_int(hStmt, 1);
+        const int nY = sqlite3_column_int(hStmt, 2);
+        if( asJobs.empty() || asJobs.back().nZ != nZ ||
+            asJobs.back().nX != nX || asJobs.back().nY != nY )
+        {
+            if( asJobs.size() == nMaxJobs || nBatchBytes > nMaxBatchBytes )
+            {
+                bRet = ProcessTileJobs(asJobs);
+                nBatchBytes = 0;
+            }
+            OGRMVTWriterTileJob sJob;
+            sJob.poDS = this;
+            sJob.nZ = nZ;
+            sJob.nX = nX;
+            sJob.nY = nY;
+            asJobs.push_back(sJob);
+        }
+
+        OGRMVTWriterTileFeature sFeature;
+        sFeature.nLayerIdx = sqlite3_column_int(hStmt, 3);
+        sFeature.nFID = sqlite3_column_int64(hStmt, 4);
+        sFeature.osGeom.assign(
+            static_cast<const char*>(sqlite3_column_blob(hStmt, 5)),
+            sqlite3_column_bytes(hStmt, 5));
+        const int nAttrsSize = sqlite3_column_bytes(hStmt, 6);
+        if( nAttrsSize > 0 )
+        {
+            sFeature.osAttrs.assign(
+                static_cast<const char*>(sqlite3_column_blob(hStmt, 6)),
+                nAttrsSize);
+        }
+        nBatchBytes += sFeature.osGeom.size() + sFeature.osAttrs.size();
+        if( sFeature.nLayerIdx < 0 ||
+            sFeature.nLayerIdx >= static_cast<int>(m_apoLayers.size()) )
+        {
+            continue;
+        }
+        asJobs.back().asFeatures.push_back(sFeature);
+    }
+    sqlite3_finalize(hStmt);
+    if( bRet && !asJobs.empty() )
+        bRet = ProcessTileJobs(asJobs);
+    return bRet;
+}
+
+/************************************************************************/
+/*                           WriteMetadata()                            */
+/************************************************************************/
+
+bool OGRMVTWriterDataset::WriteMetadata()
+{
+    CPLJSONObject oJson;
+    CPLJSONArray oVectorLayers;
+    CPLJSONArray oTileStatLayers;
+    int nMinZoom = m_apoLayers.empty() ? m_nMinZoom : m_nMaxZoom;
+    int nMaxZoom = m_apoLayers.empty() ? m_nMaxZoom : m_nMinZoom;
+    for( const auto& poLayer: m_apoLayers )
+    {
+        nMinZoom = std::min(nMinZoom, poLayer->m_nMinZoom);
+        nMaxZoom = std::max(nMaxZoom, poLayer->m_nMaxZoom);
+
+        CPLJSONObject oLayer;
+        oLayer.Add("id", poLayer->m_osTargetName);
+        oLayer.Add("description", poLayer->m_osDescription);
+        oLayer.Add("minzoom", poLayer->m_nMinZoom);
+        oLayer.Add("maxzoom", poLayer->m_nMaxZoom);
+        CPLJSONObject oFields;
+        OGRFeatureDefn* poFDefn = poLayer->m_poFeatureDefn;
+        for( int i = 0; i < poFDefn->GetFieldCount(); i++ )
+        {
+            OGRFieldDefn* poFieldDefn = poFDefn->GetFieldDefn(i);
+            const OGRFieldType eType = poFieldDefn->GetType();
+            if( (eType == OFTInteger || eType == OFTInteger64) &&
+                poFieldDefn->GetSubType() == OFSTBoolean )
+            {
+                oFields.Add(poFieldDefn->GetNameRef(), "Boolean");
+            }
+            else if( eType == OFTInteger || eType == OFTInteger64 )
+            {
+                // GDAL extension, to preserve the field type on reading
+                oFields.Add(poFieldDefn->GetNameRef(),
+                            eType == OFTInteger ? "Integer" : "Integer64");
+            }
+            else if( eType == OFTReal )
+            {
+                oFields.Add(poFieldDefn->GetNameRef(), "Number");
+            }
+            else
+            {
+                oFields.Add(poFieldDefn->GetNameRef(), "String");
+            }
+        }
+        oLayer.Add("fields", oFields);
+        oVectorLayers.Add(oLayer);
+
+        CPLJSONObject oTileStatLayer;
+        oTileStatLayer.Add("layer", poLayer->m_osTargetName);
+        oTileStatLayer.Add("count",
+                           static_cast<GInt64>(poLayer->m_nFeatureCount));
+        const int nKinds = (poLayer->m_bHasPoint ? 1 : 0) +
+                           (poLayer->m_bHasLineString ? 1 : 0) +
+                           (poLayer->m_bHasPolygon ? 1 : 0);
+        if( nKinds == 1 )
+        {
+            oTileStatLayer.Add("geometry",
+                poLayer->m_bHasPoint ? "Point" :
+                poLayer->m_bHasLineString ? "LineString" : "Polygon");
+        }
+        oTileStatLayer.Add("attributeCount", poFDefn->GetFieldCount());
+        oTileStatLayers.Add(oTileStatLayer);
+    }
+    oJson.Add("vector_layers", oVectorLayers);
+    CPLJSONObject oTileStats;
+    oTileStats.Add("layerCount", static_cast<int>(m_apoLayers.size()));
+    oTileStats.Add("layers", oTileStatLayers);
+    oJson.Add("tilestats", oTileStats);
+
+    CPLString osBounds;
+    CPLString osCenter;
+    if( m_oEnvelope.IsInit() )
+    {
+        auto ToLongLat = [](double dfX, double dfY, double& dfLon,
+                            double& dfLat)
+        {
+            dfLon = dfX / kmSPHERICAL_RADIUS / M_PI * 180;
+            dfLat = (2 * atan(exp(dfY / kmSPHERICAL_RADIUS)) - M_PI / 2) /
+                    M_PI * 180;
+        };
+        double dfMinLon, dfMinLat, dfMaxLon, dfMaxLat;
+        ToLongLat(std::max(-kmMAX_GM, m_oEnvelope.MinX),
+                  std::max(-kmMAX_GM, m_oEnvelope.MinY), dfMinLon, dfMinLat);
+        ToLongLat(std::min(kmMAX_GM, m_oEnvelope.MaxX),
+                  std::min(kmMAX_GM, m_oEnvelope.MaxY), dfMaxLon, dfMaxLat);
+        osBounds.Printf("%.18g,%.18g,%.18g,%.18g",
+                        dfMinLon, dfMinLat, dfMaxLon, dfMaxLat);
+        osCenter.Printf("%.18g,%.18g,%d", (dfMinLon + dfMaxLon) / 2,
+                        (dfMinLat + dfMaxLat) / 2, nMinZoom);
+    }
+
+    std::vector<std::pair<CPLString, CPLString>> aoItems;
+    aoItems.push_back(std::pair<CPLString, CPLString>("name", m_osName));
+    aoItems.push_back(std::pair<CPLString, CPLString>("description",
+                                                      m_osDescription));
+    aoItems.push_back(std::pair<CPLString, CPLString>("version", "2"));
+    aoItems.push_back(std::pair<CPLString, CPLString>("type", m_osType));
+    aoItems.push_back(std::pair<CPLString, CPLString>("format", "pbf"));
+    aoItems.push_back(std::pair<CPLString, CPLString>("minzoom",
+                                            CPLSPrintf("%d", nMinZoom)));
+    aoItems.push_back(std::pair<CPLString, CPLString>("maxzoom",
+                                            CPLSPrintf("%d", nMaxZoom)));
+    if( !osBounds.empty() )
+    {
+        aoItems.push_back(std::pair<CPLString, CPLString>("bounds",
+                                                          osBounds));
+        aoItems.push_back(std::pair<CPLString, CPLString>("center",
+                                                          osCenter));
+    }
+    aoItems.push_back(std::pair<CPLString, CPLString>("json",
+                                oJson.Format(CPLJSONObject::Plain)));
+
+    if( m_bMBTiles )
+    {
+        sqlite3_stmt* hStmt = nullptr;
+        if( sqlite3_prepare_v2(m_hDBMBTiles,
+                "INSERT INTO metadata(name, value) VALUES (?, ?)",
+                -1, &hStmt, nullptr) != SQLITE_OK )
+        {
+            return false;
+        }
+        bool bRet = true;
+        for( const auto& oItem: aoItems )
+        {
+            sqlite3_reset(hStmt);
+            sqlite3_bind_text(hStmt, 1, oItem.first.c_str(), -1,
+                              SQLITE_STATIC);
+            sqlite3_bind_text(hStmt, 2, oItem.second.c_str(), -1,
+                              SQLITE_STATIC);
+            bRet &= sqlite3_step(hStmt) == SQLITE_DONE;
+        }
+        sqlite3_finalize(hStmt);
+        return bRet;
+    }
+
+    CPLJSONDocument oDoc;
+    CPLJSONObject oRoot = oDoc.GetRoot();
+    for( const auto& oItem: aoItems )
+    {
+        oRoot.Add(oItem.first, oItem.second);
+    }
+    return oDoc.Save(CPLFormFilename(GetDescription(), "metadata.json",
+                                     nullptr));
+}
+
+/************************************************************************/
+/*                              Finalize()                              */
+/************************************************************************/
+
+bool OGRMVTWriterDataset::Finalize()
+{
+    if( m_bFinalized )
+        return true;
+    m_bFinalized = true;
+    if( m_hTempDB == nullptr || m_bError )
+        return false;
+
+    if( sqlite3_exec(m_hTempDB, "COMMIT", nullptr, nullptr, nullptr) !=
+                                                                SQLITE_OK )
+    {
+        return false;
+    }
+    if( m_bMBTiles )
+    {
+        sqlite3_exec(m_hDBMBTiles, "BEGIN", nullptr, nullptr, nullptr);
+    }
+    bool bRet = GenerateTiles() && WriteMetadata();
+    if( m_bMBTiles )
+    {
+        bRet &= sqlite3_exec(m_hDBMBTiles, "COMMIT",
+                             nullptr, nullptr, nullptr) == SQLITE_OK;
+    }
+    return bRet;
+}
+
+/************************************************************************/
+/*                               Create()                               */
+/************************************************************************/
+
+GDALDataset* OGRMVTWriterDataset::Create( const char * pszFilename,
+                                          int nXSize, int nYSize,
+                                          int nBandsIn,
+                                          GDALDataType,
+                                          char ** papszOptions )
+{
+    if( nXSize != 0 || nYSize != 0 || nBandsIn != 0 )
+        return nullptr;
+
+    const char* pszFormat = CSLFetchNameValue(papszOptions, "FORMAT");
+    const bool bMBTiles = pszFormat != nullptr ? EQUAL(pszFormat, "MBTILES") :
+                    EQUAL(CPLGetExtension(pszFilename), "mbtiles");
+
+    VSIStatBufL sStat;
+    if( VSIStatL(pszFilename, &sStat) == 0 )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "%s already exists",
+                 pszFilename);
+        return nullptr;
+    }
+
+    std::unique_ptr<OGRMVTWriterDataset> poDS(new OGRMVTWriterDataset());
+    poDS->SetDescription(pszFilename);
+    poDS->m_bMBTiles = bMBTiles;
+    poDS->m_nMinZoom = atoi(CSLFetchNameValueDef(papszOptions, "MINZOOM",
+                                                 "0"));
+    poDS->m_nMaxZoom = atoi(CSLFetchNameValueDef(papszOptions, "MAXZOOM",
+                                                 "5"));
+    if( poDS->m_nMinZoom < 0 || poDS->m_nMinZoom > 22 ||
+        poDS->m_nMaxZoom < poDS->m_nMinZoom || poDS->m_nMaxZoom > 22 )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Invalid MINZOOM / MAXZOOM values");
+        return nullptr;
+    }
+    const int nExtent = atoi(CSLFetchNameValueDef(papszOptions, "EXTENT",
+                                                  "4096"));
+    const int nBuffer = atoi(CSLFetchNameValueDef(papszOptions, "BUFFER",
+                                                  "80"));
+    if( nExtent < 256 || nExtent > 65536 || nBuffer < 0 ||
+        nBuffer > nExtent )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Invalid EXTENT / BUFFER values");
+        return nullptr;
+    }
+    poDS->m_nExtent = static_cast<unsigned int>(nExtent);
+    poDS->m_nBuffer = static_cast<unsigned int>(nBuffer);
+    poDS->m_dfSimplification = CPLAtof(CSLFetchNameValueDef(papszOptions,
+                                                    "SIMPLIFICATION", "0"));
+    poDS->m_bGZip = CPLFetchBool(papszOptions, "COMPRESS", true);
+    poDS->m_osName = CSLFetchNameValueDef(papszOptions, "NAME",
+                                          CPLGetBasename(pszFilename));
+    poDS->m_osDescription = CSLFetchNameValueDef(papszOptions, "DESCRIPTION",
+                                                 poDS->m_osName);
+    poDS->m_osType = CSLFetchNameValueDef(papszOptions, "TYPE", "overlay");
+
+    const char* pszNumThreads = CSLFetchNameValueDef(
+        papszOptions, "NUM_THREADS",
+        CPLGetConfigOption("GDAL_NUM_THREADS", "ALL_CPUS"));
+    poDS->m_nNumThreads = CPLGetNumCPUs();
+    if( !EQUAL(pszNumThreads, "ALL_CPUS") )
+    {
+        poDS->m_nNumThreads = std::max(1, std::min(
+            2 * poDS->m_nNumThreads, atoi(pszNumThreads)));
+    }
+    if( poDS->m_nNumThreads > 1 )
+    {
+        poDS->m_poWTP = new CPLWorkerThreadPool();
+        if( !poDS->m_poWTP->Setup(poDS->m_nNumThreads, nullptr, nullptr) )
+        {
+            delete poDS->m_poWTP;
+            poDS->m_poWTP = nullptr;
+            poDS->m_nNumThreads = 1;
+        }
+    }
+
+    if( bMBTiles )
+    {
+        if( sqlite3_open_v2(pszFilename, &poDS->m_hDBMBTiles,
+                    SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                    nullptr) != SQLITE_OK )
+        {
+            CPLError(CE_Failure, CPLE_OpenFailed, "Cannot create %s",
+                     pszFilename);
+            return nullptr;
+        }
+        if( sqlite3_exec(poDS->m_hDBMBTiles,
+                "CREATE TABLE metadata (name text, value text);"
+                "CREATE TABLE tiles (zoom_level integer, "
+                    "tile_column integer, tile_row integer, tile_data blob);"
+                "CREATE UNIQUE INDEX tile_index on tiles "
+                    "(zoom_level, tile_column, tile_row)",
+                nullptr, nullptr, nullptr) != SQLITE_OK ||
+            sqlite3_prepare_v2(poDS->m_hDBMBTiles,
+                "INSERT INTO tiles(zoom_level, tile_column, tile_row, "
+                "tile_data) VALUES (?,?,?,?)",
+                -1, &poDS->m_hInsertMBTilesStmt, nullptr) != SQLITE_OK )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "Cannot initialize %s: %s",
+                     pszFilename, sqlite3_errmsg(poDS->m_hDBMBTiles));
+            return nullptr;
+        }
+    }
+    else if( VSIMkdir(pszFilename, 0755) != 0 )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot create directory %s",
+                 pszFilename);
+        return nullptr;
+    }
+
+    // The temporary database must be a real file, as it is accessed
+    // directly with sqlite3.
+    poDS->m_osTempDB = CSLFetchNameValueDef(papszOptions, "TEMPORARY_DB",
+        CPLSPrintf("%s.temp.db", STARTS_WITH(pszFilename, "/vsi") ?
+            CPLGenerateTempFilename("mvt") : pszFilename));
+    if( !poDS->CreateTempDB() )
+        return nullptr;
+
+    return poDS.release();
+}
+
+#endif // HAVE_MVT_WRITE_SUPPORT
+
+/************************************************************************/
+/*                           RegisterOGRMVT()                           */
+/************************************************************************/
+
+void RegisterOGRMVT()
+
+{
+    if( GDALGetDriverByName( "MVT" ) != nullptr )
+        return;
+
+    GDALDriver  *poDriver = new GDALDriver();
+
+    poDriver->SetDescription( "MVT" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VECTOR, "YES" );
+    poDriver->SetMetadataItem( GDAL_DMD_LONGNAME,
+                               "MapBox Vector Tiles" );
+    poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drv_mvt.html" );
+    poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "mvt mvt.gz pbf" );
+
+    poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
+"<OpenOptionList>"
+"  <Option name='X' type='int' description='X coordinate of tile'/>"
+"  <Option name='Y' type='int' description='Y coordinate of tile'/>"
+"  <Option name='Z' type='int' description='Z coordinate of tile'/>"
+"  <Option name='METADATA_FILE' type='string' "
+                                "description='Path to metadata.json'/>"
+"  <Option name='CLIP' type='boolean' "
+    "description='Whether to clip geometries to tile extent' default='YES'/>"
+"  <Option name='TILE_EXTENSION' type='string' default='pbf' description="
+    "'For tilesets, extension of tiles'/>"
+"  <Option name='TILE_COUNT_TO_ESTABLISH_FEATURE_DEFN' type='int' description="
+    "'For tilesets without metadata file, maximum number of tiles to use to "
+    "establish the layer schemas' default='1000'/>"
+"  <Option name='JSON_FIELD' type='string' description='For tilesets, "
+        "whether to put all attributes as a serialized JSon dictionary'/>"
+"</OpenOptionList>" );
+
+#ifdef HAVE_MVT_WRITE_SUPPORT
+    poDriver->SetMetadataItem( GDAL_DCAP_CREATE, "YES" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONFIELDDATATYPES,
+                               "Integer Integer64 Real String" );
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONFIELDDATASUBTYPES,
+                               "Boolean Float32" );
+
+    poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
+"<CreationOptionList>"
+"  <Option name='FORMAT' type='string-select' description='Output format'>"
+"    <Value>DIRECTORY</Value>"
+"    <Value>MBTILES</Value>"
+"  </Option>"
+"  <Option name='NAME' type='string' description='Name of the tileset'/>"
+"  <Option name='DESCRIPTION' type='string' "
+                            "description='Description of the tileset'/>"
+"  <Option name='TYPE' type='string-select' default='overlay' "
+                                        "description='Layer type'>"
+"    <Value>overlay</Value>"
+"    <Value>baselayer</Value>"
+"  </Option>"
+"  <Option name='MINZOOM' type='int' default='0' "
+                                "description='Minimum zoom level'/>"
+"  <Option name='MAXZOOM' type='int' default='5' "
+                                "description='Maximum zoom level'/>"
+"  <Option name='EXTENT' type='unsigned int' default='4096' "
+    "description='Number of units in a tile'/>"
+"  <Option name='BUFFER' type='unsigned int' default='80' "
+    "description='Number of units for geometry buffering around the tile'/>"
+"  <Option name='SIMPLIFICATION' type='float' default='0' "
+    "description='Simplification tolerance, in tile units'/>"
+"  <Option name='COMPRESS' type='boolean' default='YES' "
+    "description='Whether to gzip-compress tiles'/>"
+"  <Option name='NUM_THREADS' type='string' description="
+    "'Number of threads used to generate tiles. Integer value or ALL_CPUS'/>"
+"  <Option name='TEMPORARY_DB' type='string' description="
+    "'Filename of the temporary SQLite database used to spool features'/>"
+"</CreationOptionList>" );
+
+    poDriver->SetMetadataItem( GDAL_DS_LAYER_CREATIONOPTIONLIST,
+"<LayerCreationOptionList>"
+"  <Option name='MINZOOM' type='int' description='Minimum zoom level'/>"
+"  <Option name='MAXZOOM' type='int' description='Maximum zoom level'/>"
+"  <Option name='NAME' type='string' description='Target layer name'/>"
+"  <Option name='DESCRIPTION' type='string' "
+                                "description='Description of the layer'/>"
+"</LayerCreationOptionList>" );
+#endif
 
     poDriver->pfnIdentify = OGRMVTDriverIdentify;
     poDriver->pfnOpen = OGRMVTDataset::Open;
+#ifdef HAVE_MVT_WRITE_SUPPORT
+    poDriver->pfnCreate = OGRMVTWriterDataset::Create;
+#endif
 
     GetGDALDriverManager()->RegisterDriver( poDriver );
 }
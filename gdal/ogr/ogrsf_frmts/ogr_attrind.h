@@ -56,6 +56,31 @@ public:
     virtual OGRErr RemoveEntry( OGRField *psKey, GIntBig nFID ) = 0;
 
     virtual OGRErr Clear() = 0;
+
+    /* Optional capabilities of ordered (B-tree like) implementations. */
+    virtual int       GetKeyFieldCount();
+    virtual int       GetKeyField( int iKey );
+    virtual int       SupportsRangeScan();
+
+    /* Return FIDs whose first nEqualCount key fields equal pasEqualKeys[], */
+    /* and whose next key field lies between psMin and psMax (each bound  */
+    /* may be NULL for an unbounded side).                                */
+    virtual GIntBig  *GetRangeMatches( int nEqualCount,
+                                       const OGRField *pasEqualKeys,
+                                       const OGRField *psMin,
+                                       int bMinIncluded,
+                                       const OGRField *psMax,
+                                       int bMaxIncluded,
+                                       GIntBig* panFIDList, int* nFIDCount,
+                                       int* nLength );
+
+    /* Same as above, but the next key field is a string starting with */
+    /* pszPrefix (case insensitive, as for LIKE 'prefix%').             */
+    virtual GIntBig  *GetPrefixMatches( int nEqualCount,
+                                        const OGRField *pasEqualKeys,
+                                        const char *pszPrefix,
+                                        GIntBig* panFIDList, int* nFIDCount,
+                                        int* nLength );
 };
 
 /************************************************************************/
@@ -86,9 +111,22 @@ public:
     virtual OGRErr RemoveFromIndex( OGRFeature *poFeature ) = 0;
 
     virtual OGRAttrIndex *GetFieldIndex( int iField ) = 0;
+
+    /* Multi-column indexes, for implementations supporting them. */
+    virtual OGRErr CreateMultiFieldIndex( int nFieldCount,
+                                          const int *panFields );
+    virtual OGRErr DropMultiFieldIndex( int nFieldCount,
+                                        const int *panFields );
+    virtual int    GetIndexCount();
+    virtual OGRAttrIndex *GetIndexByPosition( int iIndex );
+
+    /* To be called when the layer has been modified without updating */
+    /* the indexes, so that they are no longer used.                   */
+    virtual void   Invalidate();
 };
 
 OGRLayerAttrIndex CPL_DLL *OGRCreateDefaultLayerIndex();
+OGRLayerAttrIndex CPL_DLL *OGRCreateMILayerIndex();
 
 //! @endcond
 
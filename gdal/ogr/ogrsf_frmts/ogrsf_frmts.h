@@ -57,6 +57,10 @@ class OGRSFDriver;
 /*                               OGRLayer                               */
 /************************************************************************/
 
+//! @cond Doxygen_Suppress
+class OGRLayerFilterGrid;
+//! @endcond
+
 /**
  * This class represents a layer of simple features, with access methods.
  *
@@ -75,13 +79,19 @@ class CPL_DLL OGRLayer : public GDALMajorObject
     int          m_bFilterIsEnvelope;
     OGRGeometry *m_poFilterGeom;
     OGRPreparedGeometry *m_pPreparedFilterGeom; /* m_poFilterGeom compiled as a prepared geometry */
+    OGRLayerFilterGrid *m_poFilterGrid; /* coverage of a polygonal m_poFilterGeom, built on first use */
+    bool         m_bFilterGridBuilt;
     OGREnvelope  m_sFilterEnvelope;
     int          m_iGeomFieldFilter; // specify the index on which the spatial
                                      // filter is active.
 
     int          FilterGeometry( OGRGeometry * );
     //int          FilterGeometry( OGRGeometry *, OGREnvelope* psGeometryEnvelope);
+    int          FilterWKBGeometry( const GByte* pabyWKB, size_t nWKBSize,
+                                    bool bEnvelopeAlreadySet,
+                                    OGREnvelope& sEnvelope );
     int          InstallFilter( OGRGeometry * );
+    OGRLayerFilterGrid* GetFilterGrid();
 
     OGRErr       GetExtentInternal(int iGeomField, OGREnvelope *psExtent, int bForce );
 //! @endcond
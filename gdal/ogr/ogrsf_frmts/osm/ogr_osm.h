@@ -77,6 +77,7 @@ class OGROSMComputedAttribute
 /************************************************************************/
 
 class OGROSMDataSource;
+class CPLWorkerThreadPool;
 
 class OGROSMLayer : public OGRLayer
 {
@@ -270,6 +271,7 @@ typedef struct
     IndexedKVP*         pasTags; /*  point to a sub-array of OGROSMDataSource.pasAccumulatedTags */
     OSMInfo             sInfo;
     OGRFeature         *poFeature;
+    unsigned int        nResolvedRefs; /* number of coordinates in pasLonLatBatch, when resolved by worker threads */
     EMULATED_BOOL       bIsArea : 1;
     EMULATED_BOOL       bAttrFilterAlreadyEvaluated : 1;
 } WayFeaturePair;
@@ -402,6 +404,18 @@ class OGROSMDataSource : public OGRDataSource
     std::map<int, Bucket> oMapBuckets;
     Bucket*             GetBucket(int nBucketId);
 
+    /* Threads used to compress node sectors and resolve way geometries */
+    CPLWorkerThreadPool *poWTP;
+    int                 nNumThreads;
+    /* Full sectors of the current bucket waiting to be compressed */
+    GByte              *pabyPendingSectors;
+    GByte              *pabyPendingCompressed;
+    int                *panPendingSectorIdx;
+    int                *panPendingCompressedSize;
+    int                 nPendingSectors;
+    /* Coordinates of the ways of the current batch, resolved in parallel */
+    LonLat             *pasLonLatBatch;
+
     bool                bNeedsToSaveWayInfo;
 
     static const GIntBig FILESIZE_NOT_INIT = -2;
@@ -429,6 +443,7 @@ class OGROSMDataSource : public OGRDataSource
     bool                FlushCurrentSector();
     bool                FlushCurrentSectorCompressedCase();
     bool                FlushCurrentSectorNonCompressedCase();
+    bool                FlushPendingSectors();
     bool                IndexPointCustom( OSMNode* psNode );
 
     void                IndexWay(GIntBig nWayID, bool bIsArea,
@@ -440,6 +455,13 @@ class OGROSMDataSource : public OGRDataSource
     bool                CommitTransactionCacheDB();
 
     int                 FindNode(GIntBig nID);
+    unsigned int        ResolveWayNodes(const WayFeaturePair* psWayFeaturePairs,
+                                        LonLat* pasCoords);
+    static void         SetWayGeometry(WayFeaturePair* psWayFeaturePairs,
+                                       const LonLat* pasCoords,
+                                       unsigned int nFound);
+    static void         ResolveWaysJob(void* pData);
+    static void         CompressSectorsJob(void* pData);
     void                ProcessWaysBatch();
 
     void                ProcessPolygonsStandalone();
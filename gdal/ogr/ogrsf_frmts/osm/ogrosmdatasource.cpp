@@ -29,6 +29,7 @@
 #include "cpl_conv.h"
 #include "cpl_multiproc.h"
 #include "cpl_time.h"
+#include "cpl_worker_thread_pool.h"
 #include "ogr_api.h"
 #include "ogr_osm.h"
 #include "ogr_p.h"
@@ -278,6 +279,14 @@ OGROSMDataSource::OGROSMDataSource() :
     nBucketOld(-1),
     nOffInBucketReducedOld(-1),
     pabySector(nullptr),
+    poWTP(nullptr),
+    nNumThreads(1),
+    pabyPendingSectors(nullptr),
+    pabyPendingCompressed(nullptr),
+    panPendingSectorIdx(nullptr),
+    panPendingCompressedSize(nullptr),
+    nPendingSectors(0),
+    pasLonLatBatch(nullptr),
     bNeedsToSaveWayInfo(false),
     m_nFileSize(FILESIZE_NOT_INIT)
 {}
@@ -372,6 +381,13 @@ OGROSMDataSource::~OGROSMDataSource()
     }
 
     CPLFree(pabySector);
+    CPLFree(pabyPendingSectors);
+    CPLFree(pabyPendingCompressed);
+    CPLFree(panPendingSectorIdx);
+    CPLFree(panPendingCompressedSize);
+    CPLFree(pasLonLatBatch);
+    delete poWTP;
+
     std::map<int, Bucket>::iterator oIter = oMapBuckets.begin();
     for( ; oIter != oMapBuckets.end(); ++oIter )
     {
@@ -593,39 +609,41 @@ Bucket* OGROSMDataSource::GetBucket(int nBucketId)
 }
 
 /************************************************************************/
-/*                     FlushCurrentSectorCompressedCase()               */
+/*                            CompressSector()                          */
 /************************************************************************/
 
-bool OGROSMDataSource::FlushCurrentSectorCompressedCase()
+/* Compress the NODE_PER_SECTOR LonLat of pabyIn into pabyOut, which must */
+/* be at least 2 * SECTOR_SIZE large. Returns the rounded compressed size,*/
+/* or SECTOR_SIZE if the sector must be stored uncompressed. */
+static int CompressSector( const GByte* pabyIn, GByte* pabyOut )
 {
-    GByte abyOutBuffer[2 * SECTOR_SIZE];
-    GByte* pabyOut = abyOutBuffer;
-    LonLat* pasLonLatIn = (LonLat*)pabySector;
+    GByte* pabyPtr = pabyOut;
+    const LonLat* pasLonLatIn = reinterpret_cast<const LonLat*>(pabyIn);
     int nLastLon = 0;
     int nLastLat = 0;
     bool bLastValid = false;
 
     CPLAssert((NODE_PER_SECTOR % 8) == 0);
-    memset(abyOutBuffer, 0, NODE_PER_SECTOR / 8);
-    pabyOut += NODE_PER_SECTOR / 8;
+    memset(pabyOut, 0, NODE_PER_SECTOR / 8);
+    pabyPtr += NODE_PER_SECTOR / 8;
     for( int i = 0; i < NODE_PER_SECTOR; i++)
     {
         if( pasLonLatIn[i].nLon || pasLonLatIn[i].nLat )
         {
-            abyOutBuffer[i >> 3] |= (1 << (i % 8));
+            pabyOut[i >> 3] |= (1 << (i % 8));
             if( bLastValid )
             {
                 const GIntBig nDiff64Lon =
                   static_cast<GIntBig>(pasLonLatIn[i].nLon) -
                   static_cast<GIntBig>(nLastLon);
                 const GIntBig nDiff64Lat = pasLonLatIn[i].nLat - nLastLat;
-                WriteVarSInt64(nDiff64Lon, &pabyOut);
-                WriteVarSInt64(nDiff64Lat, &pabyOut);
+                WriteVarSInt64(nDiff64Lon, &pabyPtr);
+                WriteVarSInt64(nDiff64Lat, &pabyPtr);
             }
             else
             {
-                memcpy(pabyOut, &pasLonLatIn[i], sizeof(LonLat));
-                pabyOut += sizeof(LonLat);
+                memcpy(pabyPtr, &pasLonLatIn[i], sizeof(LonLat));
+                pabyPtr += sizeof(LonLat);
             }
             bLastValid = true;
 
@@ -634,17 +652,44 @@ bool OGROSMDataSource::FlushCurrentSectorCompressedCase()
         }
     }
 
-    size_t nCompressSize = static_cast<size_t>(pabyOut - abyOutBuffer);
-    CPLAssert(nCompressSize < sizeof(abyOutBuffer) - 1);
-    abyOutBuffer[nCompressSize] = 0;
+    size_t nCompressSize = static_cast<size_t>(pabyPtr - pabyOut);
+    CPLAssert(nCompressSize < 2 * SECTOR_SIZE - 1);
+    pabyOut[nCompressSize] = 0;
 
     nCompressSize = ROUND_COMPRESS_SIZE(nCompressSize);
-    GByte* pabyToWrite = nullptr;
     if( nCompressSize >= static_cast<size_t>(SECTOR_SIZE) )
+        return SECTOR_SIZE;
+    return static_cast<int>(nCompressSize);
+}
+
+/************************************************************************/
+/*                     FlushCurrentSectorCompressedCase()               */
+/************************************************************************/
+
+bool OGROSMDataSource::FlushCurrentSectorCompressedCase()
+{
+    /* When worker threads are available, full sectors of the current */
+    /* bucket are queued, and compressed in parallel by */
+    /* FlushPendingSectors() once the bucket is complete. */
+    if( pabyPendingSectors != nullptr )
     {
-        nCompressSize = SECTOR_SIZE;
-        pabyToWrite = pabySector;
+        memcpy(pabyPendingSectors +
+                    static_cast<size_t>(nPendingSectors) * SECTOR_SIZE,
+               pabySector, SECTOR_SIZE);
+        panPendingSectorIdx[nPendingSectors] = nOffInBucketReducedOld;
+        nPendingSectors ++;
+        memset(pabySector, 0, SECTOR_SIZE);
+        if( nPendingSectors == BUCKET_SECTOR_SIZE_ARRAY_SIZE )
+            return FlushPendingSectors();
+        return true;
     }
+
+    GByte abyOutBuffer[2 * SECTOR_SIZE];
+    const size_t nCompressSize = static_cast<size_t>(
+        CompressSector(pabySector, abyOutBuffer));
+    GByte* pabyToWrite = nullptr;
+    if( nCompressSize == static_cast<size_t>(SECTOR_SIZE) )
+        pabyToWrite = pabySector;
     else
         pabyToWrite = abyOutBuffer;
 
@@ -674,6 +719,95 @@ bool OGROSMDataSource::FlushCurrentSectorCompressedCase()
     return false;
 }
 
+/************************************************************************/
+/*                          CompressSectorsJob()                        */
+/************************************************************************/
+
+typedef struct
+{
+    OGROSMDataSource* poDS;
+    int               iStart;
+    int               iEnd;
+} OSMBatchJob;
+
+void OGROSMDataSource::CompressSectorsJob(void* pData)
+{
+    OSMBatchJob* psJob = static_cast<OSMBatchJob*>(pData);
+    OGROSMDataSource* poDS = psJob->poDS;
+    for( int i = psJob->iStart; i < psJob->iEnd; i++ )
+    {
+        poDS->panPendingCompressedSize[i] = CompressSector(
+            poDS->pabyPendingSectors + static_cast<size_t>(i) * SECTOR_SIZE,
+            poDS->pabyPendingCompressed +
+                static_cast<size_t>(i) * 2 * SECTOR_SIZE);
+    }
+}
+
+/************************************************************************/
+/*                         FlushPendingSectors()                        */
+/************************************************************************/
+
+bool OGROSMDataSource::FlushPendingSectors()
+{
+    if( nPendingSectors == 0 )
+        return true;
+
+    const int nJobs = std::min(nNumThreads, nPendingSectors);
+    std::vector<OSMBatchJob> asJobs(nJobs);
+    std::vector<void*> ahJobs;
+    for( int i = 0; i < nJobs; i++ )
+    {
+        asJobs[i].poDS = this;
+        asJobs[i].iStart =
+            static_cast<int>(static_cast<GIntBig>(nPendingSectors) * i / nJobs);
+        asJobs[i].iEnd =
+            static_cast<int>(static_cast<GIntBig>(nPendingSectors) * (i + 1) / nJobs);
+        ahJobs.push_back(&asJobs[i]);
+    }
+    if( nJobs > 1 )
+    {
+        poWTP->SubmitJobs(CompressSectorsJob, ahJobs);
+        poWTP->WaitCompletion();
+    }
+    else
+    {
+        CompressSectorsJob(ahJobs[0]);
+    }
+
+    Bucket* psBucket = GetBucket(nBucketOld);
+    if( psBucket->u.panSectorSize == nullptr )
+    {
+        psBucket = AllocBucket(nBucketOld);
+        if( psBucket == nullptr )
+            return false;
+    }
+
+    /* Write the sectors in the order they were indexed. */
+    const int nCount = nPendingSectors;
+    nPendingSectors = 0;
+    for( int i = 0; i < nCount; i++ )
+    {
+        const size_t nCompressSize =
+            static_cast<size_t>(panPendingCompressedSize[i]);
+        const GByte* pabyToWrite =
+            nCompressSize == static_cast<size_t>(SECTOR_SIZE) ?
+                pabyPendingSectors + static_cast<size_t>(i) * SECTOR_SIZE :
+                pabyPendingCompressed + static_cast<size_t>(i) * 2 * SECTOR_SIZE;
+        if( VSIFWriteL(pabyToWrite, 1, nCompressSize, fpNodes) != nCompressSize )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Cannot write in temporary node file %s : %s",
+                      osNodesFilename.c_str(), VSIStrerror(errno));
+            return false;
+        }
+        nNodesFileSize += nCompressSize;
+        psBucket->u.panSectorSize[panPendingSectorIdx[i]] =
+                                    COMPRESS_SIZE_TO_BYTE(nCompressSize);
+    }
+
+    return true;
+}
+
 /************************************************************************/
 /*                   FlushCurrentSectorNonCompressedCase()              */
 /************************************************************************/
@@ -745,7 +879,7 @@ bool OGROSMDataSource::IndexPointCustom(OSMNode* psNode)
         CPLAssert(nBucket > nBucketOld);
         if( nBucketOld >= 0 )
         {
-            if( !FlushCurrentSector() )
+            if( !FlushCurrentSector() || !FlushPendingSectors() )
             {
                 bStopParsing = true;
                 return false;
@@ -1067,7 +1201,7 @@ void OGROSMDataSource::LookupNodesCustom( )
 
     if( nBucketOld >= 0 )
     {
-        if( !FlushCurrentSector() )
+        if( !FlushCurrentSector() || !FlushPendingSectors() )
         {
             bStopParsing = true;
             return;
@@ -1653,93 +1787,186 @@ int OGROSMDataSource::FindNode(GIntBig nID)
 }
 
 /************************************************************************/
-/*                         ProcessWaysBatch()                           */
+/*                          ResolveWayNodes()                           */
 /************************************************************************/
 
-void OGROSMDataSource::ProcessWaysBatch()
+/* Fetch the coordinates of the nodes of a way from the result of */
+/* LookupNodes(). Only reads state shared by the whole batch, so it can */
+/* be run concurrently on different ways. */
+unsigned int OGROSMDataSource::ResolveWayNodes(
+    const WayFeaturePair* psWayFeaturePairs, LonLat* pasCoords )
 {
-    if( nWayFeaturePairs == 0 ) return;
-
-    //printf("nodes = %d, features = %d\n", nUnsortedReqIds, nWayFeaturePairs);
-    LookupNodes();
-
-    for( int iPair = 0; iPair < nWayFeaturePairs; iPair ++)
-    {
-        WayFeaturePair* psWayFeaturePairs = &pasWayFeaturePairs[iPair];
-
-        const EMULATED_BOOL bIsArea = psWayFeaturePairs->bIsArea;
-
-        unsigned int nFound = 0;
+    unsigned int nFound = 0;
 
 #ifdef ENABLE_NODE_LOOKUP_BY_HASHING
-        if( bHashedIndexValid )
+    if( bHashedIndexValid )
+    {
+        for( unsigned int i=0;i<psWayFeaturePairs->nRefs;i++)
         {
-            for( unsigned int i=0;i<psWayFeaturePairs->nRefs;i++)
+            int nIndInHashArray = static_cast<int>(
+                HASH_ID_FUNC(psWayFeaturePairs->panNodeRefs[i]) %
+                    HASHED_INDEXES_ARRAY_SIZE);
+            int nIdx = panHashedIndexes[nIndInHashArray];
+            if( nIdx < -1 )
             {
-                int nIndInHashArray = static_cast<int>(
-                    HASH_ID_FUNC(psWayFeaturePairs->panNodeRefs[i]) %
-                        HASHED_INDEXES_ARRAY_SIZE);
-                int nIdx = panHashedIndexes[nIndInHashArray];
-                if( nIdx < -1 )
+                int iBucket = -nIdx - 2;
+                while( true )
                 {
-                    int iBucket = -nIdx - 2;
-                    while( true )
+                    nIdx = psCollisionBuckets[iBucket].nInd;
+                    if( panReqIds[nIdx] ==
+                        psWayFeaturePairs->panNodeRefs[i] )
+                        break;
+                    iBucket = psCollisionBuckets[iBucket].nNext;
+                    if( iBucket < 0 )
                     {
-                        nIdx = psCollisionBuckets[iBucket].nInd;
-                        if( panReqIds[nIdx] ==
-                            psWayFeaturePairs->panNodeRefs[i] )
-                            break;
-                        iBucket = psCollisionBuckets[iBucket].nNext;
-                        if( iBucket < 0 )
-                        {
-                            nIdx = -1;
-                            break;
-                        }
+                        nIdx = -1;
+                        break;
                     }
                 }
-                else if( nIdx >= 0 &&
-                         panReqIds[nIdx] != psWayFeaturePairs->panNodeRefs[i] )
-                    nIdx = -1;
+            }
+            else if( nIdx >= 0 &&
+                     panReqIds[nIdx] != psWayFeaturePairs->panNodeRefs[i] )
+                nIdx = -1;
 
-                if( nIdx >= 0 )
-                {
-                    pasLonLatCache[nFound].nLon = pasLonLatArray[nIdx].nLon;
-                    pasLonLatCache[nFound].nLat = pasLonLatArray[nIdx].nLat;
-                    nFound ++;
-                }
+            if( nIdx >= 0 )
+            {
+                pasCoords[nFound].nLon = pasLonLatArray[nIdx].nLon;
+                pasCoords[nFound].nLat = pasLonLatArray[nIdx].nLat;
+                nFound ++;
             }
         }
-        else
+    }
+    else
 #endif // ENABLE_NODE_LOOKUP_BY_HASHING
+    {
+        int nIdx = -1;
+        for( unsigned int i=0;i<psWayFeaturePairs->nRefs;i++)
         {
-            int nIdx = -1;
-            for( unsigned int i=0;i<psWayFeaturePairs->nRefs;i++)
+            if( nIdx >= 0 && psWayFeaturePairs->panNodeRefs[i] ==
+                             psWayFeaturePairs->panNodeRefs[i-1] + 1 )
             {
-                if( nIdx >= 0 && psWayFeaturePairs->panNodeRefs[i] ==
-                                 psWayFeaturePairs->panNodeRefs[i-1] + 1 )
-                {
-                    if( nIdx+1 < (int)nReqIds && panReqIds[nIdx+1] ==
-                                        psWayFeaturePairs->panNodeRefs[i] )
-                        nIdx ++;
-                    else
-                        nIdx = -1;
-                }
+                if( nIdx+1 < (int)nReqIds && panReqIds[nIdx+1] ==
+                                    psWayFeaturePairs->panNodeRefs[i] )
+                    nIdx ++;
                 else
-                    nIdx = FindNode( psWayFeaturePairs->panNodeRefs[i] );
-                if( nIdx >= 0 )
-                {
-                    pasLonLatCache[nFound].nLon = pasLonLatArray[nIdx].nLon;
-                    pasLonLatCache[nFound].nLat = pasLonLatArray[nIdx].nLat;
-                    nFound ++;
-                }
+                    nIdx = -1;
             }
+            else
+                nIdx = FindNode( psWayFeaturePairs->panNodeRefs[i] );
+            if( nIdx >= 0 )
+            {
+                pasCoords[nFound].nLon = pasLonLatArray[nIdx].nLon;
+                pasCoords[nFound].nLat = pasLonLatArray[nIdx].nLat;
+                nFound ++;
+            }
+        }
+    }
+
+    if( nFound > 0 && psWayFeaturePairs->bIsArea )
+    {
+        pasCoords[nFound].nLon = pasCoords[0].nLon;
+        pasCoords[nFound].nLat = pasCoords[0].nLat;
+        nFound ++;
+    }
+
+    return nFound;
+}
+
+/************************************************************************/
+/*                           SetWayGeometry()                           */
+/************************************************************************/
+
+void OGROSMDataSource::SetWayGeometry( WayFeaturePair* psWayFeaturePairs,
+                                       const LonLat* pasCoords,
+                                       unsigned int nFound )
+{
+    OGRLineString* poLS = new OGRLineString();
+    OGRGeometry* poGeom = poLS;
+
+    poLS->setNumPoints((int)nFound);
+    for( unsigned int i=0;i<nFound;i++)
+    {
+        poLS->setPoint(i,
+                    INT_TO_DBL(pasCoords[i].nLon),
+                    INT_TO_DBL(pasCoords[i].nLat));
+    }
+
+    psWayFeaturePairs->poFeature->SetGeometryDirectly(poGeom);
+}
+
+/************************************************************************/
+/*                           ResolveWaysJob()                           */
+/************************************************************************/
+
+void OGROSMDataSource::ResolveWaysJob(void* pData)
+{
+    OSMBatchJob* psJob = static_cast<OSMBatchJob*>(pData);
+    OGROSMDataSource* poDS = psJob->poDS;
+    for( int iPair = psJob->iStart; iPair < psJob->iEnd; iPair ++ )
+    {
+        WayFeaturePair* psWayFeaturePairs = &poDS->pasWayFeaturePairs[iPair];
+        /* Node references of the ways are contiguous in */
+        /* panUnsortedReqIds, plus one slot per way to close areas. */
+        LonLat* pasCoords = poDS->pasLonLatBatch +
+            (psWayFeaturePairs->panNodeRefs - poDS->panUnsortedReqIds) + iPair;
+        const unsigned int nFound =
+            poDS->ResolveWayNodes(psWayFeaturePairs, pasCoords);
+        psWayFeaturePairs->nResolvedRefs = nFound;
+        if( nFound >= 2 && psWayFeaturePairs->poFeature != nullptr )
+            SetWayGeometry(psWayFeaturePairs, pasCoords, nFound);
+    }
+}
+
+/************************************************************************/
+/*                         ProcessWaysBatch()                           */
+/************************************************************************/
+
+void OGROSMDataSource::ProcessWaysBatch()
+{
+    if( nWayFeaturePairs == 0 ) return;
+
+    //printf("nodes = %d, features = %d\n", nUnsortedReqIds, nWayFeaturePairs);
+    LookupNodes();
+
+    /* Resolve node coordinates and build line geometries on the worker */
+    /* threads. Indexing and emission of features remain sequential. */
+    const bool bResolvedInParallel =
+        pasLonLatBatch != nullptr && nWayFeaturePairs > 1;
+    if( bResolvedInParallel )
+    {
+        const int nJobs = std::min(nNumThreads * 4, nWayFeaturePairs);
+        std::vector<OSMBatchJob> asJobs(nJobs);
+        std::vector<void*> ahJobs;
+        for( int i = 0; i < nJobs; i++ )
+        {
+            asJobs[i].poDS = this;
+            asJobs[i].iStart = static_cast<int>(
+                static_cast<GIntBig>(nWayFeaturePairs) * i / nJobs);
+            asJobs[i].iEnd = static_cast<int>(
+                static_cast<GIntBig>(nWayFeaturePairs) * (i + 1) / nJobs);
+            ahJobs.push_back(&asJobs[i]);
         }
+        poWTP->SubmitJobs(ResolveWaysJob, ahJobs);
+        poWTP->WaitCompletion();
+    }
 
-        if( nFound > 0 && bIsArea )
+    for( int iPair = 0; iPair < nWayFeaturePairs; iPair ++)
+    {
+        WayFeaturePair* psWayFeaturePairs = &pasWayFeaturePairs[iPair];
+
+        const EMULATED_BOOL bIsArea = psWayFeaturePairs->bIsArea;
+
+        LonLat* pasCoords = pasLonLatCache;
+        unsigned int nFound = 0;
+        if( bResolvedInParallel )
         {
-            pasLonLatCache[nFound].nLon = pasLonLatCache[0].nLon;
-            pasLonLatCache[nFound].nLat = pasLonLatCache[0].nLat;
-            nFound ++;
+            pasCoords = pasLonLatBatch +
+                (psWayFeaturePairs->panNodeRefs - panUnsortedReqIds) + iPair;
+            nFound = psWayFeaturePairs->nResolvedRefs;
+        }
+        else
+        {
+            nFound = ResolveWayNodes(psWayFeaturePairs, pasCoords);
         }
 
         if( nFound < 2 )
@@ -1758,30 +1985,20 @@ void OGROSMDataSource::ProcessWaysBatch()
                      bIsArea != 0,
                      psWayFeaturePairs->nTags,
                      psWayFeaturePairs->pasTags,
-                     pasLonLatCache, (int)nFound,
+                     pasCoords, (int)nFound,
                      &psWayFeaturePairs->sInfo);
         }
         else
             IndexWay(psWayFeaturePairs->nWayID, bIsArea != 0, 0, nullptr,
-                     pasLonLatCache, (int)nFound, nullptr);
+                     pasCoords, (int)nFound, nullptr);
 
         if( psWayFeaturePairs->poFeature == nullptr )
         {
             continue;
         }
 
-        OGRLineString* poLS = new OGRLineString();
-        OGRGeometry* poGeom = poLS;
-
-        poLS->setNumPoints((int)nFound);
-        for( unsigned int i=0;i<nFound;i++)
-        {
-            poLS->setPoint(i,
-                        INT_TO_DBL(pasLonLatCache[i].nLon),
-                        INT_TO_DBL(pasLonLatCache[i].nLat));
-        }
-
-        psWayFeaturePairs->poFeature->SetGeometryDirectly(poGeom);
+        if( !bResolvedInParallel )
+            SetWayGeometry(psWayFeaturePairs, pasCoords, nFound);
 
         if( nFound != psWayFeaturePairs->nRefs )
             CPLDebug("OSM", "For way " CPL_FRMT_GIB ", got only %d nodes instead of %d",
@@ -2963,6 +3180,57 @@ int OGROSMDataSource::Open( const char * pszFilename,
         }
     }
 
+/* -------------------------------------------------------------------- */
+/*      Worker threads used to compress node sectors and to resolve     */
+/*      the coordinates of way geometries.                              */
+/* -------------------------------------------------------------------- */
+    const char* pszNumThreads = CSLFetchNameValueDef(
+        papszOpenOptionsIn, "NUM_THREADS",
+        CPLGetConfigOption("GDAL_NUM_THREADS", "ALL_CPUS"));
+    nNumThreads = CPLGetNumCPUs();
+    if( !EQUAL(pszNumThreads, "ALL_CPUS") )
+        nNumThreads = std::min(2 * nNumThreads, atoi(pszNumThreads));
+    if( nNumThreads > 1 )
+    {
+        poWTP = new CPLWorkerThreadPool();
+        if( !poWTP->Setup(nNumThreads, nullptr, nullptr) )
+        {
+            delete poWTP;
+            poWTP = nullptr;
+        }
+    }
+    if( poWTP != nullptr )
+    {
+        pasLonLatBatch = static_cast<LonLat*>(VSI_MALLOC_VERBOSE(
+            (MAX_ACCUMULATED_NODES + MAX_DELAYED_FEATURES) * sizeof(LonLat)));
+        if( pasLonLatBatch == nullptr )
+        {
+            return FALSE;
+        }
+        if( bCustomIndexing && bCompressNodes )
+        {
+            pabyPendingSectors = static_cast<GByte*>(VSI_MALLOC_VERBOSE(
+                BUCKET_SECTOR_SIZE_ARRAY_SIZE * SECTOR_SIZE));
+            pabyPendingCompressed = static_cast<GByte*>(VSI_MALLOC_VERBOSE(
+                BUCKET_SECTOR_SIZE_ARRAY_SIZE * 2 * SECTOR_SIZE));
+            panPendingSectorIdx = static_cast<int*>(VSI_MALLOC_VERBOSE(
+                BUCKET_SECTOR_SIZE_ARRAY_SIZE * sizeof(int)));
+            panPendingCompressedSize = static_cast<int*>(VSI_MALLOC_VERBOSE(
+                BUCKET_SECTOR_SIZE_ARRAY_SIZE * sizeof(int)));
+            if( pabyPendingSectors == nullptr ||
+                pabyPendingCompressed == nullptr ||
+                panPendingSectorIdx == nullptr ||
+                panPendingCompressedSize == nullptr )
+            {
+                return FALSE;
+            }
+        }
+    }
+    else
+    {
+        nNumThreads = 1;
+    }
+
     const bool bRet = CreateTempDB();
     if( bRet )
     {
@@ -3839,6 +4107,7 @@ int OGROSMDataSource::MyResetReading()
         VSIFSeekL(fpNodes, 0, SEEK_SET);
         VSIFTruncateL(fpNodes, 0);
         nNodesFileSize = 0;
+        nPendingSectors = 0;
 
         memset(pabySector, 0, SECTOR_SIZE);
 
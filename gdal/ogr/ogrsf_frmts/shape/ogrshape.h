@@ -55,6 +55,10 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
                                OGRFeatureDefn * poDefn, int iShape,
                                SHPObject *psShape, const char *pszSHPEncoding );
 OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape );
+OGRFeature *SHPReadOGRFeatureFields( DBFHandle hDBF, OGRFeatureDefn * poDefn,
+                                     int iShape,
+                                     const std::vector<int>& anFields,
+                                     const char *pszSHPEncoding );
 OGRFeatureDefn *SHPReadOGRFeatureDefn( const char * pszName,
                                        SHPHandle hSHP, DBFHandle hDBF,
                                        const char *pszSHPEncoding,
@@ -119,6 +123,11 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
 
     bool                ScanIndices();
 
+    // Fields used by the attribute filter, when it can be evaluated on
+    // them only, before reading the geometry and the other fields.
+    bool                m_bAttrFilterOnFieldsFirst;
+    std::vector<int>    m_anAttrFilterFields;
+
     GIntBig            *panMatchingFIDs;
     int                 iMatchingFID;
     void                ClearMatchingFIDs();
@@ -165,6 +174,7 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
     void                TruncateDBF();
 
     bool                bCreateSpatialIndexAtClose;
+    bool                m_bSpatialSortAtClose;
     bool                bRewindOnWrite;
 
     bool                m_bAutoRepack;
@@ -176,6 +186,8 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
     } NormandyState; /* French joke. "Peut'et' ben que oui, peut'et' ben que non." Sorry :-) */
     NormandyState       m_eNeedRepack;
 
+    bool                SortAlongHilbertCurve( std::vector<int>& anShapeOrder );
+
   protected:
 
     virtual void        CloseUnderlyingLayer() override;
@@ -187,7 +199,7 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
   public:
     OGRErr              CreateSpatialIndex( int nMaxDepth );
     OGRErr              DropSpatialIndex();
-    OGRErr              Repack();
+    OGRErr              Repack( bool bSpatialSort = false );
     OGRErr              RecomputeExtent();
     OGRErr              ResizeDBF();
 
@@ -245,6 +257,8 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
     void                AddToFileList( CPLStringList& oFileList );
     void                CreateSpatialIndexAtClose( int bFlag )
         { bCreateSpatialIndexAtClose = CPL_TO_BOOL(bFlag); }
+    void                SetSpatialSortAtClose( bool bFlag )
+        { m_bSpatialSortAtClose = bFlag; }
     void                SetModificationDate( const char* pszStr );
     void                SetAutoRepack(bool b) { m_bAutoRepack = b; }
     void                SetWriteDBFEOFChar(bool b);
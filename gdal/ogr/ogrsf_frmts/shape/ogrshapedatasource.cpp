@@ -796,6 +796,8 @@ OGRShapeDataSource::ICreateLayer( const char * pszLayerName,
         CPLFetchBool( papszOptions, "RESIZE", false ) );
     poLayer->CreateSpatialIndexAtClose(
         CPLFetchBool( papszOptions, "SPATIAL_INDEX", false ) );
+    poLayer->SetSpatialSortAtClose(
+        CPLFetchBool( papszOptions, "SPATIAL_SORT", false ) );
     poLayer->SetModificationDate(
         CSLFetchNameValue( papszOptions, "DBF_DATE_LAST_UPDATE" ) );
     poLayer->SetAutoRepack(
@@ -1167,6 +1169,7 @@ OGRErr OGRShapeDataSource::DeleteLayer( int iLayer )
     VSIUnlink( CPLResetExtension(pszFilename, "dbf") );
     VSIUnlink( CPLResetExtension(pszFilename, "prj") );
     VSIUnlink( CPLResetExtension(pszFilename, "qix") );
+    VSIUnlink( CPLResetExtension(pszFilename, "oix") );
 
     CPLFree( pszFilename );
 
@@ -32,6 +32,7 @@
 #include "cpl_conv.h"
 #include "cpl_string.h"
 #include "cpl_time.h"
+#include "ogr_attrind.h"
 #include "ogr_p.h"
 
 #include <algorithm>
@@ -61,6 +62,7 @@ OGRShapeLayer::OGRShapeLayer( OGRShapeDataSource* poDSIn,
     hDBF(hDBFIn),
     bUpdateAccess(bUpdate),
     eRequestedGeomType(eReqType),
+    m_bAttrFilterOnFieldsFirst(false),
     panMatchingFIDs(nullptr),
     iMatchingFID(0),
     m_poFilterGeomLastValid(nullptr),
@@ -79,6 +81,7 @@ OGRShapeLayer::OGRShapeLayer( OGRShapeDataSource* poDSIn,
     eFileDescriptorsState(FD_OPENED),
     bResizeAtClose(false),
     bCreateSpatialIndexAtClose(false),
+    m_bSpatialSortAtClose(false),
     bRewindOnWrite(false),
     m_bAutoRepack(false),
     m_eNeedRepack(MAYBE)
@@ -239,7 +242,9 @@ OGRShapeLayer::OGRShapeLayer( OGRShapeDataSource* poDSIn,
 OGRShapeLayer::~OGRShapeLayer()
 
 {
-    if( m_eNeedRepack == YES && m_bAutoRepack )
+    if( m_bSpatialSortAtClose && hSHP != nullptr )
+        Repack(true);
+    else if( m_eNeedRepack == YES && m_bAutoRepack )
         Repack();
 
     if( bResizeAtClose && hDBF != nullptr )
@@ -703,7 +708,35 @@ OGRErr OGRShapeLayer::SetAttributeFilter( const char * pszAttributeFilter )
 {
     ClearMatchingFIDs();
 
-    return OGRLayer::SetAttributeFilter(pszAttributeFilter);
+    const OGRErr eErr = OGRLayer::SetAttributeFilter(pszAttributeFilter);
+
+/* -------------------------------------------------------------------- */
+/*      Check if the filter only uses regular fields and the FID, in    */
+/*      which case it can be evaluated before reading the geometry and  */
+/*      the other fields.                                               */
+/* -------------------------------------------------------------------- */
+    m_bAttrFilterOnFieldsFirst = false;
+    m_anAttrFilterFields.clear();
+    if( eErr == OGRERR_NONE && m_poAttrQuery != nullptr && hDBF != nullptr )
+    {
+        char** papszUsedFields = m_poAttrQuery->GetUsedFields();
+        bool bOnlyFields = papszUsedFields != nullptr;
+        for( int i = 0;
+             papszUsedFields != nullptr && papszUsedFields[i] != nullptr;
+             i++ )
+        {
+            const int iField =
+                poFeatureDefn->GetFieldIndex(papszUsedFields[i]);
+            if( iField >= 0 )
+                m_anAttrFilterFields.push_back(iField);
+            else if( !EQUAL(papszUsedFields[i], SpecialFieldNames[SPF_FID]) )
+                bOnlyFields = false;
+        }
+        CSLDestroy(papszUsedFields);
+        m_bAttrFilterOnFieldsFirst = bOnlyFields;
+    }
+
+    return eErr;
 }
 
 /************************************************************************/
@@ -775,6 +808,21 @@ OGRFeature *OGRShapeLayer::FetchShape( int iShapeId )
                                            iShapeId, psShape, osEncoding );
         }
     }
+    else if( m_bAttrFilterOnFieldsFirst && m_poAttrQuery != nullptr )
+    {
+        // Only read the geometry and the other fields of the features
+        // matching the attribute filter.
+        OGRFeature *poFieldsFeature =
+            SHPReadOGRFeatureFields( hDBF, poFeatureDefn, iShapeId,
+                                     m_anAttrFilterFields, osEncoding );
+        if( poFieldsFeature == nullptr ||
+            m_poAttrQuery->Evaluate( poFieldsFeature ) )
+        {
+            poFeature = SHPReadOGRFeature( hSHP, hDBF, poFeatureDefn,
+                                           iShapeId, nullptr, osEncoding );
+        }
+        delete poFieldsFeature;
+    }
     else
     {
         poFeature = SHPReadOGRFeature( hSHP, hDBF, poFeatureDefn,
@@ -929,6 +977,8 @@ OGRErr OGRShapeLayer::ISetFeature( OGRFeature *poFeature )
     bHeaderDirty = true;
     if( CheckForQIX() || CheckForSBN() )
         DropSpatialIndex();
+    if( m_poAttrIndex != nullptr )
+        m_poAttrIndex->Invalidate();
 
     unsigned int nOffset = 0;
     unsigned int nSize = 0;
@@ -1013,6 +1063,8 @@ OGRErr OGRShapeLayer::DeleteFeature( GIntBig nFID )
     bHeaderDirty = true;
     if( CheckForQIX() || CheckForSBN() )
         DropSpatialIndex();
+    if( m_poAttrIndex != nullptr )
+        m_poAttrIndex->Invalidate();
     m_eNeedRepack = YES;
 
     return OGRERR_NONE;
@@ -1045,6 +1097,8 @@ OGRErr OGRShapeLayer::ICreateFeature( OGRFeature *poFeature )
     bHeaderDirty = true;
     if( CheckForQIX() || CheckForSBN() )
         DropSpatialIndex();
+    if( m_poAttrIndex != nullptr )
+        m_poAttrIndex->Invalidate();
 
     poFeature->SetFID( OGRNullFID );
 
@@ -1379,10 +1433,11 @@ int OGRShapeLayer::GetFeatureCountWithSpatialFilterOnly()
             else
             {
 /* -------------------------------------------------------------------- */
-/*      Fallback to full intersect test (using GEOS) if we still        */
-/*      don't know for sure.                                            */
+/*      Fallback to full intersect test (using the coverage grid of     */
+/*      the filter and/or GEOS) if we still don't know for sure.        */
 /* -------------------------------------------------------------------- */
-                if( OGRGeometryFactory::haveGEOS() )
+                if( OGRGeometryFactory::haveGEOS() ||
+                    GetFilterGrid() != nullptr )
                 {
                     // Read the full geometry.
                     if( poGeometry == nullptr )
@@ -1396,20 +1451,11 @@ int OGRShapeLayer::GetFeatureCountWithSpatialFilterOnly()
                             psShape = nullptr;
                         }
                     }
-                    if( poGeometry == nullptr )
+                    if( poGeometry == nullptr ||
+                        FilterGeometry(poGeometry) )
                     {
                         nFeatureCount++;
                     }
-                    else if( m_pPreparedFilterGeom != nullptr )
-                    {
-                        if( OGRPreparedGeometryIntersects(m_pPreparedFilterGeom,
-                                                          poGeometry) )
-                        {
-                            nFeatureCount++;
-                        }
-                    }
-                    else if( m_poFilterGeom->Intersects( poGeometry ) )
-                        nFeatureCount++;
                 }
                 else
                 {
@@ -2481,17 +2527,159 @@ static void ForceDeleteFile( const CPLString& osFilename )
     CheckFileDeletion( osFilename );
 }
 
+/************************************************************************/
+/*                            HilbertCode()                             */
+/*                                                                      */
+/*      Distance of (nX, nY) along the Hilbert curve filling a          */
+/*      65536 x 65536 grid.                                             */
+/************************************************************************/
+
+static GUInt32 HilbertCode( GUInt32 nX, GUInt32 nY )
+{
+    GUInt32 nCode = 0;
+    for( GUInt32 nS = 1U << 15; nS > 0; nS >>= 1 )
+    {
+        const GUInt32 nRX = (nX & nS) ? 1 : 0;
+        const GUInt32 nRY = (nY & nS) ? 1 : 0;
+        nCode += nS * nS * ((3 * nRX) ^ nRY);
+        if( nRY == 0 )
+        {
+            if( nRX == 1 )
+            {
+                nX = 65535 - nX;
+                nY = 65535 - nY;
+            }
+            std::swap(nX, nY);
+        }
+    }
+    return nCode;
+}
+
+/************************************************************************/
+/*                       SortAlongHilbertCurve()                        */
+/*                                                                      */
+/*      Sort shape ids according to the position of the center of      */
+/*      the bounding box of the shapes along a Hilbert curve covering  */
+/*      the layer extent. Null shapes are put at the end.               */
+/************************************************************************/
+
+bool OGRShapeLayer::SortAlongHilbertCurve( std::vector<int>& anShapeOrder )
+{
+    const double dfMinX = hSHP->adBoundsMin[0];
+    const double dfMinY = hSHP->adBoundsMin[1];
+    const double dfScaleX = hSHP->adBoundsMax[0] > dfMinX ?
+                    65535.0 / (hSHP->adBoundsMax[0] - dfMinX) : 0.0;
+    const double dfScaleY = hSHP->adBoundsMax[1] > dfMinY ?
+                    65535.0 / (hSHP->adBoundsMax[1] - dfMinY) : 0.0;
+
+    std::vector<std::pair<GUInt32, int>> aoCodes;
+    aoCodes.reserve(anShapeOrder.size());
+
+    for( size_t i = 0; i < anShapeOrder.size(); i++ )
+    {
+        const int iShape = anShapeOrder[i];
+        if( iShape >= hSHP->nRecords )
+            return false;
+
+/* -------------------------------------------------------------------- */
+/*      Only read the shape type and the bounding box, or the           */
+/*      coordinates of points, unless the .shx is lazily loaded.        */
+/* -------------------------------------------------------------------- */
+        int nSHPType = SHPT_NULL;
+        double dfX = 0.0;
+        double dfY = 0.0;
+        if( hSHP->panRecOffset[iShape] != 0 )
+        {
+            GByte abyBuf[4 + 8 * 4] = {};
+            const int nToRead = std::min(static_cast<int>(sizeof(abyBuf)),
+                                static_cast<int>(hSHP->panRecSize[iShape]));
+            if( nToRead >= 4 &&
+                (hSHP->sHooks.FSeek( hSHP->fpSHP,
+                                     hSHP->panRecOffset[iShape] + 8, 0 ) != 0 ||
+                 hSHP->sHooks.FRead( abyBuf, nToRead,
+                                     1, hSHP->fpSHP ) != 1) )
+            {
+                return false;
+            }
+            if( nToRead >= 4 )
+            {
+                memcpy(&nSHPType, abyBuf, 4);
+                CPL_LSBPTR32(&nSHPType);
+            }
+            double adfVal[4] = { 0.0, 0.0, 0.0, 0.0 };
+            for( int j = 0; j < 4 && 4 + (j + 1) * 8 <= nToRead; j++ )
+            {
+                memcpy(&adfVal[j], abyBuf + 4 + j * 8, 8);
+                CPL_LSBPTR64(&adfVal[j]);
+            }
+            if( nSHPType == SHPT_POINT || nSHPType == SHPT_POINTM ||
+                nSHPType == SHPT_POINTZ )
+            {
+                if( nToRead < 4 + 8 * 2 )
+                    nSHPType = SHPT_NULL;
+                dfX = adfVal[0];
+                dfY = adfVal[1];
+            }
+            else if( nSHPType != SHPT_NULL )
+            {
+                if( nToRead < 4 + 8 * 4 )
+                    nSHPType = SHPT_NULL;
+                dfX = (adfVal[0] + adfVal[2]) / 2;
+                dfY = (adfVal[1] + adfVal[3]) / 2;
+            }
+        }
+        else
+        {
+            SHPObject *psShape = SHPReadObject( hSHP, iShape );
+            if( psShape != nullptr )
+            {
+                nSHPType = psShape->nSHPType;
+                dfX = (psShape->dfXMin + psShape->dfXMax) / 2;
+                dfY = (psShape->dfYMin + psShape->dfYMax) / 2;
+                SHPDestroyObject( psShape );
+            }
+        }
+
+        GUInt32 nCode = 0xFFFFFFFFU;
+        if( nSHPType != SHPT_NULL )
+        {
+            const double dfGridX =
+                std::max(0.0, std::min(65535.0, (dfX - dfMinX) * dfScaleX));
+            const double dfGridY =
+                std::max(0.0, std::min(65535.0, (dfY - dfMinY) * dfScaleY));
+            // NaN coordinates end up at the origin of the curve.
+            nCode = HilbertCode(
+                CPLIsNan(dfGridX) ? 0 : static_cast<GUInt32>(dfGridX),
+                CPLIsNan(dfGridY) ? 0 : static_cast<GUInt32>(dfGridY));
+        }
+        aoCodes.push_back(std::pair<GUInt32, int>(nCode, iShape));
+    }
+
+    std::sort(aoCodes.begin(), aoCodes.end());
+    for( size_t i = 0; i < aoCodes.size(); i++ )
+        anShapeOrder[i] = aoCodes[i].second;
+
+    return true;
+}
+
 /************************************************************************/
 /*                               Repack()                               */
 /*                                                                      */
 /*      Repack the shape and dbf file, dropping deleted records.        */
 /*      FIDs may change.                                                */
+/*                                                                      */
+/*      If bSpatialSort is set, the records are also reordered along    */
+/*      a Hilbert curve, so that features close to each other are       */
+/*      stored close to each other.                                     */
 /************************************************************************/
 
-OGRErr OGRShapeLayer::Repack()
+OGRErr OGRShapeLayer::Repack( bool bSpatialSort )
 
 {
-    if( m_eNeedRepack == NO )
+    if( hSHP == nullptr )
+        bSpatialSort = false;
+
+    if( m_eNeedRepack == NO && !bSpatialSort )
     {
         CPLDebug("Shape", "REPACK: nothing to do. Was done previously");
         return OGRERR_NONE;
@@ -2564,7 +2752,7 @@ OGRErr OGRShapeLayer::Repack()
 /*      If there are no records marked for deletion, we take no         */
 /*      action.                                                         */
 /* -------------------------------------------------------------------- */
-    if( nDeleteCount == 0 && !bSHPNeedsRepack )
+    if( nDeleteCount == 0 && !bSHPNeedsRepack && !bSpatialSort )
     {
         CPLDebug("Shape", "REPACK: nothing to do");
         CPLFree( panRecordsToDelete );
@@ -2572,6 +2760,35 @@ OGRErr OGRShapeLayer::Repack()
     }
     panRecordsToDelete[nDeleteCount] = -1;
 
+/* -------------------------------------------------------------------- */
+/*      Establish the order in which the records that are not deleted   */
+/*      will be written.                                                */
+/* -------------------------------------------------------------------- */
+    std::vector<int> anShapeOrder;
+    anShapeOrder.reserve(nTotalShapeCount - nDeleteCount);
+    {
+        int iNextDeletedShape = 0;
+        for( int iShape = 0; iShape < nTotalShapeCount; iShape++ )
+        {
+            if( panRecordsToDelete[iNextDeletedShape] == iShape )
+                iNextDeletedShape++;
+            else
+                anShapeOrder.push_back(iShape);
+        }
+    }
+
+    if( bSpatialSort )
+    {
+        CPLDebug("Shape", "REPACK: sorting records along a Hilbert curve");
+        if( !SortAlongHilbertCurve(anShapeOrder) )
+        {
+            CPLError(CE_Failure, CPLE_FileIO,
+                     "Error while reading shape bounds for spatial sorting");
+            CPLFree( panRecordsToDelete );
+            return OGRERR_FAILURE;
+        }
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Find existing filenames with exact case (see #3293).            */
 /* -------------------------------------------------------------------- */
@@ -2661,7 +2878,7 @@ OGRErr OGRShapeLayer::Repack()
     CPLString oTempFileDBF;
     const int nNewRecords = nTotalShapeCount - nDeleteCount;
 
-    if( hDBF != nullptr && nDeleteCount > 0 )
+    if( hDBF != nullptr && (nDeleteCount > 0 || bSpatialSort) )
     {
         CPLDebug("Shape", "REPACK: repacking .dbf");
         bMustReopenDBF = true;
@@ -2692,28 +2909,19 @@ OGRErr OGRShapeLayer::Repack()
 /* -------------------------------------------------------------------- */
 /*      Copy over all records that are not deleted.                     */
 /* -------------------------------------------------------------------- */
-        int iDestShape = 0;
-        int iNextDeletedShape = 0;
-
-        for( int iShape = 0;
-             iShape < nTotalShapeCount && eErr == OGRERR_NONE;
-             iShape++ )
+        for( int iDestShape = 0;
+             iDestShape < nNewRecords && eErr == OGRERR_NONE;
+             iDestShape++ )
         {
-            if( panRecordsToDelete[iNextDeletedShape] == iShape )
-            {
-                iNextDeletedShape++;
-            }
-            else
+            const int iShape = anShapeOrder[iDestShape];
+            void *pTuple =
+                const_cast<char *>( DBFReadTuple( hDBF, iShape ) );
+            if( pTuple == nullptr ||
+                !DBFWriteTuple( hNewDBF, iDestShape, pTuple ) )
             {
-                void *pTuple =
-                    const_cast<char *>( DBFReadTuple( hDBF, iShape ) );
-                if( pTuple == nullptr ||
-                    !DBFWriteTuple( hNewDBF, iDestShape++, pTuple ) )
-                {
-                    CPLError(CE_Failure, CPLE_AppDefined,
-                             "Error writing record %d in .dbf", iShape);
-                    eErr = OGRERR_FAILURE;
-                }
+                CPLError(CE_Failure, CPLE_AppDefined,
+                         "Error writing record %d in .dbf", iShape);
+                eErr = OGRERR_FAILURE;
             }
         }
 
@@ -2772,30 +2980,22 @@ OGRErr OGRShapeLayer::Repack()
 /* -------------------------------------------------------------------- */
 /*      Copy over all records that are not deleted.                     */
 /* -------------------------------------------------------------------- */
-        int iNextDeletedShape = 0;
-
-        for( int iShape = 0;
-             iShape < nTotalShapeCount && eErr == OGRERR_NONE;
-             iShape++ )
+        for( size_t iDestShape = 0;
+             iDestShape < anShapeOrder.size() && eErr == OGRERR_NONE;
+             iDestShape++ )
         {
-            if( panRecordsToDelete[iNextDeletedShape] == iShape )
+            const int iShape = anShapeOrder[iDestShape];
+            SHPObject *hObject = SHPReadObject( hSHP, iShape );
+            if( hObject == nullptr ||
+                SHPWriteObject( hNewSHP, -1, hObject ) == -1 )
             {
-                iNextDeletedShape++;
+                CPLError(CE_Failure, CPLE_AppDefined,
+                         "Error writing record %d in .shp", iShape);
+                eErr = OGRERR_FAILURE;
             }
-            else
-            {
-                SHPObject *hObject = SHPReadObject( hSHP, iShape );
-                if( hObject == nullptr ||
-                    SHPWriteObject( hNewSHP, -1, hObject ) == -1 )
-                {
-                    CPLError(CE_Failure, CPLE_AppDefined,
-                             "Error writing record %d in .shp", iShape);
-                    eErr = OGRERR_FAILURE;
-                }
 
-                if( hObject )
-                    SHPDestroyObject( hObject );
-            }
+            if( hObject )
+                SHPDestroyObject( hObject );
         }
 
         if( bPackInPlace )
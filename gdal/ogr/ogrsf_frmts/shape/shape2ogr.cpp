@@ -1175,6 +1175,99 @@ OGRFeatureDefn *SHPReadOGRFeatureDefn( const char * pszName,
     return poDefn;
 }
 
+/************************************************************************/
+/*                          SHPReadOGRField()                           */
+/************************************************************************/
+
+static void SHPReadOGRField( DBFHandle hDBF, OGRFeature* poFeature,
+                             int iShape, int iField,
+                             const OGRFieldDefn* poFieldDefn,
+                             const char *pszSHPEncoding )
+{
+    switch( poFieldDefn->GetType() )
+    {
+      case OFTString:
+      {
+          const char * const pszFieldVal =
+              DBFReadStringAttribute( hDBF, iShape, iField );
+          if( pszFieldVal != nullptr && pszFieldVal[0] != '\0' )
+          {
+            if( pszSHPEncoding[0] != '\0' )
+            {
+                char * const pszUTF8Field =
+                    CPLRecode( pszFieldVal, pszSHPEncoding, CPL_ENC_UTF8);
+                poFeature->SetField( iField, pszUTF8Field );
+                CPLFree( pszUTF8Field );
+            }
+            else
+                poFeature->SetField( iField, pszFieldVal );
+          }
+          else
+          {
+              poFeature->SetFieldNull(iField);
+          }
+          break;
+      }
+      case OFTInteger:
+      case OFTInteger64:
+      case OFTReal:
+      {
+          if( DBFIsAttributeNULL( hDBF, iShape, iField ) )
+          {
+              poFeature->SetFieldNull(iField);
+          }
+          else
+          {
+              poFeature->SetField(
+                  iField,
+                  DBFReadStringAttribute( hDBF, iShape, iField ) );
+          }
+          break;
+      }
+      case OFTDate:
+      {
+          if( DBFIsAttributeNULL( hDBF, iShape, iField ) )
+          {
+              poFeature->SetFieldNull(iField);
+              return;
+          }
+
+          const char* const pszDateValue =
+              DBFReadStringAttribute(hDBF,iShape,iField);
+
+          // Some DBF files have fields filled with spaces
+          // (trimmed by DBFReadStringAttribute) to indicate null
+          // values for dates (#4265).
+          if( pszDateValue[0] == '\0' )
+              return;
+
+          OGRField sFld;
+          memset( &sFld, 0, sizeof(sFld) );
+
+          if( strlen(pszDateValue) >= 10 &&
+              pszDateValue[2] == '/' && pszDateValue[5] == '/' )
+          {
+              sFld.Date.Month = static_cast<GByte>(atoi(pszDateValue + 0));
+              sFld.Date.Day   = static_cast<GByte>(atoi(pszDateValue + 3));
+              sFld.Date.Year  = static_cast<GInt16>(atoi(pszDateValue + 6));
+          }
+          else
+          {
+              const int nFullDate = atoi(pszDateValue);
+              sFld.Date.Year = static_cast<GInt16>(nFullDate / 10000);
+              sFld.Date.Month = static_cast<GByte>((nFullDate / 100) % 100);
+              sFld.Date.Day = static_cast<GByte>(nFullDate % 100);
+          }
+
+          poFeature->SetField( iField, &sFld );
+      }
+      break;
+
+      default:
+        CPLAssert( false );
+    }
+}
+
 /************************************************************************/
 /*                         SHPReadOGRFeature()                          */
 /************************************************************************/
@@ -1274,92 +1367,46 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
         if( poFieldDefn->IsIgnored() )
             continue;
 
-        switch( poFieldDefn->GetType() )
-        {
-          case OFTString:
-          {
-              const char * const pszFieldVal =
-                  DBFReadStringAttribute( hDBF, iShape, iField );
-              if( pszFieldVal != nullptr && pszFieldVal[0] != '\0' )
-              {
-                if( pszSHPEncoding[0] != '\0' )
-                {
-                    char * const pszUTF8Field =
-                        CPLRecode( pszFieldVal, pszSHPEncoding, CPL_ENC_UTF8);
-                    poFeature->SetField( iField, pszUTF8Field );
-                    CPLFree( pszUTF8Field );
-                }
-                else
-                    poFeature->SetField( iField, pszFieldVal );
-              }
-              else
-              {
-                  poFeature->SetFieldNull(iField);
-              }
-              break;
-          }
-          case OFTInteger:
-          case OFTInteger64:
-          case OFTReal:
-          {
-              if( DBFIsAttributeNULL( hDBF, iShape, iField ) )
-              {
-                  poFeature->SetFieldNull(iField);
-              }
-              else
-              {
-                  poFeature->SetField(
-                      iField,
-                      DBFReadStringAttribute( hDBF, iShape, iField ) );
-              }
-              break;
-          }
-          case OFTDate:
-          {
-              if( DBFIsAttributeNULL( hDBF, iShape, iField ) )
-              {
-                  poFeature->SetFieldNull(iField);
-                  continue;
-              }
+        SHPReadOGRField( hDBF, poFeature, iShape, iField, poFieldDefn,
+                         pszSHPEncoding );
+    }
 
-              const char* const pszDateValue =
-                  DBFReadStringAttribute(hDBF,iShape,iField);
+    if( poFeature != nullptr )
+        poFeature->SetFID( iShape );
 
-              // Some DBF files have fields filled with spaces
-              // (trimmed by DBFReadStringAttribute) to indicate null
-              // values for dates (#4265).
-              if( pszDateValue[0] == '\0' )
-                  continue;
+    return poFeature;
+}
 
-              OGRField sFld;
-              memset( &sFld, 0, sizeof(sFld) );
+/************************************************************************/
+/*                       SHPReadOGRFeatureFields()                      */
+/*                                                                      */
+/*      Read only the passed fields of a record, without its            */
+/*      geometry. Returns nullptr if the record cannot be read.         */
+/************************************************************************/
 
-              if( strlen(pszDateValue) >= 10 &&
-                  pszDateValue[2] == '/' && pszDateValue[5] == '/' )
-              {
-                  sFld.Date.Month = static_cast<GByte>(atoi(pszDateValue + 0));
-                  sFld.Date.Day   = static_cast<GByte>(atoi(pszDateValue + 3));
-                  sFld.Date.Year  = static_cast<GInt16>(atoi(pszDateValue + 6));
-              }
-              else
-              {
-                  const int nFullDate = atoi(pszDateValue);
-                  sFld.Date.Year = static_cast<GInt16>(nFullDate / 10000);
-                  sFld.Date.Month = static_cast<GByte>((nFullDate / 100) % 100);
-                  sFld.Date.Day = static_cast<GByte>(nFullDate % 100);
-              }
+OGRFeature *SHPReadOGRFeatureFields( DBFHandle hDBF, OGRFeatureDefn * poDefn,
+                                     int iShape,
+                                     const std::vector<int>& anFields,
+                                     const char *pszSHPEncoding )
 
-              poFeature->SetField( iField, &sFld );
-          }
-          break;
+{
+    if( iShape < 0 || iShape >= hDBF->nRecords ||
+        DBFIsRecordDeleted( hDBF, iShape ) )
+    {
+        return nullptr;
+    }
 
-          default:
-            CPLAssert( false );
+    OGRFeature *poFeature = new OGRFeature( poDefn );
+    for( size_t i = 0; i < anFields.size(); i++ )
+    {
+        if( anFields[i] < poDefn->GetFieldCount() )
+        {
+            SHPReadOGRField( hDBF, poFeature, iShape, anFields[i],
+                             poDefn->GetFieldDefn(anFields[i]),
+                             pszSHPEncoding );
         }
     }
-
-    if( poFeature != nullptr )
-        poFeature->SetFID( iShape );
+    poFeature->SetFID( iShape );
 
     return poFeature;
 }
@@ -43,6 +43,16 @@ typedef struct
     int       bEnforce2GBLimit;
     int       bHasWarned2GB;
     SAOffset  nCurOffset;
+
+    /* Read buffer, only used for files opened in read-only mode. When it */
+    /* is used, nCurOffset is the logical position, and the position of */
+    /* fp is only meaningful after a seek. */
+    SAOffset  nBufferSize;
+    GByte    *pabyBuffer;
+    SAOffset  nBufferOffset;
+    SAOffset  nBufferDataSize;
+    SAOffset  nLastReadEnd;
+    SAOffset  nFileSize;
 } OGRSHPDBFFile;
 
 /************************************************************************/
@@ -83,6 +93,28 @@ SAFile VSI_SHP_OpenInternal( const char *pszFilename, const char *pszAccess,
     pFile->pszFilename = CPLStrdup(pszFilename);
     pFile->bEnforce2GBLimit = bEnforce2GBLimit;
     pFile->nCurOffset = 0;
+
+/* -------------------------------------------------------------------- */
+/*      Read the file by large chunks in read-only mode, so that the    */
+/*      many small reads of records are served from memory.             */
+/* -------------------------------------------------------------------- */
+    if( strchr(pszAccess, '+') == NULL && strchr(pszAccess, 'w') == NULL &&
+        strchr(pszAccess, 'a') == NULL )
+    {
+        const int nBufferSize =
+            atoi(CPLGetConfigOption("SHAPE_READ_BUFFER_SIZE", "65536"));
+        if( nBufferSize > 0 &&
+            VSIFSeekL( fp, 0, SEEK_END ) == 0 )
+        {
+            const vsi_l_offset nFileSize = VSIFTellL( fp );
+            if( VSIFSeekL( fp, 0, SEEK_SET ) == 0 )
+            {
+                pFile->nFileSize = (SAOffset) nFileSize;
+                pFile->nBufferSize =
+                    MIN((SAOffset) nBufferSize, pFile->nFileSize);
+            }
+        }
+    }
     return (SAFile) pFile;
 }
 
@@ -117,7 +149,73 @@ SAOffset VSI_SHP_Read( void *p, SAOffset size, SAOffset nmemb, SAFile file )
 
 {
     OGRSHPDBFFile* pFile = (OGRSHPDBFFile*) file;
-    SAOffset ret = (SAOffset) VSIFReadL( p, (size_t) size, (size_t) nmemb,
+    SAOffset ret;
+
+    if( pFile->nBufferSize > 0 )
+    {
+        const SAOffset nToRead = size * nmemb;
+
+/* -------------------------------------------------------------------- */
+/*      Refill the buffer if the request is not in it, and is small     */
+/*      and (almost) after the previous one.                            */
+/* -------------------------------------------------------------------- */
+        if( nToRead > 0 &&
+            !(pFile->nCurOffset >= pFile->nBufferOffset &&
+              pFile->nCurOffset + nToRead <=
+                    pFile->nBufferOffset + pFile->nBufferDataSize) &&
+            nToRead <= pFile->nBufferSize &&
+            pFile->nCurOffset + nToRead <= pFile->nFileSize &&
+            pFile->nCurOffset >= pFile->nLastReadEnd &&
+            pFile->nCurOffset - pFile->nLastReadEnd < pFile->nBufferSize )
+        {
+            if( pFile->pabyBuffer == NULL )
+            {
+                pFile->pabyBuffer = (GByte*)
+                    VSI_MALLOC_VERBOSE((size_t)pFile->nBufferSize);
+            }
+            pFile->nBufferDataSize = 0;
+            if( pFile->pabyBuffer != NULL &&
+                VSIFSeekL( pFile->fp, (vsi_l_offset) pFile->nCurOffset,
+                           SEEK_SET ) == 0 )
+            {
+                const SAOffset nBufferDataSize =
+                    MIN(pFile->nBufferSize,
+                        pFile->nFileSize - pFile->nCurOffset);
+                if( (SAOffset) VSIFReadL( pFile->pabyBuffer, 1,
+                                          (size_t) nBufferDataSize,
+                                          pFile->fp ) == nBufferDataSize )
+                {
+                    pFile->nBufferOffset = pFile->nCurOffset;
+                    pFile->nBufferDataSize = nBufferDataSize;
+                }
+            }
+        }
+
+        if( nToRead > 0 &&
+            pFile->nCurOffset >= pFile->nBufferOffset &&
+            pFile->nCurOffset + nToRead <=
+                    pFile->nBufferOffset + pFile->nBufferDataSize )
+        {
+            memcpy( p, pFile->pabyBuffer +
+                            (pFile->nCurOffset - pFile->nBufferOffset),
+                    (size_t) nToRead );
+            pFile->nCurOffset += nToRead;
+            pFile->nLastReadEnd = pFile->nCurOffset;
+            return nmemb;
+        }
+
+        /* Otherwise read directly from the file */
+        if( VSIFSeekL( pFile->fp, (vsi_l_offset) pFile->nCurOffset,
+                       SEEK_SET ) != 0 )
+            return 0;
+        ret = (SAOffset) VSIFReadL( p, (size_t) size, (size_t) nmemb,
+                                    pFile->fp );
+        pFile->nCurOffset += ret * size;
+        pFile->nLastReadEnd = pFile->nCurOffset;
+        return ret;
+    }
+
+    ret = (SAOffset) VSIFReadL( p, (size_t) size, (size_t) nmemb,
                                  pFile->fp );
     pFile->nCurOffset += ret * size;
     return ret;
@@ -162,6 +260,15 @@ SAOffset VSI_SHP_Write( void *p, SAOffset size, SAOffset nmemb, SAFile file )
     SAOffset ret;
     if( !VSI_SHP_WriteMoreDataOK( file, size * nmemb ) )
         return 0;
+    if( pFile->nBufferSize > 0 )
+    {
+        /* Should not happen given the access mode, but be safe */
+        pFile->nBufferSize = 0;
+        pFile->nBufferDataSize = 0;
+        if( VSIFSeekL( pFile->fp, (vsi_l_offset) pFile->nCurOffset,
+                       SEEK_SET ) != 0 )
+            return 0;
+    }
     ret = (SAOffset) VSIFWriteL( p, (size_t) size, (size_t) nmemb,
                                   pFile->fp );
     pFile->nCurOffset += ret * size;
@@ -177,7 +284,24 @@ SAOffset VSI_SHP_Seek( SAFile file, SAOffset offset, int whence )
 
 {
     OGRSHPDBFFile* pFile = (OGRSHPDBFFile*) file;
-    SAOffset ret = (SAOffset) VSIFSeekL( pFile->fp, (vsi_l_offset) offset, whence );
+    SAOffset ret;
+
+    if( pFile->nBufferSize > 0 )
+    {
+        /* Only update the logical position. But clear the end-of-file */
+        /* flag of the file, as callers might test it. */
+        if( whence == SEEK_SET )
+            pFile->nCurOffset = offset;
+        else if( whence == SEEK_CUR )
+            pFile->nCurOffset += offset;
+        else
+            pFile->nCurOffset = pFile->nFileSize + offset;
+        if( VSIFEofL( pFile->fp ) )
+            VSIFSeekL( pFile->fp, (vsi_l_offset) pFile->nCurOffset, SEEK_SET );
+        return 0;
+    }
+
+    ret = (SAOffset) VSIFSeekL( pFile->fp, (vsi_l_offset) offset, whence );
     if( whence == 0 && ret == 0)
         pFile->nCurOffset = offset;
     else
@@ -219,6 +343,7 @@ int VSI_SHP_Close( SAFile file )
 {
     OGRSHPDBFFile* pFile = (OGRSHPDBFFile*) file;
     int ret = VSIFCloseL( pFile->fp );
+    CPLFree(pFile->pabyBuffer);
     CPLFree(pFile->pszFilename);
     CPLFree(pFile);
     return ret;
@@ -255,6 +255,8 @@ int swqlex( YYSTYPE *ppNode, swq_parse_context *context )
             nReturn = SWQT_WHERE;
         else if( EQUAL(osToken, "ON") )
             nReturn = SWQT_ON;
+        else if( EQUAL(osToken, "GROUP") )
+            nReturn = SWQT_GROUP;
         else if( EQUAL(osToken, "ORDER") )
             nReturn = SWQT_ORDER;
         else if( EQUAL(osToken, "BY") )
@@ -305,6 +307,56 @@ int swqlex( YYSTYPE *ppNode, swq_parse_context *context )
     }
 }
 
+/************************************************************************/
+/*                      swq_select_init_summary()                       */
+/*                                                                      */
+/*      Allocate one initialized summary per result column.             */
+/************************************************************************/
+
+void swq_select_init_summary( swq_select *select_info,
+                              std::vector<swq_summary>& summary_list )
+
+{
+    summary_list.clear();
+    summary_list.resize(select_info->result_columns);
+    for( int i = 0; i < select_info->result_columns; i++ )
+    {
+        if( select_info->column_defs[i].distinct_flag )
+        {
+            swq_summary::Comparator oComparator;
+            if( select_info->query_mode == SWQM_DISTINCT_LIST &&
+                select_info->order_specs > 0 )
+            {
+                CPLAssert( select_info->order_specs ==1 );
+                CPLAssert( select_info->result_columns == 1 );
+                oComparator.bSortAsc =
+                    CPL_TO_BOOL(select_info->order_defs[0].ascending_flag);
+            }
+            if( select_info->column_defs[i].field_type == SWQ_INTEGER ||
+                select_info->column_defs[i].field_type == SWQ_INTEGER64 )
+            {
+                oComparator.eType = SWQ_INTEGER64;
+            }
+            else if( select_info->column_defs[i].field_type == SWQ_FLOAT )
+            {
+                oComparator.eType = SWQ_FLOAT;
+            }
+            else
+            {
+                oComparator.eType = SWQ_STRING;
+            }
+            summary_list[i].oSetDistinctValues =
+                std::set<CPLString, swq_summary::Comparator>(oComparator);
+        }
+        summary_list[i].min =
+            std::numeric_limits<double>::infinity();
+        summary_list[i].max =
+            -std::numeric_limits<double>::infinity();
+        summary_list[i].osMin = "9999/99/99 99:99:99";
+        summary_list[i].osMax = "0000/00/00 00:00:00";
+    }
+}
+
 /************************************************************************/
 /*                        swq_select_summarize()                        */
 /************************************************************************/
@@ -313,6 +365,23 @@ const char *
 swq_select_summarize( swq_select *select_info,
                       int dest_column, const char *value )
 
+{
+    return swq_select_summarize( select_info, select_info->column_summary,
+                                 dest_column, value );
+}
+
+/************************************************************************/
+/*                        swq_select_summarize()                        */
+/*                                                                      */
+/*      Accumulate a value into a caller provided summary list, as      */
+/*      used for the per-group summaries of a GROUP BY query.           */
+/************************************************************************/
+
+const char *
+swq_select_summarize( swq_select *select_info,
+                      std::vector<swq_summary>& summary_list,
+                      int dest_column, const char *value )
+
 {
     swq_col_def *def = select_info->column_defs + dest_column;
 
@@ -343,50 +412,13 @@ swq_select_summarize( swq_select *select_info,
 /*      Create the summary information if this is the first row         */
 /*      being processed.                                                */
 /* -------------------------------------------------------------------- */
-    if( select_info->column_summary.empty() )
-    {
-        select_info->column_summary.resize(select_info->result_columns);
-        for( int i = 0; i < select_info->result_columns; i++ )
-        {
-            if( def->distinct_flag )
-            {
-                swq_summary::Comparator oComparator;
-                if( select_info->order_specs > 0 )
-                {
-                    CPLAssert( select_info->order_specs ==1 );
-                    CPLAssert( select_info->result_columns == 1 );
-                    oComparator.bSortAsc =
-                        CPL_TO_BOOL(select_info->order_defs[0].ascending_flag);
-                }
-                if( select_info->column_defs[i].field_type == SWQ_INTEGER ||
--                   select_info->column_defs[i].field_type == SWQ_INTEGER64 )
-                {
-                    oComparator.eType = SWQ_INTEGER64;
-                }
-                else if( select_info->column_defs[i].field_type == SWQ_FLOAT )
-                {
-                    oComparator.eType = SWQ_FLOAT;
-                }
-                else
-                {
-                    oComparator.eType = SWQ_STRING;
-                }
-                select_info->column_summary[i].oSetDistinctValues =
-                    std::set<CPLString, swq_summary::Comparator>(oComparator);
-            }
-            select_info->column_summary[i].min =
-                std::numeric_limits<double>::infinity();
-            select_info->column_summary[i].max =
-                -std::numeric_limits<double>::infinity();
-            select_info->column_summary[i].osMin = "9999/99/99 99:99:99";
-            select_info->column_summary[i].osMax = "0000/00/00 00:00:00";
-        }
-    }
+    if( summary_list.empty() )
+        swq_select_init_summary( select_info, summary_list );
 
 /* -------------------------------------------------------------------- */
 /*      If distinct processing is on, process that now.                 */
 /* -------------------------------------------------------------------- */
-    swq_summary& summary = select_info->column_summary[dest_column];
+    swq_summary& summary = summary_list[dest_column];
 
     if( def->distinct_flag )
     {
@@ -398,7 +430,8 @@ swq_select_summarize( swq_select *select_info,
                     summary.oSetDistinctValues.end() )
             {
                 summary.oSetDistinctValues.insert(value);
-                if( select_info->order_specs == 0 )
+                if( select_info->query_mode == SWQM_DISTINCT_LIST &&
+                    select_info->order_specs == 0 )
                 {
                     // If not sorted, keep values in their original order
                     summary.oVectorDistinctValues.push_back(value);
@@ -512,6 +545,56 @@ swq_select_summarize( swq_select *select_info,
 
     return nullptr;
 }
+
+/************************************************************************/
+/*                         swq_summary_merge()                          */
+/*                                                                      */
+/*      Fold a partial summary, computed over a disjoint subset of      */
+/*      the records, into another one.                                  */
+/************************************************************************/
+
+void swq_summary_merge( swq_summary& dst, const swq_summary& src,
+                        const swq_col_def *def )
+
+{
+    if( def->distinct_flag )
+    {
+        if( !src.oVectorDistinctValues.empty() )
+        {
+            for( size_t i = 0; i < src.oVectorDistinctValues.size(); i++ )
+            {
+                const CPLString& osVal = src.oVectorDistinctValues[i];
+                if( dst.oSetDistinctValues.insert(osVal).second )
+                {
+                    dst.oVectorDistinctValues.push_back(osVal);
+                    dst.count++;
+                }
+            }
+        }
+        else
+        {
+            std::set<CPLString, swq_summary::Comparator>::const_iterator
+                oIter = src.oSetDistinctValues.begin();
+            for( ; oIter != src.oSetDistinctValues.end(); ++oIter )
+            {
+                if( dst.oSetDistinctValues.insert(*oIter).second )
+                    dst.count++;
+            }
+        }
+        return;
+    }
+
+    dst.count += src.count;
+    dst.sum += src.sum;
+    if( src.min < dst.min )
+        dst.min = src.min;
+    if( src.max > dst.max )
+        dst.max = src.max;
+    if( strcmp( src.osMin, dst.osMin ) < 0 )
+        dst.osMin = src.osMin;
+    if( strcmp( src.osMax, dst.osMax ) > 0 )
+        dst.osMax = src.osMax;
+}
 /************************************************************************/
 /*                      sort comparison functions.                      */
 /************************************************************************/
@@ -799,6 +882,7 @@ static const char* const apszSQLReservedKeywords[] = {
     "JOIN",
     "WHERE",
     "ON",
+    "GROUP",
     "ORDER",
     "BY",
     "FROM",
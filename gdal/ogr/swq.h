@@ -246,7 +246,9 @@ CPLErr swq_expr_compile2( const char *where_clause,
 /*
 ** Evaluation related.
 */
-int swq_test_like( const char *input, const char *pattern );
+int swq_test_like( const char *input, const char *pattern,
+                   char chEscape );
+int swq_test_string_equal( const char *pszVal1, const char *pszVal2 );
 
 swq_expr_node *SWQGeneralEvaluator( swq_expr_node *, swq_expr_node **);
 swq_field_type SWQGeneralChecker( swq_expr_node *node, int bAllowMismatchTypeOnFieldComparison );
@@ -261,6 +263,7 @@ const char*    SWQFieldTypeToString( swq_field_type field_type );
 #define SWQM_SUMMARY_RECORD  1
 #define SWQM_RECORDSET       2
 #define SWQM_DISTINCT_LIST   3
+#define SWQM_GROUP_BY        4
 
 typedef enum {
     SWQCF_NONE = 0,
@@ -323,6 +326,13 @@ typedef struct {
     int   ascending_flag;
 } swq_order_def;
 
+typedef struct {
+    char *table_name;
+    char *field_name;
+    int   table_index;
+    int   field_index;
+} swq_group_def;
+
 typedef struct {
     int        secondary_table;
     swq_expr_node  *poExpr;
@@ -376,6 +386,12 @@ public:
 
     swq_expr_node *where_expr;
 
+    void        PushGroupBy( const char* pszTableName, const char *pszFieldName );
+    int         group_specs;
+    swq_group_def *group_defs;
+
+    // In SWQM_GROUP_BY mode, order_defs[].field_index is the index of the
+    // ordered result column, not of a source field.
     void        PushOrderBy( const char* pszTableName, const char *pszFieldName, int bAscending );
     int         order_specs;
     swq_order_def *order_defs;
@@ -407,6 +423,14 @@ CPLErr swq_select_parse( swq_select *select_info,
 const char *swq_select_summarize( swq_select *select_info,
                                   int dest_column,
                                   const char *value );
+void swq_select_init_summary( swq_select *select_info,
+                              std::vector<swq_summary>& summary_list );
+const char *swq_select_summarize( swq_select *select_info,
+                                  std::vector<swq_summary>& summary_list,
+                                  int dest_column,
+                                  const char *value );
+void swq_summary_merge( swq_summary& dst, const swq_summary& src,
+                        const swq_col_def *def );
 
 int swq_is_reserved_keyword(const char* pszStr);
 
@@ -52,8 +52,8 @@ CPL_CVSID("$Id$")
 /*      Does input match pattern?                                       */
 /************************************************************************/
 
-static int swq_test_like( const char *input, const char *pattern,
-                          char chEscape )
+int swq_test_like( const char *input, const char *pattern,
+                   char chEscape )
 
 {
     if( input == nullptr || pattern == nullptr )
@@ -115,6 +115,35 @@ static int swq_test_like( const char *input, const char *pattern,
         return 1;
 }
 
+/************************************************************************/
+/*                       swq_test_string_equal()                        */
+/*                                                                      */
+/*      Case insensitive equality of string or timestamp values.        */
+/************************************************************************/
+
+int swq_test_string_equal( const char *pszVal1, const char *pszVal2 )
+
+{
+    const size_t nLen1 = strlen(pszVal1);
+    const size_t nLen2 = strlen(pszVal2);
+
+    // When comparing timestamps, the +00 at the end might be discarded
+    // if the other member has no explicit timezone.
+    if( nLen1 > 3 && nLen2 > 3 &&
+        strcmp(pszVal1 + nLen1 - 3, "+00") == 0 &&
+        pszVal2[nLen2 - 3] == ':' )
+    {
+        return EQUALN(pszVal1, pszVal2, nLen2);
+    }
+    if( nLen1 > 3 && nLen2 > 3 &&
+        pszVal1[nLen1 - 3] == ':' &&
+        strcmp(pszVal2 + nLen2 - 3, "+00") == 0 )
+    {
+        return EQUALN(pszVal1, pszVal2, nLen1);
+    }
+    return strcasecmp(pszVal1, pszVal2) == 0;
+}
+
 /************************************************************************/
 /*                        OGRHStoreGetValue()                           */
 /************************************************************************/
@@ -700,35 +729,14 @@ swq_expr_node *SWQGeneralEvaluator( swq_expr_node *node,
         {
           case SWQ_EQ:
           {
-            // When comparing timestamps, the +00 at the end might be discarded
-            // if the other member has no explicit timezone.
             if( (sub_node_values[0]->field_type == SWQ_TIMESTAMP ||
                  sub_node_values[0]->field_type == SWQ_STRING) &&
                 (sub_node_values[1]->field_type == SWQ_TIMESTAMP ||
-                 sub_node_values[1]->field_type == SWQ_STRING) &&
-                strlen(sub_node_values[0]->string_value) > 3 &&
-                strlen(sub_node_values[1]->string_value) > 3 &&
-                (strcmp(sub_node_values[0]->string_value + strlen(sub_node_values[0]->string_value)-3, "+00") == 0 &&
-                 sub_node_values[1]->string_value[strlen(sub_node_values[1]->string_value)-3] == ':') )
-            {
-                poRet->int_value =
-                    EQUALN(sub_node_values[0]->string_value,
-                           sub_node_values[1]->string_value,
-                           strlen(sub_node_values[1]->string_value));
-            }
-            else if( (sub_node_values[0]->field_type == SWQ_TIMESTAMP ||
-                      sub_node_values[0]->field_type == SWQ_STRING) &&
-                     (sub_node_values[1]->field_type == SWQ_TIMESTAMP ||
-                      sub_node_values[1]->field_type == SWQ_STRING) &&
-                     strlen(sub_node_values[0]->string_value) > 3 &&
-                     strlen(sub_node_values[1]->string_value) > 3 &&
-                     (sub_node_values[0]->string_value[strlen(sub_node_values[0]->string_value)-3] == ':') &&
-                      strcmp(sub_node_values[1]->string_value + strlen(sub_node_values[1]->string_value)-3, "+00") == 0)
+                 sub_node_values[1]->field_type == SWQ_STRING) )
             {
                 poRet->int_value =
-                    EQUALN(sub_node_values[0]->string_value,
-                           sub_node_values[1]->string_value,
-                           strlen(sub_node_values[0]->string_value));
+                    swq_test_string_equal(sub_node_values[0]->string_value,
+                                          sub_node_values[1]->string_value);
             }
             else
             {
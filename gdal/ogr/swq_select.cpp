@@ -58,6 +58,8 @@ swq_select::swq_select() :
     join_count(0),
     join_defs(nullptr),
     where_expr(nullptr),
+    group_specs(0),
+    group_defs(nullptr),
     order_specs(0),
     order_defs(nullptr),
     limit(-1),
@@ -96,6 +98,14 @@ swq_select::~swq_select()
 
     CPLFree( column_defs );
 
+    for( int i = 0; i < group_specs; i++ )
+    {
+        CPLFree( group_defs[i].table_name );
+        CPLFree( group_defs[i].field_name );
+    }
+
+    CPLFree( group_defs );
+
     for( int i = 0; i < order_specs; i++ )
     {
         CPLFree( order_defs[i].table_name );
@@ -197,6 +207,8 @@ void swq_select::Dump( FILE *fp )
         fprintf( fp, "  QUERY MODE: RECORDSET\n" );
     else if( query_mode == SWQM_DISTINCT_LIST )
         fprintf( fp, "  QUERY MODE: DISTINCT LIST\n" );
+    else if( query_mode == SWQM_GROUP_BY )
+        fprintf( fp, "  QUERY MODE: GROUP BY\n" );
     else
         fprintf( fp, "  QUERY MODE: %d/unknown\n", query_mode );
 
@@ -285,6 +297,18 @@ void swq_select::Dump( FILE *fp )
         where_expr->Dump( fp, 2 );
     }
 
+/* -------------------------------------------------------------------- */
+/*      Group by                                                        */
+/* -------------------------------------------------------------------- */
+
+    for( int i = 0; i < group_specs; i++ )
+    {
+        fprintf( fp, "  GROUP BY: %s (%d/%d)\n",
+                 group_defs[i].field_name,
+                 group_defs[i].table_index,
+                 group_defs[i].field_index );
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Order by                                                        */
 /* -------------------------------------------------------------------- */
@@ -412,6 +436,19 @@ char* swq_select::Unparse()
         CPLFree(pszTmp);
     }
 
+    for( int i = 0; i < group_specs; i++ )
+    {
+        osSelect += ( i == 0 ) ? " GROUP BY " : ", ";
+        if( group_defs[i].table_name[0] != '\0' )
+        {
+            osSelect +=
+                swq_expr_node::QuoteIfNecessary(group_defs[i].table_name, '"');
+            osSelect += ".";
+        }
+        osSelect +=
+            swq_expr_node::QuoteIfNecessary(group_defs[i].field_name, '"');
+    }
+
     for( int i = 0; i < order_specs; i++ )
     {
         osSelect += " ORDER BY ";
@@ -740,6 +777,25 @@ int swq_select::PushTableDef( const char *pszDataSource,
     return table_count-1;
 }
 
+/************************************************************************/
+/*                            PushGroupBy()                             */
+/************************************************************************/
+
+void swq_select::PushGroupBy( const char* pszTableName,
+                              const char *pszFieldName )
+
+{
+    group_specs++;
+    group_defs = static_cast<swq_group_def *>(
+        CPLRealloc(group_defs, sizeof(swq_group_def) * group_specs));
+
+    group_defs[group_specs-1].table_name =
+        CPLStrdup(pszTableName ? pszTableName : "");
+    group_defs[group_specs-1].field_name = CPLStrdup(pszFieldName);
+    group_defs[group_specs-1].table_index = -1;
+    group_defs[group_specs-1].field_index = -1;
+}
+
 /************************************************************************/
 /*                            PushOrderBy()                             */
 /************************************************************************/
@@ -1179,7 +1235,8 @@ CPLErr swq_select::parse( swq_field_list *field_list,
 
         if( this_indicator != query_mode
              && this_indicator != -1
-            && query_mode != 0 )
+            && query_mode != 0
+            && group_specs == 0 )
         {
             CPLError(CE_Failure, CPLE_AppDefined,
                      "Field list implies mixture of regular recordset mode, "
@@ -1196,6 +1253,105 @@ CPLErr swq_select::parse( swq_field_list *field_list,
         query_mode = SWQM_RECORDSET;
     }
 
+/* -------------------------------------------------------------------- */
+/*      Process column names in GROUP BY specs.  Every selected         */
+/*      column that is not an aggregate must be a grouping column.      */
+/* -------------------------------------------------------------------- */
+    if( group_specs > 0 )
+    {
+        if( query_mode == SWQM_DISTINCT_LIST )
+        {
+            CPLError( CE_Failure, CPLE_NotSupported,
+                      "SELECT DISTINCT not supported with GROUP BY." );
+            return CE_Failure;
+        }
+
+        for( int i = 0; i < group_specs; i++ )
+        {
+            swq_group_def *def = group_defs + i;
+
+            swq_field_type field_type;
+            def->field_index = swq_identify_field(def->table_name,
+                                                  def->field_name, field_list,
+                                                  &field_type,
+                                                  &(def->table_index));
+            if( def->field_index == -1 )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "Unrecognized field name %s in GROUP BY.",
+                          def->table_name[0] ?
+                          CPLSPrintf("%s.%s", def->table_name,
+                                     def->field_name)
+                          : def->field_name );
+                return CE_Failure;
+            }
+
+            if( def->table_index != 0 )
+            {
+                CPLError(CE_Failure, CPLE_AppDefined,
+                         "Cannot use field '%s' of a secondary table in "
+                         "a GROUP BY clause",
+                         def->field_name );
+                return CE_Failure;
+            }
+
+            if( field_type == SWQ_GEOMETRY )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "Cannot use geometry field '%s' in a GROUP BY "
+                          "clause",
+                          def->field_name );
+                return CE_Failure;
+            }
+        }
+
+        for( int i = 0; i < result_columns; i++ )
+        {
+            swq_col_def *def = column_defs + i;
+
+            if( def->col_func == SWQCF_CUSTOM )
+            {
+                CPLError( CE_Failure, CPLE_NotSupported,
+                          "Custom column functions not supported with "
+                          "GROUP BY." );
+                return CE_Failure;
+            }
+
+            if( def->col_func != SWQCF_NONE )
+            {
+                if( def->table_index > 0 )
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "Cannot aggregate field '%s' of a secondary "
+                             "table in a GROUP BY query",
+                             def->field_name );
+                    return CE_Failure;
+                }
+                continue;
+            }
+
+            bool bFound = false;
+            if( def->expr == nullptr || def->expr->eNodeType == SNT_COLUMN )
+            {
+                for( int j = 0; !bFound && j < group_specs; j++ )
+                {
+                    bFound = def->table_index == group_defs[j].table_index &&
+                             def->field_index == group_defs[j].field_index;
+                }
+            }
+            if( !bFound )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "Column %s must appear in the GROUP BY clause or "
+                          "be used in an aggregate function.",
+                          def->field_name );
+                return CE_Failure;
+            }
+        }
+
+        query_mode = SWQM_GROUP_BY;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Process column names in JOIN specs.                             */
 /* -------------------------------------------------------------------- */
@@ -1217,6 +1373,49 @@ CPLErr swq_select::parse( swq_field_list *field_list,
     {
         swq_order_def *def = order_defs + i;
 
+        // The result of a GROUP BY is ordered on its own columns.
+        if( query_mode == SWQM_GROUP_BY )
+        {
+            def->table_index = 0;
+            def->field_index = -1;
+            for( int j = 0; def->field_index < 0 && j < result_columns; j++ )
+            {
+                const swq_col_def *col_def = column_defs + j;
+                CPLString osName;
+                if( col_def->field_alias != nullptr )
+                    osName = col_def->field_alias;
+                else if( col_def->col_func != SWQCF_NONE )
+                {
+                    const swq_operation *op =
+                        swq_op_registrar::GetOperator(
+                            static_cast<swq_op>(col_def->col_func) );
+                    osName.Printf( "%s_%s", op->pszName,
+                                   col_def->field_name );
+                }
+                else
+                    osName = col_def->field_name;
+
+                if( EQUAL(osName, def->field_name) &&
+                    (def->table_name[0] == '\0' ||
+                     col_def->col_func != SWQCF_NONE ||
+                     EQUAL(def->table_name, col_def->table_name) ||
+                     EQUAL(def->table_name,
+                           table_defs[0].table_alias)) )
+                {
+                    def->field_index = j;
+                }
+            }
+            if( def->field_index < 0 )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "ORDER BY field %s is not a column of the GROUP BY "
+                          "result.",
+                          def->field_name );
+                return CE_Failure;
+            }
+            continue;
+        }
+
         // Identify field.
         swq_field_type field_type;
         def->field_index = swq_identify_field(def->table_name,